@@ -145,6 +145,10 @@ def grpc_cc_library(
                       "//:remote_execution": ["GRPC_PORT_ISOLATED_RUNTIME=1"],
                       "//conditions:default": [],
                   }) +
+                  select({
+                      "//:grpc_usdt_probes": ["GRPC_USDT_PROBES"],
+                      "//conditions:default": [],
+                  }) +
                   select({
                       "//:grpc_allow_exceptions": ["GRPC_ALLOW_EXCEPTIONS=1"],
                       "//:grpc_disallow_exceptions": ["GRPC_ALLOW_EXCEPTIONS=0"],
@@ -458,6 +458,7 @@
         'src/core/lib/gpr/tmpfile_windows.cc',
         'src/core/lib/gpr/wrap_memcpy.cc',
         'src/core/lib/gprpp/arena.cc',
+        'src/core/lib/gprpp/contention_profiler.cc',
         'src/core/lib/gprpp/examine_stack.cc',
         'src/core/lib/gprpp/fork.cc',
         'src/core/lib/gprpp/global_config_env.cc',
@@ -480,12 +481,14 @@
         'absl/container:flat_hash_map',
         'absl/container:inlined_vector',
         'absl/functional:bind_front',
+        'absl/random:random',
         'absl/status:statusor',
         'absl/types:variant',
         'gpr',
         'address_sorting',
       ],
       'sources': [
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
         'src/core/ext/filters/census/grpc_context.cc',
         'src/core/ext/filters/client_channel/backend_metric.cc',
         'src/core/ext/filters/client_channel/backup_poller.cc',
@@ -494,6 +497,7 @@
         'src/core/ext/filters/client_channel/client_channel_channelz.cc',
         'src/core/ext/filters/client_channel/client_channel_factory.cc',
         'src/core/ext/filters/client_channel/client_channel_plugin.cc',
+        'src/core/ext/filters/client_channel/client_concurrency_filter.cc',
         'src/core/ext/filters/client_channel/config_selector.cc',
         'src/core/ext/filters/client_channel/dynamic_filters.cc',
         'src/core/ext/filters/client_channel/global_subchannel_pool.cc',
@@ -509,6 +513,7 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_channel_secure.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
@@ -530,6 +535,7 @@
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_event_engine.cc',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_posix.cc',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_windows.cc',
+        'src/core/ext/filters/client_channel/resolver/dns/dns_cache.cc',
         'src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.cc',
         'src/core/ext/filters/client_channel/resolver/dns/native/dns_resolver.cc',
         'src/core/ext/filters/client_channel/resolver/fake/fake_resolver.cc',
@@ -804,18 +810,24 @@
         'src/core/lib/channel/channel_trace.cc',
         'src/core/lib/channel/channelz.cc',
         'src/core/lib/channel/channelz_registry.cc',
+        'src/core/lib/channel/concurrency_limiter.cc',
         'src/core/lib/channel/connected_channel.cc',
         'src/core/lib/channel/handshaker.cc',
         'src/core/lib/channel/handshaker_registry.cc',
+        'src/core/lib/channel/shm_handshaker.cc',
         'src/core/lib/channel/status_util.cc',
         'src/core/lib/compression/compression.cc',
         'src/core/lib/compression/compression_args.cc',
+        'src/core/lib/compression/compression_dictionary.cc',
+        'src/core/lib/compression/adaptive_compression.cc',
+        'src/core/lib/compression/parallel_compress.cc',
         'src/core/lib/compression/compression_internal.cc',
         'src/core/lib/compression/message_compress.cc',
         'src/core/lib/compression/stream_compression.cc',
         'src/core/lib/compression/stream_compression_gzip.cc',
         'src/core/lib/compression/stream_compression_identity.cc',
         'src/core/lib/config/core_configuration.cc',
+        'src/core/lib/debug/method_stats.cc',
         'src/core/lib/debug/stats.cc',
         'src/core/lib/debug/stats_data.cc',
         'src/core/lib/debug/trace.cc',
@@ -836,6 +848,7 @@
         'src/core/lib/iomgr/endpoint_pair_event_engine.cc',
         'src/core/lib/iomgr/endpoint_pair_posix.cc',
         'src/core/lib/iomgr/endpoint_pair_windows.cc',
+        'src/core/lib/iomgr/endpoint_shm.cc',
         'src/core/lib/iomgr/error.cc',
         'src/core/lib/iomgr/error_cfstream.cc',
         'src/core/lib/iomgr/ev_apple.cc',
@@ -1021,6 +1034,7 @@
         'src/core/lib/transport/timeout_encoding.cc',
         'src/core/lib/transport/transport.cc',
         'src/core/lib/transport/transport_op_string.cc',
+        'src/core/lib/transport/write_latency.cc',
         'src/core/lib/uri/uri_parser.cc',
         'src/core/plugin_registry/grpc_plugin_registry.cc',
         'src/core/tsi/alts/crypt/aes_gcm.cc',
@@ -1138,12 +1152,14 @@
         'absl/container:flat_hash_map',
         'absl/container:inlined_vector',
         'absl/functional:bind_front',
+        'absl/random:random',
         'absl/status:statusor',
         'absl/types:variant',
         'gpr',
         'address_sorting',
       ],
       'sources': [
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
         'src/core/ext/filters/census/grpc_context.cc',
         'src/core/ext/filters/client_channel/backend_metric.cc',
         'src/core/ext/filters/client_channel/backup_poller.cc',
@@ -1152,6 +1168,7 @@
         'src/core/ext/filters/client_channel/client_channel_channelz.cc',
         'src/core/ext/filters/client_channel/client_channel_factory.cc',
         'src/core/ext/filters/client_channel/client_channel_plugin.cc',
+        'src/core/ext/filters/client_channel/client_concurrency_filter.cc',
         'src/core/ext/filters/client_channel/config_selector.cc',
         'src/core/ext/filters/client_channel/dynamic_filters.cc',
         'src/core/ext/filters/client_channel/global_subchannel_pool.cc',
@@ -1167,6 +1184,7 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_channel.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
@@ -1184,6 +1202,7 @@
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_event_engine.cc',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_posix.cc',
         'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_windows.cc',
+        'src/core/ext/filters/client_channel/resolver/dns/dns_cache.cc',
         'src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.cc',
         'src/core/ext/filters/client_channel/resolver/dns/native/dns_resolver.cc',
         'src/core/ext/filters/client_channel/resolver/fake/fake_resolver.cc',
@@ -1263,18 +1282,24 @@
         'src/core/lib/channel/channel_trace.cc',
         'src/core/lib/channel/channelz.cc',
         'src/core/lib/channel/channelz_registry.cc',
+        'src/core/lib/channel/concurrency_limiter.cc',
         'src/core/lib/channel/connected_channel.cc',
         'src/core/lib/channel/handshaker.cc',
         'src/core/lib/channel/handshaker_registry.cc',
+        'src/core/lib/channel/shm_handshaker.cc',
         'src/core/lib/channel/status_util.cc',
         'src/core/lib/compression/compression.cc',
         'src/core/lib/compression/compression_args.cc',
+        'src/core/lib/compression/compression_dictionary.cc',
+        'src/core/lib/compression/adaptive_compression.cc',
+        'src/core/lib/compression/parallel_compress.cc',
         'src/core/lib/compression/compression_internal.cc',
         'src/core/lib/compression/message_compress.cc',
         'src/core/lib/compression/stream_compression.cc',
         'src/core/lib/compression/stream_compression_gzip.cc',
         'src/core/lib/compression/stream_compression_identity.cc',
         'src/core/lib/config/core_configuration.cc',
+        'src/core/lib/debug/method_stats.cc',
         'src/core/lib/debug/stats.cc',
         'src/core/lib/debug/stats_data.cc',
         'src/core/lib/debug/trace.cc',
@@ -1294,6 +1319,7 @@
         'src/core/lib/iomgr/endpoint_pair_event_engine.cc',
         'src/core/lib/iomgr/endpoint_pair_posix.cc',
         'src/core/lib/iomgr/endpoint_pair_windows.cc',
+        'src/core/lib/iomgr/endpoint_shm.cc',
         'src/core/lib/iomgr/error.cc',
         'src/core/lib/iomgr/error_cfstream.cc',
         'src/core/lib/iomgr/ev_apple.cc',
@@ -1424,6 +1450,7 @@
         'src/core/lib/transport/timeout_encoding.cc',
         'src/core/lib/transport/transport.cc',
         'src/core/lib/transport/transport_op_string.cc',
+        'src/core/lib/transport/write_latency.cc',
         'src/core/lib/uri/uri_parser.cc',
         'src/core/plugin_registry/grpc_unsecure_plugin_registry.cc',
       ],
@@ -1451,6 +1478,7 @@
         'grpc',
       ],
       'sources': [
+        'src/cpp/client/bulk_unary_call.cc',
         'src/cpp/client/channel_cc.cc',
         'src/cpp/client/client_callback.cc',
         'src/cpp/client/client_context.cc',
@@ -1584,6 +1612,7 @@
         'grpc_unsecure',
       ],
       'sources': [
+        'src/cpp/client/bulk_unary_call.cc',
         'src/cpp/client/channel_cc.cc',
         'src/cpp/client/client_callback.cc',
         'src/cpp/client/client_context.cc',
@@ -68,6 +68,23 @@ GRPCAPI void grpc_compression_options_disable_algorithm(
 GRPCAPI int grpc_compression_options_is_algorithm_enabled(
     const grpc_compression_options* opts, grpc_compression_algorithm algorithm);
 
+/** EXPERIMENTAL: Registers \a dictionary (\a length bytes) as the preset
+ * dictionary that GRPC_COMPRESS_DEFLATE uses for the methods whose path
+ * starts with \a path_prefix, e.g. "/pkg.Service/" for a whole service or
+ * "/pkg.Service/Method" for a single method. The longest matching prefix
+ * wins. Messages of other methods are deflated without a dictionary.
+ * The dictionary is named after its Adler-32 checksum in grpc-encoding, as
+ * "deflate-dict-<8 hex digits>", and both peers list that name in
+ * grpc-accept-encoding. Each side only deflates with the dictionary once the
+ * other side listed it: servers look at the request, clients at earlier
+ * responses on the same connection. Until then, messages are plain deflate.
+ * Registrations are kept until the process exits.
+ * Returns 1 upon success, 0 if another dictionary with the same checksum is
+ * already registered. */
+GRPCAPI int grpc_compression_dictionary_register(const char* path_prefix,
+                                                 const char* dictionary,
+                                                 size_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -178,6 +178,26 @@ typedef struct {
    application will see the compressed message in the byte buffer. */
 #define GRPC_ARG_ENABLE_PER_MESSAGE_DECOMPRESSION \
   "grpc.per_message_decompression"
+/** Experimental Arg. If set, the per-message compression of the channel
+   adapts to the messages of each method: messages that look incompressible,
+   and methods whose messages compress poorly, are sent uncompressed, and the
+   compression level is lowered for methods that save less than
+   GRPC_ARG_ADAPTIVE_COMPRESSION_MIN_BYTES_SAVED_PER_CPU_MS. Boolean valued,
+   defaults to 0. */
+#define GRPC_ARG_ADAPTIVE_MESSAGE_COMPRESSION \
+  "grpc.adaptive_message_compression"
+/** Experimental Arg. The CPU budget of adaptive message compression: bytes
+   that compression must save per millisecond of CPU time. Int valued,
+   defaults to 4096. With 0, only the compression ratio is taken into
+   account. */
+#define GRPC_ARG_ADAPTIVE_COMPRESSION_MIN_BYTES_SAVED_PER_CPU_MS \
+  "grpc.adaptive_compression_min_bytes_saved_per_cpu_ms"
+/** Experimental Arg. Messages of at least this many bytes are compressed
+   with gzip or deflate in 128KB chunks on a pool of threads, into a stream
+   that any inflater decompresses. The sending thread still waits for the
+   whole message, but for less time. Int valued, defaults to 0 (disabled). */
+#define GRPC_ARG_PARALLEL_COMPRESSION_MIN_MESSAGE_SIZE \
+  "grpc.parallel_compression_min_message_size"
 /** Enable/disable support for deadline checking. Defaults to 1, unless
     GRPC_ARG_MINIMAL_STACK is enabled, in which case it defaults to 0 */
 #define GRPC_ARG_ENABLE_DEADLINE_CHECKS "grpc.enable_deadline_checking"
@@ -231,6 +251,12 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** Break the latency of the writes of one in this many streams down into
+    stages, from the TX timestamps of the kernel (Linux only). The breakdowns
+    are reported to the call's CallAttemptTracer and recorded in process-wide
+    histograms. Int valued, 0 (the default) disables it. */
+#define GRPC_ARG_HTTP2_WRITE_TIMESTAMPS_SAMPLING_PERIOD \
+  "grpc.http2.write_timestamps_sampling_period"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -267,6 +293,35 @@ typedef struct {
 /** The timeout used on servers for finishing handshaking on an incoming
     connection.  Defaults to 120 seconds. */
 #define GRPC_ARG_SERVER_HANDSHAKE_TIMEOUT_MS "grpc.server_handshake_timeout_ms"
+/** If non-zero, the server keeps histograms of the queue time, handler time
+ * and message bytes of the calls to each registered method, reported by
+ * channelz and, in C++, by grpc::Server::experimental().GetMethodStats().
+ * Defaults to 0. */
+#define GRPC_ARG_SERVER_METHOD_STATS "grpc.server_method_stats"
+/** If non-zero, the server bounds the number of calls it handles at once by a
+ * limit that follows the latency of its handlers: the limit shrinks when
+ * latency rises above its long-term average, and grows while it does not.
+ * Calls above the limit fail right away with RESOURCE_EXHAUSTED. The limit is
+ * reported by channelz. Defaults to 0. */
+#define GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY "grpc.server_adaptive_concurrency"
+/** With GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY, the initial, minimum and maximum
+ * number of calls the server handles at once. Default to 20, 1 and 1000. */
+#define GRPC_ARG_SERVER_CONCURRENCY_INITIAL_LIMIT \
+  "grpc.server_concurrency_initial_limit"
+#define GRPC_ARG_SERVER_CONCURRENCY_MIN_LIMIT "grpc.server_concurrency_min_limit"
+#define GRPC_ARG_SERVER_CONCURRENCY_MAX_LIMIT "grpc.server_concurrency_max_limit"
+/** If non-zero, the channel bounds the number of calls it has in flight by a
+ * limit that follows their latency, as GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY
+ * does for servers. Calls above the limit fail right away with
+ * RESOURCE_EXHAUSTED, without reaching the network or being retried, and count
+ * as failures for retry throttling. Defaults to 0. */
+#define GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY "grpc.client_adaptive_concurrency"
+/** With GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY, the initial, minimum and maximum
+ * number of calls the channel has in flight. Default to 20, 1 and 1000. */
+#define GRPC_ARG_CLIENT_CONCURRENCY_INITIAL_LIMIT \
+  "grpc.client_concurrency_initial_limit"
+#define GRPC_ARG_CLIENT_CONCURRENCY_MIN_LIMIT "grpc.client_concurrency_min_limit"
+#define GRPC_ARG_CLIENT_CONCURRENCY_MAX_LIMIT "grpc.client_concurrency_max_limit"
 /** This *should* be used for testing only.
     The caller of the secure_channel_create functions may override the target
     name used for SSL host name checking using this channel argument which is of
@@ -434,6 +489,12 @@ typedef struct {
  * timeouts/backoff/retry logic, and so the actual DNS resolution may time out
  * sooner than the value specified here. */
 #define GRPC_ARG_DNS_ARES_QUERY_TIMEOUT_MS "grpc.dns_ares_query_timeout"
+/** If set, the channel's DNS resolver shares its resolutions with the other
+ * channels of the process that set it: results are reused for their TTL and
+ * failures for a few seconds, and concurrent resolutions of the same name
+ * are only sent once. Works with both the "ares" and the "native" DNS
+ * resolvers. Boolean valued, defaults to 0. */
+#define GRPC_ARG_DNS_ENABLE_CACHE "grpc.dns_enable_cache"
 /** If set, uses a local subchannel pool within the channel. Otherwise, uses the
  * global subchannel pool. */
 #define GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL "grpc.use_local_subchannel_pool"
@@ -445,6 +506,12 @@ typedef struct {
     gRPC authorization check. */
 #define GRPC_ARG_AUTHORIZATION_POLICY_PROVIDER \
   "grpc.authorization_policy_provider"
+/** If non-zero, C++ in-process channels (Server::InProcessChannel) hand
+    messages to the server as owned objects instead of serialized bytes,
+    when no interceptor needs the bytes. Size limits on messages are not
+    enforced for messages passed this way. Defaults to 0. */
+#define GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS \
+  "grpc.inproc.pass_message_pointers"
 /** \} */
 
 /** Result of a grpc call. If the caller satisfies the prerequisites of a
@@ -49,6 +49,18 @@ typedef struct grpc_slice grpc_slice;
 #define GRPC_SLICE_INLINED_SIZE \
   (sizeof(size_t) + sizeof(uint8_t*) - 1 + GRPC_SLICE_INLINE_EXTRA_SIZE)
 
+/** The headroom that slices of outgoing messages should reserve with
+   grpc_slice_malloc_with_headroom() for the transport to frame them in place:
+   enough for a message prefix (5 bytes) and an HTTP/2 frame header (9 bytes).
+ */
+#define GRPC_SLICE_WRITE_HEADROOM 16
+
+/** The largest slice of an outgoing message that the transport can send in
+   place as one frame, whatever the peer: the smallest maximum frame size that
+   HTTP/2 peers may advertise. The first slice of a message also carries its
+   prefix, so it should be 5 bytes shorter. */
+#define GRPC_SLICE_WRITE_CHUNK_SIZE 16384
+
 struct grpc_slice_refcount;
 /** A grpc_slice s, if initialized, represents the byte range
    s.bytes[0..s.length-1].
@@ -67,6 +67,14 @@ GPRAPI grpc_slice grpc_slice_new_with_len(void* p, size_t len,
 GPRAPI grpc_slice grpc_slice_malloc(size_t length);
 GPRAPI grpc_slice grpc_slice_malloc_large(size_t length);
 
+/** Like grpc_slice_malloc(), but also reserves \a headroom unused bytes before
+   the start of the slice. When the slice is sent as (the start of) a message,
+   the transport may write its message prefix and frame headers in this
+   headroom instead of allocating them separately: see
+   GRPC_SLICE_WRITE_HEADROOM and GRPC_SLICE_WRITE_CHUNK_SIZE. */
+GPRAPI grpc_slice grpc_slice_malloc_with_headroom(size_t length,
+                                                  size_t headroom);
+
 #define GRPC_SLICE_MALLOC(len) grpc_slice_malloc(len)
 
 /** Intern a slice:
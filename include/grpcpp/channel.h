@@ -33,6 +33,9 @@
 struct grpc_channel;
 
 namespace grpc {
+namespace internal {
+class BulkUnaryCall;
+}  // namespace internal
 namespace testing {
 class ChannelTestPeer;
 }  // namespace testing
@@ -72,6 +75,7 @@ class Channel final : public ::grpc::ChannelInterface,
  private:
   template <class InputMessage, class OutputMessage>
   friend class ::grpc::internal::BlockingUnaryCallImpl;
+  friend class ::grpc::internal::BulkUnaryCall;
   friend class ::grpc::testing::ChannelTestPeer;
   friend void experimental::ChannelResetConnectionBackoff(Channel* channel);
   friend std::shared_ptr<Channel> grpc::CreateChannelInternal(
@@ -80,6 +84,7 @@ class Channel final : public ::grpc::ChannelInterface,
           ::grpc::experimental::ClientInterceptorFactoryInterface>>
           interceptor_creators);
   friend class ::grpc::internal::InterceptedChannel;
+  friend class ::grpc::Server;
   Channel(const std::string& host, grpc_channel* c_channel,
           std::vector<std::unique_ptr<
               ::grpc::experimental::ClientInterceptorFactoryInterface>>
@@ -119,6 +124,10 @@ class Channel final : public ::grpc::ChannelInterface,
   std::vector<
       std::unique_ptr<::grpc::experimental::ClientInterceptorFactoryInterface>>
       interceptor_creators_;
+
+  // Set on in-process channels created with
+  // GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS.
+  bool pass_message_pointers_ = false;
 };
 
 }  // namespace grpc
@@ -26,6 +26,7 @@
 #include <grpc/impl/codegen/byte_buffer.h>
 #include <grpcpp/impl/codegen/config.h>
 #include <grpcpp/impl/codegen/core_codegen_interface.h>
+#include <grpcpp/impl/codegen/inproc_message.h>
 #include <grpcpp/impl/codegen/serialization_traits.h>
 #include <grpcpp/impl/codegen/slice.h>
 #include <grpcpp/impl/codegen/status.h>
@@ -55,6 +56,8 @@ class ExternalConnectionAcceptorImpl;
 template <class R>
 class DeserializeFuncType;
 class GrpcByteBufferPeer;
+class BulkUnaryCall;
+InprocMessage* InprocMessageFromByteBuffer(const ByteBuffer& buffer);
 
 }  // namespace internal
 /// A sequence of bytes.
@@ -187,6 +190,9 @@ class ByteBuffer final {
   friend class ProtoBufferWriter;
   friend class internal::GrpcByteBufferPeer;
   friend class internal::ExternalConnectionAcceptorImpl;
+  friend class internal::BulkUnaryCall;
+  friend internal::InprocMessage* internal::InprocMessageFromByteBuffer(
+      const ByteBuffer& buffer);
 
   grpc_byte_buffer* buffer_;
 
@@ -219,10 +225,29 @@ class ByteBuffer final {
   ByteBufferPointer bbuf_ptr() const { return ByteBufferPointer(this); }
 };
 
+namespace internal {
+
+/// Returns the message object carried by \a buffer, or nullptr if \a buffer
+/// holds serialized bytes. See InprocMessage.
+inline InprocMessage* InprocMessageFromByteBuffer(const ByteBuffer& buffer) {
+  return InprocMessage::FromByteBuffer(buffer.buffer_);
+}
+
+}  // namespace internal
+
 template <>
 class SerializationTraits<ByteBuffer, void> {
  public:
   static Status Deserialize(ByteBuffer* byte_buffer, ByteBuffer* dest) {
+    internal::InprocMessage* inproc =
+        internal::InprocMessageFromByteBuffer(*byte_buffer);
+    if (inproc != nullptr) {
+      // Raw byte consumers get the serialized form of a message object.
+      dest->Clear();
+      Status status = inproc->Serialize(dest);
+      byte_buffer->Clear();
+      return status;
+    }
     dest->set_buffer(byte_buffer->buffer_);
     return Status::OK;
   }
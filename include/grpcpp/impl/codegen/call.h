@@ -81,6 +81,11 @@ class Call final {
     return server_rpc_info_;
   }
 
+  /// Whether messages may be sent as objects rather than serialized bytes.
+  /// Only set for calls on the inproc transport, see inproc_message.h.
+  bool pass_message_pointers() const { return pass_message_pointers_; }
+  void set_pass_message_pointers(bool pass) { pass_message_pointers_ = pass; }
+
  private:
   CallHook* call_hook_;
   ::grpc::CompletionQueue* cq_;
@@ -88,6 +93,7 @@ class Call final {
   int max_receive_message_size_;
   experimental::ClientRpcInfo* client_rpc_info_ = nullptr;
   experimental::ServerRpcInfo* server_rpc_info_ = nullptr;
+  bool pass_message_pointers_ = false;
 };
 }  // namespace internal
 }  // namespace grpc
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <map>
 #include <memory>
+#include <type_traits>
 
 #include <grpc/impl/codegen/compression_types.h>
 #include <grpc/impl/codegen/grpc_types.h>
@@ -281,6 +282,28 @@ class CallOpSendInitialMetadata {
   } maybe_compression_level_;
 };
 
+typedef Status (*InprocSerializerFunc)(const void* message, bool may_move,
+                                       ByteBuffer* buffer);
+
+/// Returns the function that wraps a message of type \a M into an
+/// InprocMessage, or nullptr if SerializationTraits<M> do not support it
+/// (i.e. do not provide SerializeInproc).
+template <class M, class = void>
+struct InprocSerializer {
+  static InprocSerializerFunc Get() { return nullptr; }
+};
+
+template <class M>
+struct InprocSerializer<
+    M, decltype(void(&SerializationTraits<M>::SerializeInproc))> {
+  static Status Serialize(const void* message, bool may_move,
+                          ByteBuffer* buffer) {
+    return SerializationTraits<M, void>::SerializeInproc(
+        *static_cast<const M*>(message), may_move, buffer);
+  }
+  static InprocSerializerFunc Get() { return Serialize; }
+};
+
 class CallOpSendMessage {
  public:
   CallOpSendMessage() : send_buf_() {}
@@ -306,6 +329,11 @@ class CallOpSendMessage {
   template <class M>
   Status SendMessagePtr(const M* message) GRPC_MUST_USE_RESULT;
 
+  /// Like SendMessagePtr, for a \a message that the caller does not use once
+  /// the op has started: gRPC may then move out of it.
+  template <class M>
+  Status SendOwnedMessagePtr(M* message) GRPC_MUST_USE_RESULT;
+
  protected:
   void AddOp(grpc_op* ops, size_t* nops) {
     if (msg_ == nullptr && !send_buf_.Valid()) return;
@@ -314,9 +342,19 @@ class CallOpSendMessage {
       return;
     }
     if (msg_ != nullptr) {
-      GPR_CODEGEN_ASSERT(serializer_(msg_).ok());
+      if (pass_message_pointers_ && inproc_serializer_ != nullptr) {
+        // Nothing asked for the bytes of the message: hand it over as an
+        // object. An interceptor may have replaced the message, which is
+        // then not ours to move.
+        GPR_CODEGEN_ASSERT(
+            inproc_serializer_(msg_, msg_ == owned_msg_, &send_buf_).ok());
+      } else {
+        GPR_CODEGEN_ASSERT(serializer_(msg_).ok());
+      }
     }
     serializer_ = nullptr;
+    inproc_serializer_ = nullptr;
+    owned_msg_ = nullptr;
     grpc_op* op = &ops[(*nops)++];
     op->op = GRPC_OP_SEND_MESSAGE;
     op->flags = write_options_.flags();
@@ -364,13 +402,18 @@ class CallOpSendMessage {
     hijacked_ = true;
   }
 
+  friend void SetPassMessagePointers(CallOpSendMessage* op, bool pass);
+
  private:
   const void* msg_ = nullptr;  // The original non-serialized message
+  const void* owned_msg_ = nullptr;  // msg_, if it may be moved from
   bool hijacked_ = false;
   bool failed_send_ = false;
   ByteBuffer send_buf_;
   WriteOptions write_options_;
   std::function<Status(const void*)> serializer_;
+  InprocSerializerFunc inproc_serializer_ = nullptr;
+  bool pass_message_pointers_ = false;
 };
 
 template <class M>
@@ -399,6 +442,7 @@ template <class M>
 Status CallOpSendMessage::SendMessagePtr(const M* message,
                                          WriteOptions options) {
   msg_ = message;
+  owned_msg_ = nullptr;
   write_options_ = options;
   // Store the serializer for later since we have access to the message
   serializer_ = [this](const void* message) {
@@ -414,6 +458,7 @@ Status CallOpSendMessage::SendMessagePtr(const M* message,
     }
     return result;
   };
+  inproc_serializer_ = InprocSerializer<M>::Get();
   return Status();
 }
 
@@ -422,6 +467,13 @@ Status CallOpSendMessage::SendMessagePtr(const M* message) {
   return SendMessagePtr(message, WriteOptions());
 }
 
+template <class M>
+Status CallOpSendMessage::SendOwnedMessagePtr(M* message) {
+  Status result = SendMessagePtr(message, WriteOptions());
+  owned_msg_ = message;
+  return result;
+}
+
 template <class R>
 class CallOpRecvMessage {
  public:
@@ -853,6 +905,13 @@ template <class Op1 = CallNoOp<1>, class Op2 = CallNoOp<2>,
           class Op5 = CallNoOp<5>, class Op6 = CallNoOp<6>>
 class CallOpSet;
 
+/// Only CallOpSendMessage cares whether the call passes message objects.
+template <class Op>
+void SetPassMessagePointers(Op* /*op*/, bool /*pass*/) {}
+inline void SetPassMessagePointers(CallOpSendMessage* op, bool pass) {
+  op->pass_message_pointers_ = pass;
+}
+
 /// Primary implementation of CallOpSetInterface.
 /// Since we cannot use variadic templates, we declare slots up to
 /// the maximum count of ops we'll need in a set. We leverage the
@@ -961,6 +1020,13 @@ class CallOpSet : public CallOpSetInterface,
     static const size_t MAX_OPS = 6;
     grpc_op ops[MAX_OPS];
     size_t nops = 0;
+    const bool pass = call_.pass_message_pointers();
+    SetPassMessagePointers(static_cast<Op1*>(this), pass);
+    SetPassMessagePointers(static_cast<Op2*>(this), pass);
+    SetPassMessagePointers(static_cast<Op3*>(this), pass);
+    SetPassMessagePointers(static_cast<Op4*>(this), pass);
+    SetPassMessagePointers(static_cast<Op5*>(this), pass);
+    SetPassMessagePointers(static_cast<Op6*>(this), pass);
     this->Op1::AddOp(ops, &nops);
     this->Op2::AddOp(ops, &nops);
     this->Op3::AddOp(ops, &nops);
@@ -75,6 +75,7 @@ class ClientCallbackWriterImpl;
 class ClientCallbackUnaryImpl;
 class ClientContextAccessor;
 class ClientAsyncResponseReaderHelper;
+class BulkUnaryCall;
 }  // namespace internal
 
 template <class R>
@@ -462,6 +463,7 @@ class ClientContext {
   friend class ::grpc::internal::ClientCallbackWriterImpl;
   friend class ::grpc::internal::ClientCallbackUnaryImpl;
   friend class ::grpc::internal::ClientContextAccessor;
+  friend class ::grpc::internal::BulkUnaryCall;
 
   // Used by friend class CallOpClientRecvStatus
   void set_debug_error_string(const std::string& debug_error_string) {
@@ -100,6 +100,8 @@ class CoreCodegen final : public CoreCodegenInterface {
                                      void (*destroy)(void*, size_t)) override;
   grpc_slice grpc_empty_slice() override;
   grpc_slice grpc_slice_malloc(size_t length) override;
+  grpc_slice grpc_slice_malloc_with_headroom(size_t length,
+                                             size_t headroom) override;
   void grpc_slice_unref(grpc_slice slice) override;
   grpc_slice grpc_slice_ref(grpc_slice slice) override;
   grpc_slice grpc_slice_split_tail(grpc_slice* s, size_t split) override;
@@ -0,0 +1,145 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_IMPL_CODEGEN_INPROC_MESSAGE_H
+#define GRPCPP_IMPL_CODEGEN_INPROC_MESSAGE_H
+
+// IWYU pragma: private
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <random>
+
+#include <grpc/impl/codegen/byte_buffer.h>
+#include <grpc/impl/codegen/slice.h>
+#include <grpcpp/impl/codegen/core_codegen_interface.h>
+#include <grpcpp/impl/codegen/status.h>
+
+namespace grpc {
+
+class ByteBuffer;
+
+namespace internal {
+
+/// A message handed to the receiver as an object instead of serialized bytes.
+///
+/// Calls on in-process channels created with
+/// GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS carry the message through the inproc
+/// transport as an object: the byte buffer holds a single slice that owns an
+/// InprocMessage, and the receiving SerializationTraits take the message out
+/// of it instead of parsing. Receivers that need the bytes call Serialize().
+///
+/// The slice tags itself: its bytes are a header holding a key drawn at
+/// random once per process and the address the header lives at. Bytes from
+/// the network cannot know the key, and a copy of a header is never at the
+/// address it names, so FromByteBuffer() only accepts the slice ToSlice()
+/// made, without any bookkeeping shared between calls.
+class InprocMessage {
+ public:
+  virtual ~InprocMessage() {}
+
+  /// Serializes the message into \a buffer. Fails if the message was
+  /// already consumed.
+  virtual Status Serialize(ByteBuffer* buffer) = 0;
+
+  /// Identifies the InprocMessage subclass, see InprocMessageType().
+  const void* type() const { return type_; }
+
+  /// Claims the message for the caller, which may then move it out. Returns
+  /// false if it was already claimed.
+  bool Consume() {
+    return !consumed_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  /// Transfers the ownership of \a message to the returned slice: it is
+  /// destroyed once the last reference to the slice is gone.
+  static grpc_slice ToSlice(InprocMessage* message) {
+    return g_core_codegen_interface->grpc_slice_new_with_user_data(
+        &message->header_, sizeof(message->header_), Destroy, message);
+  }
+
+  /// Returns the message carried by \a buffer, or nullptr if \a buffer holds
+  /// serialized bytes.
+  static InprocMessage* FromByteBuffer(grpc_byte_buffer* buffer) {
+    if (buffer == nullptr || buffer->type != GRPC_BB_RAW ||
+        buffer->data.raw.compression != GRPC_COMPRESS_NONE ||
+        buffer->data.raw.slice_buffer.count != 1) {
+      return nullptr;
+    }
+    const grpc_slice& slice = buffer->data.raw.slice_buffer.slices[0];
+    if (slice.refcount == nullptr ||
+        slice.data.refcounted.length != sizeof(Header)) {
+      return nullptr;
+    }
+    Header header;
+    memcpy(&header, slice.data.refcounted.bytes, sizeof(header));
+    if (header.magic != kMagic || header.key != Key() ||
+        header.where != slice.data.refcounted.bytes) {
+      return nullptr;
+    }
+    return header.self;
+  }
+
+ protected:
+  explicit InprocMessage(const void* type) : type_(type) {
+    header_.magic = kMagic;
+    header_.key = Key();
+    header_.where = &header_;
+    header_.self = this;
+  }
+
+ private:
+  struct Header {
+    uint64_t magic;
+    uint64_t key;
+    const void* where;
+    InprocMessage* self;
+  };
+  static constexpr uint64_t kMagic = 0x6d6f7270636e6921;  // "!incprom"
+
+  static uint64_t Key() {
+    static const uint64_t key = [] {
+      std::random_device rd;
+      return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }();
+    return key;
+  }
+
+  static void Destroy(void* message) {
+    delete static_cast<InprocMessage*>(message);
+  }
+
+  Header header_;
+  const void* const type_;
+  std::atomic<bool> consumed_{false};
+};
+
+/// Returns a tag identifying the InprocMessage subclass \a T in
+/// InprocMessage::type().
+template <class T>
+const void* InprocMessageType() {
+  static const char tag = 0;
+  return &tag;
+}
+
+}  // namespace internal
+}  // namespace grpc
+
+#endif  // GRPCPP_IMPL_CODEGEN_INPROC_MESSAGE_H
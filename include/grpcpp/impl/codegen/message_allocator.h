@@ -21,6 +21,10 @@
 
 // IWYU pragma: private, include <grpcpp/support/message_allocator.h>
 
+#include <stddef.h>
+
+#include <memory>
+
 namespace grpc {
 
 // NOTE: This is an API for advanced users who need custom allocators.
@@ -68,6 +72,44 @@ class MessageAllocator {
   virtual MessageHolder<RequestT, ResponseT>* AllocateMessages() = 0;
 };
 
+namespace experimental {
+
+// Options of the pools of protobuf arenas that callback unary methods can
+// allocate their messages from, instead of a custom allocator: see
+// ServerBuilder::experimental_type::SetMessageArenaPool and
+// ArenaMessageAllocator.
+struct MessageArenaPoolOptions {
+  // The initial block of each arena is kept across RPCs, and sized from the
+  // memory the messages of recent RPCs used, within these bounds.
+  size_t min_initial_block_size = 256;
+  size_t max_initial_block_size = 256 * 1024;
+  // The number of idle arenas kept for reuse by each thread.
+  size_t max_idle_arenas_per_thread = 16;
+};
+
+}  // namespace experimental
+
+namespace internal {
+
+class MessageArenaPool;
+
+// Allocates the messages of a method from a MessageArenaPool, for message
+// types that can live on a protobuf arena: the specialization for protobuf
+// messages is in message_arena_pool.h. Others get no pool.
+template <typename RequestT, typename ResponseT, typename = void>
+struct ArenaMessages {
+  static std::shared_ptr<MessageArenaPool> NewPool(
+      const experimental::MessageArenaPoolOptions& /*options*/) {
+    return nullptr;
+  }
+  static MessageHolder<RequestT, ResponseT>* Allocate(
+      MessageArenaPool* /*pool*/) {
+    return nullptr;
+  }
+};
+
+}  // namespace internal
+
 }  // namespace grpc
 
 #endif  // GRPCPP_IMPL_CODEGEN_MESSAGE_ALLOCATOR_H
@@ -0,0 +1,275 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_IMPL_CODEGEN_MESSAGE_ARENA_POOL_H
+#define GRPCPP_IMPL_CODEGEN_MESSAGE_ARENA_POOL_H
+
+// IWYU pragma: private, include <grpcpp/support/message_arena_pool.h>
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include <grpcpp/impl/codegen/config_protobuf.h>
+#include <grpcpp/impl/codegen/message_allocator.h>
+#include <grpcpp/impl/codegen/sync.h>
+
+namespace grpc {
+namespace internal {
+
+/// A pool of protobuf arenas for the messages of RPCs. Arenas are reset
+/// rather than freed once the RPC is done, and keep their initial block, so
+/// that an RPC whose messages fit in that block allocates nothing. The size of
+/// the initial blocks follows the memory the messages of recent RPCs used: it
+/// grows as soon as an RPC needs more, and shrinks after many RPCs needed less
+/// than half of it.
+///
+/// Idle arenas are kept in per-thread free lists (threads are spread over a
+/// shard per core), so that threads rarely contend for them. An arena may be
+/// released by another thread than the one that acquired it.
+class MessageArenaPool {
+ public:
+  class PooledArena {
+   public:
+    protobuf::Arena* arena() { return &arena_; }
+
+   private:
+    friend class MessageArenaPool;
+
+    static protobuf::ArenaOptions Options(char* initial_block,
+                                          size_t initial_block_size) {
+      protobuf::ArenaOptions options;
+      options.initial_block = initial_block;
+      options.initial_block_size = initial_block_size;
+      return options;
+    }
+
+    explicit PooledArena(size_t initial_block_size)
+        : initial_block_size_(initial_block_size),
+          initial_block_(new char[initial_block_size]),
+          arena_(Options(initial_block_.get(), initial_block_size)) {}
+
+    const size_t initial_block_size_;
+    // Must outlive arena_.
+    std::unique_ptr<char[]> initial_block_;
+    protobuf::Arena arena_;
+    PooledArena* next_ = nullptr;
+  };
+
+  explicit MessageArenaPool(const experimental::MessageArenaPoolOptions&
+                                options = experimental::MessageArenaPoolOptions())
+      : options_(options),
+        num_shards_(std::max(1u, std::thread::hardware_concurrency())),
+        shards_(new Shard[num_shards_]),
+        initial_block_size_(RoundUpToPowerOfTwo(options.min_initial_block_size)) {}
+
+  ~MessageArenaPool() {
+    for (size_t i = 0; i < num_shards_; i++) {
+      while (shards_[i].idle != nullptr) {
+        PooledArena* arena = shards_[i].idle;
+        shards_[i].idle = arena->next_;
+        delete arena;
+      }
+    }
+  }
+
+  MessageArenaPool(const MessageArenaPool&) = delete;
+  MessageArenaPool& operator=(const MessageArenaPool&) = delete;
+
+  /// Returns an empty arena.
+  PooledArena* Acquire() {
+    Shard& shard = ShardForThisThread();
+    {
+      grpc::internal::MutexLock lock(&shard.mu);
+      PooledArena* arena = shard.idle;
+      if (arena != nullptr) {
+        shard.idle = arena->next_;
+        shard.num_idle--;
+        return arena;
+      }
+    }
+    return new PooledArena(initial_block_size_.load(std::memory_order_relaxed));
+  }
+
+  /// Destroys the objects on \a arena and returns it to the pool.
+  void Release(PooledArena* arena) {
+    size_t used = static_cast<size_t>(arena->arena_.SpaceUsed());
+    arena->arena_.Reset();
+    size_t initial_block_size = UpdateInitialBlockSize(used);
+    // Drop arenas whose initial block no longer fits: new ones get the
+    // current size.
+    if (arena->initial_block_size_ != initial_block_size) {
+      delete arena;
+      return;
+    }
+    Shard& shard = ShardForThisThread();
+    {
+      grpc::internal::MutexLock lock(&shard.mu);
+      if (shard.num_idle < options_.max_idle_arenas_per_thread) {
+        arena->next_ = shard.idle;
+        shard.idle = arena;
+        shard.num_idle++;
+        return;
+      }
+    }
+    delete arena;
+  }
+
+  /// The size of the initial block of new arenas.
+  size_t initial_block_size() const {
+    return initial_block_size_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // The number of consecutive RPCs using less than half of the initial block
+  // after which it shrinks by half.
+  static constexpr int kReleasesBeforeShrinking = 256;
+
+  struct Shard {
+    grpc::internal::Mutex mu;
+    PooledArena* idle = nullptr;
+    size_t num_idle = 0;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t size) {
+    size_t rounded = 1;
+    while (rounded < size) rounded <<= 1;
+    return rounded;
+  }
+
+  Shard& ShardForThisThread() {
+    static std::atomic<size_t> next_thread_index{0};
+    static thread_local size_t thread_index =
+        next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return shards_[thread_index % num_shards_];
+  }
+
+  // Records that an RPC used \a used bytes of its arena, and returns the size
+  // of the initial block of new arenas. Races between threads only delay the
+  // adaptation.
+  size_t UpdateInitialBlockSize(size_t used) {
+    size_t wanted = RoundUpToPowerOfTwo(
+        std::min(std::max(used, options_.min_initial_block_size),
+                 options_.max_initial_block_size));
+    size_t current = initial_block_size_.load(std::memory_order_relaxed);
+    if (wanted > current) {
+      initial_block_size_.store(wanted, std::memory_order_relaxed);
+      small_releases_.store(0, std::memory_order_relaxed);
+      return wanted;
+    }
+    if (wanted * 2 > current) {
+      small_releases_.store(0, std::memory_order_relaxed);
+      return current;
+    }
+    if (small_releases_.fetch_add(1, std::memory_order_relaxed) + 1 <
+        kReleasesBeforeShrinking) {
+      return current;
+    }
+    small_releases_.store(0, std::memory_order_relaxed);
+    initial_block_size_.store(current / 2, std::memory_order_relaxed);
+    return current / 2;
+  }
+
+  const experimental::MessageArenaPoolOptions options_;
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> initial_block_size_;
+  std::atomic<int> small_releases_{0};
+};
+
+/// Holds the messages of an RPC on an arena of a MessageArenaPool. The holder
+/// itself lives on the arena.
+template <class RequestT, class ResponseT>
+class ArenaMessageHolder : public MessageHolder<RequestT, ResponseT> {
+ public:
+  static ArenaMessageHolder* Create(MessageArenaPool* pool) {
+    MessageArenaPool::PooledArena* arena = pool->Acquire();
+    return protobuf::Arena::Create<ArenaMessageHolder>(arena->arena(), pool,
+                                                       arena);
+  }
+
+  ArenaMessageHolder(MessageArenaPool* pool,
+                     MessageArenaPool::PooledArena* arena)
+      : pool_(pool), arena_(arena) {
+    this->set_request(
+        protobuf::Arena::CreateMessage<RequestT>(arena->arena()));
+    this->set_response(
+        protobuf::Arena::CreateMessage<ResponseT>(arena->arena()));
+  }
+
+  void Release() override {
+    // Resetting the arena destroys this holder along with the messages.
+    pool_->Release(arena_);
+  }
+
+ private:
+  MessageArenaPool* const pool_;
+  MessageArenaPool::PooledArena* const arena_;
+};
+
+template <typename RequestT, typename ResponseT>
+struct ArenaMessages<
+    RequestT, ResponseT,
+    typename std::enable_if<
+        std::is_base_of<protobuf::MessageLite, RequestT>::value &&
+        std::is_base_of<protobuf::MessageLite, ResponseT>::value>::type> {
+  static std::shared_ptr<MessageArenaPool> NewPool(
+      const experimental::MessageArenaPoolOptions& options) {
+    return std::make_shared<MessageArenaPool>(options);
+  }
+  static MessageHolder<RequestT, ResponseT>* Allocate(MessageArenaPool* pool) {
+    return ArenaMessageHolder<RequestT, ResponseT>::Create(pool);
+  }
+};
+
+}  // namespace internal
+
+namespace experimental {
+
+/// A MessageAllocator for protobuf messages that allocates the messages of
+/// each RPC from a pool of arenas. It can be set on a callback unary method
+/// with the SetMessageAllocatorFor_<method> of the generated service. To use
+/// it for all the methods of a server, see
+/// ServerBuilder::experimental_type::SetMessageArenaPool instead.
+///
+/// Messages on an arena cannot be freed before the end of the RPC: FreeRequest
+/// is a no-op.
+template <class RequestT, class ResponseT>
+class ArenaMessageAllocator : public MessageAllocator<RequestT, ResponseT> {
+ public:
+  explicit ArenaMessageAllocator(
+      const MessageArenaPoolOptions& options = MessageArenaPoolOptions())
+      : pool_(options) {}
+
+  MessageHolder<RequestT, ResponseT>* AllocateMessages() override {
+    return ::grpc::internal::ArenaMessageHolder<RequestT, ResponseT>::Create(
+        &pool_);
+  }
+
+ private:
+  ::grpc::internal::MessageArenaPool pool_;
+};
+
+}  // namespace experimental
+}  // namespace grpc
+
+#endif  // GRPCPP_IMPL_CODEGEN_MESSAGE_ARENA_POOL_H
@@ -59,9 +59,15 @@ class ProtoBufferWriter : public ::grpc::protobuf::io::ZeroCopyOutputStream {
   /// \param[out] byte_buffer A pointer to the grpc::ByteBuffer created
   /// \param block_size How big are the chunks to allocate at a time
   /// \param total_size How many total bytes are required for this proto
-  ProtoBufferWriter(ByteBuffer* byte_buffer, int block_size, int total_size)
+  /// \param framed Whether to allocate the chunks with headroom for the
+  /// transport to frame them in place (see GRPC_SLICE_WRITE_HEADROOM). The
+  /// first chunk is then shorter by the size of the message prefix, so that
+  /// each chunk makes a frame of at most \a block_size bytes.
+  ProtoBufferWriter(ByteBuffer* byte_buffer, int block_size, int total_size,
+                    bool framed = false)
       : block_size_(block_size),
         total_size_(total_size),
+        framed_(framed),
         byte_count_(0),
         have_backup_(false) {
     GPR_CODEGEN_ASSERT(!byte_buffer->Valid());
@@ -99,12 +105,17 @@ class ProtoBufferWriter : public ::grpc::protobuf::io::ZeroCopyOutputStream {
     } else {
       // When less than a whole block is needed, only allocate that much.
       // But make sure the allocated slice is not inlined.
-      size_t allocate_length =
-          remain > static_cast<size_t>(block_size_) ? block_size_ : remain;
-      slice_ = g_core_codegen_interface->grpc_slice_malloc(
-          allocate_length > GRPC_SLICE_INLINED_SIZE
-              ? allocate_length
-              : GRPC_SLICE_INLINED_SIZE + 1);
+      size_t block_size = block_size_;
+      if (framed_ && byte_count_ == 0) block_size -= kMessagePrefixLength;
+      size_t allocate_length = remain > block_size ? block_size : remain;
+      if (allocate_length <= GRPC_SLICE_INLINED_SIZE) {
+        allocate_length = GRPC_SLICE_INLINED_SIZE + 1;
+      }
+      slice_ = framed_
+                   ? g_core_codegen_interface->grpc_slice_malloc_with_headroom(
+                         allocate_length, GRPC_SLICE_WRITE_HEADROOM)
+                   : g_core_codegen_interface->grpc_slice_malloc(
+                         allocate_length);
     }
     *data = GRPC_SLICE_START_PTR(slice_);
     // On win x64, int is only 32bit
@@ -153,8 +164,11 @@ class ProtoBufferWriter : public ::grpc::protobuf::io::ZeroCopyOutputStream {
  private:
   // friend for testing purposes only
   friend class internal::ProtoBufferWriterPeer;
+  // The compressed flag and length that precede messages on the wire.
+  static const int kMessagePrefixLength = 5;
   const int block_size_;  ///< size to alloc for each new \a grpc_slice needed
   const int total_size_;  ///< byte size of proto being serialized
+  const bool framed_;     ///< whether slices get headroom for frame headers
   int64_t byte_count_;    ///< bytes written since this object was created
   grpc_slice_buffer*
       slice_buffer_;  ///< internal buffer of slices holding the serialized data
@@ -21,7 +21,9 @@
 
 // IWYU pragma: private
 
+#include <memory>
 #include <type_traits>
+#include <typeinfo>
 
 #include <grpc/impl/codegen/byte_buffer_reader.h>
 #include <grpc/impl/codegen/grpc_types.h>
@@ -29,6 +31,8 @@
 #include <grpcpp/impl/codegen/byte_buffer.h>
 #include <grpcpp/impl/codegen/config_protobuf.h>
 #include <grpcpp/impl/codegen/core_codegen_interface.h>
+#include <grpcpp/impl/codegen/inproc_message.h>
+#include <grpcpp/impl/codegen/message_arena_pool.h>
 #include <grpcpp/impl/codegen/proto_buffer_reader.h>
 #include <grpcpp/impl/codegen/proto_buffer_writer.h>
 #include <grpcpp/impl/codegen/serialization_traits.h>
@@ -62,12 +66,98 @@ Status GenericSerialize(const grpc::protobuf::MessageLite& msg, ByteBuffer* bb,
 
     return g_core_codegen_interface->ok();
   }
-  ProtoBufferWriter writer(bb, kProtoBufferWriterMaxBufferLength, byte_size);
+  // Serialize messages of several frames into chunks the transport can send
+  // as frames as they are. Smaller messages are better off sharing frames.
+  bool framed = byte_size > GRPC_SLICE_WRITE_CHUNK_SIZE;
+  ProtoBufferWriter writer(bb,
+                           framed ? GRPC_SLICE_WRITE_CHUNK_SIZE
+                                  : kProtoBufferWriterMaxBufferLength,
+                           byte_size, framed);
   return msg.SerializeToZeroCopyStream(&writer)
              ? g_core_codegen_interface->ok()
              : Status(StatusCode::INTERNAL, "Failed to serialize message");
 }
 
+namespace internal {
+
+// Generated code hands messages to the library as MessageLite, so passing
+// them as objects relies on their dynamic type. Full messages are moved
+// with reflection when RTTI can tell them apart from lite ones; anything
+// else is copied.
+#if !defined(GRPC_USE_PROTO_LITE) && \
+    (defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti))
+#define GRPC_INPROC_MESSAGE_MOVE 1
+#endif
+
+// Whether \a a and \a b are messages of the same type.
+inline bool SameProtoType(const grpc::protobuf::MessageLite& a,
+                          const grpc::protobuf::MessageLite& b) {
+#ifdef GRPC_INPROC_MESSAGE_MOVE
+  return typeid(a) == typeid(b);
+#else
+  return a.GetTypeName() == b.GetTypeName();
+#endif
+}
+
+// Moves \a from into \a to, a message of the same type.
+inline void MoveProto(grpc::protobuf::MessageLite* from,
+                      grpc::protobuf::MessageLite* to) {
+#ifdef GRPC_INPROC_MESSAGE_MOVE
+  auto* full = dynamic_cast<grpc::protobuf::Message*>(from);
+  if (full != nullptr) {
+    full->GetReflection()->Swap(full,
+                                static_cast<grpc::protobuf::Message*>(to));
+    return;
+  }
+#endif
+  to->Clear();
+  to->CheckTypeAndMergeFrom(*from);
+}
+
+// A protobuf message passed through the inproc transport.
+class ProtoInprocMessage final : public InprocMessage {
+ public:
+  // Takes the contents of \a msg if \a may_move, otherwise copies them.
+  ProtoInprocMessage(const grpc::protobuf::MessageLite& msg, bool may_move)
+      : InprocMessage(InprocMessageType<ProtoInprocMessage>()),
+        message_(msg.New()) {
+    if (may_move) {
+      MoveProto(const_cast<grpc::protobuf::MessageLite*>(&msg),
+                message_.get());
+    } else {
+      message_->CheckTypeAndMergeFrom(msg);
+    }
+  }
+
+  Status Serialize(ByteBuffer* buffer) override {
+    if (!Consume()) {
+      return Status(StatusCode::INTERNAL, "Message was already consumed");
+    }
+    bool own_buffer;
+    return GenericSerialize<ProtoBufferWriter, grpc::protobuf::MessageLite>(
+        *message_, buffer, &own_buffer);
+  }
+
+  grpc::protobuf::MessageLite* message() { return message_.get(); }
+
+ private:
+  std::unique_ptr<grpc::protobuf::MessageLite> message_;
+};
+
+}  // namespace internal
+
+// Wraps \a msg into \a bb as a message object rather than bytes. With
+// \a may_move, the caller gives up \a msg, whose contents are moved rather
+// than copied where possible.
+inline Status GenericSerializeInproc(const grpc::protobuf::MessageLite& msg,
+                                     bool may_move, ByteBuffer* bb) {
+  auto* message = new internal::ProtoInprocMessage(msg, may_move);
+  Slice slice(internal::InprocMessage::ToSlice(message), Slice::STEAL_REF);
+  ByteBuffer tmp(&slice, 1);
+  bb->Swap(&tmp);
+  return g_core_codegen_interface->ok();
+}
+
 // BufferReader must be a subclass of ::protobuf::io::ZeroCopyInputStream.
 template <class ProtoBufferReader, class T>
 Status GenericDeserialize(ByteBuffer* buffer,
@@ -79,6 +169,27 @@ Status GenericDeserialize(ByteBuffer* buffer,
   if (buffer == nullptr) {
     return Status(StatusCode::INTERNAL, "No payload");
   }
+  internal::InprocMessage* inproc =
+      internal::InprocMessageFromByteBuffer(*buffer);
+  if (inproc != nullptr) {
+    // The message was passed as an object: take it if it has our type,
+    // otherwise go through its serialized form.
+    if (inproc->type() ==
+        internal::InprocMessageType<internal::ProtoInprocMessage>()) {
+      auto* proto = static_cast<internal::ProtoInprocMessage*>(inproc);
+      if (internal::SameProtoType(*proto->message(), *msg) &&
+          proto->Consume()) {
+        internal::MoveProto(proto->message(), msg);
+        buffer->Clear();
+        return g_core_codegen_interface->ok();
+      }
+    }
+    ByteBuffer serialized;
+    Status status = inproc->Serialize(&serialized);
+    buffer->Clear();
+    if (!status.ok()) return status;
+    return GenericDeserialize<ProtoBufferReader, T>(&serialized, msg);
+  }
   Status result = g_core_codegen_interface->ok();
   {
     ProtoBufferReader reader(buffer);
@@ -113,6 +224,11 @@ class SerializationTraits<
                             grpc::protobuf::MessageLite* msg) {
     return GenericDeserialize<ProtoBufferReader, T>(buffer, msg);
   }
+
+  static Status SerializeInproc(const grpc::protobuf::MessageLite& msg,
+                                bool may_move, ByteBuffer* bb) {
+    return GenericSerializeInproc(msg, may_move, bb);
+  }
 };
 #endif
 
@@ -35,6 +35,9 @@
 
 namespace grpc {
 class ServerContextBase;
+namespace experimental {
+struct MessageArenaPoolOptions;
+}  // namespace experimental
 namespace internal {
 /// Base class for running an RPC handler.
 class MethodHandler {
@@ -80,6 +83,12 @@ class MethodHandler {
     GPR_CODEGEN_ASSERT(req == nullptr);
     return nullptr;
   }
+
+  /// Allocates the messages of the method from a pool of protobuf arenas, if
+  /// the handler and its message types support it and no MessageAllocator
+  /// was set.
+  virtual void SetMessageArenaPool(
+      const experimental::MessageArenaPoolOptions& /*options*/) {}
 };
 
 /// Server side rpc method class
@@ -55,6 +55,15 @@ namespace grpc {
 ///
 /// Both functions return a Status, allowing them to explain what went
 /// wrong if required.
+///
+/// Implementations may also provide
+///     static Status SerializeInproc(const Message& msg, bool may_move,
+///                                   ByteBuffer* buffer);
+/// which wraps msg into buffer as an object (see
+/// grpc::internal::InprocMessage) for in-process channels created with
+/// GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS. It may move out of msg if
+/// may_move, and must copy it otherwise. Deserialize must then accept such
+/// buffers as well.
 template <class Message,
           class UnusedButHereForPartialTemplateSpecialization = void>
 class SerializationTraits;
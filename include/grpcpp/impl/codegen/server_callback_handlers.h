@@ -43,6 +43,11 @@ class CallbackUnaryHandler : public ::grpc::internal::MethodHandler {
     allocator_ = allocator;
   }
 
+  void SetMessageArenaPool(
+      const experimental::MessageArenaPoolOptions& options) override {
+    arena_pool_ = ArenaMessages<RequestType, ResponseType>::NewPool(options);
+  }
+
   void RunHandler(const HandlerParameter& param) final {
     // Arena allocate a controller structure (that includes request/response)
     ::grpc::g_core_codegen_interface->grpc_call_ref(param.call->call());
@@ -83,10 +88,14 @@ class CallbackUnaryHandler : public ::grpc::internal::MethodHandler {
     ::grpc::ByteBuffer buf;
     buf.set_buffer(req);
     RequestType* request = nullptr;
-    MessageHolder<RequestType, ResponseType>* allocator_state;
+    MessageHolder<RequestType, ResponseType>* allocator_state = nullptr;
     if (allocator_ != nullptr) {
       allocator_state = allocator_->AllocateMessages();
-    } else {
+    } else if (arena_pool_ != nullptr) {
+      allocator_state = ArenaMessages<RequestType, ResponseType>::Allocate(
+          arena_pool_.get());
+    }
+    if (allocator_state == nullptr) {
       allocator_state =
           new (::grpc::g_core_codegen_interface->grpc_call_arena_alloc(
               call, sizeof(DefaultMessageHolder<RequestType, ResponseType>)))
@@ -108,6 +117,7 @@ class CallbackUnaryHandler : public ::grpc::internal::MethodHandler {
                                     const RequestType*, ResponseType*)>
       get_reactor_;
   MessageAllocator<RequestType, ResponseType>* allocator_ = nullptr;
+  std::shared_ptr<MessageArenaPool> arena_pool_;
 
   class ServerCallbackUnaryImpl : public ServerCallbackUnary {
    public:
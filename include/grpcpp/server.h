@@ -21,8 +21,12 @@
 
 #include <grpc/impl/codegen/port_platform.h>
 
+#include <stdint.h>
+
 #include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <grpc/compression.h>
@@ -34,6 +38,7 @@
 #include <grpcpp/impl/codegen/client_interceptor.h>
 #include <grpcpp/impl/codegen/completion_queue.h>
 #include <grpcpp/impl/codegen/grpc_library.h>
+#include <grpcpp/impl/codegen/message_allocator.h>
 #include <grpcpp/impl/codegen/server_interface.h>
 #include <grpcpp/impl/rpc_service_method.h>
 #include <grpcpp/security/server_credentials.h>
@@ -52,6 +57,37 @@ namespace internal {
 class ExternalConnectionAcceptorImpl;
 }  // namespace internal
 
+namespace experimental {
+/// EXPERIMENTAL: Statistics of the calls to one method registered with a
+/// server, kept if the server was built with the GRPC_ARG_SERVER_METHOD_STATS
+/// channel argument. Percentiles are estimated from histograms with four
+/// buckets per power of two, and are within 25% of the exact values.
+struct MethodStats {
+  /// The values recorded for one metric of the calls.
+  struct Distribution {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+  };
+
+  std::string method;
+  /// Empty unless the method was registered for a single host.
+  std::string host;
+  /// From when the call arrived to when it was handed to the application, in
+  /// nanoseconds.
+  Distribution queue_time_ns;
+  /// From when the call was handed to the application to when it sent its
+  /// status, in nanoseconds.
+  Distribution handler_time_ns;
+  /// Message bytes received and sent by the calls.
+  Distribution bytes_in;
+  Distribution bytes_out;
+};
+}  // namespace experimental
+
 /// Represents a gRPC server.
 ///
 /// Use a \a grpc::ServerBuilder to create, configure, and start
@@ -121,6 +157,11 @@ class Server : public ServerInterface, private GrpcLibraryCodegen {
             std::unique_ptr<experimental::ClientInterceptorFactoryInterface>>
             interceptor_creators);
 
+    /// Returns the statistics of the registered methods, which are only kept
+    /// if the server was built with the GRPC_ARG_SERVER_METHOD_STATS channel
+    /// argument. Calls still in progress are not included.
+    std::vector<experimental::MethodStats> GetMethodStats();
+
    private:
     Server* server_;
   };
@@ -247,6 +288,16 @@ class Server : public ServerInterface, private GrpcLibraryCodegen {
     context_allocator_ = std::move(context_allocator);
   }
 
+  /// Switch the thread managers of the sync server completion queues to
+  /// work-stealing mode (see ServerBuilder::PINNED_POLLERS).
+  void EnableSyncServerWorkStealing(int pinned_pollers,
+                                    int target_queueing_delay_usec);
+
+  void RegisterMessageArenaPools(
+      std::map<std::string, experimental::MessageArenaPoolOptions> pools) {
+    message_arena_pools_ = std::move(pools);
+  }
+
   void PerformOpsOnCall(internal::CallOpSetInterface* ops,
                         internal::Call* call) override;
 
@@ -317,6 +368,11 @@ class Server : public ServerInterface, private GrpcLibraryCodegen {
 
   std::unique_ptr<ContextAllocator> context_allocator_;
 
+  // Options of the arena pools of callback unary methods, by method name
+  // ("" for all methods).
+  std::map<std::string, experimental::MessageArenaPoolOptions>
+      message_arena_pools_;
+
   std::unique_ptr<HealthCheckServiceInterface> health_check_service_;
   bool health_check_service_disabled_;
 
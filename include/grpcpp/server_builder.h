@@ -30,6 +30,7 @@
 #include <grpc/support/cpu.h>
 #include <grpc/support/workaround_list.h>
 #include <grpcpp/impl/channel_argument_option.h>
+#include <grpcpp/impl/codegen/message_allocator.h>
 #include <grpcpp/impl/codegen/server_interceptor.h>
 #include <grpcpp/impl/server_builder_option.h>
 #include <grpcpp/impl/server_builder_plugin.h>
@@ -228,7 +229,17 @@ class ServerBuilder {
     NUM_CQS,         ///< Number of completion queues.
     MIN_POLLERS,     ///< Minimum number of polling threads.
     MAX_POLLERS,     ///< Maximum number of polling threads.
-    CQ_TIMEOUT_MSEC  ///< Completion queue timeout in milliseconds.
+    CQ_TIMEOUT_MSEC,  ///< Completion queue timeout in milliseconds.
+    /// Number of polling threads per completion queue, each pinned to a CPU,
+    /// that hand the RPCs they get to a pool of executor threads which steal
+    /// work from each other. The pool grows when RPCs wait longer than
+    /// TARGET_QUEUEING_DELAY_USEC for an executor, and MIN_POLLERS is then
+    /// its minimum size. 0 (the default) keeps polling threads that run the
+    /// RPCs themselves, between MIN_POLLERS and MAX_POLLERS of them.
+    PINNED_POLLERS,
+    /// With PINNED_POLLERS, the queueing delay in microseconds above which
+    /// executor threads are added.
+    TARGET_QUEUEING_DELAY_USEC
   };
 
   /// Only useful if this is a Synchronous server.
@@ -282,6 +293,34 @@ class ServerBuilder {
         std::shared_ptr<experimental::AuthorizationPolicyProviderInterface>
             provider);
 
+    /// Allocates the request and response of callback unary methods from a
+    /// pool of protobuf arenas, which are reset rather than freed after each
+    /// RPC. \a method is the full name of a method
+    /// ("/package.Service/Method"), or empty for all the methods without a
+    /// pool of their own. Methods with a MessageAllocator, and methods whose
+    /// messages are not protobufs, are not affected.
+    void SetMessageArenaPool(
+        const std::string& method,
+        const grpc::experimental::MessageArenaPoolOptions& options =
+            grpc::experimental::MessageArenaPoolOptions()) {
+      builder_->message_arena_pools_[method] = options;
+    }
+
+    /// Bounds the number of calls the server handles at once by a limit that
+    /// follows the latency of its handlers, between \a min_limit and \a
+    /// max_limit (see GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY). Calls above the
+    /// limit fail right away with RESOURCE_EXHAUSTED.
+    void EnableAdaptiveConcurrency(int initial_limit = 20, int min_limit = 1,
+                                   int max_limit = 1000) {
+      builder_->AddChannelArgument(GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY, 1);
+      builder_->AddChannelArgument(GRPC_ARG_SERVER_CONCURRENCY_INITIAL_LIMIT,
+                                   initial_limit);
+      builder_->AddChannelArgument(GRPC_ARG_SERVER_CONCURRENCY_MIN_LIMIT,
+                                   min_limit);
+      builder_->AddChannelArgument(GRPC_ARG_SERVER_CONCURRENCY_MAX_LIMIT,
+                                   max_limit);
+    }
+
    private:
     ServerBuilder* builder_;
   };
@@ -355,7 +394,12 @@ class ServerBuilder {
 
   struct SyncServerSettings {
     SyncServerSettings()
-        : num_cqs(1), min_pollers(1), max_pollers(2), cq_timeout_msec(10000) {}
+        : num_cqs(1),
+          min_pollers(1),
+          max_pollers(2),
+          cq_timeout_msec(10000),
+          pinned_pollers(0),
+          target_queueing_delay_usec(1000) {}
 
     /// Number of server completion queues to create to listen to incoming RPCs.
     int num_cqs;
@@ -370,6 +414,13 @@ class ServerBuilder {
 
     /// The timeout for server completion queue's AsyncNext call.
     int cq_timeout_msec;
+
+    /// Number of CPU-pinned polling threads per completion queue handing
+    /// RPCs to work-stealing executors (0 to not use executors).
+    int pinned_pollers;
+
+    /// The queueing delay above which executors are added.
+    int target_queueing_delay_usec;
   };
 
   int max_receive_message_size_;
@@ -388,6 +439,8 @@ class ServerBuilder {
   grpc_resource_quota* resource_quota_;
   grpc::AsyncGenericService* generic_service_{nullptr};
   std::unique_ptr<ContextAllocator> context_allocator_;
+  std::map<std::string, grpc::experimental::MessageArenaPoolOptions>
+      message_arena_pools_;
   grpc::CallbackGenericService* callback_generic_service_{nullptr};
 
   struct {
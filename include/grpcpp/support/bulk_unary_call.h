@@ -0,0 +1,120 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_SUPPORT_BULK_UNARY_CALL_H
+#define GRPCPP_SUPPORT_BULK_UNARY_CALL_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/impl/codegen/byte_buffer.h>
+#include <grpcpp/impl/codegen/serialization_traits.h>
+#include <grpcpp/impl/codegen/status.h>
+
+namespace grpc {
+namespace internal {
+
+/// The part of experimental::BulkUnaryStub that does not depend on the message
+/// types.
+class BulkUnaryCall {
+ public:
+  /// Registers \a method on \a channel, returning its tag.
+  static void* RegisterMethod(Channel* channel, const std::string& method);
+
+  /// Starts a call to the method of \a method_tag for each of \a requests, and
+  /// calls \a on_done with their statuses and responses once they are all
+  /// done. Requests that are not valid fail with INTERNAL without being sent.
+  static void Start(
+      Channel* channel, void* method_tag, ClientContext* context,
+      std::vector<ByteBuffer> requests,
+      std::function<void(std::vector<Status>, std::vector<ByteBuffer>)>
+          on_done);
+
+ private:
+  class BulkOp;
+};
+
+}  // namespace internal
+
+namespace experimental {
+
+/// Starts unary calls to one method of a channel in bulk, for clients that
+/// issue bursts of many small calls. The calls of a bulk operation share a
+/// single set of options and metadata, converted once, and complete through a
+/// single callback rather than one completion each.
+///
+/// The options of the calls come from one ClientContext: its deadline,
+/// metadata, credentials, wait_for_ready and propagation options. The context
+/// is not bound to the calls: it may be reused or destroyed once Call()
+/// returns, and TryCancel() does not apply to them. The server's initial and
+/// trailing metadata are not reported, and client interceptors are not run.
+template <class RequestType, class ResponseType>
+class BulkUnaryStub {
+ public:
+  /// \a method is the full name of the method, e.g. "/package.Service/Method".
+  BulkUnaryStub(std::shared_ptr<Channel> channel, const std::string& method)
+      : channel_(std::move(channel)),
+        method_tag_(
+            internal::BulkUnaryCall::RegisterMethod(channel_.get(), method)) {}
+
+  /// Starts a call for each of \a requests, with the options of \a context.
+  /// Once they are all done, the response of requests[i] is in
+  /// (*responses)[i] if the status it got is OK, and \a on_done is called with
+  /// the statuses. \a responses must stay alive until then. \a on_done may run
+  /// before Call() returns, e.g. when there are no requests.
+  void Call(ClientContext* context, const std::vector<RequestType>& requests,
+            std::vector<ResponseType>* responses,
+            std::function<void(std::vector<Status>)> on_done) {
+    std::vector<ByteBuffer> buffers(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      bool own_buffer;
+      if (!SerializationTraits<RequestType>::Serialize(requests[i], &buffers[i],
+                                                       &own_buffer)
+               .ok()) {
+        buffers[i].Clear();
+      }
+    }
+    responses->resize(requests.size());
+    internal::BulkUnaryCall::Start(
+        channel_.get(), method_tag_, context, std::move(buffers),
+        [responses, on_done](std::vector<Status> statuses,
+                             std::vector<ByteBuffer> response_buffers) {
+          for (size_t i = 0; i < statuses.size(); i++) {
+            if (!statuses[i].ok()) continue;
+            statuses[i] = SerializationTraits<ResponseType>::Deserialize(
+                &response_buffers[i], &(*responses)[i]);
+            // Deserialize() took over the buffer.
+            response_buffers[i].Release();
+          }
+          on_done(std::move(statuses));
+        });
+  }
+
+ private:
+  const std::shared_ptr<Channel> channel_;
+  void* const method_tag_;
+};
+
+}  // namespace experimental
+}  // namespace grpc
+
+#endif  // GRPCPP_SUPPORT_BULK_UNARY_CALL_H
@@ -0,0 +1,568 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_SUPPORT_COROUTINE_H
+#define GRPCPP_SUPPORT_COROUTINE_H
+
+// C++20 coroutine support for the callback API. The types below are only
+// defined, and GRPCPP_HAS_COROUTINES is only defined to 1, when the compiler
+// supports coroutines (e.g. -std=c++20).
+//
+// On the client, RPCs are awaited from any coroutine type:
+//
+//   grpc::Status status = co_await grpc::experimental::CallUnary(
+//       [&](grpc::ClientUnaryReactor* reactor) {
+//         stub->async()->Echo(&context, &request, &response, reactor);
+//       });
+//
+//   grpc::experimental::ClientBidiStream<EchoRequest, EchoResponse> stream;
+//   stub->async()->BidiStream(&context, &stream);
+//   stream.Start();
+//   bool ok = co_await stream.Write(request);
+//   ok = ok && co_await stream.Read(&response);
+//   co_await stream.WritesDone();
+//   grpc::Status status = co_await stream.Finish();
+//
+// ClientWriteStream (client streaming) and ClientReadStream (server
+// streaming) work the same way, with the operations of their direction.
+//
+// On the server, callback service methods return the reactor of a handler
+// coroutine:
+//
+//   grpc::ServerUnaryReactor* Echo(grpc::CallbackServerContext* context,
+//                                  const EchoRequest* request,
+//                                  EchoResponse* response) override {
+//     return HandleEcho(context, request, response);
+//   }
+//   grpc::experimental::ServerUnaryHandler HandleEcho(
+//       grpc::CallbackServerContext* context, const EchoRequest* request,
+//       EchoResponse* response) {
+//     ...
+//     co_return grpc::Status::OK;
+//   }
+//
+//   grpc::experimental::ServerBidiHandler<EchoRequest, EchoResponse>
+//   HandleBidiStream(grpc::CallbackServerContext* context) {
+//     auto& stream = co_await grpc::experimental::this_stream;
+//     EchoRequest request;
+//     while (co_await stream.Read(&request)) { ... }
+//     co_return grpc::Status::OK;
+//   }
+//
+// ServerReadHandler and ServerWriteHandler, with ServerReadStream and
+// ServerWriteStream, are the handlers of client and server streaming methods.
+//
+// Coroutines resume on the thread that completes the operation they await,
+// inline in the reaction of the library, rather than through an executor: like
+// reactions, they must not block between two co_awaits. An operation that
+// completes before its coroutine is suspended resumes it without suspending
+// at all. Server handlers must take a CallbackServerContext* parameter: their
+// frames are allocated on the arena of the call.
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define GRPCPP_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef GRPCPP_HAS_COROUTINES
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include <grpcpp/impl/codegen/client_callback.h>
+#include <grpcpp/impl/codegen/core_codegen_interface.h>
+#include <grpcpp/impl/codegen/server_callback.h>
+#include <grpcpp/impl/codegen/server_context.h>
+#include <grpcpp/impl/codegen/status.h>
+
+namespace grpc {
+namespace experimental {
+
+namespace internal {
+
+// An operation that one coroutine awaits at a time. Whichever of the
+// coroutine suspending and the operation completing comes second resumes the
+// coroutine, so that an operation that completes inline does not suspend it.
+class AwaitedOp {
+ public:
+  // Returns whether the coroutine must suspend. \a start starts the operation,
+  // and must not touch the awaiter after starting it.
+  template <class StartFn>
+  bool Suspend(std::coroutine_handle<> handle, StartFn&& start) {
+    handle_ = handle;
+    completed_.store(false, std::memory_order_relaxed);
+    start();
+    return !completed_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  void Complete(bool ok) {
+    ok_ = ok;
+    if (completed_.exchange(true, std::memory_order_acq_rel)) {
+      handle_.resume();
+    }
+  }
+
+  bool ok() const { return ok_; }
+
+ private:
+  std::coroutine_handle<> handle_;
+  std::atomic<bool> completed_{false};
+  bool ok_ = false;
+};
+
+// Awaits a stream operation, and returns whether it succeeded. The awaiter
+// holds the lambda that starts the operation, so awaiting does not allocate.
+template <class StartFn>
+class OpAwaiter {
+ public:
+  OpAwaiter(AwaitedOp* op, StartFn start)
+      : op_(op), start_(std::move(start)) {}
+
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    return op_->Suspend(handle, start_);
+  }
+  bool await_resume() { return op_->ok(); }
+
+ private:
+  AwaitedOp* op_;
+  StartFn start_;
+};
+
+// Awaits the status of a client stream, releasing the hold of its Start().
+template <class Stream>
+class ClientFinishAwaiter {
+ public:
+  explicit ClientFinishAwaiter(Stream* stream) : stream_(stream) {}
+
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    Stream* stream = stream_;
+    return stream->done_op_.Suspend(handle,
+                                    [stream]() { stream->RemoveHold(); });
+  }
+  ::grpc::Status await_resume() { return std::move(stream_->status_); }
+
+ private:
+  Stream* stream_;
+};
+
+// Returns the CallbackServerContext among the parameters of a handler.
+template <class Arg, class... Args>
+::grpc::CallbackServerContext* FindServerContext(Arg& arg, Args&... args) {
+  if constexpr (std::is_convertible_v<Arg&, ::grpc::CallbackServerContext*>) {
+    return arg;
+  } else {
+    static_assert(sizeof...(Args) > 0,
+                  "server handlers must take a CallbackServerContext*");
+    return FindServerContext(args...);
+  }
+}
+
+// Allocates the frames of server handlers on the arena of their call.
+struct ArenaAllocatedPromise {
+  template <class... Args>
+  static void* operator new(std::size_t size, Args&... args) {
+    return ::grpc::g_core_codegen_interface->grpc_call_arena_alloc(
+        FindServerContext(args...)->c_call(), size);
+  }
+  // The arena is freed with the call.
+  static void operator delete(void* /*ptr*/, std::size_t /*size*/) {}
+};
+
+}  // namespace internal
+
+/// A coroutine that runs as soon as it is called, and on its own until it
+/// returns, for starting coroutines from code that is not a coroutine.
+class Detached {
+ public:
+  struct promise_type {
+    Detached get_return_object() { return Detached(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+/// Awaits a unary RPC, started by \a start on the ClientUnaryReactor it is
+/// passed, and returns its status.
+template <class StartFn>
+class UnaryCallAwaiter : public ::grpc::ClientUnaryReactor {
+ public:
+  explicit UnaryCallAwaiter(StartFn start) : start_(std::move(start)) {}
+
+  bool await_ready() { return false; }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    return op_.Suspend(handle, [this]() {
+      start_(static_cast<::grpc::ClientUnaryReactor*>(this));
+      StartCall();
+    });
+  }
+  ::grpc::Status await_resume() { return std::move(status_); }
+
+  void OnDone(const ::grpc::Status& s) override {
+    status_ = s;
+    op_.Complete(true);
+  }
+
+ private:
+  StartFn start_;
+  internal::AwaitedOp op_;
+  ::grpc::Status status_;
+};
+
+template <class StartFn>
+UnaryCallAwaiter<StartFn> CallUnary(StartFn start) {
+  return UnaryCallAwaiter<StartFn>(std::move(start));
+}
+
+// The client streams below are passed to the stub as the reactor, then
+// started with Start(), which holds the call open so that operations can be
+// started outside of reactions. Finish() must be awaited before the stream is
+// destroyed. Reads and writes may be awaited concurrently by different
+// coroutines, but only one read and one write at a time.
+
+/// A client bidi stream whose operations are awaited.
+template <class Request, class Response>
+class ClientBidiStream
+    : public ::grpc::ClientBidiReactor<Request, Response> {
+ public:
+  void Start() {
+    this->AddHold();
+    this->StartCall();
+  }
+
+  auto Read(Response* response) {
+    return internal::OpAwaiter(
+        &read_op_, [this, response]() { this->StartRead(response); });
+  }
+
+  /// \a request must outlive the write.
+  auto Write(const Request& request,
+             ::grpc::WriteOptions options = ::grpc::WriteOptions()) {
+    return internal::OpAwaiter(&write_op_, [this, &request, options]() {
+      this->StartWrite(&request, options);
+    });
+  }
+
+  auto WritesDone() {
+    return internal::OpAwaiter(&write_op_,
+                               [this]() { this->StartWritesDone(); });
+  }
+
+  /// Waits for all operations to complete, and returns the status of the RPC.
+  auto Finish() { return internal::ClientFinishAwaiter(this); }
+
+  void OnReadDone(bool ok) override { read_op_.Complete(ok); }
+  void OnWriteDone(bool ok) override { write_op_.Complete(ok); }
+  void OnWritesDoneDone(bool ok) override { write_op_.Complete(ok); }
+  void OnDone(const ::grpc::Status& s) override {
+    status_ = s;
+    done_op_.Complete(true);
+  }
+
+ private:
+  friend class internal::ClientFinishAwaiter<ClientBidiStream>;
+
+  internal::AwaitedOp read_op_;
+  internal::AwaitedOp write_op_;
+  internal::AwaitedOp done_op_;
+  ::grpc::Status status_;
+};
+
+/// A client-streaming call whose operations are awaited. The response is
+/// only valid once Finish() returned OK.
+template <class Request>
+class ClientWriteStream : public ::grpc::ClientWriteReactor<Request> {
+ public:
+  void Start() {
+    this->AddHold();
+    this->StartCall();
+  }
+
+  /// \a request must outlive the write.
+  auto Write(const Request& request,
+             ::grpc::WriteOptions options = ::grpc::WriteOptions()) {
+    return internal::OpAwaiter(&write_op_, [this, &request, options]() {
+      this->StartWrite(&request, options);
+    });
+  }
+
+  auto WritesDone() {
+    return internal::OpAwaiter(&write_op_,
+                               [this]() { this->StartWritesDone(); });
+  }
+
+  /// Waits for all operations to complete, and returns the status of the RPC.
+  auto Finish() { return internal::ClientFinishAwaiter(this); }
+
+  void OnWriteDone(bool ok) override { write_op_.Complete(ok); }
+  void OnWritesDoneDone(bool ok) override { write_op_.Complete(ok); }
+  void OnDone(const ::grpc::Status& s) override {
+    status_ = s;
+    done_op_.Complete(true);
+  }
+
+ private:
+  friend class internal::ClientFinishAwaiter<ClientWriteStream>;
+
+  internal::AwaitedOp write_op_;
+  internal::AwaitedOp done_op_;
+  ::grpc::Status status_;
+};
+
+/// A server-streaming call whose reads are awaited.
+template <class Response>
+class ClientReadStream : public ::grpc::ClientReadReactor<Response> {
+ public:
+  void Start() {
+    this->AddHold();
+    this->StartCall();
+  }
+
+  auto Read(Response* response) {
+    return internal::OpAwaiter(
+        &read_op_, [this, response]() { this->StartRead(response); });
+  }
+
+  /// Waits for all operations to complete, and returns the status of the RPC.
+  auto Finish() { return internal::ClientFinishAwaiter(this); }
+
+  void OnReadDone(bool ok) override { read_op_.Complete(ok); }
+  void OnDone(const ::grpc::Status& s) override {
+    status_ = s;
+    done_op_.Complete(true);
+  }
+
+ private:
+  friend class internal::ClientFinishAwaiter<ClientReadStream>;
+
+  internal::AwaitedOp read_op_;
+  internal::AwaitedOp done_op_;
+  ::grpc::Status status_;
+};
+
+/// The coroutine type of unary server handlers: converts to the
+/// ServerUnaryReactor the service method returns, and finishes the RPC with
+/// the status the handler co_returns.
+class ServerUnaryHandler {
+ public:
+  struct promise_type : internal::ArenaAllocatedPromise {
+    template <class... Args>
+    explicit promise_type(Args&... args)
+        : reactor(internal::FindServerContext(args...)->DefaultReactor()) {}
+
+    ServerUnaryHandler get_return_object() {
+      return ServerUnaryHandler(reactor);
+    }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      void await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+        ::grpc::ServerUnaryReactor* reactor = handle.promise().reactor;
+        ::grpc::Status status = std::move(handle.promise().status);
+        // Finishing may free the call, and the frame with it.
+        handle.destroy();
+        reactor->Finish(std::move(status));
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_value(::grpc::Status s) { status = std::move(s); }
+    void unhandled_exception() { std::terminate(); }
+
+    ::grpc::ServerUnaryReactor* reactor;
+    ::grpc::Status status;
+  };
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  operator ::grpc::ServerUnaryReactor*() const { return reactor_; }
+
+ private:
+  explicit ServerUnaryHandler(::grpc::ServerUnaryReactor* reactor)
+      : reactor_(reactor) {}
+
+  ::grpc::ServerUnaryReactor* reactor_;
+};
+
+// The server streams below live in the frame of their handler, which gets
+// them with co_await this_stream, and only goes away once the library is
+// done with the stream.
+
+/// The stream of a bidi server handler.
+template <class Request, class Response>
+class ServerBidiStream
+    : public ::grpc::ServerBidiReactor<Request, Response> {
+ public:
+  explicit ServerBidiStream(std::coroutine_handle<> frame) : frame_(frame) {}
+
+  auto Read(Request* request) {
+    return internal::OpAwaiter(
+        &read_op_, [this, request]() { this->StartRead(request); });
+  }
+
+  /// \a response must outlive the write.
+  auto Write(const Response& response,
+             ::grpc::WriteOptions options = ::grpc::WriteOptions()) {
+    return internal::OpAwaiter(&write_op_, [this, &response, options]() {
+      this->StartWrite(&response, options);
+    });
+  }
+
+  void OnReadDone(bool ok) override { read_op_.Complete(ok); }
+  void OnWriteDone(bool ok) override { write_op_.Complete(ok); }
+  void OnDone() override { frame_.destroy(); }
+
+ private:
+  std::coroutine_handle<> frame_;
+  internal::AwaitedOp read_op_;
+  internal::AwaitedOp write_op_;
+};
+
+/// The stream of a client-streaming server handler, which fills in the
+/// response before it co_returns.
+template <class Request>
+class ServerReadStream : public ::grpc::ServerReadReactor<Request> {
+ public:
+  explicit ServerReadStream(std::coroutine_handle<> frame) : frame_(frame) {}
+
+  auto Read(Request* request) {
+    return internal::OpAwaiter(
+        &read_op_, [this, request]() { this->StartRead(request); });
+  }
+
+  void OnReadDone(bool ok) override { read_op_.Complete(ok); }
+  void OnDone() override { frame_.destroy(); }
+
+ private:
+  std::coroutine_handle<> frame_;
+  internal::AwaitedOp read_op_;
+};
+
+/// The stream of a server-streaming server handler.
+template <class Response>
+class ServerWriteStream : public ::grpc::ServerWriteReactor<Response> {
+ public:
+  explicit ServerWriteStream(std::coroutine_handle<> frame) : frame_(frame) {}
+
+  /// \a response must outlive the write.
+  auto Write(const Response& response,
+             ::grpc::WriteOptions options = ::grpc::WriteOptions()) {
+    return internal::OpAwaiter(&write_op_, [this, &response, options]() {
+      this->StartWrite(&response, options);
+    });
+  }
+
+  void OnWriteDone(bool ok) override { write_op_.Complete(ok); }
+  void OnDone() override { frame_.destroy(); }
+
+ private:
+  std::coroutine_handle<> frame_;
+  internal::AwaitedOp write_op_;
+};
+
+/// Gets the stream of a streaming server handler.
+struct ThisStream {};
+inline constexpr ThisStream this_stream;
+
+namespace internal {
+
+// The coroutine type of streaming server handlers: converts to the reactor
+// the service method returns, and finishes the RPC with the status the
+// handler co_returns.
+template <class Stream>
+class ServerStreamHandler {
+ public:
+  struct promise_type : ArenaAllocatedPromise {
+    promise_type()
+        : stream(std::coroutine_handle<promise_type>::from_promise(*this)) {}
+
+    ServerStreamHandler get_return_object() {
+      return ServerStreamHandler(&stream);
+    }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      // The frame stays until the stream is done.
+      void await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+        promise_type& promise = handle.promise();
+        promise.stream.Finish(std::move(promise.status));
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    struct StreamAwaiter {
+      bool await_ready() { return true; }
+      void await_suspend(std::coroutine_handle<> /*handle*/) {}
+      Stream& await_resume() { return *stream; }
+
+      Stream* stream;
+    };
+    StreamAwaiter await_transform(ThisStream /*tag*/) { return {&stream}; }
+    template <class Awaitable>
+    Awaitable&& await_transform(Awaitable&& awaitable) {
+      return std::forward<Awaitable>(awaitable);
+    }
+
+    void return_value(::grpc::Status s) { status = std::move(s); }
+    void unhandled_exception() { std::terminate(); }
+
+    Stream stream;
+    ::grpc::Status status;
+  };
+
+  // Converts to the reactor of the stream too, as Stream derives from it.
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  operator Stream*() const { return stream_; }
+
+ private:
+  explicit ServerStreamHandler(Stream* stream) : stream_(stream) {}
+
+  Stream* stream_;
+};
+
+}  // namespace internal
+
+/// The coroutine types of streaming server handlers.
+template <class Request, class Response>
+using ServerBidiHandler =
+    internal::ServerStreamHandler<ServerBidiStream<Request, Response>>;
+template <class Request>
+using ServerReadHandler =
+    internal::ServerStreamHandler<ServerReadStream<Request>>;
+template <class Response>
+using ServerWriteHandler =
+    internal::ServerStreamHandler<ServerWriteStream<Response>>;
+
+}  // namespace experimental
+}  // namespace grpc
+
+#endif  // GRPCPP_HAS_COROUTINES
+
+#endif  // GRPCPP_SUPPORT_COROUTINE_H
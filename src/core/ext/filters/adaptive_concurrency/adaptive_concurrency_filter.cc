@@ -0,0 +1,283 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.h"
+
+#include "src/core/lib/channel/channel_stack_builder.h"
+#include "src/core/lib/channel/concurrency_limiter.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/iomgr/call_combiner.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/surface/channel_init.h"
+
+namespace grpc_core {
+
+namespace {
+
+class ChannelData {
+ public:
+  static grpc_error_handle Init(grpc_channel_element* elem,
+                                grpc_channel_element_args* args);
+  static void Destroy(grpc_channel_element* elem);
+
+  ConcurrencyLimiter* limiter() const { return limiter_.get(); }
+
+ private:
+  explicit ChannelData(grpc_channel_element_args* args)
+      : limiter_(ConcurrencyLimiter::FromChannelArgs(args->channel_args)
+                     ->Ref()) {}
+
+  RefCountedPtr<ConcurrencyLimiter> limiter_;
+};
+
+class CallData {
+ public:
+  static grpc_error_handle Init(grpc_call_element* elem,
+                                const grpc_call_element_args* args);
+  static void Destroy(grpc_call_element* elem,
+                      const grpc_call_final_info* /*final_info*/,
+                      grpc_closure* /*then_schedule_closure*/);
+  static void StartTransportStreamOpBatch(
+      grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
+
+ private:
+  CallData(grpc_call_element* elem, const grpc_call_element_args& args);
+  ~CallData();
+
+  static void RecvInitialMetadataReady(void* arg, grpc_error_handle error);
+  static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
+  static void StartRejectCancelInCallCombiner(void* arg,
+                                              grpc_error_handle error);
+  static void OnRejectCancelComplete(void* arg, grpc_error_handle error);
+
+  // Fails the stream with reject_error_ on the transport, so that the client
+  // gets RESOURCE_EXHAUSTED whatever happens to the call above the filter.
+  void SendRejectCancel(grpc_call_element* elem);
+
+  // Ends the call for the limiter, counting its latency if \a handled.
+  void MaybeRelease(bool handled);
+
+  ConcurrencyLimiter* limiter_;
+  grpc_call_stack* owning_call_;
+  CallCombiner* call_combiner_;
+  bool admitted_ = false;
+  gpr_cycle_counter admitted_at_;
+  // Set when the call was not admitted.
+  grpc_error_handle reject_error_ = GRPC_ERROR_NONE;
+  grpc_closure reject_cancel_closure_;
+  grpc_closure recv_initial_metadata_ready_;
+  grpc_closure* original_recv_initial_metadata_ready_ = nullptr;
+  grpc_closure recv_trailing_metadata_ready_;
+  grpc_closure* original_recv_trailing_metadata_ready_ = nullptr;
+  grpc_error_handle recv_trailing_metadata_error_ = GRPC_ERROR_NONE;
+  bool seen_recv_trailing_metadata_ready_ = false;
+};
+
+// ChannelData
+
+grpc_error_handle ChannelData::Init(grpc_channel_element* elem,
+                                    grpc_channel_element_args* args) {
+  GPR_ASSERT(elem->filter == &AdaptiveConcurrencyFilterVtable);
+  new (elem->channel_data) ChannelData(args);
+  return GRPC_ERROR_NONE;
+}
+
+void ChannelData::Destroy(grpc_channel_element* elem) {
+  auto* chand = static_cast<ChannelData*>(elem->channel_data);
+  chand->~ChannelData();
+}
+
+// CallData
+
+grpc_error_handle CallData::Init(grpc_call_element* elem,
+                                 const grpc_call_element_args* args) {
+  new (elem->call_data) CallData(elem, *args);
+  return GRPC_ERROR_NONE;
+}
+
+void CallData::Destroy(grpc_call_element* elem,
+                       const grpc_call_final_info* /*final_info*/,
+                       grpc_closure* /*then_schedule_closure*/) {
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  calld->~CallData();
+}
+
+CallData::CallData(grpc_call_element* elem, const grpc_call_element_args& args)
+    : limiter_(static_cast<ChannelData*>(elem->channel_data)->limiter()),
+      owning_call_(args.call_stack),
+      call_combiner_(args.call_combiner) {
+  GRPC_CLOSURE_INIT(&recv_initial_metadata_ready_, RecvInitialMetadataReady,
+                    elem, grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&recv_trailing_metadata_ready_, RecvTrailingMetadataReady,
+                    elem, grpc_schedule_on_exec_ctx);
+}
+
+CallData::~CallData() {
+  // The call ended without sending a status, e.g. it was cancelled.
+  MaybeRelease(false);
+  GRPC_ERROR_UNREF(reject_error_);
+}
+
+void CallData::MaybeRelease(bool handled) {
+  if (!admitted_) return;
+  admitted_ = false;
+  int64_t latency_ns = -1;
+  if (handled) {
+    gpr_timespec latency =
+        gpr_cycle_counter_sub(gpr_get_cycle_counter(), admitted_at_);
+    latency_ns = latency.tv_sec * GPR_NS_PER_SEC + latency.tv_nsec;
+  }
+  limiter_->Release(latency_ns);
+}
+
+void CallData::StartTransportStreamOpBatch(
+    grpc_call_element* elem, grpc_transport_stream_op_batch* batch) {
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  if (batch->recv_initial_metadata) {
+    calld->original_recv_initial_metadata_ready_ =
+        batch->payload->recv_initial_metadata.recv_initial_metadata_ready;
+    batch->payload->recv_initial_metadata.recv_initial_metadata_ready =
+        &calld->recv_initial_metadata_ready_;
+  }
+  if (batch->recv_trailing_metadata) {
+    calld->original_recv_trailing_metadata_ready_ =
+        batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready;
+    batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready =
+        &calld->recv_trailing_metadata_ready_;
+  }
+  // The handler is done once it sends the status.
+  if (batch->send_trailing_metadata) calld->MaybeRelease(true);
+  grpc_call_next_op(elem, batch);
+}
+
+void CallData::RecvInitialMetadataReady(void* arg, grpc_error_handle error) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(arg);
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  if (error == GRPC_ERROR_NONE) {
+    if (calld->limiter_->TryAcquire()) {
+      calld->admitted_ = true;
+      calld->admitted_at_ = gpr_get_cycle_counter();
+    } else {
+      calld->reject_error_ = grpc_error_set_int(
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+              "Server concurrency limit reached"),
+          GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_RESOURCE_EXHAUSTED);
+      error = GRPC_ERROR_REF(calld->reject_error_);
+      calld->SendRejectCancel(elem);
+    }
+  } else {
+    error = GRPC_ERROR_REF(error);
+  }
+  grpc_closure* closure = calld->original_recv_initial_metadata_ready_;
+  calld->original_recv_initial_metadata_ready_ = nullptr;
+  if (calld->seen_recv_trailing_metadata_ready_) {
+    GRPC_CALL_COMBINER_START(calld->call_combiner_,
+                             &calld->recv_trailing_metadata_ready_,
+                             calld->recv_trailing_metadata_error_,
+                             "continue recv_trailing_metadata_ready");
+  }
+  Closure::Run(DEBUG_LOCATION, closure, error);
+}
+
+void CallData::SendRejectCancel(grpc_call_element* elem) {
+  GRPC_CALL_STACK_REF(owning_call_, "adaptive_concurrency_reject");
+  GRPC_CLOSURE_INIT(&reject_cancel_closure_, StartRejectCancelInCallCombiner,
+                    elem, nullptr);
+  GRPC_CALL_COMBINER_START(call_combiner_, &reject_cancel_closure_,
+                           GRPC_ERROR_NONE,
+                           "call rejected -- sending cancel_stream op");
+}
+
+void CallData::StartRejectCancelInCallCombiner(void* arg,
+                                               grpc_error_handle /*error*/) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(arg);
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  grpc_transport_stream_op_batch* batch =
+      grpc_make_transport_stream_op(GRPC_CLOSURE_INIT(
+          &calld->reject_cancel_closure_, OnRejectCancelComplete, calld,
+          nullptr));
+  batch->cancel_stream = true;
+  batch->payload->cancel_stream.cancel_error =
+      GRPC_ERROR_REF(calld->reject_error_);
+  grpc_call_next_op(elem, batch);
+}
+
+void CallData::OnRejectCancelComplete(void* arg,
+                                      grpc_error_handle /*error*/) {
+  auto* calld = static_cast<CallData*>(arg);
+  GRPC_CALL_COMBINER_STOP(calld->call_combiner_,
+                          "got on_complete from reject cancel_stream batch");
+  GRPC_CALL_STACK_UNREF(calld->owning_call_, "adaptive_concurrency_reject");
+}
+
+void CallData::RecvTrailingMetadataReady(void* arg, grpc_error_handle error) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(arg);
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  if (calld->original_recv_initial_metadata_ready_ != nullptr) {
+    calld->recv_trailing_metadata_error_ = GRPC_ERROR_REF(error);
+    calld->seen_recv_trailing_metadata_ready_ = true;
+    GRPC_CALL_COMBINER_STOP(calld->call_combiner_,
+                            "deferring recv_trailing_metadata_ready until "
+                            "after recv_initial_metadata_ready");
+    return;
+  }
+  error = grpc_error_add_child(GRPC_ERROR_REF(error),
+                               GRPC_ERROR_REF(calld->reject_error_));
+  Closure::Run(DEBUG_LOCATION, calld->original_recv_trailing_metadata_ready_,
+               error);
+}
+
+bool MaybeAddAdaptiveConcurrencyFilter(grpc_channel_stack_builder* builder,
+                                       void* /*arg*/) {
+  const grpc_channel_args* channel_args =
+      grpc_channel_stack_builder_get_channel_arguments(builder);
+  if (ConcurrencyLimiter::FromChannelArgs(channel_args) == nullptr) {
+    return true;
+  }
+  return grpc_channel_stack_builder_prepend_filter(
+      builder, &AdaptiveConcurrencyFilterVtable, nullptr, nullptr);
+}
+
+}  // namespace
+
+extern const grpc_channel_filter AdaptiveConcurrencyFilterVtable = {
+    CallData::StartTransportStreamOpBatch,
+    grpc_channel_next_op,
+    sizeof(CallData),
+    CallData::Init,
+    grpc_call_stack_ignore_set_pollset_or_pollset_set,
+    CallData::Destroy,
+    sizeof(ChannelData),
+    ChannelData::Init,
+    ChannelData::Destroy,
+    grpc_channel_next_get_info,
+    "adaptive_concurrency",
+};
+
+}  // namespace grpc_core
+
+void grpc_adaptive_concurrency_filter_init(void) {
+  grpc_channel_init_register_stage(GRPC_SERVER_CHANNEL,
+                                   GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
+                                   grpc_core::MaybeAddAdaptiveConcurrencyFilter,
+                                   nullptr);
+}
+
+void grpc_adaptive_concurrency_filter_shutdown(void) {}
@@ -40,6 +40,7 @@
 
 #include "src/core/ext/filters/client_channel/backend_metric.h"
 #include "src/core/ext/filters/client_channel/backup_poller.h"
+#include "src/core/ext/filters/client_channel/client_concurrency_filter.h"
 #include "src/core/ext/filters/client_channel/config_selector.h"
 #include "src/core/ext/filters/client_channel/dynamic_filters.h"
 #include "src/core/ext/filters/client_channel/global_subchannel_pool.h"
@@ -65,6 +66,7 @@
 #include "src/core/lib/iomgr/polling_entity.h"
 #include "src/core/lib/iomgr/work_serializer.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/surface/channel.h"
@@ -574,14 +576,43 @@ class ClientChannel::SubchannelWrapper : public SubchannelInterface {
     return connected_subchannel_.get();
   }
 
-  // Caller must be holding the data-plane mutex.
-  ConnectedSubchannel* connected_subchannel_in_data_plane() const
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
-    return connected_subchannel_in_data_plane_.get();
-  }
+  // Returns the connected subchannel as of the picker generation
+  // generation_id.  May be called without holding any lock: the caller
+  // must hold a ref to the generation, which keeps the returned connected
+  // subchannel alive.
+  ConnectedSubchannel* connected_subchannel_in_data_plane(
+      uint64_t generation_id) const {
+    // A subchannel that has disconnected keeps its last connected
+    // subchannel, which picks made with earlier generations may still use.
+    const uint64_t disconnected_generation =
+        data_plane_disconnected_generation_.load(std::memory_order_acquire);
+    if (disconnected_generation != 0 &&
+        disconnected_generation <= generation_id) {
+      return nullptr;
+    }
+    return data_plane_connected_subchannel_.load(std::memory_order_acquire);
+  }
+  // Applies an update for the picker generation generation_id, before it
+  // becomes current.  The connected subchannel being replaced is moved to
+  // *retired, so that it is kept alive for the picks made with the
+  // current generation.
+  // Caller must be holding the control-plane work_serializer.
   void set_connected_subchannel_in_data_plane(
-      RefCountedPtr<ConnectedSubchannel> connected_subchannel)
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
+      RefCountedPtr<ConnectedSubchannel> connected_subchannel,
+      uint64_t generation_id,
+      std::vector<RefCountedPtr<ConnectedSubchannel>>* retired)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::work_serializer_) {
+    if (connected_subchannel_in_data_plane_ != nullptr) {
+      retired->push_back(std::move(connected_subchannel_in_data_plane_));
+    }
+    if (connected_subchannel != nullptr) {
+      data_plane_connected_subchannel_.store(connected_subchannel.get(),
+                                             std::memory_order_release);
+      data_plane_disconnected_generation_.store(0, std::memory_order_release);
+    } else {
+      data_plane_disconnected_generation_.store(generation_id,
+                                                std::memory_order_release);
+    }
     connected_subchannel_in_data_plane_ = std::move(connected_subchannel);
   }
 
@@ -742,9 +773,16 @@ class ClientChannel::SubchannelWrapper : public SubchannelInterface {
   // To be accessed only in the control plane work_serializer.
   RefCountedPtr<ConnectedSubchannel> connected_subchannel_
       ABSL_GUARDED_BY(&ClientChannel::work_serializer_);
-  // To be accessed only in the data plane mutex.
+  // The connected subchannel used by the data plane, updated along with the
+  // picker.  Once it is replaced, data_plane_connected_subchannel_ may
+  // still point to it until the next connection, which is only read by
+  // picks made with the generations that keep it alive.
   RefCountedPtr<ConnectedSubchannel> connected_subchannel_in_data_plane_
-      ABSL_GUARDED_BY(&ClientChannel::data_plane_mu_);
+      ABSL_GUARDED_BY(&ClientChannel::work_serializer_);
+  // Read by picks without a lock.  The first picker generation that sees the
+  // subchannel disconnected, or 0 if it is connected.
+  std::atomic<ConnectedSubchannel*> data_plane_connected_subchannel_{nullptr};
+  std::atomic<uint64_t> data_plane_disconnected_generation_{0};
 };
 
 //
@@ -1137,6 +1175,11 @@ ClientChannel::ClientChannel(grpc_channel_element_args* args,
   keepalive_time_ = grpc_channel_args_find_integer(
       channel_args_, GRPC_ARG_KEEPALIVE_TIME_MS,
       {-1 /* default value, unset */, 1, INT_MAX});
+  if (grpc_channel_args_find_bool(channel_args_,
+                                  GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY, false)) {
+    concurrency_limiter_ = MakeRefCounted<ConcurrencyLimiter>(
+        ConcurrencyLimiter::ClientOptionsFromChannelArgs(channel_args_));
+  }
   if (!ResolverRegistry::IsValidTarget(target_uri_.get())) {
     *error = GRPC_ERROR_CREATE_FROM_CPP_STRING(
         absl::StrCat("the target uri is not valid: ", target_uri_.get()));
@@ -1498,7 +1541,7 @@ void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
     config_selector =
         MakeRefCounted<DefaultConfigSelector>(saved_service_config_);
   }
-  absl::InlinedVector<grpc_arg, 2> args_to_add = {
+  absl::InlinedVector<grpc_arg, 3> args_to_add = {
       grpc_channel_arg_pointer_create(
           const_cast<char*>(GRPC_ARG_CLIENT_CHANNEL), this,
           &kClientChannelArgPointerVtable),
@@ -1506,6 +1549,11 @@ void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
           const_cast<char*>(GRPC_ARG_SERVICE_CONFIG_OBJ), service_config.get(),
           &kServiceConfigObjArgPointerVtable),
   };
+  // The limiter is only passed to the dynamic filters, so that it does not
+  // make the subchannels of this channel unique to it.
+  if (concurrency_limiter_ != nullptr) {
+    args_to_add.push_back(concurrency_limiter_->MakeChannelArg());
+  }
   grpc_channel_args* new_args = grpc_channel_args_copy_and_add(
       channel_args_, args_to_add.data(), args_to_add.size());
   new_args = config_selector->ModifyChannelArgs(new_args);
@@ -1514,6 +1562,9 @@ void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
   // Construct dynamic filter stack.
   std::vector<const grpc_channel_filter*> filters =
       config_selector->GetFilters();
+  if (concurrency_limiter_ != nullptr) {
+    filters.push_back(&kClientConcurrencyFilterVtable);
+  }
   if (enable_retries) {
     filters.push_back(&kRetryFilterVtable);
   } else {
@@ -1632,6 +1683,13 @@ void ClientChannel::UpdateStateAndPickerLocked(
             channelz::ChannelNode::GetChannelConnectivityStateChangeString(
                 state)));
   }
+  // Set up a new picker generation, which picks will start using once it
+  // becomes current.
+  PickerGeneration* old_generation =
+      picker_generation_.load(std::memory_order_relaxed);
+  PickerGeneration* generation = NewPickerGenerationLocked();
+  generation->id = next_picker_generation_id_++;
+  generation->picker = std::move(picker);
   // Grab data plane lock to do subchannel updates and update the picker.
   //
   // Note that we want to minimize the work done while holding the data
@@ -1640,10 +1698,17 @@ void ClientChannel::UpdateStateAndPickerLocked(
   // the refs until after we release the lock, and then unref them at
   // that point.  This includes the following:
   // - refs to subchannel wrappers in the keys of pending_subchannel_updates_
-  // - ownership of the existing picker in picker_
+  // - the state of the old picker generation
   {
     MutexLock lock(&data_plane_mu_);
-    // Handle subchannel updates.
+    // Handle subchannel updates.  The connected subchannels they replace
+    // may still be used by picks made with the old generation, so they
+    // are kept alive along with it.
+    std::vector<RefCountedPtr<ConnectedSubchannel>> unused;
+    std::vector<RefCountedPtr<ConnectedSubchannel>>* retired =
+        old_generation != nullptr
+            ? &old_generation->retired_connected_subchannels
+            : &unused;
     for (auto& p : pending_subchannel_updates_) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
         gpr_log(GPR_INFO,
@@ -1654,11 +1719,18 @@ void ClientChannel::UpdateStateAndPickerLocked(
       // Note: We do not remove the entry from pending_subchannel_updates_
       // here, since this would unref the subchannel wrapper; instead,
       // we wait until we've released the lock to clear the map.
-      p.first->set_connected_subchannel_in_data_plane(std::move(p.second));
+      p.first->set_connected_subchannel_in_data_plane(std::move(p.second),
+                                                      generation->id, retired);
+    }
+    // Swap out the picker generation.
+    // Note: The old generation's state will be released after the lock is
+    // released, once no picks are using it.
+    generation->refs.fetch_add(PickerGeneration::kCurrent);
+    picker_generation_.store(generation);
+    if (old_generation != nullptr) {
+      old_generation->refs.fetch_sub(PickerGeneration::kCurrent);
+      retired_picker_generations_.push_back(old_generation);
     }
-    // Swap out the picker.
-    // Note: Original value will be destroyed after the lock is released.
-    picker_.swap(picker);
     // Re-process queued picks.
     for (LbQueuedCall* call = lb_queued_calls_; call != nullptr;
          call = call->next) {
@@ -1680,6 +1752,55 @@ void ClientChannel::UpdateStateAndPickerLocked(
   // Clear the pending update map after releasing the lock, to keep the
   // critical section small.
   pending_subchannel_updates_.clear();
+  ReclaimPickerGenerationsLocked();
+}
+
+ClientChannel::PickerGeneration* ClientChannel::NewPickerGenerationLocked() {
+  for (auto& generation : picker_generations_) {
+    if (!generation->in_use) {
+      generation->in_use = true;
+      return generation.get();
+    }
+  }
+  picker_generations_.push_back(absl::make_unique<PickerGeneration>());
+  picker_generations_.back()->in_use = true;
+  return picker_generations_.back().get();
+}
+
+void ClientChannel::ReclaimPickerGenerationsLocked() {
+  while (!retired_picker_generations_.empty()) {
+    PickerGeneration* generation = retired_picker_generations_.front();
+    if (generation->refs.load() != 0) break;
+    retired_picker_generations_.pop_front();
+    generation->picker.reset();
+    generation->retired_connected_subchannels.clear();
+    generation->in_use = false;
+  }
+}
+
+ClientChannel::PickerGeneration* ClientChannel::RefPickerGeneration() {
+  while (true) {
+    PickerGeneration* generation = picker_generation_.load();
+    if (generation == nullptr) return nullptr;
+    // The generation may stop being current before we get the ref, in which
+    // case it may be reclaimed and reused, so we check again.
+    generation->refs.fetch_add(1);
+    if (picker_generation_.load() == generation) return generation;
+    UnrefPickerGeneration(generation);
+  }
+}
+
+void ClientChannel::UnrefPickerGeneration(PickerGeneration* generation) {
+  if (generation->refs.fetch_sub(1) != 1) return;
+  // That was the last pick using a retired generation: release its state
+  // in the control plane work_serializer.
+  GRPC_CHANNEL_STACK_REF(owning_stack_, "ReclaimPickerGenerations");
+  work_serializer_->Run(
+      [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_) {
+        ReclaimPickerGenerationsLocked();
+        GRPC_CHANNEL_STACK_UNREF(owning_stack_, "ReclaimPickerGenerations");
+      },
+      DEBUG_LOCATION);
 }
 
 namespace {
@@ -1720,11 +1841,11 @@ grpc_error_handle ClientChannel::DoPingLocked(grpc_transport_op* op) {
   if (state_tracker_.state() != GRPC_CHANNEL_READY) {
     return GRPC_ERROR_CREATE_FROM_STATIC_STRING("channel not connected");
   }
-  LoadBalancingPolicy::PickResult result;
-  {
-    MutexLock lock(&data_plane_mu_);
-    result = picker_->Pick(LoadBalancingPolicy::PickArgs());
-  }
+  // The current picker generation is only replaced in the work_serializer,
+  // so it cannot go away here.
+  LoadBalancingPolicy::PickResult result =
+      picker_generation_.load(std::memory_order_relaxed)
+          ->picker->Pick(LoadBalancingPolicy::PickArgs());
   return HandlePickResult<grpc_error_handle>(
       &result,
       // Complete pick.
@@ -1866,11 +1987,11 @@ void ClientChannel::RemoveLbQueuedCall(LbQueuedCall* to_remove,
 
 RefCountedPtr<ConnectedSubchannel>
 ClientChannel::GetConnectedSubchannelInDataPlane(
-    SubchannelInterface* subchannel) const {
+    SubchannelInterface* subchannel, const PickerGeneration* generation) const {
   SubchannelWrapper* subchannel_wrapper =
       static_cast<SubchannelWrapper*>(subchannel);
   ConnectedSubchannel* connected_subchannel =
-      subchannel_wrapper->connected_subchannel_in_data_plane();
+      subchannel_wrapper->connected_subchannel_in_data_plane(generation->id);
   if (connected_subchannel == nullptr) return nullptr;
   return connected_subchannel->Ref();
 }
@@ -2518,6 +2639,33 @@ class ClientChannel::LoadBalancedCall::Metadata
   grpc_metadata_batch* batch_;
 };
 
+//
+// ClientChannel::LoadBalancedCall::WriteLatencyForwarder
+//
+
+// Reports the write latencies the transport observes for the call to its
+// attempt tracer, until the attempt ends.
+class ClientChannel::LoadBalancedCall::WriteLatencyForwarder
+    : public WriteLatencyObserver {
+ public:
+  explicit WriteLatencyForwarder(CallTracer::CallAttemptTracer* tracer)
+      : tracer_(tracer) {}
+
+  void OnWriteLatency(const WriteLatency& latency) override {
+    MutexLock lock(&mu_);
+    if (tracer_ != nullptr) tracer_->RecordWriteLatency(latency);
+  }
+
+  void Detach() {
+    MutexLock lock(&mu_);
+    tracer_ = nullptr;
+  }
+
+ private:
+  Mutex mu_;
+  CallTracer::CallAttemptTracer* tracer_ ABSL_GUARDED_BY(mu_);
+};
+
 //
 // ClientChannel::LoadBalancedCall::LbCallState
 //
@@ -2592,7 +2740,14 @@ ClientChannel::LoadBalancedCall::LoadBalancedCall(
       on_call_destruction_complete_(on_call_destruction_complete),
       call_dispatch_controller_(call_dispatch_controller),
       call_attempt_tracer_(
-          GetCallAttemptTracer(args.context, is_transparent_retry)) {}
+          GetCallAttemptTracer(args.context, is_transparent_retry)) {
+  if (call_attempt_tracer_ != nullptr) {
+    write_latency_forwarder_ =
+        MakeRefCounted<WriteLatencyForwarder>(call_attempt_tracer_);
+    call_context_[GRPC_CONTEXT_WRITE_LATENCY_OBSERVER].value =
+        write_latency_forwarder_.get();
+  }
+}
 
 ClientChannel::LoadBalancedCall::~LoadBalancedCall() {
   grpc_slice_unref_internal(path_);
@@ -2615,6 +2770,12 @@ ClientChannel::LoadBalancedCall::~LoadBalancedCall() {
 void ClientChannel::LoadBalancedCall::Orphan() {
   // Compute latency and report it to the tracer.
   if (call_attempt_tracer_ != nullptr) {
+    write_latency_forwarder_->Detach();
+    // A later attempt may have replaced it already.
+    if (call_context_[GRPC_CONTEXT_WRITE_LATENCY_OBSERVER].value ==
+        write_latency_forwarder_.get()) {
+      call_context_[GRPC_CONTEXT_WRITE_LATENCY_OBSERVER].value = nullptr;
+    }
     gpr_timespec latency =
         gpr_cycle_counter_sub(gpr_get_cycle_counter(), lb_call_start_time_);
     call_attempt_tracer_->RecordEnd(latency);
@@ -3075,11 +3236,25 @@ void ClientChannel::LoadBalancedCall::PickDone(void* arg,
 void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
                                                      grpc_error_handle error) {
   auto* self = static_cast<LoadBalancedCall*>(arg);
-  bool pick_complete;
-  {
-    MutexLock lock(&self->chand_->data_plane_mu_);
-    pick_complete = self->PickSubchannelLocked(&error);
+  ClientChannel* chand = self->chand_;
+  // Pick with the current picker without holding the data plane mutex.
+  ClientChannel::PickerGeneration* generation = chand->RefPickerGeneration();
+  bool pick_complete = generation != nullptr &&
+                       self->PickSubchannelWithGeneration(generation, &error);
+  if (!pick_complete) {
+    // The call must be queued until the picker is updated.  Queued picks
+    // are re-processed under the data plane mutex when the picker is
+    // updated, so if it was updated since we picked, we need to pick again.
+    MutexLock lock(&chand->data_plane_mu_);
+    if (generation != nullptr &&
+        chand->picker_generation_.load(std::memory_order_relaxed) ==
+            generation) {
+      self->MaybeAddCallToLbQueuedCallsLocked();
+    } else {
+      pick_complete = self->PickSubchannelLocked(&error);
+    }
   }
+  if (generation != nullptr) chand->UnrefPickerGeneration(generation);
   if (pick_complete) {
     PickDone(self, error);
     GRPC_ERROR_UNREF(error);
@@ -3088,6 +3263,18 @@ void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
 
 bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
     grpc_error_handle* error) {
+  if (PickSubchannelWithGeneration(
+          chand_->picker_generation_.load(std::memory_order_relaxed), error)) {
+    MaybeRemoveCallFromLbQueuedCallsLocked();
+    return true;
+  }
+  MaybeAddCallToLbQueuedCallsLocked();
+  return false;
+}
+
+bool ClientChannel::LoadBalancedCall::PickSubchannelWithGeneration(
+    const ClientChannel::PickerGeneration* generation,
+    grpc_error_handle* error) {
   GPR_ASSERT(connected_subchannel_ == nullptr);
   GPR_ASSERT(subchannel_call_ == nullptr);
   // Grab initial metadata.
@@ -3104,76 +3291,71 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
   pick_args.call_state = &lb_call_state;
   Metadata initial_metadata(this, initial_metadata_batch);
   pick_args.initial_metadata = &initial_metadata;
-  auto result = chand_->picker_->Pick(pick_args);
+  auto result = generation->picker->Pick(pick_args);
+  // The result is 0: complete, 1: queue, 2: fail or 3: drop.
+  GRPC_USDT4(lb_pick, this, result.result.index(), GRPC_SLICE_START_PTR(path_),
+             GRPC_SLICE_LENGTH(path_));
   return HandlePickResult<bool>(
       &result,
       // CompletePick
-      [this](LoadBalancingPolicy::PickResult::Complete* complete_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
-            if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
-              gpr_log(GPR_INFO,
-                      "chand=%p lb_call=%p: LB pick succeeded: subchannel=%p",
-                      chand_, this, complete_pick->subchannel.get());
-            }
-            GPR_ASSERT(complete_pick->subchannel != nullptr);
-            // Grab a ref to the connected subchannel while we're still
-            // holding the data plane mutex.
-            connected_subchannel_ = chand_->GetConnectedSubchannelInDataPlane(
-                complete_pick->subchannel.get());
-            GPR_ASSERT(connected_subchannel_ != nullptr);
-            lb_recv_trailing_metadata_ready_ =
-                std::move(complete_pick->recv_trailing_metadata_ready);
-            MaybeRemoveCallFromLbQueuedCallsLocked();
-            return true;
-          },
+      [this, generation](
+          LoadBalancingPolicy::PickResult::Complete* complete_pick) {
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+          gpr_log(GPR_INFO,
+                  "chand=%p lb_call=%p: LB pick succeeded: subchannel=%p",
+                  chand_, this, complete_pick->subchannel.get());
+        }
+        GPR_ASSERT(complete_pick->subchannel != nullptr);
+        // Grab a ref to the connected subchannel while we're still
+        // holding the picker generation.
+        connected_subchannel_ = chand_->GetConnectedSubchannelInDataPlane(
+            complete_pick->subchannel.get(), generation);
+        GPR_ASSERT(connected_subchannel_ != nullptr);
+        lb_recv_trailing_metadata_ready_ =
+            std::move(complete_pick->recv_trailing_metadata_ready);
+        return true;
+      },
       // QueuePick
-      [this](LoadBalancingPolicy::PickResult::Queue* /*queue_pick*/)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
-            if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
-              gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick queued", chand_,
-                      this);
-            }
-            MaybeAddCallToLbQueuedCallsLocked();
-            return false;
-          },
+      [this](LoadBalancingPolicy::PickResult::Queue* /*queue_pick*/) {
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+          gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick queued", chand_,
+                  this);
+        }
+        return false;
+      },
       // FailPick
       [this, send_initial_metadata_flags,
-       &error](LoadBalancingPolicy::PickResult::Fail* fail_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
-            if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
-              gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick failed: %s",
-                      chand_, this, fail_pick->status.ToString().c_str());
-            }
-            // If wait_for_ready is false, then the error indicates the RPC
-            // attempt's final status.
-            if ((send_initial_metadata_flags &
-                 GRPC_INITIAL_METADATA_WAIT_FOR_READY) == 0) {
-              grpc_error_handle lb_error =
-                  absl_status_to_grpc_error(fail_pick->status);
-              *error = GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
-                  "Failed to pick subchannel", &lb_error, 1);
-              GRPC_ERROR_UNREF(lb_error);
-              MaybeRemoveCallFromLbQueuedCallsLocked();
-              return true;
-            }
-            // If wait_for_ready is true, then queue to retry when we get a new
-            // picker.
-            MaybeAddCallToLbQueuedCallsLocked();
-            return false;
-          },
+       &error](LoadBalancingPolicy::PickResult::Fail* fail_pick) {
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+          gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick failed: %s", chand_,
+                  this, fail_pick->status.ToString().c_str());
+        }
+        // If wait_for_ready is false, then the error indicates the RPC
+        // attempt's final status.
+        if ((send_initial_metadata_flags &
+             GRPC_INITIAL_METADATA_WAIT_FOR_READY) == 0) {
+          grpc_error_handle lb_error =
+              absl_status_to_grpc_error(fail_pick->status);
+          *error = GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+              "Failed to pick subchannel", &lb_error, 1);
+          GRPC_ERROR_UNREF(lb_error);
+          return true;
+        }
+        // If wait_for_ready is true, then queue to retry when we get a new
+        // picker.
+        return false;
+      },
       // DropPick
-      [this, &error](LoadBalancingPolicy::PickResult::Drop* drop_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
-            if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
-              gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick dropped: %s",
-                      chand_, this, drop_pick->status.ToString().c_str());
-            }
-            *error =
-                grpc_error_set_int(absl_status_to_grpc_error(drop_pick->status),
-                                   GRPC_ERROR_INT_LB_POLICY_DROP, 1);
-            MaybeRemoveCallFromLbQueuedCallsLocked();
-            return true;
-          });
+      [this, &error](LoadBalancingPolicy::PickResult::Drop* drop_pick) {
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+          gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick dropped: %s",
+                  chand_, this, drop_pick->status.ToString().c_str());
+        }
+        *error =
+            grpc_error_set_int(absl_status_to_grpc_error(drop_pick->status),
+                               GRPC_ERROR_INT_LB_POLICY_DROP, 1);
+        return true;
+      });
 }
 
 }  // namespace grpc_core
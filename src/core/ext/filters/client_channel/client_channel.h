@@ -19,10 +19,13 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/types/optional.h"
@@ -40,6 +43,7 @@
 #include "src/core/ext/filters/client_channel/subchannel.h"
 #include "src/core/ext/filters/client_channel/subchannel_pool_interface.h"
 #include "src/core/lib/channel/call_tracer.h"
+#include "src/core/lib/channel/concurrency_limiter.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/iomgr/polling_entity.h"
@@ -194,6 +198,30 @@ class ClientChannel {
     LoadBalancedCall* lb_call;
     LbQueuedCall* next = nullptr;
   };
+  // A picker, along with the data plane state that must stay alive while
+  // picks made with it are in progress.  Picks take a ref to the current
+  // generation without holding data_plane_mu_.  Generations are therefore
+  // only freed when the channel is destroyed, so that a pick may
+  // speculatively ref one that is no longer current: they are reused once
+  // they have no picks left, and their picker is destroyed in the control
+  // plane work_serializer.
+  struct PickerGeneration {
+    // Added to refs while the generation is the channel's current one.
+    static constexpr intptr_t kCurrent = intptr_t(1) << 30;
+    // Generations are numbered in the order they became current, from 1.
+    // Set before the generation becomes current.
+    uint64_t id = 0;
+    // Set before the generation becomes current.
+    std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker;
+    // Connected subchannels that were replaced while this generation was
+    // current, which picks made with it may still be reading.
+    std::vector<RefCountedPtr<ConnectedSubchannel>> retired_connected_subchannels;
+    // The picks in progress, plus kCurrent while current.
+    std::atomic<intptr_t> refs{0};
+    // Whether the generation is current or retired, as opposed to ready for
+    // reuse.  Accessed only in the control plane work_serializer.
+    bool in_use = false;
+  };
 
   ClientChannel(grpc_channel_element_args* args, grpc_error_handle* error);
   ~ClientChannel();
@@ -263,9 +291,25 @@ class ClientChannel {
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
   void RemoveLbQueuedCall(LbQueuedCall* to_remove, grpc_polling_entity* pollent)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
+
+  // Returns a ref to the current picker generation, or null if there is no
+  // picker yet.  Does not require holding any lock.
+  PickerGeneration* RefPickerGeneration();
+  void UnrefPickerGeneration(PickerGeneration* generation);
+  // Returns the connected subchannel of subchannel as of generation, which
+  // the caller must hold a ref to (or hold data_plane_mu_ if generation is
+  // the current one).
   RefCountedPtr<ConnectedSubchannel> GetConnectedSubchannelInDataPlane(
-      SubchannelInterface* subchannel) const
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
+      SubchannelInterface* subchannel,
+      const PickerGeneration* generation) const;
+
+  // Returns a picker generation that is not in use.
+  PickerGeneration* NewPickerGenerationLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
+  // Releases the state of the retired picker generations that have no picks
+  // in progress, oldest first.
+  void ReclaimPickerGenerationsLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
 
   //
   // Fields set at construction and never modified.
@@ -279,6 +323,9 @@ class ClientChannel {
   UniquePtr<char> target_uri_;
   channelz::ChannelNode* channelz_node_;
   grpc_pollset_set* interested_parties_;
+  // Set for GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY. Kept across resolver
+  // updates, unlike the dynamic filters that use it.
+  RefCountedPtr<ConcurrencyLimiter> concurrency_limiter_;
 
   //
   // Fields related to name resolution.  Guarded by resolution_mu_.
@@ -301,8 +348,10 @@ class ClientChannel {
   // Fields used in the data plane.  Guarded by data_plane_mu_.
   //
   mutable Mutex data_plane_mu_;
-  std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker_
-      ABSL_GUARDED_BY(data_plane_mu_);
+  // The current picker generation.  Read without a lock by picks, and
+  // updated while holding data_plane_mu_, so that calls only queue with
+  // the current picker.
+  std::atomic<PickerGeneration*> picker_generation_{nullptr};
   // Linked list of calls queued waiting for LB pick.
   LbQueuedCall* lb_queued_calls_ ABSL_GUARDED_BY(data_plane_mu_) = nullptr;
 
@@ -337,6 +386,15 @@ class ClientChannel {
   // applied in the data plane mutex when the picker is updated.
   std::map<RefCountedPtr<SubchannelWrapper>, RefCountedPtr<ConnectedSubchannel>>
       pending_subchannel_updates_ ABSL_GUARDED_BY(work_serializer_);
+  // All of the picker generations, including the current one.
+  std::vector<std::unique_ptr<PickerGeneration>> picker_generations_
+      ABSL_GUARDED_BY(work_serializer_);
+  // The generations that were replaced but whose state was not released
+  // yet, oldest first.  Picks made with a generation may read connected
+  // subchannels retired by later ones, so they are released in order.
+  std::deque<PickerGeneration*> retired_picker_generations_
+      ABSL_GUARDED_BY(work_serializer_);
+  uint64_t next_picker_generation_id_ ABSL_GUARDED_BY(work_serializer_) = 1;
   int keepalive_time_ ABSL_GUARDED_BY(work_serializer_) = -1;
   grpc_error_handle disconnect_error_ ABSL_GUARDED_BY(work_serializer_) =
       GRPC_ERROR_NONE;
@@ -384,11 +442,13 @@ class ClientChannel::LoadBalancedCall
 
   void StartTransportStreamOpBatch(grpc_transport_stream_op_batch* batch);
 
-  // Invoked by channel for queued LB picks when the picker is updated.
+  // Performs the LB pick of the call.  It holds the data plane mutex only
+  // if the call must be queued.
   static void PickSubchannel(void* arg, grpc_error_handle error);
-  // Helper function for performing an LB pick while holding the data plane
-  // mutex.  Returns true if the pick is complete, in which case the caller
-  // must invoke PickDone() or AsyncPickDone() with the returned error.
+  // Helper function for performing an LB pick with the current picker while
+  // holding the data plane mutex, used for queued LB picks when the picker
+  // is updated.  Returns true if the pick is complete, in which case the
+  // caller must invoke PickDone() or AsyncPickDone() with the returned error.
   bool PickSubchannelLocked(grpc_error_handle* error)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_);
   // Schedules a callback to process the completed pick.  The callback
@@ -403,6 +463,7 @@ class ClientChannel::LoadBalancedCall
   class LbQueuedCallCanceller;
   class Metadata;
   class LbCallState;
+  class WriteLatencyForwarder;
 
   // Returns the index into pending_batches_ to be used for batch.
   static size_t GetBatchIndex(grpc_transport_stream_op_batch* batch);
@@ -439,6 +500,12 @@ class ClientChannel::LoadBalancedCall
   static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
 
   void CreateSubchannelCall();
+  // Performs an LB pick with the picker of generation, which the caller
+  // holds a ref to.  Returns true if the pick is complete, with *error set
+  // if it failed, or false if the call must be queued.
+  bool PickSubchannelWithGeneration(
+      const ClientChannel::PickerGeneration* generation,
+      grpc_error_handle* error);
   // Invoked when a pick is completed, on both success or failure.
   static void PickDone(void* arg, grpc_error_handle error);
   // Removes the call from the channel's list of queued picks if present.
@@ -464,6 +531,8 @@ class ClientChannel::LoadBalancedCall
   ConfigSelector::CallDispatchController* call_dispatch_controller_;
 
   CallTracer::CallAttemptTracer* call_attempt_tracer_;
+  // Set when there is a call attempt tracer.
+  RefCountedPtr<WriteLatencyForwarder> write_latency_forwarder_;
 
   gpr_cycle_counter lb_call_start_time_ = gpr_get_cycle_counter();
 
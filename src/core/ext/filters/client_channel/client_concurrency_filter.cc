@@ -0,0 +1,218 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/client_channel/client_concurrency_filter.h"
+
+#include "src/core/ext/filters/client_channel/retry_service_config.h"
+#include "src/core/ext/filters/client_channel/retry_throttle.h"
+#include "src/core/lib/channel/concurrency_limiter.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/iomgr/call_combiner.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/transport/error_utils.h"
+
+namespace grpc_core {
+
+namespace {
+
+class ChannelData {
+ public:
+  static grpc_error_handle Init(grpc_channel_element* elem,
+                                grpc_channel_element_args* args);
+  static void Destroy(grpc_channel_element* elem);
+
+  ConcurrencyLimiter* limiter() const { return limiter_.get(); }
+  internal::ServerRetryThrottleData* retry_throttle_data() const {
+    return retry_throttle_data_.get();
+  }
+
+ private:
+  ChannelData(const grpc_channel_args* args, grpc_error_handle* error)
+      : limiter_(ConcurrencyLimiter::FromChannelArgs(args)->Ref()),
+        retry_throttle_data_(
+            internal::GetRetryThrottleDataFromChannelArgs(args, error)) {}
+
+  RefCountedPtr<ConcurrencyLimiter> limiter_;
+  // The same data as the retry filter's, if retries are throttled.
+  RefCountedPtr<internal::ServerRetryThrottleData> retry_throttle_data_;
+};
+
+class CallData {
+ public:
+  static grpc_error_handle Init(grpc_call_element* elem,
+                                const grpc_call_element_args* args);
+  static void Destroy(grpc_call_element* elem,
+                      const grpc_call_final_info* /*final_info*/,
+                      grpc_closure* /*then_schedule_closure*/);
+  static void StartTransportStreamOpBatch(
+      grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
+
+ private:
+  CallData(grpc_call_element* elem, const grpc_call_element_args& args);
+  ~CallData();
+
+  static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
+
+  // Admits the call, or sets reject_error_.
+  void Admit(ChannelData* chand);
+  // Ends the call for the limiter, counting its latency if \a completed.
+  void MaybeRelease(bool completed);
+
+  ConcurrencyLimiter* limiter_;
+  CallCombiner* call_combiner_;
+  grpc_millis deadline_;
+  bool admitted_ = false;
+  gpr_cycle_counter admitted_at_;
+  // Set when the call was not admitted: it then fails all its batches but
+  // cancel_stream ones.
+  grpc_error_handle reject_error_ = GRPC_ERROR_NONE;
+  grpc_closure recv_trailing_metadata_ready_;
+  grpc_closure* original_recv_trailing_metadata_ready_ = nullptr;
+};
+
+// ChannelData
+
+grpc_error_handle ChannelData::Init(grpc_channel_element* elem,
+                                    grpc_channel_element_args* args) {
+  GPR_ASSERT(elem->filter == &kClientConcurrencyFilterVtable);
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  new (elem->channel_data) ChannelData(args->channel_args, &error);
+  return error;
+}
+
+void ChannelData::Destroy(grpc_channel_element* elem) {
+  auto* chand = static_cast<ChannelData*>(elem->channel_data);
+  chand->~ChannelData();
+}
+
+// CallData
+
+grpc_error_handle CallData::Init(grpc_call_element* elem,
+                                 const grpc_call_element_args* args) {
+  new (elem->call_data) CallData(elem, *args);
+  return GRPC_ERROR_NONE;
+}
+
+void CallData::Destroy(grpc_call_element* elem,
+                       const grpc_call_final_info* /*final_info*/,
+                       grpc_closure* /*then_schedule_closure*/) {
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  calld->~CallData();
+}
+
+CallData::CallData(grpc_call_element* elem, const grpc_call_element_args& args)
+    : limiter_(static_cast<ChannelData*>(elem->channel_data)->limiter()),
+      call_combiner_(args.call_combiner),
+      deadline_(args.deadline) {
+  GRPC_CLOSURE_INIT(&recv_trailing_metadata_ready_, RecvTrailingMetadataReady,
+                    elem, grpc_schedule_on_exec_ctx);
+}
+
+CallData::~CallData() {
+  // The call ended without receiving a status.
+  MaybeRelease(false);
+  GRPC_ERROR_UNREF(reject_error_);
+}
+
+void CallData::Admit(ChannelData* chand) {
+  if (limiter_->TryAcquire()) {
+    admitted_ = true;
+    admitted_at_ = gpr_get_cycle_counter();
+    return;
+  }
+  reject_error_ = grpc_error_set_int(
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Client concurrency limit reached"),
+      GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_RESOURCE_EXHAUSTED);
+  // Shedding calls means the backends are overloaded: make the calls that
+  // did get through less likely to add retries to their load.
+  if (chand->retry_throttle_data() != nullptr) {
+    chand->retry_throttle_data()->RecordFailure();
+  }
+}
+
+void CallData::MaybeRelease(bool completed) {
+  if (!admitted_) return;
+  admitted_ = false;
+  int64_t latency_ns = -1;
+  if (completed) {
+    gpr_timespec latency =
+        gpr_cycle_counter_sub(gpr_get_cycle_counter(), admitted_at_);
+    latency_ns = latency.tv_sec * GPR_NS_PER_SEC + latency.tv_nsec;
+  }
+  limiter_->Release(latency_ns);
+}
+
+void CallData::StartTransportStreamOpBatch(
+    grpc_call_element* elem, grpc_transport_stream_op_batch* batch) {
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  if (batch->send_initial_metadata) {
+    calld->Admit(static_cast<ChannelData*>(elem->channel_data));
+  }
+  // Cancellations always go down, so that the filters below release what
+  // they hold for the call, even once it was rejected here.
+  if (batch->cancel_stream) {
+    grpc_call_next_op(elem, batch);
+    return;
+  }
+  if (calld->reject_error_ != GRPC_ERROR_NONE) {
+    grpc_transport_stream_op_batch_finish_with_failure(
+        batch, GRPC_ERROR_REF(calld->reject_error_), calld->call_combiner_);
+    return;
+  }
+  if (batch->recv_trailing_metadata) {
+    calld->original_recv_trailing_metadata_ready_ =
+        batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready;
+    batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready =
+        &calld->recv_trailing_metadata_ready_;
+  }
+  grpc_call_next_op(elem, batch);
+}
+
+void CallData::RecvTrailingMetadataReady(void* arg, grpc_error_handle error) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(arg);
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  // Any status from the server counts, and so does running out of time
+  // waiting for one: the deadline then bounds the latency of the call.
+  grpc_status_code status = GRPC_STATUS_OK;
+  if (error != GRPC_ERROR_NONE) {
+    grpc_error_get_status(error, calld->deadline_, &status, nullptr, nullptr,
+                          nullptr);
+  }
+  calld->MaybeRelease(error == GRPC_ERROR_NONE ||
+                      status == GRPC_STATUS_DEADLINE_EXCEEDED);
+  Closure::Run(DEBUG_LOCATION, calld->original_recv_trailing_metadata_ready_,
+               GRPC_ERROR_REF(error));
+}
+
+}  // namespace
+
+const grpc_channel_filter kClientConcurrencyFilterVtable = {
+    CallData::StartTransportStreamOpBatch,
+    grpc_channel_next_op,
+    sizeof(CallData),
+    CallData::Init,
+    grpc_call_stack_ignore_set_pollset_or_pollset_set,
+    CallData::Destroy,
+    sizeof(ChannelData),
+    ChannelData::Init,
+    ChannelData::Destroy,
+    grpc_channel_next_get_info,
+    "client_concurrency",
+};
+
+}  // namespace grpc_core
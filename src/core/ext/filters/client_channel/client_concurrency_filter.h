@@ -0,0 +1,36 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_CLIENT_CONCURRENCY_FILTER_H
+#define GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_CLIENT_CONCURRENCY_FILTER_H
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/channel/channel_stack.h"
+
+namespace grpc_core {
+
+// Dynamic filter admitting calls through the ConcurrencyLimiter of the client
+// channel (see GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY), and reporting to it the
+// time from the start of admitted calls to their status. It sits above the
+// retry filter, so that a call holds a single slot for all its attempts.
+// Calls that are not admitted fail with RESOURCE_EXHAUSTED without being
+// retried, and count as failures for retry throttling.
+extern const grpc_channel_filter kClientConcurrencyFilterVtable;
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_CLIENT_CONCURRENCY_FILTER_H
@@ -0,0 +1,1156 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <set>
+
+#include "absl/random/random.h"
+#include "absl/types/optional.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy.h"
+#include "src/core/ext/filters/client_channel/lb_policy/child_policy_handler.h"
+#include "src/core/ext/filters/client_channel/lb_policy_factory.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "src/core/lib/json/json_util.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_outlier_detection_lb_trace(false, "outlier_detection_lb");
+
+namespace {
+
+constexpr char kOutlierDetection[] = "outlier_detection_experimental";
+
+// Parameters of outlier detection.  They follow the outlier_detection
+// fields of xDS clusters, plus an ejection of addresses with high latency.
+struct OutlierDetectionParams {
+  // Ejects the addresses whose success rate is more than stdev_factor / 1000
+  // standard deviations below the mean of the addresses.
+  struct SuccessRateEjection {
+    uint32_t stdev_factor = 1900;
+    uint32_t enforcement_percentage = 100;
+    uint32_t minimum_hosts = 5;
+    uint32_t request_volume = 100;
+  };
+  // Ejects the addresses with more than threshold percent of failed calls.
+  struct FailurePercentageEjection {
+    uint32_t threshold = 85;
+    uint32_t enforcement_percentage = 0;
+    uint32_t minimum_hosts = 5;
+    uint32_t request_volume = 50;
+  };
+  // Ejects the addresses whose latency at the given percentile is more than
+  // threshold percent of the median of that latency over the addresses.
+  struct LatencyEjection {
+    uint32_t percentile = 99;
+    uint32_t threshold = 200;
+    uint32_t enforcement_percentage = 100;
+    uint32_t minimum_hosts = 5;
+    uint32_t request_volume = 100;
+  };
+
+  grpc_millis interval = 10 * GPR_MS_PER_SEC;
+  grpc_millis base_ejection_time = 30 * GPR_MS_PER_SEC;
+  grpc_millis max_ejection_time = 300 * GPR_MS_PER_SEC;
+  uint32_t max_ejection_percent = 10;
+  absl::optional<SuccessRateEjection> success_rate_ejection;
+  absl::optional<FailurePercentageEjection> failure_percentage_ejection;
+  absl::optional<LatencyEjection> latency_ejection;
+};
+
+// Config for outlier_detection LB policy.
+class OutlierDetectionLbConfig : public LoadBalancingPolicy::Config {
+ public:
+  OutlierDetectionLbConfig(
+      OutlierDetectionParams params,
+      RefCountedPtr<LoadBalancingPolicy::Config> child_policy)
+      : params_(std::move(params)), child_policy_(std::move(child_policy)) {}
+
+  const char* name() const override { return kOutlierDetection; }
+
+  const OutlierDetectionParams& params() const { return params_; }
+  RefCountedPtr<LoadBalancingPolicy::Config> child_policy() const {
+    return child_policy_;
+  }
+
+  // Returns true if any ejection algorithm is enabled, in which case the
+  // results of the calls need to be counted.
+  bool CountingEnabled() const {
+    return params_.success_rate_ejection.has_value() ||
+           params_.failure_percentage_ejection.has_value() ||
+           params_.latency_ejection.has_value();
+  }
+
+ private:
+  OutlierDetectionParams params_;
+  RefCountedPtr<LoadBalancingPolicy::Config> child_policy_;
+};
+
+// A histogram of call latencies, in microseconds.  Latencies below 4us have
+// their own bucket, and every power of two above that is split in 4 buckets,
+// so that the buckets are within 25% of the latencies they count.
+constexpr size_t kNumLatencyBuckets = 160;
+
+size_t LatencyBucket(uint64_t latency_us) {
+  if (latency_us < 4) return latency_us;
+  size_t msb = 0;
+  for (uint64_t v = latency_us; v > 1; v >>= 1) ++msb;
+  size_t bucket = (msb - 1) * 4 + ((latency_us >> (msb - 2)) & 3);
+  return std::min(bucket, kNumLatencyBuckets - 1);
+}
+
+// Returns the smallest latency counted in bucket.
+uint64_t LatencyBucketLowerBound(size_t bucket) {
+  if (bucket < 4) return bucket;
+  return static_cast<uint64_t>(4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+// outlier_detection LB policy.
+class OutlierDetectionLb : public LoadBalancingPolicy {
+ public:
+  explicit OutlierDetectionLb(Args args);
+
+  const char* name() const override { return kOutlierDetection; }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ExitIdleLocked() override;
+  void ResetBackoffLocked() override;
+
+ private:
+  class SubchannelWrapper;
+
+  // The call counters and ejection state of an address.  The counters are
+  // updated without locks by the calls to the address, and read by the
+  // control plane once per interval.
+  class AddressState : public RefCounted<AddressState> {
+   public:
+    struct IntervalCounts {
+      uint64_t successes = 0;
+      uint64_t failures = 0;
+      uint64_t latency[kNumLatencyBuckets] = {};
+
+      uint64_t volume() const { return successes + failures; }
+      // Returns the latency at percentile, in microseconds.
+      uint64_t LatencyAtPercentile(uint32_t percentile) const;
+    };
+
+    // Records a call to the address.  latency_us is only used if
+    // record_latency is true.
+    void AddCall(bool success, bool record_latency, uint64_t latency_us) {
+      (success ? successes_ : failures_)
+          .fetch_add(1, std::memory_order_relaxed);
+      if (record_latency) {
+        latency_[LatencyBucket(latency_us)].fetch_add(
+            1, std::memory_order_relaxed);
+      }
+    }
+
+    // Returns the calls counted since the previous call.
+    void TakeIntervalCountsLocked(IntervalCounts* counts);
+
+    bool ejected() const { return ejected_; }
+    void EjectLocked(grpc_millis now);
+    void UnejectLocked();
+    // Unejects the address if its ejection time has elapsed, or decreases
+    // its ejection multiplier if it is not ejected.
+    void MaybeUnejectLocked(const OutlierDetectionParams& params,
+                            grpc_millis now);
+    // Unejects the address and forgets its past ejections.
+    void ResetLocked();
+
+    void AddSubchannel(SubchannelWrapper* wrapper);
+    void RemoveSubchannel(SubchannelWrapper* wrapper);
+
+   private:
+    // Returns refs to the subchannel wrappers of the address.
+    std::vector<RefCountedPtr<SubchannelWrapper>> GetSubchannels();
+
+    std::atomic<uint64_t> successes_{0};
+    std::atomic<uint64_t> failures_{0};
+    std::atomic<uint64_t> latency_[kNumLatencyBuckets] = {};
+
+    // The values of the counters at the end of the previous interval.
+    // Accessed only in the control plane work serializer.
+    IntervalCounts previous_;
+    bool ejected_ = false;
+    grpc_millis ejection_time_ = 0;
+    uint32_t ejection_multiplier_ = 0;
+
+    // Wrappers can be destroyed outside of the work serializer.
+    Mutex mu_;
+    std::set<SubchannelWrapper*> subchannels_ ABSL_GUARDED_BY(mu_);
+  };
+
+  // Wraps the subchannels of an address, reporting them as in
+  // TRANSIENT_FAILURE to the child policy while the address is ejected.
+  class SubchannelWrapper : public DelegatingSubchannel {
+   public:
+    SubchannelWrapper(RefCountedPtr<AddressState> address_state,
+                      RefCountedPtr<SubchannelInterface> subchannel);
+    ~SubchannelWrapper() override;
+
+    AddressState* address_state() const { return address_state_.get(); }
+
+    void EjectLocked();
+    void UnejectLocked();
+
+    grpc_connectivity_state CheckConnectivityState() override;
+    void WatchConnectivityState(
+        grpc_connectivity_state initial_state,
+        std::unique_ptr<ConnectivityStateWatcherInterface> watcher) override;
+    void CancelConnectivityStateWatch(
+        ConnectivityStateWatcherInterface* watcher) override;
+
+   private:
+    class WatcherWrapper : public ConnectivityStateWatcherInterface {
+     public:
+      // If the address is ejected, the watcher is told of
+      // TRANSIENT_FAILURE once the state of the subchannel is known.
+      // Otherwise, it believes the subchannel is in initial_state.
+      WatcherWrapper(
+          std::unique_ptr<ConnectivityStateWatcherInterface> watcher,
+          grpc_connectivity_state initial_state, bool ejected)
+          : watcher_(std::move(watcher)), ejected_(ejected) {
+        if (!ejected_) last_seen_state_ = initial_state;
+      }
+
+      void OnConnectivityStateChange(
+          grpc_connectivity_state new_state) override {
+        const bool first_state = !last_seen_state_.has_value();
+        last_seen_state_ = new_state;
+        if (!ejected_) {
+          watcher_->OnConnectivityStateChange(new_state);
+        } else if (first_state) {
+          watcher_->OnConnectivityStateChange(GRPC_CHANNEL_TRANSIENT_FAILURE);
+        }
+      }
+
+      grpc_pollset_set* interested_parties() override {
+        return watcher_->interested_parties();
+      }
+
+      void Eject() {
+        ejected_ = true;
+        if (last_seen_state_.has_value()) {
+          watcher_->OnConnectivityStateChange(GRPC_CHANNEL_TRANSIENT_FAILURE);
+        }
+      }
+
+      void Uneject() {
+        ejected_ = false;
+        if (last_seen_state_.has_value()) {
+          watcher_->OnConnectivityStateChange(*last_seen_state_);
+        }
+      }
+
+     private:
+      std::unique_ptr<ConnectivityStateWatcherInterface> watcher_;
+      absl::optional<grpc_connectivity_state> last_seen_state_;
+      bool ejected_;
+    };
+
+    RefCountedPtr<AddressState> address_state_;
+    // Accessed only in the control plane work serializer.
+    bool ejected_ = false;
+    std::map<ConnectivityStateWatcherInterface*, WatcherWrapper*> watchers_;
+  };
+
+  // A simple wrapper for ref-counting a picker from the child policy.
+  class RefCountedPicker : public RefCounted<RefCountedPicker> {
+   public:
+    explicit RefCountedPicker(std::unique_ptr<SubchannelPicker> picker)
+        : picker_(std::move(picker)) {}
+    PickResult Pick(PickArgs args) { return picker_->Pick(args); }
+
+   private:
+    std::unique_ptr<SubchannelPicker> picker_;
+  };
+
+  // A picker that wraps the picker from the child to count the results of
+  // the calls.
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(OutlierDetectionLb* outlier_detection_lb,
+           RefCountedPtr<RefCountedPicker> picker);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    RefCountedPtr<RefCountedPicker> picker_;
+    bool counting_enabled_;
+    bool latency_enabled_;
+  };
+
+  class Helper : public ChannelControlHelper {
+   public:
+    explicit Helper(RefCountedPtr<OutlierDetectionLb> outlier_detection_policy)
+        : outlier_detection_policy_(std::move(outlier_detection_policy)) {}
+
+    ~Helper() override {
+      outlier_detection_policy_.reset(DEBUG_LOCATION, "Helper");
+    }
+
+    RefCountedPtr<SubchannelInterface> CreateSubchannel(
+        ServerAddress address, const grpc_channel_args& args) override;
+    void UpdateState(grpc_connectivity_state state, const absl::Status& status,
+                     std::unique_ptr<SubchannelPicker> picker) override;
+    void RequestReresolution() override;
+    void AddTraceEvent(TraceSeverity severity,
+                       absl::string_view message) override;
+
+   private:
+    RefCountedPtr<OutlierDetectionLb> outlier_detection_policy_;
+  };
+
+  // Runs the ejection algorithms every interval.  Each arming of the timer
+  // is a new object, so the callback of a cancelled timer can never run the
+  // algorithms or re-arm the timer.
+  class EjectionTimer : public InternallyRefCounted<EjectionTimer> {
+   public:
+    explicit EjectionTimer(RefCountedPtr<OutlierDetectionLb> parent);
+
+    ~EjectionTimer() override {
+      parent_.reset(DEBUG_LOCATION, "EjectionTimer");
+    }
+
+    void Orphan() override;
+
+   private:
+    static void OnTimer(void* arg, grpc_error_handle error);
+    void OnTimerLocked(grpc_error_handle error);
+
+    RefCountedPtr<OutlierDetectionLb> parent_;
+    grpc_timer timer_;
+    grpc_closure on_timer_;
+    bool timer_pending_ = true;
+  };
+
+  ~OutlierDetectionLb() override;
+
+  void ShutdownLocked() override;
+
+  OrphanablePtr<LoadBalancingPolicy> CreateChildPolicyLocked(
+      const grpc_channel_args* args);
+
+  void MaybeUpdatePickerLocked();
+
+  // Runs the ejection algorithms over the calls of the last interval.
+  void EjectOutliersLocked();
+
+  // Current config from the resolver.
+  RefCountedPtr<OutlierDetectionLbConfig> config_;
+
+  // Internal state.
+  bool shutting_down_ = false;
+
+  OrphanablePtr<LoadBalancingPolicy> child_policy_;
+
+  // Latest state and picker reported by the child policy.
+  grpc_connectivity_state state_ = GRPC_CHANNEL_IDLE;
+  absl::Status status_;
+  RefCountedPtr<RefCountedPicker> picker_;
+
+  // The addresses of the latest update, keyed by their address string.
+  std::map<std::string, RefCountedPtr<AddressState>> address_states_;
+
+  OrphanablePtr<EjectionTimer> ejection_timer_;
+  // Decides which outliers are ejected when enforcement is below 100%.
+  absl::BitGen bit_gen_;
+};
+
+//
+// OutlierDetectionLb::AddressState
+//
+
+uint64_t OutlierDetectionLb::AddressState::IntervalCounts::LatencyAtPercentile(
+    uint32_t percentile) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumLatencyBuckets; ++i) total += latency[i];
+  if (total == 0) return 0;
+  // The rank of the call at percentile, starting from 1.
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(total * (percentile / 100.0))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+    seen += latency[i];
+    if (seen >= rank) return LatencyBucketLowerBound(i);
+  }
+  return LatencyBucketLowerBound(kNumLatencyBuckets - 1);
+}
+
+void OutlierDetectionLb::AddressState::TakeIntervalCountsLocked(
+    IntervalCounts* counts) {
+  const uint64_t successes = successes_.load(std::memory_order_relaxed);
+  const uint64_t failures = failures_.load(std::memory_order_relaxed);
+  counts->successes = successes - previous_.successes;
+  counts->failures = failures - previous_.failures;
+  previous_.successes = successes;
+  previous_.failures = failures;
+  for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+    const uint64_t latency = latency_[i].load(std::memory_order_relaxed);
+    counts->latency[i] = latency - previous_.latency[i];
+    previous_.latency[i] = latency;
+  }
+}
+
+void OutlierDetectionLb::AddressState::EjectLocked(grpc_millis now) {
+  ejected_ = true;
+  ejection_time_ = now;
+  ++ejection_multiplier_;
+  for (auto& wrapper : GetSubchannels()) wrapper->EjectLocked();
+}
+
+void OutlierDetectionLb::AddressState::UnejectLocked() {
+  ejected_ = false;
+  for (auto& wrapper : GetSubchannels()) wrapper->UnejectLocked();
+}
+
+void OutlierDetectionLb::AddressState::MaybeUnejectLocked(
+    const OutlierDetectionParams& params, grpc_millis now) {
+  if (!ejected_) {
+    if (ejection_multiplier_ > 0) --ejection_multiplier_;
+    return;
+  }
+  // Each consecutive ejection lasts twice as long as the previous one, up to
+  // max_ejection_time (or base_ejection_time, if larger).
+  const grpc_millis max_ejection_duration =
+      std::max(params.base_ejection_time, params.max_ejection_time);
+  grpc_millis ejection_duration = params.base_ejection_time;
+  for (uint32_t i = 1; i < ejection_multiplier_ && ejection_duration > 0 &&
+                       ejection_duration < max_ejection_duration;
+       ++i) {
+    ejection_duration *= 2;
+  }
+  ejection_duration = std::min(ejection_duration, max_ejection_duration);
+  if (now >= ejection_time_ + ejection_duration) UnejectLocked();
+}
+
+void OutlierDetectionLb::AddressState::ResetLocked() {
+  if (ejected_) UnejectLocked();
+  ejection_multiplier_ = 0;
+}
+
+void OutlierDetectionLb::AddressState::AddSubchannel(
+    SubchannelWrapper* wrapper) {
+  MutexLock lock(&mu_);
+  subchannels_.insert(wrapper);
+}
+
+void OutlierDetectionLb::AddressState::RemoveSubchannel(
+    SubchannelWrapper* wrapper) {
+  MutexLock lock(&mu_);
+  subchannels_.erase(wrapper);
+}
+
+std::vector<RefCountedPtr<OutlierDetectionLb::SubchannelWrapper>>
+OutlierDetectionLb::AddressState::GetSubchannels() {
+  std::vector<RefCountedPtr<SubchannelWrapper>> wrappers;
+  MutexLock lock(&mu_);
+  wrappers.reserve(subchannels_.size());
+  for (SubchannelWrapper* wrapper : subchannels_) {
+    // Skip the wrappers that are being destroyed.
+    RefCountedPtr<SubchannelInterface> ref = wrapper->RefIfNonZero();
+    if (ref != nullptr) {
+      wrappers.emplace_back(static_cast<SubchannelWrapper*>(ref.release()));
+    }
+  }
+  return wrappers;
+}
+
+//
+// OutlierDetectionLb::SubchannelWrapper
+//
+
+OutlierDetectionLb::SubchannelWrapper::SubchannelWrapper(
+    RefCountedPtr<AddressState> address_state,
+    RefCountedPtr<SubchannelInterface> subchannel)
+    : DelegatingSubchannel(std::move(subchannel)),
+      address_state_(std::move(address_state)) {
+  if (address_state_ != nullptr) {
+    ejected_ = address_state_->ejected();
+    address_state_->AddSubchannel(this);
+  }
+}
+
+OutlierDetectionLb::SubchannelWrapper::~SubchannelWrapper() {
+  if (address_state_ != nullptr) address_state_->RemoveSubchannel(this);
+}
+
+void OutlierDetectionLb::SubchannelWrapper::EjectLocked() {
+  if (ejected_) return;
+  ejected_ = true;
+  for (auto& p : watchers_) p.second->Eject();
+}
+
+void OutlierDetectionLb::SubchannelWrapper::UnejectLocked() {
+  if (!ejected_) return;
+  ejected_ = false;
+  for (auto& p : watchers_) p.second->Uneject();
+}
+
+grpc_connectivity_state
+OutlierDetectionLb::SubchannelWrapper::CheckConnectivityState() {
+  if (ejected_) return GRPC_CHANNEL_TRANSIENT_FAILURE;
+  return DelegatingSubchannel::CheckConnectivityState();
+}
+
+void OutlierDetectionLb::SubchannelWrapper::WatchConnectivityState(
+    grpc_connectivity_state initial_state,
+    std::unique_ptr<ConnectivityStateWatcherInterface> watcher) {
+  ConnectivityStateWatcherInterface* watcher_ptr = watcher.get();
+  auto watcher_wrapper =
+      absl::make_unique<WatcherWrapper>(std::move(watcher), initial_state,
+                                        ejected_);
+  watchers_.emplace(watcher_ptr, watcher_wrapper.get());
+  // While ejected, the wrapper needs to hear of the actual state of the
+  // subchannel, to report it once the address is unejected.
+  DelegatingSubchannel::WatchConnectivityState(
+      ejected_ ? GRPC_CHANNEL_SHUTDOWN : initial_state,
+      std::move(watcher_wrapper));
+}
+
+void OutlierDetectionLb::SubchannelWrapper::CancelConnectivityStateWatch(
+    ConnectivityStateWatcherInterface* watcher) {
+  auto it = watchers_.find(watcher);
+  if (it == watchers_.end()) return;
+  DelegatingSubchannel::CancelConnectivityStateWatch(it->second);
+  watchers_.erase(it);
+}
+
+//
+// OutlierDetectionLb::Picker
+//
+
+OutlierDetectionLb::Picker::Picker(OutlierDetectionLb* outlier_detection_lb,
+                                   RefCountedPtr<RefCountedPicker> picker)
+    : picker_(std::move(picker)),
+      counting_enabled_(outlier_detection_lb->config_->CountingEnabled()),
+      latency_enabled_(outlier_detection_lb->config_->params()
+                           .latency_ejection.has_value()) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] constructed new picker %p",
+            outlier_detection_lb, this);
+  }
+}
+
+LoadBalancingPolicy::PickResult OutlierDetectionLb::Picker::Pick(
+    LoadBalancingPolicy::PickArgs args) {
+  if (picker_ == nullptr) {  // Should never happen.
+    return PickResult::Fail(absl::InternalError(
+        "outlier_detection picker not given any child picker"));
+  }
+  // Delegate to child picker.
+  PickResult result = picker_->Pick(args);
+  auto* complete_pick = absl::get_if<PickResult::Complete>(&result.result);
+  if (complete_pick != nullptr) {
+    auto* subchannel_wrapper =
+        static_cast<SubchannelWrapper*>(complete_pick->subchannel.get());
+    AddressState* address_state = subchannel_wrapper->address_state();
+    if (counting_enabled_ && address_state != nullptr) {
+      // Intercept the recv_trailing_metadata op to record call completion.
+      address_state = address_state->Ref(DEBUG_LOCATION, "call").release();
+      const bool record_latency = latency_enabled_;
+      const gpr_timespec start_time = record_latency
+                                          ? gpr_now(GPR_CLOCK_MONOTONIC)
+                                          : gpr_inf_past(GPR_CLOCK_MONOTONIC);
+      auto original_recv_trailing_metadata_ready =
+          complete_pick->recv_trailing_metadata_ready;
+      complete_pick->recv_trailing_metadata_ready =
+          // Note: This callback does not run in either the control plane
+          // work serializer or in the data plane mutex.
+          [address_state, record_latency, start_time,
+           original_recv_trailing_metadata_ready](absl::Status status,
+                                                  MetadataInterface* metadata,
+                                                  CallState* call_state) {
+            uint64_t latency_us = 0;
+            if (record_latency) {
+              gpr_timespec latency =
+                  gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start_time);
+              latency_us = std::max<int64_t>(
+                  0, latency.tv_sec * GPR_US_PER_SEC +
+                         latency.tv_nsec / GPR_NS_PER_US);
+            }
+            address_state->AddCall(status.ok(), record_latency, latency_us);
+            address_state->Unref(DEBUG_LOCATION, "call");
+            // Invoke the original recv_trailing_metadata_ready callback, if
+            // any.
+            if (original_recv_trailing_metadata_ready != nullptr) {
+              original_recv_trailing_metadata_ready(status, metadata,
+                                                    call_state);
+            }
+          };
+    }
+    // Unwrap subchannel to pass back up the stack.
+    complete_pick->subchannel = subchannel_wrapper->wrapped_subchannel();
+  }
+  return result;
+}
+
+//
+// OutlierDetectionLb::EjectionTimer
+//
+
+OutlierDetectionLb::EjectionTimer::EjectionTimer(
+    RefCountedPtr<OutlierDetectionLb> parent)
+    : parent_(std::move(parent)) {
+  const grpc_millis interval = parent_->config_->params().interval;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] starting ejection timer for %" PRId64
+            " ms",
+            parent_.get(), interval);
+  }
+  GRPC_CLOSURE_INIT(&on_timer_, OnTimer, this, nullptr);
+  Ref(DEBUG_LOCATION, "OnTimer").release();
+  grpc_timer_init(&timer_, ExecCtx::Get()->Now() + interval, &on_timer_);
+}
+
+void OutlierDetectionLb::EjectionTimer::Orphan() {
+  if (timer_pending_) {
+    timer_pending_ = false;
+    grpc_timer_cancel(&timer_);
+  }
+  Unref();
+}
+
+void OutlierDetectionLb::EjectionTimer::OnTimer(void* arg,
+                                                grpc_error_handle error) {
+  EjectionTimer* self = static_cast<EjectionTimer*>(arg);
+  GRPC_ERROR_REF(error);  // ref owned by lambda
+  self->parent_->work_serializer()->Run(
+      [self, error]() { self->OnTimerLocked(error); }, DEBUG_LOCATION);
+}
+
+void OutlierDetectionLb::EjectionTimer::OnTimerLocked(grpc_error_handle error) {
+  if (error == GRPC_ERROR_NONE && timer_pending_) {
+    timer_pending_ = false;
+    parent_->EjectOutliersLocked();
+    // Replacing the timer orphans this one; the ref taken for the callback
+    // keeps it alive until the Unref() below.
+    parent_->ejection_timer_ = MakeOrphanable<EjectionTimer>(
+        parent_->Ref(DEBUG_LOCATION, "EjectionTimer"));
+  }
+  Unref(DEBUG_LOCATION, "OnTimer");
+  GRPC_ERROR_UNREF(error);
+}
+
+//
+// OutlierDetectionLb
+//
+
+OutlierDetectionLb::OutlierDetectionLb(Args args)
+    : LoadBalancingPolicy(std::move(args)) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] created", this);
+  }
+}
+
+OutlierDetectionLb::~OutlierDetectionLb() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] destroying outlier_detection LB policy",
+            this);
+  }
+}
+
+void OutlierDetectionLb::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] shutting down", this);
+  }
+  shutting_down_ = true;
+  ejection_timer_.reset();
+  // Remove the child policy's interested_parties pollset_set from the
+  // outlier_detection policy.
+  if (child_policy_ != nullptr) {
+    grpc_pollset_set_del_pollset_set(child_policy_->interested_parties(),
+                                     interested_parties());
+    child_policy_.reset();
+  }
+  // Drop our ref to the child's picker, in case it's holding a ref to
+  // the child.
+  picker_.reset();
+  address_states_.clear();
+}
+
+void OutlierDetectionLb::ExitIdleLocked() {
+  if (child_policy_ != nullptr) child_policy_->ExitIdleLocked();
+}
+
+void OutlierDetectionLb::ResetBackoffLocked() {
+  if (child_policy_ != nullptr) child_policy_->ResetBackoffLocked();
+}
+
+void OutlierDetectionLb::UpdateLocked(UpdateArgs args) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO, "[outlier_detection_lb %p] Received update", this);
+  }
+  // Update config.
+  const bool was_counting = config_ != nullptr && config_->CountingEnabled();
+  config_ = std::move(args.config);
+  // Update the address states, keeping those of the addresses that are
+  // still present, along with their counters and ejections.
+  std::map<std::string, RefCountedPtr<AddressState>> address_states;
+  for (const ServerAddress& address : args.addresses) {
+    std::string address_string =
+        grpc_sockaddr_to_string(&address.address(), false);
+    auto it = address_states_.find(address_string);
+    if (it != address_states_.end()) {
+      address_states.emplace(std::move(address_string), std::move(it->second));
+    } else {
+      address_states.emplace(std::move(address_string),
+                             MakeRefCounted<AddressState>());
+    }
+  }
+  address_states_ = std::move(address_states);
+  // Start or stop the ejection timer.
+  if (config_->CountingEnabled()) {
+    if (!was_counting) {
+      // Ignore the calls counted before counting was enabled.
+      AddressState::IntervalCounts counts;
+      for (auto& p : address_states_) {
+        p.second->TakeIntervalCountsLocked(&counts);
+      }
+    }
+    if (ejection_timer_ == nullptr) {
+      ejection_timer_ =
+          MakeOrphanable<EjectionTimer>(Ref(DEBUG_LOCATION, "EjectionTimer"));
+    }
+  } else {
+    ejection_timer_.reset();
+    for (auto& p : address_states_) p.second->ResetLocked();
+  }
+  // Update picker if whether calls are counted has changed.
+  MaybeUpdatePickerLocked();
+  // Create policy if needed.
+  if (child_policy_ == nullptr) {
+    child_policy_ = CreateChildPolicyLocked(args.args);
+  }
+  // Construct update args.
+  UpdateArgs update_args;
+  update_args.addresses = std::move(args.addresses);
+  update_args.config = config_->child_policy();
+  update_args.args = grpc_channel_args_copy(args.args);
+  // Update the policy.
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] Updating child policy handler %p", this,
+            child_policy_.get());
+  }
+  child_policy_->UpdateLocked(std::move(update_args));
+}
+
+void OutlierDetectionLb::MaybeUpdatePickerLocked() {
+  if (picker_ == nullptr) return;
+  auto outlier_detection_picker = absl::make_unique<Picker>(this, picker_);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] updating connectivity: state=%s "
+            "status=(%s) picker=%p",
+            this, ConnectivityStateName(state_), status_.ToString().c_str(),
+            outlier_detection_picker.get());
+  }
+  channel_control_helper()->UpdateState(state_, status_,
+                                        std::move(outlier_detection_picker));
+}
+
+OrphanablePtr<LoadBalancingPolicy> OutlierDetectionLb::CreateChildPolicyLocked(
+    const grpc_channel_args* args) {
+  LoadBalancingPolicy::Args lb_policy_args;
+  lb_policy_args.work_serializer = work_serializer();
+  lb_policy_args.args = args;
+  lb_policy_args.channel_control_helper =
+      absl::make_unique<Helper>(Ref(DEBUG_LOCATION, "Helper"));
+  OrphanablePtr<LoadBalancingPolicy> lb_policy =
+      MakeOrphanable<ChildPolicyHandler>(std::move(lb_policy_args),
+                                         &grpc_outlier_detection_lb_trace);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] Created new child policy handler %p",
+            this, lb_policy.get());
+  }
+  // Add our interested_parties pollset_set to that of the newly created
+  // child policy. This will make the child policy progress upon activity on
+  // this policy, which in turn is tied to the application's call.
+  grpc_pollset_set_add_pollset_set(lb_policy->interested_parties(),
+                                   interested_parties());
+  return lb_policy;
+}
+
+void OutlierDetectionLb::EjectOutliersLocked() {
+  const OutlierDetectionParams& params = config_->params();
+  const grpc_millis now = ExecCtx::Get()->Now();
+  struct Candidate {
+    const std::string* address;
+    AddressState* state;
+    AddressState::IntervalCounts counts;
+  };
+  std::vector<Candidate> candidates(address_states_.size());
+  size_t num_ejected = 0;
+  size_t i = 0;
+  for (auto& p : address_states_) {
+    candidates[i].address = &p.first;
+    candidates[i].state = p.second.get();
+    p.second->TakeIntervalCountsLocked(&candidates[i].counts);
+    if (p.second->ejected()) ++num_ejected;
+    ++i;
+  }
+  const size_t num_addresses = candidates.size();
+  // Ejects the address of candidate, unless too many addresses are ejected
+  // already.  Returns false once no more addresses can be ejected.
+  auto maybe_eject = [&](Candidate* candidate,
+                         uint32_t enforcement_percentage,
+                         const char* reason) {
+    if (num_ejected * 100 >= params.max_ejection_percent * num_addresses) {
+      return false;
+    }
+    if (candidate->state->ejected()) return true;
+    if (absl::Uniform<uint32_t>(bit_gen_, 0, 100) >= enforcement_percentage) {
+      return true;
+    }
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+      gpr_log(GPR_INFO, "[outlier_detection_lb %p] ejecting %s: %s", this,
+              candidate->address->c_str(), reason);
+    }
+    candidate->state->EjectLocked(now);
+    ++num_ejected;
+    return true;
+  };
+  // Returns the candidates with at least request_volume calls.
+  auto with_volume = [&](uint32_t request_volume) {
+    std::vector<Candidate*> result;
+    for (Candidate& candidate : candidates) {
+      if (candidate.counts.volume() >= request_volume) {
+        result.push_back(&candidate);
+      }
+    }
+    return result;
+  };
+  if (params.success_rate_ejection.has_value()) {
+    const auto& config = *params.success_rate_ejection;
+    std::vector<Candidate*> eligible = with_volume(config.request_volume);
+    if (!eligible.empty() && eligible.size() >= config.minimum_hosts) {
+      std::vector<double> success_rates;
+      success_rates.reserve(eligible.size());
+      double sum = 0;
+      for (Candidate* candidate : eligible) {
+        success_rates.push_back(
+            static_cast<double>(candidate->counts.successes) /
+            candidate->counts.volume());
+        sum += success_rates.back();
+      }
+      const double mean = sum / eligible.size();
+      double variance = 0;
+      for (double rate : success_rates) {
+        variance += (rate - mean) * (rate - mean);
+      }
+      variance /= eligible.size();
+      const double threshold =
+          mean - std::sqrt(variance) * (config.stdev_factor / 1000.0);
+      for (size_t j = 0; j < eligible.size(); ++j) {
+        if (success_rates[j] >= threshold) continue;
+        if (!maybe_eject(eligible[j], config.enforcement_percentage,
+                         "low success rate")) {
+          break;
+        }
+      }
+    }
+  }
+  if (params.failure_percentage_ejection.has_value()) {
+    const auto& config = *params.failure_percentage_ejection;
+    std::vector<Candidate*> eligible = with_volume(config.request_volume);
+    if (!eligible.empty() && eligible.size() >= config.minimum_hosts) {
+      for (Candidate* candidate : eligible) {
+        if (candidate->counts.failures * 100 <=
+            static_cast<uint64_t>(config.threshold) *
+                candidate->counts.volume()) {
+          continue;
+        }
+        if (!maybe_eject(candidate, config.enforcement_percentage,
+                         "high failure percentage")) {
+          break;
+        }
+      }
+    }
+  }
+  if (params.latency_ejection.has_value()) {
+    const auto& config = *params.latency_ejection;
+    std::vector<Candidate*> eligible = with_volume(config.request_volume);
+    if (!eligible.empty() && eligible.size() >= config.minimum_hosts) {
+      std::vector<uint64_t> latencies;
+      latencies.reserve(eligible.size());
+      for (Candidate* candidate : eligible) {
+        latencies.push_back(
+            candidate->counts.LatencyAtPercentile(config.percentile));
+      }
+      std::vector<uint64_t> sorted_latencies = latencies;
+      std::sort(sorted_latencies.begin(), sorted_latencies.end());
+      const uint64_t median = sorted_latencies[sorted_latencies.size() / 2];
+      for (size_t j = 0; j < eligible.size(); ++j) {
+        if (latencies[j] * 100 <= median * config.threshold) continue;
+        if (!maybe_eject(eligible[j], config.enforcement_percentage,
+                         "high latency")) {
+          break;
+        }
+      }
+    }
+  }
+  // Uneject the addresses whose ejection time has elapsed.
+  for (Candidate& candidate : candidates) {
+    const bool was_ejected = candidate.state->ejected();
+    candidate.state->MaybeUnejectLocked(params, now);
+    if (was_ejected && !candidate.state->ejected() &&
+        GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+      gpr_log(GPR_INFO, "[outlier_detection_lb %p] unejected %s", this,
+              candidate.address->c_str());
+    }
+  }
+}
+
+//
+// OutlierDetectionLb::Helper
+//
+
+RefCountedPtr<SubchannelInterface> OutlierDetectionLb::Helper::CreateSubchannel(
+    ServerAddress address, const grpc_channel_args& args) {
+  if (outlier_detection_policy_->shutting_down_) return nullptr;
+  RefCountedPtr<AddressState> address_state;
+  auto it = outlier_detection_policy_->address_states_.find(
+      grpc_sockaddr_to_string(&address.address(), false));
+  if (it != outlier_detection_policy_->address_states_.end()) {
+    address_state = it->second;
+  }
+  RefCountedPtr<SubchannelInterface> subchannel =
+      outlier_detection_policy_->channel_control_helper()->CreateSubchannel(
+          std::move(address), args);
+  if (subchannel == nullptr) return nullptr;
+  return MakeRefCounted<SubchannelWrapper>(std::move(address_state),
+                                           std::move(subchannel));
+}
+
+void OutlierDetectionLb::Helper::UpdateState(
+    grpc_connectivity_state state, const absl::Status& status,
+    std::unique_ptr<SubchannelPicker> picker) {
+  if (outlier_detection_policy_->shutting_down_) return;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+    gpr_log(GPR_INFO,
+            "[outlier_detection_lb %p] child connectivity state update: "
+            "state=%s (%s) picker=%p",
+            outlier_detection_policy_.get(), ConnectivityStateName(state),
+            status.ToString().c_str(), picker.get());
+  }
+  // Save the state and picker.
+  outlier_detection_policy_->state_ = state;
+  outlier_detection_policy_->status_ = status;
+  outlier_detection_policy_->picker_ =
+      MakeRefCounted<RefCountedPicker>(std::move(picker));
+  // Wrap the picker and return it to the channel.
+  outlier_detection_policy_->MaybeUpdatePickerLocked();
+}
+
+void OutlierDetectionLb::Helper::RequestReresolution() {
+  if (outlier_detection_policy_->shutting_down_) return;
+  outlier_detection_policy_->channel_control_helper()->RequestReresolution();
+}
+
+void OutlierDetectionLb::Helper::AddTraceEvent(TraceSeverity severity,
+                                               absl::string_view message) {
+  if (outlier_detection_policy_->shutting_down_) return;
+  outlier_detection_policy_->channel_control_helper()->AddTraceEvent(severity,
+                                                                     message);
+}
+
+//
+// factory
+//
+
+class OutlierDetectionLbFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<OutlierDetectionLb>(std::move(args));
+  }
+
+  const char* name() const override { return kOutlierDetection; }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    GPR_DEBUG_ASSERT(error != nullptr && *error == GRPC_ERROR_NONE);
+    if (json.type() == Json::Type::JSON_NULL) {
+      // This policy was configured in the deprecated loadBalancingPolicy
+      // field or in the client API.
+      *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:loadBalancingPolicy error:outlier_detection policy requires "
+          "configuration. Please use loadBalancingConfig field of service "
+          "config instead.");
+      return nullptr;
+    }
+    std::vector<grpc_error_handle> error_list;
+    const Json::Object& object = json.object_value();
+    OutlierDetectionParams params;
+    ParseJsonObjectFieldAsDuration(object, "interval", &params.interval,
+                                   &error_list, /*required=*/false);
+    ParseJsonObjectFieldAsDuration(object, "baseEjectionTime",
+                                   &params.base_ejection_time, &error_list,
+                                   /*required=*/false);
+    ParseJsonObjectFieldAsDuration(object, "maxEjectionTime",
+                                   &params.max_ejection_time, &error_list,
+                                   /*required=*/false);
+    if (params.interval <= 0) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:interval error:must be positive"));
+    }
+    ParseJsonObjectField(object, "maxEjectionPercent",
+                         &params.max_ejection_percent, &error_list,
+                         /*required=*/false);
+    if (params.max_ejection_percent > 100) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:maxEjectionPercent error:must be <= 100"));
+    }
+    const Json::Object* ejection_object;
+    if (ParseJsonObjectField(object, "successRateEjection", &ejection_object,
+                             &error_list, /*required=*/false)) {
+      OutlierDetectionParams::SuccessRateEjection config;
+      std::vector<grpc_error_handle> child_errors;
+      ParseJsonObjectField(*ejection_object, "stdevFactor",
+                           &config.stdev_factor, &child_errors,
+                           /*required=*/false);
+      ParseEjectionFields(*ejection_object, &config.enforcement_percentage,
+                          &config.minimum_hosts, &config.request_volume,
+                          &child_errors);
+      AddChildErrors("field:successRateEjection", &child_errors, &error_list);
+      params.success_rate_ejection = config;
+    }
+    if (ParseJsonObjectField(object, "failurePercentageEjection",
+                             &ejection_object, &error_list,
+                             /*required=*/false)) {
+      OutlierDetectionParams::FailurePercentageEjection config;
+      std::vector<grpc_error_handle> child_errors;
+      ParseJsonObjectField(*ejection_object, "threshold", &config.threshold,
+                           &child_errors, /*required=*/false);
+      if (config.threshold > 100) {
+        child_errors.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:threshold error:must be <= 100"));
+      }
+      ParseEjectionFields(*ejection_object, &config.enforcement_percentage,
+                          &config.minimum_hosts, &config.request_volume,
+                          &child_errors);
+      AddChildErrors("field:failurePercentageEjection", &child_errors,
+                     &error_list);
+      params.failure_percentage_ejection = config;
+    }
+    if (ParseJsonObjectField(object, "latencyEjection", &ejection_object,
+                             &error_list, /*required=*/false)) {
+      OutlierDetectionParams::LatencyEjection config;
+      std::vector<grpc_error_handle> child_errors;
+      ParseJsonObjectField(*ejection_object, "percentile", &config.percentile,
+                           &child_errors, /*required=*/false);
+      if (config.percentile == 0 || config.percentile > 100) {
+        child_errors.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:percentile error:must be in the range of 1 to 100"));
+      }
+      ParseJsonObjectField(*ejection_object, "threshold", &config.threshold,
+                           &child_errors, /*required=*/false);
+      if (config.threshold < 100) {
+        child_errors.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:threshold error:must be >= 100"));
+      }
+      ParseEjectionFields(*ejection_object, &config.enforcement_percentage,
+                          &config.minimum_hosts, &config.request_volume,
+                          &child_errors);
+      AddChildErrors("field:latencyEjection", &child_errors, &error_list);
+      params.latency_ejection = config;
+    }
+    // Child policy.
+    RefCountedPtr<LoadBalancingPolicy::Config> child_policy;
+    auto it = object.find("childPolicy");
+    if (it == object.end()) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:childPolicy error:required field missing"));
+    } else {
+      grpc_error_handle parse_error = GRPC_ERROR_NONE;
+      child_policy = LoadBalancingPolicyRegistry::ParseLoadBalancingConfig(
+          it->second, &parse_error);
+      if (child_policy == nullptr) {
+        GPR_DEBUG_ASSERT(parse_error != GRPC_ERROR_NONE);
+        std::vector<grpc_error_handle> child_errors;
+        child_errors.push_back(parse_error);
+        error_list.push_back(
+            GRPC_ERROR_CREATE_FROM_VECTOR("field:childPolicy", &child_errors));
+      }
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+          "outlier_detection_experimental LB policy config", &error_list);
+      return nullptr;
+    }
+    return MakeRefCounted<OutlierDetectionLbConfig>(std::move(params),
+                                                    std::move(child_policy));
+  }
+
+ private:
+  // Parses the fields that all the ejection algorithms have.
+  static void ParseEjectionFields(const Json::Object& object,
+                                  uint32_t* enforcement_percentage,
+                                  uint32_t* minimum_hosts,
+                                  uint32_t* request_volume,
+                                  std::vector<grpc_error_handle>* error_list) {
+    ParseJsonObjectField(object, "enforcementPercentage",
+                         enforcement_percentage, error_list,
+                         /*required=*/false);
+    if (*enforcement_percentage > 100) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:enforcementPercentage error:must be <= 100"));
+    }
+    ParseJsonObjectField(object, "minimumHosts", minimum_hosts, error_list,
+                         /*required=*/false);
+    ParseJsonObjectField(object, "requestVolume", request_volume, error_list,
+                         /*required=*/false);
+  }
+
+  static void AddChildErrors(const char* field,
+                             std::vector<grpc_error_handle>* child_errors,
+                             std::vector<grpc_error_handle>* error_list) {
+    if (child_errors->empty()) return;
+    error_list->push_back(GRPC_ERROR_CREATE_FROM_VECTOR(field, child_errors));
+  }
+};
+
+}  // namespace
+
+void GrpcLbPolicyOutlierDetectionInit() {
+  LoadBalancingPolicyRegistry::Builder::RegisterLoadBalancingPolicyFactory(
+      absl::make_unique<OutlierDetectionLbFactory>());
+}
+
+void GrpcLbPolicyOutlierDetectionShutdown() {}
+
+}  // namespace grpc_core
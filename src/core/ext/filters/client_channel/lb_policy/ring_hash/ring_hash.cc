@@ -16,6 +16,8 @@
 
 #include <grpc/support/port_platform.h>
 
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,12 +47,28 @@ namespace grpc_core {
 const char* kRequestRingHashAttribute = "request_ring_hash";
 TraceFlag grpc_lb_ring_hash_trace(false, "ring_hash_lb");
 
+namespace {
+
+bool IsPrime(size_t n) {
+  if (n < 2) return false;
+  for (size_t i = 2; i * i <= n; ++i) {
+    if (n % i == 0) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 // Helper Parser method
 void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
                            size_t* max_ring_size,
+                           RingHashLookupTableType* lookup_table_type,
+                           size_t* maglev_table_size,
                            std::vector<grpc_error_handle>* error_list) {
   *min_ring_size = 1024;
   *max_ring_size = 8388608;
+  *lookup_table_type = RingHashLookupTableType::kRing;
+  *maglev_table_size = 65537;
   if (json.type() != Json::Type::OBJECT) {
     error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
         "ring_hash_experimental should be of type object"));
@@ -85,23 +103,269 @@ void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
         "and max_ring_size cannot be smaller than "
         "min_ring_size"));
   }
+  ring_hash_it = ring_hash.find("lookup_table");
+  if (ring_hash_it != ring_hash.end()) {
+    if (ring_hash_it->second.type() != Json::Type::STRING) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:lookup_table error: should be of type string"));
+    } else if (ring_hash_it->second.string_value() == "RING") {
+      *lookup_table_type = RingHashLookupTableType::kRing;
+    } else if (ring_hash_it->second.string_value() == "MAGLEV") {
+      *lookup_table_type = RingHashLookupTableType::kMaglev;
+    } else {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:lookup_table error: should be RING or MAGLEV"));
+    }
+  }
+  ring_hash_it = ring_hash.find("maglev_table_size");
+  if (ring_hash_it != ring_hash.end()) {
+    if (ring_hash_it->second.type() != Json::Type::NUMBER) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:maglev_table_size error: should be of type number"));
+    } else {
+      int value = gpr_parse_nonnegative_int(
+          ring_hash_it->second.string_value().c_str());
+      if (value < 2 || value > 5000011 || !IsPrime(value)) {
+        error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:maglev_table_size error: "
+            "should be a prime number no larger than 5000011"));
+      } else {
+        *maglev_table_size = value;
+      }
+    }
+  }
 }
 
 namespace {
 
 constexpr char kRingHash[] = "ring_hash_experimental";
 
+//
+// Ketama hash ring
+//
+class KetamaRing : public RingHashLookupTable {
+ public:
+  KetamaRing(const std::vector<RingHashEndpoint>& endpoints,
+             size_t min_ring_size, size_t max_ring_size);
+
+  size_t size() const override { return ring_.size(); }
+  size_t FindEntry(uint64_t hash) const override;
+  size_t EndpointIndex(size_t entry_index) const override {
+    return ring_[entry_index].endpoint_index;
+  }
+
+ private:
+  struct RingEntry {
+    uint64_t hash;
+    size_t endpoint_index;
+  };
+
+  std::vector<RingEntry> ring_;
+};
+
+KetamaRing::KetamaRing(const std::vector<RingHashEndpoint>& endpoints,
+                       size_t min_ring_size, size_t max_ring_size) {
+  size_t sum = 0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    GPR_ASSERT(endpoint.weight != 0);
+    sum += endpoint.weight;
+  }
+  // Calculating normalized weights and find the min.
+  std::vector<double> normalized_weights;
+  normalized_weights.reserve(endpoints.size());
+  double min_normalized_weight = 1.0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    const double normalized_weight =
+        static_cast<double>(endpoint.weight) / sum;
+    normalized_weights.push_back(normalized_weight);
+    min_normalized_weight = std::min(normalized_weight, min_normalized_weight);
+  }
+  // Scale up the number of hashes per host such that the least-weighted host
+  // gets a whole number of hashes on the ring. Other hosts might not end up
+  // with whole numbers, and that's fine (the ring-building algorithm below can
+  // handle this). This preserves the original implementation's behavior: when
+  // weights aren't provided, all hosts should get an equal number of hashes. In
+  // the case where this number exceeds the max_ring_size, it's scaled back down
+  // to fit.
+  const double scale = std::min(
+      std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
+      static_cast<double>(max_ring_size));
+  // Reserve memory for the entire ring up front.
+  const uint64_t ring_size = std::ceil(scale);
+  ring_.reserve(ring_size);
+  // Populate the hash ring by walking through the (host, weight) pairs in
+  // normalized_host_weights, and generating (scale * weight) hashes for each
+  // host. Since these aren't necessarily whole numbers, we maintain running
+  // sums -- current_hashes and target_hashes -- which allows us to populate the
+  // ring in a mostly stable way.
+  absl::InlinedVector<char, 196> hash_key_buffer;
+  double current_hashes = 0.0;
+  double target_hashes = 0.0;
+  for (size_t i = 0; i < endpoints.size(); ++i) {
+    const std::string& address_string = endpoints[i].address;
+    hash_key_buffer.assign(address_string.begin(), address_string.end());
+    hash_key_buffer.emplace_back('_');
+    auto offset_start = hash_key_buffer.end();
+    target_hashes += scale * normalized_weights[i];
+    size_t count = 0;
+    while (current_hashes < target_hashes) {
+      const std::string count_str = absl::StrCat(count);
+      hash_key_buffer.insert(offset_start, count_str.begin(), count_str.end());
+      absl::string_view hash_key(hash_key_buffer.data(),
+                                 hash_key_buffer.size());
+      const uint64_t hash = XXH64(hash_key.data(), hash_key.size(), 0);
+      ring_.push_back({hash, i});
+      ++count;
+      ++current_hashes;
+      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+    }
+  }
+  std::sort(ring_.begin(), ring_.end(),
+            [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+              return lhs.hash < rhs.hash;
+            });
+}
+
+size_t KetamaRing::FindEntry(uint64_t hash) const {
+  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c
+  // (ketama_get_server) NOTE: The algorithm depends on using signed integers
+  // for lowp, highp, and first_index. Do not change them!
+  int64_t lowp = 0;
+  int64_t highp = ring_.size();
+  int64_t first_index = 0;
+  while (true) {
+    first_index = (lowp + highp) / 2;
+    if (first_index == static_cast<int64_t>(ring_.size())) {
+      first_index = 0;
+      break;
+    }
+    uint64_t midval = ring_[first_index].hash;
+    uint64_t midval1 = first_index == 0 ? 0 : ring_[first_index - 1].hash;
+    if (hash <= midval && hash > midval1) {
+      break;
+    }
+    if (midval < hash) {
+      lowp = first_index + 1;
+    } else {
+      highp = first_index - 1;
+    }
+    if (lowp > highp) {
+      first_index = 0;
+      break;
+    }
+  }
+  return first_index;
+}
+
+//
+// Maglev lookup table
+//
+// See "Maglev: A Fast and Reliable Software Network Load Balancer"
+// (Eisenbud et al., NSDI 2016), section 3.4.
+class MaglevTable : public RingHashLookupTable {
+ public:
+  MaglevTable(const std::vector<RingHashEndpoint>& endpoints,
+              size_t table_size);
+
+  size_t size() const override { return table_.size(); }
+  size_t FindEntry(uint64_t hash) const override {
+    return hash % table_.size();
+  }
+  size_t EndpointIndex(size_t entry_index) const override {
+    return table_[entry_index];
+  }
+
+ private:
+  std::vector<uint32_t> table_;
+};
+
+MaglevTable::MaglevTable(const std::vector<RingHashEndpoint>& endpoints,
+                         size_t table_size) {
+  GPR_ASSERT(table_size >= 2);
+  GPR_ASSERT(endpoints.size() < UINT32_MAX);
+  if (endpoints.empty()) return;
+  // Each endpoint has its own permutation of the table entries, depending
+  // only on its address, given by offset and skip.  The endpoints take turns
+  // claiming the next entry of their permutation that is not taken yet, which
+  // spreads the entries of an endpoint over the table, and means that adding
+  // or removing an endpoint moves few entries of the other endpoints.
+  struct Permutation {
+    uint64_t offset;
+    uint64_t skip;
+    // The position in the permutation of the next entry to try.
+    uint64_t next;
+    // To follow the weights, endpoints gain their weight in credit each
+    // turn, and only claim an entry once they have max_weight of it.
+    uint64_t credit;
+  };
+  std::vector<Permutation> permutations;
+  permutations.reserve(endpoints.size());
+  uint32_t max_weight = 0;
+  for (const RingHashEndpoint& endpoint : endpoints) {
+    GPR_ASSERT(endpoint.weight != 0);
+    max_weight = std::max(max_weight, endpoint.weight);
+    const std::string& address = endpoint.address;
+    permutations.push_back(
+        {XXH64(address.data(), address.size(), 0) % table_size,
+         XXH64(address.data(), address.size(), 1) % (table_size - 1) + 1, 0,
+         0});
+  }
+  constexpr uint32_t kEmpty = UINT32_MAX;
+  table_.assign(table_size, kEmpty);
+  size_t filled = 0;
+  while (true) {
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+      Permutation& permutation = permutations[i];
+      permutation.credit += endpoints[i].weight;
+      if (permutation.credit < max_weight) continue;
+      permutation.credit -= max_weight;
+      size_t entry;
+      do {
+        // Since table_size is prime, this visits all of the entries once
+        // every table_size tries.
+        entry = (permutation.offset + permutation.next * permutation.skip) %
+                table_size;
+        ++permutation.next;
+      } while (table_[entry] != kEmpty);
+      table_[entry] = i;
+      if (++filled == table_size) return;
+    }
+  }
+}
+
 class RingHashLbConfig : public LoadBalancingPolicy::Config {
  public:
-  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size)
-      : min_ring_size_(min_ring_size), max_ring_size_(max_ring_size) {}
+  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size,
+                   RingHashLookupTableType lookup_table_type,
+                   size_t maglev_table_size)
+      : min_ring_size_(min_ring_size),
+        max_ring_size_(max_ring_size),
+        lookup_table_type_(lookup_table_type),
+        maglev_table_size_(maglev_table_size) {}
   const char* name() const override { return kRingHash; }
   size_t min_ring_size() const { return min_ring_size_; }
   size_t max_ring_size() const { return max_ring_size_; }
+  RingHashLookupTableType lookup_table_type() const {
+    return lookup_table_type_;
+  }
+  size_t maglev_table_size() const { return maglev_table_size_; }
+
+  // Returns true if the lookup tables built with this config and other are
+  // the same.
+  bool SameLookupTable(const RingHashLbConfig& other) const {
+    if (lookup_table_type_ != other.lookup_table_type_) return false;
+    if (lookup_table_type_ == RingHashLookupTableType::kMaglev) {
+      return maglev_table_size_ == other.maglev_table_size_;
+    }
+    return min_ring_size_ == other.min_ring_size_ &&
+           max_ring_size_ == other.max_ring_size_;
+  }
 
  private:
   size_t min_ring_size_;
   size_t max_ring_size_;
+  RingHashLookupTableType lookup_table_type_;
+  size_t maglev_table_size_;
 };
 
 //
@@ -173,6 +437,23 @@ class RingHash : public LoadBalancingPolicy {
       // any references to subchannels, since the subchannels'
       // pollset_sets will include the LB policy's pollset_set.
       policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+      endpoints_.reserve(num_subchannels());
+      for (size_t i = 0; i < num_subchannels(); ++i) {
+        const ServerAddress& address = subchannel(i)->address();
+        const ServerAddressWeightAttribute* weight_attribute =
+            static_cast<const ServerAddressWeightAttribute*>(
+                address.GetAttribute(ServerAddressWeightAttribute::
+                                         kServerAddressWeightAttributeKey));
+        RingHashEndpoint endpoint;
+        endpoint.address = grpc_sockaddr_to_string(&address.address(), false);
+        // Default weight is 1 for the cases where a weight is not provided,
+        // each occurrence of the address will be counted a weight value of 1.
+        if (weight_attribute != nullptr) {
+          GPR_ASSERT(weight_attribute->weight() != 0);
+          endpoint.weight = weight_attribute->weight();
+        }
+        endpoints_.push_back(std::move(endpoint));
+      }
     }
 
     ~RingHashSubchannelList() override {
@@ -180,6 +461,18 @@ class RingHash : public LoadBalancingPolicy {
       p->Unref(DEBUG_LOCATION, "subchannel_list");
     }
 
+    // Sets the lookup table of this list according to config.  The lookup
+    // table depends only on the endpoints and the config, so it is built
+    // once per list rather than once per picker, and taken from
+    // previous_list when that list has the same endpoints and config.
+    void SetLookupTableLocked(const RingHashLbConfig& config,
+                              const RingHashSubchannelList* previous_list,
+                              const RingHashLbConfig* previous_config);
+
+    const RefCountedPtr<RingHashLookupTable>& lookup_table() const {
+      return lookup_table_;
+    }
+
     // Starts watching the subchannels in this list.
     void StartWatchingLocked();
 
@@ -195,6 +488,9 @@ class RingHash : public LoadBalancingPolicy {
     bool UpdateRingHashConnectivityStateLocked();
 
    private:
+    // The endpoints of the subchannels, in the same order.
+    std::vector<RingHashEndpoint> endpoints_;
+    RefCountedPtr<RingHashLookupTable> lookup_table_;
     size_t num_idle_ = 0;
     size_t num_ready_ = 0;
     size_t num_connecting_ = 0;
@@ -209,8 +505,7 @@ class RingHash : public LoadBalancingPolicy {
     PickResult Pick(PickArgs args) override;
 
    private:
-    struct RingEntry {
-      uint64_t hash;
+    struct EndpointState {
       RefCountedPtr<SubchannelInterface> subchannel;
       grpc_connectivity_state connectivity_state;
     };
@@ -230,8 +525,8 @@ class RingHash : public LoadBalancingPolicy {
       }
 
       void Orphan() override {
-        // Hop into ExecCtx, so that we're not holding the data plane mutex
-        // while we run control-plane code.
+        // Hop into ExecCtx, so that we don't run control-plane code
+        // inside of a pick.
         ExecCtx::Run(DEBUG_LOCATION, &closure_, GRPC_ERROR_NONE);
       }
 
@@ -257,8 +552,11 @@ class RingHash : public LoadBalancingPolicy {
 
     RefCountedPtr<RingHash> parent_;
 
-    // A ring of subchannels.
-    std::vector<RingEntry> ring_;
+    // Maps request hashes to indexes of endpoints_.
+    RefCountedPtr<RingHashLookupTable> lookup_table_;
+    // The subchannel of each endpoint, and its state when the picker was
+    // created.
+    std::vector<EndpointState> endpoints_;
   };
 
   void ShutdownLocked() override;
@@ -278,105 +576,20 @@ class RingHash : public LoadBalancingPolicy {
 
 RingHash::Picker::Picker(RefCountedPtr<RingHash> parent,
                          RingHashSubchannelList* subchannel_list)
-    : parent_(std::move(parent)) {
-  size_t num_subchannels = subchannel_list->num_subchannels();
-  // Store the weights while finding the sum.
-  struct AddressWeight {
-    std::string address;
-    // Default weight is 1 for the cases where a weight is not provided,
-    // each occurrence of the address will be counted a weight value of 1.
-    uint32_t weight = 1;
-    double normalized_weight;
-  };
-  std::vector<AddressWeight> address_weights;
-  size_t sum = 0;
-  address_weights.reserve(num_subchannels);
-  for (size_t i = 0; i < num_subchannels; ++i) {
-    RingHashSubchannelData* sd = subchannel_list->subchannel(i);
-    const ServerAddressWeightAttribute* weight_attribute = static_cast<
-        const ServerAddressWeightAttribute*>(sd->address().GetAttribute(
-        ServerAddressWeightAttribute::kServerAddressWeightAttributeKey));
-    AddressWeight address_weight;
-    address_weight.address =
-        grpc_sockaddr_to_string(&sd->address().address(), false);
-    if (weight_attribute != nullptr) {
-      GPR_ASSERT(weight_attribute->weight() != 0);
-      address_weight.weight = weight_attribute->weight();
-    }
-    sum += address_weight.weight;
-    address_weights.push_back(std::move(address_weight));
-  }
-  // Calculating normalized weights and find min and max.
-  double min_normalized_weight = 1.0;
-  double max_normalized_weight = 0.0;
-  for (auto& address : address_weights) {
-    address.normalized_weight = static_cast<double>(address.weight) / sum;
-    min_normalized_weight =
-        std::min(address.normalized_weight, min_normalized_weight);
-    max_normalized_weight =
-        std::max(address.normalized_weight, max_normalized_weight);
-  }
-  // Scale up the number of hashes per host such that the least-weighted host
-  // gets a whole number of hashes on the ring. Other hosts might not end up
-  // with whole numbers, and that's fine (the ring-building algorithm below can
-  // handle this). This preserves the original implementation's behavior: when
-  // weights aren't provided, all hosts should get an equal number of hashes. In
-  // the case where this number exceeds the max_ring_size, it's scaled back down
-  // to fit.
-  const size_t min_ring_size = parent_->config_->min_ring_size();
-  const size_t max_ring_size = parent_->config_->max_ring_size();
-  const double scale = std::min(
-      std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
-      static_cast<double>(max_ring_size));
-  // Reserve memory for the entire ring up front.
-  const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
-  // Populate the hash ring by walking through the (host, weight) pairs in
-  // normalized_host_weights, and generating (scale * weight) hashes for each
-  // host. Since these aren't necessarily whole numbers, we maintain running
-  // sums -- current_hashes and target_hashes -- which allows us to populate the
-  // ring in a mostly stable way.
-  absl::InlinedVector<char, 196> hash_key_buffer;
-  double current_hashes = 0.0;
-  double target_hashes = 0.0;
-  uint64_t min_hashes_per_host = ring_size;
-  uint64_t max_hashes_per_host = 0;
-  for (size_t i = 0; i < num_subchannels; ++i) {
-    const std::string& address_string = address_weights[i].address;
-    hash_key_buffer.assign(address_string.begin(), address_string.end());
-    hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
-    target_hashes += scale * address_weights[i].normalized_weight;
-    size_t count = 0;
-    auto current_state =
-        subchannel_list->subchannel(i)->subchannel()->CheckConnectivityState();
-    while (current_hashes < target_hashes) {
-      const std::string count_str = absl::StrCat(count);
-      hash_key_buffer.insert(offset_start, count_str.begin(), count_str.end());
-      absl::string_view hash_key(hash_key_buffer.data(),
-                                 hash_key_buffer.size());
-      const uint64_t hash = XXH64(hash_key.data(), hash_key.size(), 0);
-      ring_.push_back({hash,
-                       subchannel_list->subchannel(i)->subchannel()->Ref(),
-                       current_state});
-      ++count;
-      ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
-    }
-    min_hashes_per_host =
-        std::min(static_cast<uint64_t>(i), min_hashes_per_host);
-    max_hashes_per_host =
-        std::max(static_cast<uint64_t>(i), max_hashes_per_host);
+    : parent_(std::move(parent)),
+      lookup_table_(subchannel_list->lookup_table()) {
+  endpoints_.reserve(subchannel_list->num_subchannels());
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    SubchannelInterface* subchannel =
+        subchannel_list->subchannel(i)->subchannel();
+    endpoints_.push_back(
+        {subchannel->Ref(), subchannel->CheckConnectivityState()});
   }
-  std::sort(ring_.begin(), ring_.end(),
-            [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-              return lhs.hash < rhs.hash;
-            });
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_ring_hash_trace)) {
     gpr_log(GPR_INFO,
             "[RH %p picker %p] created picker from subchannel_list=%p "
-            "with %" PRIuPTR " ring entries",
-            parent_.get(), this, subchannel_list, ring_.size());
+            "with %" PRIuPTR " lookup table entries",
+            parent_.get(), this, subchannel_list, lookup_table_->size());
   }
 }
 
@@ -388,33 +601,10 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
     return PickResult::Fail(
         absl::InternalError("xds ring hash value is not a number"));
   }
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c
-  // (ketama_get_server) NOTE: The algorithm depends on using signed integers
-  // for lowp, highp, and first_index. Do not change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  int64_t first_index = 0;
-  while (true) {
-    first_index = (lowp + highp) / 2;
-    if (first_index == static_cast<int64_t>(ring_.size())) {
-      first_index = 0;
-      break;
-    }
-    uint64_t midval = ring_[first_index].hash;
-    uint64_t midval1 = first_index == 0 ? 0 : ring_[first_index - 1].hash;
-    if (h <= midval && h > midval1) {
-      break;
-    }
-    if (midval < h) {
-      lowp = first_index + 1;
-    } else {
-      highp = first_index - 1;
-    }
-    if (lowp > highp) {
-      first_index = 0;
-      break;
-    }
-  }
+  const size_t num_entries = lookup_table_->size();
+  const size_t first_index = lookup_table_->FindEntry(h);
+  const EndpointState& first_entry =
+      endpoints_[lookup_table_->EndpointIndex(first_index)];
   OrphanablePtr<SubchannelConnectionAttempter> subchannel_connection_attempter;
   auto ScheduleSubchannelConnectionAttempt =
       [&](RefCountedPtr<SubchannelInterface> subchannel) {
@@ -424,26 +614,27 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
         }
         subchannel_connection_attempter->AddSubchannel(std::move(subchannel));
       };
-  switch (ring_[first_index].connectivity_state) {
+  switch (first_entry.connectivity_state) {
     case GRPC_CHANNEL_READY:
-      return PickResult::Complete(ring_[first_index].subchannel);
+      return PickResult::Complete(first_entry.subchannel);
     case GRPC_CHANNEL_IDLE:
-      ScheduleSubchannelConnectionAttempt(ring_[first_index].subchannel);
+      ScheduleSubchannelConnectionAttempt(first_entry.subchannel);
       ABSL_FALLTHROUGH_INTENDED;
     case GRPC_CHANNEL_CONNECTING:
       return PickResult::Queue();
     default:  // GRPC_CHANNEL_TRANSIENT_FAILURE
       break;
   }
-  ScheduleSubchannelConnectionAttempt(ring_[first_index].subchannel);
+  ScheduleSubchannelConnectionAttempt(first_entry.subchannel);
   // Loop through remaining subchannels to find one in READY.
   // On the way, we make sure the right set of connection attempts
   // will happen.
   bool found_second_subchannel = false;
   bool found_first_non_failed = false;
-  for (size_t i = 1; i < ring_.size(); ++i) {
-    const RingEntry& entry = ring_[(first_index + i) % ring_.size()];
-    if (entry.subchannel == ring_[first_index].subchannel) {
+  for (size_t i = 1; i < num_entries; ++i) {
+    const EndpointState& entry = endpoints_[lookup_table_->EndpointIndex(
+        (first_index + i) % num_entries)];
+    if (entry.subchannel == first_entry.subchannel) {
       continue;
     }
     if (entry.connectivity_state == GRPC_CHANNEL_READY) {
@@ -480,6 +671,36 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
 // RingHash::RingHashSubchannelList
 //
 
+void RingHash::RingHashSubchannelList::SetLookupTableLocked(
+    const RingHashLbConfig& config, const RingHashSubchannelList* previous_list,
+    const RingHashLbConfig* previous_config) {
+  if (num_subchannels() == 0) return;
+  if (previous_list != nullptr && previous_config != nullptr &&
+      previous_list->lookup_table_ != nullptr &&
+      config.SameLookupTable(*previous_config) &&
+      previous_list->endpoints_.size() == endpoints_.size() &&
+      std::equal(endpoints_.begin(), endpoints_.end(),
+                 previous_list->endpoints_.begin(),
+                 [](const RingHashEndpoint& a, const RingHashEndpoint& b) {
+                   return a.address == b.address && a.weight == b.weight;
+                 })) {
+    lookup_table_ = previous_list->lookup_table_;
+    return;
+  }
+  if (config.lookup_table_type() == RingHashLookupTableType::kMaglev) {
+    lookup_table_ = MakeMaglevTable(endpoints_, config.maglev_table_size());
+  } else {
+    lookup_table_ = MakeRingHashRing(endpoints_, config.min_ring_size(),
+                                     config.max_ring_size());
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_INFO,
+            "[RH %p] built lookup table with %" PRIuPTR
+            " entries for subchannel_list=%p",
+            policy(), lookup_table_->size(), this);
+  }
+}
+
 void RingHash::RingHashSubchannelList::StartWatchingLocked() {
   if (num_subchannels() == 0) return;
   // Check current state of each subchannel synchronously.
@@ -690,6 +911,7 @@ void RingHash::UpdateLocked(UpdateArgs args) {
     gpr_log(GPR_INFO, "[RR %p] received update with %" PRIuPTR " addresses",
             this, args.addresses.size());
   }
+  RefCountedPtr<RingHashLbConfig> previous_config = std::move(config_);
   config_ = std::move(args.config);
   // Filter out any address with weight 0.
   ServerAddressList addresses;
@@ -702,8 +924,11 @@ void RingHash::UpdateLocked(UpdateArgs args) {
       addresses.push_back(std::move(address));
     }
   }
-  subchannel_list_ = MakeOrphanable<RingHashSubchannelList>(
+  auto subchannel_list = MakeOrphanable<RingHashSubchannelList>(
       this, &grpc_lb_ring_hash_trace, std::move(addresses), *args.args);
+  subchannel_list->SetLookupTableLocked(*config_, subchannel_list_.get(),
+                                        previous_config.get());
+  subchannel_list_ = std::move(subchannel_list);
   if (subchannel_list_->num_subchannels() == 0) {
     // If the new list is empty, immediately transition to TRANSIENT_FAILURE.
     absl::Status status = absl::UnavailableError("Empty update");
@@ -733,10 +958,15 @@ class RingHashFactory : public LoadBalancingPolicyFactory {
       const Json& json, grpc_error_handle* error) const override {
     size_t min_ring_size;
     size_t max_ring_size;
+    RingHashLookupTableType lookup_table_type;
+    size_t maglev_table_size;
     std::vector<grpc_error_handle> error_list;
-    ParseRingHashLbConfig(json, &min_ring_size, &max_ring_size, &error_list);
+    ParseRingHashLbConfig(json, &min_ring_size, &max_ring_size,
+                          &lookup_table_type, &maglev_table_size, &error_list);
     if (error_list.empty()) {
-      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size);
+      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size,
+                                              lookup_table_type,
+                                              maglev_table_size);
     } else {
       *error = GRPC_ERROR_CREATE_FROM_VECTOR(
           "ring_hash_experimental LB policy config", &error_list);
@@ -747,6 +977,17 @@ class RingHashFactory : public LoadBalancingPolicyFactory {
 
 }  // namespace
 
+RefCountedPtr<RingHashLookupTable> MakeRingHashRing(
+    const std::vector<RingHashEndpoint>& endpoints, size_t min_ring_size,
+    size_t max_ring_size) {
+  return MakeRefCounted<KetamaRing>(endpoints, min_ring_size, max_ring_size);
+}
+
+RefCountedPtr<RingHashLookupTable> MakeMaglevTable(
+    const std::vector<RingHashEndpoint>& endpoints, size_t table_size) {
+  return MakeRefCounted<MaglevTable>(endpoints, table_size);
+}
+
 void GrpcLbPolicyRingHashInit() {
   grpc_core::LoadBalancingPolicyRegistry::Builder::
       RegisterLoadBalancingPolicyFactory(
@@ -21,17 +21,70 @@
 
 #include <stdlib.h>
 
+#include <string>
+#include <vector>
+
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/json/json.h"
 
 namespace grpc_core {
 extern const char* kRequestRingHashAttribute;
 
+// The kinds of lookup table that the ring_hash policy can map request hashes
+// to endpoints with.
+enum class RingHashLookupTableType {
+  // A Ketama hash ring of between min_ring_size and max_ring_size entries,
+  // searched in O(log(ring size)).
+  kRing,
+  // A Maglev lookup table of maglev_table_size entries, searched in O(1).
+  kMaglev,
+};
+
 // Helper Parsing method to parse ring hash policy configs; for example, ring
 // hash size validity.
 void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
                            size_t* max_ring_size,
+                           RingHashLookupTableType* lookup_table_type,
+                           size_t* maglev_table_size,
                            std::vector<grpc_error_handle>* error_list);
+
+// An endpoint of the ring_hash policy, from which its lookup table is built.
+struct RingHashEndpoint {
+  // The address, as in "ip:port".
+  std::string address;
+  uint32_t weight = 1;
+};
+
+// Maps request hashes to endpoints.  It depends only on the endpoints'
+// addresses and weights, so it is built once for a list of endpoints and
+// shared by all of the pickers made for it.
+class RingHashLookupTable : public RefCounted<RingHashLookupTable> {
+ public:
+  // Returns the number of entries in the table.
+  virtual size_t size() const = 0;
+  // Returns the index of the entry that hash maps to.  If that entry's
+  // endpoint cannot be used, the following entries, wrapping around, are
+  // the ones to try next.
+  virtual size_t FindEntry(uint64_t hash) const = 0;
+  // Returns the index of the endpoint of the entry at entry_index.
+  virtual size_t EndpointIndex(size_t entry_index) const = 0;
+};
+
+// Builds a Ketama hash ring for endpoints.
+RefCountedPtr<RingHashLookupTable> MakeRingHashRing(
+    const std::vector<RingHashEndpoint>& endpoints, size_t min_ring_size,
+    size_t max_ring_size);
+
+// Builds a Maglev lookup table for endpoints, with table_size entries.
+// table_size must be a prime number, and should be much larger than the
+// number of endpoints.  Endpoints get a number of entries about proportional
+// to their weight, and a change to the endpoints moves few of the entries of
+// the other endpoints.
+RefCountedPtr<RingHashLookupTable> MakeMaglevTable(
+    const std::vector<RingHashEndpoint>& endpoints, size_t table_size);
+
 }  // namespace grpc_core
 
 #endif  // GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_RING_HASH_RING_HASH_H
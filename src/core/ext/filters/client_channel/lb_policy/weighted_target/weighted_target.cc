@@ -21,6 +21,7 @@
 #include <string.h>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/random/random.h"
 #include "absl/strings/str_cat.h"
 
 #include <grpc/grpc.h>
@@ -210,8 +211,12 @@ class WeightedTargetLb : public LoadBalancingPolicy {
 
 WeightedTargetLb::PickResult WeightedTargetLb::WeightedPicker::Pick(
     PickArgs args) {
-  // Generate a random number in [0, total weight).
-  const uint32_t key = rand() % pickers_[pickers_.size() - 1].first;
+  // Generate a random number in [0, total weight). Picks run concurrently:
+  // rand() would share its state between them, and seeding a generator for
+  // every pick would lock absl's entropy pool, so each thread keeps its own.
+  static thread_local absl::BitGen bit_gen;
+  const uint32_t key =
+      absl::Uniform<uint32_t>(bit_gen, 0, pickers_[pickers_.size() - 1].first);
   // Find the index in pickers_ corresponding to key.
   size_t mid = 0;
   size_t start_index = 0;
@@ -415,6 +415,9 @@ bool CdsLb::GenerateDiscoveryMechanismForCluster(
     mechanism["lrsLoadReportingServerName"] =
         state.update->lrs_load_reporting_server_name.value();
   }
+  if (state.update->outlier_detection.has_value()) {
+    mechanism["outlierDetection"] = state.update->outlier_detection.value();
+  }
   discovery_mechanisms->emplace_back(std::move(mechanism));
   return true;
 }
@@ -73,6 +73,9 @@ class XdsClusterResolverLbConfig : public LoadBalancingPolicy::Config {
     DiscoveryMechanismType type;
     std::string eds_service_name;
     std::string dns_hostname;
+    // The config of the outlier_detection_experimental policy to wrap the
+    // priorities of the mechanism in, without its childPolicy field.
+    absl::optional<Json::Object> outlier_detection;
 
     bool operator==(const DiscoveryMechanism& other) const {
       return (cluster_name == other.cluster_name &&
@@ -81,7 +84,8 @@ class XdsClusterResolverLbConfig : public LoadBalancingPolicy::Config {
               max_concurrent_requests == other.max_concurrent_requests &&
               type == other.type &&
               eds_service_name == other.eds_service_name &&
-              dns_hostname == other.dns_hostname);
+              dns_hostname == other.dns_hostname &&
+              outlier_detection == other.outlier_detection);
     }
   };
 
@@ -973,6 +977,19 @@ XdsClusterResolverLb::CreateChildPolicyConfigLocked() {
     Json locality_picking_policy = Json::Array{Json::Object{
         {"xds_cluster_impl_experimental", std::move(xds_cluster_impl_config)},
     }};
+    // Wrap it in the outlier_detection policy, if configured.
+    if (config_->discovery_mechanisms()[discovery_index]
+            .outlier_detection.has_value()) {
+      Json::Object outlier_detection_config =
+          config_->discovery_mechanisms()[discovery_index]
+              .outlier_detection.value();
+      outlier_detection_config["childPolicy"] =
+          std::move(locality_picking_policy);
+      locality_picking_policy = Json::Array{Json::Object{
+          {"outlier_detection_experimental",
+           std::move(outlier_detection_config)},
+      }};
+    }
     // Add priority entry.
     const size_t child_number = priority_child_numbers_[priority];
     std::string child_name = absl::StrCat("child", child_number);
@@ -1214,8 +1231,11 @@ class XdsClusterResolverLbFactory : public LoadBalancingPolicyFactory {
             xds_lb_policy = array[i];
             size_t min_ring_size;
             size_t max_ring_size;
+            RingHashLookupTableType lookup_table_type;
+            size_t maglev_table_size;
             ParseRingHashLbConfig(policy_it->second, &min_ring_size,
-                                  &max_ring_size, &error_list);
+                                  &max_ring_size, &lookup_table_type,
+                                  &maglev_table_size, &error_list);
           }
         }
       }
@@ -1275,6 +1295,16 @@ class XdsClusterResolverLbFactory : public LoadBalancingPolicyFactory {
             gpr_parse_nonnegative_int(it->second.string_value().c_str());
       }
     }
+    // Outlier detection.
+    it = json.object_value().find("outlierDetection");
+    if (it != json.object_value().end()) {
+      if (it->second.type() != Json::Type::OBJECT) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:outlierDetection error:type should be object"));
+      } else {
+        discovery_mechanism->outlier_detection = it->second.object_value();
+      }
+    }
     // Discovery Mechanism type
     it = json.object_value().find("type");
     if (it == json.object_value().end()) {
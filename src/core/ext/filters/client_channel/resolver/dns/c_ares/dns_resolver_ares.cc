@@ -24,6 +24,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <memory>
+
 #include <address_sorting/address_sorting.h>
 
 #include "absl/container/inlined_vector.h"
@@ -36,6 +38,7 @@
 #include "src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_balancer_addresses.h"
 #include "src/core/ext/filters/client_channel/lb_policy_registry.h"
 #include "src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper.h"
+#include "src/core/ext/filters/client_channel/resolver/dns/dns_cache.h"
 #include "src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.h"
 #include "src/core/ext/filters/client_channel/resolver_registry.h"
 #include "src/core/ext/filters/client_channel/server_address.h"
@@ -77,11 +80,15 @@ class AresDnsResolver : public Resolver {
 
   void MaybeStartResolvingLocked();
   void StartResolvingLocked();
+  void LookUpCacheLocked();
+  void StartQueryLocked();
 
   static void OnNextResolution(void* arg, grpc_error_handle error);
   static void OnResolved(void* arg, grpc_error_handle error);
   void OnNextResolutionLocked(grpc_error_handle error);
   void OnResolvedLocked(grpc_error_handle error);
+  void OnCacheResultLocked(DnsCache::ResultPtr result);
+  void ReturnResultLocked(const DnsCache::Result& dns_result);
 
   /// DNS server to use (if not system default)
   std::string dns_server_;
@@ -102,6 +109,10 @@ class AresDnsResolver : public Resolver {
   int query_timeout_ms_;
   /// min interval between DNS requests
   grpc_millis min_time_between_resolutions_;
+  /// whether to share resolutions through the DnsCache
+  bool use_cache_;
+  /// what the resolutions are cached under
+  std::string cache_key_;
 
   /// closures used by the work_serializer
   grpc_closure on_next_resolution_;
@@ -110,6 +121,13 @@ class AresDnsResolver : public Resolver {
   bool resolving_ = false;
   /// the pending resolving request
   grpc_ares_request* pending_request_ = nullptr;
+  /// whether pending_request_ resolves cache_key_ for the DnsCache
+  bool resolving_for_cache_ = false;
+  /// whether the next resolution must not be served from the DnsCache
+  bool refresh_cache_ = false;
+  /// the smallest TTL of the records of pending_request_, if resolving for
+  /// the DnsCache
+  int min_ttl_seconds_ = -1;
   /// next resolution timer
   bool have_next_resolution_timer_ = false;
   grpc_timer next_resolution_timer_;
@@ -144,6 +162,11 @@ AresDnsResolver::AresDnsResolver(ResolverArgs args)
       min_time_between_resolutions_(grpc_channel_args_find_integer(
           channel_args_, GRPC_ARG_DNS_MIN_TIME_BETWEEN_RESOLUTIONS_MS,
           {1000 * 30, 0, INT_MAX})),
+      use_cache_(grpc_channel_args_find_bool(channel_args_,
+                                             GRPC_ARG_DNS_ENABLE_CACHE, false)),
+      cache_key_(absl::StrCat("ares|", dns_server_, "|", name_to_resolve_,
+                              enable_srv_queries_ ? "|srv" : "",
+                              request_service_config_ ? "|txt" : "")),
       backoff_(
           BackOff::Options()
               .set_initial_backoff(GRPC_DNS_INITIAL_CONNECT_BACKOFF_SECONDS *
@@ -170,6 +193,9 @@ void AresDnsResolver::StartLocked() {
 
 void AresDnsResolver::RequestReresolutionLocked() {
   if (!resolving_) {
+    // The channel asks because the addresses it has stopped working, so a
+    // cached copy of them will not do.
+    refresh_cache_ = use_cache_;
     MaybeStartResolvingLocked();
   }
 }
@@ -224,7 +250,7 @@ bool ValueInJsonArray(const Json::Array& array, const char* value) {
   return false;
 }
 
-std::string ChooseServiceConfig(char* service_config_choice_json,
+std::string ChooseServiceConfig(const std::string& service_config_choice_json,
                                 grpc_error_handle* error) {
   Json json = Json::Parse(service_config_choice_json, error);
   if (*error != GRPC_ERROR_NONE) return "";
@@ -312,23 +338,62 @@ void AresDnsResolver::OnResolved(void* arg, grpc_error_handle error) {
 
 void AresDnsResolver::OnResolvedLocked(grpc_error_handle error) {
   GPR_ASSERT(resolving_);
-  resolving_ = false;
+  auto dns_result = std::make_shared<DnsCache::Result>();
+  if (resolving_for_cache_ && min_ttl_seconds_ >= 0) {
+    dns_result->ttl = min_ttl_seconds_ * GPR_MS_PER_SEC;
+  }
   gpr_free(pending_request_);
   pending_request_ = nullptr;
+  dns_result->addresses = std::move(addresses_);
+  dns_result->balancer_addresses = std::move(balancer_addresses_);
+  if (service_config_json_ != nullptr) {
+    dns_result->service_config_json = service_config_json_;
+    gpr_free(service_config_json_);
+    service_config_json_ = nullptr;
+  }
+  dns_result->error = error;
+  if (resolving_for_cache_) {
+    resolving_for_cache_ = false;
+    // The resolution was cancelled, not failed.
+    if (shutdown_initiated_) {
+      DnsCache::Get()->Abandon(cache_key_);
+    } else {
+      DnsCache::Get()->Complete(cache_key_, dns_result);
+    }
+  }
   if (shutdown_initiated_) {
+    resolving_ = false;
     Unref(DEBUG_LOCATION, "OnResolvedLocked() shutdown");
-    GRPC_ERROR_UNREF(error);
     return;
   }
-  if (addresses_ != nullptr || balancer_addresses_ != nullptr) {
+  ReturnResultLocked(*dns_result);
+}
+
+void AresDnsResolver::OnCacheResultLocked(DnsCache::ResultPtr result) {
+  if (shutdown_initiated_) {
+    resolving_ = false;
+    Unref(DEBUG_LOCATION, "OnCacheResultLocked() shutdown");
+  } else if (result == nullptr) {
+    // The resolver we were waiting for gave up: try again.
+    LookUpCacheLocked();
+  } else {
+    GRPC_CARES_TRACE_LOG("resolver:%p got resolution of %s from the cache",
+                         this, name_to_resolve_.c_str());
+    ReturnResultLocked(*result);
+  }
+  Unref(DEBUG_LOCATION, "dns-cache");
+}
+
+void AresDnsResolver::ReturnResultLocked(const DnsCache::Result& dns_result) {
+  resolving_ = false;
+  if (!dns_result.failed()) {
     Result result;
-    if (addresses_ != nullptr) {
-      result.addresses = std::move(*addresses_);
+    if (dns_result.addresses != nullptr) {
+      result.addresses = *dns_result.addresses;
     }
-    if (service_config_json_ != nullptr) {
+    if (!dns_result.service_config_json.empty()) {
       std::string service_config_string = ChooseServiceConfig(
-          service_config_json_, &result.service_config_error);
-      gpr_free(service_config_json_);
+          dns_result.service_config_json, &result.service_config_error);
       if (result.service_config_error == GRPC_ERROR_NONE &&
           !service_config_string.empty()) {
         GRPC_CARES_TRACE_LOG("resolver:%p selected service config choice: %s",
@@ -338,19 +403,18 @@ void AresDnsResolver::OnResolvedLocked(grpc_error_handle error) {
       }
     }
     absl::InlinedVector<grpc_arg, 1> new_args;
-    if (balancer_addresses_ != nullptr) {
+    if (dns_result.balancer_addresses != nullptr) {
       new_args.push_back(
-          CreateGrpclbBalancerAddressesArg(balancer_addresses_.get()));
+          CreateGrpclbBalancerAddressesArg(dns_result.balancer_addresses.get()));
     }
     result.args = grpc_channel_args_copy_and_add(channel_args_, new_args.data(),
                                                  new_args.size());
     result_handler_->ReturnResult(std::move(result));
-    addresses_.reset();
-    balancer_addresses_.reset();
     // Reset backoff state so that we start from the beginning when the
     // next request gets triggered.
     backoff_.Reset();
   } else {
+    grpc_error_handle error = dns_result.error;
     GRPC_CARES_TRACE_LOG("resolver:%p dns resolution failed: %s", this,
                          grpc_error_std_string(error).c_str());
     std::string error_message =
@@ -383,7 +447,6 @@ void AresDnsResolver::OnResolvedLocked(grpc_error_handle error) {
     grpc_timer_init(&next_resolution_timer_, next_try, &on_next_resolution_);
   }
   Unref(DEBUG_LOCATION, "dns-resolving");
-  GRPC_ERROR_UNREF(error);
 }
 
 void AresDnsResolver::MaybeStartResolvingLocked() {
@@ -427,14 +490,55 @@ void AresDnsResolver::StartResolvingLocked() {
   Ref(DEBUG_LOCATION, "dns-resolving").release();
   GPR_ASSERT(!resolving_);
   resolving_ = true;
+  last_resolution_timestamp_ = grpc_core::ExecCtx::Get()->Now();
+  if (use_cache_) {
+    if (refresh_cache_) {
+      refresh_cache_ = false;
+      DnsCache::Get()->Invalidate(cache_key_);
+    }
+    LookUpCacheLocked();
+  } else {
+    StartQueryLocked();
+  }
+}
+
+void AresDnsResolver::LookUpCacheLocked() {
+  // Held by the callback, in case it is queued.
+  Ref(DEBUG_LOCATION, "dns-cache").release();
+  bool resolve;
+  DnsCache::ResultPtr result = DnsCache::Get()->Lookup(
+      cache_key_,
+      [this](DnsCache::ResultPtr result) {
+        work_serializer_->Run(
+            [this, result]() { OnCacheResultLocked(std::move(result)); },
+            DEBUG_LOCATION);
+      },
+      &resolve);
+  if (result == nullptr && !resolve) {
+    GRPC_CARES_TRACE_LOG("resolver:%p waiting for a resolution of %s in flight",
+                         this, name_to_resolve_.c_str());
+    return;
+  }
+  Unref(DEBUG_LOCATION, "dns-cache");
+  if (result != nullptr) {
+    GRPC_CARES_TRACE_LOG("resolver:%p got resolution of %s from the cache",
+                         this, name_to_resolve_.c_str());
+    ReturnResultLocked(*result);
+  } else {
+    resolving_for_cache_ = true;
+    StartQueryLocked();
+  }
+}
+
+void AresDnsResolver::StartQueryLocked() {
   service_config_json_ = nullptr;
   pending_request_ = grpc_dns_lookup_ares_locked(
       dns_server_.c_str(), name_to_resolve_.c_str(), kDefaultSecurePort,
       interested_parties_, &on_resolved_, &addresses_,
       enable_srv_queries_ ? &balancer_addresses_ : nullptr,
       request_service_config_ ? &service_config_json_ : nullptr,
-      query_timeout_ms_, work_serializer_);
-  last_resolution_timestamp_ = grpc_core::ExecCtx::Get()->Now();
+      resolving_for_cache_ ? &min_ttl_seconds_ : nullptr, query_timeout_ms_,
+      work_serializer_);
   GRPC_CARES_TRACE_LOG("resolver:%p Started resolving. pending_request_:%p",
                        this, pending_request_);
 }
@@ -20,9 +20,12 @@
 
 #if GRPC_ARES == 1
 
+#include <limits.h>
 #include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
+
 #include <address_sorting/address_sorting.h>
 #include <ares.h>
 
@@ -75,6 +78,12 @@ struct grpc_ares_request {
   grpc_ares_ev_driver* ev_driver;
   /** number of ongoing queries */
   size_t pending_queries;
+  /** the pointer to receive the smallest TTL of the records, in seconds;
+      null if TTLs are not needed */
+  int* min_ttl_seconds_out;
+  /** the smallest TTL of the records received so far, in seconds; INT_MAX
+      until one is received */
+  int min_ttl_seconds;
 
   /** the errors explaining query failures, appended to in query callbacks */
   grpc_error_handle error;
@@ -623,6 +632,9 @@ void grpc_ares_complete_request_locked(grpc_ares_request* r) {
       grpc_cares_wrapper_address_sorting_sort(r, balancer_addresses);
     }
   }
+  if (r->min_ttl_seconds_out != nullptr && r->min_ttl_seconds != INT_MAX) {
+    *r->min_ttl_seconds_out = r->min_ttl_seconds;
+  }
   grpc_core::ExecCtx::Run(DEBUG_LOCATION, r->on_done, r->error);
 }
 
@@ -652,79 +664,196 @@ static void destroy_hostbyname_request_locked(
   delete hr;
 }
 
+static void update_min_ttl_locked(grpc_ares_request* r, int ttl_seconds) {
+  r->min_ttl_seconds = std::min(r->min_ttl_seconds, std::max(ttl_seconds, 0));
+}
+
+/* Lowers r->min_ttl_seconds to the smallest TTL of the records in the answer
+   section of the DNS response in abuf: ares_parse_srv_reply() and
+   ares_parse_txt_reply_ext() do not report them. */
+static void update_min_ttl_from_answers_locked(grpc_ares_request* r,
+                                               const unsigned char* abuf,
+                                               int alen) {
+  // RFC 1035 section 4.1: sizes of the header, and of the fixed parts of
+  // questions and of resource records.
+  constexpr int kHeaderSize = 12;
+  constexpr int kQuestionFixedSize = 4;
+  constexpr int kRecordFixedSize = 10;
+  if (alen < kHeaderSize) return;
+  const int questions = (abuf[4] << 8) | abuf[5];
+  const int answers = (abuf[6] << 8) | abuf[7];
+  const unsigned char* p = abuf + kHeaderSize;
+  const unsigned char* end = abuf + alen;
+  auto skip_name = [&p, abuf, alen]() {
+    char* name;
+    long len;
+    if (ares_expand_name(p, abuf, alen, &name, &len) != ARES_SUCCESS) {
+      return false;
+    }
+    ares_free_string(name);
+    p += len;
+    return true;
+  };
+  for (int i = 0; i < questions; i++) {
+    if (!skip_name() || end - p < kQuestionFixedSize) return;
+    p += kQuestionFixedSize;
+  }
+  for (int i = 0; i < answers; i++) {
+    if (!skip_name() || end - p < kRecordFixedSize) return;
+    const uint32_t ttl = (static_cast<uint32_t>(p[4]) << 24) |
+                         (static_cast<uint32_t>(p[5]) << 16) |
+                         (static_cast<uint32_t>(p[6]) << 8) | p[7];
+    const int rdlength = (p[8] << 8) | p[9];
+    update_min_ttl_locked(
+        r, static_cast<int>(std::min<uint32_t>(ttl, INT_MAX)));
+    p += kRecordFixedSize;
+    if (end - p < rdlength) return;
+    p += rdlength;
+  }
+}
+
+/* Appends \a address, an in_addr or in6_addr, with hr's port, to the
+   addresses of hr. */
+static void add_hostbyname_address_locked(grpc_ares_hostbyname_request* hr,
+                                          ServerAddressList* addresses,
+                                          int family, const void* address) {
+  grpc_ares_request* r = hr->parent_request;
+  absl::InlinedVector<grpc_arg, 1> args_to_add;
+  if (hr->is_balancer) {
+    args_to_add.emplace_back(
+        grpc_core::CreateAuthorityOverrideChannelArg(hr->host));
+  }
+  grpc_channel_args* args = grpc_channel_args_copy_and_add(
+      nullptr, args_to_add.data(), args_to_add.size());
+  switch (family) {
+    case AF_INET6: {
+      size_t addr_len = sizeof(struct sockaddr_in6);
+      struct sockaddr_in6 addr;
+      memset(&addr, 0, addr_len);
+      memcpy(&addr.sin6_addr, address, sizeof(struct in6_addr));
+      addr.sin6_family = static_cast<unsigned char>(family);
+      addr.sin6_port = hr->port;
+      addresses->emplace_back(&addr, addr_len, args);
+      char output[INET6_ADDRSTRLEN];
+      ares_inet_ntop(AF_INET6, &addr.sin6_addr, output, INET6_ADDRSTRLEN);
+      GRPC_CARES_TRACE_LOG(
+          "request:%p c-ares resolver gets a AF_INET6 result: \n"
+          "  addr: %s\n  port: %d\n  sin6_scope_id: %d\n",
+          r, output, ntohs(hr->port), addr.sin6_scope_id);
+      break;
+    }
+    case AF_INET: {
+      size_t addr_len = sizeof(struct sockaddr_in);
+      struct sockaddr_in addr;
+      memset(&addr, 0, addr_len);
+      memcpy(&addr.sin_addr, address, sizeof(struct in_addr));
+      addr.sin_family = static_cast<unsigned char>(family);
+      addr.sin_port = hr->port;
+      addresses->emplace_back(&addr, addr_len, args);
+      char output[INET_ADDRSTRLEN];
+      ares_inet_ntop(AF_INET, &addr.sin_addr, output, INET_ADDRSTRLEN);
+      GRPC_CARES_TRACE_LOG(
+          "request:%p c-ares resolver gets a AF_INET result: \n"
+          "  addr: %s\n  port: %d\n",
+          r, output, ntohs(hr->port));
+      break;
+    }
+    default:
+      grpc_channel_args_destroy(args);
+      break;
+  }
+}
+
+/* Returns the list that the addresses of hr go to, creating it if needed. */
+static ServerAddressList* hostbyname_address_list_locked(
+    grpc_ares_hostbyname_request* hr) {
+  grpc_ares_request* r = hr->parent_request;
+  std::unique_ptr<ServerAddressList>* address_list_ptr =
+      hr->is_balancer ? r->balancer_addresses_out : r->addresses_out;
+  if (*address_list_ptr == nullptr) {
+    *address_list_ptr = absl::make_unique<ServerAddressList>();
+  }
+  return address_list_ptr->get();
+}
+
+static void on_hostbyname_failed_locked(grpc_ares_hostbyname_request* hr,
+                                        int status) {
+  grpc_ares_request* r = hr->parent_request;
+  std::string error_msg = absl::StrFormat(
+      "C-ares status is not ARES_SUCCESS qtype=%s name=%s is_balancer=%d: %s",
+      hr->qtype, hr->host, hr->is_balancer, ares_strerror(status));
+  GRPC_CARES_TRACE_LOG("request:%p on_hostbyname_done_locked: %s", r,
+                       error_msg.c_str());
+  grpc_error_handle error =
+      GRPC_ERROR_CREATE_FROM_CPP_STRING(std::move(error_msg));
+  r->error = grpc_error_add_child(error, r->error);
+}
+
 static void on_hostbyname_done_locked(void* arg, int status, int /*timeouts*/,
                                       struct hostent* hostent) {
   grpc_ares_hostbyname_request* hr =
       static_cast<grpc_ares_hostbyname_request*>(arg);
-  grpc_ares_request* r = hr->parent_request;
   if (status == ARES_SUCCESS) {
     GRPC_CARES_TRACE_LOG(
-        "request:%p on_hostbyname_done_locked qtype=%s host=%s ARES_SUCCESS", r,
-        hr->qtype, hr->host);
-    std::unique_ptr<ServerAddressList>* address_list_ptr =
-        hr->is_balancer ? r->balancer_addresses_out : r->addresses_out;
-    if (*address_list_ptr == nullptr) {
-      *address_list_ptr = absl::make_unique<ServerAddressList>();
-    }
-    ServerAddressList& addresses = **address_list_ptr;
+        "request:%p on_hostbyname_done_locked qtype=%s host=%s ARES_SUCCESS",
+        hr->parent_request, hr->qtype, hr->host);
+    ServerAddressList* addresses = hostbyname_address_list_locked(hr);
     for (size_t i = 0; hostent->h_addr_list[i] != nullptr; ++i) {
-      absl::InlinedVector<grpc_arg, 1> args_to_add;
-      if (hr->is_balancer) {
-        args_to_add.emplace_back(
-            grpc_core::CreateAuthorityOverrideChannelArg(hr->host));
-      }
-      grpc_channel_args* args = grpc_channel_args_copy_and_add(
-          nullptr, args_to_add.data(), args_to_add.size());
-      switch (hostent->h_addrtype) {
-        case AF_INET6: {
-          size_t addr_len = sizeof(struct sockaddr_in6);
-          struct sockaddr_in6 addr;
-          memset(&addr, 0, addr_len);
-          memcpy(&addr.sin6_addr, hostent->h_addr_list[i],
-                 sizeof(struct in6_addr));
-          addr.sin6_family = static_cast<unsigned char>(hostent->h_addrtype);
-          addr.sin6_port = hr->port;
-          addresses.emplace_back(&addr, addr_len, args);
-          char output[INET6_ADDRSTRLEN];
-          ares_inet_ntop(AF_INET6, &addr.sin6_addr, output, INET6_ADDRSTRLEN);
-          GRPC_CARES_TRACE_LOG(
-              "request:%p c-ares resolver gets a AF_INET6 result: \n"
-              "  addr: %s\n  port: %d\n  sin6_scope_id: %d\n",
-              r, output, ntohs(hr->port), addr.sin6_scope_id);
-          break;
-        }
-        case AF_INET: {
-          size_t addr_len = sizeof(struct sockaddr_in);
-          struct sockaddr_in addr;
-          memset(&addr, 0, addr_len);
-          memcpy(&addr.sin_addr, hostent->h_addr_list[i],
-                 sizeof(struct in_addr));
-          addr.sin_family = static_cast<unsigned char>(hostent->h_addrtype);
-          addr.sin_port = hr->port;
-          addresses.emplace_back(&addr, addr_len, args);
-          char output[INET_ADDRSTRLEN];
-          ares_inet_ntop(AF_INET, &addr.sin_addr, output, INET_ADDRSTRLEN);
-          GRPC_CARES_TRACE_LOG(
-              "request:%p c-ares resolver gets a AF_INET result: \n"
-              "  addr: %s\n  port: %d\n",
-              r, output, ntohs(hr->port));
-          break;
-        }
+      add_hostbyname_address_locked(hr, addresses, hostent->h_addrtype,
+                                    hostent->h_addr_list[i]);
+    }
+  } else {
+    on_hostbyname_failed_locked(hr, status);
+  }
+  destroy_hostbyname_request_locked(hr);
+}
+
+static void on_addrinfo_done_locked(void* arg, int status, int /*timeouts*/,
+                                    struct ares_addrinfo* result) {
+  grpc_ares_hostbyname_request* hr =
+      static_cast<grpc_ares_hostbyname_request*>(arg);
+  if (status == ARES_SUCCESS) {
+    GRPC_CARES_TRACE_LOG(
+        "request:%p on_addrinfo_done_locked qtype=%s host=%s ARES_SUCCESS",
+        hr->parent_request, hr->qtype, hr->host);
+    ServerAddressList* addresses = hostbyname_address_list_locked(hr);
+    for (struct ares_addrinfo_node* node = result->nodes; node != nullptr;
+         node = node->ai_next) {
+      update_min_ttl_locked(hr->parent_request, node->ai_ttl);
+      if (node->ai_family == AF_INET6) {
+        add_hostbyname_address_locked(
+            hr, addresses, AF_INET6,
+            &reinterpret_cast<struct sockaddr_in6*>(node->ai_addr)->sin6_addr);
+      } else if (node->ai_family == AF_INET) {
+        add_hostbyname_address_locked(
+            hr, addresses, AF_INET,
+            &reinterpret_cast<struct sockaddr_in*>(node->ai_addr)->sin_addr);
       }
     }
+    ares_freeaddrinfo(result);
   } else {
-    std::string error_msg = absl::StrFormat(
-        "C-ares status is not ARES_SUCCESS qtype=%s name=%s is_balancer=%d: %s",
-        hr->qtype, hr->host, hr->is_balancer, ares_strerror(status));
-    GRPC_CARES_TRACE_LOG("request:%p on_hostbyname_done_locked: %s", r,
-                         error_msg.c_str());
-    grpc_error_handle error =
-        GRPC_ERROR_CREATE_FROM_CPP_STRING(std::move(error_msg));
-    r->error = grpc_error_add_child(error, r->error);
+    on_hostbyname_failed_locked(hr, status);
   }
   destroy_hostbyname_request_locked(hr);
 }
 
+/* Looks up the A or AAAA records of hr->host. Only ares_getaddrinfo() reports
+   the TTLs of the records, so it is used when they were asked for. */
+static void start_hostbyname_request_locked(grpc_ares_hostbyname_request* hr,
+                                            int family) {
+  grpc_ares_request* r = hr->parent_request;
+  if (r->min_ttl_seconds_out == nullptr) {
+    ares_gethostbyname(r->ev_driver->channel, hr->host, family,
+                       on_hostbyname_done_locked, hr);
+    return;
+  }
+  struct ares_addrinfo_hints hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = family;
+  ares_getaddrinfo(r->ev_driver->channel, hr->host, nullptr, &hints,
+                   on_addrinfo_done_locked, hr);
+}
+
 static void on_srv_query_done_locked(void* arg, int status, int /*timeouts*/,
                                      unsigned char* abuf, int alen) {
   GrpcAresQuery* q = static_cast<GrpcAresQuery*>(arg);
@@ -733,6 +862,9 @@ static void on_srv_query_done_locked(void* arg, int status, int /*timeouts*/,
     GRPC_CARES_TRACE_LOG(
         "request:%p on_srv_query_done_locked name=%s ARES_SUCCESS", r,
         q->name().c_str());
+    if (r->min_ttl_seconds_out != nullptr) {
+      update_min_ttl_from_answers_locked(r, abuf, alen);
+    }
     struct ares_srv_reply* reply;
     const int parse_status = ares_parse_srv_reply(abuf, alen, &reply);
     GRPC_CARES_TRACE_LOG("request:%p ares_parse_srv_reply: %d", r,
@@ -744,13 +876,11 @@ static void on_srv_query_done_locked(void* arg, int status, int /*timeouts*/,
           grpc_ares_hostbyname_request* hr = create_hostbyname_request_locked(
               r, srv_it->host, htons(srv_it->port), true /* is_balancer */,
               "AAAA");
-          ares_gethostbyname(r->ev_driver->channel, hr->host, AF_INET6,
-                             on_hostbyname_done_locked, hr);
+          start_hostbyname_request_locked(hr, AF_INET6);
         }
         grpc_ares_hostbyname_request* hr = create_hostbyname_request_locked(
             r, srv_it->host, htons(srv_it->port), true /* is_balancer */, "A");
-        ares_gethostbyname(r->ev_driver->channel, hr->host, AF_INET,
-                           on_hostbyname_done_locked, hr);
+        start_hostbyname_request_locked(hr, AF_INET);
         grpc_ares_notify_on_event_locked(r->ev_driver);
       }
     }
@@ -786,6 +916,9 @@ static void on_txt_done_locked(void* arg, int status, int /*timeouts*/,
                        q->name().c_str());
   status = ares_parse_txt_reply_ext(buf, len, &reply);
   if (status != ARES_SUCCESS) goto fail;
+  if (r->min_ttl_seconds_out != nullptr) {
+    update_min_ttl_from_answers_locked(r, buf, len);
+  }
   // Find service config in TXT record.
   for (result = reply; result != nullptr; result = result->next) {
     if (result->record_start &&
@@ -895,14 +1028,12 @@ void grpc_dns_lookup_ares_continue_after_check_localhost_and_ip_literals_locked(
     hr = create_hostbyname_request_locked(r, host.c_str(),
                                           grpc_strhtons(port.c_str()),
                                           /*is_balancer=*/false, "AAAA");
-    ares_gethostbyname(r->ev_driver->channel, hr->host, AF_INET6,
-                       on_hostbyname_done_locked, hr);
+    start_hostbyname_request_locked(hr, AF_INET6);
   }
   hr = create_hostbyname_request_locked(r, host.c_str(),
                                         grpc_strhtons(port.c_str()),
                                         /*is_balancer=*/false, "A");
-  ares_gethostbyname(r->ev_driver->channel, hr->host, AF_INET,
-                     on_hostbyname_done_locked, hr);
+  start_hostbyname_request_locked(hr, AF_INET);
   if (r->balancer_addresses_out != nullptr) {
     /* Query the SRV record */
     std::string service_name = absl::StrCat("_grpclb._tcp.", host);
@@ -1058,7 +1189,7 @@ static grpc_ares_request* grpc_dns_lookup_ares_locked_impl(
     grpc_pollset_set* interested_parties, grpc_closure* on_done,
     std::unique_ptr<grpc_core::ServerAddressList>* addrs,
     std::unique_ptr<grpc_core::ServerAddressList>* balancer_addrs,
-    char** service_config_json, int query_timeout_ms,
+    char** service_config_json, int* min_ttl_seconds, int query_timeout_ms,
     std::shared_ptr<grpc_core::WorkSerializer> work_serializer) {
   grpc_ares_request* r =
       static_cast<grpc_ares_request*>(gpr_zalloc(sizeof(grpc_ares_request)));
@@ -1069,6 +1200,9 @@ static grpc_ares_request* grpc_dns_lookup_ares_locked_impl(
   r->service_config_json_out = service_config_json;
   r->error = GRPC_ERROR_NONE;
   r->pending_queries = 0;
+  r->min_ttl_seconds_out = min_ttl_seconds;
+  r->min_ttl_seconds = INT_MAX;
+  if (min_ttl_seconds != nullptr) *min_ttl_seconds = -1;
   GRPC_CARES_TRACE_LOG(
       "request:%p c-ares grpc_dns_lookup_ares_locked_impl name=%s, "
       "default_port=%s",
@@ -1103,7 +1237,7 @@ grpc_ares_request* (*grpc_dns_lookup_ares_locked)(
     grpc_pollset_set* interested_parties, grpc_closure* on_done,
     std::unique_ptr<grpc_core::ServerAddressList>* addrs,
     std::unique_ptr<grpc_core::ServerAddressList>* balancer_addrs,
-    char** service_config_json, int query_timeout_ms,
+    char** service_config_json, int* min_ttl_seconds, int query_timeout_ms,
     std::shared_ptr<grpc_core::WorkSerializer> work_serializer) =
     grpc_dns_lookup_ares_locked_impl;
 
@@ -1201,7 +1335,8 @@ static void grpc_resolve_address_invoke_dns_lookup_ares_locked(void* arg) {
       nullptr /* dns_server */, r->name, r->default_port, r->interested_parties,
       &r->on_dns_lookup_done_locked, &r->addresses,
       nullptr /* balancer_addresses */, nullptr /* service_config_json */,
-      GRPC_DNS_ARES_DEFAULT_QUERY_TIMEOUT_MS, r->work_serializer);
+      nullptr /* min_ttl_seconds */, GRPC_DNS_ARES_DEFAULT_QUERY_TIMEOUT_MS,
+      r->work_serializer);
 }
 
 static void grpc_resolve_address_ares_impl(const char* name,
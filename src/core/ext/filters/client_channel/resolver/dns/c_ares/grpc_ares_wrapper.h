@@ -62,13 +62,17 @@ extern void (*grpc_resolve_address_ares)(const char* name,
   function. \a on_done may be called directly in this function without being
   scheduled with \a exec_ctx, so it must not try to acquire locks that are
   being held by the caller. The returned grpc_ares_request object is owned
-  by the caller and it is safe to free after on_done is called back. */
+  by the caller and it is safe to free after on_done is called back.
+  Unless it is null, \a min_ttl_seconds receives the smallest TTL of the
+  records received, in seconds, or -1 if there was none; the A and AAAA
+  records are then looked up with ares_getaddrinfo(), which reports TTLs,
+  rather than ares_gethostbyname(). */
 extern grpc_ares_request* (*grpc_dns_lookup_ares_locked)(
     const char* dns_server, const char* name, const char* default_port,
     grpc_pollset_set* interested_parties, grpc_closure* on_done,
     std::unique_ptr<grpc_core::ServerAddressList>* addresses,
     std::unique_ptr<grpc_core::ServerAddressList>* balancer_addresses,
-    char** service_config_json, int query_timeout_ms,
+    char** service_config_json, int* min_ttl_seconds, int query_timeout_ms,
     std::shared_ptr<grpc_core::WorkSerializer> work_serializer);
 
 /* Cancel the pending grpc_ares_request \a request */
@@ -0,0 +1,136 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/client_channel/resolver/dns/dns_cache.h"
+
+#include <algorithm>
+
+namespace grpc_core {
+
+constexpr grpc_millis DnsCache::kNegativeTtl;
+constexpr grpc_millis DnsCache::kDefaultTtl;
+constexpr grpc_millis DnsCache::kMaxTtl;
+constexpr size_t DnsCache::kMaxEntries;
+
+DnsCache* DnsCache::Get() {
+  static DnsCache* cache = new DnsCache(kMaxEntries);
+  return cache;
+}
+
+DnsCache::ResultPtr DnsCache::Lookup(const std::string& key, Callback on_done,
+                                     bool* resolve) {
+  *resolve = false;
+  MutexLock lock(&mu_);
+  Entry& entry = entries_[key];
+  if (entry.result != nullptr &&
+      entry.expiration > ExecCtx::Get()->Now()) {
+    TouchLocked(key, &entry);
+    return entry.result;
+  }
+  if (entry.resolving) {
+    entry.waiters.push_back(std::move(on_done));
+  } else {
+    entry.resolving = true;
+    *resolve = true;
+  }
+  return nullptr;
+}
+
+void DnsCache::Complete(const std::string& key, ResultPtr result) {
+  std::vector<Callback> waiters;
+  {
+    MutexLock lock(&mu_);
+    auto it = entries_.emplace(key, Entry()).first;
+    Entry& entry = it->second;
+    entry.resolving = false;
+    waiters = TakeWaitersLocked(&entry);
+    grpc_millis ttl;
+    if (result->failed()) {
+      ttl = kNegativeTtl;
+    } else if (result->ttl < 0) {
+      ttl = kDefaultTtl;
+    } else {
+      ttl = std::min(result->ttl, kMaxTtl);
+    }
+    if (ttl > 0) {
+      entry.result = result;
+      entry.expiration = ExecCtx::Get()->Now() + ttl;
+      TouchLocked(key, &entry);
+      while (lru_.size() > max_entries_) {
+        RemoveLocked(entries_.find(lru_.front()));
+      }
+    } else {
+      RemoveLocked(it);
+    }
+  }
+  for (Callback& waiter : waiters) waiter(result);
+}
+
+void DnsCache::Abandon(const std::string& key) {
+  std::vector<Callback> waiters;
+  {
+    MutexLock lock(&mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    it->second.resolving = false;
+    waiters = TakeWaitersLocked(&it->second);
+    if (!it->second.in_lru) entries_.erase(it);
+  }
+  for (Callback& waiter : waiters) waiter(nullptr);
+}
+
+void DnsCache::Invalidate(const std::string& key) {
+  MutexLock lock(&mu_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) RemoveLocked(it);
+}
+
+void DnsCache::Clear() {
+  MutexLock lock(&mu_);
+  while (!lru_.empty()) RemoveLocked(entries_.find(lru_.front()));
+}
+
+std::vector<DnsCache::Callback> DnsCache::TakeWaitersLocked(Entry* entry) {
+  std::vector<Callback> waiters;
+  waiters.swap(entry->waiters);
+  return waiters;
+}
+
+void DnsCache::TouchLocked(const std::string& key, Entry* entry) {
+  if (entry->in_lru) {
+    lru_.splice(lru_.end(), lru_, entry->lru_position);
+  } else {
+    entry->lru_position = lru_.insert(lru_.end(), key);
+    entry->in_lru = true;
+  }
+}
+
+void DnsCache::RemoveLocked(std::map<std::string, Entry>::iterator it) {
+  Entry& entry = it->second;
+  if (entry.in_lru) {
+    lru_.erase(entry.lru_position);
+    entry.in_lru = false;
+  }
+  entry.result.reset();
+  // A resolution in flight still needs its entry, for its waiters.
+  if (!entry.resolving) entries_.erase(it);
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_RESOLVER_DNS_DNS_CACHE_H
+#define GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_RESOLVER_DNS_DNS_CACHE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/core/ext/filters/client_channel/server_address.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+namespace grpc_core {
+
+// A process-wide cache of DNS resolutions, shared by the channels of the
+// c-ares and native resolvers that set GRPC_ARG_DNS_ENABLE_CACHE.
+//
+// Results are kept for their TTL, and failures for kNegativeTtl. While a
+// name is being resolved, the channels that look it up wait for that
+// resolution instead of sending the same queries. Thread-safe.
+class DnsCache {
+ public:
+  // Failures are cached this long.
+  static constexpr grpc_millis kNegativeTtl = 5 * GPR_MS_PER_SEC;
+  // TTL of resolutions that don't report one, like getaddrinfo()'s.
+  static constexpr grpc_millis kDefaultTtl = 30 * GPR_MS_PER_SEC;
+  // Longer TTLs are capped to this.
+  static constexpr grpc_millis kMaxTtl = 10 * 60 * GPR_MS_PER_SEC;
+  // Entries kept by the process-wide cache.
+  static constexpr size_t kMaxEntries = 1024;
+
+  // The outcome of a resolution. Immutable once handed to the cache.
+  struct Result {
+    ~Result() { GRPC_ERROR_UNREF(error); }
+
+    // Null when the resolution did not return any.
+    std::unique_ptr<ServerAddressList> addresses;
+    std::unique_ptr<ServerAddressList> balancer_addresses;
+    // The TXT record choices, empty if there was none.
+    std::string service_config_json;
+    // Why the resolution failed, when it returned no addresses at all.
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    // How long the result may be reused; -1 when unknown.
+    grpc_millis ttl = -1;
+
+    bool failed() const {
+      return addresses == nullptr && balancer_addresses == nullptr;
+    }
+  };
+  using ResultPtr = std::shared_ptr<const Result>;
+
+  // Called with the result of a resolution that was in flight, or with
+  // nullptr if it was abandoned, in which case the caller should look the
+  // name up again.
+  using Callback = std::function<void(ResultPtr)>;
+
+  // The cache shared by all channels.
+  static DnsCache* Get();
+
+  explicit DnsCache(size_t max_entries) : max_entries_(max_entries) {}
+
+  DnsCache(const DnsCache&) = delete;
+  DnsCache& operator=(const DnsCache&) = delete;
+
+  // Returns the cached result for \a key if it has not expired. Otherwise
+  // returns nullptr and either queues \a on_done until the resolution in
+  // flight for \a key completes, or, if there is none, sets \a *resolve:
+  // the caller must then resolve \a key and call Complete() or Abandon().
+  ResultPtr Lookup(const std::string& key, Callback on_done, bool* resolve);
+
+  // Caches \a result for \a key and hands it to the callers waiting for it.
+  void Complete(const std::string& key, ResultPtr result);
+
+  // Gives up on resolving \a key, e.g. because the resolver is shutting down:
+  // the callers waiting for it get nullptr.
+  void Abandon(const std::string& key);
+
+  // Drops the cached result for \a key, e.g. because a channel found its
+  // addresses stale. A resolution in flight is left to complete.
+  void Invalidate(const std::string& key);
+
+  // Drops all the cached results. For tests.
+  void Clear();
+
+ private:
+  struct Entry {
+    ResultPtr result;
+    grpc_millis expiration = 0;
+    bool resolving = false;
+    std::vector<Callback> waiters;
+    // Position in lru_, for entries with a result.
+    std::list<std::string>::iterator lru_position;
+    bool in_lru = false;
+  };
+
+  std::vector<Callback> TakeWaitersLocked(Entry* entry)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void TouchLocked(const std::string& key, Entry* entry)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void RemoveLocked(std::map<std::string, Entry>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const size_t max_entries_;
+  Mutex mu_;
+  std::map<std::string, Entry> entries_ ABSL_GUARDED_BY(mu_);
+  // Keys of the entries with a result, least recently used first.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_RESOLVER_DNS_DNS_CACHE_H */
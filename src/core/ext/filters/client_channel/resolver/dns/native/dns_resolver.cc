@@ -22,6 +22,7 @@
 
 #include <climits>
 #include <cstring>
+#include <memory>
 
 #include "absl/strings/str_cat.h"
 
@@ -29,6 +30,7 @@
 #include <grpc/support/string_util.h>
 #include <grpc/support/time.h>
 
+#include "src/core/ext/filters/client_channel/resolver/dns/dns_cache.h"
 #include "src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.h"
 #include "src/core/ext/filters/client_channel/resolver_registry.h"
 #include "src/core/ext/filters/client_channel/server_address.h"
@@ -66,11 +68,15 @@ class NativeDnsResolver : public Resolver {
 
   void MaybeStartResolvingLocked();
   void StartResolvingLocked();
+  void LookUpCacheLocked();
+  void StartQueryLocked();
 
   static void OnNextResolution(void* arg, grpc_error_handle error);
   void OnNextResolutionLocked(grpc_error_handle error);
   static void OnResolved(void* arg, grpc_error_handle error);
   void OnResolvedLocked(grpc_error_handle error);
+  void OnCacheResultLocked(DnsCache::ResultPtr result);
+  void ReturnResultLocked(const DnsCache::Result& dns_result);
 
   /// name to resolve
   std::string name_to_resolve_;
@@ -84,6 +90,14 @@ class NativeDnsResolver : public Resolver {
   bool shutdown_ = false;
   /// are we currently resolving?
   bool resolving_ = false;
+  /// whether to share resolutions through the DnsCache
+  bool use_cache_;
+  /// what the resolutions are cached under
+  std::string cache_key_;
+  /// whether the pending resolution is for the DnsCache
+  bool resolving_for_cache_ = false;
+  /// whether the next resolution must not be served from the DnsCache
+  bool refresh_cache_ = false;
   grpc_closure on_resolved_;
   /// next resolution timer
   bool have_next_resolution_timer_ = false;
@@ -105,6 +119,9 @@ NativeDnsResolver::NativeDnsResolver(ResolverArgs args)
       work_serializer_(std::move(args.work_serializer)),
       result_handler_(std::move(args.result_handler)),
       interested_parties_(grpc_pollset_set_create()),
+      use_cache_(grpc_channel_args_find_bool(channel_args_,
+                                             GRPC_ARG_DNS_ENABLE_CACHE, false)),
+      cache_key_(absl::StrCat("native|", name_to_resolve_)),
       min_time_between_resolutions_(grpc_channel_args_find_integer(
           channel_args_, GRPC_ARG_DNS_MIN_TIME_BETWEEN_RESOLUTIONS_MS,
           {1000 * 30, 0, INT_MAX})),
@@ -129,6 +146,9 @@ void NativeDnsResolver::StartLocked() { MaybeStartResolvingLocked(); }
 
 void NativeDnsResolver::RequestReresolutionLocked() {
   if (!resolving_) {
+    // The channel asks because the addresses it has stopped working, so a
+    // cached copy of them will not do.
+    refresh_cache_ = use_cache_;
     MaybeStartResolvingLocked();
   }
 }
@@ -172,26 +192,56 @@ void NativeDnsResolver::OnResolved(void* arg, grpc_error_handle error) {
 
 void NativeDnsResolver::OnResolvedLocked(grpc_error_handle error) {
   GPR_ASSERT(resolving_);
-  resolving_ = false;
+  auto dns_result = std::make_shared<DnsCache::Result>();
+  if (addresses_ != nullptr) {
+    dns_result->addresses = absl::make_unique<ServerAddressList>();
+    for (size_t i = 0; i < addresses_->naddrs; ++i) {
+      dns_result->addresses->emplace_back(&addresses_->addrs[i].addr,
+                                          addresses_->addrs[i].len,
+                                          nullptr /* args */);
+    }
+    grpc_resolved_addresses_destroy(addresses_);
+    addresses_ = nullptr;
+  }
+  dns_result->error = error;
+  if (resolving_for_cache_) {
+    resolving_for_cache_ = false;
+    DnsCache::Get()->Complete(cache_key_, dns_result);
+  }
   if (shutdown_) {
+    resolving_ = false;
     Unref(DEBUG_LOCATION, "dns-resolving");
-    GRPC_ERROR_UNREF(error);
     return;
   }
-  if (addresses_ != nullptr) {
+  ReturnResultLocked(*dns_result);
+}
+
+void NativeDnsResolver::OnCacheResultLocked(DnsCache::ResultPtr result) {
+  if (shutdown_) {
+    resolving_ = false;
+    Unref(DEBUG_LOCATION, "dns-resolving");
+  } else if (result == nullptr) {
+    // The resolver we were waiting for gave up: try again.
+    LookUpCacheLocked();
+  } else {
+    ReturnResultLocked(*result);
+  }
+  Unref(DEBUG_LOCATION, "dns-cache");
+}
+
+void NativeDnsResolver::ReturnResultLocked(
+    const DnsCache::Result& dns_result) {
+  resolving_ = false;
+  if (!dns_result.failed()) {
     Result result;
-    for (size_t i = 0; i < addresses_->naddrs; ++i) {
-      result.addresses.emplace_back(&addresses_->addrs[i].addr,
-                                    addresses_->addrs[i].len,
-                                    nullptr /* args */);
-    }
-    grpc_resolved_addresses_destroy(addresses_);
+    result.addresses = *dns_result.addresses;
     result.args = grpc_channel_args_copy(channel_args_);
     result_handler_->ReturnResult(std::move(result));
     // Reset backoff state so that we start from the beginning when the
     // next request gets triggered.
     backoff_.Reset();
   } else {
+    grpc_error_handle error = dns_result.error;
     gpr_log(GPR_INFO, "dns resolution failed (will retry): %s",
             grpc_error_std_string(error).c_str());
     // Return transient error.
@@ -224,7 +274,6 @@ void NativeDnsResolver::OnResolvedLocked(grpc_error_handle error) {
     grpc_timer_init(&next_resolution_timer_, next_try, &on_next_resolution_);
   }
   Unref(DEBUG_LOCATION, "dns-resolving");
-  GRPC_ERROR_UNREF(error);
 }
 
 void NativeDnsResolver::MaybeStartResolvingLocked() {
@@ -272,12 +321,46 @@ void NativeDnsResolver::StartResolvingLocked() {
   Ref(DEBUG_LOCATION, "dns-resolving").release();
   GPR_ASSERT(!resolving_);
   resolving_ = true;
+  last_resolution_timestamp_ = grpc_core::ExecCtx::Get()->Now();
+  if (use_cache_) {
+    if (refresh_cache_) {
+      refresh_cache_ = false;
+      DnsCache::Get()->Invalidate(cache_key_);
+    }
+    LookUpCacheLocked();
+  } else {
+    StartQueryLocked();
+  }
+}
+
+void NativeDnsResolver::LookUpCacheLocked() {
+  // Held by the callback, in case it is queued.
+  Ref(DEBUG_LOCATION, "dns-cache").release();
+  bool resolve;
+  DnsCache::ResultPtr result = DnsCache::Get()->Lookup(
+      cache_key_,
+      [this](DnsCache::ResultPtr result) {
+        work_serializer_->Run(
+            [this, result]() { OnCacheResultLocked(std::move(result)); },
+            DEBUG_LOCATION);
+      },
+      &resolve);
+  if (result == nullptr && !resolve) return;
+  Unref(DEBUG_LOCATION, "dns-cache");
+  if (result != nullptr) {
+    ReturnResultLocked(*result);
+  } else {
+    resolving_for_cache_ = true;
+    StartQueryLocked();
+  }
+}
+
+void NativeDnsResolver::StartQueryLocked() {
   addresses_ = nullptr;
   GRPC_CLOSURE_INIT(&on_resolved_, NativeDnsResolver::OnResolved, this,
                     grpc_schedule_on_exec_ctx);
   grpc_resolve_address(name_to_resolve_.c_str(), kDefaultSecurePort,
                        interested_parties_, &on_resolved_, &addresses_);
-  last_resolution_timestamp_ = grpc_core::ExecCtx::Get()->Now();
 }
 
 //
@@ -19,8 +19,6 @@
 #include "src/core/ext/filters/client_channel/retry_filter.h"
 
 #include "absl/container/inlined_vector.h"
-#include "absl/status/statusor.h"
-#include "absl/strings/strip.h"
 
 #include <grpc/support/log.h>
 
@@ -42,7 +40,6 @@
 #include "src/core/lib/transport/metadata_batch.h"
 #include "src/core/lib/transport/static_metadata.h"
 #include "src/core/lib/transport/status_metadata.h"
-#include "src/core/lib/uri/uri_parser.h"
 
 //
 // Retry filter
@@ -147,35 +144,9 @@ class RetryFilter {
   RetryFilter(const grpc_channel_args* args, grpc_error_handle* error)
       : client_channel_(grpc_channel_args_find_pointer<ClientChannel>(
             args, GRPC_ARG_CLIENT_CHANNEL)),
-        per_rpc_retry_buffer_size_(GetMaxPerRpcRetryBufferSize(args)) {
-    // Get retry throttling parameters from service config.
-    auto* service_config = grpc_channel_args_find_pointer<ServiceConfig>(
-        args, GRPC_ARG_SERVICE_CONFIG_OBJ);
-    if (service_config == nullptr) return;
-    const auto* config = static_cast<const RetryGlobalConfig*>(
-        service_config->GetGlobalParsedConfig(
-            RetryServiceConfigParser::ParserIndex()));
-    if (config == nullptr) return;
-    // Get server name from target URI.
-    const char* server_uri =
-        grpc_channel_args_find_string(args, GRPC_ARG_SERVER_URI);
-    if (server_uri == nullptr) {
-      *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
-          "server URI channel arg missing or wrong type in client channel "
-          "filter");
-      return;
-    }
-    absl::StatusOr<URI> uri = URI::Parse(server_uri);
-    if (!uri.ok() || uri->path().empty()) {
-      *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
-          "could not extract server name from target URI");
-      return;
-    }
-    std::string server_name(absl::StripPrefix(uri->path(), "/"));
-    // Get throttling config for server_name.
-    retry_throttle_data_ = internal::ServerRetryThrottleMap::GetDataForServer(
-        server_name, config->max_milli_tokens(), config->milli_token_ratio());
-  }
+        per_rpc_retry_buffer_size_(GetMaxPerRpcRetryBufferSize(args)),
+        retry_throttle_data_(
+            internal::GetRetryThrottleDataFromChannelArgs(args, error)) {}
 
   ClientChannel* client_channel_;
   size_t per_rpc_retry_buffer_size_;
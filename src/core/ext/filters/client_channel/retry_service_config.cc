@@ -22,7 +22,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 #include "absl/types/optional.h"
 
 #include <grpc/support/alloc.h>
@@ -32,6 +34,7 @@
 #include "src/core/ext/filters/client_channel/client_channel.h"
 #include "src/core/ext/filters/client_channel/lb_policy_registry.h"
 #include "src/core/ext/filters/client_channel/server_address.h"
+#include "src/core/ext/filters/client_channel/service_config.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/status_util.h"
 #include "src/core/lib/gpr/string.h"
@@ -312,5 +315,36 @@ RetryServiceConfigParser::ParsePerMethodParams(const grpc_channel_args* args,
       retryable_status_codes, per_attempt_recv_timeout);
 }
 
+RefCountedPtr<ServerRetryThrottleData> GetRetryThrottleDataFromChannelArgs(
+    const grpc_channel_args* args, grpc_error_handle* error) {
+  // Get retry throttling parameters from service config.
+  auto* service_config = grpc_channel_args_find_pointer<ServiceConfig>(
+      args, GRPC_ARG_SERVICE_CONFIG_OBJ);
+  if (service_config == nullptr) return nullptr;
+  const auto* config = static_cast<const RetryGlobalConfig*>(
+      service_config->GetGlobalParsedConfig(
+          RetryServiceConfigParser::ParserIndex()));
+  if (config == nullptr) return nullptr;
+  // Get server name from target URI.
+  const char* server_uri =
+      grpc_channel_args_find_string(args, GRPC_ARG_SERVER_URI);
+  if (server_uri == nullptr) {
+    *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "server URI channel arg missing or wrong type in client channel "
+        "filter");
+    return nullptr;
+  }
+  absl::StatusOr<URI> uri = URI::Parse(server_uri);
+  if (!uri.ok() || uri->path().empty()) {
+    *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "could not extract server name from target URI");
+    return nullptr;
+  }
+  std::string server_name(absl::StripPrefix(uri->path(), "/"));
+  // Get throttling config for server_name.
+  return ServerRetryThrottleMap::GetDataForServer(
+      server_name, config->max_milli_tokens(), config->milli_token_ratio());
+}
+
 }  // namespace internal
 }  // namespace grpc_core
@@ -90,6 +90,11 @@ class RetryServiceConfigParser : public ServiceConfigParser::Parser {
   static void Register();
 };
 
+// Returns the retry throttle data of the server that \a args target, or null
+// if the service config in \a args does not throttle retries.
+RefCountedPtr<ServerRetryThrottleData> GetRetryThrottleDataFromChannelArgs(
+    const grpc_channel_args* args, grpc_error_handle* error);
+
 }  // namespace internal
 }  // namespace grpc_core
 
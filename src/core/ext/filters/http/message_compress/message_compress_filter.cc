@@ -21,8 +21,18 @@
 #include "src/core/ext/filters/http/message_compress/message_compress_filter.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <zlib.h>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_split.h"
 #include "absl/types/optional.h"
 
 #include <grpc/compression.h>
@@ -31,20 +41,29 @@
 #include <grpc/support/log.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/compression/adaptive_compression.h"
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/compression_args.h"
+#include "src/core/lib/compression/compression_dictionary.h"
 #include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/compression/parallel_compress.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
+#include "src/core/lib/slice/slice_utils.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/transport/static_metadata.h"
 
 namespace {
 
+constexpr int kDefaultMinBytesSavedPerCpuMs = 4096;
+
 class ChannelData {
  public:
   explicit ChannelData(grpc_channel_element_args* args) {
@@ -71,6 +90,19 @@ class ChannelData {
     enabled_stream_compression_algorithms_bitset_ =
         grpc_compression_bitset_to_stream_bitset(
             enabled_compression_algorithms_bitset_);
+    if (grpc_channel_args_find_bool(args->channel_args,
+                                    GRPC_ARG_ADAPTIVE_MESSAGE_COMPRESSION,
+                                    false)) {
+      adaptive_compression_policy_ =
+          absl::make_unique<grpc_core::AdaptiveCompressionPolicy>(
+              grpc_channel_args_find_integer(
+                  args->channel_args,
+                  GRPC_ARG_ADAPTIVE_COMPRESSION_MIN_BYTES_SAVED_PER_CPU_MS,
+                  {kDefaultMinBytesSavedPerCpuMs, 0, INT_MAX}));
+    }
+    parallel_compression_min_message_size_ = grpc_channel_args_find_integer(
+        args->channel_args, GRPC_ARG_PARALLEL_COMPRESSION_MIN_MESSAGE_SIZE,
+        {0, 0, INT_MAX});
     GPR_ASSERT(!args->is_last);
   }
 
@@ -90,6 +122,38 @@ class ChannelData {
     return enabled_stream_compression_algorithms_bitset_;
   }
 
+  /** Null unless GRPC_ARG_ADAPTIVE_MESSAGE_COMPRESSION is set. */
+  grpc_core::AdaptiveCompressionPolicy* adaptive_compression_policy() const {
+    return adaptive_compression_policy_.get();
+  }
+
+  /** 0 unless GRPC_ARG_PARALLEL_COMPRESSION_MIN_MESSAGE_SIZE is set. */
+  size_t parallel_compression_min_message_size() const {
+    return parallel_compression_min_message_size_;
+  }
+
+  /** Whether calls need to know their method to compress. */
+  bool needs_method() const {
+    return adaptive_compression_policy_ != nullptr ||
+           grpc_core::CompressionDictionariesRegistered();
+  }
+
+  /** Clients only: whether the server listed \a dictionary in the
+   * grpc-accept-encoding of a response on this connection. */
+  bool ServerHasDictionary(const grpc_core::CompressionDictionary* dictionary) {
+    grpc_core::MutexLock lock(&mu_);
+    return std::find(server_dictionaries_.begin(), server_dictionaries_.end(),
+                     dictionary) != server_dictionaries_.end();
+  }
+
+  void AddServerDictionary(const grpc_core::CompressionDictionary* dictionary) {
+    grpc_core::MutexLock lock(&mu_);
+    if (std::find(server_dictionaries_.begin(), server_dictionaries_.end(),
+                  dictionary) == server_dictionaries_.end()) {
+      server_dictionaries_.push_back(dictionary);
+    }
+  }
+
  private:
   /** The default, channel-level, compression algorithm */
   grpc_compression_algorithm default_compression_algorithm_;
@@ -99,13 +163,23 @@ class ChannelData {
   uint32_t enabled_message_compression_algorithms_bitset_;
   /** Bitset of enabled stream compression algorithms */
   uint32_t enabled_stream_compression_algorithms_bitset_;
+  std::unique_ptr<grpc_core::AdaptiveCompressionPolicy>
+      adaptive_compression_policy_;
+  size_t parallel_compression_min_message_size_;
+  grpc_core::Mutex mu_;
+  /** The dictionaries the server advertised. Registered dictionaries are
+   * never freed, and there are few of them. */
+  std::vector<const grpc_core::CompressionDictionary*> server_dictionaries_
+      ABSL_GUARDED_BY(mu_);
 };
 
 class CallData {
  public:
   CallData(grpc_call_element* elem, const grpc_call_element_args& args)
-      : call_combiner_(args.call_combiner) {
-    ChannelData* channeld = static_cast<ChannelData*>(elem->channel_data);
+      : call_combiner_(args.call_combiner),
+        arena_(args.arena),
+        channeld_(static_cast<ChannelData*>(elem->channel_data)) {
+    ChannelData* channeld = channeld_;
     // The call's message compression algorithm is set to channel's default
     // setting. It can be overridden later by initial metadata.
     if (GPR_LIKELY(GPR_BITGET(channeld->enabled_compression_algorithms_bitset(),
@@ -116,12 +190,18 @@ class CallData {
     }
     GRPC_CLOSURE_INIT(&start_send_message_batch_in_call_combiner_,
                       StartSendMessageBatch, elem, grpc_schedule_on_exec_ctx);
+    GRPC_CLOSURE_INIT(&on_recv_initial_metadata_ready_,
+                      OnRecvInitialMetadataReady, this,
+                      grpc_schedule_on_exec_ctx);
   }
 
   ~CallData() {
     if (state_initialized_) {
       grpc_slice_buffer_destroy_internal(&slices_);
     }
+    if (compressor_ != nullptr) {
+      compressor_->~MessageCompressor();
+    }
     GRPC_ERROR_UNREF(cancel_error_);
   }
 
@@ -130,11 +210,19 @@ class CallData {
 
  private:
   bool SkipMessageCompression();
+  // Whether messages are deflated with dictionary_.
+  bool UseDictionary() const {
+    return message_compression_algorithm_ == GRPC_MESSAGE_COMPRESS_DEFLATE &&
+           dictionary_ != nullptr && peer_has_dictionary_;
+  }
   void InitializeState(grpc_call_element* elem);
 
   grpc_error_handle ProcessSendInitialMetadata(
       grpc_call_element* elem, grpc_metadata_batch* initial_metadata);
 
+  void FindMethodState(grpc_metadata_batch* metadata, bool from_peer);
+  static void OnRecvInitialMetadataReady(void* arg, grpc_error_handle error);
+
   // Methods for processing a send_message batch
   static void StartSendMessageBatch(void* elem_arg, grpc_error_handle unused);
   static void OnSendMessageNextDone(void* elem_arg, grpc_error_handle error);
@@ -148,6 +236,8 @@ class CallData {
   static void SendMessageOnComplete(void* calld_arg, grpc_error_handle error);
 
   grpc_core::CallCombiner* call_combiner_;
+  grpc_core::Arena* arena_;
+  ChannelData* channeld_;
   grpc_message_compression_algorithm message_compression_algorithm_ =
       GRPC_MESSAGE_COMPRESS_NONE;
   grpc_error_handle cancel_error_ = GRPC_ERROR_NONE;
@@ -156,6 +246,21 @@ class CallData {
   /* Set to true, if the fields below are initialized. */
   bool state_initialized_ = false;
   grpc_closure start_send_message_batch_in_call_combiner_;
+  /* The compression dictionary and the adaptive compression stats depend on
+   * the method. Clients find it in send_initial_metadata, servers in
+   * recv_initial_metadata. */
+  const grpc_core::CompressionDictionary* dictionary_ = nullptr;
+  /* Whether the peer can inflate messages deflated with dictionary_: servers
+   * know it if the client lists the dictionary in grpc-accept-encoding.
+   * Clients know it once the server listed it in a response on the same
+   * connection, and send plain deflate until then. */
+  bool peer_has_dictionary_ = false;
+  grpc_core::AdaptiveCompressionStats* adaptive_stats_ = nullptr;
+  grpc_metadata_batch* recv_initial_metadata_ = nullptr;
+  grpc_closure* original_recv_initial_metadata_ready_ = nullptr;
+  grpc_closure on_recv_initial_metadata_ready_;
+  /* Created with the first message to compress. */
+  grpc_core::MessageCompressor* compressor_ = nullptr;
   /* The fields below are only initialized when we compress the payload.
    * Keep them at the bottom of the struct, so they don't pollute the
    * cache-lines. */
@@ -163,6 +268,10 @@ class CallData {
   grpc_linked_mdelem stream_compression_algorithm_storage_;
   grpc_linked_mdelem accept_encoding_storage_;
   grpc_linked_mdelem accept_stream_encoding_storage_;
+  /* Back the grpc-encoding and grpc-accept-encoding elements that name
+   * dictionary_, which then need neither an allocation nor interning. */
+  grpc_metadata dictionary_encoding_md_;
+  grpc_metadata dictionary_accept_encoding_md_;
   grpc_slice_buffer slices_; /**< Buffers up input slices to be compressed */
   // Allocate space for the replacement stream
   std::aligned_storage<sizeof(grpc_core::SliceBufferByteStream),
@@ -173,6 +282,16 @@ class CallData {
   grpc_closure on_send_message_next_done_;
 };
 
+// Returns an element that uses *storage as its backing store: it needs no ref,
+// but storage has to outlive it.
+grpc_mdelem ExternalMdelem(const grpc_core::StaticMetadataSlice& key,
+                           const grpc_slice& value, grpc_metadata* storage) {
+  storage->key = key;
+  storage->value = value;
+  return grpc_mdelem_create(key, value,
+                            reinterpret_cast<grpc_mdelem_data*>(storage));
+}
+
 // Returns true if we should skip message compression for the current message.
 bool CallData::SkipMessageCompression() {
   // If the flags of this message indicate that it shouldn't be compressed, we
@@ -236,6 +355,67 @@ void CallData::InitializeState(grpc_call_element* elem) {
                     grpc_schedule_on_exec_ctx);
 }
 
+// Whether the grpc-accept-encoding in \a metadata lists \a dictionary.
+bool AcceptsDictionary(grpc_metadata_batch* metadata,
+                       const grpc_core::CompressionDictionary* dictionary) {
+  grpc_linked_mdelem* accept_encoding =
+      (*metadata)->legacy_index()->named.grpc_accept_encoding;
+  if (accept_encoding == nullptr) return false;
+  absl::string_view accepted =
+      grpc_core::StringViewFromSlice(GRPC_MDVALUE(accept_encoding->md));
+  for (absl::string_view encoding : absl::StrSplit(accepted, ',')) {
+    if (absl::StripAsciiWhitespace(encoding) == dictionary->encoding_name()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CallData::FindMethodState(grpc_metadata_batch* metadata,
+                               bool from_peer) {
+  grpc_linked_mdelem* path = (*metadata)->legacy_index()->named.path;
+  if (path == nullptr) return;
+  absl::string_view method =
+      grpc_core::StringViewFromSlice(GRPC_MDVALUE(path->md));
+  if (GPR_BITGET(channeld_->enabled_message_compression_algorithms_bitset(),
+                 GRPC_MESSAGE_COMPRESS_DEFLATE)) {
+    dictionary_ = grpc_core::CompressionDictionaryForPath(method);
+  }
+  if (dictionary_ != nullptr) {
+    peer_has_dictionary_ = from_peer
+                               ? AcceptsDictionary(metadata, dictionary_)
+                               : channeld_->ServerHasDictionary(dictionary_);
+  }
+  // Clients that do not compress never need the stats.
+  if (channeld_->adaptive_compression_policy() != nullptr &&
+      (from_peer ||
+       message_compression_algorithm_ != GRPC_MESSAGE_COMPRESS_NONE)) {
+    adaptive_stats_ =
+        channeld_->adaptive_compression_policy()->StatsForMethod(method);
+  }
+}
+
+void CallData::OnRecvInitialMetadataReady(void* arg, grpc_error_handle error) {
+  CallData* calld = static_cast<CallData*>(arg);
+  if (error == GRPC_ERROR_NONE) {
+    if ((*calld->recv_initial_metadata_)->legacy_index()->named.path !=
+        nullptr) {
+      calld->FindMethodState(calld->recv_initial_metadata_,
+                             /*from_peer=*/true);
+    } else if (calld->dictionary_ != nullptr &&
+               AcceptsDictionary(calld->recv_initial_metadata_,
+                                 calld->dictionary_)) {
+      // A client reading the response headers. This call already chose its
+      // grpc-encoding, but the next calls on the connection can use the
+      // dictionary.
+      calld->channeld_->AddServerDictionary(calld->dictionary_);
+    }
+  }
+  grpc_core::Closure::Run(DEBUG_LOCATION,
+                          calld->original_recv_initial_metadata_ready_,
+                          GRPC_ERROR_REF(error));
+}
+
 grpc_error_handle CallData::ProcessSendInitialMetadata(
     grpc_call_element* elem, grpc_metadata_batch* initial_metadata) {
   ChannelData* channeld = static_cast<ChannelData*>(elem->channel_data);
@@ -249,14 +429,21 @@ grpc_error_handle CallData::ProcessSendInitialMetadata(
   grpc_stream_compression_algorithm stream_compression_algorithm =
       grpc_compression_algorithm_to_stream_compression_algorithm(
           compression_algorithm);
+  if (channeld->needs_method()) {
+    FindMethodState(initial_metadata, /*from_peer=*/false);
+  }
   // Hint compression algorithm.
   grpc_error_handle error = GRPC_ERROR_NONE;
   if (message_compression_algorithm_ != GRPC_MESSAGE_COMPRESS_NONE) {
     InitializeState(elem);
     error = grpc_metadata_batch_add_tail(
         initial_metadata, &message_compression_algorithm_storage_,
-        grpc_message_compression_encoding_mdelem(
-            message_compression_algorithm_),
+        UseDictionary()
+            ? ExternalMdelem(GRPC_MDSTR_GRPC_ENCODING,
+                             dictionary_->encoding_slice(),
+                             &dictionary_encoding_md_)
+            : grpc_message_compression_encoding_mdelem(
+                  message_compression_algorithm_),
         GRPC_BATCH_GRPC_ENCODING);
   } else if (stream_compression_algorithm != GRPC_STREAM_COMPRESS_NONE) {
     InitializeState(elem);
@@ -266,11 +453,18 @@ grpc_error_handle CallData::ProcessSendInitialMetadata(
         GRPC_BATCH_CONTENT_ENCODING);
   }
   if (error != GRPC_ERROR_NONE) return error;
-  // Convey supported compression algorithms.
+  // Convey supported compression algorithms, and the dictionary of the method
+  // if there is one.
   error = grpc_metadata_batch_add_tail(
       initial_metadata, &accept_encoding_storage_,
-      GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
-          channeld->enabled_message_compression_algorithms_bitset()),
+      dictionary_ != nullptr
+          ? ExternalMdelem(
+                GRPC_MDSTR_GRPC_ACCEPT_ENCODING,
+                dictionary_->accept_encoding_slice(
+                    channeld->enabled_message_compression_algorithms_bitset()),
+                &dictionary_accept_encoding_md_)
+          : GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
+                channeld->enabled_message_compression_algorithms_bitset()),
       GRPC_BATCH_GRPC_ACCEPT_ENCODING);
   if (error != GRPC_ERROR_NONE) return error;
   // Do not overwrite accept-encoding header if it already presents (e.g., added
@@ -309,8 +503,43 @@ void CallData::FinishSendMessage(grpc_call_element* elem) {
   grpc_slice_buffer_init(&tmp);
   uint32_t send_flags =
       send_message_batch_->payload->send_message.send_message->flags();
-  bool did_compress =
-      grpc_msg_compress(message_compression_algorithm_, &slices_, &tmp);
+  if (compressor_ == nullptr) {
+    compressor_ = arena_->New<grpc_core::MessageCompressor>();
+    if (UseDictionary()) compressor_->set_dictionary(dictionary_);
+    if (channeld_->parallel_compression_min_message_size() > 0) {
+      compressor_->set_parallel_compressor(
+          grpc_core::ParallelCompressor::Get(),
+          channeld_->parallel_compression_min_message_size());
+    }
+  }
+  bool did_compress = false;
+  grpc_core::AdaptiveCompressionStats::Decision decision = {
+      true, Z_DEFAULT_COMPRESSION};
+  if (adaptive_stats_ != nullptr) {
+    decision = adaptive_stats_->Decide(&slices_);
+    compressor_->set_level(decision.level);
+  }
+  if (decision.compress) {
+    const int64_t start = gpr_thread_cpu_time_ns();
+    did_compress =
+        compressor_->Compress(message_compression_algorithm_, &slices_, &tmp);
+    const int64_t cpu_ns = gpr_thread_cpu_time_ns() - start +
+                           compressor_->last_helper_cpu_ns();
+    // On failure, tmp holds a copy of the input.
+    if (adaptive_stats_ != nullptr) {
+      adaptive_stats_->Record(decision.level, slices_.length, tmp.length,
+                              cpu_ns);
+    }
+    GRPC_STATS_ADD_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_CPU_US,
+                           cpu_ns / GPR_NS_PER_US);
+    if (did_compress) {
+      GRPC_STATS_INC_MESSAGE_COMPRESSION_COMPRESSED();
+      GRPC_STATS_ADD_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_BYTES_SAVED,
+                             slices_.length - tmp.length);
+    }
+  } else {
+    GRPC_STATS_INC_MESSAGE_COMPRESSION_SKIPPED();
+  }
   if (did_compress) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_compression_trace)) {
       const char* algo_name;
@@ -460,6 +689,15 @@ void CallData::CompressStartTransportStreamOpBatch(
         batch, GRPC_ERROR_REF(cancel_error_), call_combiner_);
     return;
   }
+  // Handle recv_initial_metadata.
+  if (batch->recv_initial_metadata && channeld_->needs_method()) {
+    recv_initial_metadata_ =
+        batch->payload->recv_initial_metadata.recv_initial_metadata;
+    original_recv_initial_metadata_ready_ =
+        batch->payload->recv_initial_metadata.recv_initial_metadata_ready;
+    batch->payload->recv_initial_metadata.recv_initial_metadata_ready =
+        &on_recv_initial_metadata_ready_;
+  }
   // Handle send_initial_metadata.
   if (batch->send_initial_metadata) {
     GPR_ASSERT(!seen_initial_metadata_);
@@ -35,11 +35,13 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/compression_args.h"
+#include "src/core/lib/compression/compression_dictionary.h"
 #include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
+#include "src/core/lib/slice/slice_utils.h"
 
 namespace grpc_core {
 namespace {
@@ -59,6 +61,7 @@ class CallData {
  public:
   CallData(const grpc_call_element_args& args, const ChannelData* chand)
       : call_combiner_(args.call_combiner),
+        arena_(args.arena),
         max_recv_message_length_(chand->max_recv_size()) {
     // Initialize state for recv_initial_metadata_ready callback
     GRPC_CLOSURE_INIT(&on_recv_initial_metadata_ready_,
@@ -83,7 +86,10 @@ class CallData {
     }
   }
 
-  ~CallData() { grpc_slice_buffer_destroy_internal(&recv_slices_); }
+  ~CallData() {
+    grpc_slice_buffer_destroy_internal(&recv_slices_);
+    if (decompressor_ != nullptr) decompressor_->~MessageCompressor();
+  }
 
   void DecompressStartTransportStreamOpBatch(
       grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
@@ -105,6 +111,7 @@ class CallData {
   static void OnRecvTrailingMetadataReady(void* arg, grpc_error_handle error);
 
   CallCombiner* call_combiner_;
+  Arena* arena_;
   // Overall error for the call
   grpc_error_handle error_ = GRPC_ERROR_NONE;
   // Fields for handling recv_initial_metadata_ready callback
@@ -115,6 +122,10 @@ class CallData {
   bool seen_recv_message_ready_ = false;
   int max_recv_message_length_;
   grpc_message_compression_algorithm algorithm_ = GRPC_MESSAGE_COMPRESS_NONE;
+  // The preset dictionary named by grpc-encoding, if any.
+  const CompressionDictionary* dictionary_ = nullptr;
+  // Created with the first compressed message.
+  MessageCompressor* decompressor_ = nullptr;
   grpc_closure on_recv_message_ready_;
   grpc_closure* original_recv_message_ready_ = nullptr;
   grpc_closure on_recv_message_next_done_;
@@ -156,6 +167,13 @@ void CallData::OnRecvInitialMetadataReady(void* arg, grpc_error_handle error) {
         (*calld->recv_initial_metadata_)->legacy_index()->named.grpc_encoding;
     if (grpc_encoding != nullptr) {
       calld->algorithm_ = DecodeMessageCompressionAlgorithm(grpc_encoding->md);
+      uint32_t dictionary_id;
+      if (ParseCompressionDictionaryEncoding(
+              StringViewFromSlice(GRPC_MDVALUE(grpc_encoding->md)),
+              &dictionary_id)) {
+        // Messages that need an unknown dictionary fail to decompress.
+        calld->dictionary_ = CompressionDictionaryForId(dictionary_id);
+      }
     }
   }
   calld->MaybeResumeOnRecvMessageReady();
@@ -257,8 +275,12 @@ void CallData::OnRecvMessageNextDone(void* arg, grpc_error_handle error) {
 void CallData::FinishRecvMessage() {
   grpc_slice_buffer decompressed_slices;
   grpc_slice_buffer_init(&decompressed_slices);
-  if (grpc_msg_decompress(algorithm_, &recv_slices_, &decompressed_slices) ==
-      0) {
+  if (decompressor_ == nullptr) {
+    decompressor_ = arena_->New<MessageCompressor>();
+    decompressor_->set_dictionary(dictionary_);
+  }
+  if (decompressor_->Decompress(algorithm_, &recv_slices_,
+                                &decompressed_slices) == 0) {
     GPR_DEBUG_ASSERT(error_ == GRPC_ERROR_NONE);
     error_ = GRPC_ERROR_CREATE_FROM_CPP_STRING(
         absl::StrCat("Unexpected error decompressing data for algorithm with "
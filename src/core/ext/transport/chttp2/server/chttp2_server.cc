@@ -414,6 +414,10 @@ void Chttp2ServerListener::ActiveConnection::HandshakingState::OnHandshakeDone(
       // handshaker may have handed off the connection to some external
       // code, so we can just clean up here without creating a transport.
       if (args->endpoint != nullptr) {
+        // The tcp server polls the accepted socket in the accepting pollset.
+        // A handshaker may have replaced the endpoint, so poll whatever we
+        // ended up with there too; adding the same fd again is a no-op.
+        grpc_endpoint_add_to_pollset(args->endpoint, self->accepting_pollset_);
         grpc_transport* transport = grpc_create_chttp2_transport(
             args->args, args->endpoint, false,
             grpc_resource_user_create(
@@ -46,6 +46,7 @@
 #include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/transport/error_utils.h"
@@ -303,6 +304,11 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                            GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE)) {
       t->write_buffer_size = static_cast<uint32_t>(grpc_channel_arg_get_integer(
           &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_WRITE_TIMESTAMPS_SAMPLING_PERIOD)) {
+      t->write_timestamps_sampling_period =
+          static_cast<uint32_t>(grpc_channel_arg_get_integer(
+              &channel_args->args[i], {0, 0, INT_MAX}));
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
       enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
@@ -385,6 +391,11 @@ static bool read_channel_args(grpc_chttp2_transport* t,
       }
     }
   }
+  // Only sockets reporting errors separately report TX timestamps.
+  if (t->write_timestamps_sampling_period != 0 &&
+      !grpc_endpoint_can_track_err(t->ep)) {
+    t->write_timestamps_sampling_period = 0;
+  }
   if (channelz_enabled) {
     t->channelz_socket =
         grpc_core::MakeRefCounted<grpc_core::channelz::SocketNode>(
@@ -663,6 +674,14 @@ grpc_chttp2_stream::grpc_chttp2_stream(grpc_chttp2_transport* t,
     flow_control.Init<grpc_core::chttp2::StreamFlowControlDisabled>();
   }
 
+  if (t->write_timestamps_sampling_period != 0 &&
+      ++t->write_timestamps_countdown >= t->write_timestamps_sampling_period) {
+    t->write_timestamps_countdown = 0;
+    write_timestamps_sampled = true;
+    last_write_done_time = gpr_now(GPR_CLOCK_REALTIME);
+  }
+  write_queued_time = gpr_inf_past(GPR_CLOCK_REALTIME);
+
   grpc_slice_buffer_init(&frame_storage);
   grpc_slice_buffer_init(&unprocessed_incoming_frames_buffer);
   grpc_slice_buffer_init(&flow_controlled_buffer);
@@ -725,6 +744,9 @@ static int init_stream(grpc_transport* gt, grpc_stream* gs,
   GPR_TIMER_SCOPE("init_stream", 0);
   grpc_chttp2_transport* t = reinterpret_cast<grpc_chttp2_transport*>(gt);
   new (gs) grpc_chttp2_stream(t, refcount, server_data, arena);
+  // Client streams get their id later, when they start: see stream_start.
+  GRPC_USDT4(stream_create, t, gs, t->is_client,
+             reinterpret_cast<grpc_chttp2_stream*>(gs)->id);
   return 0;
 }
 
@@ -806,6 +828,15 @@ static void set_write_state(grpc_chttp2_transport* t,
       gpr_log(GPR_INFO, "W:%p %s [%s] state %s -> %s [%s]", t,
               t->is_client ? "CLIENT" : "SERVER", t->peer_string.c_str(),
               write_state_name(t->write_state), write_state_name(st), reason));
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled()) &&
+      (t->write_state == GRPC_CHTTP2_WRITE_STATE_IDLE) !=
+          (st == GRPC_CHTTP2_WRITE_STATE_IDLE)) {
+    if (st == GRPC_CHTTP2_WRITE_STATE_IDLE) {
+      grpc_core::LatencyTracer::AsyncEnd("chttp2.write_cycle", t);
+    } else {
+      grpc_core::LatencyTracer::AsyncBegin("chttp2.write_cycle", t);
+    }
+  }
   t->write_state = st;
   // If the state is being reset back to idle, it means a write was just
   // finished. Make sure all the run_after_write closures are scheduled.
@@ -1166,6 +1197,7 @@ static void maybe_start_some_streams(grpc_chttp2_transport* t) {
     }
 
     grpc_chttp2_stream_map_add(&t->stream_map, s->id, s);
+    GRPC_USDT3(stream_start, t, s, s->id);
     post_destructive_reclaimer(t);
     grpc_chttp2_mark_stream_writable(t, s);
     grpc_chttp2_initiate_write(t, GRPC_CHTTP2_INITIATE_WRITE_START_NEW_STREAM);
@@ -1269,10 +1301,35 @@ static void maybe_become_writable_due_to_send_msg(grpc_chttp2_transport* t,
   }
 }
 
+// Adds the prefix of the message being fetched to flow_controlled_buffer. If
+// the message's first slice is given and has headroom, the prefix is written
+// in place, and the slice grown to include it.
+static void add_send_message_prefix_locked(grpc_chttp2_stream* s,
+                                           grpc_slice* first_slice) {
+  s->send_message_prefix_pending = false;
+  grpc_slice grown;
+  if (first_slice != nullptr &&
+      grpc_core::ClaimSliceHeadroom(*first_slice, GRPC_HEADER_SIZE_IN_BYTES,
+                                    &grown)) {
+    GRPC_STATS_INC_HTTP2_MESSAGE_PREFIXES_IN_PLACE();
+    memcpy(GRPC_SLICE_START_PTR(grown), s->send_message_prefix,
+           GRPC_HEADER_SIZE_IN_BYTES);
+    grpc_slice_unref_internal(*first_slice);
+    *first_slice = grown;
+  } else {
+    memcpy(grpc_slice_buffer_tiny_add(&s->flow_controlled_buffer,
+                                      GRPC_HEADER_SIZE_IN_BYTES),
+           s->send_message_prefix, GRPC_HEADER_SIZE_IN_BYTES);
+  }
+}
+
 static void add_fetched_slice_locked(grpc_chttp2_transport* t,
                                      grpc_chttp2_stream* s) {
   s->fetched_send_message_length +=
       static_cast<uint32_t> GRPC_SLICE_LENGTH(s->fetching_slice);
+  if (s->send_message_prefix_pending) {
+    add_send_message_prefix_locked(s, &s->fetching_slice);
+  }
   grpc_slice_buffer_add(&s->flow_controlled_buffer, s->fetching_slice);
   maybe_become_writable_due_to_send_msg(t, s);
 }
@@ -1285,6 +1342,10 @@ static void continue_fetching_send_locked(grpc_chttp2_transport* t,
       abort(); /* TODO(ctiller): what cleanup here? */
     }
     if (s->fetched_send_message_length == s->fetching_send_message->length()) {
+      // Empty messages have no slice to carry the prefix.
+      if (s->send_message_prefix_pending) {
+        add_send_message_prefix_locked(s, nullptr);
+      }
       int64_t notify_offset = s->next_message_end_offset;
       if (notify_offset <= s->flow_controlled_bytes_written) {
         grpc_chttp2_complete_closure_step(
@@ -1374,7 +1435,21 @@ static void perform_stream_op_locked(void* stream_op,
   GRPC_STATS_INC_HTTP2_OP_BATCHES();
 
   s->context = op->payload->context;
-  s->traced = op->is_traced;
+  s->traced = op->is_traced || s->write_timestamps_sampled;
+  if (s->write_timestamps_sampled &&
+      (op->send_initial_metadata || op->send_message ||
+       op->send_trailing_metadata)) {
+    if (gpr_time_cmp(s->write_queued_time,
+                     gpr_inf_past(GPR_CLOCK_REALTIME)) == 0) {
+      s->write_queued_time = gpr_now(GPR_CLOCK_REALTIME);
+    }
+    if (op->payload->context != nullptr &&
+        s->write_latency_observer == nullptr) {
+      auto* observer = static_cast<grpc_core::WriteLatencyObserver*>(
+          op->payload->context[GRPC_CONTEXT_WRITE_LATENCY_OBSERVER].value);
+      if (observer != nullptr) s->write_latency_observer = observer->Ref();
+    }
+  }
   if (GRPC_TRACE_FLAG_ENABLED(grpc_http_trace)) {
     gpr_log(GPR_INFO, "perform_stream_op_locked: %s; on_complete = %p",
             grpc_transport_stream_op_batch_string(op).c_str(), op->on_complete);
@@ -1495,8 +1570,8 @@ static void perform_stream_op_locked(void* stream_op,
           "fetching_send_message_finished");
     } else {
       GPR_ASSERT(s->fetching_send_message == nullptr);
-      uint8_t* frame_hdr = grpc_slice_buffer_tiny_add(
-          &s->flow_controlled_buffer, GRPC_HEADER_SIZE_IN_BYTES);
+      uint8_t* frame_hdr = s->send_message_prefix;
+      s->send_message_prefix_pending = true;
       uint32_t flags = op_payload->send_message.send_message->flags();
       frame_hdr[0] = (flags & GRPC_WRITE_INTERNAL_COMPRESS) != 0;
       size_t len = op_payload->send_message.send_message->length();
@@ -1510,7 +1585,7 @@ static void perform_stream_op_locked(void* stream_op,
       s->next_message_end_offset =
           s->flow_controlled_bytes_written +
           static_cast<int64_t>(s->flow_controlled_buffer.length) +
-          static_cast<int64_t>(len);
+          GRPC_HEADER_SIZE_IN_BYTES + static_cast<int64_t>(len);
       if (flags & GRPC_WRITE_BUFFER_HINT) {
         s->next_message_end_offset -= t->write_buffer_size;
         s->write_buffering = true;
@@ -2184,6 +2259,7 @@ void grpc_chttp2_fail_pending_writes(grpc_chttp2_transport* t,
                                     "send_trailing_metadata_finished");
 
   s->fetching_send_message.reset();
+  s->send_message_prefix_pending = false;
   grpc_chttp2_complete_closure_step(t, s, &s->fetching_send_message_finished,
                                     GRPC_ERROR_REF(error),
                                     "fetching_send_message_finished");
@@ -2509,6 +2585,9 @@ static void read_action_locked(void* tp, grpc_error_handle error) {
   GPR_TIMER_SCOPE("reading_action_locked", 0);
 
   grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(tp);
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    grpc_core::LatencyTracer::AsyncEnd("chttp2.endpoint_read", t);
+  }
 
   GRPC_ERROR_REF(error);
 
@@ -2599,6 +2678,9 @@ static void continue_read_action_locked(grpc_chttp2_transport* t) {
   const bool urgent = t->goaway_error != GRPC_ERROR_NONE;
   GRPC_CLOSURE_INIT(&t->read_action_locked, read_action, t,
                     grpc_schedule_on_exec_ctx);
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    grpc_core::LatencyTracer::AsyncBegin("chttp2.endpoint_read", t);
+  }
   grpc_endpoint_read(t->ep, &t->read_buffer, &t->read_action_locked, urgent);
   grpc_chttp2_act_on_flowctl_action(t->flow_control->MakeAction(), t, nullptr);
 }
@@ -24,27 +24,76 @@ namespace {
 void (*write_timestamps_callback_g)(void*, grpc_core::Timestamps*,
                                     grpc_error_handle error) = nullptr;
 void* (*get_copied_context_fn_g)(void*) = nullptr;
+
+/* Returns the nanoseconds from \a start to \a end, or -1 if either was not
+ * reported. */
+int64_t NanosBetween(gpr_timespec start, gpr_timespec end) {
+  const gpr_timespec never = gpr_inf_past(GPR_CLOCK_REALTIME);
+  if (gpr_time_cmp(start, never) == 0 || gpr_time_cmp(end, never) == 0) {
+    return -1;
+  }
+  gpr_timespec elapsed = gpr_time_sub(end, start);
+  /* The kernel's clock and ours may disagree by a little. */
+  if (elapsed.tv_sec < 0) return 0;
+  return elapsed.tv_sec * GPR_NS_PER_SEC + elapsed.tv_nsec;
+}
 }  // namespace
 
 namespace grpc_core {
 void ContextList::Append(ContextList** head, grpc_chttp2_stream* s) {
-  if (get_copied_context_fn_g == nullptr ||
-      write_timestamps_callback_g == nullptr) {
+  const bool hooked = get_copied_context_fn_g != nullptr &&
+                      write_timestamps_callback_g != nullptr;
+  if (!hooked && !s->write_timestamps_sampled) {
     return;
   }
   /* Create a new element in the list and add it at the front */
   ContextList* elem = new ContextList();
-  elem->trace_context_ = get_copied_context_fn_g(s->context);
+  if (hooked) {
+    elem->trace_context_ = get_copied_context_fn_g(s->context);
+  }
   elem->byte_offset_ = s->byte_counter;
+  if (s->write_timestamps_sampled) {
+    elem->write_timestamps_sampled_ = true;
+    elem->is_client_ = s->t->is_client;
+    elem->last_write_done_time_ = s->last_write_done_time;
+    elem->write_queued_time_ = s->write_queued_time;
+    elem->write_latency_observer_ = s->write_latency_observer;
+    s->write_queued_time = gpr_inf_past(GPR_CLOCK_REALTIME);
+  }
   elem->next_ = *head;
   *head = elem;
 }
 
+WriteLatency ContextList::ComputeLatency(
+    const grpc_core::Timestamps& ts) const {
+  WriteLatency latency;
+  latency.stage_ns[WriteLatency::kApp] =
+      NanosBetween(last_write_done_time_, write_queued_time_);
+  latency.stage_ns[WriteLatency::kWriteQueue] =
+      NanosBetween(write_queued_time_, ts.sendmsg_time.time);
+  latency.stage_ns[WriteLatency::kKernel] =
+      NanosBetween(ts.sendmsg_time.time, ts.scheduled_time.time);
+  latency.stage_ns[WriteLatency::kQdisc] =
+      NanosBetween(ts.scheduled_time.time, ts.sent_time.time);
+  latency.stage_ns[WriteLatency::kNetwork] =
+      NanosBetween(ts.sent_time.time, ts.acked_time.time);
+  latency.byte_offset = static_cast<uint32_t>(byte_offset_);
+  latency.is_client = is_client_;
+  return latency;
+}
+
 void ContextList::Execute(void* arg, grpc_core::Timestamps* ts,
                           grpc_error_handle error) {
   ContextList* head = static_cast<ContextList*>(arg);
   ContextList* to_be_freed;
   while (head != nullptr) {
+    if (head->write_timestamps_sampled_ && ts != nullptr) {
+      WriteLatency latency = head->ComputeLatency(*ts);
+      WriteLatencyStats::Record(latency);
+      if (head->write_latency_observer_ != nullptr) {
+        head->write_latency_observer_->OnWriteLatency(latency);
+      }
+    }
     if (write_timestamps_callback_g) {
       if (ts) {
         ts->byte_offset = static_cast<uint32_t>(head->byte_offset_);
@@ -32,16 +32,25 @@ class ContextList {
    * list. */
   static void Append(ContextList** head, grpc_chttp2_stream* s);
 
-  /* Executes a function \a fn with each context in the list and \a ts. It also
-   * frees up the entire list after this operation. It is intended as a callback
-   * and hence does not take a ref on \a error */
+  /* Executes a function \a fn with each context in the list and \a ts, and
+   * reports the write latency of the streams sampled for it. It also frees up
+   * the entire list after this operation. It is intended as a callback and
+   * hence does not take a ref on \a error */
   static void Execute(void* arg, grpc_core::Timestamps* ts,
                       grpc_error_handle error);
 
  private:
+  /* Breaks the latency of the write down from \a ts. */
+  WriteLatency ComputeLatency(const grpc_core::Timestamps& ts) const;
+
   void* trace_context_ = nullptr;
   ContextList* next_ = nullptr;
   size_t byte_offset_ = 0;
+  bool write_timestamps_sampled_ = false;
+  bool is_client_ = false;
+  gpr_timespec last_write_done_time_;
+  gpr_timespec write_queued_time_;
+  RefCountedPtr<WriteLatencyObserver> write_latency_observer_;
 };
 
 void grpc_http2_set_write_timestamps_callback(
@@ -28,8 +28,10 @@
 #include <grpc/support/log.h>
 
 #include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/memory.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/transport/transport.h"
@@ -70,9 +72,14 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   uint8_t* p;
   static const size_t header_size = 9;
 
-  hdr = GRPC_SLICE_MALLOC(header_size);
-  p = GRPC_SLICE_START_PTR(hdr);
   GPR_ASSERT(write_bytes < (1 << 24));
+  // When the frame is the start of a slice with headroom, write the header in
+  // the headroom and send header and payload as one slice.
+  bool in_place =
+      write_bytes > 0 && write_bytes <= GRPC_SLICE_LENGTH(inbuf->slices[0]) &&
+      grpc_core::ClaimSliceHeadroom(inbuf->slices[0], header_size, &hdr);
+  if (!in_place) hdr = GRPC_SLICE_MALLOC(header_size);
+  p = GRPC_SLICE_START_PTR(hdr);
   *p++ = static_cast<uint8_t>(write_bytes >> 16);
   *p++ = static_cast<uint8_t>(write_bytes >> 8);
   *p++ = static_cast<uint8_t>(write_bytes);
@@ -82,9 +89,24 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   *p++ = static_cast<uint8_t>(id >> 16);
   *p++ = static_cast<uint8_t>(id >> 8);
   *p++ = static_cast<uint8_t>(id);
-  grpc_slice_buffer_add(outbuf, hdr);
+  GRPC_USDT4(frame_write, id, GRPC_CHTTP2_FRAME_DATA, write_bytes,
+             is_eof ? GRPC_CHTTP2_DATA_FLAG_END_STREAM : 0);
 
-  grpc_slice_buffer_move_first_no_ref(inbuf, write_bytes, outbuf);
+  if (in_place) {
+    GRPC_STATS_INC_HTTP2_DATA_FRAMES_IN_PLACE();
+    hdr.data.refcounted.length = header_size + write_bytes;
+    grpc_slice_buffer_add(outbuf, hdr);
+    if (write_bytes == GRPC_SLICE_LENGTH(inbuf->slices[0])) {
+      grpc_slice_buffer_remove_first(inbuf);
+    } else {
+      grpc_slice_buffer_sub_first(inbuf, write_bytes,
+                                  GRPC_SLICE_LENGTH(inbuf->slices[0]));
+    }
+  } else {
+    if (write_bytes > 0) GRPC_STATS_INC_HTTP2_DATA_FRAMES_RESLICED();
+    grpc_slice_buffer_add(outbuf, hdr);
+    grpc_slice_buffer_move_first_no_ref(inbuf, write_bytes, outbuf);
+  }
 
   stats->framing_bytes += header_size;
   stats->data_bytes += write_bytes;
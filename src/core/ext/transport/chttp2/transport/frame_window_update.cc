@@ -27,6 +27,7 @@
 #include <grpc/support/log.h>
 
 #include "src/core/ext/transport/chttp2/transport/internal.h"
+#include "src/core/lib/profiling/usdt.h"
 
 grpc_slice grpc_chttp2_window_update_create(
     uint32_t id, uint32_t window_delta, grpc_transport_one_way_stats* stats) {
@@ -36,6 +37,7 @@ grpc_slice grpc_chttp2_window_update_create(
   uint8_t* p = GRPC_SLICE_START_PTR(slice);
 
   GPR_ASSERT(window_delta);
+  GRPC_USDT4(frame_write, id, GRPC_CHTTP2_FRAME_WINDOW_UPDATE, 4, 0);
 
   *p++ = 0;
   *p++ = 0;
@@ -92,6 +94,8 @@ grpc_error_handle grpc_chttp2_window_update_parser_parse(
           absl::StrCat("invalid window update bytes: ", p->amount));
     }
     GPR_ASSERT(is_last);
+    GRPC_USDT4(flow_control_window_update, t, t->incoming_stream_id,
+               received_update, false);
 
     if (t->incoming_stream_id != 0) {
       if (s != nullptr) {
@@ -34,6 +34,7 @@
 #include "src/core/ext/transport/chttp2/transport/hpack_utils.h"
 #include "src/core/ext/transport/chttp2/transport/varint.h"
 #include "src/core/lib/debug/stats.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/surface/validate_metadata.h"
@@ -109,6 +110,7 @@ void HPackCompressor::Framer::FinishFrame(bool is_header_boundary) {
   }
   FillHeader(GRPC_SLICE_START_PTR(output_->slices[prefix_.header_idx]), type,
              stream_id_, CurrentFrameSize(), flags);
+  GRPC_USDT4(frame_write, stream_id_, type, CurrentFrameSize(), flags);
   stats_->framing_bytes += kDataFrameHeaderSize;
   is_first_frame_ = false;
 }
@@ -44,11 +44,14 @@
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/transport/transport_impl.h"
+#include "src/core/lib/transport/write_latency.h"
 
 namespace grpc_core {
 class ContextList;
 }
 
+#define GRPC_HEADER_SIZE_IN_BYTES 5
+
 /* streams are kept in various linked lists depending on what things need to
    happen to them... this enum labels each list */
 typedef enum {
@@ -356,6 +359,11 @@ struct grpc_chttp2_transport {
    */
   uint32_t write_buffer_size = grpc_core::chttp2::kDefaultWindow;
 
+  /** the writes of one in this many streams are timestamped, if non-zero:
+   * see GRPC_ARG_HTTP2_WRITE_TIMESTAMPS_SAMPLING_PERIOD */
+  uint32_t write_timestamps_sampling_period = 0;
+  uint32_t write_timestamps_countdown = 0;
+
   /** Set to a grpc_error object if a goaway frame is received. By default, set
    * to GRPC_ERROR_NONE */
   grpc_error_handle goaway_error = GRPC_ERROR_NONE;
@@ -546,6 +554,10 @@ struct grpc_chttp2_stream {
   grpc_core::OrphanablePtr<grpc_core::ByteStream> fetching_send_message;
   uint32_t fetched_send_message_length = 0;
   grpc_slice fetching_slice = grpc_empty_slice();
+  /** The prefix of fetching_send_message, added to flow_controlled_buffer
+      along with its first slice so that it can go in the slice's headroom */
+  uint8_t send_message_prefix[GRPC_HEADER_SIZE_IN_BYTES];
+  bool send_message_prefix_pending = false;
   int64_t next_message_end_offset;
   int64_t flow_controlled_bytes_written = 0;
   int64_t flow_controlled_bytes_flowed = 0;
@@ -651,6 +663,17 @@ struct grpc_chttp2_stream {
   bool unprocessed_incoming_frames_decompressed = false;
   /** Whether the bytes needs to be traced using Fathom */
   bool traced = false;
+  /** Whether the stream was sampled for the write latency breakdown, which
+   * traces its bytes too */
+  bool write_timestamps_sampled = false;
+  /** When the previous write of the stream was done (its creation, before the
+   * first write) and when the transport got the oldest write not written
+   * yet, in realtime: only kept for sampled streams */
+  gpr_timespec last_write_done_time;
+  gpr_timespec write_queued_time;
+  /** The call's observer of the breakdowns, if it has one */
+  grpc_core::RefCountedPtr<grpc_core::WriteLatencyObserver>
+      write_latency_observer;
   /** gRPC header bytes that are already decompressed */
   size_t decompressed_header_bytes = 0;
   /** Byte counter for number of bytes written */
@@ -776,7 +799,6 @@ void grpc_chttp2_complete_closure_step(grpc_chttp2_transport* t,
                                        grpc_error_handle error,
                                        const char* desc);
 
-#define GRPC_HEADER_SIZE_IN_BYTES 5
 #define MAX_SIZE_T (~(size_t)0)
 
 #define GRPC_CHTTP2_CLIENT_CONNECT_STRING "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
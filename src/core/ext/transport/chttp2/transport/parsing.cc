@@ -28,6 +28,7 @@
 
 #include "src/core/ext/transport/chttp2/transport/internal.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/slice/slice_utils.h"
 #include "src/core/lib/transport/http2_errors.h"
@@ -176,6 +177,8 @@ grpc_error_handle grpc_chttp2_perform_read(grpc_chttp2_transport* t,
       GPR_DEBUG_ASSERT(cur < end);
       t->incoming_stream_id |= (static_cast<uint32_t>(*cur));
       t->deframe_state = GRPC_DTS_FRAME;
+      GRPC_USDT5(frame_read, t, t->incoming_stream_id, t->incoming_frame_type,
+                 t->incoming_frame_size, t->incoming_frame_flags);
       err = init_frame_parser(t);
       if (err != GRPC_ERROR_NONE) {
         return err;
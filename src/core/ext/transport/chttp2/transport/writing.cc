@@ -28,6 +28,7 @@
 #include "src/core/lib/compression/stream_compression.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/transport/http2_errors.h"
 
@@ -158,6 +159,7 @@ static bool update_list(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
 
 static void report_stall(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
                          const char* staller) {
+  GRPC_USDT3(flow_control_stall, t, s->id, staller);
   if (GRPC_TRACE_FLAG_ENABLED(grpc_flowctl_trace)) {
     gpr_log(
         GPR_DEBUG,
@@ -246,6 +248,7 @@ class WriteContext {
       grpc_slice_buffer_add(
           &t_->outbuf, grpc_chttp2_window_update_create(0, transport_announce,
                                                         &throwaway_stats));
+      GRPC_USDT4(flow_control_window_update, t_, 0, transport_announce, true);
       grpc_chttp2_reset_ping_clock(t_);
     }
   }
@@ -340,9 +343,26 @@ class DataSendContext {
 
   bool AnyOutgoing() const { return max_outgoing() > 0; }
 
+  // Returns the size of the next frame of flow_controlled_buffer. Frames end
+  // where a slice with headroom starts, so that the next frame can start with
+  // it and have its header written in place by grpc_chttp2_encode_data.
+  uint32_t NextFrameLength() const {
+    static const size_t frame_header_size = 9;
+    const grpc_slice_buffer& buffer = s_->flow_controlled_buffer;
+    size_t length = max_outgoing();
+    size_t offset = 0;
+    for (size_t i = 0; i < buffer.count && offset < length; i++) {
+      if (offset > 0 &&
+          grpc_core::SliceHeadroom(buffer.slices[i]) >= frame_header_size) {
+        return static_cast<uint32_t>(offset);
+      }
+      offset += GRPC_SLICE_LENGTH(buffer.slices[i]);
+    }
+    return static_cast<uint32_t> GPR_MIN(length, offset);
+  }
+
   void FlushUncompressedBytes() {
-    uint32_t send_bytes = static_cast<uint32_t> GPR_MIN(
-        max_outgoing(), s_->flow_controlled_buffer.length);
+    uint32_t send_bytes = NextFrameLength();
     is_last_frame_ = send_bytes == s_->flow_controlled_buffer.length &&
                      s_->fetching_send_message == nullptr &&
                      s_->send_trailing_metadata != nullptr &&
@@ -497,6 +517,7 @@ class StreamWriteContext {
     grpc_slice_buffer_add(
         &t_->outbuf, grpc_chttp2_window_update_create(s_->id, stream_announce,
                                                       &s_->stats.outgoing));
+    GRPC_USDT4(flow_control_window_update, t_, s_->id, stream_announce, true);
     grpc_chttp2_reset_ping_clock(t_);
     write_context_->IncWindowUpdateWrites();
   }
@@ -700,6 +721,10 @@ void grpc_chttp2_end_write(grpc_chttp2_transport* t, grpc_error_handle error) {
   t->num_messages_in_next_write = 0;
 
   while (grpc_chttp2_list_pop_writing_stream(t, &s)) {
+    if (s->write_timestamps_sampled) {
+      /* The time to the next write is spent above the transport. */
+      s->last_write_done_time = gpr_now(GPR_CLOCK_REALTIME);
+    }
     if (s->sending_bytes != 0) {
       update_list(t, s, static_cast<int64_t>(s->sending_bytes),
                   &s->on_write_finished_cbs, &s->flow_controlled_bytes_written,
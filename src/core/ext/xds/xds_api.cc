@@ -26,6 +26,7 @@
 #include <cstdlib>
 #include <string>
 
+#include "absl/random/random.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -34,6 +35,7 @@
 #include "envoy/config/cluster/v3/circuit_breaker.upb.h"
 #include "envoy/config/cluster/v3/cluster.upb.h"
 #include "envoy/config/cluster/v3/cluster.upbdefs.h"
+#include "envoy/config/cluster/v3/outlier_detection.upb.h"
 #include "envoy/config/core/v3/address.upb.h"
 #include "envoy/config/core/v3/base.upb.h"
 #include "envoy/config/core/v3/base.upbdefs.h"
@@ -116,6 +118,15 @@ bool XdsAggregateAndLogicalDnsClusterEnabled() {
   return parse_succeeded && parsed_value;
 }
 
+// Whether the outlier_detection field of CDS clusters is honored.
+bool XdsOutlierDetectionEnabled() {
+  char* value = gpr_getenv("GRPC_EXPERIMENTAL_ENABLE_OUTLIER_DETECTION");
+  bool parsed_value;
+  bool parse_succeeded = gpr_parse_bool_value(value, &parsed_value);
+  gpr_free(value);
+  return parse_succeeded && parsed_value;
+}
+
 //
 // XdsApi::Route::HashPolicy
 //
@@ -709,6 +720,10 @@ std::string XdsApi::CdsUpdate::ToString() const {
   }
   contents.push_back(
       absl::StrFormat("max_concurrent_requests=%d", max_concurrent_requests));
+  if (outlier_detection.has_value()) {
+    contents.push_back(absl::StrCat("outlier_detection=",
+                                    Json(*outlier_detection).Dump()));
+  }
   return absl::StrCat("{", absl::StrJoin(contents, ", "), "}");
 }
 
@@ -749,10 +764,13 @@ std::string XdsApi::EdsUpdate::Priority::ToString() const {
 
 bool XdsApi::EdsUpdate::DropConfig::ShouldDrop(
     const std::string** category_name) const {
+  // Picks call this concurrently. Seeding a generator per call would lock
+  // absl's entropy pool, so each thread keeps its own.
+  static thread_local absl::BitGen bit_gen;
   for (size_t i = 0; i < drop_category_list_.size(); ++i) {
     const auto& drop_category = drop_category_list_[i];
     // Generate a random number in [0, 1000000).
-    const uint32_t random = static_cast<uint32_t>(rand()) % 1000000;
+    const uint32_t random = absl::Uniform<uint32_t>(bit_gen, 0, 1000000);
     if (random < drop_category.parts_per_million) {
       *category_name = &drop_category.name;
       return true;
@@ -2964,6 +2982,119 @@ grpc_error_handle CdsLogicalDnsParse(
   return GRPC_ERROR_NONE;
 }
 
+// Converts the outlier_detection field of a Cluster to the config of the
+// outlier_detection_experimental LB policy.
+grpc_error_handle OutlierDetectionParse(
+    const envoy_config_cluster_v3_OutlierDetection* outlier_detection,
+    Json::Object* config) {
+  std::vector<grpc_error_handle> errors;
+  auto parse_duration = [&](const char* field,
+                            const google_protobuf_Duration* proto_duration) {
+    if (proto_duration == nullptr) return;
+    XdsApi::Duration duration = DurationParse(proto_duration);
+    if (duration.seconds < 0 || duration.nanos < 0) {
+      errors.push_back(GRPC_ERROR_CREATE_FROM_COPIED_STRING(
+          absl::StrCat(field, " must not be negative").c_str()));
+      return;
+    }
+    (*config)[field] =
+        absl::StrFormat("%d.%09ds", duration.seconds, duration.nanos);
+  };
+  // Returns the value of a percentage field, or default_value if unset.
+  auto parse_percentage = [&](const char* field,
+                              const google_protobuf_UInt32Value* value,
+                              uint32_t default_value) {
+    if (value == nullptr) return default_value;
+    uint32_t percentage = google_protobuf_UInt32Value_value(value);
+    if (percentage > 100) {
+      errors.push_back(GRPC_ERROR_CREATE_FROM_COPIED_STRING(
+          absl::StrCat(field, " must be <= 100").c_str()));
+    }
+    return percentage;
+  };
+  parse_duration("interval",
+                 envoy_config_cluster_v3_OutlierDetection_interval(
+                     outlier_detection));
+  parse_duration("baseEjectionTime",
+                 envoy_config_cluster_v3_OutlierDetection_base_ejection_time(
+                     outlier_detection));
+  parse_duration("maxEjectionTime",
+                 envoy_config_cluster_v3_OutlierDetection_max_ejection_time(
+                     outlier_detection));
+  (*config)["maxEjectionPercent"] = parse_percentage(
+      "max_ejection_percent",
+      envoy_config_cluster_v3_OutlierDetection_max_ejection_percent(
+          outlier_detection),
+      10);
+  // Each ejection algorithm is disabled when its enforcement percentage is 0.
+  uint32_t enforcing_success_rate = parse_percentage(
+      "enforcing_success_rate",
+      envoy_config_cluster_v3_OutlierDetection_enforcing_success_rate(
+          outlier_detection),
+      100);
+  if (enforcing_success_rate != 0) {
+    Json::Object success_rate_ejection = {
+        {"enforcementPercentage", enforcing_success_rate},
+    };
+    const google_protobuf_UInt32Value* value =
+        envoy_config_cluster_v3_OutlierDetection_success_rate_stdev_factor(
+            outlier_detection);
+    if (value != nullptr) {
+      success_rate_ejection["stdevFactor"] =
+          google_protobuf_UInt32Value_value(value);
+    }
+    value = envoy_config_cluster_v3_OutlierDetection_success_rate_minimum_hosts(
+        outlier_detection);
+    if (value != nullptr) {
+      success_rate_ejection["minimumHosts"] =
+          google_protobuf_UInt32Value_value(value);
+    }
+    value =
+        envoy_config_cluster_v3_OutlierDetection_success_rate_request_volume(
+            outlier_detection);
+    if (value != nullptr) {
+      success_rate_ejection["requestVolume"] =
+          google_protobuf_UInt32Value_value(value);
+    }
+    (*config)["successRateEjection"] = std::move(success_rate_ejection);
+  }
+  uint32_t enforcing_failure_percentage = parse_percentage(
+      "enforcing_failure_percentage",
+      envoy_config_cluster_v3_OutlierDetection_enforcing_failure_percentage(
+          outlier_detection),
+      0);
+  if (enforcing_failure_percentage != 0) {
+    Json::Object failure_percentage_ejection = {
+        {"enforcementPercentage", enforcing_failure_percentage},
+    };
+    const google_protobuf_UInt32Value* value =
+        envoy_config_cluster_v3_OutlierDetection_failure_percentage_threshold(
+            outlier_detection);
+    if (value != nullptr) {
+      failure_percentage_ejection["threshold"] = parse_percentage(
+          "failure_percentage_threshold", value, 85);
+    }
+    value =
+        envoy_config_cluster_v3_OutlierDetection_failure_percentage_minimum_hosts(
+            outlier_detection);
+    if (value != nullptr) {
+      failure_percentage_ejection["minimumHosts"] =
+          google_protobuf_UInt32Value_value(value);
+    }
+    value =
+        envoy_config_cluster_v3_OutlierDetection_failure_percentage_request_volume(
+            outlier_detection);
+    if (value != nullptr) {
+      failure_percentage_ejection["requestVolume"] =
+          google_protobuf_UInt32Value_value(value);
+    }
+    (*config)["failurePercentageEjection"] =
+        std::move(failure_percentage_ejection);
+  }
+  return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing outlier_detection",
+                                       &errors);
+}
+
 grpc_error_handle CdsResourceParse(
     const EncodingContext& context,
     const envoy_config_cluster_v3_Cluster* cluster, bool /*is_v2*/,
@@ -3144,6 +3275,17 @@ grpc_error_handle CdsResourceParse(
       }
     }
   }
+  // Record outlier detection config, if any.
+  if (XdsOutlierDetectionEnabled()) {
+    const envoy_config_cluster_v3_OutlierDetection* outlier_detection =
+        envoy_config_cluster_v3_Cluster_outlier_detection(cluster);
+    if (outlier_detection != nullptr) {
+      cds_update->outlier_detection.emplace();
+      grpc_error_handle error = OutlierDetectionParse(
+          outlier_detection, &*cds_update->outlier_detection);
+      if (error != GRPC_ERROR_NONE) errors.push_back(error);
+    }
+  }
   return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing CDS resource", &errors);
 }
 
@@ -38,6 +38,7 @@
 #include "src/core/ext/xds/xds_client_stats.h"
 #include "src/core/ext/xds/xds_http_filters.h"
 #include "src/core/lib/channel/status_util.h"
+#include "src/core/lib/json/json.h"
 #include "src/core/lib/matchers/matchers.h"
 
 namespace grpc_core {
@@ -433,6 +434,10 @@ class XdsApi {
     // cluster.
     uint32_t max_concurrent_requests = 1024;
 
+    // The config of the outlier_detection_experimental LB policy, without
+    // its childPolicy field.  Not set if outlier detection is disabled.
+    absl::optional<Json::Object> outlier_detection;
+
     bool operator==(const CdsUpdate& other) const {
       return cluster_type == other.cluster_type &&
              eds_service_name == other.eds_service_name &&
@@ -444,7 +449,8 @@ class XdsApi {
              lb_policy == other.lb_policy &&
              min_ring_size == other.min_ring_size &&
              max_ring_size == other.max_ring_size &&
-             max_concurrent_requests == other.max_concurrent_requests;
+             max_concurrent_requests == other.max_concurrent_requests &&
+             outlier_detection == other.outlier_detection;
     }
 
     std::string ToString() const;
@@ -26,6 +26,7 @@
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/transport/byte_stream.h"
 #include "src/core/lib/transport/metadata_batch.h"
+#include "src/core/lib/transport/write_latency.h"
 
 namespace grpc_core {
 
@@ -63,6 +64,12 @@ class CallTracer {
         absl::Status status, grpc_metadata_batch* recv_trailing_metadata,
         const grpc_transport_stream_stats& transport_stream_stats) = 0;
     virtual void RecordCancel(grpc_error_handle cancel_error) = 0;
+    // Records where the time to put one of the attempt's writes on the wire
+    // went, for attempts on a transport that samples write timestamps. May be
+    // invoked from any thread, concurrently with the other methods, but never
+    // after RecordEnd(): writes acknowledged by the peer later only count in
+    // the WriteLatencyStats.
+    virtual void RecordWriteLatency(const WriteLatency& /*latency*/) {}
     // Should be the last API call to the object. Once invoked, the tracer
     // library is free to destroy the object.
     virtual void RecordEnd(const gpr_timespec& latency) = 0;
@@ -280,6 +280,11 @@ void ServerNode::RemoveChildListenSocket(intptr_t child_uuid) {
   child_listen_sockets_.erase(child_uuid);
 }
 
+void ServerNode::AddMethodStats(RefCountedPtr<MethodStats> stats) {
+  MutexLock lock(&child_mu_);
+  method_stats_.push_back(std::move(stats));
+}
+
 std::string ServerNode::RenderServerSockets(intptr_t start_socket_id,
                                             intptr_t max_results) {
   GPR_ASSERT(start_socket_id >= 0);
@@ -337,6 +342,16 @@ Json ServerNode::RenderJson() {
       }
       object["listenSocket"] = std::move(array);
     }
+    if (!method_stats_.empty()) {
+      Json::Array array;
+      for (const auto& stats : method_stats_) {
+        array.emplace_back(stats->RenderJson());
+      }
+      object["methodStats"] = std::move(array);
+    }
+  }
+  if (concurrency_limiter_ != nullptr) {
+    object["concurrencyLimiter"] = concurrency_limiter_->RenderJson();
   }
   return object;
 }
@@ -24,6 +24,7 @@
 #include <atomic>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
@@ -31,6 +32,8 @@
 #include <grpc/grpc.h>
 
 #include "src/core/lib/channel/channel_trace.h"
+#include "src/core/lib/channel/concurrency_limiter.h"
+#include "src/core/lib/debug/method_stats.h"
 #include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/gprpp/ref_counted.h"
@@ -247,6 +250,14 @@ class ServerNode : public BaseNode {
 
   void RemoveChildListenSocket(intptr_t child_uuid);
 
+  // Reports the stats of a registered method.
+  void AddMethodStats(RefCountedPtr<MethodStats> stats);
+
+  // Reports the limiter of GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY.
+  void SetConcurrencyLimiter(RefCountedPtr<ConcurrencyLimiter> limiter) {
+    concurrency_limiter_ = std::move(limiter);
+  }
+
   // proxy methods to composed classes.
   void AddTraceEvent(ChannelTrace::Severity severity, const grpc_slice& data) {
     trace_.AddTraceEvent(severity, data);
@@ -264,9 +275,12 @@ class ServerNode : public BaseNode {
  private:
   CallCountingHelper call_counter_;
   ChannelTrace trace_;
-  Mutex child_mu_;  // Guards child maps below.
+  Mutex child_mu_;  // Guards child maps and method stats below.
   std::map<intptr_t, RefCountedPtr<SocketNode>> child_sockets_;
   std::map<intptr_t, RefCountedPtr<ListenSocketNode>> child_listen_sockets_;
+  std::vector<RefCountedPtr<MethodStats>> method_stats_;
+  // Set before the server starts.
+  RefCountedPtr<ConcurrencyLimiter> concurrency_limiter_;
 };
 
 #define GRPC_ARG_CHANNELZ_SECURITY "grpc.internal.channelz_security"
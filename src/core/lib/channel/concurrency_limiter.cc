@@ -0,0 +1,186 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/channel/concurrency_limiter.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "src/core/lib/channel/channel_args.h"
+
+namespace grpc_core {
+
+namespace {
+
+void* ConcurrencyLimiterArgCopy(void* p) {
+  static_cast<ConcurrencyLimiter*>(p)->Ref().release();
+  return p;
+}
+
+void ConcurrencyLimiterArgDestroy(void* p) {
+  static_cast<ConcurrencyLimiter*>(p)->Unref();
+}
+
+int ConcurrencyLimiterArgCmp(void* a, void* b) { return GPR_ICMP(a, b); }
+
+const grpc_arg_pointer_vtable kConcurrencyLimiterArgVtable = {
+    ConcurrencyLimiterArgCopy, ConcurrencyLimiterArgDestroy,
+    ConcurrencyLimiterArgCmp};
+
+int64_t NanosSince(gpr_cycle_counter start, gpr_cycle_counter now) {
+  gpr_timespec elapsed = gpr_cycle_counter_sub(now, start);
+  return elapsed.tv_sec * GPR_NS_PER_SEC + elapsed.tv_nsec;
+}
+
+ConcurrencyLimiter::Options OptionsFromLimitArgs(const grpc_channel_args* args,
+                                                 const char* initial_limit_arg,
+                                                 const char* min_limit_arg,
+                                                 const char* max_limit_arg) {
+  ConcurrencyLimiter::Options options;
+  options.max_limit = grpc_channel_args_find_integer(
+      args, max_limit_arg, {options.max_limit, 1, INT_MAX});
+  options.min_limit = grpc_channel_args_find_integer(
+      args, min_limit_arg, {options.min_limit, 1, options.max_limit});
+  options.initial_limit = grpc_channel_args_find_integer(
+      args, initial_limit_arg,
+      {std::min(std::max(options.initial_limit, options.min_limit),
+                options.max_limit),
+       options.min_limit, options.max_limit});
+  return options;
+}
+
+}  // namespace
+
+ConcurrencyLimiter::Options ConcurrencyLimiter::ServerOptionsFromChannelArgs(
+    const grpc_channel_args* args) {
+  return OptionsFromLimitArgs(args, GRPC_ARG_SERVER_CONCURRENCY_INITIAL_LIMIT,
+                              GRPC_ARG_SERVER_CONCURRENCY_MIN_LIMIT,
+                              GRPC_ARG_SERVER_CONCURRENCY_MAX_LIMIT);
+}
+
+ConcurrencyLimiter::Options ConcurrencyLimiter::ClientOptionsFromChannelArgs(
+    const grpc_channel_args* args) {
+  return OptionsFromLimitArgs(args, GRPC_ARG_CLIENT_CONCURRENCY_INITIAL_LIMIT,
+                              GRPC_ARG_CLIENT_CONCURRENCY_MIN_LIMIT,
+                              GRPC_ARG_CLIENT_CONCURRENCY_MAX_LIMIT);
+}
+
+ConcurrencyLimiter* ConcurrencyLimiter::FromChannelArgs(
+    const grpc_channel_args* args) {
+  return grpc_channel_args_find_pointer<ConcurrencyLimiter>(
+      args, GRPC_ARG_CONCURRENCY_LIMITER);
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(const Options& options)
+    : options_(options),
+      limit_(options.initial_limit),
+      exact_limit_(options.initial_limit),
+      window_start_(gpr_get_cycle_counter()) {}
+
+grpc_arg ConcurrencyLimiter::MakeChannelArg() {
+  return grpc_channel_arg_pointer_create(
+      const_cast<char*>(GRPC_ARG_CONCURRENCY_LIMITER), this,
+      &kConcurrencyLimiterArgVtable);
+}
+
+bool ConcurrencyLimiter::TryAcquire() {
+  int in_flight = in_flight_.load(std::memory_order_relaxed);
+  do {
+    if (in_flight >= limit_.load(std::memory_order_relaxed)) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  } while (!in_flight_.compare_exchange_weak(in_flight, in_flight + 1,
+                                             std::memory_order_relaxed));
+  admitted_.fetch_add(1, std::memory_order_relaxed);
+  int max_in_flight = window_max_in_flight_.load(std::memory_order_relaxed);
+  while (in_flight + 1 > max_in_flight &&
+         !window_max_in_flight_.compare_exchange_weak(
+             max_in_flight, in_flight + 1, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+void ConcurrencyLimiter::Release(int64_t latency_ns) {
+  in_flight_.fetch_sub(1, std::memory_order_relaxed);
+  if (latency_ns < 0) return;
+  gpr_cycle_counter now = gpr_get_cycle_counter();
+  MutexLock lock(&mu_);
+  window_latency_sum_ns_ += latency_ns;
+  window_samples_++;
+  if (window_samples_ < options_.min_window_samples ||
+      NanosSince(window_start_, now) < options_.window_ns) {
+    return;
+  }
+  UpdateLimitLocked(window_latency_sum_ns_ / window_samples_,
+                    window_max_in_flight_.exchange(
+                        in_flight_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed));
+  window_start_ = now;
+  window_latency_sum_ns_ = 0;
+  window_samples_ = 0;
+}
+
+void ConcurrencyLimiter::UpdateLimitLocked(double window_latency_ns,
+                                           int window_max_in_flight) {
+  last_window_latency_ns_ = window_latency_ns;
+  if (long_term_latency_ns_ == 0) {
+    long_term_latency_ns_ = window_latency_ns;
+  } else {
+    long_term_latency_ns_ =
+        0.95 * long_term_latency_ns_ + 0.05 * window_latency_ns;
+    // Come back down quickly after the latency dropped (e.g. once a
+    // stretch of overload is over), rather than over many windows.
+    if (long_term_latency_ns_ > 2 * window_latency_ns) {
+      long_term_latency_ns_ = 0.9 * long_term_latency_ns_;
+    }
+  }
+  // Calls do not fill the limit: latency says nothing about a higher one.
+  if (window_max_in_flight * 2 < exact_limit_) return;
+  double gradient = std::max(
+      0.5, std::min(1.0, options_.latency_tolerance * long_term_latency_ns_ /
+                             window_latency_ns));
+  double queue_size = sqrt(exact_limit_);
+  double new_limit = exact_limit_ * gradient + queue_size;
+  new_limit = (1 - options_.smoothing) * exact_limit_ +
+              options_.smoothing * new_limit;
+  exact_limit_ = std::max<double>(
+      options_.min_limit, std::min<double>(options_.max_limit, new_limit));
+  limit_.store(static_cast<int>(exact_limit_), std::memory_order_relaxed);
+}
+
+Json ConcurrencyLimiter::RenderJson() {
+  Json::Object object = {
+      {"limit", limit()},
+      {"inFlight", in_flight()},
+      {"admitted",
+       std::to_string(admitted_.load(std::memory_order_relaxed))},
+      {"rejected", std::to_string(rejected())},
+  };
+  MutexLock lock(&mu_);
+  if (long_term_latency_ns_ > 0) {
+    object["longTermLatencyUs"] = long_term_latency_ns_ / 1000;
+    object["lastWindowLatencyUs"] = last_window_latency_ns_ / 1000;
+  }
+  return object;
+}
+
+}  // namespace grpc_core
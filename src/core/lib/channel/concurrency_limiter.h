@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_CHANNEL_CONCURRENCY_LIMITER_H
+#define GRPC_CORE_LIB_CHANNEL_CONCURRENCY_LIMITER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include <grpc/impl/codegen/grpc_types.h>
+
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/json/json.h"
+
+// Channel arg pointing to the ConcurrencyLimiter of a server or client channel,
+// set for GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY and
+// GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY.
+#define GRPC_ARG_CONCURRENCY_LIMITER "grpc.internal.concurrency_limiter"
+
+namespace grpc_core {
+
+// Bounds the number of calls in flight, with a limit adjusted
+// from the latency of the calls it admits (the gradient algorithm of Netflix's
+// concurrency-limits library):
+//
+// - The latency of the calls completed in a window (at least window_ns and
+//   min_window_samples calls) is averaged, and compared to a long-term
+//   average of those window latencies.
+// - The limit is scaled by the ratio of the long-term to the window latency
+//   (up to latency_tolerance times the long-term latency is tolerated), and a
+//   queue of sqrt(limit) calls is added, so that it grows while latency holds.
+// - The limit only grows while calls actually use at least half of it.
+//
+// Since the long-term average follows the latency, a sustained rise
+// eventually becomes the new baseline: this keeps the limit from collapsing
+// when the server gets slower for reasons that are not load.
+class ConcurrencyLimiter : public RefCounted<ConcurrencyLimiter> {
+ public:
+  struct Options {
+    int initial_limit = 20;
+    int min_limit = 1;
+    int max_limit = 1000;
+    double latency_tolerance = 1.5;
+    // The weight of a window's limit in the new limit.
+    double smoothing = 0.2;
+    int64_t window_ns = 100 * GPR_NS_PER_MS;
+    int min_window_samples = 10;
+  };
+
+  // Return the options set by the GRPC_ARG_SERVER_CONCURRENCY_* and
+  // GRPC_ARG_CLIENT_CONCURRENCY_* args.
+  static Options ServerOptionsFromChannelArgs(const grpc_channel_args* args);
+  static Options ClientOptionsFromChannelArgs(const grpc_channel_args* args);
+  // Returns the limiter in \a args, if any.
+  static ConcurrencyLimiter* FromChannelArgs(const grpc_channel_args* args);
+
+  explicit ConcurrencyLimiter(const Options& options);
+
+  // Returns an arg pointing to this limiter. Copies of the arg hold a ref.
+  grpc_arg MakeChannelArg();
+
+  // Admits a call if fewer than limit() calls are in flight.
+  bool TryAcquire();
+  // Ends an admitted call that took \a latency_ns to handle, or whose latency
+  // should not count (e.g. it was cancelled) if \a latency_ns is negative.
+  void Release(int64_t latency_ns);
+
+  int limit() const { return limit_.load(std::memory_order_relaxed); }
+  int in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+  uint64_t rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+  }
+
+  Json RenderJson();
+
+ private:
+  // Updates the limit from the window that just ended. Called under mu_.
+  void UpdateLimitLocked(double window_latency_ns, int window_max_in_flight);
+
+  const Options options_;
+  std::atomic<int> limit_;
+  std::atomic<int> in_flight_{0};
+  std::atomic<uint64_t> admitted_{0};
+  std::atomic<uint64_t> rejected_{0};
+
+  Mutex mu_;
+  // The fractional limit, of which limit_ is the rounded value.
+  double exact_limit_ ABSL_GUARDED_BY(mu_);
+  double long_term_latency_ns_ ABSL_GUARDED_BY(mu_) = 0;
+  double last_window_latency_ns_ ABSL_GUARDED_BY(mu_) = 0;
+  gpr_cycle_counter window_start_ ABSL_GUARDED_BY(mu_);
+  double window_latency_sum_ns_ ABSL_GUARDED_BY(mu_) = 0;
+  int window_samples_ ABSL_GUARDED_BY(mu_) = 0;
+  // The highest number of calls in flight seen in the current window. Updated
+  // without the lock when calls are admitted.
+  std::atomic<int> window_max_in_flight_{0};
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_CHANNEL_CONCURRENCY_LIMITER_H */
@@ -41,6 +41,10 @@ typedef enum {
   /// Holds a pointer to ServiceConfigCallData associated with this call.
   GRPC_CONTEXT_SERVICE_CONFIG_CALL_DATA,
 
+  /// Value is a WriteLatencyObserver, which the transport reports the
+  /// latencies of the call's sampled writes to.
+  GRPC_CONTEXT_WRITE_LATENCY_OBSERVER,
+
   GRPC_CONTEXT_COUNT
 } grpc_context_index;
 
@@ -0,0 +1,313 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/channel/shm_handshaker.h"
+
+#include "src/core/lib/iomgr/port.h"
+
+#if defined(GRPC_LINUX_SHM_ENDPOINT) && defined(GRPC_POSIX_SOCKET_TCP)
+
+#include <unistd.h>
+
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/match.h"
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/channel/handshaker.h"
+#include "src/core/lib/channel/handshaker_registry.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/endpoint_shm.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/resource_quota.h"
+#include "src/core/lib/iomgr/tcp_posix.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Takes the Unix domain socket away from the tcp endpoint, runs the
+// shared-memory handshake over it and replaces the endpoint with the
+// resulting shared-memory endpoint. The socket is closed afterwards. On the
+// server, a client that does not offer shared memory gets a new tcp endpoint
+// over the same socket instead.
+class ShmHandshaker : public Handshaker {
+ public:
+  ShmHandshaker(bool is_client, size_t ring_size,
+                grpc_pollset_set* interested_parties);
+  void Shutdown(grpc_error_handle why) override;
+  void DoHandshake(grpc_tcp_server_acceptor* acceptor,
+                   grpc_closure* on_handshake_done,
+                   HandshakerArgs* args) override;
+  const char* name() const override { return "shm"; }
+
+ private:
+  ~ShmHandshaker() override;
+  void CleanupArgsForFailureLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void HandshakeFailedLocked(grpc_error_handle error)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  static void OnFdReleased(void* arg, grpc_error_handle error);
+  static void OnShmHandshakeDone(void* arg, grpc_error_handle error);
+
+  const bool is_client_;
+  const size_t ring_size_;
+  grpc_pollset_set* interested_parties_;
+
+  Mutex mu_;
+
+  bool is_shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  // Read buffer to destroy after a shutdown.
+  grpc_slice_buffer* read_buffer_to_destroy_ ABSL_GUARDED_BY(mu_) = nullptr;
+
+  // State saved while performing the handshake.
+  HandshakerArgs* args_ = nullptr;
+  grpc_closure* on_handshake_done_ = nullptr;
+  std::string peer_string_;
+  int released_fd_ = -1;
+  grpc_fd* uds_fd_ ABSL_GUARDED_BY(mu_) = nullptr;
+  // The shared-memory endpoint, or the tcp endpoint of a plain client.
+  grpc_endpoint* endpoint_ = nullptr;
+  grpc_closure on_fd_released_;
+  grpc_closure on_shm_handshake_done_;
+};
+
+ShmHandshaker::ShmHandshaker(bool is_client, size_t ring_size,
+                             grpc_pollset_set* interested_parties)
+    : is_client_(is_client),
+      ring_size_(ring_size),
+      interested_parties_(interested_parties) {
+  GRPC_CLOSURE_INIT(&on_fd_released_, &ShmHandshaker::OnFdReleased, this,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&on_shm_handshake_done_,
+                    &ShmHandshaker::OnShmHandshakeDone, this,
+                    grpc_schedule_on_exec_ctx);
+}
+
+ShmHandshaker::~ShmHandshaker() {
+  if (read_buffer_to_destroy_ != nullptr) {
+    grpc_slice_buffer_destroy_internal(read_buffer_to_destroy_);
+    gpr_free(read_buffer_to_destroy_);
+  }
+}
+
+// Set args fields to nullptr, saving the read buffer for later destruction.
+// The endpoint is ours from the start of the handshake, so it is already
+// nullptr.
+void ShmHandshaker::CleanupArgsForFailureLocked() {
+  read_buffer_to_destroy_ = args_->read_buffer;
+  args_->read_buffer = nullptr;
+  grpc_channel_args_destroy(args_->args);
+  args_->args = nullptr;
+}
+
+void ShmHandshaker::HandshakeFailedLocked(grpc_error_handle error) {
+  if (error == GRPC_ERROR_NONE) {
+    error = GRPC_ERROR_CREATE_FROM_STATIC_STRING("Handshaker shutdown");
+  }
+  if (!is_shutdown_) {
+    CleanupArgsForFailureLocked();
+    is_shutdown_ = true;
+  }
+  ExecCtx::Run(DEBUG_LOCATION, on_handshake_done_, error);
+}
+
+// Callback invoked once the tcp endpoint let go of the socket.
+void ShmHandshaker::OnFdReleased(void* arg, grpc_error_handle error) {
+  auto* handshaker = static_cast<ShmHandshaker*>(arg);
+  ReleasableMutexLock lock(&handshaker->mu_);
+  if (error != GRPC_ERROR_NONE || handshaker->is_shutdown_) {
+    if (handshaker->released_fd_ >= 0) close(handshaker->released_fd_);
+    handshaker->HandshakeFailedLocked(GRPC_ERROR_REF(error));
+    lock.Release();
+    handshaker->Unref();
+    return;
+  }
+  // The shared-memory handshake callback inherits our ref to the handshaker.
+  handshaker->uds_fd_ =
+      grpc_fd_create(handshaker->released_fd_, "shm_handshaker", false);
+  grpc_pollset_set_add_fd(handshaker->interested_parties_,
+                          handshaker->uds_fd_);
+  if (handshaker->is_client_) {
+    grpc_shm_endpoint_connect(handshaker->uds_fd_, handshaker->ring_size_,
+                              handshaker->peer_string_.c_str(),
+                              &handshaker->endpoint_,
+                              &handshaker->on_shm_handshake_done_);
+  } else {
+    grpc_shm_endpoint_accept(handshaker->uds_fd_,
+                             handshaker->peer_string_.c_str(),
+                             &handshaker->endpoint_,
+                             &handshaker->on_shm_handshake_done_);
+  }
+}
+
+// Callback invoked when the shared-memory handshake finished.
+void ShmHandshaker::OnShmHandshakeDone(void* arg, grpc_error_handle error) {
+  auto* handshaker = static_cast<ShmHandshaker*>(arg);
+  ReleasableMutexLock lock(&handshaker->mu_);
+  grpc_pollset_set_del_fd(handshaker->interested_parties_,
+                          handshaker->uds_fd_);
+  if (error == GRPC_ERROR_NONE && !handshaker->is_shutdown_ &&
+      handshaker->endpoint_ == nullptr) {
+    // The client did not offer shared memory, and nothing was read from the
+    // socket: carry on over it with a tcp endpoint, as if we never ran.
+    grpc_resource_quota* resource_quota =
+        grpc_resource_quota_from_channel_args(handshaker->args_->args, true);
+    handshaker->endpoint_ = grpc_tcp_create(
+        handshaker->uds_fd_, handshaker->args_->args,
+        handshaker->peer_string_.c_str(),
+        grpc_slice_allocator_create(resource_quota,
+                                    handshaker->peer_string_.c_str(),
+                                    handshaker->args_->args));
+    grpc_resource_quota_unref_internal(resource_quota);
+  } else {
+    grpc_fd_orphan(handshaker->uds_fd_, nullptr, nullptr, "shm_handshaker");
+  }
+  handshaker->uds_fd_ = nullptr;
+  if (error != GRPC_ERROR_NONE || handshaker->is_shutdown_) {
+    if (handshaker->endpoint_ != nullptr) {
+      grpc_endpoint_destroy(handshaker->endpoint_);
+      handshaker->endpoint_ = nullptr;
+    }
+    handshaker->HandshakeFailedLocked(GRPC_ERROR_REF(error));
+  } else {
+    if (handshaker->is_client_) {
+      grpc_endpoint_add_to_pollset_set(handshaker->endpoint_,
+                                       handshaker->interested_parties_);
+    }
+    handshaker->args_->endpoint = handshaker->endpoint_;
+    handshaker->endpoint_ = nullptr;
+    // Set shutdown to true so that subsequent calls to Shutdown() do
+    // nothing.
+    handshaker->is_shutdown_ = true;
+    ExecCtx::Run(DEBUG_LOCATION, handshaker->on_handshake_done_,
+                 GRPC_ERROR_NONE);
+  }
+  lock.Release();
+  handshaker->Unref();
+}
+
+//
+// Public handshaker methods
+//
+
+void ShmHandshaker::Shutdown(grpc_error_handle why) {
+  {
+    MutexLock lock(&mu_);
+    if (!is_shutdown_) {
+      is_shutdown_ = true;
+      // Fails the pending shared-memory handshake step, if any. A pending
+      // release sees is_shutdown_ instead.
+      if (uds_fd_ != nullptr) grpc_fd_shutdown(uds_fd_, GRPC_ERROR_REF(why));
+      CleanupArgsForFailureLocked();
+    }
+  }
+  GRPC_ERROR_UNREF(why);
+}
+
+void ShmHandshaker::DoHandshake(grpc_tcp_server_acceptor* /*acceptor*/,
+                                grpc_closure* on_handshake_done,
+                                HandshakerArgs* args) {
+  absl::string_view peer = grpc_endpoint_get_peer(args->endpoint);
+  // Only connections over Unix domain sockets that nothing was read from yet
+  // can switch to shared memory. Let everything else through untouched.
+  if (!(absl::StartsWith(peer, "unix:") ||
+        absl::StartsWith(peer, "unix-abstract:")) ||
+      grpc_endpoint_get_fd(args->endpoint) < 0 ||
+      args->read_buffer->length != 0) {
+    // Set shutdown to true so that subsequent calls to Shutdown() do nothing.
+    {
+      MutexLock lock(&mu_);
+      is_shutdown_ = true;
+    }
+    ExecCtx::Run(DEBUG_LOCATION, on_handshake_done, GRPC_ERROR_NONE);
+    return;
+  }
+  MutexLock lock(&mu_);
+  args_ = args;
+  on_handshake_done_ = on_handshake_done;
+  peer_string_ = std::string(peer);
+  // Take a new ref to be held by the release callback.
+  Ref().release();
+  grpc_endpoint* endpoint = args->endpoint;
+  args->endpoint = nullptr;
+  // The client connector adds its endpoint to interested_parties for the
+  // duration of the handshake and removes it afterwards. Move that
+  // membership over to the endpoint that replaces it.
+  if (is_client_) {
+    grpc_endpoint_delete_from_pollset_set(endpoint, interested_parties_);
+  }
+  grpc_tcp_destroy_and_release_fd(endpoint, &released_fd_, &on_fd_released_);
+}
+
+//
+// handshaker factory
+//
+
+class ShmHandshakerFactory : public HandshakerFactory {
+ public:
+  explicit ShmHandshakerFactory(bool is_client) : is_client_(is_client) {}
+  void AddHandshakers(const grpc_channel_args* args,
+                      grpc_pollset_set* interested_parties,
+                      HandshakeManager* handshake_mgr) override {
+    // The handshake needs someone to poll the socket.
+    if (interested_parties == nullptr ||
+        !grpc_channel_args_find_bool(args, GRPC_ARG_SHM_ENDPOINT, false)) {
+      return;
+    }
+    size_t ring_size = grpc_channel_args_find_integer(
+        args, GRPC_ARG_SHM_ENDPOINT_RING_SIZE,
+        {GRPC_SHM_ENDPOINT_DEFAULT_RING_SIZE, 4096, 1 << 30});
+    handshake_mgr->Add(MakeRefCounted<ShmHandshaker>(is_client_, ring_size,
+                                                     interested_parties));
+  }
+  ~ShmHandshakerFactory() override = default;
+
+ private:
+  const bool is_client_;
+};
+
+}  // namespace
+
+void RegisterShmHandshaker(CoreConfiguration::Builder* builder) {
+  // Runs first, so that the other handshakers already see the shared-memory
+  // endpoint.
+  builder->handshaker_registry()->RegisterHandshakerFactory(
+      true /* at_start */, HANDSHAKER_CLIENT,
+      absl::make_unique<ShmHandshakerFactory>(/*is_client=*/true));
+  builder->handshaker_registry()->RegisterHandshakerFactory(
+      true /* at_start */, HANDSHAKER_SERVER,
+      absl::make_unique<ShmHandshakerFactory>(/*is_client=*/false));
+}
+
+}  // namespace grpc_core
+
+#else /* GRPC_LINUX_SHM_ENDPOINT && GRPC_POSIX_SOCKET_TCP */
+
+namespace grpc_core {
+
+void RegisterShmHandshaker(CoreConfiguration::Builder* /*builder*/) {}
+
+}  // namespace grpc_core
+
+#endif /* GRPC_LINUX_SHM_ENDPOINT && GRPC_POSIX_SOCKET_TCP */
@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_CHANNEL_SHM_HANDSHAKER_H
+#define GRPC_CORE_LIB_CHANNEL_SHM_HANDSHAKER_H
+
+#include <grpc/impl/codegen/port_platform.h>
+
+#include "src/core/lib/config/core_configuration.h"
+
+/// Channel arg (boolean) that moves connections over unix: addresses onto the
+/// shared-memory endpoint (src/core/lib/iomgr/endpoint_shm.h) right after
+/// they are established. A client with the arg set requires the server to
+/// have it too; a server with the arg set keeps serving clients without it
+/// over the socket.
+#define GRPC_ARG_SHM_ENDPOINT "grpc.experimental.shm_endpoint"
+
+/// Channel arg (integer) with the capacity of each direction of a
+/// shared-memory connection, in bytes. Only read by the client, which
+/// creates the segment.
+#define GRPC_ARG_SHM_ENDPOINT_RING_SIZE "grpc.experimental.shm_ring_size"
+
+namespace grpc_core {
+
+// Register the shared-memory handshaker into the configuration builder.
+// Does nothing on platforms without the shared-memory endpoint.
+void RegisterShmHandshaker(CoreConfiguration::Builder* builder);
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_CHANNEL_SHM_HANDSHAKER_H */
@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/compression/adaptive_compression.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include <zlib.h>
+
+#include "absl/memory/memory.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Messages are sampled up to this many bytes...
+constexpr size_t kEntropySampleSize = 1024;
+// ...and only when they have at least this many, below which the estimate
+// is too noisy.
+constexpr size_t kMinEntropySampleSize = 256;
+// Deflate barely does better than storing data above this entropy.
+constexpr double kIncompressibleEntropy = 7.5;
+// Compressing to more than this fraction of the original size is not worth
+// the CPU.
+constexpr double kMaxRatio = 0.9;
+// Weight of the newest message in the averages.
+constexpr double kSmoothing = 0.125;
+// Messages to average over before changing modes.
+constexpr int kMinSamples = 8;
+constexpr uint32_t kProbeInterval = 32;
+// Methods tracked per channel.
+constexpr size_t kMaxMethods = 256;
+
+}  // namespace
+
+double EstimateEntropyBitsPerByte(const grpc_slice_buffer* input,
+                                  size_t sample_size) {
+  uint32_t histogram[256] = {};
+  size_t n = 0;
+  for (size_t i = 0; i < input->count && n < sample_size; i++) {
+    const uint8_t* p = GRPC_SLICE_START_PTR(input->slices[i]);
+    const size_t len =
+        std::min(GRPC_SLICE_LENGTH(input->slices[i]), sample_size - n);
+    for (size_t j = 0; j < len; j++) histogram[p[j]]++;
+    n += len;
+  }
+  if (n == 0) return 0;
+  double entropy = 0;
+  int symbols = 0;
+  for (uint32_t count : histogram) {
+    if (count == 0) continue;
+    symbols++;
+    const double p = static_cast<double>(count) / n;
+    entropy -= p * log2(p);
+  }
+  // Miller-Madow correction: small samples underestimate the entropy.
+  entropy += (symbols - 1) / (2.0 * n * log(2.0));
+  return std::min(entropy, 8.0);
+}
+
+AdaptiveCompressionStats::Decision AdaptiveCompressionStats::Decide(
+    const grpc_slice_buffer* message) {
+  if (message->length >= kMinEntropySampleSize &&
+      EstimateEntropyBitsPerByte(message, kEntropySampleSize) >
+          kIncompressibleEntropy) {
+    return {false, Z_DEFAULT_COMPRESSION};
+  }
+  const bool probe =
+      (messages_.fetch_add(1, std::memory_order_relaxed) + 1) %
+          kProbeInterval ==
+      0;
+  switch (mode_.load(std::memory_order_relaxed)) {
+    case Mode::kDefaultLevel:
+      break;
+    case Mode::kFastLevel:
+      if (!probe) return {true, Z_BEST_SPEED};
+      break;
+    case Mode::kOff:
+      if (!probe) return {false, Z_DEFAULT_COMPRESSION};
+      break;
+  }
+  return {true, Z_DEFAULT_COMPRESSION};
+}
+
+void AdaptiveCompressionStats::Record(int level, size_t uncompressed_size,
+                                      size_t compressed_size, int64_t cpu_ns) {
+  if (uncompressed_size == 0) return;
+  compressed_size = std::min(compressed_size, uncompressed_size);
+  const double ratio = static_cast<double>(compressed_size) / uncompressed_size;
+  const double bytes_saved_per_cpu_ms =
+      (uncompressed_size - compressed_size) * 1e6 /
+      std::max<int64_t>(cpu_ns, 1);
+  const bool default_level = level != Z_BEST_SPEED;
+  // Where the averages say a level stands.
+  auto evaluate = [this](double ratio, double bytes_saved_per_cpu_ms,
+                         bool default_level) {
+    if (ratio > kMaxRatio) return Mode::kOff;
+    if (bytes_saved_per_cpu_ms < min_bytes_saved_per_cpu_ms_) {
+      return default_level ? Mode::kFastLevel : Mode::kOff;
+    }
+    return default_level ? Mode::kDefaultLevel : Mode::kFastLevel;
+  };
+  Mode mode = mode_.load(std::memory_order_relaxed);
+  // Decided before the last change of mode.
+  if (!default_level && mode != Mode::kFastLevel) return;
+  Mode next;
+  if (default_level != (mode == Mode::kDefaultLevel)) {
+    // A probe, which stands for the default level on its own.
+    next = evaluate(ratio, bytes_saved_per_cpu_ms, default_level);
+  } else {
+    // Racing updates may overwrite each other's sample; the averages are
+    // estimates anyway.
+    const int samples = samples_.fetch_add(1, std::memory_order_relaxed) + 1;
+    double avg_ratio = ratio;
+    double avg_bytes_saved_per_cpu_ms = bytes_saved_per_cpu_ms;
+    if (samples > 1) {
+      const double old_ratio = ratio_.load(std::memory_order_relaxed);
+      const double old_bytes_saved_per_cpu_ms =
+          bytes_saved_per_cpu_ms_.load(std::memory_order_relaxed);
+      avg_ratio = old_ratio + kSmoothing * (ratio - old_ratio);
+      avg_bytes_saved_per_cpu_ms =
+          old_bytes_saved_per_cpu_ms +
+          kSmoothing * (bytes_saved_per_cpu_ms - old_bytes_saved_per_cpu_ms);
+    }
+    ratio_.store(avg_ratio, std::memory_order_relaxed);
+    bytes_saved_per_cpu_ms_.store(avg_bytes_saved_per_cpu_ms,
+                                  std::memory_order_relaxed);
+    if (samples < kMinSamples) return;
+    next = evaluate(avg_ratio, avg_bytes_saved_per_cpu_ms, default_level);
+  }
+  // Only the thread that changes the mode restarts the counts.
+  if (next != mode &&
+      mode_.compare_exchange_strong(mode, next, std::memory_order_relaxed)) {
+    messages_.store(0, std::memory_order_relaxed);
+    samples_.store(0, std::memory_order_relaxed);
+  }
+}
+
+AdaptiveCompressionStats* AdaptiveCompressionPolicy::StatsForMethod(
+    absl::string_view path) {
+  MutexLock lock(&mu_);
+  auto it = methods_.find(std::string(path));
+  if (it != methods_.end()) return it->second.get();
+  if (methods_.size() >= kMaxMethods) return &other_methods_;
+  std::unique_ptr<AdaptiveCompressionStats>& stats =
+      methods_[std::string(path)];
+  stats = absl::make_unique<AdaptiveCompressionStats>(
+      min_bytes_saved_per_cpu_ms_);
+  return stats.get();
+}
+
+}  // namespace grpc_core
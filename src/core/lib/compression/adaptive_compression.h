@@ -0,0 +1,112 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_COMPRESSION_ADAPTIVE_COMPRESSION_H
+#define GRPC_CORE_LIB_COMPRESSION_ADAPTIVE_COMPRESSION_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/gprpp/sync.h"
+
+namespace grpc_core {
+
+// Estimates the entropy, in bits per byte, of the first \a sample_size bytes
+// of \a input. Data that is already compressed or encrypted is close to 8.
+double EstimateEntropyBitsPerByte(const grpc_slice_buffer* input,
+                                  size_t sample_size);
+
+// Decides, message by message, whether and how hard the messages of one
+// method are worth compressing, from the ratio and the CPU cost of the
+// messages compressed so far. Thread-safe and lock-free: concurrent calls may
+// lose the odd sample from the averages, which only delays a change of mode.
+class AdaptiveCompressionStats {
+ public:
+  struct Decision {
+    bool compress;
+    // zlib compression level.
+    int level;
+  };
+
+  // \a min_bytes_saved_per_cpu_ms is the CPU budget: the compression level
+  // is lowered, and then compression stopped, for methods that save less.
+  explicit AdaptiveCompressionStats(int64_t min_bytes_saved_per_cpu_ms)
+      : min_bytes_saved_per_cpu_ms_(min_bytes_saved_per_cpu_ms) {}
+
+  // Decides what to do with \a message, which is about to be sent.
+  Decision Decide(const grpc_slice_buffer* message);
+
+  // Records the outcome of compressing a message at \a level:
+  // \a uncompressed_size bytes became \a compressed_size bytes using
+  // \a cpu_ns nanoseconds of CPU time, summed over all the threads involved.
+  void Record(int level, size_t uncompressed_size, size_t compressed_size,
+              int64_t cpu_ns);
+
+  // Exponentially weighted averages, for tests and debugging.
+  double ratio() const { return ratio_.load(std::memory_order_relaxed); }
+  double bytes_saved_per_cpu_ms() const {
+    return bytes_saved_per_cpu_ms_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum class Mode { kDefaultLevel, kFastLevel, kOff };
+
+  const int64_t min_bytes_saved_per_cpu_ms_;
+  std::atomic<Mode> mode_{Mode::kDefaultLevel};
+  // Counts the messages since the mode last changed; every kProbeInterval-th
+  // one is compressed at the default level, to notice when the payloads of
+  // the method change.
+  std::atomic<uint32_t> messages_{0};
+  // Messages in the averages below.
+  std::atomic<int> samples_{0};
+  std::atomic<double> ratio_{0};
+  std::atomic<double> bytes_saved_per_cpu_ms_{0};
+};
+
+// The AdaptiveCompressionStats of each method of a channel.
+class AdaptiveCompressionPolicy {
+ public:
+  explicit AdaptiveCompressionPolicy(int64_t min_bytes_saved_per_cpu_ms)
+      : min_bytes_saved_per_cpu_ms_(min_bytes_saved_per_cpu_ms),
+        other_methods_(min_bytes_saved_per_cpu_ms) {}
+
+  // Returns the stats for \a path, which live as long as the policy.
+  // Past kMaxMethods methods, new ones share a single entry.
+  AdaptiveCompressionStats* StatsForMethod(absl::string_view path);
+
+ private:
+  const int64_t min_bytes_saved_per_cpu_ms_;
+  Mutex mu_;
+  std::map<std::string, std::unique_ptr<AdaptiveCompressionStats>> methods_
+      ABSL_GUARDED_BY(mu_);
+  AdaptiveCompressionStats other_methods_;
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_COMPRESSION_ADAPTIVE_COMPRESSION_H */
@@ -0,0 +1,182 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/compression/compression_dictionary.h"
+
+#include <inttypes.h>
+
+#include <atomic>
+#include <map>
+
+#include <zlib.h>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/strip.h"
+
+#include <grpc/compression.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/surface/api_trace.h"
+
+namespace grpc_core {
+
+namespace {
+
+constexpr absl::string_view kEncodingPrefix = "deflate-dict-";
+
+uint32_t DictionaryId(const std::string& data) {
+  return static_cast<uint32_t>(
+      adler32(adler32(0L, Z_NULL, 0),
+              reinterpret_cast<const Bytef*>(data.data()),
+              static_cast<uInt>(data.size())));
+}
+
+class DictionaryRegistry {
+ public:
+  static DictionaryRegistry* Get() {
+    static DictionaryRegistry* registry = new DictionaryRegistry();
+    return registry;
+  }
+
+  bool Register(std::string path_prefix, std::string data) {
+    MutexLock lock(&mu_);
+    const CompressionDictionary*& by_id = by_id_[DictionaryId(data)];
+    if (by_id == nullptr) {
+      by_id = new CompressionDictionary(std::move(data));
+    } else if (by_id->data() != data) {
+      return false;
+    }
+    by_path_prefix_[std::move(path_prefix)] = by_id;
+    empty_.store(false, std::memory_order_release);
+    return true;
+  }
+
+  const CompressionDictionary* ForPath(absl::string_view path) {
+    if (empty_.load(std::memory_order_acquire)) return nullptr;
+    MutexLock lock(&mu_);
+    // The prefixes of path sort before it, longest last.
+    for (auto it = by_path_prefix_.upper_bound(std::string(path));
+         it != by_path_prefix_.begin();) {
+      --it;
+      if (absl::StartsWith(path, it->first)) return it->second;
+    }
+    return nullptr;
+  }
+
+  bool empty() const { return empty_.load(std::memory_order_acquire); }
+
+  const CompressionDictionary* ForId(uint32_t id) {
+    if (empty_.load(std::memory_order_acquire)) return nullptr;
+    MutexLock lock(&mu_);
+    auto it = by_id_.find(id);
+    return it == by_id_.end() ? nullptr : it->second;
+  }
+
+ private:
+  Mutex mu_;
+  std::map<std::string, const CompressionDictionary*> by_path_prefix_
+      ABSL_GUARDED_BY(mu_);
+  std::map<uint32_t, const CompressionDictionary*> by_id_ ABSL_GUARDED_BY(mu_);
+  // Lets calls skip the lock when no dictionary was ever registered.
+  std::atomic<bool> empty_{true};
+};
+
+}  // namespace
+
+CompressionDictionary::CompressionDictionary(std::string data)
+    : data_(std::move(data)),
+      id_(DictionaryId(data_)),
+      encoding_name_(absl::StrFormat("%s%08x", kEncodingPrefix, id_)) {
+  accept_encodings_.resize(1u << GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT);
+  for (uint32_t bitset = 0; bitset < accept_encodings_.size(); bitset++) {
+    std::string& value = accept_encodings_[bitset];
+    for (int i = 0; i < GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT; i++) {
+      const char* name;
+      if (GPR_BITGET(bitset, i) &&
+          grpc_message_compression_algorithm_name(
+              static_cast<grpc_message_compression_algorithm>(i), &name)) {
+        absl::StrAppend(&value, name, ",");
+      }
+    }
+    value.append(encoding_name_);
+  }
+}
+
+grpc_slice CompressionDictionary::accept_encoding_slice(
+    uint32_t message_bitset) const {
+  GPR_DEBUG_ASSERT(message_bitset < accept_encodings_.size());
+  const std::string& value = accept_encodings_[message_bitset];
+  return grpc_slice_from_static_buffer(value.data(), value.size());
+}
+
+const CompressionDictionary* CompressionDictionaryForPath(
+    absl::string_view path) {
+  return DictionaryRegistry::Get()->ForPath(path);
+}
+
+const CompressionDictionary* CompressionDictionaryForId(uint32_t id) {
+  return DictionaryRegistry::Get()->ForId(id);
+}
+
+bool CompressionDictionariesRegistered() {
+  return !DictionaryRegistry::Get()->empty();
+}
+
+bool ParseCompressionDictionaryEncoding(absl::string_view encoding,
+                                        uint32_t* id) {
+  if (!absl::ConsumePrefix(&encoding, kEncodingPrefix) ||
+      encoding.size() != 8) {
+    return false;
+  }
+  uint32_t value = 0;
+  for (char c : encoding) {
+    if (!absl::ascii_isxdigit(c)) return false;
+    value = value << 4 | (absl::ascii_isdigit(c)
+                              ? c - '0'
+                              : absl::ascii_tolower(c) - 'a' + 10);
+  }
+  *id = value;
+  return true;
+}
+
+}  // namespace grpc_core
+
+int grpc_compression_dictionary_register(const char* path_prefix,
+                                         const char* dictionary,
+                                         size_t length) {
+  GRPC_API_TRACE(
+      "grpc_compression_dictionary_register(path_prefix=%s, dictionary=%p, "
+      "length=%" PRIuPTR ")",
+      3, (path_prefix, dictionary, length));
+  if (!grpc_core::DictionaryRegistry::Get()->Register(
+          path_prefix, std::string(dictionary, length))) {
+    gpr_log(GPR_ERROR,
+            "Compression dictionary for '%s' has the same checksum as another "
+            "registered dictionary: ignoring it.",
+            path_prefix);
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,96 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_COMPRESSION_COMPRESSION_DICTIONARY_H
+#define GRPC_CORE_LIB_COMPRESSION_COMPRESSION_DICTIONARY_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/compression/compression_internal.h"
+
+namespace grpc_core {
+
+// A zlib preset dictionary for GRPC_MESSAGE_COMPRESS_DEFLATE.
+//
+// Messages deflated with a dictionary carry the grpc-encoding
+// "deflate-dict-" followed by the dictionary id in eight lowercase hex digits.
+// Peers that have the dictionary list that name in grpc-accept-encoding.
+class CompressionDictionary {
+ public:
+  explicit CompressionDictionary(std::string data);
+
+  CompressionDictionary(const CompressionDictionary&) = delete;
+  CompressionDictionary& operator=(const CompressionDictionary&) = delete;
+
+  const std::string& data() const { return data_; }
+
+  // Adler-32 checksum of the dictionary. zlib also writes it in the header of
+  // the streams compressed with the dictionary.
+  uint32_t id() const { return id_; }
+
+  // The grpc-encoding of the messages compressed with the dictionary.
+  const std::string& encoding_name() const { return encoding_name_; }
+
+  // The grpc-encoding of the messages compressed with the dictionary, as a
+  // slice that needs no ref.
+  grpc_slice encoding_slice() const {
+    return grpc_slice_from_static_buffer(encoding_name_.data(),
+                                         encoding_name_.size());
+  }
+
+  // The grpc-accept-encoding listing the message compression algorithms in
+  // \a message_bitset, then encoding_name(). Needs no ref either.
+  grpc_slice accept_encoding_slice(uint32_t message_bitset) const;
+
+ private:
+  const std::string data_;
+  const uint32_t id_;
+  const std::string encoding_name_;
+  // Indexed by message bitset.
+  std::vector<std::string> accept_encodings_;
+};
+
+// Returns the dictionary registered with grpc_compression_dictionary_register()
+// for the longest prefix of \a path, or nullptr if there is none.
+// Registered dictionaries are never freed.
+const CompressionDictionary* CompressionDictionaryForPath(
+    absl::string_view path);
+
+// Returns the registered dictionary whose id is \a id, or nullptr.
+const CompressionDictionary* CompressionDictionaryForId(uint32_t id);
+
+// Whether any dictionary was registered. Calls skip the lookups otherwise.
+bool CompressionDictionariesRegistered();
+
+// If \a encoding is the grpc-encoding of a dictionary, sets \a id to the
+// dictionary id and returns true.
+bool ParseCompressionDictionaryEncoding(absl::string_view encoding,
+                                        uint32_t* id);
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_COMPRESSION_COMPRESSION_DICTIONARY_H */
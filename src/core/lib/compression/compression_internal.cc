@@ -26,6 +26,7 @@
 #include <grpc/compression.h>
 
 #include "src/core/lib/compression/algorithm_metadata.h"
+#include "src/core/lib/compression/compression_dictionary.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/slice/slice_utils.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -44,6 +45,12 @@ grpc_message_compression_algorithm_from_slice(const grpc_slice& str) {
   if (grpc_slice_eq_static_interned(str, GRPC_MDSTR_GZIP)) {
     return GRPC_MESSAGE_COMPRESS_GZIP;
   }
+  /* deflate with a preset dictionary: the filters handle the dictionary */
+  uint32_t dictionary_id;
+  if (grpc_core::ParseCompressionDictionaryEncoding(
+          grpc_core::StringViewFromSlice(str), &dictionary_id)) {
+    return GRPC_MESSAGE_COMPRESS_DEFLATE;
+  }
   return GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT;
 }
 
@@ -253,6 +260,7 @@ grpc_message_compression_algorithm grpc_message_compression_algorithm_for_level(
 
 int grpc_message_compression_algorithm_parse(
     grpc_slice value, grpc_message_compression_algorithm* algorithm) {
+  uint32_t dictionary_id;
   if (grpc_slice_eq_static_interned(value, GRPC_MDSTR_IDENTITY)) {
     *algorithm = GRPC_MESSAGE_COMPRESS_NONE;
     return 1;
@@ -262,6 +270,11 @@ int grpc_message_compression_algorithm_parse(
   } else if (grpc_slice_eq_static_interned(value, GRPC_MDSTR_GZIP)) {
     *algorithm = GRPC_MESSAGE_COMPRESS_GZIP;
     return 1;
+  } else if (grpc_core::ParseCompressionDictionaryEncoding(
+                 grpc_core::StringViewFromSlice(value), &dictionary_id)) {
+    /* deflate with a preset dictionary */
+    *algorithm = GRPC_MESSAGE_COMPRESS_DEFLATE;
+    return 1;
   } else {
     return 0;
   }
@@ -22,11 +22,14 @@
 
 #include <string.h>
 
+#include <vector>
+
 #include <zlib.h>
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/slice/slice_internal.h"
 
 #define OUTPUT_BLOCK_SIZE 1024
@@ -91,20 +94,140 @@ static void* zalloc_gpr(void* /*opaque*/, unsigned int items,
 
 static void zfree_gpr(void* /*opaque*/, void* address) { gpr_free(address); }
 
-static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
-                         int gzip) {
-  z_stream zs;
+namespace grpc_core {
+
+namespace {
+
+// Idle zlib streams. A stream is taken for the length of one message, so the
+// pool holds about as many streams as there are messages being compressed at
+// once, up to kMaxIdleStreams of each kind.
+class ZlibStreamPool {
+ public:
+  static ZlibStreamPool* Get() {
+    static ZlibStreamPool* pool = new ZlibStreamPool();
+    return pool;
+  }
+
+  // Returns a deflate stream ready for a new message.
+  z_stream* TakeDeflate(int window_bits, int level) {
+    z_stream* zs = Take(&idle_deflate_, window_bits, level);
+    if (zs != nullptr) {
+      GPR_ASSERT(deflateReset(zs) == Z_OK);
+      return zs;
+    }
+    zs = NewStream();
+    GPR_ASSERT(deflateInit2(zs, level, Z_DEFLATED, window_bits, 8,
+                            Z_DEFAULT_STRATEGY) == Z_OK);
+    return zs;
+  }
+
+  void ReturnDeflate(z_stream* zs, int window_bits, int level) {
+    if (!Return(&idle_deflate_, zs, window_bits, level)) {
+      deflateEnd(zs);
+      delete zs;
+    }
+  }
+
+  // Returns an inflate stream ready for a new message.
+  z_stream* TakeInflate(int window_bits) {
+    z_stream* zs = Take(&idle_inflate_, window_bits, 0);
+    if (zs != nullptr) {
+      GPR_ASSERT(inflateReset(zs) == Z_OK);
+      return zs;
+    }
+    zs = NewStream();
+    GPR_ASSERT(inflateInit2(zs, window_bits) == Z_OK);
+    return zs;
+  }
+
+  void ReturnInflate(z_stream* zs, int window_bits) {
+    if (!Return(&idle_inflate_, zs, window_bits, 0)) {
+      inflateEnd(zs);
+      delete zs;
+    }
+  }
+
+ private:
+  // A deflate stream takes about 256KB, an inflate stream about 40KB.
+  static constexpr size_t kMaxIdleStreams = 8;
+
+  struct IdleStream {
+    z_stream* zs;
+    int window_bits;
+    int level;
+  };
+
+  static z_stream* NewStream() {
+    z_stream* zs = new z_stream();
+    zs->zalloc = zalloc_gpr;
+    zs->zfree = zfree_gpr;
+    return zs;
+  }
+
+  z_stream* Take(std::vector<IdleStream>* idle, int window_bits, int level) {
+    MutexLock lock(&mu_);
+    for (size_t i = idle->size(); i-- > 0;) {
+      if ((*idle)[i].window_bits == window_bits && (*idle)[i].level == level) {
+        z_stream* zs = (*idle)[i].zs;
+        (*idle)[i] = idle->back();
+        idle->pop_back();
+        return zs;
+      }
+    }
+    return nullptr;
+  }
+
+  bool Return(std::vector<IdleStream>* idle, z_stream* zs, int window_bits,
+              int level) {
+    MutexLock lock(&mu_);
+    if (idle->size() >= kMaxIdleStreams) return false;
+    idle->push_back({zs, window_bits, level});
+    return true;
+  }
+
+  Mutex mu_;
+  std::vector<IdleStream> idle_deflate_ ABSL_GUARDED_BY(mu_);
+  std::vector<IdleStream> idle_inflate_ ABSL_GUARDED_BY(mu_);
+};
+
+// inflate() that sets the dictionary in zs->opaque when the stream asks for
+// one.
+int InflateWithDictionary(z_stream* zs, int flush) {
+  int r = inflate(zs, flush);
+  if (r != Z_NEED_DICT) return r;
+  const CompressionDictionary* dictionary =
+      static_cast<const CompressionDictionary*>(zs->opaque);
+  if (dictionary == nullptr || dictionary->id() != zs->adler) {
+    gpr_log(GPR_INFO, "zlib: unexpected dictionary %08x",
+            static_cast<uint32_t>(zs->adler));
+    return Z_DATA_ERROR;
+  }
+  r = inflateSetDictionary(
+      zs, reinterpret_cast<const Bytef*>(dictionary->data().data()),
+      static_cast<uInt>(dictionary->data().size()));
+  if (r != Z_OK) return Z_DATA_ERROR;
+  return inflate(zs, flush);
+}
+
+}  // namespace
+
+int MessageCompressor::ZlibCompress(grpc_slice_buffer* input,
+                                    grpc_slice_buffer* output, int window_bits,
+                                    const CompressionDictionary* dictionary) {
   int r;
   size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
-                   8, Z_DEFAULT_STRATEGY);
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
+  z_stream* zs = ZlibStreamPool::Get()->TakeDeflate(window_bits, level_);
+  if (dictionary != nullptr) {
+    GPR_ASSERT(dictionary->data().size() <= ~static_cast<uInt>(0));
+    r = deflateSetDictionary(
+        zs, reinterpret_cast<const Bytef*>(dictionary->data().data()),
+        static_cast<uInt>(dictionary->data().size()));
+    GPR_ASSERT(r == Z_OK);
+  }
+  r = zlib_body(zs, input, output, deflate) && output->length < input->length;
+  ZlibStreamPool::Get()->ReturnDeflate(zs, window_bits, level_);
   if (!r) {
     for (i = count_before; i < output->count; i++) {
       grpc_slice_unref_internal(output->slices[i]);
@@ -112,23 +235,22 @@ static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
     output->count = count_before;
     output->length = length_before;
   }
-  deflateEnd(&zs);
   return r;
 }
 
-static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
-                           int gzip) {
-  z_stream zs;
+int MessageCompressor::ZlibDecompress(grpc_slice_buffer* input,
+                                      grpc_slice_buffer* output,
+                                      int window_bits,
+                                      const CompressionDictionary* dictionary) {
   int r;
   size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, inflate);
+  z_stream* zs = ZlibStreamPool::Get()->TakeInflate(window_bits);
+  zs->opaque = const_cast<CompressionDictionary*>(dictionary);
+  r = zlib_body(zs, input, output, InflateWithDictionary);
+  zs->opaque = nullptr;
+  ZlibStreamPool::Get()->ReturnInflate(zs, window_bits);
   if (!r) {
     for (i = count_before; i < output->count; i++) {
       grpc_slice_unref_internal(output->slices[i]);
@@ -136,7 +258,6 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
     output->count = count_before;
     output->length = length_before;
   }
-  inflateEnd(&zs);
   return r;
 }
 
@@ -148,45 +269,62 @@ static int copy(grpc_slice_buffer* input, grpc_slice_buffer* output) {
   return 1;
 }
 
-static int compress_inner(grpc_message_compression_algorithm algorithm,
-                          grpc_slice_buffer* input, grpc_slice_buffer* output) {
+int MessageCompressor::Compress(grpc_message_compression_algorithm algorithm,
+                                grpc_slice_buffer* input,
+                                grpc_slice_buffer* output) {
+  last_helper_cpu_ns_ = 0;
+  if (parallel_compressor_ != nullptr && parallel_min_size_ > 0 &&
+      input->length >= parallel_min_size_ &&
+      ((algorithm == GRPC_MESSAGE_COMPRESS_DEFLATE && dictionary_ == nullptr) ||
+       algorithm == GRPC_MESSAGE_COMPRESS_GZIP)) {
+    return parallel_compressor_->Compress(algorithm, level_, input, output,
+                                          &last_helper_cpu_ns_);
+  }
+  int r = 0;
   switch (algorithm) {
     case GRPC_MESSAGE_COMPRESS_NONE:
       /* the fallback path always needs to be send uncompressed: we simply
          rely on that here */
-      return 0;
+      break;
     case GRPC_MESSAGE_COMPRESS_DEFLATE:
-      return zlib_compress(input, output, 0);
+      r = ZlibCompress(input, output, 15, dictionary_);
+      break;
     case GRPC_MESSAGE_COMPRESS_GZIP:
-      return zlib_compress(input, output, 1);
-    case GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT:
+      r = ZlibCompress(input, output, 15 | 16, nullptr);
+      break;
+    default:
+      gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
       break;
   }
-  gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
-  return 0;
-}
-
-int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
-                      grpc_slice_buffer* input, grpc_slice_buffer* output) {
-  if (!compress_inner(algorithm, input, output)) {
-    copy(input, output);
-    return 0;
-  }
-  return 1;
+  if (!r) copy(input, output);
+  return r;
 }
 
-int grpc_msg_decompress(grpc_message_compression_algorithm algorithm,
-                        grpc_slice_buffer* input, grpc_slice_buffer* output) {
+int MessageCompressor::Decompress(grpc_message_compression_algorithm algorithm,
+                                  grpc_slice_buffer* input,
+                                  grpc_slice_buffer* output) {
   switch (algorithm) {
     case GRPC_MESSAGE_COMPRESS_NONE:
       return copy(input, output);
     case GRPC_MESSAGE_COMPRESS_DEFLATE:
-      return zlib_decompress(input, output, 0);
+      return ZlibDecompress(input, output, 15, dictionary_);
     case GRPC_MESSAGE_COMPRESS_GZIP:
-      return zlib_decompress(input, output, 1);
+      return ZlibDecompress(input, output, 15 | 16, nullptr);
     case GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT:
       break;
   }
   gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
   return 0;
 }
+
+}  // namespace grpc_core
+
+int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
+                      grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  return grpc_core::MessageCompressor().Compress(algorithm, input, output);
+}
+
+int grpc_msg_decompress(grpc_message_compression_algorithm algorithm,
+                        grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  return grpc_core::MessageCompressor().Decompress(algorithm, input, output);
+}
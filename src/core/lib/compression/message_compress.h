@@ -21,9 +21,13 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <zlib.h>
+
 #include <grpc/slice_buffer.h>
 
+#include "src/core/lib/compression/compression_dictionary.h"
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/compression/parallel_compress.h"
 
 /* compress 'input' to 'output' using 'algorithm'.
    On success, appends compressed slices to output and returns 1.
@@ -37,4 +41,66 @@ int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
 int grpc_msg_decompress(grpc_message_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+namespace grpc_core {
+
+// Compresses and decompresses the messages of a call. The zlib streams come
+// from a process-wide pool of idle streams and go back to it after each
+// message: messages reuse the streams of earlier ones (deflateReset() and
+// inflateReset()) instead of paying for deflateInit2()/inflateInit2(), and
+// idle calls hold no zlib state.
+class MessageCompressor {
+ public:
+  MessageCompressor() = default;
+
+  MessageCompressor(const MessageCompressor&) = delete;
+  MessageCompressor& operator=(const MessageCompressor&) = delete;
+
+  // Sets the preset dictionary of GRPC_MESSAGE_COMPRESS_DEFLATE messages, in
+  // both directions. Deflate streams that need another dictionary fail to
+  // decompress.
+  void set_dictionary(const CompressionDictionary* dictionary) {
+    dictionary_ = dictionary;
+  }
+
+  // Sets the zlib compression level of the next messages. Defaults to
+  // Z_DEFAULT_COMPRESSION.
+  void set_level(int level) { level_ = level; }
+
+  // Has GRPC_MESSAGE_COMPRESS_DEFLATE and GRPC_MESSAGE_COMPRESS_GZIP messages
+  // of at least \a min_size bytes compressed by \a compressor. 0 disables.
+  // Messages deflated with a dictionary are never compressed in parallel.
+  void set_parallel_compressor(ParallelCompressor* compressor,
+                               size_t min_size) {
+    parallel_compressor_ = compressor;
+    parallel_min_size_ = min_size;
+  }
+
+  // Same contract as grpc_msg_compress().
+  int Compress(grpc_message_compression_algorithm algorithm,
+               grpc_slice_buffer* input, grpc_slice_buffer* output);
+
+  // CPU time that helper threads spent on the last message compressed, on
+  // top of that of the calling thread. 0 unless it was compressed in
+  // parallel.
+  int64_t last_helper_cpu_ns() const { return last_helper_cpu_ns_; }
+
+  // Same contract as grpc_msg_decompress().
+  int Decompress(grpc_message_compression_algorithm algorithm,
+                 grpc_slice_buffer* input, grpc_slice_buffer* output);
+
+ private:
+  int ZlibCompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                   int window_bits, const CompressionDictionary* dictionary);
+  int ZlibDecompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                     int window_bits, const CompressionDictionary* dictionary);
+
+  const CompressionDictionary* dictionary_ = nullptr;
+  int level_ = Z_DEFAULT_COMPRESSION;
+  ParallelCompressor* parallel_compressor_ = nullptr;
+  size_t parallel_min_size_ = 0;
+  int64_t last_helper_cpu_ns_ = 0;
+};
+
+}  // namespace grpc_core
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
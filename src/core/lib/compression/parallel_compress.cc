@@ -0,0 +1,347 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/compression/parallel_compress.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <zlib.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Size of the deflate window: how much of the previous chunk primes the next.
+constexpr size_t kWindowSize = 32 * 1024;
+constexpr size_t kOutputBlockSize = 64 * 1024;
+
+void* ZAlloc(void* /*opaque*/, unsigned int items, unsigned int size) {
+  return gpr_malloc(items * size);
+}
+
+void ZFree(void* /*opaque*/, void* address) { gpr_free(address); }
+
+// Returns the last \a n bytes of \a buffer, or all of it if shorter.
+std::string Tail(const grpc_slice_buffer* buffer, size_t n) {
+  n = std::min(n, buffer->length);
+  std::string tail(n, 0);
+  size_t end = n;
+  for (size_t i = buffer->count; i > 0 && end > 0; i--) {
+    const grpc_slice& slice = buffer->slices[i - 1];
+    const size_t len = std::min(GRPC_SLICE_LENGTH(slice), end);
+    memcpy(&tail[end - len], GRPC_SLICE_END_PTR(slice) - len, len);
+    end -= len;
+  }
+  return tail;
+}
+
+void PutBigEndian32(uint32_t value, uint8_t* out) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+void PutLittleEndian32(uint32_t value, uint8_t* out) {
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+  out[2] = static_cast<uint8_t>(value >> 16);
+  out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+}  // namespace
+
+// One message being compressed. Held by the caller and by each helper thread
+// that was asked to pitch in, which may get to it after all the chunks are
+// done.
+class ParallelCompressor::Job : public RefCounted<Job> {
+ public:
+  Job(bool gzip, int level, grpc_slice_buffer* input)
+      : gzip_(gzip),
+        level_(level),
+        length_(input->length),
+        num_chunks_((input->length + kChunkSize - 1) / kChunkSize),
+        chunks_(new Chunk[num_chunks_]) {
+    size_t chunk = 0;
+    for (size_t i = 0; i < input->count; i++) {
+      const grpc_slice& slice = input->slices[i];
+      size_t offset = 0;
+      while (offset < GRPC_SLICE_LENGTH(slice)) {
+        if (chunks_[chunk].input.length == kChunkSize) {
+          chunks_[chunk + 1].dictionary =
+              Tail(&chunks_[chunk].input, kWindowSize);
+          chunk++;
+        }
+        const size_t len =
+            std::min(GRPC_SLICE_LENGTH(slice) - offset,
+                     kChunkSize - chunks_[chunk].input.length);
+        grpc_slice_buffer_add(&chunks_[chunk].input,
+                              grpc_slice_sub(slice, offset, offset + len));
+        offset += len;
+      }
+    }
+  }
+
+  size_t num_chunks() const { return num_chunks_; }
+
+  // Has \a count threads of \a pool call Work().
+  void AddHelpers(ThreadPool* pool, size_t count) {
+    for (size_t i = 0; i < count; i++) pool->Add(new Helper(Ref()));
+  }
+
+  // Compresses chunks until there are none left to start. A \a helper
+  // thread adds the CPU time it spends to helper_cpu_ns().
+  void Work(bool helper) {
+    size_t i;
+    while ((i = next_chunk_.fetch_add(1, std::memory_order_relaxed)) <
+           num_chunks_) {
+      const int64_t start = helper ? gpr_thread_cpu_time_ns() : 0;
+      chunks_[i].ok = CompressChunk(&chunks_[i], i == num_chunks_ - 1);
+      MutexLock lock(&mu_);
+      if (helper) helper_cpu_ns_ += gpr_thread_cpu_time_ns() - start;
+      if (++done_ == num_chunks_) cv_.Signal();
+    }
+  }
+
+  // Waits until all the chunks are compressed.
+  void Wait() {
+    MutexLock lock(&mu_);
+    while (done_ < num_chunks_) cv_.Wait(&mu_);
+  }
+
+  // CPU time the helper threads spent on the chunks. Call after Wait().
+  int64_t helper_cpu_ns() {
+    MutexLock lock(&mu_);
+    return helper_cpu_ns_;
+  }
+
+  // Appends the compressed message to \a output. Returns false if a chunk
+  // failed to compress.
+  bool Finish(grpc_slice_buffer* output) {
+    uLong check = chunks_[0].check;
+    for (size_t i = 0; i < num_chunks_; i++) {
+      if (!chunks_[i].ok) return false;
+      if (i > 0) {
+        const z_off_t len = static_cast<z_off_t>(chunks_[i].input.length);
+        check = gzip_ ? crc32_combine(check, chunks_[i].check, len)
+                      : adler32_combine(check, chunks_[i].check, len);
+      }
+    }
+    // Headers and trailers as deflate() would write them: RFC 1952 for
+    // gzip, RFC 1950 for deflate (which is zlib in gRPC).
+    if (gzip_) {
+      const uint8_t header[10] = {
+          0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0,
+          static_cast<uint8_t>(level_ == 9 ? 2 : level_ == 1 ? 4 : 0),
+          255 /* unknown OS */};
+      grpc_slice_buffer_add(
+          output, grpc_slice_from_copied_buffer(
+                      reinterpret_cast<const char*>(header), sizeof(header)));
+    } else {
+      const int level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+      const unsigned level_flags =
+          level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+      unsigned header = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8) |
+                        (level_flags << 6);
+      header += 31 - header % 31;
+      const char bytes[2] = {static_cast<char>(header >> 8),
+                             static_cast<char>(header & 0xff)};
+      grpc_slice_buffer_add(output,
+                            grpc_slice_from_copied_buffer(bytes, 2));
+    }
+    for (size_t i = 0; i < num_chunks_; i++) {
+      grpc_slice_buffer_move_into(&chunks_[i].output, output);
+    }
+    uint8_t trailer[8];
+    size_t trailer_length;
+    if (gzip_) {
+      PutLittleEndian32(static_cast<uint32_t>(check), trailer);
+      PutLittleEndian32(static_cast<uint32_t>(length_), trailer + 4);
+      trailer_length = 8;
+    } else {
+      PutBigEndian32(static_cast<uint32_t>(check), trailer);
+      trailer_length = 4;
+    }
+    grpc_slice_buffer_add(
+        output, grpc_slice_from_copied_buffer(
+                    reinterpret_cast<const char*>(trailer), trailer_length));
+    return true;
+  }
+
+ private:
+  struct Helper : public grpc_completion_queue_functor {
+    explicit Helper(RefCountedPtr<Job> job) : job(std::move(job)) {
+      functor_run = Run;
+      inlineable = false;
+      internal_success = 1;
+    }
+
+    static void Run(grpc_completion_queue_functor* functor, int /*ok*/) {
+      Helper* self = static_cast<Helper*>(functor);
+      self->job->Work(/*helper=*/true);
+      delete self;
+    }
+
+    RefCountedPtr<Job> job;
+  };
+
+  struct Chunk {
+    Chunk() {
+      grpc_slice_buffer_init(&input);
+      grpc_slice_buffer_init(&output);
+    }
+    ~Chunk() {
+      grpc_slice_buffer_destroy(&input);
+      grpc_slice_buffer_destroy(&output);
+    }
+
+    grpc_slice_buffer input;
+    // The last kWindowSize bytes of the previous chunk.
+    std::string dictionary;
+    grpc_slice_buffer output;
+    // crc32 or adler32 of input.
+    uLong check = 0;
+    bool ok = false;
+  };
+
+  // Deflates \a chunk as a raw deflate stream. All but the last chunk end
+  // with a sync flush, so that the next one starts on a byte boundary.
+  bool CompressChunk(Chunk* chunk, bool last) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    zs.zalloc = ZAlloc;
+    zs.zfree = ZFree;
+    if (deflateInit2(&zs, level_, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+    if (!chunk->dictionary.empty()) {
+      deflateSetDictionary(
+          &zs, reinterpret_cast<const Bytef*>(chunk->dictionary.data()),
+          static_cast<uInt>(chunk->dictionary.size()));
+    }
+    chunk->check = gzip_ ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+    grpc_slice outbuf = GRPC_SLICE_MALLOC(kOutputBlockSize);
+    zs.avail_out = static_cast<uInt>(kOutputBlockSize);
+    zs.next_out = GRPC_SLICE_START_PTR(outbuf);
+    int r = Z_OK;
+    for (size_t i = 0; i < chunk->input.count; i++) {
+      grpc_slice slice = chunk->input.slices[i];
+      const int flush = i < chunk->input.count - 1 ? Z_NO_FLUSH
+                        : last                     ? Z_FINISH
+                                                   : Z_SYNC_FLUSH;
+      const uInt len = static_cast<uInt>(GRPC_SLICE_LENGTH(slice));
+      chunk->check = gzip_
+                         ? crc32(chunk->check, GRPC_SLICE_START_PTR(slice), len)
+                         : adler32(chunk->check, GRPC_SLICE_START_PTR(slice),
+                                   len);
+      zs.next_in = GRPC_SLICE_START_PTR(slice);
+      zs.avail_in = len;
+      do {
+        if (zs.avail_out == 0) {
+          grpc_slice_buffer_add_indexed(&chunk->output, outbuf);
+          outbuf = GRPC_SLICE_MALLOC(kOutputBlockSize);
+          zs.avail_out = static_cast<uInt>(kOutputBlockSize);
+          zs.next_out = GRPC_SLICE_START_PTR(outbuf);
+        }
+        r = deflate(&zs, flush);
+        if (r == Z_STREAM_ERROR) break;
+      } while (zs.avail_out == 0);
+    }
+    deflateEnd(&zs);
+    if (r == Z_STREAM_ERROR || zs.avail_in != 0 ||
+        (last && r != Z_STREAM_END)) {
+      gpr_log(GPR_INFO, "zlib: chunk compression failed (%d)", r);
+      grpc_slice_unref(outbuf);
+      return false;
+    }
+    outbuf.data.refcounted.length -= zs.avail_out;
+    grpc_slice_buffer_add_indexed(&chunk->output, outbuf);
+    return true;
+  }
+
+  const bool gzip_;
+  const int level_;
+  const size_t length_;
+  const size_t num_chunks_;
+  std::unique_ptr<Chunk[]> chunks_;
+  std::atomic<size_t> next_chunk_{0};
+  Mutex mu_;
+  CondVar cv_;
+  size_t done_ ABSL_GUARDED_BY(mu_) = 0;
+  int64_t helper_cpu_ns_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+ParallelCompressor* ParallelCompressor::Get() {
+  static ParallelCompressor* compressor = new ParallelCompressor(
+      std::max(1, static_cast<int>(gpr_cpu_num_cores()) - 1));
+  return compressor;
+}
+
+ParallelCompressor::ParallelCompressor(int num_threads)
+    : pool_(num_threads, "grpc_compress") {}
+
+int ParallelCompressor::Compress(grpc_message_compression_algorithm algorithm,
+                                 int level, grpc_slice_buffer* input,
+                                 grpc_slice_buffer* output,
+                                 int64_t* helper_cpu_ns) {
+  int r = 0;
+  if (helper_cpu_ns != nullptr) *helper_cpu_ns = 0;
+  if (input->length > 0 && (algorithm == GRPC_MESSAGE_COMPRESS_GZIP ||
+                            algorithm == GRPC_MESSAGE_COMPRESS_DEFLATE)) {
+    RefCountedPtr<Job> job = MakeRefCounted<Job>(
+        algorithm == GRPC_MESSAGE_COMPRESS_GZIP, level, input);
+    job->AddHelpers(&pool_,
+                    std::min(static_cast<size_t>(pool_.pool_capacity()),
+                             job->num_chunks() - 1));
+    job->Work(/*helper=*/false);
+    job->Wait();
+    if (helper_cpu_ns != nullptr) *helper_cpu_ns = job->helper_cpu_ns();
+    grpc_slice_buffer compressed;
+    grpc_slice_buffer_init(&compressed);
+    r = job->Finish(&compressed) && compressed.length < input->length;
+    if (r) grpc_slice_buffer_move_into(&compressed, output);
+    grpc_slice_buffer_destroy(&compressed);
+  } else {
+    gpr_log(GPR_ERROR, "invalid parallel compression algorithm %d", algorithm);
+  }
+  if (!r) {
+    for (size_t i = 0; i < input->count; i++) {
+      grpc_slice_buffer_add(output, grpc_slice_ref(input->slices[i]));
+    }
+  }
+  return r;
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,68 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_COMPRESSION_PARALLEL_COMPRESS_H
+#define GRPC_CORE_LIB_COMPRESSION_PARALLEL_COMPRESS_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/iomgr/executor/threadpool.h"
+
+namespace grpc_core {
+
+// Compresses large messages on a pool of threads, pigz-style: the message is
+// cut into chunks that are deflated independently, each primed with the
+// last 32KB of the previous chunk, and the raw deflate outputs are stitched
+// into a single gzip or zlib stream. Any inflater decompresses it.
+class ParallelCompressor {
+ public:
+  // Messages are cut into chunks of this many bytes.
+  static constexpr size_t kChunkSize = 128 * 1024;
+
+  // The compressor shared by all channels, with a thread per core.
+  static ParallelCompressor* Get();
+
+  // \a num_threads helper threads; the calling thread compresses too.
+  explicit ParallelCompressor(int num_threads);
+
+  ParallelCompressor(const ParallelCompressor&) = delete;
+  ParallelCompressor& operator=(const ParallelCompressor&) = delete;
+
+  // Same contract as grpc_msg_compress(), for GRPC_MESSAGE_COMPRESS_DEFLATE
+  // and GRPC_MESSAGE_COMPRESS_GZIP only. \a level is the zlib compression
+  // level. Blocks until the whole message is compressed. If not null,
+  // \a helper_cpu_ns is set to the CPU time the helper threads spent on it;
+  // the caller's share is not included.
+  int Compress(grpc_message_compression_algorithm algorithm, int level,
+               grpc_slice_buffer* input, grpc_slice_buffer* output,
+               int64_t* helper_cpu_ns = nullptr);
+
+ private:
+  class Job;
+
+  ThreadPool pool_;
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_COMPRESSION_PARALLEL_COMPRESS_H */
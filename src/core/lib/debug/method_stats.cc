@@ -0,0 +1,160 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/debug/method_stats.h"
+
+#include <algorithm>
+
+#include <grpc/support/cpu.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Shards beyond this many cost memory without reducing contention much.
+constexpr size_t kMaxShards = 8;
+
+constexpr uint64_t kMaxBucketedValue =
+    (uint64_t(1) << (MethodStats::kNumBuckets / MethodStats::kSubBuckets + 1)) -
+    1;
+
+int HighestBit(uint64_t value) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(value);
+#else
+  int bit = 0;
+  while (value >>= 1) ++bit;
+  return bit;
+#endif
+}
+
+const char* MetricName(int metric) {
+  switch (metric) {
+    case MethodStats::kQueueTime:
+      return "queueTimeNanos";
+    case MethodStats::kHandlerTime:
+      return "handlerTimeNanos";
+    case MethodStats::kBytesIn:
+      return "bytesIn";
+    case MethodStats::kBytesOut:
+      return "bytesOut";
+  }
+  GPR_UNREACHABLE_CODE(return "");
+}
+
+}  // namespace
+
+constexpr int MethodStats::kSubBuckets;
+constexpr int MethodStats::kNumBuckets;
+
+int MethodStats::BucketFor(uint64_t value) {
+  if (value < kSubBuckets) return static_cast<int>(value);
+  value = std::min(value, kMaxBucketedValue);
+  // kSubBuckets is 4: the two bits below the highest one pick the sub-bucket.
+  int exponent = HighestBit(value);
+  return (exponent - 1) * kSubBuckets +
+         static_cast<int>((value >> (exponent - 2)) & (kSubBuckets - 1));
+}
+
+uint64_t MethodStats::BucketLowerBound(int bucket) {
+  if (bucket < kSubBuckets) return bucket;
+  int exponent = bucket / kSubBuckets + 1;
+  return static_cast<uint64_t>(kSubBuckets + bucket % kSubBuckets)
+         << (exponent - 2);
+}
+
+double MethodStats::Histogram::Percentile(double percentile) const {
+  if (count_ == 0) return 0;
+  double rank = count_ * std::min(std::max(percentile, 0.0), 100.0) / 100;
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    if (buckets_[i] == 0) continue;
+    if (seen + buckets_[i] >= rank) {
+      double lower = BucketLowerBound(i);
+      double upper = i + 1 < kNumBuckets ? BucketLowerBound(i + 1)
+                                         : kMaxBucketedValue + 1.0;
+      return lower + (upper - lower) * (rank - seen) / buckets_[i];
+    }
+    seen += buckets_[i];
+  }
+  return BucketLowerBound(kNumBuckets - 1);
+}
+
+MethodStats::MethodStats(std::string method, std::string host)
+    : method_(std::move(method)),
+      host_(std::move(host)),
+      num_shards_(std::min<size_t>(std::max(1u, gpr_cpu_num_cores()),
+                                   kMaxShards)),
+      shards_(new Shard[num_shards_]()) {}
+
+void MethodStats::RecordCall(uint64_t queue_time_ns, uint64_t handler_time_ns,
+                             uint64_t bytes_in, uint64_t bytes_out) {
+  Shard* shard = &shards_[ExecCtx::Get()->starting_cpu() % num_shards_];
+  Record(shard, kQueueTime, queue_time_ns);
+  Record(shard, kHandlerTime, handler_time_ns);
+  Record(shard, kBytesIn, bytes_in);
+  Record(shard, kBytesOut, bytes_out);
+}
+
+MethodStats::Snapshot MethodStats::GetSnapshot() const {
+  Snapshot snapshot;
+  for (size_t s = 0; s < num_shards_; ++s) {
+    const Shard& shard = shards_[s];
+    for (int m = 0; m < kNumMetrics; ++m) {
+      Histogram& histogram = snapshot.metrics[m];
+      histogram.sum_ += shard.sums[m].load(std::memory_order_relaxed);
+      for (int b = 0; b < kNumBuckets; ++b) {
+        uint64_t count = shard.buckets[m][b].load(std::memory_order_relaxed);
+        histogram.buckets_[b] += count;
+        histogram.count_ += count;
+      }
+    }
+  }
+  return snapshot;
+}
+
+Json MethodStats::RenderJson() const {
+  Snapshot snapshot = GetSnapshot();
+  Json::Object object = {
+      {"method", method_},
+      {"callsRecorded", std::to_string(snapshot.metrics[kQueueTime].count())},
+  };
+  if (!host_.empty()) object["host"] = host_;
+  for (int m = 0; m < kNumMetrics; ++m) {
+    const Histogram& histogram = snapshot.metrics[m];
+    if (histogram.count() == 0) continue;
+    Json::Object metric = {
+        {"sum", std::to_string(histogram.sum())},
+    };
+    for (const auto& p : {std::make_pair("p50", 50.0),
+                          std::make_pair("p90", 90.0),
+                          std::make_pair("p99", 99.0),
+                          std::make_pair("p999", 99.9)}) {
+      metric[p.first] = std::to_string(
+          static_cast<uint64_t>(histogram.Percentile(p.second)));
+    }
+    object[MetricName(m)] = std::move(metric);
+  }
+  return object;
+}
+
+}  // namespace grpc_core
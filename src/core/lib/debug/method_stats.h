@@ -0,0 +1,126 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_DEBUG_METHOD_STATS_H
+#define GRPC_CORE_LIB_DEBUG_METHOD_STATS_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/json/json.h"
+
+namespace grpc_core {
+
+// Latency and size histograms of the calls to one registered server method,
+// enabled with GRPC_ARG_SERVER_METHOD_STATS.
+//
+// Recording a call costs a handful of relaxed atomic increments on counters
+// sharded by CPU, so the stats are cheap enough to keep on in production.
+// Values are bucketed log-linearly: kSubBuckets buckets per power of two,
+// which bounds the error of a percentile to 25%.
+class MethodStats : public RefCounted<MethodStats> {
+ public:
+  enum Metric {
+    // From when the call's initial metadata arrived to when it was matched
+    // with a call requested by the application, in nanoseconds.
+    kQueueTime,
+    // From when the call was handed to the application to when it sent the
+    // status, in nanoseconds.
+    kHandlerTime,
+    // Message bytes received and sent on the call.
+    kBytesIn,
+    kBytesOut,
+    kNumMetrics,
+  };
+
+  static constexpr int kSubBuckets = 4;
+  // Values from 2^41 up share the last bucket.
+  static constexpr int kNumBuckets = 40 * kSubBuckets;
+
+  // Returns the bucket of \a value.
+  static int BucketFor(uint64_t value);
+  // Returns the smallest value in \a bucket.
+  static uint64_t BucketLowerBound(int bucket);
+
+  // The values recorded for one metric.
+  class Histogram {
+   public:
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t bucket(int i) const { return buckets_[i]; }
+    // Returns the value below which \a percentile percent of the values fall,
+    // interpolated within its bucket; 0 when there are none.
+    double Percentile(double percentile) const;
+
+   private:
+    friend class MethodStats;
+    friend class WriteLatencyStats;
+
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t buckets_[kNumBuckets] = {};
+  };
+
+  struct Snapshot {
+    Histogram metrics[kNumMetrics];
+  };
+
+  MethodStats(std::string method, std::string host);
+
+  const std::string& method() const { return method_; }
+  const std::string& host() const { return host_; }
+
+  void RecordCall(uint64_t queue_time_ns, uint64_t handler_time_ns,
+                  uint64_t bytes_in, uint64_t bytes_out);
+
+  // Sums the shards. Calls recorded concurrently may be partially included.
+  Snapshot GetSnapshot() const;
+
+  // Renders the count and percentiles of each metric for channelz.
+  Json RenderJson() const;
+
+ private:
+  struct Shard {
+    std::atomic<uint64_t> sums[kNumMetrics];
+    std::atomic<uint64_t> buckets[kNumMetrics][kNumBuckets];
+    // Keeps the next shard's counters off our last cache line.
+    char padding[GPR_CACHELINE_SIZE];
+  };
+
+  void Record(Shard* shard, Metric metric, uint64_t value) {
+    shard->sums[metric].fetch_add(value, std::memory_order_relaxed);
+    shard->buckets[metric][BucketFor(value)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  const std::string method_;
+  const std::string host_;
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_DEBUG_METHOD_STATS_H */
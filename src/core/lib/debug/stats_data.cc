@@ -125,6 +125,13 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "cq_ev_queue_trylock_failures",
     "cq_ev_queue_trylock_successes",
     "cq_ev_queue_transient_pop_failures",
+    "message_compression_compressed",
+    "message_compression_skipped",
+    "message_compression_bytes_saved",
+    "message_compression_cpu_us",
+    "http2_data_frames_in_place",
+    "http2_data_frames_resliced",
+    "http2_message_prefixes_in_place",
 };
 const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of client side calls created by this process",
@@ -252,6 +259,16 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "queue.",
     "Number of times NULL was popped out of completion queue's event queue "
     "even though the event queue was not empty",
+    "Number of messages compressed by the message_compress filter",
+    "Number of messages adaptive message compression decided not to compress",
+    "Number of bytes saved by message compression",
+    "Microseconds of CPU time spent compressing messages",
+    "Number of HTTP2 data frames sent as a single slice, with the frame header "
+    "written in the headroom of the payload",
+    "Number of HTTP2 data frames sent with the frame header in a slice of its "
+    "own",
+    "Number of message prefixes written in the headroom of the first slice of "
+    "their message",
 };
 const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "call_initial_size",
@@ -126,6 +126,13 @@ typedef enum {
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_COMPRESSED,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_SKIPPED,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_BYTES_SAVED,
+  GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_CPU_US,
+  GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_IN_PLACE,
+  GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_RESLICED,
+  GRPC_STATS_COUNTER_HTTP2_MESSAGE_PREFIXES_IN_PLACE,
   GRPC_STATS_COUNTER_COUNT
 } grpc_stats_counters;
 extern const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT];
@@ -396,6 +403,20 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES)
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_COMPRESSED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_COMPRESSED)
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_SKIPPED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_SKIPPED)
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_BYTES_SAVED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_BYTES_SAVED)
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_CPU_US() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_MESSAGE_COMPRESSION_CPU_US)
+#define GRPC_STATS_INC_HTTP2_DATA_FRAMES_IN_PLACE() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_IN_PLACE)
+#define GRPC_STATS_INC_HTTP2_DATA_FRAMES_RESLICED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_RESLICED)
+#define GRPC_STATS_INC_HTTP2_MESSAGE_PREFIXES_IN_PLACE() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_MESSAGE_PREFIXES_IN_PLACE)
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value) \
   grpc_stats_inc_call_initial_size((int)(value))
 void grpc_stats_inc_call_initial_size(int value);
@@ -534,6 +555,13 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES()
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_COMPRESSED()
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_SKIPPED()
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_BYTES_SAVED()
+#define GRPC_STATS_INC_MESSAGE_COMPRESSION_CPU_US()
+#define GRPC_STATS_INC_HTTP2_DATA_FRAMES_IN_PLACE()
+#define GRPC_STATS_INC_HTTP2_DATA_FRAMES_RESLICED()
+#define GRPC_STATS_INC_HTTP2_MESSAGE_PREFIXES_IN_PLACE()
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value)
 #define GRPC_STATS_INC_POLL_EVENTS_RETURNED(value)
 #define GRPC_STATS_INC_TCP_WRITE_SIZE(value)
@@ -33,6 +33,7 @@
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/gprpp/contention_profiler.h"
 #include "src/core/lib/profiling/timers.h"
 
 #ifdef GPR_LOW_LEVEL_COUNTERS
@@ -53,12 +54,14 @@ void gpr_mu_destroy(gpr_mu* mu) {
 
 void gpr_mu_lock(gpr_mu* mu) ABSL_NO_THREAD_SAFETY_ANALYSIS {
   GPR_TIMER_SCOPE("gpr_mu_lock", 0);
-  reinterpret_cast<absl::Mutex*>(mu)->Lock();
+  grpc_core::ContentionProfiler::Lock(
+      reinterpret_cast<absl::Mutex*>(mu),
+      grpc_core::LockSite{nullptr, 0, GRPC_LOCK_SITE_CALLER_PC});
 }
 
 void gpr_mu_unlock(gpr_mu* mu) ABSL_NO_THREAD_SAFETY_ANALYSIS {
   GPR_TIMER_SCOPE("gpr_mu_unlock", 0);
-  reinterpret_cast<absl::Mutex*>(mu)->Unlock();
+  grpc_core::ContentionProfiler::Unlock(reinterpret_cast<absl::Mutex*>(mu));
 }
 
 int gpr_mu_trylock(gpr_mu* mu) {
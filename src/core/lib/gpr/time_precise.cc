@@ -22,6 +22,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #endif
+#ifdef GPR_POSIX_TIME
+#include <time.h>
+#endif
 
 #include <algorithm>
 
@@ -166,3 +169,15 @@ gpr_timespec gpr_cycle_counter_sub(gpr_cycle_counter a, gpr_cycle_counter b) {
 }
 #endif /* GPR_CYCLE_COUNTER_FALLBACK */
 #endif /* !GPR_CYCLE_COUNTER_CUSTOM */
+
+int64_t gpr_thread_cpu_time_ns(void) {
+#if defined(GPR_POSIX_TIME) && defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return static_cast<int64_t>(ts.tv_sec) * GPR_NS_PER_SEC + ts.tv_nsec;
+  }
+#endif
+  gpr_timespec now;
+  gpr_precise_clock_now(&now);
+  return now.tv_sec * GPR_NS_PER_SEC + now.tv_nsec;
+}
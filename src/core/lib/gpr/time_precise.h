@@ -67,4 +67,8 @@ void gpr_precise_clock_now(gpr_timespec* clk);
 gpr_timespec gpr_cycle_counter_to_time(gpr_cycle_counter cycles);
 gpr_timespec gpr_cycle_counter_sub(gpr_cycle_counter a, gpr_cycle_counter b);
 
+// CPU time used by the calling thread, in nanoseconds. Platforms without a
+// per-thread CPU clock return the precise wall clock instead.
+int64_t gpr_thread_cpu_time_ns(void);
+
 #endif /* GRPC_CORE_LIB_GPR_TIME_PRECISE_H */
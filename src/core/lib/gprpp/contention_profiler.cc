@@ -0,0 +1,346 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/gprpp/contention_profiler.h"
+
+#include <string.h>
+
+#ifdef GPR_POSIX_SYNC
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gprpp/global_config.h"
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_contention_profile, 0,
+    "If positive, profile lock contention, sampling one in this many lock "
+    "acquisitions, and log the report at grpc_shutdown().");
+
+namespace grpc_core {
+
+namespace {
+
+// Sites beyond this many are lumped together in the last entry.
+constexpr size_t kMaxSites = 4096;
+// Sampled locks a thread may hold at once.
+constexpr int kMaxHeld = 8;
+
+// The profile of one site. The table has static storage, so it is usable
+// from the first lock acquisition on, without any lock of its own.
+struct Site {
+  // 0: free, 1: being claimed, 2: key set.
+  std::atomic<int> state;
+  const char* file;
+  int line;
+  const void* pc;
+  std::atomic<uint64_t> acquisitions;
+  std::atomic<uint64_t> contended;
+  std::atomic<uint64_t> wait_ns;
+  std::atomic<uint64_t> max_wait_ns;
+  std::atomic<uint64_t> hold_ns;
+  std::atomic<uint64_t> max_hold_ns;
+};
+
+Site g_sites[kMaxSites];
+std::atomic<uint32_t> g_sampling_period{1};
+// Bumped by Enable(), so that samples held across a Disable() are dropped.
+std::atomic<uint32_t> g_generation{0};
+
+struct ThreadState {
+  uint32_t countdown;
+  int num_held;
+  struct Held {
+    const void* mu;
+    Site* site;
+    gpr_cycle_counter acquired;
+    uint32_t generation;
+  } held[kMaxHeld];
+  // Keeps the states reachable: they live as long as the process.
+  ThreadState* next;
+  // Next in g_free_states.
+  ThreadState* next_free = nullptr;
+};
+
+std::atomic<ThreadState*> g_thread_states{nullptr};
+// States of the threads that exited, for the next threads to reuse.
+gpr_mu g_free_states_mu;
+ThreadState* g_free_states = nullptr;
+gpr_once g_free_states_once = GPR_ONCE_INIT;
+#ifdef GPR_POSIX_SYNC
+// Its destructor returns the state of an exiting thread to g_free_states.
+pthread_key_t g_thread_state_key;
+#endif
+GPR_THREAD_LOCAL(ThreadState*) g_thread_state;
+// Set when the thread can't have a state anymore, and while it gets one:
+// locking g_free_states_mu comes back to the profiler.
+GPR_THREAD_LOCAL(bool) g_no_thread_state;
+
+#ifdef GPR_POSIX_SYNC
+void ReleaseThreadState(void* arg) {
+  ThreadState* state = static_cast<ThreadState*>(arg);
+  // Whatever the thread locks from now on is not sampled.
+  g_thread_state = nullptr;
+  g_no_thread_state = true;
+  state->num_held = 0;
+  gpr_mu_lock(&g_free_states_mu);
+  state->next_free = g_free_states;
+  g_free_states = state;
+  gpr_mu_unlock(&g_free_states_mu);
+}
+#endif
+
+void InitFreeStates() {
+  gpr_mu_init(&g_free_states_mu);
+#ifdef GPR_POSIX_SYNC
+  GPR_ASSERT(pthread_key_create(&g_thread_state_key, ReleaseThreadState) ==
+             0);
+#endif
+}
+
+// Returns nullptr while the thread can't have a state.
+ThreadState* GetThreadState() {
+  ThreadState* state = g_thread_state;
+  if (GPR_LIKELY(state != nullptr)) return state;
+  if (g_no_thread_state) return nullptr;
+  g_no_thread_state = true;
+  gpr_once_init(&g_free_states_once, InitFreeStates);
+  gpr_mu_lock(&g_free_states_mu);
+  state = g_free_states;
+  if (state != nullptr) g_free_states = state->next_free;
+  gpr_mu_unlock(&g_free_states_mu);
+  if (state == nullptr) {
+    state = new ThreadState();
+    state->next = g_thread_states.load(std::memory_order_relaxed);
+    while (!g_thread_states.compare_exchange_weak(
+        state->next, state, std::memory_order_release,
+        std::memory_order_relaxed)) {
+    }
+  }
+  // Start each thread at a different point of the period, so that threads
+  // running the same loop don't sample the same acquisitions.
+  state->countdown =
+      1 + (reinterpret_cast<uintptr_t>(state) >> 4) %
+              g_sampling_period.load(std::memory_order_relaxed);
+#ifdef GPR_POSIX_SYNC
+  pthread_setspecific(g_thread_state_key, state);
+#endif
+  g_no_thread_state = false;
+  g_thread_state = state;
+  return state;
+}
+
+Site* FindSite(const LockSite& key) {
+  constexpr size_t kTableSize = kMaxSites - 1;
+  size_t hash = (reinterpret_cast<uintptr_t>(key.file) >> 3) * 31 +
+                static_cast<size_t>(key.line) * 17 +
+                (reinterpret_cast<uintptr_t>(key.pc) >> 2);
+  for (size_t probe = 0; probe < kTableSize; ++probe) {
+    Site* site = &g_sites[(hash + probe) % kTableSize];
+    int state = site->state.load(std::memory_order_acquire);
+    if (state == 0 && site->state.compare_exchange_strong(
+                          state, 1, std::memory_order_acq_rel)) {
+      site->file = key.file;
+      site->line = key.line;
+      site->pc = key.pc;
+      site->state.store(2, std::memory_order_release);
+      return site;
+    }
+    while (state == 1) state = site->state.load(std::memory_order_acquire);
+    if (site->file == key.file && site->line == key.line &&
+        site->pc == key.pc) {
+      return site;
+    }
+  }
+  return &g_sites[kMaxSites - 1];
+}
+
+uint64_t NanosSince(gpr_cycle_counter start, gpr_cycle_counter end) {
+  gpr_timespec elapsed = gpr_cycle_counter_sub(end, start);
+  if (elapsed.tv_sec < 0) return 0;
+  return static_cast<uint64_t>(elapsed.tv_sec) * GPR_NS_PER_SEC +
+         elapsed.tv_nsec;
+}
+
+void UpdateMax(std::atomic<uint64_t>* max, uint64_t value) {
+  uint64_t current = max->load(std::memory_order_relaxed);
+  while (current < value && !max->compare_exchange_weak(
+                                current, value, std::memory_order_relaxed)) {
+  }
+}
+
+std::string SiteName(const Site& site) {
+  if (&site == &g_sites[kMaxSites - 1]) return "(other sites)";
+  if (site.file != nullptr) return absl::StrCat(site.file, ":", site.line);
+  if (site.pc != nullptr) return absl::StrFormat("gpr_mu_lock() from %p", site.pc);
+  return "(unknown site)";
+}
+
+}  // namespace
+
+std::atomic<bool> ContentionProfiler::enabled_{false};
+
+void ContentionProfiler::Enable(uint32_t sampling_period) {
+  g_sampling_period.store(std::max(sampling_period, 1u),
+                          std::memory_order_relaxed);
+  g_generation.fetch_add(1, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void ContentionProfiler::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+void ContentionProfiler::Reset() {
+  for (Site& site : g_sites) {
+    site.acquisitions.store(0, std::memory_order_relaxed);
+    site.contended.store(0, std::memory_order_relaxed);
+    site.wait_ns.store(0, std::memory_order_relaxed);
+    site.max_wait_ns.store(0, std::memory_order_relaxed);
+    site.hold_ns.store(0, std::memory_order_relaxed);
+    site.max_hold_ns.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool ContentionProfiler::ShouldSample() {
+  ThreadState* state = GetThreadState();
+  if (state == nullptr) return false;
+  if (state->countdown > 1) {
+    --state->countdown;
+    return false;
+  }
+  state->countdown = g_sampling_period.load(std::memory_order_relaxed);
+  return true;
+}
+
+void ContentionProfiler::RecordAcquired(const void* mu, const LockSite& key,
+                                        gpr_cycle_counter start,
+                                        bool contended) {
+  gpr_cycle_counter now = gpr_get_cycle_counter();
+  Site* site = FindSite(key);
+  site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+  if (contended) {
+    uint64_t wait_ns = NanosSince(start, now);
+    site->contended.fetch_add(1, std::memory_order_relaxed);
+    site->wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    UpdateMax(&site->max_wait_ns, wait_ns);
+  }
+  ThreadState* state = GetThreadState();
+  if (state == nullptr) return;
+  // A thread that released its locks elsewhere, or from another thread, can
+  // fill its slots up: recycle the oldest.
+  if (state->num_held == kMaxHeld) {
+    std::copy(state->held + 1, state->held + kMaxHeld, state->held);
+    --state->num_held;
+  }
+  state->held[state->num_held++] = {
+      mu, site, now, g_generation.load(std::memory_order_relaxed)};
+}
+
+void ContentionProfiler::RecordReleased(const void* mu) {
+  ThreadState* state = g_thread_state;
+  if (state == nullptr || state->num_held == 0) return;
+  uint32_t generation = g_generation.load(std::memory_order_relaxed);
+  for (int i = state->num_held - 1; i >= 0; --i) {
+    ThreadState::Held& held = state->held[i];
+    if (held.mu != mu) continue;
+    if (held.generation == generation) {
+      uint64_t hold_ns = NanosSince(held.acquired, gpr_get_cycle_counter());
+      held.site->hold_ns.fetch_add(hold_ns, std::memory_order_relaxed);
+      UpdateMax(&held.site->max_hold_ns, hold_ns);
+    }
+    std::copy(state->held + i + 1, state->held + state->num_held,
+              state->held + i);
+    --state->num_held;
+    return;
+  }
+}
+
+std::vector<ContentionProfiler::SiteStats> ContentionProfiler::GetStats() {
+  const uint64_t period = g_sampling_period.load(std::memory_order_relaxed);
+  // The same site may have several entries when its file name is a different
+  // string in different translation units.
+  std::map<std::string, SiteStats> stats_by_name;
+  for (const Site& site : g_sites) {
+    uint64_t acquisitions = site.acquisitions.load(std::memory_order_relaxed);
+    if (acquisitions == 0) continue;
+    std::string name = SiteName(site);
+    SiteStats& stats = stats_by_name[name];
+    stats.site = std::move(name);
+    stats.acquisitions += acquisitions * period;
+    stats.contended +=
+        site.contended.load(std::memory_order_relaxed) * period;
+    stats.wait_ns += site.wait_ns.load(std::memory_order_relaxed) * period;
+    stats.max_wait_ns =
+        std::max(stats.max_wait_ns,
+                 site.max_wait_ns.load(std::memory_order_relaxed));
+    stats.hold_ns += site.hold_ns.load(std::memory_order_relaxed) * period;
+    stats.max_hold_ns =
+        std::max(stats.max_hold_ns,
+                 site.max_hold_ns.load(std::memory_order_relaxed));
+  }
+  std::vector<SiteStats> result;
+  for (auto& p : stats_by_name) result.push_back(std::move(p.second));
+  std::sort(result.begin(), result.end(),
+            [](const SiteStats& a, const SiteStats& b) {
+              return std::tie(a.wait_ns, a.hold_ns) >
+                     std::tie(b.wait_ns, b.hold_ns);
+            });
+  return result;
+}
+
+std::string ContentionProfiler::Report() {
+  std::string report = absl::StrFormat(
+      "Lock contention profile, sampling 1 in %d acquisitions:\n"
+      "%10s %10s %12s %12s %12s %12s  %s\n",
+      g_sampling_period.load(std::memory_order_relaxed), "wait ms",
+      "hold ms", "contended", "acquired", "max wait us", "max hold us",
+      "site");
+  for (const SiteStats& stats : GetStats()) {
+    absl::StrAppendFormat(&report, "%10.3f %10.3f %12d %12d %12.1f %12.1f  %s\n",
+                          stats.wait_ns / 1e6, stats.hold_ns / 1e6,
+                          stats.contended, stats.acquisitions,
+                          stats.max_wait_ns / 1e3, stats.max_hold_ns / 1e3,
+                          stats.site);
+  }
+  return report;
+}
+
+void ContentionProfiler::InitFromEnvironment() {
+  int32_t sampling_period = GPR_GLOBAL_CONFIG_GET(grpc_contention_profile);
+  if (sampling_period > 0) Enable(sampling_period);
+}
+
+void ContentionProfiler::LogReportIfEnabled() {
+  if (!enabled()) return;
+  gpr_log(GPR_INFO, "%s", Report().c_str());
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,140 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_GPRPP_CONTENTION_PROFILER_H
+#define GRPC_CORE_LIB_GPRPP_CONTENTION_PROFILER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "absl/base/config.h"
+#include "absl/base/thread_annotations.h"
+
+#include "src/core/lib/gpr/time_precise.h"
+
+// The lock guards of sync.h take the location of their caller as default
+// arguments. DebugLocation is empty in opt builds, so this uses the builtins
+// absl::SourceLocation is built on; sites are unknown without them.
+#if ABSL_HAVE_BUILTIN(__builtin_FILE) || \
+    (defined(__GNUC__) && !defined(__clang__))
+#define GRPC_LOCK_SITE_FILE __builtin_FILE()
+#define GRPC_LOCK_SITE_LINE __builtin_LINE()
+#else
+#define GRPC_LOCK_SITE_FILE nullptr
+#define GRPC_LOCK_SITE_LINE 0
+#endif
+
+// The gpr_mu functions identify their caller by its return address.
+#if defined(__GNUC__) || defined(__clang__)
+#define GRPC_LOCK_SITE_CALLER_PC __builtin_return_address(0)
+#else
+#define GRPC_LOCK_SITE_CALLER_PC nullptr
+#endif
+
+namespace grpc_core {
+
+// Where a lock is acquired: a source location, or the address of the code
+// that called gpr_mu_lock().
+struct LockSite {
+  const char* file;
+  int line;
+  const void* pc;
+};
+
+// An opt-in, sampled profile of lock contention per acquisition site.
+//
+// When enabled, one in every sampling period acquisitions through the lock
+// guards of sync.h or gpr_mu_lock() is timed: how long it waited for the lock,
+// and how long the lock was then held. While disabled, locking costs one
+// relaxed load and a predictable branch more.
+//
+// Hold times include the time spent waiting on a condition variable with the
+// lock, since the wait releases the lock behind the profiler's back.
+class ContentionProfiler {
+ public:
+  // Totals for one site, estimated from the samples by multiplying them by
+  // the sampling period, except for the maxima.
+  struct SiteStats {
+    std::string site;
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0;
+    uint64_t wait_ns = 0;
+    uint64_t max_wait_ns = 0;
+    uint64_t hold_ns = 0;
+    uint64_t max_hold_ns = 0;
+  };
+
+  // Starts sampling one in \a sampling_period acquisitions.
+  static void Enable(uint32_t sampling_period);
+  static void Disable();
+  // Drops the samples taken so far.
+  static void Reset();
+
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Returns the sites sampled so far, longest total wait first.
+  static std::vector<SiteStats> GetStats();
+  // Returns GetStats() as a table.
+  static std::string Report();
+
+  // Enables the profiler if GRPC_CONTENTION_PROFILE is set.
+  static void InitFromEnvironment();
+  // Logs the report if the profiler is enabled.
+  static void LogReportIfEnabled();
+
+  // Hooks for the lock implementations: M must have Lock(), TryLock() and
+  // Unlock().
+  template <typename M>
+  static void Lock(M* mu, const LockSite& site)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    if (GPR_LIKELY(!enabled()) || !ShouldSample()) {
+      mu->Lock();
+      return;
+    }
+    gpr_cycle_counter start = gpr_get_cycle_counter();
+    bool contended = !mu->TryLock();
+    if (contended) mu->Lock();
+    RecordAcquired(mu, site, start, contended);
+  }
+
+  template <typename M>
+  static void Unlock(M* mu) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    if (GPR_UNLIKELY(enabled())) RecordReleased(mu);
+    mu->Unlock();
+  }
+
+  // Counts down to the next sample on this thread. Only call when enabled.
+  static bool ShouldSample();
+  // Records an acquisition of \a mu that started at \a start.
+  static void RecordAcquired(const void* mu, const LockSite& site,
+                             gpr_cycle_counter start, bool contended);
+  // Records the hold time of \a mu if its acquisition was sampled.
+  static void RecordReleased(const void* mu);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_GPRPP_CONTENTION_PROFILER_H */
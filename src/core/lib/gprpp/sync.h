@@ -27,6 +27,7 @@
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/gprpp/contention_profiler.h"
 #include "src/core/lib/gprpp/time_util.h"
 
 // The core library is not accessible in C++ codegen headers, and vice versa.
@@ -43,8 +44,6 @@ namespace grpc_core {
 #ifdef GPR_ABSEIL_SYNC
 
 using Mutex = absl::Mutex;
-using MutexLock = absl::MutexLock;
-using ReleasableMutexLock = absl::ReleasableMutexLock;
 using CondVar = absl::CondVar;
 
 // Returns the underlying gpr_mu from Mutex. This should be used only when
@@ -83,12 +82,42 @@ class ABSL_LOCKABLE Mutex {
 // TODO(veblush): Remove this after C-core no longer uses gpr_mu.
 inline gpr_mu* GetUnderlyingGprMu(Mutex* mutex) { return &mutex->mu_; }
 
+class CondVar {
+ public:
+  CondVar() { gpr_cv_init(&cv_); }
+  ~CondVar() { gpr_cv_destroy(&cv_); }
+
+  CondVar(const CondVar&) = delete;
+  CondVar& operator=(const CondVar&) = delete;
+
+  void Signal() { gpr_cv_signal(&cv_); }
+  void SignalAll() { gpr_cv_broadcast(&cv_); }
+
+  void Wait(Mutex* mu) { WaitWithDeadline(mu, absl::InfiniteFuture()); }
+  bool WaitWithTimeout(Mutex* mu, absl::Duration timeout) {
+    return gpr_cv_wait(&cv_, &mu->mu_, ToGprTimeSpec(timeout)) != 0;
+  }
+  bool WaitWithDeadline(Mutex* mu, absl::Time deadline) {
+    return gpr_cv_wait(&cv_, &mu->mu_, ToGprTimeSpec(deadline)) != 0;
+  }
+
+ private:
+  gpr_cv cv_;
+};
+
+#endif  // GPR_ABSEIL_SYNC
+
+// The lock guards report the acquisitions of their callers to the
+// ContentionProfiler when it is enabled.
 class ABSL_SCOPED_LOCKABLE MutexLock {
  public:
-  explicit MutexLock(Mutex* mu) ABSL_EXCLUSIVE_LOCK_FUNCTION(mu) : mu_(mu) {
-    mu_->Lock();
+  explicit MutexLock(Mutex* mu, const char* file = GRPC_LOCK_SITE_FILE,
+                     int line = GRPC_LOCK_SITE_LINE)
+      ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
+      : mu_(mu) {
+    ContentionProfiler::Lock(mu_, LockSite{file, line, nullptr});
   }
-  ~MutexLock() ABSL_UNLOCK_FUNCTION() { mu_->Unlock(); }
+  ~MutexLock() ABSL_UNLOCK_FUNCTION() { ContentionProfiler::Unlock(mu_); }
 
   MutexLock(const MutexLock&) = delete;
   MutexLock& operator=(const MutexLock&) = delete;
@@ -99,12 +128,15 @@ class ABSL_SCOPED_LOCKABLE MutexLock {
 
 class ABSL_SCOPED_LOCKABLE ReleasableMutexLock {
  public:
-  explicit ReleasableMutexLock(Mutex* mu) ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
+  explicit ReleasableMutexLock(Mutex* mu,
+                               const char* file = GRPC_LOCK_SITE_FILE,
+                               int line = GRPC_LOCK_SITE_LINE)
+      ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
       : mu_(mu) {
-    mu_->Lock();
+    ContentionProfiler::Lock(mu_, LockSite{file, line, nullptr});
   }
   ~ReleasableMutexLock() ABSL_UNLOCK_FUNCTION() {
-    if (!released_) mu_->Unlock();
+    if (!released_) ContentionProfiler::Unlock(mu_);
   }
 
   ReleasableMutexLock(const ReleasableMutexLock&) = delete;
@@ -113,7 +145,7 @@ class ABSL_SCOPED_LOCKABLE ReleasableMutexLock {
   void Release() ABSL_UNLOCK_FUNCTION() {
     GPR_DEBUG_ASSERT(!released_);
     released_ = true;
-    mu_->Unlock();
+    ContentionProfiler::Unlock(mu_);
   }
 
  private:
@@ -121,31 +153,6 @@ class ABSL_SCOPED_LOCKABLE ReleasableMutexLock {
   bool released_ = false;
 };
 
-class CondVar {
- public:
-  CondVar() { gpr_cv_init(&cv_); }
-  ~CondVar() { gpr_cv_destroy(&cv_); }
-
-  CondVar(const CondVar&) = delete;
-  CondVar& operator=(const CondVar&) = delete;
-
-  void Signal() { gpr_cv_signal(&cv_); }
-  void SignalAll() { gpr_cv_broadcast(&cv_); }
-
-  void Wait(Mutex* mu) { WaitWithDeadline(mu, absl::InfiniteFuture()); }
-  bool WaitWithTimeout(Mutex* mu, absl::Duration timeout) {
-    return gpr_cv_wait(&cv_, &mu->mu_, ToGprTimeSpec(timeout)) != 0;
-  }
-  bool WaitWithDeadline(Mutex* mu, absl::Time deadline) {
-    return gpr_cv_wait(&cv_, &mu->mu_, ToGprTimeSpec(deadline)) != 0;
-  }
-
- private:
-  gpr_cv cv_;
-};
-
-#endif  // GPR_ABSEIL_SYNC
-
 // Deprecated. Prefer MutexLock
 class MutexLockForGprMu {
  public:
@@ -162,13 +169,14 @@ class MutexLockForGprMu {
 // Deprecated. Prefer MutexLock or ReleasableMutexLock
 class ABSL_SCOPED_LOCKABLE LockableAndReleasableMutexLock {
  public:
-  explicit LockableAndReleasableMutexLock(Mutex* mu)
-      ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
-      : mu_(mu) {
-    mu_->Lock();
+  explicit LockableAndReleasableMutexLock(
+      Mutex* mu, const char* file = GRPC_LOCK_SITE_FILE,
+      int line = GRPC_LOCK_SITE_LINE) ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
+      : mu_(mu), site_{file, line, nullptr} {
+    ContentionProfiler::Lock(mu_, site_);
   }
   ~LockableAndReleasableMutexLock() ABSL_UNLOCK_FUNCTION() {
-    if (!released_) mu_->Unlock();
+    if (!released_) ContentionProfiler::Unlock(mu_);
   }
 
   LockableAndReleasableMutexLock(const LockableAndReleasableMutexLock&) =
@@ -178,18 +186,19 @@ class ABSL_SCOPED_LOCKABLE LockableAndReleasableMutexLock {
 
   void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() {
     GPR_DEBUG_ASSERT(released_);
-    mu_->Lock();
+    ContentionProfiler::Lock(mu_, site_);
     released_ = false;
   }
 
   void Release() ABSL_UNLOCK_FUNCTION() {
     GPR_DEBUG_ASSERT(!released_);
     released_ = true;
-    mu_->Unlock();
+    ContentionProfiler::Unlock(mu_);
   }
 
  private:
   Mutex* const mu_;
+  const LockSite site_;
   bool released_ = false;
 };
 
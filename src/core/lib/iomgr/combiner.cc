@@ -155,6 +155,10 @@ static void combiner_exec(grpc_core::Combiner* lock, grpc_closure* cl,
   }
   GPR_ASSERT(last & STATE_UNORPHANED);  // ensure lock has not been destroyed
   assert(cl->cb);
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    // links the closure to the thread holding the combiner that runs it
+    grpc_core::LatencyTracer::FlowStart("combiner.execute", cl);
+  }
   cl->error_data.error = error;
   lock->queue.Push(cl->next_data.mpscq_node.get());
 }
@@ -171,11 +175,17 @@ static void move_next() {
 
 static void offload(void* arg, grpc_error_handle /*error*/) {
   grpc_core::Combiner* lock = static_cast<grpc_core::Combiner*>(arg);
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    grpc_core::LatencyTracer::FlowEnd("combiner.offload", lock);
+  }
   push_last_on_exec_ctx(lock);
 }
 
 static void queue_offload(grpc_core::Combiner* lock) {
   GRPC_STATS_INC_COMBINER_LOCKS_OFFLOADED();
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    grpc_core::LatencyTracer::FlowStart("combiner.offload", lock);
+  }
   move_next();
   GRPC_COMBINER_TRACE(gpr_log(GPR_INFO, "C:%p queue_offload", lock));
   grpc_core::Executor::Run(&lock->offload, GRPC_ERROR_NONE);
@@ -232,6 +242,9 @@ bool grpc_combiner_continue_exec_ctx() {
     }
     GPR_TIMER_SCOPE("combiner.exec1", 0);
     grpc_closure* cl = reinterpret_cast<grpc_closure*>(n);
+    if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+      grpc_core::LatencyTracer::FlowEnd("combiner.execute", cl);
+    }
     grpc_error_handle cl_err = cl->error_data.error;
 #ifndef NDEBUG
     cl->scheduled = false;
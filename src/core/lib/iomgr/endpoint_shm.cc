@@ -0,0 +1,938 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+
+#include "src/core/lib/iomgr/endpoint_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/slice.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+// Older libc headers lack the file sealing API.
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS 1033
+#define F_GET_SEALS 1034
+#endif
+#ifndef F_SEAL_SEAL
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#endif
+
+namespace {
+
+constexpr uint64_t kSegmentMagic = 0x6d68732d63707267;  // "grpc-shm"
+constexpr uint32_t kHandshakeVersion = 1;
+// Each ring control block lives on its own page, ahead of the ring data.
+constexpr size_t kPageSize = 4096;
+constexpr size_t kMinRingSize = 4096;
+constexpr size_t kMaxRingSize = 1u << 30;
+// The peer maps the same segment, so it must not be able to resize it under
+// us: a shrunk segment would turn our accesses into SIGBUS.
+constexpr int kRequiredSeals = F_SEAL_SHRINK | F_SEAL_GROW;
+// Largest slice handed out by a single read.
+constexpr size_t kMaxReadSliceSize = 64 * 1024;
+
+// The client writes ring 0 and the server writes ring 1. Each ring has two
+// doorbells: one rung by the writer when it added data, one rung by the
+// reader when it freed space.
+constexpr int kNumRings = 2;
+constexpr int kNumDoorbells = 2 * kNumRings;
+// The segment is sent first, then the doorbells.
+constexpr int kNumHandshakeFds = 1 + kNumDoorbells;
+int DataDoorbell(int ring) { return 2 * ring; }
+int SpaceDoorbell(int ring) { return 2 * ring + 1; }
+
+// The peer can write anything into the segment, so each side keeps its own
+// position privately and only publishes it here; the position read from the
+// peer is checked against the ring size before it is used.
+struct RingControl {
+  // Total bytes ever written; only advanced by the writer.
+  alignas(64) std::atomic<uint64_t> head;
+  // Total bytes ever read; only advanced by the reader.
+  alignas(64) std::atomic<uint64_t> tail;
+  // Set by the reader (resp. writer) right before it sleeps on its doorbell.
+  alignas(64) std::atomic<uint32_t> reader_waiting;
+  std::atomic<uint32_t> writer_waiting;
+  // Set once either side went away.
+  std::atomic<uint32_t> closed;
+};
+static_assert(sizeof(RingControl) <= kPageSize, "ring control too large");
+
+struct SegmentHeader {
+  uint64_t magic;
+  uint64_t ring_size;
+};
+
+// Sent by the connecting side along with the segment and doorbell fds.
+struct HandshakeRequest {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t ring_size;
+};
+
+size_t SegmentSize(size_t ring_size) {
+  return kPageSize + kNumRings * (kPageSize + ring_size);
+}
+
+RingControl* RingControlAt(void* segment, size_t ring_size, int ring) {
+  return reinterpret_cast<RingControl*>(static_cast<char*>(segment) +
+                                        kPageSize +
+                                        ring * (kPageSize + ring_size));
+}
+
+char* RingDataAt(void* segment, size_t ring_size, int ring) {
+  return reinterpret_cast<char*>(RingControlAt(segment, ring_size, ring)) +
+         kPageSize;
+}
+
+size_t RoundUpRingSize(size_t ring_size) {
+  size_t size = kMinRingSize;
+  while (size < ring_size && size < kMaxRingSize) size <<= 1;
+  return size;
+}
+
+// Doorbells are non-blocking (see CheckDoorbell). EAGAIN means that the
+// counter is about to overflow, so the doorbell is already rung.
+void RingDoorbell(int fd) {
+  int r;
+  do {
+    r = eventfd_write(fd, 1);
+  } while (r < 0 && errno == EINTR);
+}
+
+void DrainDoorbell(grpc_fd* fd) {
+  eventfd_t value;
+  int r;
+  do {
+    r = eventfd_read(grpc_fd_wrapped_fd(fd), &value);
+  } while (r < 0 && errno == EINTR);
+}
+
+void CloseFds(int* fds, int count) {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) close(fds[i]);
+    fds[i] = -1;
+  }
+}
+
+// Creates the memfd backing a connection and its doorbells.
+grpc_error_handle CreateSegment(size_t ring_size, int* memfd,
+                                int doorbells[kNumDoorbells]) {
+  *memfd = -1;
+  for (int i = 0; i < kNumDoorbells; i++) doorbells[i] = -1;
+#ifdef SYS_memfd_create
+  *memfd = static_cast<int>(syscall(SYS_memfd_create, "grpc-shm",
+                                    1u /* MFD_CLOEXEC */ | MFD_ALLOW_SEALING));
+#else
+  errno = ENOSYS;
+#endif
+  if (*memfd < 0) return GRPC_OS_ERROR(errno, "memfd_create");
+  size_t size = SegmentSize(ring_size);
+  if (ftruncate(*memfd, static_cast<off_t>(size)) != 0) {
+    grpc_error_handle error = GRPC_OS_ERROR(errno, "ftruncate");
+    close(*memfd);
+    *memfd = -1;
+    return error;
+  }
+  if (fcntl(*memfd, F_ADD_SEALS, kRequiredSeals | F_SEAL_SEAL) != 0) {
+    grpc_error_handle error = GRPC_OS_ERROR(errno, "fcntl(F_ADD_SEALS)");
+    close(*memfd);
+    *memfd = -1;
+    return error;
+  }
+  void* segment =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, *memfd, 0);
+  if (segment == MAP_FAILED) {
+    grpc_error_handle error = GRPC_OS_ERROR(errno, "mmap");
+    close(*memfd);
+    *memfd = -1;
+    return error;
+  }
+  // The rings start zeroed, which is their initial state.
+  SegmentHeader* header = static_cast<SegmentHeader*>(segment);
+  header->magic = kSegmentMagic;
+  header->ring_size = ring_size;
+  munmap(segment, size);
+  for (int i = 0; i < kNumDoorbells; i++) {
+    doorbells[i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (doorbells[i] < 0) {
+      grpc_error_handle error = GRPC_OS_ERROR(errno, "eventfd");
+      CloseFds(doorbells, kNumDoorbells);
+      close(*memfd);
+      *memfd = -1;
+      return error;
+    }
+  }
+  return GRPC_ERROR_NONE;
+}
+
+struct grpc_shm_endpoint {
+  grpc_endpoint base;
+  grpc_core::RefCount refcount;
+
+  void* segment = nullptr;
+  size_t segment_size = 0;
+  size_t ring_size = 0;
+  RingControl* rx = nullptr;
+  char* rx_data = nullptr;
+  RingControl* tx = nullptr;
+  char* tx_data = nullptr;
+  // Our own positions in rx and tx; the copies in the segment are only
+  // published to the peer.
+  uint64_t rx_tail = 0;
+  uint64_t tx_head = 0;
+
+  // Rung by the peer when it wrote into rx.
+  grpc_fd* rx_data_fd = nullptr;
+  // Rung by the peer when it freed space in tx.
+  grpc_fd* tx_space_fd = nullptr;
+  // Doorbells of the peer.
+  int tx_data_doorbell = -1;
+  int rx_space_doorbell = -1;
+
+  std::atomic<bool> shutdown{false};
+
+  grpc_closure read_done_closure;
+  grpc_closure* read_cb = nullptr;
+  grpc_slice_buffer* incoming_buffer = nullptr;
+
+  grpc_closure write_done_closure;
+  grpc_closure* write_cb = nullptr;
+  grpc_slice_buffer* outgoing_buffer = nullptr;
+  size_t outgoing_slice_idx = 0;
+  size_t outgoing_byte_idx = 0;
+
+  std::string peer_string;
+  std::string local_address;
+};
+
+void CopyIntoRing(grpc_shm_endpoint* ep, uint64_t pos, const uint8_t* src,
+                  size_t length) {
+  size_t offset = pos & (ep->ring_size - 1);
+  size_t first = std::min(length, ep->ring_size - offset);
+  memcpy(ep->tx_data + offset, src, first);
+  memcpy(ep->tx_data, src + first, length - first);
+}
+
+void CopyFromRing(grpc_shm_endpoint* ep, uint64_t pos, uint8_t* dst,
+                  size_t length) {
+  size_t offset = pos & (ep->ring_size - 1);
+  size_t first = std::min(length, ep->ring_size - offset);
+  memcpy(dst, ep->rx_data + offset, first);
+  memcpy(dst + first, ep->rx_data, length - first);
+}
+
+grpc_error_handle shm_annotate_error(grpc_error_handle error,
+                                     grpc_shm_endpoint* ep) {
+  return grpc_error_set_str(
+      grpc_error_set_int(error, GRPC_ERROR_INT_GRPC_STATUS,
+                         GRPC_STATUS_UNAVAILABLE),
+      GRPC_ERROR_STR_TARGET_ADDRESS,
+      grpc_slice_from_copied_string(ep->peer_string.c_str()));
+}
+
+void shm_free(grpc_shm_endpoint* ep) {
+  grpc_fd_orphan(ep->rx_data_fd, nullptr, nullptr, "shm_endpoint");
+  grpc_fd_orphan(ep->tx_space_fd, nullptr, nullptr, "shm_endpoint");
+  close(ep->tx_data_doorbell);
+  close(ep->rx_space_doorbell);
+  munmap(ep->segment, ep->segment_size);
+  delete ep;
+}
+
+void shm_ref(grpc_shm_endpoint* ep) { ep->refcount.Ref(); }
+
+void shm_unref(grpc_shm_endpoint* ep) {
+  if (GPR_UNLIKELY(ep->refcount.Unref())) shm_free(ep);
+}
+
+// Marks both rings closed and wakes the peer up, so that it sees EOF.
+void shm_close_rings(grpc_shm_endpoint* ep) {
+  ep->tx->closed.store(1, std::memory_order_seq_cst);
+  ep->rx->closed.store(1, std::memory_order_seq_cst);
+  RingDoorbell(ep->tx_data_doorbell);
+  RingDoorbell(ep->rx_space_doorbell);
+}
+
+// Shuts the endpoint down for good: closes the rings and fails whatever
+// operation is pending on our side, whether or not anyone still polls the
+// doorbells. Takes ownership of \a why.
+void shm_fail(grpc_shm_endpoint* ep, grpc_error_handle why) {
+  if (!ep->shutdown.exchange(true, std::memory_order_acq_rel)) {
+    shm_close_rings(ep);
+    grpc_fd_shutdown(ep->rx_data_fd, GRPC_ERROR_REF(why));
+    grpc_fd_shutdown(ep->tx_space_fd, GRPC_ERROR_REF(why));
+  }
+  GRPC_ERROR_UNREF(why);
+}
+
+void shm_finish_read(grpc_shm_endpoint* ep, grpc_error_handle error) {
+  grpc_closure* cb = ep->read_cb;
+  ep->read_cb = nullptr;
+  ep->incoming_buffer = nullptr;
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, cb, error);
+  shm_unref(ep);
+}
+
+void shm_do_read(grpc_shm_endpoint* ep) {
+  RingControl* rx = ep->rx;
+  while (true) {
+    if (ep->shutdown.load(std::memory_order_acquire)) {
+      shm_finish_read(
+          ep, shm_annotate_error(
+                  GRPC_ERROR_CREATE_FROM_STATIC_STRING("Endpoint shutdown"),
+                  ep));
+      return;
+    }
+    uint64_t tail = ep->rx_tail;
+    uint64_t head = rx->head.load(std::memory_order_acquire);
+    if (head - tail > ep->ring_size) {
+      grpc_error_handle error = shm_annotate_error(
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+              "Peer corrupted the receive ring"),
+          ep);
+      shm_fail(ep, GRPC_ERROR_REF(error));
+      shm_finish_read(ep, error);
+      return;
+    }
+    if (head != tail) {
+      for (uint64_t pos = tail; pos != head;) {
+        size_t length = static_cast<size_t>(
+            std::min<uint64_t>(head - pos, kMaxReadSliceSize));
+        grpc_slice slice = GRPC_SLICE_MALLOC(length);
+        CopyFromRing(ep, pos, GRPC_SLICE_START_PTR(slice), length);
+        grpc_slice_buffer_add(ep->incoming_buffer, slice);
+        pos += length;
+      }
+      ep->rx_tail = head;
+      rx->tail.store(head, std::memory_order_seq_cst);
+      if (rx->writer_waiting.load(std::memory_order_seq_cst) != 0 &&
+          rx->writer_waiting.exchange(0, std::memory_order_seq_cst) != 0) {
+        RingDoorbell(ep->rx_space_doorbell);
+      }
+      shm_finish_read(ep, GRPC_ERROR_NONE);
+      return;
+    }
+    if (rx->closed.load(std::memory_order_acquire) != 0) {
+      shm_finish_read(
+          ep, shm_annotate_error(
+                  GRPC_ERROR_CREATE_FROM_STATIC_STRING("Socket closed"), ep));
+      return;
+    }
+    // Announce that we are going to sleep, then look again: either we see
+    // the data written meanwhile or the writer sees the flag and rings.
+    rx->reader_waiting.store(1, std::memory_order_seq_cst);
+    if (rx->head.load(std::memory_order_seq_cst) != tail ||
+        rx->closed.load(std::memory_order_seq_cst) != 0) {
+      rx->reader_waiting.store(0, std::memory_order_relaxed);
+      continue;
+    }
+    grpc_fd_notify_on_read(ep->rx_data_fd, &ep->read_done_closure);
+    return;
+  }
+}
+
+void shm_handle_read(void* arg, grpc_error_handle error) {
+  grpc_shm_endpoint* ep = static_cast<grpc_shm_endpoint*>(arg);
+  if (error != GRPC_ERROR_NONE) {
+    grpc_slice_buffer_reset_and_unref_internal(ep->incoming_buffer);
+    shm_finish_read(ep, GRPC_ERROR_REF(error));
+    return;
+  }
+  DrainDoorbell(ep->rx_data_fd);
+  shm_do_read(ep);
+}
+
+void shm_read(grpc_endpoint* ep, grpc_slice_buffer* incoming_buffer,
+              grpc_closure* cb, bool /*urgent*/) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  GPR_ASSERT(shm->read_cb == nullptr);
+  shm->read_cb = cb;
+  shm->incoming_buffer = incoming_buffer;
+  grpc_slice_buffer_reset_and_unref_internal(incoming_buffer);
+  shm_ref(shm);
+  shm_do_read(shm);
+}
+
+void shm_finish_write(grpc_shm_endpoint* ep, grpc_error_handle error) {
+  grpc_closure* cb = ep->write_cb;
+  grpc_slice_buffer_reset_and_unref_internal(ep->outgoing_buffer);
+  ep->write_cb = nullptr;
+  ep->outgoing_buffer = nullptr;
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, cb, error);
+  shm_unref(ep);
+}
+
+void shm_do_write(grpc_shm_endpoint* ep) {
+  RingControl* tx = ep->tx;
+  grpc_slice_buffer* outgoing = ep->outgoing_buffer;
+  while (true) {
+    if (ep->shutdown.load(std::memory_order_acquire)) {
+      shm_finish_write(
+          ep, shm_annotate_error(
+                  GRPC_ERROR_CREATE_FROM_STATIC_STRING("Endpoint shutdown"),
+                  ep));
+      return;
+    }
+    if (tx->closed.load(std::memory_order_acquire) != 0) {
+      shm_finish_write(
+          ep, shm_annotate_error(
+                  GRPC_ERROR_CREATE_FROM_STATIC_STRING("Socket closed"), ep));
+      return;
+    }
+    uint64_t head = ep->tx_head;
+    uint64_t tail = tx->tail.load(std::memory_order_acquire);
+    // Also catches a tail ahead of head, as the difference wraps around.
+    if (head - tail > ep->ring_size) {
+      grpc_error_handle error = shm_annotate_error(
+          GRPC_ERROR_CREATE_FROM_STATIC_STRING("Peer corrupted the send ring"),
+          ep);
+      shm_fail(ep, GRPC_ERROR_REF(error));
+      shm_finish_write(ep, error);
+      return;
+    }
+    size_t space = ep->ring_size - static_cast<size_t>(head - tail);
+    uint64_t new_head = head;
+    while (space > 0 && ep->outgoing_slice_idx != outgoing->count) {
+      const grpc_slice& slice = outgoing->slices[ep->outgoing_slice_idx];
+      size_t length = std::min(
+          GRPC_SLICE_LENGTH(slice) - ep->outgoing_byte_idx, space);
+      CopyIntoRing(ep, new_head,
+                   GRPC_SLICE_START_PTR(slice) + ep->outgoing_byte_idx,
+                   length);
+      new_head += length;
+      space -= length;
+      ep->outgoing_byte_idx += length;
+      if (ep->outgoing_byte_idx == GRPC_SLICE_LENGTH(slice)) {
+        ep->outgoing_slice_idx++;
+        ep->outgoing_byte_idx = 0;
+      }
+    }
+    if (new_head != head) {
+      ep->tx_head = new_head;
+      tx->head.store(new_head, std::memory_order_seq_cst);
+      if (tx->reader_waiting.load(std::memory_order_seq_cst) != 0 &&
+          tx->reader_waiting.exchange(0, std::memory_order_seq_cst) != 0) {
+        RingDoorbell(ep->tx_data_doorbell);
+      }
+    }
+    if (ep->outgoing_slice_idx == outgoing->count) {
+      shm_finish_write(ep, GRPC_ERROR_NONE);
+      return;
+    }
+    // The ring is full: wait for the reader to free some space, with the
+    // same announce-then-recheck protocol as the reader.
+    tx->writer_waiting.store(1, std::memory_order_seq_cst);
+    if (tx->tail.load(std::memory_order_seq_cst) != tail ||
+        tx->closed.load(std::memory_order_seq_cst) != 0) {
+      tx->writer_waiting.store(0, std::memory_order_relaxed);
+      continue;
+    }
+    grpc_fd_notify_on_read(ep->tx_space_fd, &ep->write_done_closure);
+    return;
+  }
+}
+
+void shm_handle_write(void* arg, grpc_error_handle error) {
+  grpc_shm_endpoint* ep = static_cast<grpc_shm_endpoint*>(arg);
+  if (error != GRPC_ERROR_NONE) {
+    shm_finish_write(ep, GRPC_ERROR_REF(error));
+    return;
+  }
+  DrainDoorbell(ep->tx_space_fd);
+  shm_do_write(ep);
+}
+
+void shm_write(grpc_endpoint* ep, grpc_slice_buffer* buf, grpc_closure* cb,
+               void* /*arg*/) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  GPR_ASSERT(shm->write_cb == nullptr);
+  shm->write_cb = cb;
+  shm->outgoing_buffer = buf;
+  shm->outgoing_slice_idx = 0;
+  shm->outgoing_byte_idx = 0;
+  shm_ref(shm);
+  shm_do_write(shm);
+}
+
+void shm_add_to_pollset(grpc_endpoint* ep, grpc_pollset* pollset) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  grpc_pollset_add_fd(pollset, shm->rx_data_fd);
+  grpc_pollset_add_fd(pollset, shm->tx_space_fd);
+}
+
+void shm_add_to_pollset_set(grpc_endpoint* ep, grpc_pollset_set* pollset_set) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  grpc_pollset_set_add_fd(pollset_set, shm->rx_data_fd);
+  grpc_pollset_set_add_fd(pollset_set, shm->tx_space_fd);
+}
+
+void shm_delete_from_pollset_set(grpc_endpoint* ep,
+                                 grpc_pollset_set* pollset_set) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  grpc_pollset_set_del_fd(pollset_set, shm->rx_data_fd);
+  grpc_pollset_set_del_fd(pollset_set, shm->tx_space_fd);
+}
+
+void shm_shutdown(grpc_endpoint* ep, grpc_error_handle why) {
+  shm_fail(reinterpret_cast<grpc_shm_endpoint*>(ep), why);
+}
+
+void shm_destroy(grpc_endpoint* ep) {
+  grpc_shm_endpoint* shm = reinterpret_cast<grpc_shm_endpoint*>(ep);
+  shm_shutdown(ep,
+               GRPC_ERROR_CREATE_FROM_STATIC_STRING("Endpoint destroyed"));
+  shm_unref(shm);
+}
+
+absl::string_view shm_get_peer(grpc_endpoint* ep) {
+  return reinterpret_cast<grpc_shm_endpoint*>(ep)->peer_string;
+}
+
+absl::string_view shm_get_local_address(grpc_endpoint* ep) {
+  return reinterpret_cast<grpc_shm_endpoint*>(ep)->local_address;
+}
+
+int shm_get_fd(grpc_endpoint* /*ep*/) { return -1; }
+
+bool shm_can_track_err(grpc_endpoint* /*ep*/) { return false; }
+
+const grpc_endpoint_vtable vtable = {shm_read,
+                                     shm_write,
+                                     shm_add_to_pollset,
+                                     shm_add_to_pollset_set,
+                                     shm_delete_from_pollset_set,
+                                     shm_shutdown,
+                                     shm_destroy,
+                                     shm_get_peer,
+                                     shm_get_local_address,
+                                     shm_get_fd,
+                                     shm_can_track_err};
+
+// The doorbells come from the peer. Checks that \a fd is an eventfd, so that
+// ringing it cannot write into a pipe or a socket, and makes it non-blocking
+// whatever flags the peer created it with.
+grpc_error_handle CheckDoorbell(int fd) {
+  static const char kEventFdLink[] = "anon_inode:[eventfd]";
+  std::string path = absl::StrCat("/proc/self/fd/", fd);
+  char link[sizeof(kEventFdLink)];
+  ssize_t len = readlink(path.c_str(), link, sizeof(link));
+  bool is_eventfd;
+  if (len >= 0) {
+    is_eventfd = len == sizeof(kEventFdLink) - 1 &&
+                 memcmp(link, kEventFdLink, sizeof(kEventFdLink) - 1) == 0;
+  } else {
+    // Without /proc, settle for an anonymous inode, which has no file type.
+    struct stat st;
+    is_eventfd = fstat(fd, &st) == 0 && (st.st_mode & S_IFMT) == 0;
+  }
+  if (!is_eventfd) {
+    return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Shared memory doorbell is not an eventfd");
+  }
+  int flags = fcntl(fd, F_GETFL);
+  if (flags < 0) return GRPC_OS_ERROR(errno, "fcntl(F_GETFL)");
+  if ((flags & O_NONBLOCK) == 0 &&
+      fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    return GRPC_OS_ERROR(errno, "fcntl(F_SETFL)");
+  }
+  return GRPC_ERROR_NONE;
+}
+
+// Maps the segment behind \a memfd and wraps it into an endpoint. Takes
+// ownership of \a doorbells, but not of \a memfd.
+grpc_error_handle CreateEndpoint(int memfd, int doorbells[kNumDoorbells],
+                                 bool is_client, const char* peer_string,
+                                 grpc_endpoint** endpoint) {
+  *endpoint = nullptr;
+  for (int i = 0; i < kNumDoorbells; i++) {
+    grpc_error_handle error = CheckDoorbell(doorbells[i]);
+    if (error != GRPC_ERROR_NONE) {
+      CloseFds(doorbells, kNumDoorbells);
+      return error;
+    }
+  }
+  int seals = fcntl(memfd, F_GET_SEALS);
+  if (seals < 0 || (seals & kRequiredSeals) != kRequiredSeals) {
+    CloseFds(doorbells, kNumDoorbells);
+    return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Shared memory segment is not sealed");
+  }
+  struct stat st;
+  if (fstat(memfd, &st) != 0) {
+    grpc_error_handle error = GRPC_OS_ERROR(errno, "fstat");
+    CloseFds(doorbells, kNumDoorbells);
+    return error;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void* segment = size < kPageSize ? MAP_FAILED
+                                   : mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED, memfd, 0);
+  if (segment == MAP_FAILED) {
+    CloseFds(doorbells, kNumDoorbells);
+    return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Failed to map shared memory segment");
+  }
+  const SegmentHeader* header = static_cast<const SegmentHeader*>(segment);
+  size_t ring_size = static_cast<size_t>(header->ring_size);
+  if (header->magic != kSegmentMagic || ring_size < kMinRingSize ||
+      ring_size > kMaxRingSize || (ring_size & (ring_size - 1)) != 0 ||
+      SegmentSize(ring_size) > size) {
+    munmap(segment, size);
+    CloseFds(doorbells, kNumDoorbells);
+    return GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Invalid shared memory segment");
+  }
+  int tx_ring = is_client ? 0 : 1;
+  int rx_ring = 1 - tx_ring;
+  grpc_shm_endpoint* ep = new grpc_shm_endpoint();
+  ep->base.vtable = &vtable;
+  ep->segment = segment;
+  ep->segment_size = size;
+  ep->ring_size = ring_size;
+  ep->rx = RingControlAt(segment, ring_size, rx_ring);
+  ep->rx_data = RingDataAt(segment, ring_size, rx_ring);
+  ep->tx = RingControlAt(segment, ring_size, tx_ring);
+  ep->tx_data = RingDataAt(segment, ring_size, tx_ring);
+  GPR_ASSERT(ep->tx->head.is_lock_free());
+  ep->peer_string = peer_string;
+  ep->local_address = absl::StrCat("shm:", is_client ? "client" : "server");
+  std::string name = absl::StrCat("shm:", peer_string);
+  ep->rx_data_fd =
+      grpc_fd_create(doorbells[DataDoorbell(rx_ring)], name.c_str(), false);
+  ep->tx_space_fd =
+      grpc_fd_create(doorbells[SpaceDoorbell(tx_ring)], name.c_str(), false);
+  ep->tx_data_doorbell = doorbells[DataDoorbell(tx_ring)];
+  ep->rx_space_doorbell = doorbells[SpaceDoorbell(rx_ring)];
+  GRPC_CLOSURE_INIT(&ep->read_done_closure, shm_handle_read, ep,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&ep->write_done_closure, shm_handle_write, ep,
+                    grpc_schedule_on_exec_ctx);
+  *endpoint = &ep->base;
+  return GRPC_ERROR_NONE;
+}
+
+// State of a grpc_shm_endpoint_connect() or grpc_shm_endpoint_accept() in
+// progress. Each step tries its socket operation without blocking and waits
+// for the socket to become ready if it would have blocked.
+struct ShmHandshake {
+  ShmHandshake(grpc_fd* uds_fd, bool is_client, const char* peer_string,
+               grpc_endpoint** endpoint, grpc_closure* on_done)
+      : uds_fd(uds_fd),
+        is_client(is_client),
+        peer_string(peer_string),
+        endpoint(endpoint),
+        on_done(on_done) {
+    memset(&request, 0, sizeof(request));
+    for (int i = 0; i < kNumHandshakeFds; i++) fds[i] = -1;
+  }
+
+  grpc_fd* uds_fd;
+  bool is_client;
+  std::string peer_string;
+  grpc_endpoint** endpoint;
+  grpc_closure* on_done;
+  grpc_closure on_ready;
+  HandshakeRequest request;
+  // The segment followed by the doorbells, in the order they are sent.
+  int fds[kNumHandshakeFds];
+  // Client: the request was sent. Server: the request was received.
+  bool request_done = false;
+  // Server: the endpoint set up from the request, until the ack is sent.
+  grpc_endpoint* result = nullptr;
+};
+
+bool WouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+
+void FinishHandshake(ShmHandshake* hs, grpc_error_handle error) {
+  CloseFds(hs->fds, kNumHandshakeFds);
+  if (error != GRPC_ERROR_NONE && hs->result != nullptr) {
+    grpc_endpoint_destroy(hs->result);
+    hs->result = nullptr;
+  }
+  *hs->endpoint = hs->result;
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, hs->on_done, error);
+  delete hs;
+}
+
+grpc_error_handle CreateEndpointFromHandshake(ShmHandshake* hs) {
+  grpc_error_handle error =
+      CreateEndpoint(hs->fds[0], &hs->fds[1], hs->is_client,
+                     hs->peer_string.c_str(), &hs->result);
+  // The doorbells now belong to the endpoint, or were closed on failure.
+  for (int i = 1; i < kNumHandshakeFds; i++) hs->fds[i] = -1;
+  return error;
+}
+
+void OnConnectReady(void* arg, grpc_error_handle error) {
+  ShmHandshake* hs = static_cast<ShmHandshake*>(arg);
+  if (error != GRPC_ERROR_NONE) {
+    FinishHandshake(hs, GRPC_ERROR_REF(error));
+    return;
+  }
+  int fd = grpc_fd_wrapped_fd(hs->uds_fd);
+  if (!hs->request_done) {
+    struct iovec iov;
+    iov.iov_base = &hs->request;
+    iov.iov_len = sizeof(hs->request);
+    union {
+      char buf[CMSG_SPACE(sizeof(hs->fds))];
+      struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(hs->fds));
+    memcpy(CMSG_DATA(cmsg), hs->fds, sizeof(hs->fds));
+    ssize_t sent;
+    do {
+      sent = sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (sent < 0 && errno == EINTR);
+    if (sent < 0 && WouldBlock()) {
+      grpc_fd_notify_on_write(hs->uds_fd, &hs->on_ready);
+      return;
+    }
+    if (sent != static_cast<ssize_t>(sizeof(hs->request))) {
+      FinishHandshake(hs, sent < 0
+                              ? GRPC_OS_ERROR(errno, "sendmsg")
+                              : GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                    "Short write during shared memory "
+                                    "handshake"));
+      return;
+    }
+    hs->request_done = true;
+  }
+  char ack = 0;
+  ssize_t received;
+  do {
+    received = recv(fd, &ack, 1, MSG_DONTWAIT);
+  } while (received < 0 && errno == EINTR);
+  if (received < 0 && WouldBlock()) {
+    grpc_fd_notify_on_read(hs->uds_fd, &hs->on_ready);
+    return;
+  }
+  if (received != 1 || ack != 1) {
+    FinishHandshake(hs, received < 0
+                            ? GRPC_OS_ERROR(errno, "recv")
+                            : GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                  "Peer rejected shared memory handshake"));
+    return;
+  }
+  FinishHandshake(hs, CreateEndpointFromHandshake(hs));
+}
+
+void OnAcceptReady(void* arg, grpc_error_handle error) {
+  ShmHandshake* hs = static_cast<ShmHandshake*>(arg);
+  if (error != GRPC_ERROR_NONE) {
+    FinishHandshake(hs, GRPC_ERROR_REF(error));
+    return;
+  }
+  int fd = grpc_fd_wrapped_fd(hs->uds_fd);
+  if (!hs->request_done) {
+    // Look at the first bytes without consuming them: a client that did not
+    // offer shared memory, such as a plain HTTP/2 client, must find its data
+    // untouched. Without a control buffer, peeking installs no descriptors.
+    uint64_t magic;
+    ssize_t peeked;
+    do {
+      peeked = recv(fd, &magic, sizeof(magic), MSG_PEEK | MSG_DONTWAIT);
+    } while (peeked < 0 && errno == EINTR);
+    if (peeked < 0 && WouldBlock()) {
+      grpc_fd_notify_on_read(hs->uds_fd, &hs->on_ready);
+      return;
+    }
+    if (peeked <= 0) {
+      FinishHandshake(hs, peeked < 0
+                              ? GRPC_OS_ERROR(errno, "recv")
+                              : GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                    "Socket closed before shared memory "
+                                    "handshake"));
+      return;
+    }
+    if (memcmp(&magic, &kSegmentMagic, static_cast<size_t>(peeked)) != 0) {
+      FinishHandshake(hs, GRPC_ERROR_NONE);
+      return;
+    }
+    if (peeked < static_cast<ssize_t>(sizeof(magic))) {
+      grpc_fd_notify_on_read(hs->uds_fd, &hs->on_ready);
+      return;
+    }
+    struct iovec iov;
+    iov.iov_base = &hs->request;
+    iov.iov_len = sizeof(hs->request);
+    union {
+      char buf[CMSG_SPACE(sizeof(hs->fds))];
+      struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    ssize_t received;
+    do {
+      received = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0 && WouldBlock()) {
+      grpc_fd_notify_on_read(hs->uds_fd, &hs->on_ready);
+      return;
+    }
+    if (received < 0) {
+      FinishHandshake(hs, GRPC_OS_ERROR(errno, "recvmsg"));
+      return;
+    }
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+        cmsg->cmsg_type != SCM_RIGHTS) {
+      FinishHandshake(hs, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                              "Shared memory handshake carried no "
+                              "descriptors"));
+      return;
+    }
+    size_t num_fds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    num_fds = std::min(num_fds, static_cast<size_t>(kNumHandshakeFds));
+    memcpy(hs->fds, CMSG_DATA(cmsg), num_fds * sizeof(int));
+    if (num_fds != kNumHandshakeFds ||
+        received != static_cast<ssize_t>(sizeof(hs->request)) ||
+        (msg.msg_flags & MSG_CTRUNC) != 0 ||
+        hs->request.magic != kSegmentMagic ||
+        hs->request.version != kHandshakeVersion) {
+      FinishHandshake(hs, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                              "Invalid shared memory handshake"));
+      return;
+    }
+    hs->request_done = true;
+    error = CreateEndpointFromHandshake(hs);
+    if (error != GRPC_ERROR_NONE) {
+      FinishHandshake(hs, error);
+      return;
+    }
+  }
+  char ack = 1;
+  ssize_t sent;
+  do {
+    sent = send(fd, &ack, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+  } while (sent < 0 && errno == EINTR);
+  if (sent < 0 && WouldBlock()) {
+    grpc_fd_notify_on_write(hs->uds_fd, &hs->on_ready);
+    return;
+  }
+  FinishHandshake(hs, sent == 1 ? GRPC_ERROR_NONE
+                                : GRPC_OS_ERROR(errno, "send"));
+}
+
+}  // namespace
+
+grpc_endpoint_pair grpc_shm_endpoint_pair_create(const char* name,
+                                                 size_t ring_size) {
+  grpc_core::ExecCtx exec_ctx;
+  ring_size = RoundUpRingSize(ring_size);
+  int memfd;
+  int doorbells[kNumDoorbells];
+  GPR_ASSERT(CreateSegment(ring_size, &memfd, doorbells) == GRPC_ERROR_NONE);
+  int server_doorbells[kNumDoorbells];
+  for (int i = 0; i < kNumDoorbells; i++) {
+    server_doorbells[i] = dup(doorbells[i]);
+    GPR_ASSERT(server_doorbells[i] >= 0);
+  }
+  grpc_endpoint_pair p;
+  std::string client_peer = absl::StrCat(name, ":server");
+  std::string server_peer = absl::StrCat(name, ":client");
+  GPR_ASSERT(CreateEndpoint(memfd, doorbells, true, client_peer.c_str(),
+                            &p.client) == GRPC_ERROR_NONE);
+  GPR_ASSERT(CreateEndpoint(memfd, server_doorbells, false,
+                            server_peer.c_str(),
+                            &p.server) == GRPC_ERROR_NONE);
+  close(memfd);
+  return p;
+}
+
+void grpc_shm_endpoint_connect(grpc_fd* uds_fd, size_t ring_size,
+                               const char* peer_string,
+                               grpc_endpoint** endpoint,
+                               grpc_closure* on_done) {
+  *endpoint = nullptr;
+  ShmHandshake* hs =
+      new ShmHandshake(uds_fd, true, peer_string, endpoint, on_done);
+  GRPC_CLOSURE_INIT(&hs->on_ready, OnConnectReady, hs,
+                    grpc_schedule_on_exec_ctx);
+  ring_size = RoundUpRingSize(ring_size);
+  grpc_error_handle error =
+      CreateSegment(ring_size, &hs->fds[0], &hs->fds[1]);
+  if (error != GRPC_ERROR_NONE) {
+    FinishHandshake(hs, error);
+    return;
+  }
+  hs->request.magic = kSegmentMagic;
+  hs->request.version = kHandshakeVersion;
+  hs->request.ring_size = ring_size;
+  OnConnectReady(hs, GRPC_ERROR_NONE);
+}
+
+void grpc_shm_endpoint_accept(grpc_fd* uds_fd, const char* peer_string,
+                              grpc_endpoint** endpoint,
+                              grpc_closure* on_done) {
+  *endpoint = nullptr;
+  ShmHandshake* hs =
+      new ShmHandshake(uds_fd, false, peer_string, endpoint, on_done);
+  GRPC_CLOSURE_INIT(&hs->on_ready, OnAcceptReady, hs,
+                    grpc_schedule_on_exec_ctx);
+  OnAcceptReady(hs, GRPC_ERROR_NONE);
+}
+
+#endif /* GRPC_LINUX_SHM_ENDPOINT */
@@ -0,0 +1,79 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_ENDPOINT_SHM_H
+#define GRPC_CORE_LIB_IOMGR_ENDPOINT_SHM_H
+/*
+   Shared-memory endpoint for peers on the same host.
+
+   Each direction of the connection is a single-producer single-consumer byte
+   ring in a memfd segment mapped by both peers. Writes copy into the ring and
+   reads copy out of it, with no system call on the data path. An eventfd per
+   ring and per direction rings the peer's doorbell, but only when the peer
+   announced that it is about to sleep.
+
+   The segment and the eventfds are handed to the peer over a connected Unix
+   domain socket (grpc_shm_endpoint_connect / grpc_shm_endpoint_accept). The
+   segment is sealed against resizing, and each side validates the positions
+   published by the peer, so a misbehaving peer can only fail the connection.
+   The resulting endpoints can be used with any transport built on
+   grpc_endpoint; the shm handshaker (src/core/lib/channel/shm_handshaker.h)
+   switches chttp2 connections over unix: addresses to them.
+*/
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/ev_posix.h"
+
+/* Default capacity of each ring, in bytes. */
+#define GRPC_SHM_ENDPOINT_DEFAULT_RING_SIZE (1024 * 1024)
+
+/* Creates two connected shared-memory endpoints in this process. \a ring_size
+   is rounded up to a power of two. */
+grpc_endpoint_pair grpc_shm_endpoint_pair_create(const char* name,
+                                                 size_t ring_size);
+
+/* Offers a shared-memory connection over the connected Unix domain socket
+   \a uds_fd: creates the segment and the doorbells, sends them to the peer and
+   waits for it to acknowledge. Never blocks: \a on_done runs once the
+   handshake completed or failed, with *endpoint set on success. \a uds_fd
+   must be polled by a pollset or pollset_set while the handshake is in
+   progress, and stays owned by the caller; shutting it down cancels the
+   handshake. */
+void grpc_shm_endpoint_connect(grpc_fd* uds_fd, size_t ring_size,
+                               const char* peer_string,
+                               grpc_endpoint** endpoint,
+                               grpc_closure* on_done);
+
+/* Accepts the shared-memory connection offered by grpc_shm_endpoint_connect()
+   on the other end of \a uds_fd, with the same contract. If the peer sends
+   anything else first, \a on_done runs without error and with *endpoint
+   left nullptr, and nothing was read from \a uds_fd. */
+void grpc_shm_endpoint_accept(grpc_fd* uds_fd, const char* peer_string,
+                              grpc_endpoint** endpoint,
+                              grpc_closure* on_done);
+
+#endif /* GRPC_LINUX_SHM_ENDPOINT */
+
+#endif /* GRPC_CORE_LIB_IOMGR_ENDPOINT_SHM_H */
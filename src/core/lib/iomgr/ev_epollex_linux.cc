@@ -511,7 +511,8 @@ static bool fd_is_shutdown(grpc_fd* fd) {
 static void fd_shutdown(grpc_fd* fd, grpc_error_handle why) {
   if (fd->read_closure.SetShutdown(GRPC_ERROR_REF(why))) {
     if (shutdown(fd->fd, SHUT_RDWR)) {
-      if (errno != ENOTCONN) {
+      // Non-sockets (e.g. eventfds) only have their closures shut down.
+      if (errno != ENOTCONN && errno != ENOTSOCK) {
         gpr_log(GPR_ERROR, "Error shutting down fd %d. errno: %d",
                 grpc_fd_wrapped_fd(fd), errno);
       }
@@ -40,7 +40,11 @@ static void exec_ctx_run(grpc_closure* closure, grpc_error_handle error) {
             closure->line_initiated);
   }
 #endif
+  bool traced = GPR_UNLIKELY(grpc_core::LatencyTracer::enabled()) &&
+                grpc_core::LatencyTracer::BeginClosure(
+                    "closure", closure, reinterpret_cast<void*>(closure->cb));
   closure->cb(closure->cb_arg, error);
+  if (GPR_UNLIKELY(traced)) grpc_core::LatencyTracer::End("closure");
 #ifndef NDEBUG
   if (grpc_trace_closure.enabled()) {
     gpr_log(GPR_DEBUG, "closure %p finished", closure);
@@ -50,6 +54,9 @@ static void exec_ctx_run(grpc_closure* closure, grpc_error_handle error) {
 }
 
 static void exec_ctx_sched(grpc_closure* closure, grpc_error_handle error) {
+  if (GPR_UNLIKELY(grpc_core::LatencyTracer::enabled())) {
+    grpc_core::LatencyTracer::FlowStart("closure", closure);
+  }
 #if defined(GRPC_USE_EVENT_ENGINE) && \
     defined(GRPC_EVENT_ENGINE_REPLACE_EXEC_CTX)
   grpc_iomgr_event_engine()->Run(GrpcClosureToCallback(closure, error), {});
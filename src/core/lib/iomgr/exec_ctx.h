@@ -33,6 +33,7 @@
 #include "src/core/lib/gprpp/debug_location.h"
 #include "src/core/lib/gprpp/fork.h"
 #include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/profiling/timers.h"
 
 typedef int64_t grpc_millis;
 
@@ -110,6 +111,7 @@ class ExecCtx {
   ExecCtx() : flags_(GRPC_EXEC_CTX_FLAG_IS_FINISHED) {
     grpc_core::Fork::IncExecCtxCount();
     Set(this);
+    MaybeStartLatencyTrace();
   }
 
   /** Parameterised Constructor */
@@ -118,12 +120,14 @@ class ExecCtx {
       grpc_core::Fork::IncExecCtxCount();
     }
     Set(this);
+    MaybeStartLatencyTrace();
   }
 
   /** Destructor */
   virtual ~ExecCtx() {
     flags_ |= GRPC_EXEC_CTX_FLAG_IS_FINISHED;
     Flush();
+    if (GPR_UNLIKELY(latency_traced_)) LatencyTracer::EndSampledWork();
     Set(last_exec_ctx_);
     if (!(GRPC_EXEC_CTX_FLAG_IS_INTERNAL_THREAD & flags_)) {
       grpc_core::Fork::DecExecCtxCount();
@@ -247,8 +251,16 @@ class ExecCtx {
   bool now_is_valid_ = false;
   grpc_millis now_ = 0;
 
+  // The latency tracer samples the work of top-level ExecCtx's.
+  void MaybeStartLatencyTrace() {
+    if (GPR_UNLIKELY(LatencyTracer::enabled()) && last_exec_ctx_ == nullptr) {
+      latency_traced_ = LatencyTracer::StartSampledWork();
+    }
+  }
+
   static GPR_THREAD_LOCAL(ExecCtx*) exec_ctx_;
   ExecCtx* last_exec_ctx_ = Get();
+  bool latency_traced_ = false;
 };
 
 /** Application-callback execution context.
@@ -211,6 +211,11 @@
 #define GRPC_POSIX_SOCKET_UTILS_COMMON 1
 #endif
 
+#if defined(GRPC_POSIX_SOCKET_EV) && defined(GRPC_LINUX_EVENTFD) && \
+    defined(GRPC_HAVE_UNIX_SOCKET)
+#define GRPC_LINUX_SHM_ENDPOINT 1
+#endif
+
 #if defined(GRPC_POSIX_HOST_NAME_MAX) && defined(GRPC_POSIX_SYSCONF)
 #error "Cannot define both GRPC_POSIX_HOST_NAME_MAX and GRPC_POSIX_SYSCONF"
 #endif
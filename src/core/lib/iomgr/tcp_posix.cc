@@ -58,6 +58,7 @@
 #include "src/core/lib/iomgr/socket_utils_posix.h"
 #include "src/core/lib/iomgr/tcp_posix.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 
@@ -676,6 +677,8 @@ static void call_read_cb(grpc_tcp* tcp, grpc_error_handle error) {
     }
   }
 
+  GRPC_USDT3(tcp_read_done, tcp, tcp->incoming_buffer->length,
+             error != GRPC_ERROR_NONE);
   tcp->read_cb = nullptr;
   tcp->incoming_buffer = nullptr;
   grpc_core::Closure::Run(DEBUG_LOCATION, cb, error);
@@ -1007,6 +1010,7 @@ static bool tcp_write_with_timestamps(grpc_tcp* tcp, struct msghdr* msg,
 
   /* If there was an error on sendmsg the logic in tcp_flush will handle it. */
   ssize_t length = tcp_send(tcp->fd, msg, additional_flags);
+  GRPC_USDT3(tcp_sendmsg, tcp, sending_length, length);
   *sent_length = length;
   /* Only save timestamps if all the bytes were taken by sendmsg. */
   if (sending_length == static_cast<size_t>(length)) {
@@ -1347,6 +1351,7 @@ static bool do_tcp_flush_zerocopy(grpc_tcp* tcp, TcpZerocopySendRecord* record,
       GRPC_STATS_INC_TCP_WRITE_SIZE(sending_length);
       GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(iov_size);
       sent_length = tcp_send(tcp->fd, &msg, MSG_ZEROCOPY);
+      GRPC_USDT3(tcp_sendmsg, tcp, sending_length, sent_length);
     }
     if (sent_length < 0) {
       // If this particular send failed, drop ref taken earlier in this method.
@@ -1453,6 +1458,7 @@ static bool tcp_flush(grpc_tcp* tcp, grpc_error_handle* error) {
       GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(iov_size);
 
       sent_length = tcp_send(tcp->fd, &msg);
+      GRPC_USDT3(tcp_sendmsg, tcp, sending_length, sent_length);
     }
 
     if (sent_length < 0) {
@@ -1514,6 +1520,7 @@ static void tcp_handle_write(void* arg /* grpc_tcp */,
                                       "handle_write_err");
       tcp->current_zerocopy_send = nullptr;
     }
+    GRPC_USDT2(tcp_write_done, tcp, true);
     grpc_core::Closure::Run(DEBUG_LOCATION, cb, GRPC_ERROR_REF(error));
     TCP_UNREF(tcp, "write");
     return;
@@ -1537,6 +1544,7 @@ static void tcp_handle_write(void* arg /* grpc_tcp */,
     if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
       gpr_log(GPR_INFO, "write: %s", grpc_error_std_string(error).c_str());
     }
+    GRPC_USDT2(tcp_write_done, tcp, error != GRPC_ERROR_NONE);
     // No need to take a ref on error since tcp_flush provides a ref.
     grpc_core::Closure::Run(DEBUG_LOCATION, cb, error);
     TCP_UNREF(tcp, "write");
@@ -1578,6 +1586,7 @@ static void tcp_write(grpc_endpoint* ep, grpc_slice_buffer* buf,
     return;
   }
 
+  GRPC_USDT2(tcp_write, tcp, buf->length);
   zerocopy_send_record = tcp_get_send_zerocopy_record(tcp, buf);
   if (zerocopy_send_record == nullptr) {
     // Either not enough bytes, or couldn't allocate a zerocopy context.
@@ -1605,6 +1614,7 @@ static void tcp_write(grpc_endpoint* ep, grpc_slice_buffer* buf,
     if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
       gpr_log(GPR_INFO, "write: %s", grpc_error_std_string(error).c_str());
     }
+    GRPC_USDT2(tcp_write_done, tcp, error != GRPC_ERROR_NONE);
     grpc_core::Closure::Run(DEBUG_LOCATION, cb, error);
   }
 }
@@ -20,276 +20,440 @@
 
 #include "src/core/lib/profiling/timers.h"
 
-#ifdef GRPC_BASIC_PROFILER
-
-#include <inttypes.h>
-#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 
-#include <grpc/support/alloc.h>
+#ifdef GPR_POSIX_SYNC
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
-#include <grpc/support/time.h>
 
+#include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/gprpp/global_config.h"
-#include "src/core/lib/profiling/timers.h"
 
-typedef enum { BEGIN = '{', END = '}', MARK = '.' } marker_type;
-
-typedef struct gpr_timer_entry {
-  gpr_timespec tm;
-  const char* tagstr;
-  const char* file;
-  short line;
-  char type;
-  uint8_t important;
-  int thd;
-} gpr_timer_entry;
-
-#define MAX_COUNT 1000000
-
-typedef struct gpr_timer_log {
-  size_t num_entries;
-  struct gpr_timer_log* next;
-  struct gpr_timer_log* prev;
-  gpr_timer_entry log[MAX_COUNT];
-} gpr_timer_log;
-
-typedef struct gpr_timer_log_list {
-  gpr_timer_log* head;
-  /* valid iff head!=NULL */
-  gpr_timer_log* tail;
-} gpr_timer_log_list;
-
-static GPR_THREAD_LOCAL(gpr_timer_log*) g_thread_log;
-static gpr_once g_once_init = GPR_ONCE_INIT;
-static FILE* output_file;
-static const char* output_filename_or_null = NULL;
-static pthread_mutex_t g_mu;
-static pthread_cond_t g_cv;
-static gpr_timer_log_list g_in_progress_logs;
-static gpr_timer_log_list g_done_logs;
-static int g_shutdown;
-static pthread_t g_writing_thread;
-static GPR_THREAD_LOCAL(int) g_thread_id;
-static int g_next_thread_id;
-static int g_writing_enabled = 1;
-
-GPR_GLOBAL_CONFIG_DEFINE_STRING(grpc_latency_trace, "latency_trace.txt",
-                                "Output file name for latency trace")
-
-static const char* output_filename() {
-  if (output_filename_or_null == NULL) {
-    grpc_core::UniquePtr<char> value =
-        GPR_GLOBAL_CONFIG_GET(grpc_latency_trace);
-    if (strlen(value.get()) > 0) {
-      output_filename_or_null = value.release();
-    } else {
-      output_filename_or_null = "latency_trace.txt";
-    }
-  }
-  return output_filename_or_null;
+#ifdef GRPC_BASIC_PROFILER
+#define GRPC_LATENCY_TRACE_DEFAULT "latency_trace.txt"
+#else
+#define GRPC_LATENCY_TRACE_DEFAULT ""
+#endif
+
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_latency_trace, GRPC_LATENCY_TRACE_DEFAULT,
+    "If set, trace latency from grpc_init() on, and write the trace to this "
+    "file at grpc_shutdown(), in the Chrome trace event format.")
+
+namespace grpc_core {
+
+namespace {
+
+enum class EventType : uint8_t {
+  kBegin,
+  kBeginClosure,
+  kEnd,
+  kMark,
+  kFlowStart,
+  kFlowEnd,
+  kAsyncBegin,
+  kAsyncEnd,
+};
+
+// Written by the owning thread only, and read by the dumping thread: fields
+// are relaxed atomics, which cost no more than plain stores on the platforms
+// we care about.
+struct Event {
+  std::atomic<gpr_cycle_counter> time;
+  std::atomic<const char*> name;
+  // The file of a begin or mark, the callback of a closure, or the id of a
+  // flow or async slice.
+  std::atomic<const void*> arg;
+  std::atomic<int32_t> line;
+  std::atomic<EventType> type;
+  std::atomic<bool> important;
+};
+
+// A copy of an event, taken by the dumping thread.
+struct DumpedEvent {
+  gpr_cycle_counter time;
+  const char* name;
+  const void* arg;
+  int32_t line;
+  EventType type;
+  bool important;
+};
+
+struct Ring {
+  Event events[LatencyTracer::kEventsPerThread];
+  // The writer claims the slot of event n by bumping claimed to n + 1 before
+  // writing it, and publishes it by bumping published to n + 1 after, so
+  // that the reader can tell the events it copied that were overwritten
+  // meanwhile.
+  std::atomic<uint64_t> claimed{0};
+  std::atomic<uint64_t> published{0};
+  int tid;
+  // Keeps the rings reachable: they live as long as the process.
+  Ring* next;
+  // Next in g_free_rings.
+  Ring* next_free = nullptr;
+};
+
+std::atomic<Ring*> g_rings{nullptr};
+std::atomic<size_t> g_num_rings{0};
+// Rings of the threads that exited, for the next threads to reuse. They keep
+// their events, and their tid in the trace, whose lanes are then shared by
+// threads that did not overlap.
+gpr_mu g_free_rings_mu;
+Ring* g_free_rings = nullptr;
+gpr_once g_free_rings_once = GPR_ONCE_INIT;
+#ifdef GPR_POSIX_SYNC
+// Its destructor returns the ring of an exiting thread to g_free_rings.
+pthread_key_t g_ring_key;
+#endif
+std::atomic<uint32_t> g_sampling_period{1};
+// Events before this time were dropped by Reset().
+std::atomic<gpr_cycle_counter> g_epoch{0};
+const char* g_output_filename = nullptr;
+bool g_write_at_shutdown = false;
+
+GPR_THREAD_LOCAL(Ring*) g_ring;
+// Set when the thread can't have a ring anymore.
+GPR_THREAD_LOCAL(bool) g_no_ring;
+// Whether the work of the thread's top-level ExecCtx is sampled.
+GPR_THREAD_LOCAL(bool) g_sampled;
+GPR_THREAD_LOCAL(uint32_t) g_countdown;
+
+#ifdef GPR_POSIX_SYNC
+void ReleaseRing(void* arg) {
+  Ring* ring = static_cast<Ring*>(arg);
+  // Whatever the thread records from now on is dropped.
+  g_ring = nullptr;
+  g_no_ring = true;
+  gpr_mu_lock(&g_free_rings_mu);
+  ring->next_free = g_free_rings;
+  g_free_rings = ring;
+  gpr_mu_unlock(&g_free_rings_mu);
 }
+#endif
 
-static int timer_log_push_back(gpr_timer_log_list* list, gpr_timer_log* log) {
-  if (list->head == NULL) {
-    list->head = list->tail = log;
-    log->next = log->prev = NULL;
-    return 1;
-  } else {
-    log->prev = list->tail;
-    log->next = NULL;
-    list->tail->next = log;
-    list->tail = log;
-    return 0;
-  }
+void InitFreeRings() {
+  gpr_mu_init(&g_free_rings_mu);
+#ifdef GPR_POSIX_SYNC
+  GPR_ASSERT(pthread_key_create(&g_ring_key, ReleaseRing) == 0);
+#endif
 }
 
-static gpr_timer_log* timer_log_pop_front(gpr_timer_log_list* list) {
-  gpr_timer_log* out = list->head;
-  if (out != NULL) {
-    list->head = out->next;
-    if (list->head != NULL) {
-      list->head->prev = NULL;
-    } else {
-      list->tail = NULL;
+Ring* GetRing() {
+  Ring* ring = g_ring;
+  if (GPR_LIKELY(ring != nullptr)) return ring;
+  if (g_no_ring) return nullptr;
+  // gpr_mu_lock records timers of its own: they are dropped meanwhile.
+  g_no_ring = true;
+  gpr_once_init(&g_free_rings_once, InitFreeRings);
+  gpr_mu_lock(&g_free_rings_mu);
+  ring = g_free_rings;
+  if (ring != nullptr) g_free_rings = ring->next_free;
+  gpr_mu_unlock(&g_free_rings_mu);
+  if (ring == nullptr) {
+    size_t index = g_num_rings.fetch_add(1, std::memory_order_relaxed);
+    if (index >= LatencyTracer::kMaxThreads) return nullptr;
+    // Using new here, as this could be called from gpr_malloc.
+    ring = new Ring();
+    ring->tid = static_cast<int>(index);
+    ring->next = g_rings.load(std::memory_order_relaxed);
+    while (!g_rings.compare_exchange_weak(ring->next, ring,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
     }
   }
-  return out;
+#ifdef GPR_POSIX_SYNC
+  pthread_setspecific(g_ring_key, ring);
+#endif
+  g_no_ring = false;
+  g_ring = ring;
+  return ring;
 }
 
-static void timer_log_remove(gpr_timer_log_list* list, gpr_timer_log* log) {
-  if (log->prev == NULL) {
-    list->head = log->next;
-    if (list->head != NULL) {
-      list->head->prev = NULL;
-    }
-  } else {
-    log->prev->next = log->next;
-  }
-  if (log->next == NULL) {
-    list->tail = log->prev;
-    if (list->tail != NULL) {
-      list->tail->next = NULL;
-    }
-  } else {
-    log->next->prev = log->prev;
-  }
+bool ShouldRecord() {
+  return g_sampled || g_sampling_period.load(std::memory_order_relaxed) == 1;
+}
+
+void Record(EventType type, const char* name, const void* arg, int line,
+            bool important) {
+  Ring* ring = GetRing();
+  if (ring == nullptr) return;
+  uint64_t index = ring->claimed.load(std::memory_order_relaxed);
+  ring->claimed.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  Event& event =
+      ring->events[index & (LatencyTracer::kEventsPerThread - 1)];
+  event.time.store(gpr_get_cycle_counter(), std::memory_order_relaxed);
+  event.name.store(name, std::memory_order_relaxed);
+  event.arg.store(arg, std::memory_order_relaxed);
+  event.line.store(line, std::memory_order_relaxed);
+  event.type.store(type, std::memory_order_relaxed);
+  event.important.store(important, std::memory_order_relaxed);
+  ring->published.store(index + 1, std::memory_order_release);
 }
 
-static void write_log(gpr_timer_log* log) {
-  size_t i;
-  if (output_file == NULL) {
-    output_file = fopen(output_filename(), "w");
+// Copies the events of \a ring that are complete and not overwritten.
+std::vector<DumpedEvent> CopyRing(const Ring& ring) {
+  constexpr uint64_t kSize = LatencyTracer::kEventsPerThread;
+  uint64_t end = ring.published.load(std::memory_order_acquire);
+  uint64_t begin = end > kSize ? end - kSize : 0;
+  std::vector<DumpedEvent> events;
+  events.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    const Event& event = ring.events[i & (kSize - 1)];
+    events.push_back({event.time.load(std::memory_order_relaxed),
+                      event.name.load(std::memory_order_relaxed),
+                      event.arg.load(std::memory_order_relaxed),
+                      event.line.load(std::memory_order_relaxed),
+                      event.type.load(std::memory_order_relaxed),
+                      event.important.load(std::memory_order_relaxed)});
   }
-  for (i = 0; i < log->num_entries; i++) {
-    gpr_timer_entry* entry = &(log->log[i]);
-    if (gpr_time_cmp(entry->tm, gpr_time_0(entry->tm.clock_type)) < 0) {
-      entry->tm = gpr_time_0(entry->tm.clock_type);
-    }
-    fprintf(output_file,
-            "{\"t\": %" PRId64
-            ".%09d, \"thd\": \"%d\", \"type\": \"%c\", \"tag\": "
-            "\"%s\", \"file\": \"%s\", \"line\": %d, \"imp\": %d}\n",
-            entry->tm.tv_sec, entry->tm.tv_nsec, entry->thd, entry->type,
-            entry->tagstr, entry->file, entry->line, entry->important);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // A copied event was overwritten if the writer claimed the slot again.
+  uint64_t claimed = ring.claimed.load(std::memory_order_relaxed);
+  if (claimed > begin + kSize) {
+    uint64_t overwritten =
+        std::min<uint64_t>(claimed - begin - kSize, events.size());
+    events.erase(events.begin(), events.begin() + overwritten);
   }
+  return events;
 }
 
-static void* writing_thread(void* unused) {
-  gpr_timer_log* log;
-  pthread_mutex_lock(&g_mu);
-  for (;;) {
-    while ((log = timer_log_pop_front(&g_done_logs)) == NULL && !g_shutdown) {
-      pthread_cond_wait(&g_cv, &g_mu);
-    }
-    if (log != NULL) {
-      pthread_mutex_unlock(&g_mu);
-      write_log(log);
-      free(log);
-      pthread_mutex_lock(&g_mu);
-    }
-    if (g_shutdown) {
-      pthread_mutex_unlock(&g_mu);
-      return NULL;
-    }
+// Tags are string literals: only escape what would break the JSON.
+std::string Escape(const char* s) {
+  std::string escaped;
+  for (; *s != '\0'; ++s) {
+    if (*s == '"' || *s == '\\') escaped.push_back('\\');
+    if (static_cast<unsigned char>(*s) >= 0x20) escaped.push_back(*s);
   }
+  return escaped;
 }
 
-static void flush_logs(gpr_timer_log_list* list) {
-  gpr_timer_log* log;
-  while ((log = timer_log_pop_front(list)) != NULL) {
-    write_log(log);
-    free(log);
+void AppendEvent(const DumpedEvent& event, int tid, gpr_cycle_counter epoch,
+                 std::string* out) {
+  gpr_timespec ts = gpr_cycle_counter_sub(event.time, epoch);
+  double micros = ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+  absl::StrAppendFormat(out,
+                        ",\n{\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+                        Escape(event.name), tid, micros);
+  switch (event.type) {
+    case EventType::kBegin:
+    case EventType::kMark:
+      absl::StrAppendFormat(
+          out, ",\"ph\":\"%s\",\"args\":{\"file\":\"%s\",\"line\":%d%s}}",
+          event.type == EventType::kBegin ? "B" : "i\",\"s\":\"t",
+          Escape(static_cast<const char*>(event.arg)), event.line,
+          event.important ? ",\"important\":true" : "");
+      break;
+    case EventType::kBeginClosure:
+      absl::StrAppendFormat(out, ",\"ph\":\"B\",\"args\":{\"cb\":\"%p\"}}",
+                            event.arg);
+      break;
+    case EventType::kEnd:
+      out->append(",\"ph\":\"E\"}");
+      break;
+    case EventType::kFlowStart:
+    case EventType::kFlowEnd:
+      // Flows and async slices of different names are told apart by their
+      // category.
+      absl::StrAppendFormat(
+          out, ",\"cat\":\"%s\",\"id\":\"%p\",\"ph\":\"%s\"}",
+          Escape(event.name), event.arg,
+          event.type == EventType::kFlowStart ? "s" : "f\",\"bp\":\"e");
+      break;
+    case EventType::kAsyncBegin:
+    case EventType::kAsyncEnd:
+      absl::StrAppendFormat(
+          out, ",\"cat\":\"%s\",\"id\":\"%p\",\"ph\":\"%s\"}",
+          Escape(event.name), event.arg,
+          event.type == EventType::kAsyncBegin ? "b" : "e");
+      break;
   }
 }
 
-static void finish_writing(void) {
-  pthread_mutex_lock(&g_mu);
-  g_shutdown = 1;
-  pthread_cond_signal(&g_cv);
-  pthread_mutex_unlock(&g_mu);
-  pthread_join(g_writing_thread, NULL);
+}  // namespace
 
-  gpr_log(GPR_INFO, "flushing logs");
+constexpr size_t LatencyTracer::kEventsPerThread;
+constexpr size_t LatencyTracer::kMaxThreads;
+std::atomic<bool> LatencyTracer::enabled_{false};
 
-  pthread_mutex_lock(&g_mu);
-  flush_logs(&g_done_logs);
-  flush_logs(&g_in_progress_logs);
-  pthread_mutex_unlock(&g_mu);
-
-  if (output_file) {
-    fclose(output_file);
-  }
+void LatencyTracer::Enable(uint32_t sampling_period) {
+  g_sampling_period.store(std::max(sampling_period, 1u),
+                          std::memory_order_relaxed);
+  Reset();
+  enabled_.store(true, std::memory_order_relaxed);
 }
 
-void gpr_timers_set_log_filename(const char* filename) {
-  output_filename_or_null = filename;
+void LatencyTracer::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
 }
 
-static void init_output() {
-  pthread_attr_t attr;
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-  pthread_create(&g_writing_thread, &attr, &writing_thread, NULL);
-  pthread_attr_destroy(&attr);
-
-  atexit(finish_writing);
+void LatencyTracer::Reset() {
+  g_epoch.store(gpr_get_cycle_counter(), std::memory_order_relaxed);
 }
 
-static void rotate_log() {
-  /* Using malloc here, as this code could end up being called by gpr_malloc */
-  gpr_timer_log* log = static_cast<gpr_timer_log*>(malloc(sizeof(*log)));
-  gpr_once_init(&g_once_init, init_output);
-  log->num_entries = 0;
-  pthread_mutex_lock(&g_mu);
-  if (g_thread_log != NULL) {
-    timer_log_remove(&g_in_progress_logs, g_thread_log);
-    if (timer_log_push_back(&g_done_logs, g_thread_log)) {
-      pthread_cond_signal(&g_cv);
+std::string LatencyTracer::DumpChromeTrace() {
+  const gpr_cycle_counter epoch = g_epoch.load(std::memory_order_relaxed);
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  absl::StrAppendFormat(&out,
+                        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                        "\"args\":{\"name\":\"gRPC (1 in %d ExecCtx's)\"}}",
+                        g_sampling_period.load(std::memory_order_relaxed));
+  for (Ring* ring = g_rings.load(std::memory_order_acquire); ring != nullptr;
+       ring = ring->next) {
+    // The ring may have dropped the begin of the oldest slices: skip their
+    // ends.
+    int depth = 0;
+    for (const DumpedEvent& event : CopyRing(*ring)) {
+      if (event.time < epoch) continue;
+      if (event.type == EventType::kBegin ||
+          event.type == EventType::kBeginClosure) {
+        ++depth;
+      } else if (event.type == EventType::kEnd) {
+        if (depth == 0) continue;
+        --depth;
+      }
+      AppendEvent(event, ring->tid, epoch, &out);
     }
-  } else {
-    g_thread_id = g_next_thread_id++;
   }
-  timer_log_push_back(&g_in_progress_logs, log);
-  pthread_mutex_unlock(&g_mu);
-  g_thread_log = log;
+  out.append("\n]}\n");
+  return out;
 }
 
-static void gpr_timers_log_add(const char* tagstr, marker_type type,
-                               int important, const char* file, int line) {
-  gpr_timer_entry* entry;
+void LatencyTracer::InitFromEnvironment() {
+  // Keep tracing across grpc_init() and grpc_shutdown() cycles.
+  if (g_write_at_shutdown) return;
+  UniquePtr<char> filename = GPR_GLOBAL_CONFIG_GET(grpc_latency_trace);
+  if (strlen(filename.get()) == 0) return;
+  if (g_output_filename == nullptr) g_output_filename = filename.release();
+  g_write_at_shutdown = true;
+  Enable(1);
+}
 
-  if (!g_writing_enabled) {
+void LatencyTracer::WriteTraceFileIfRequested() {
+  if (!g_write_at_shutdown) return;
+  FILE* file = fopen(g_output_filename, "w");
+  if (file == nullptr) {
+    gpr_log(GPR_ERROR, "Failed to open latency trace file %s",
+            g_output_filename);
     return;
   }
+  std::string trace = DumpChromeTrace();
+  fwrite(trace.data(), 1, trace.size(), file);
+  fclose(file);
+}
 
-  if (g_thread_log == NULL || g_thread_log->num_entries == MAX_COUNT) {
-    rotate_log();
+bool LatencyTracer::StartSampledWork() {
+  uint32_t period = g_sampling_period.load(std::memory_order_relaxed);
+  // Start each thread at a different point of the period.
+  if (g_countdown == 0 || g_countdown > period) {
+    g_countdown = 1 + reinterpret_cast<uintptr_t>(&g_countdown) / 64 % period;
   }
+  if (--g_countdown != 0) return false;
+  g_countdown = period;
+  g_sampled = true;
+  return true;
+}
 
-  entry = &g_thread_log->log[g_thread_log->num_entries++];
+void LatencyTracer::EndSampledWork() { g_sampled = false; }
 
-  entry->tm = gpr_now(GPR_CLOCK_PRECISE);
-  entry->tagstr = tagstr;
-  entry->type = type;
-  entry->file = file;
-  entry->line = (short)line;
-  entry->important = important != 0;
-  entry->thd = g_thread_id;
+bool LatencyTracer::Begin(const char* name, bool important, const char* file,
+                          int line) {
+  if (!ShouldRecord()) return false;
+  Record(EventType::kBegin, name, file, line, important);
+  return true;
 }
 
-/* Latency profiler API implementation. */
-void gpr_timer_add_mark(const char* tagstr, int important, const char* file,
-                        int line) {
-  gpr_timers_log_add(tagstr, MARK, important, file, line);
+bool LatencyTracer::BeginClosure(const char* name, const void* closure,
+                                 const void* cb) {
+  if (!ShouldRecord()) return false;
+  Record(EventType::kBeginClosure, name, cb, 0, false);
+  Record(EventType::kFlowEnd, name, closure, 0, false);
+  return true;
 }
 
-void gpr_timer_begin(const char* tagstr, int important, const char* file,
-                     int line) {
-  gpr_timers_log_add(tagstr, BEGIN, important, file, line);
+void LatencyTracer::End(const char* name) {
+  Record(EventType::kEnd, name, nullptr, 0, false);
 }
 
-void gpr_timer_end(const char* tagstr, int important, const char* file,
-                   int line) {
-  gpr_timers_log_add(tagstr, END, important, file, line);
+void LatencyTracer::Mark(const char* name, bool important, const char* file,
+                         int line) {
+  if (!ShouldRecord()) return;
+  Record(EventType::kMark, name, file, line, important);
 }
 
-void gpr_timer_set_enabled(int enabled) { g_writing_enabled = enabled; }
+void LatencyTracer::FlowStart(const char* name, const void* id) {
+  if (!ShouldRecord()) return;
+  Record(EventType::kFlowStart, name, id, 0, false);
+}
 
-/* Basic profiler specific API functions. */
-void gpr_timers_global_init(void) {}
+void LatencyTracer::FlowEnd(const char* name, const void* id) {
+  if (!ShouldRecord()) return;
+  Record(EventType::kFlowEnd, name, id, 0, false);
+}
 
-void gpr_timers_global_destroy(void) {}
+void LatencyTracer::AsyncBegin(const char* name, const void* id) {
+  if (!ShouldRecord()) return;
+  Record(EventType::kAsyncBegin, name, id, 0, false);
+}
 
-#else  /* !GRPC_BASIC_PROFILER */
-void gpr_timers_global_init(void) {}
+void LatencyTracer::AsyncEnd(const char* name, const void* id) {
+  if (!ShouldRecord()) return;
+  Record(EventType::kAsyncEnd, name, id, 0, false);
+}
+
+}  // namespace grpc_core
+
+void gpr_timers_global_init(void) {
+  grpc_core::LatencyTracer::InitFromEnvironment();
+}
 
-void gpr_timers_global_destroy(void) {}
+void gpr_timers_global_destroy(void) {
+  grpc_core::LatencyTracer::WriteTraceFileIfRequested();
+}
 
-void gpr_timers_set_log_filename(const char* /*filename*/) {}
+void gpr_timers_set_log_filename(const char* filename) {
+  grpc_core::g_output_filename = filename;
+}
 
-void gpr_timer_set_enabled(int /*enabled*/) {}
-#endif /* GRPC_BASIC_PROFILER */
+void gpr_timer_set_enabled(int enabled) {
+  if (enabled) {
+    grpc_core::LatencyTracer::Enable(1);
+  } else {
+    grpc_core::LatencyTracer::Disable();
+  }
+}
+
+#if !(defined(GRPC_STAP_PROFILER) + defined(GRPC_CUSTOM_PROFILER))
+/* Latency profiler API implementation. */
+void gpr_timer_add_mark(const char* tagstr, int important, const char* file,
+                        int line) {
+  if (grpc_core::LatencyTracer::enabled()) {
+    grpc_core::LatencyTracer::Mark(tagstr, important != 0, file, line);
+  }
+}
+
+void gpr_timer_begin(const char* tagstr, int important, const char* file,
+                     int line) {
+  if (grpc_core::LatencyTracer::enabled()) {
+    grpc_core::LatencyTracer::Begin(tagstr, important != 0, file, line);
+  }
+}
+
+void gpr_timer_end(const char* tagstr, int /*important*/,
+                   const char* /*file*/, int /*line*/) {
+  if (grpc_core::LatencyTracer::enabled()) {
+    grpc_core::LatencyTracer::End(tagstr);
+  }
+}
+#endif /* !(GRPC_STAP_PROFILER || GRPC_CUSTOM_PROFILER) */
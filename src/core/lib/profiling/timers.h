@@ -19,6 +19,13 @@
 #ifndef GRPC_CORE_LIB_PROFILING_TIMERS_H
 #define GRPC_CORE_LIB_PROFILING_TIMERS_H
 
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
 void gpr_timers_global_init(void);
 void gpr_timers_global_destroy(void);
 
@@ -33,18 +40,114 @@ void gpr_timers_set_log_filename(const char* filename);
 
 void gpr_timer_set_enabled(int enabled);
 
-#if !(defined(GRPC_STAP_PROFILER) + defined(GRPC_BASIC_PROFILER) + \
-      defined(GRPC_CUSTOM_PROFILER))
-/* No profiling. No-op all the things. */
-#define GPR_TIMER_MARK(tag, important) \
-  do {                                 \
-  } while (0)
+namespace grpc_core {
+
+// A tracer of the latency of the work done by gRPC's threads, which can be
+// turned on at runtime: each thread records GPR_TIMER_SCOPE and
+// GPR_TIMER_MARK sites, the closures it runs and where they were scheduled,
+// into a fixed-size ring buffer of its own, without locking. The rings keep
+// the most recent events, and are dumped in the Chrome trace event format,
+// for chrome://tracing or Perfetto.
+//
+// While disabled, every site costs one relaxed load and a predictable branch.
+// To bound the overhead when enabled, the work of one in every sampling
+// period top-level ExecCtx's is recorded; the thread's work outside of an
+// ExecCtx is then left out.
+class LatencyTracer {
+ public:
+  // Events kept per thread.
+  static constexpr size_t kEventsPerThread = 1 << 15;
+  // Live threads that get a ring: past these, threads record nothing. The
+  // rings of exited threads are reused where pthreads are available.
+  static constexpr size_t kMaxThreads = 128;
+
+  // Drops the events recorded so far and starts recording the work of one in
+  // \a sampling_period top-level ExecCtx's.
+  static void Enable(uint32_t sampling_period);
+  static void Disable();
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  // Drops the events recorded so far.
+  static void Reset();
+
+  // Returns the events still in the rings as Chrome trace event JSON.
+  static std::string DumpChromeTrace();
+
+  // Enables the tracer if GRPC_LATENCY_TRACE names a file (always in
+  // GRPC_BASIC_PROFILER builds).
+  static void InitFromEnvironment();
+  // Writes the trace to that file, if InitFromEnvironment() enabled the
+  // tracer.
+  static void WriteTraceFileIfRequested();
+
+  // Called by a top-level ExecCtx when it is created: decides whether its
+  // work is sampled, and returns whether EndSampledWork() must be called.
+  static bool StartSampledWork();
+  static void EndSampledWork();
+
+  // Recording, only call when enabled. These return whether the event was
+  // recorded, in which case the matching End() must be called.
+  static bool Begin(const char* name, bool important, const char* file,
+                    int line);
+  // Begins running \a closure, scheduled by FlowStart(name, closure).
+  static bool BeginClosure(const char* name, const void* closure,
+                           const void* cb);
+  static void End(const char* name);
+  static void Mark(const char* name, bool important, const char* file,
+                   int line);
+  // Links the point where \a id is handed off to the slice that picks it up
+  // with FlowEnd() or BeginClosure().
+  static void FlowStart(const char* name, const void* id);
+  static void FlowEnd(const char* name, const void* id);
+  // Brackets work that spans threads, such as a transport's write, on a
+  // track of its own per \a id.
+  static void AsyncBegin(const char* name, const void* id);
+  static void AsyncEnd(const char* name, const void* id);
+
+  class Scope {
+   public:
+    Scope(const char* name, bool important, const char* file, int line)
+        : name_(name) {
+      if (GPR_UNLIKELY(enabled())) {
+        recorded_ = Begin(name, important, file, line);
+      }
+    }
+    ~Scope() {
+      if (GPR_UNLIKELY(recorded_)) End(name_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const char* const name_;
+    bool recorded_ = false;
+  };
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace grpc_core
 
-#define GPR_TIMER_SCOPE(tag, important) \
-  do {                                  \
+#define GPR_TIMER_SCOPE_NAME_INTERNAL(prefix, line) prefix##line
+#define GPR_TIMER_SCOPE_NAME(prefix, line) \
+  GPR_TIMER_SCOPE_NAME_INTERNAL(prefix, line)
+
+#if !(defined(GRPC_STAP_PROFILER) + defined(GRPC_CUSTOM_PROFILER))
+/* The latency tracer, off until enabled at runtime. */
+#define GPR_TIMER_MARK(tag, important)                               \
+  do {                                                               \
+    if (GPR_UNLIKELY(::grpc_core::LatencyTracer::enabled())) {       \
+      ::grpc_core::LatencyTracer::Mark((tag), (important), __FILE__, \
+                                       __LINE__);                    \
+    }                                                                \
   } while (0)
 
-#else /* at least one profiler requested... */
+#define GPR_TIMER_SCOPE(tag, important)                   \
+  ::grpc_core::LatencyTracer::Scope GPR_TIMER_SCOPE_NAME( \
+      _profile_scope_, __LINE__)((tag), (important), __FILE__, __LINE__)
+
+#else /* an external profiler was requested... */
 /* ... hopefully only one. */
 #if defined(GRPC_STAP_PROFILER) && defined(GRPC_BASIC_PROFILER)
 #error "GRPC_STAP_PROFILER and GRPC_BASIC_PROFILER are mutually exclusive."
@@ -64,10 +167,6 @@ void gpr_timer_set_enabled(int enabled);
 /* Empty placeholder for now. */
 #endif /* GRPC_STAP_PROFILER */
 
-#ifdef GRPC_BASIC_PROFILER
-/* Empty placeholder for now. */
-#endif /* GRPC_BASIC_PROFILER */
-
 namespace grpc {
 class ProfileScope {
  public:
@@ -82,13 +181,10 @@ class ProfileScope {
 };
 }  // namespace grpc
 
-#define GPR_TIMER_SCOPE_NAME_INTERNAL(prefix, line) prefix##line
-#define GPR_TIMER_SCOPE_NAME(prefix, line) \
-  GPR_TIMER_SCOPE_NAME_INTERNAL(prefix, line)
 #define GPR_TIMER_SCOPE(tag, important)                                 \
   ::grpc::ProfileScope GPR_TIMER_SCOPE_NAME(_profile_scope_, __LINE__)( \
       (tag), (important), __FILE__, __LINE__)
 
-#endif /* at least one profiler requested. */
+#endif /* an external profiler was requested. */
 
 #endif /* GRPC_CORE_LIB_PROFILING_TIMERS_H */
@@ -0,0 +1,72 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_PROFILING_USDT_H
+#define GRPC_CORE_LIB_PROFILING_USDT_H
+
+#include <grpc/support/port_platform.h>
+
+// Statically defined tracepoints (USDT probes) of the "grpc" provider, for
+// bpftrace, perf, SystemTap and other tools that attach to them at runtime.
+// See tools/profiling/usdt for the probes and their arguments.
+//
+// The probes are only compiled in with GRPC_USDT_PROBES defined (the
+// gRPC_USDT_PROBES CMake option, or --define=grpc_usdt_probes=true with
+// Bazel), which requires <sys/sdt.h>. Each one is then a single nop
+// instruction while no tool is attached, plus the computation of its
+// arguments, so arguments must be cheap: fields and pointers, not calls.
+// Without GRPC_USDT_PROBES, the probes and their arguments compile to
+// nothing.
+
+#ifdef GRPC_USDT_PROBES
+
+#include <sys/sdt.h>
+
+#define GRPC_USDT0(name) DTRACE_PROBE(grpc, name)
+#define GRPC_USDT1(name, a1) DTRACE_PROBE1(grpc, name, a1)
+#define GRPC_USDT2(name, a1, a2) DTRACE_PROBE2(grpc, name, a1, a2)
+#define GRPC_USDT3(name, a1, a2, a3) DTRACE_PROBE3(grpc, name, a1, a2, a3)
+#define GRPC_USDT4(name, a1, a2, a3, a4) \
+  DTRACE_PROBE4(grpc, name, a1, a2, a3, a4)
+#define GRPC_USDT5(name, a1, a2, a3, a4, a5) \
+  DTRACE_PROBE5(grpc, name, a1, a2, a3, a4, a5)
+
+#else /* GRPC_USDT_PROBES */
+
+#define GRPC_USDT0(name) \
+  do {                   \
+  } while (0)
+#define GRPC_USDT1(name, a1) \
+  do {                       \
+  } while (0)
+#define GRPC_USDT2(name, a1, a2) \
+  do {                           \
+  } while (0)
+#define GRPC_USDT3(name, a1, a2, a3) \
+  do {                               \
+  } while (0)
+#define GRPC_USDT4(name, a1, a2, a3, a4) \
+  do {                                   \
+  } while (0)
+#define GRPC_USDT5(name, a1, a2, a3, a4, a5) \
+  do {                                       \
+  } while (0)
+
+#endif /* GRPC_USDT_PROBES */
+
+#endif /* GRPC_CORE_LIB_PROFILING_USDT_H */
@@ -25,17 +25,25 @@
 #include "src/core/lib/security/credentials/credentials.h"
 #include "src/core/lib/slice/slice_internal.h"
 
+// The capacity of a non-empty list is the smallest power of two (and at
+// least 2) that fits its size.
+static size_t mdelem_list_capacity(size_t size) {
+  size_t capacity = 2;
+  while (capacity < size) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
 static void mdelem_list_ensure_capacity(grpc_credentials_mdelem_array* list,
                                         size_t additional_space_needed) {
   size_t target_size = list->size + additional_space_needed;
-  // Find the next power of two greater than the target size (i.e.,
-  // whenever we add more space, we double what we already have).
-  size_t new_size = 2;
-  while (new_size < target_size) {
-    new_size *= 2;
+  if (list->md != nullptr && target_size <= mdelem_list_capacity(list->size)) {
+    return;
   }
-  list->md = static_cast<grpc_mdelem*>(
-      gpr_realloc(list->md, sizeof(grpc_mdelem) * new_size));
+  // Whenever we add more space, we double what we already have.
+  list->md = static_cast<grpc_mdelem*>(gpr_realloc(
+      list->md, sizeof(grpc_mdelem) * mdelem_list_capacity(target_size)));
 }
 
 void grpc_credentials_mdelem_array_add(grpc_credentials_mdelem_array* list,
@@ -23,6 +23,17 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
@@ -36,6 +47,9 @@ extern "C" {
 
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/http/httpcli.h"
 #include "src/core/lib/iomgr/polling_entity.h"
 #include "src/core/lib/slice/b64.h"
@@ -328,6 +342,213 @@ grpc_jwt_verifier_status grpc_jwt_claims_check(const grpc_jwt_claims* claims,
   return GRPC_JWT_VERIFIER_OK;
 }
 
+/* --- Key cache. --- */
+
+/* Cache key sets for five minutes unless the server says otherwise. */
+grpc_millis grpc_jwt_verifier_key_cache_default_ttl = 5 * 60 * GPR_MS_PER_SEC;
+
+/* Never trust a key set for more than a day. */
+grpc_millis grpc_jwt_verifier_key_cache_max_ttl = 24 * 60 * 60 * GPR_MS_PER_SEC;
+
+/* Refetch a cached key set lacking the key of a JWT at most every 30 seconds. */
+grpc_millis grpc_jwt_verifier_key_miss_refetch_interval = 30 * GPR_MS_PER_SEC;
+
+grpc_millis grpc_jwt_cache_ttl_from_http_response(
+    const grpc_http_response* response) {
+  grpc_millis ttl = grpc_jwt_verifier_key_cache_default_ttl;
+  for (size_t i = 0; i < response->hdr_count; i++) {
+    if (gpr_stricmp(response->hdrs[i].key, "cache-control") != 0) continue;
+    /* See https://tools.ietf.org/html/rfc7234#section-5.2.2. */
+    for (absl::string_view directive :
+         absl::StrSplit(response->hdrs[i].value, ',')) {
+      directive = absl::StripAsciiWhitespace(directive);
+      if (absl::EqualsIgnoreCase(directive, "no-store") ||
+          absl::EqualsIgnoreCase(directive, "no-cache")) {
+        return 0;
+      }
+      int64_t max_age;
+      if (absl::StartsWithIgnoreCase(directive, "max-age=") &&
+          absl::SimpleAtoi(directive.substr(strlen("max-age=")), &max_age) &&
+          max_age >= 0) {
+        /* max_age comes from the peer: clamp it before converting. */
+        max_age = std::min<int64_t>(
+            max_age, grpc_jwt_verifier_key_cache_max_ttl / GPR_MS_PER_SEC);
+        ttl = max_age * GPR_MS_PER_SEC;
+      }
+    }
+  }
+  return GPR_MIN(ttl, grpc_jwt_verifier_key_cache_max_ttl);
+}
+
+namespace grpc_core {
+namespace {
+
+/* Maximum number of key sets (resp. OpenID issuers) remembered by a verifier.
+   Past that, expired entries and then arbitrary ones are evicted. */
+constexpr size_t kMaxKeyCacheEntries = 64;
+
+/* Immutable set of verification keys, parsed once from a fetched JWK set
+   (https://tools.ietf.org/html/rfc7517#section-5) or from the google
+   proprietary format: { <kid1>: <x5091>, <kid2>: <x5092>, ... }. */
+class JwtKeySet : public RefCounted<JwtKeySet> {
+ public:
+  explicit JwtKeySet(const Json& json);
+  ~JwtKeySet() override {
+    for (auto& p : keys_) EVP_PKEY_free(p.second);
+  }
+
+  bool empty() const { return keys_.empty(); }
+
+  /* Returns the key matching kid and alg, owned by the key set. */
+  EVP_PKEY* Find(const char* kid, const char* alg) const {
+    auto it = keys_.find(std::make_pair(std::string(kid), std::string(alg)));
+    if (it == keys_.end()) {
+      /* x509 keys do not carry an alg and match all of them. */
+      it = keys_.find(std::make_pair(std::string(kid), std::string()));
+    }
+    if (it == keys_.end()) return nullptr;
+    return it->second;
+  }
+
+ private:
+  /* Keyed by (kid, alg). */
+  std::map<std::pair<std::string, std::string>, EVP_PKEY*> keys_;
+};
+
+/* Per-verifier cache of key sets, keyed by key url (host followed by path),
+   and of the key url advertised by OpenID issuers, keyed by issuer.
+   Entries are refreshed ahead of their expiration: the first lookup past the
+   refresh point is told to refetch while concurrent lookups keep being served
+   the current keys, so that a key rotation never stalls the request path. */
+class JwtKeyCache : public RefCounted<JwtKeyCache> {
+ public:
+  struct KeyUrl {
+    std::string host;
+    std::string path;
+  };
+
+  /* Returns the cached key set for key_url, or nullptr if none is usable.
+     If *refresh is set on return, the caller is responsible for refetching
+     the key set and then calling either UpdateKeys() or RefreshFailed(). */
+  RefCountedPtr<JwtKeySet> GetKeys(const std::string& key_url, bool* refresh) {
+    grpc_millis now = ExecCtx::Get()->Now();
+    MutexLock lock(&mu_);
+    *refresh = false;
+    auto it = keys_.find(key_url);
+    if (it == keys_.end() || now >= it->second.expires_at) return nullptr;
+    if (now >= it->second.refresh_at && !it->second.refreshing) {
+      it->second.refreshing = true;
+      *refresh = true;
+    }
+    return it->second.keys;
+  }
+
+  /* Caches keys for ttl. A zero ttl drops any previously cached keys. */
+  void UpdateKeys(const std::string& key_url, RefCountedPtr<JwtKeySet> keys,
+                  grpc_millis ttl) {
+    grpc_millis now = ExecCtx::Get()->Now();
+    MutexLock lock(&mu_);
+    if (ttl <= 0) {
+      keys_.erase(key_url);
+      return;
+    }
+    if (keys_.find(key_url) == keys_.end()) MakeRoom(&keys_, now);
+    KeysEntry& entry = keys_[key_url];
+    entry.keys = std::move(keys);
+    entry.expires_at = now + ttl;
+    /* Start refreshing when 90% of the lifetime has elapsed. */
+    entry.refresh_at = now + ttl - ttl / 10;
+    entry.refreshing = false;
+  }
+
+  /* Called when the cached keys of key_url lack the key of a JWT, which is
+     what happens after the issuer rotates its keys. Returns true if the
+     caller should refetch the key set and then call either UpdateKeys() or
+     RefreshFailed(). Misses trigger at most one refetch per
+     grpc_jwt_verifier_key_miss_refetch_interval, so that JWTs with bogus kids
+     cannot make the verifier hammer the key server. */
+  bool RefetchOnKeyMiss(const std::string& key_url) {
+    grpc_millis now = ExecCtx::Get()->Now();
+    MutexLock lock(&mu_);
+    auto it = keys_.find(key_url);
+    if (it == keys_.end() || it->second.refreshing) return false;
+    if (it->second.last_miss_refetch != GRPC_MILLIS_INF_PAST &&
+        now < it->second.last_miss_refetch +
+                  grpc_jwt_verifier_key_miss_refetch_interval) {
+      return false;
+    }
+    it->second.last_miss_refetch = now;
+    it->second.refreshing = true;
+    return true;
+  }
+
+  /* Lets the next lookup retry the refresh of key_url. */
+  void RefreshFailed(const std::string& key_url) {
+    MutexLock lock(&mu_);
+    auto it = keys_.find(key_url);
+    if (it != keys_.end()) it->second.refreshing = false;
+  }
+
+  bool GetJwksUri(const std::string& issuer, KeyUrl* key_url) {
+    grpc_millis now = ExecCtx::Get()->Now();
+    MutexLock lock(&mu_);
+    auto it = jwks_uris_.find(issuer);
+    if (it == jwks_uris_.end() || now >= it->second.expires_at) return false;
+    *key_url = it->second.key_url;
+    return true;
+  }
+
+  void UpdateJwksUri(const std::string& issuer, KeyUrl key_url,
+                     grpc_millis ttl) {
+    grpc_millis now = ExecCtx::Get()->Now();
+    MutexLock lock(&mu_);
+    if (ttl <= 0) {
+      jwks_uris_.erase(issuer);
+      return;
+    }
+    if (jwks_uris_.find(issuer) == jwks_uris_.end()) {
+      MakeRoom(&jwks_uris_, now);
+    }
+    JwksUriEntry& entry = jwks_uris_[issuer];
+    entry.key_url = std::move(key_url);
+    entry.expires_at = now + ttl;
+  }
+
+ private:
+  struct KeysEntry {
+    RefCountedPtr<JwtKeySet> keys;
+    grpc_millis refresh_at = 0;
+    grpc_millis expires_at = 0;
+    grpc_millis last_miss_refetch = GRPC_MILLIS_INF_PAST;
+    bool refreshing = false;
+  };
+
+  struct JwksUriEntry {
+    KeyUrl key_url;
+    grpc_millis expires_at = 0;
+  };
+
+  template <typename Entry>
+  static void MakeRoom(std::map<std::string, Entry>* entries, grpc_millis now) {
+    if (entries->size() < kMaxKeyCacheEntries) return;
+    for (auto it = entries->begin(); it != entries->end();) {
+      if (now >= it->second.expires_at) {
+        it = entries->erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (entries->size() >= kMaxKeyCacheEntries) entries->erase(entries->begin());
+  }
+
+  Mutex mu_;
+  std::map<std::string, KeysEntry> keys_ ABSL_GUARDED_BY(mu_);
+  std::map<std::string, JwksUriEntry> jwks_uris_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+}  // namespace grpc_core
+
 /* --- verifier_cb_ctx object. --- */
 
 typedef enum {
@@ -347,6 +568,15 @@ struct verifier_cb_ctx {
   void* user_data;
   grpc_jwt_verification_done_cb user_cb;
   grpc_http_response responses[HTTP_RESPONSE_COUNT];
+  grpc_core::RefCountedPtr<grpc_core::JwtKeyCache> key_cache;
+  /* Issuer whose OpenID configuration is being fetched, if any. */
+  std::string openid_issuer;
+  /* Location of the key set used to verify the JWT. */
+  grpc_core::JwtKeyCache::KeyUrl key_url;
+  /* Keys found in the cache. Still used if a refresh of them fails. */
+  grpc_core::RefCountedPtr<grpc_core::JwtKeySet> cached_keys;
+  bool refreshing_keys;
+  grpc_closure on_cached_keys;
 };
 /* Takes ownership of the header, claims and signature. */
 static verifier_cb_ctx* verifier_cb_ctx_create(
@@ -356,8 +586,7 @@ static verifier_cb_ctx* verifier_cb_ctx_create(
     grpc_jwt_verification_done_cb cb) {
   grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
   grpc_core::ExecCtx exec_ctx;
-  verifier_cb_ctx* ctx =
-      static_cast<verifier_cb_ctx*>(gpr_zalloc(sizeof(verifier_cb_ctx)));
+  verifier_cb_ctx* ctx = new verifier_cb_ctx();
   ctx->verifier = verifier;
   ctx->pollent = grpc_polling_entity_create_from_pollset(pollset);
   ctx->header = header;
@@ -381,7 +610,7 @@ void verifier_cb_ctx_destroy(verifier_cb_ctx* ctx) {
     grpc_http_response_destroy(&ctx->responses[i]);
   }
   /* TODO: see what to do with claims... */
-  gpr_free(ctx);
+  delete ctx;
 }
 
 /* --- grpc_jwt_verifier object. --- */
@@ -401,6 +630,7 @@ struct grpc_jwt_verifier {
   size_t num_mappings; /* Should be very few, linear search ok. */
   size_t allocated_mappings;
   grpc_httpcli_context http_ctx;
+  grpc_core::RefCountedPtr<grpc_core::JwtKeyCache> key_cache;
 };
 
 static Json json_from_http(const grpc_httpcli_response* response) {
@@ -548,22 +778,25 @@ end:
   return result;
 }
 
-static EVP_PKEY* find_verification_key(const Json& json, const char* header_alg,
-                                       const char* header_kid) {
-  /* Try to parse the json as a JWK set:
-     https://tools.ietf.org/html/rfc7517#section-5. */
+namespace grpc_core {
+namespace {
+
+JwtKeySet::JwtKeySet(const Json& json) {
+  if (json.type() != Json::Type::OBJECT) return;
   const Json* jwt_keys = find_property_by_name(json, "keys");
   if (jwt_keys == nullptr) {
-    /* Use the google proprietary format which is:
-       { <kid1>: <x5091>, <kid2>: <x5092>, ... } */
-    const Json* cur = find_property_by_name(json, header_kid);
-    if (cur == nullptr) return nullptr;
-    return extract_pkey_from_x509(cur->string_value().c_str());
+    /* Use the google proprietary format. */
+    for (const auto& p : json.object_value()) {
+      if (p.second.type() != Json::Type::STRING) continue;
+      EVP_PKEY* key = extract_pkey_from_x509(p.second.string_value().c_str());
+      if (key != nullptr) keys_[std::make_pair(p.first, std::string())] = key;
+    }
+    return;
   }
   if (jwt_keys->type() != Json::Type::ARRAY) {
     gpr_log(GPR_ERROR,
             "Unexpected value type of keys property in jwks key set.");
-    return nullptr;
+    return;
   }
   /* Key format is specified in:
      https://tools.ietf.org/html/rfc7518#section-6. */
@@ -584,17 +817,18 @@ static EVP_PKEY* find_verification_key(const Json& json, const char* header_alg,
     if (it != jkey.object_value().end()) {
       kty = validate_string_field(it->second, "kty");
     }
-    if (alg != nullptr && kid != nullptr && kty != nullptr &&
-        strcmp(kid, header_kid) == 0 && strcmp(alg, header_alg) == 0) {
-      return pkey_from_jwk(jkey, kty);
-    }
+    if (alg == nullptr || kid == nullptr || kty == nullptr) continue;
+    EVP_PKEY* key = pkey_from_jwk(jkey, kty);
+    if (key == nullptr) continue;
+    auto& slot = keys_[std::make_pair(std::string(kid), std::string(alg))];
+    EVP_PKEY_free(slot);
+    slot = key;
   }
-  gpr_log(GPR_ERROR,
-          "Could not find matching key in key set for kid=%s and alg=%s",
-          header_kid, header_alg);
-  return nullptr;
 }
 
+}  // namespace
+}  // namespace grpc_core
+
 static int verify_jwt_signature(EVP_PKEY* key, const char* alg,
                                 const grpc_slice& signature,
                                 const grpc_slice& signed_data) {
@@ -628,19 +862,19 @@ end:
   return result;
 }
 
-static void on_keys_retrieved(void* user_data, grpc_error_handle /*error*/) {
-  verifier_cb_ctx* ctx = static_cast<verifier_cb_ctx*>(user_data);
-  Json json = json_from_http(&ctx->responses[HTTP_RESPONSE_KEYS]);
+/* Verifies the JWT with the given keys, then reports the status to the user
+   and destroys ctx. */
+static void verify_with_keys(verifier_cb_ctx* ctx,
+                             const grpc_core::JwtKeySet* keys) {
   EVP_PKEY* verification_key = nullptr;
   grpc_jwt_verifier_status status = GRPC_JWT_VERIFIER_GENERIC_ERROR;
   grpc_jwt_claims* claims = nullptr;
 
-  if (json.type() == Json::Type::JSON_NULL) {
+  if (keys == nullptr) {
     status = GRPC_JWT_VERIFIER_KEY_RETRIEVAL_ERROR;
     goto end;
   }
-  verification_key =
-      find_verification_key(json, ctx->header->alg, ctx->header->kid);
+  verification_key = keys->Find(ctx->header->kid, ctx->header->alg);
   if (verification_key == nullptr) {
     gpr_log(GPR_ERROR, "Could not find verification key with kid %s.",
             ctx->header->kid);
@@ -662,22 +896,85 @@ static void on_keys_retrieved(void* user_data, grpc_error_handle /*error*/) {
   }
 
 end:
-  EVP_PKEY_free(verification_key);
   ctx->user_cb(ctx->user_data, status, claims);
   verifier_cb_ctx_destroy(ctx);
 }
 
+static void on_keys_retrieved(void* user_data, grpc_error_handle /*error*/) {
+  verifier_cb_ctx* ctx = static_cast<verifier_cb_ctx*>(user_data);
+  const grpc_http_response* response = &ctx->responses[HTTP_RESPONSE_KEYS];
+  std::string key_url = ctx->key_url.host + ctx->key_url.path;
+  Json json = json_from_http(response);
+  grpc_core::RefCountedPtr<grpc_core::JwtKeySet> keys;
+  if (json.type() != Json::Type::JSON_NULL) {
+    keys = grpc_core::MakeRefCounted<grpc_core::JwtKeySet>(json);
+  }
+  if (keys == nullptr || keys->empty()) {
+    if (ctx->refreshing_keys) {
+      /* Keep using the keys we have until the next refresh attempt. */
+      gpr_log(GPR_ERROR, "Could not refresh keys from %s.", key_url.c_str());
+      ctx->key_cache->RefreshFailed(key_url);
+      keys = std::move(ctx->cached_keys);
+    }
+  } else {
+    ctx->key_cache->UpdateKeys(key_url, keys,
+                               grpc_jwt_cache_ttl_from_http_response(response));
+  }
+  verify_with_keys(ctx, keys.get());
+}
+
+static void on_cached_keys(void* user_data, grpc_error_handle /*error*/) {
+  verifier_cb_ctx* ctx = static_cast<verifier_cb_ctx*>(user_data);
+  verify_with_keys(ctx, ctx->cached_keys.get());
+}
+
+/* Verifies the JWT with the keys found at ctx->key_url, fetching them unless
+   they are cached. Takes ownership of ctx. */
+static void get_keys_and_verify(verifier_cb_ctx* ctx) {
+  bool refresh;
+  std::string key_url = ctx->key_url.host + ctx->key_url.path;
+  ctx->cached_keys = ctx->key_cache->GetKeys(key_url, &refresh);
+  if (ctx->cached_keys != nullptr && !refresh &&
+      ctx->cached_keys->Find(ctx->header->kid, ctx->header->alg) == nullptr) {
+    /* The issuer may have rotated its keys since we cached them. */
+    refresh = ctx->key_cache->RefetchOnKeyMiss(key_url);
+  }
+  if (ctx->cached_keys != nullptr && !refresh) {
+    GRPC_CLOSURE_INIT(&ctx->on_cached_keys, on_cached_keys, ctx,
+                      grpc_schedule_on_exec_ctx);
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, &ctx->on_cached_keys,
+                            GRPC_ERROR_NONE);
+    return;
+  }
+  ctx->refreshing_keys = refresh;
+
+  grpc_httpcli_request req;
+  memset(&req, 0, sizeof(grpc_httpcli_request));
+  req.handshaker = &grpc_httpcli_ssl;
+  req.host = const_cast<char*>(ctx->key_url.host.c_str());
+  req.http.path = const_cast<char*>(ctx->key_url.path.c_str());
+
+  /* TODO(ctiller): Carry the resource_quota in ctx and share it with the host
+     channel. This would allow us to cancel an authentication query when under
+     extreme memory pressure. */
+  grpc_resource_quota* resource_quota =
+      grpc_resource_quota_create("jwt_verifier");
+  grpc_httpcli_get(
+      &ctx->verifier->http_ctx, &ctx->pollent, resource_quota, &req,
+      grpc_core::ExecCtx::Get()->Now() + grpc_jwt_verifier_max_delay,
+      GRPC_CLOSURE_CREATE(on_keys_retrieved, ctx, grpc_schedule_on_exec_ctx),
+      &ctx->responses[HTTP_RESPONSE_KEYS]);
+}
+
 static void on_openid_config_retrieved(void* user_data,
                                        grpc_error_handle /*error*/) {
   verifier_cb_ctx* ctx = static_cast<verifier_cb_ctx*>(user_data);
   const grpc_http_response* response = &ctx->responses[HTTP_RESPONSE_OPENID];
   Json json = json_from_http(response);
-  grpc_httpcli_request req;
   const char* jwks_uri;
-  grpc_resource_quota* resource_quota = nullptr;
+  const char* path;
   const Json* cur;
 
-  /* TODO(jboeuf): Cache the jwks_uri in order to avoid this hop next time. */
   if (json.type() == Json::Type::JSON_NULL) goto error;
   cur = find_property_by_name(json, "jwks_uri");
   if (cur == nullptr) {
@@ -691,25 +988,18 @@ static void on_openid_config_retrieved(void* user_data,
     goto error;
   }
   jwks_uri += 8;
-  req.handshaker = &grpc_httpcli_ssl;
-  req.host = gpr_strdup(jwks_uri);
-  req.http.path = const_cast<char*>(strchr(jwks_uri, '/'));
-  if (req.http.path == nullptr) {
-    req.http.path = const_cast<char*>("");
+  path = strchr(jwks_uri, '/');
+  if (path == nullptr) {
+    ctx->key_url.host = jwks_uri;
+    ctx->key_url.path = "";
   } else {
-    *(req.host + (req.http.path - jwks_uri)) = '\0';
+    ctx->key_url.host = std::string(jwks_uri, path - jwks_uri);
+    ctx->key_url.path = path;
   }
-
-  /* TODO(ctiller): Carry the resource_quota in ctx and share it with the host
-     channel. This would allow us to cancel an authentication query when under
-     extreme memory pressure. */
-  resource_quota = grpc_resource_quota_create("jwt_verifier");
-  grpc_httpcli_get(
-      &ctx->verifier->http_ctx, &ctx->pollent, resource_quota, &req,
-      grpc_core::ExecCtx::Get()->Now() + grpc_jwt_verifier_max_delay,
-      GRPC_CLOSURE_CREATE(on_keys_retrieved, ctx, grpc_schedule_on_exec_ctx),
-      &ctx->responses[HTTP_RESPONSE_KEYS]);
-  gpr_free(req.host);
+  ctx->key_cache->UpdateJwksUri(
+      ctx->openid_issuer, ctx->key_url,
+      grpc_jwt_cache_ttl_from_http_response(response));
+  get_keys_and_verify(ctx);
   return;
 
 error:
@@ -764,17 +1054,16 @@ const char* grpc_jwt_issuer_email_domain(const char* issuer) {
 /* Takes ownership of ctx. */
 static void retrieve_key_and_verify(verifier_cb_ctx* ctx) {
   const char* email_domain;
-  grpc_closure* http_cb;
   char* path_prefix = nullptr;
   const char* iss;
   grpc_httpcli_request req;
   grpc_resource_quota* resource_quota = nullptr;
   memset(&req, 0, sizeof(grpc_httpcli_request));
   req.handshaker = &grpc_httpcli_ssl;
-  http_response_index rsp_idx;
 
   GPR_ASSERT(ctx != nullptr && ctx->header != nullptr &&
              ctx->claims != nullptr);
+  ctx->key_cache = ctx->verifier->key_cache;
   iss = ctx->claims->iss;
   if (ctx->header->kid == nullptr) {
     gpr_log(GPR_ERROR, "Missing kid in jose header.");
@@ -799,30 +1088,31 @@ static void retrieve_key_and_verify(verifier_cb_ctx* ctx) {
       gpr_log(GPR_ERROR, "Missing mapping for issuer email.");
       goto error;
     }
-    req.host = gpr_strdup(mapping->key_url_prefix);
-    path_prefix = strchr(req.host, '/');
-    if (path_prefix == nullptr) {
-      gpr_asprintf(&req.http.path, "/%s", iss);
+    ctx->key_url.host = mapping->key_url_prefix;
+    size_t slash = ctx->key_url.host.find('/');
+    if (slash == std::string::npos) {
+      ctx->key_url.path = absl::StrCat("/", iss);
     } else {
-      *(path_prefix++) = '\0';
-      gpr_asprintf(&req.http.path, "/%s/%s", path_prefix, iss);
+      ctx->key_url.path =
+          absl::StrCat("/", ctx->key_url.host.substr(slash + 1), "/", iss);
+      ctx->key_url.host.resize(slash);
     }
-    http_cb =
-        GRPC_CLOSURE_CREATE(on_keys_retrieved, ctx, grpc_schedule_on_exec_ctx);
-    rsp_idx = HTTP_RESPONSE_KEYS;
+    get_keys_and_verify(ctx);
+    return;
+  }
+  if (ctx->key_cache->GetJwksUri(iss, &ctx->key_url)) {
+    get_keys_and_verify(ctx);
+    return;
+  }
+  ctx->openid_issuer = iss;
+  req.host = gpr_strdup(strstr(iss, "https://") == iss ? iss + 8 : iss);
+  path_prefix = strchr(req.host, '/');
+  if (path_prefix == nullptr) {
+    req.http.path = gpr_strdup(GRPC_OPENID_CONFIG_URL_SUFFIX);
   } else {
-    req.host = gpr_strdup(strstr(iss, "https://") == iss ? iss + 8 : iss);
-    path_prefix = strchr(req.host, '/');
-    if (path_prefix == nullptr) {
-      req.http.path = gpr_strdup(GRPC_OPENID_CONFIG_URL_SUFFIX);
-    } else {
-      *(path_prefix++) = 0;
-      gpr_asprintf(&req.http.path, "/%s%s", path_prefix,
-                   GRPC_OPENID_CONFIG_URL_SUFFIX);
-    }
-    http_cb = GRPC_CLOSURE_CREATE(on_openid_config_retrieved, ctx,
-                                  grpc_schedule_on_exec_ctx);
-    rsp_idx = HTTP_RESPONSE_OPENID;
+    *(path_prefix++) = 0;
+    gpr_asprintf(&req.http.path, "/%s%s", path_prefix,
+                 GRPC_OPENID_CONFIG_URL_SUFFIX);
   }
 
   /* TODO(ctiller): Carry the resource_quota in ctx and share it with the host
@@ -831,8 +1121,10 @@ static void retrieve_key_and_verify(verifier_cb_ctx* ctx) {
   resource_quota = grpc_resource_quota_create("jwt_verifier");
   grpc_httpcli_get(
       &ctx->verifier->http_ctx, &ctx->pollent, resource_quota, &req,
-      grpc_core::ExecCtx::Get()->Now() + grpc_jwt_verifier_max_delay, http_cb,
-      &ctx->responses[rsp_idx]);
+      grpc_core::ExecCtx::Get()->Now() + grpc_jwt_verifier_max_delay,
+      GRPC_CLOSURE_CREATE(on_openid_config_retrieved, ctx,
+                          grpc_schedule_on_exec_ctx),
+      &ctx->responses[HTTP_RESPONSE_OPENID]);
   gpr_free(req.host);
   gpr_free(req.http.path);
   return;
@@ -890,9 +1182,9 @@ error:
 grpc_jwt_verifier* grpc_jwt_verifier_create(
     const grpc_jwt_verifier_email_domain_key_url_mapping* mappings,
     size_t num_mappings) {
-  grpc_jwt_verifier* v =
-      static_cast<grpc_jwt_verifier*>(gpr_zalloc(sizeof(grpc_jwt_verifier)));
+  grpc_jwt_verifier* v = new grpc_jwt_verifier();
   grpc_httpcli_context_init(&v->http_ctx);
+  v->key_cache = grpc_core::MakeRefCounted<grpc_core::JwtKeyCache>();
 
   /* We know at least of one mapping. */
   v->allocated_mappings = 1 + num_mappings;
@@ -922,5 +1214,5 @@ void grpc_jwt_verifier_destroy(grpc_jwt_verifier* v) {
     }
     gpr_free(v->mappings);
   }
-  gpr_free(v);
+  delete v;
 }
@@ -24,6 +24,7 @@
 #include <grpc/slice.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/http/parser.h"
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/json/json.h"
 
@@ -84,6 +85,19 @@ struct grpc_jwt_verifier_email_domain_key_url_mapping {
 extern gpr_timespec grpc_jwt_verifier_clock_skew;
 extern grpc_millis grpc_jwt_verifier_max_delay;
 
+/* Fetched key sets (and the jwks_uri of OpenID issuers) are cached by the
+   verifier for as long as the Cache-Control max-age of the HTTP response
+   allows, capped at grpc_jwt_verifier_key_cache_max_ttl. Responses without a
+   max-age directive are cached for grpc_jwt_verifier_key_cache_default_ttl.
+   Not thread-safe either. */
+extern grpc_millis grpc_jwt_verifier_key_cache_default_ttl;
+extern grpc_millis grpc_jwt_verifier_key_cache_max_ttl;
+
+/* When a JWT names a key that is not in the cached key set of its issuer, the
+   key set is refetched, at most once per
+   grpc_jwt_verifier_key_miss_refetch_interval. Not thread-safe either. */
+extern grpc_millis grpc_jwt_verifier_key_miss_refetch_interval;
+
 /* The verifier can be created with some custom mappings to help with key
    discovery in the case where the issuer is an email address.
    mappings can be NULL in which case num_mappings MUST be 0.
@@ -118,5 +132,7 @@ grpc_jwt_claims* grpc_jwt_claims_from_json(grpc_core::Json json);
 grpc_jwt_verifier_status grpc_jwt_claims_check(const grpc_jwt_claims* claims,
                                                const char* audience);
 const char* grpc_jwt_issuer_email_domain(const char* issuer);
+grpc_millis grpc_jwt_cache_ttl_from_http_response(
+    const grpc_http_response* response);
 
 #endif /* GRPC_CORE_LIB_SECURITY_CREDENTIALS_JWT_JWT_VERIFIER_H */
@@ -37,7 +37,10 @@
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/iomgr/load_file.h"
+#include "src/core/lib/iomgr/pollset.h"
+#include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/json/json.h"
 #include "src/core/lib/security/util/json_util.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -127,7 +130,7 @@ void grpc_auth_refresh_token_destruct(grpc_auth_refresh_token* refresh_token) {
 
 grpc_oauth2_token_fetcher_credentials::
     ~grpc_oauth2_token_fetcher_credentials() {
-  GRPC_MDELEM_UNREF(access_token_md_);
+  grpc_credentials_mdelem_array_destroy(&access_token_md_array_);
   gpr_mu_destroy(&mu_);
   grpc_pollset_set_destroy(grpc_polling_entity_pollset_set(&pollent_));
   grpc_httpcli_context_destroy(&httpcli_context_);
@@ -231,6 +234,119 @@ static void on_oauth2_token_fetcher_http_response(void* user_data,
   c->on_http_response(r, error);
 }
 
+// Polls pollent_ while a proactive refresh is in flight. No call waits on
+// such a fetch, so with pollers other than epoll1 (where any polling thread
+// serves every fd) nothing else would drive it. Like the client channel's
+// backup poller, it polls from a timer rather than from a thread of its own.
+class grpc_oauth2_token_fetcher_credentials::RefreshPoller {
+ public:
+  static RefreshPoller* Start(
+      grpc_core::RefCountedPtr<grpc_call_credentials> creds) {
+    RefreshPoller* self = new RefreshPoller(std::move(creds));
+    gpr_mu_lock(self->mu_);
+    self->ScheduleLocked();
+    gpr_mu_unlock(self->mu_);
+    return self;
+  }
+
+  // Stops polling. The poller deletes itself afterwards.
+  void Stop() {
+    gpr_mu_lock(mu_);
+    done_ = true;
+    grpc_timer_cancel(&timer_);
+    gpr_mu_unlock(mu_);
+  }
+
+ private:
+  static constexpr grpc_millis kPollIntervalMs = 100;
+
+  explicit RefreshPoller(grpc_core::RefCountedPtr<grpc_call_credentials> creds)
+      : creds_(std::move(creds)) {
+    pollset_ = static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+    grpc_pollset_init(pollset_, &mu_);
+    grpc_pollset_set_add_pollset(pollset_set(), pollset_);
+    GRPC_CLOSURE_INIT(&on_timer_, OnTimer, this, grpc_schedule_on_exec_ctx);
+    grpc_iomgr_register_object(&iomgr_object_, "oauth2_refresh_poller");
+  }
+
+  grpc_pollset_set* pollset_set() {
+    return grpc_polling_entity_pollset_set(
+        &static_cast<grpc_oauth2_token_fetcher_credentials*>(creds_.get())
+             ->pollent_);
+  }
+
+  void ScheduleLocked() {
+    grpc_timer_init(&timer_, grpc_core::ExecCtx::Get()->Now() + kPollIntervalMs,
+                    &on_timer_);
+  }
+
+  // Runs once per interval, and once more after Stop().
+  static void OnTimer(void* arg, grpc_error_handle /*error*/) {
+    RefreshPoller* self = static_cast<RefreshPoller*>(arg);
+    gpr_mu_lock(self->mu_);
+    if (self->done_) {
+      gpr_mu_unlock(self->mu_);
+      self->Shutdown();
+      return;
+    }
+    GRPC_LOG_IF_ERROR("pollset_work",
+                      grpc_pollset_work(self->pollset_, nullptr,
+                                        grpc_core::ExecCtx::Get()->Now()));
+    self->ScheduleLocked();
+    gpr_mu_unlock(self->mu_);
+  }
+
+  void Shutdown() {
+    grpc_pollset_set_del_pollset(pollset_set(), pollset_);
+    GRPC_CLOSURE_INIT(&destroy_closure_, Destroy, this,
+                      grpc_schedule_on_exec_ctx);
+    gpr_mu_lock(mu_);
+    grpc_pollset_shutdown(pollset_, &destroy_closure_);
+    gpr_mu_unlock(mu_);
+  }
+
+  static void Destroy(void* arg, grpc_error_handle /*error*/) {
+    RefreshPoller* self = static_cast<RefreshPoller*>(arg);
+    grpc_pollset_destroy(self->pollset_);
+    gpr_free(self->pollset_);
+    self->creds_.reset();
+    grpc_iomgr_unregister_object(&self->iomgr_object_);
+    delete self;
+  }
+
+  grpc_core::RefCountedPtr<grpc_call_credentials> creds_;
+  grpc_pollset* pollset_;
+  gpr_mu* mu_;
+  bool done_ = false;
+  grpc_timer timer_;
+  grpc_closure on_timer_;
+  grpc_closure destroy_closure_;
+  grpc_iomgr_object iomgr_object_;
+};
+
+// Returns when to start refreshing a token obtained at now, that stops being
+// usable at usable_until. rng_state is the state of the jitter's generator.
+static gpr_timespec proactive_refresh_time(gpr_timespec now,
+                                           gpr_timespec usable_until,
+                                           uint32_t* rng_state) {
+  gpr_timespec window = gpr_time_from_seconds(
+      GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_SECS, GPR_TIMESPAN);
+  gpr_timespec quarter_lifetime = gpr_time_from_millis(
+      gpr_time_to_millis(gpr_time_sub(usable_until, now)) / 4, GPR_TIMESPAN);
+  if (gpr_time_cmp(quarter_lifetime, window) < 0) window = quarter_lifetime;
+  // Spread refreshes over the second half of the window so that credentials
+  // created together do not all hit the token server at once.
+  // As in BackOff, a linear congruential generator rather than rand(), whose
+  // global state we have no control over.
+  constexpr uint32_t two_raise_31 = uint32_t(1) << 31;
+  *rng_state = (1103515245 * *rng_state + 12345) % two_raise_31;
+  int64_t window_ms = gpr_time_to_millis(window);
+  int64_t jitter_ms = static_cast<int64_t>(
+      *rng_state / static_cast<double>(two_raise_31) * (window_ms / 2));
+  return gpr_time_sub(usable_until,
+                      gpr_time_from_millis(window_ms - jitter_ms, GPR_TIMESPAN));
+}
+
 void grpc_oauth2_token_fetcher_credentials::on_http_response(
     grpc_credentials_metadata_request* r, grpc_error_handle error) {
   grpc_mdelem access_token_md = GRPC_MDNULL;
@@ -240,18 +356,40 @@ void grpc_oauth2_token_fetcher_credentials::on_http_response(
           ? grpc_oauth2_token_fetcher_credentials_parse_server_response(
                 &r->response, &access_token_md, &token_lifetime)
           : GRPC_CREDENTIALS_ERROR;
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  gpr_timespec refresh_threshold = gpr_time_from_seconds(
+      GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS, GPR_TIMESPAN);
   // Update cache and grab list of pending requests.
   gpr_mu_lock(&mu_);
   token_fetch_pending_ = false;
-  access_token_md_ = GRPC_MDELEM_REF(access_token_md);
-  token_expiration_ =
-      status == GRPC_CREDENTIALS_OK
-          ? gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
-                         gpr_time_from_millis(token_lifetime, GPR_TIMESPAN))
-          : gpr_inf_past(GPR_CLOCK_MONOTONIC);
+  RefreshPoller* refresh_poller = refresh_poller_;
+  refresh_poller_ = nullptr;
+  if (status == GRPC_CREDENTIALS_OK) {
+    grpc_credentials_mdelem_array_destroy(&access_token_md_array_);
+    access_token_md_array_ = grpc_credentials_mdelem_array();
+    grpc_credentials_mdelem_array_add(&access_token_md_array_,
+                                      access_token_md);
+    token_expiration_ = gpr_time_add(
+        now, gpr_time_from_millis(token_lifetime, GPR_TIMESPAN));
+    token_refresh_time_ = proactive_refresh_time(
+        now, gpr_time_sub(token_expiration_, refresh_threshold),
+        &rng_state_);
+  } else if (access_token_md_array_.size > 0 &&
+             gpr_time_cmp(gpr_time_sub(token_expiration_, now),
+                          refresh_threshold) > 0) {
+    // A proactive refresh failed: keep using the current token for now.
+    token_refresh_time_ = gpr_time_add(
+        now, gpr_time_from_seconds(
+                 GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_RETRY_SECS, GPR_TIMESPAN));
+  } else {
+    grpc_credentials_mdelem_array_destroy(&access_token_md_array_);
+    access_token_md_array_ = grpc_credentials_mdelem_array();
+    token_expiration_ = gpr_inf_past(GPR_CLOCK_MONOTONIC);
+  }
   grpc_oauth2_pending_get_request_metadata* pending_request = pending_requests_;
   pending_requests_ = nullptr;
   gpr_mu_unlock(&mu_);
+  if (refresh_poller != nullptr) refresh_poller->Stop();
   // Invoke callbacks for all pending requests.
   while (pending_request != nullptr) {
     grpc_error_handle new_error = GRPC_ERROR_NONE;
@@ -275,26 +413,43 @@ void grpc_oauth2_token_fetcher_credentials::on_http_response(
   grpc_credentials_metadata_request_destroy(r);
 }
 
+void grpc_oauth2_token_fetcher_credentials::start_token_fetch(
+    bool proactive) {
+  if (proactive) {
+    RefreshPoller* refresh_poller = RefreshPoller::Start(Ref());
+    gpr_mu_lock(&mu_);
+    refresh_poller_ = refresh_poller;
+    gpr_mu_unlock(&mu_);
+  }
+  Ref().release();
+  fetch_oauth2(grpc_credentials_metadata_request_create(this->Ref()),
+               &httpcli_context_, &pollent_,
+               on_oauth2_token_fetcher_http_response,
+               grpc_core::ExecCtx::Get()->Now() +
+                   GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS * GPR_MS_PER_SEC);
+}
+
 bool grpc_oauth2_token_fetcher_credentials::get_request_metadata(
     grpc_polling_entity* pollent, grpc_auth_metadata_context /*context*/,
     grpc_credentials_mdelem_array* md_array, grpc_closure* on_request_metadata,
     grpc_error_handle* /*error*/) {
   // Check if we can use the cached token.
-  grpc_millis refresh_threshold =
-      GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS * GPR_MS_PER_SEC;
-  grpc_mdelem cached_access_token_md = GRPC_MDNULL;
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  bool start_fetch = false;
   gpr_mu_lock(&mu_);
-  if (!GRPC_MDISNULL(access_token_md_) &&
+  if (access_token_md_array_.size > 0 &&
       gpr_time_cmp(
-          gpr_time_sub(token_expiration_, gpr_now(GPR_CLOCK_MONOTONIC)),
+          gpr_time_sub(token_expiration_, now),
           gpr_time_from_seconds(GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS,
                                 GPR_TIMESPAN)) > 0) {
-    cached_access_token_md = GRPC_MDELEM_REF(access_token_md_);
-  }
-  if (!GRPC_MDISNULL(cached_access_token_md)) {
+    grpc_credentials_mdelem_array_append(md_array, &access_token_md_array_);
+    // Refresh the token in the background if it expires soon.
+    if (!token_fetch_pending_ && gpr_time_cmp(now, token_refresh_time_) >= 0) {
+      token_fetch_pending_ = true;
+      start_fetch = true;
+    }
     gpr_mu_unlock(&mu_);
-    grpc_credentials_mdelem_array_add(md_array, cached_access_token_md);
-    GRPC_MDELEM_UNREF(cached_access_token_md);
+    if (start_fetch) start_token_fetch(/*proactive=*/true);
     return true;
   }
   // Couldn't get the token from the cache.
@@ -309,22 +464,22 @@ bool grpc_oauth2_token_fetcher_credentials::get_request_metadata(
       pollent, grpc_polling_entity_pollset_set(&pollent_));
   pending_request->next = pending_requests_;
   pending_requests_ = pending_request;
-  bool start_fetch = false;
   if (!token_fetch_pending_) {
     token_fetch_pending_ = true;
     start_fetch = true;
   }
   gpr_mu_unlock(&mu_);
-  if (start_fetch) {
-    Ref().release();
-    fetch_oauth2(grpc_credentials_metadata_request_create(this->Ref()),
-                 &httpcli_context_, &pollent_,
-                 on_oauth2_token_fetcher_http_response,
-                 grpc_core::ExecCtx::Get()->Now() + refresh_threshold);
-  }
+  if (start_fetch) start_token_fetch(/*proactive=*/false);
   return false;
 }
 
+bool grpc_oauth2_token_fetcher_credentials::token_fetch_pending() {
+  gpr_mu_lock(&mu_);
+  bool pending = token_fetch_pending_;
+  gpr_mu_unlock(&mu_);
+  return pending;
+}
+
 void grpc_oauth2_token_fetcher_credentials::cancel_get_request_metadata(
     grpc_credentials_mdelem_array* md_array, grpc_error_handle error) {
   gpr_mu_lock(&mu_);
@@ -355,6 +510,8 @@ void grpc_oauth2_token_fetcher_credentials::cancel_get_request_metadata(
 grpc_oauth2_token_fetcher_credentials::grpc_oauth2_token_fetcher_credentials()
     : grpc_call_credentials(GRPC_CALL_CREDENTIALS_TYPE_OAUTH2),
       token_expiration_(gpr_inf_past(GPR_CLOCK_MONOTONIC)),
+      token_refresh_time_(gpr_inf_past(GPR_CLOCK_MONOTONIC)),
+      rng_state_(static_cast<uint32_t>(gpr_now(GPR_CLOCK_REALTIME).tv_nsec)),
       pollent_(grpc_polling_entity_create_from_pollset_set(
           grpc_pollset_set_create())) {
   gpr_mu_init(&mu_);
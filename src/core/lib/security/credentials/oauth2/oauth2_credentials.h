@@ -62,6 +62,19 @@ void grpc_auth_refresh_token_destruct(grpc_auth_refresh_token* refresh_token);
 //
 //  This object is a base for credentials that need to acquire an oauth2 token
 //  from an http service.
+//
+//  Calls only wait for a fetch when there is no usable token. Otherwise, once
+//  a token enters its last GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_SECS (or last
+//  quarter, if shorter) of validity, the first call past a jittered point of
+//  that window starts fetching a new token while all calls keep using the
+//  current one.
+
+// Upper bound on how long before a token stops being usable we start
+// refreshing it.
+#define GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_SECS 300
+
+// How long to wait before retrying a failed proactive refresh.
+#define GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_RETRY_SECS 5
 
 struct grpc_oauth2_pending_get_request_metadata {
   grpc_credentials_mdelem_array* md_array;
@@ -88,6 +101,9 @@ class grpc_oauth2_token_fetcher_credentials : public grpc_call_credentials {
                         grpc_error_handle error);
   std::string debug_string() override;
 
+  // Exposed for testing only.
+  bool token_fetch_pending();
+
  protected:
   virtual void fetch_oauth2(grpc_credentials_metadata_request* req,
                             grpc_httpcli_context* httpcli_context,
@@ -95,10 +111,21 @@ class grpc_oauth2_token_fetcher_credentials : public grpc_call_credentials {
                             grpc_millis deadline) = 0;
 
  private:
+  class RefreshPoller;
+
+  // Proactive fetches get a RefreshPoller: no call waits on them.
+  void start_token_fetch(bool proactive);
+
   gpr_mu mu_;
-  grpc_mdelem access_token_md_ = GRPC_MDNULL;
+  // The current token, as handed to every call. Empty when there is none.
+  grpc_credentials_mdelem_array access_token_md_array_;
   gpr_timespec token_expiration_;
+  // When to start refreshing access_token_md_ ahead of its expiration.
+  gpr_timespec token_refresh_time_;
+  // State of the generator jittering token_refresh_time_.
+  uint32_t rng_state_;
   bool token_fetch_pending_ = false;
+  RefreshPoller* refresh_poller_ = nullptr;
   grpc_oauth2_pending_get_request_metadata* pending_requests_ = nullptr;
   grpc_httpcli_context httpcli_context_;
   grpc_polling_entity pollent_;
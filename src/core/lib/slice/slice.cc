@@ -20,6 +20,8 @@
 
 #include <string.h>
 
+#include <atomic>
+
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -337,6 +339,90 @@ grpc_slice grpc_slice_malloc(size_t length) {
   return grpc_core::UnmanagedMemorySlice(length);
 }
 
+namespace {
+
+/* Memory layout of the slices created by grpc_slice_malloc_with_headroom:
+
+   +-----------+--------------------+---------------------------------------+
+   | refcount  | headroom           | bytes                                 |
+   +-----------+--------------------+---------------------------------------+
+
+   claimed_ is where the claimed part of the block starts: the start of the
+   bytes until the headroom gets claimed. */
+class HeadroomRefCount {
+ public:
+  static void Destroy(void* arg) {
+    HeadroomRefCount* r = static_cast<HeadroomRefCount*>(arg);
+    r->~HeadroomRefCount();
+    gpr_free(r);
+  }
+
+  static HeadroomRefCount* FromSlice(const grpc_slice& slice) {
+    if (slice.refcount == nullptr ||
+        slice.refcount->destroyer_fn() != Destroy) {
+      return nullptr;
+    }
+    return static_cast<HeadroomRefCount*>(slice.refcount->destroyer_arg());
+  }
+
+  explicit HeadroomRefCount(size_t headroom)
+      : base_(grpc_slice_refcount::Type::REGULAR, &refs_, Destroy, this,
+              &base_),
+        claimed_(headroom_begin() + headroom) {}
+
+  grpc_slice_refcount* base_refcount() { return &base_; }
+
+  uint8_t* headroom_begin() { return reinterpret_cast<uint8_t*>(this + 1); }
+
+  size_t Headroom(const uint8_t* start) {
+    uint8_t* claimed = claimed_.load(std::memory_order_relaxed);
+    return claimed == start ? claimed - headroom_begin() : 0;
+  }
+
+  bool Claim(uint8_t* start, size_t n) {
+    if (static_cast<size_t>(start - headroom_begin()) < n) return false;
+    return claimed_.compare_exchange_strong(start, start - n,
+                                            std::memory_order_acq_rel);
+  }
+
+ private:
+  grpc_slice_refcount base_;
+  grpc_core::RefCount refs_;
+  std::atomic<uint8_t*> claimed_;
+};
+
+}  // namespace
+
+grpc_slice grpc_slice_malloc_with_headroom(size_t length, size_t headroom) {
+  auto* rc = static_cast<HeadroomRefCount*>(
+      gpr_malloc(sizeof(HeadroomRefCount) + headroom + length));
+  new (rc) HeadroomRefCount(headroom);
+  grpc_slice slice;
+  slice.refcount = rc->base_refcount();
+  slice.data.refcounted.bytes = rc->headroom_begin() + headroom;
+  slice.data.refcounted.length = length;
+  return slice;
+}
+
+size_t grpc_core::SliceHeadroom(const grpc_slice& slice) {
+  HeadroomRefCount* rc = HeadroomRefCount::FromSlice(slice);
+  if (rc == nullptr) return 0;
+  return rc->Headroom(slice.data.refcounted.bytes);
+}
+
+bool grpc_core::ClaimSliceHeadroom(const grpc_slice& slice, size_t n,
+                                   grpc_slice* grown) {
+  HeadroomRefCount* rc = HeadroomRefCount::FromSlice(slice);
+  if (rc == nullptr || !rc->Claim(slice.data.refcounted.bytes, n)) {
+    return false;
+  }
+  rc->base_refcount()->Ref();
+  grown->refcount = slice.refcount;
+  grown->data.refcounted.bytes = slice.data.refcounted.bytes - n;
+  grown->data.refcounted.length = slice.data.refcounted.length + n;
+  return true;
+}
+
 grpc_core::UnmanagedMemorySlice::UnmanagedMemorySlice(size_t length) {
   if (length > sizeof(data.inlined.bytes)) {
     HeapInit(length);
@@ -163,6 +163,9 @@ struct grpc_slice_refcount {
 
   grpc_slice_refcount* sub_refcount() const { return sub_refcount_; }
 
+  DestroyerFn destroyer_fn() const { return dest_fn_; }
+  void* destroyer_arg() const { return destroy_fn_arg_; }
+
  private:
   grpc_core::RefCount* ref_ = nullptr;
   const Type ref_type_ = Type::REGULAR;
@@ -351,6 +354,21 @@ grpc_core::UnmanagedMemorySlice grpc_slice_sub_no_ref(
 
 namespace grpc_core {
 
+// Slices from grpc_slice_malloc_with_headroom() have unused bytes before their
+// start. Whoever holds a slice that starts where the used part of the
+// allocation starts can claim the bytes just before it, e.g. to write a header
+// there rather than in a slice of its own. Each byte of headroom is claimed
+// once at most, so the claimer is the only one to ever see it.
+
+// Returns the headroom that \a slice could claim now.
+size_t SliceHeadroom(const grpc_slice& slice);
+
+// Claims the \a n bytes before the start of \a slice, and on success sets
+// \a grown to a new reference to them followed by the bytes of \a slice.
+// Fails if \a slice has no headroom or less than \a n bytes of it, or if a
+// holder of another slice of the same allocation claimed it first.
+bool ClaimSliceHeadroom(const grpc_slice& slice, size_t n, grpc_slice* grown);
+
 struct SliceHash {
   std::size_t operator()(const grpc_slice& slice) const {
     return grpc_slice_hash_internal(slice);
@@ -50,6 +50,7 @@
 #include "src/core/lib/gprpp/ref_counted.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/profiling/usdt.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/slice/slice_utils.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -500,6 +501,9 @@ grpc_error_handle grpc_call_create(const grpc_call_create_args* args,
     }
   }
 
+  // The path of server calls is not known yet: it is empty.
+  GRPC_USDT4(call_start, call, call->is_client, GRPC_SLICE_START_PTR(path),
+             GRPC_SLICE_LENGTH(path));
   grpc_slice_unref_internal(path);
 
   return error;
@@ -766,6 +770,7 @@ static void set_final_status(grpc_call* call, grpc_error_handle error) {
         channelz_channel->RecordCallSucceeded();
       }
     }
+    GRPC_USDT3(call_end, call, true, *call->final_op.client.status);
   } else {
     *call->final_op.server.cancelled =
         error != GRPC_ERROR_NONE || !call->sent_server_trailing_metadata;
@@ -780,6 +785,7 @@ static void set_final_status(grpc_call* call, grpc_error_handle error) {
         channelz_node->RecordCallSucceeded();
       }
     }
+    GRPC_USDT3(call_end, call, false, *call->final_op.server.cancelled);
     GRPC_ERROR_UNREF(error);
   }
 }
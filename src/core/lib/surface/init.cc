@@ -34,6 +34,7 @@
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/contention_profiler.h"
 #include "src/core/lib/gprpp/fork.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/http/parser.h"
@@ -69,6 +70,7 @@ static bool g_shutting_down ABSL_GUARDED_BY(g_init_mu) = false;
 
 static void do_basic_init(void) {
   gpr_log_verbosity_init();
+  grpc_core::ContentionProfiler::InitFromEnvironment();
   g_init_mu = new grpc_core::Mutex();
   g_shutting_down_cv = new grpc_core::CondVar();
   grpc_register_built_in_plugins();
@@ -185,6 +187,7 @@ void grpc_shutdown_internal_locked(void)
     grpc_stats_shutdown();
     grpc_core::Fork::GlobalShutdown();
   }
+  grpc_core::ContentionProfiler::LogReportIfEnabled();
   grpc_core::ExecCtx::GlobalShutdown();
   grpc_core::ApplicationCallbackExecCtx::GlobalShutdown();
   g_shutting_down = false;
@@ -39,6 +39,7 @@
 
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/channel/concurrency_limiter.h"
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/spinlock.h"
@@ -133,6 +134,8 @@ struct Server::RegisteredMethod {
   const uint32_t flags;
   // One request matcher per method.
   std::unique_ptr<RequestMatcherInterface> matcher;
+  // Set at Start() if the server keeps per-method stats.
+  RefCountedPtr<MethodStats> stats;
 };
 
 //
@@ -530,11 +533,31 @@ RefCountedPtr<channelz::ServerNode> CreateChannelzNode(
   return channelz_node;
 }
 
+// Copies the server's args, adding the concurrency limiter that all its
+// connections share if GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY is set.
+grpc_channel_args* CopyServerChannelArgs(const grpc_channel_args* args) {
+  if (!grpc_channel_args_find_bool(args, GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY,
+                                   false) ||
+      ConcurrencyLimiter::FromChannelArgs(args) != nullptr) {
+    return grpc_channel_args_copy(args);
+  }
+  auto limiter = MakeRefCounted<ConcurrencyLimiter>(
+      ConcurrencyLimiter::ServerOptionsFromChannelArgs(args));
+  grpc_arg arg = limiter->MakeChannelArg();
+  return grpc_channel_args_copy_and_add(args, &arg, 1);
+}
+
 }  // namespace
 
 Server::Server(const grpc_channel_args* args)
-    : channel_args_(grpc_channel_args_copy(args)),
-      channelz_node_(CreateChannelzNode(args)) {}
+    : channel_args_(CopyServerChannelArgs(args)),
+      channelz_node_(CreateChannelzNode(args)) {
+  ConcurrencyLimiter* limiter =
+      ConcurrencyLimiter::FromChannelArgs(channel_args_);
+  if (limiter != nullptr && channelz_node_ != nullptr) {
+    channelz_node_->SetConcurrencyLimiter(limiter->Ref());
+  }
+}
 
 Server::~Server() {
   grpc_channel_args_destroy(channel_args_);
@@ -570,10 +593,18 @@ void Server::Start() {
   if (unregistered_request_matcher_ == nullptr) {
     unregistered_request_matcher_ = absl::make_unique<RealRequestMatcher>(this);
   }
+  const bool keep_method_stats = grpc_channel_args_find_bool(
+      channel_args_, GRPC_ARG_SERVER_METHOD_STATS, false);
   for (std::unique_ptr<RegisteredMethod>& rm : registered_methods_) {
     if (rm->matcher == nullptr) {
       rm->matcher = absl::make_unique<RealRequestMatcher>(this);
     }
+    if (keep_method_stats) {
+      rm->stats = MakeRefCounted<MethodStats>(rm->method, rm->host);
+      if (channelz_node_ != nullptr) {
+        channelz_node_->AddMethodStats(rm->stats);
+      }
+    }
   }
   {
     MutexLock lock(&mu_global_);
@@ -597,6 +628,14 @@ void Server::Start() {
   starting_cv_.Signal();
 }
 
+std::vector<RefCountedPtr<MethodStats>> Server::GetMethodStats() const {
+  std::vector<RefCountedPtr<MethodStats>> stats;
+  for (const std::unique_ptr<RegisteredMethod>& rm : registered_methods_) {
+    if (rm->stats != nullptr) stats.push_back(rm->stats);
+  }
+  return stats;
+}
+
 grpc_error_handle Server::SetupTransport(
     grpc_transport* transport, grpc_pollset* accepting_pollset,
     const grpc_channel_args* args,
@@ -1245,6 +1284,10 @@ void Server::CallData::Start(grpc_call_element* elem) {
 }
 
 void Server::CallData::Publish(size_t cq_idx, RequestedCall* rc) {
+  if (method_stats_ != nullptr) {
+    publish_time_ = gpr_get_cycle_counter();
+    published_ = true;
+  }
   grpc_call_set_completion_queue(call_, rc->cq_bound_to_call);
   *rc->call = call_;
   cq_new_ = server_->cqs_[cq_idx];
@@ -1321,6 +1364,8 @@ void Server::CallData::StartNewRpc(grpc_call_element* elem) {
     if (rm != nullptr) {
       matcher_ = rm->server_registered_method->matcher.get();
       payload_handling = rm->server_registered_method->payload_handling;
+      method_stats_ = rm->server_registered_method->stats.get();
+      if (method_stats_ != nullptr) start_time_ = gpr_get_cycle_counter();
     }
   }
   // Start recv_message op if needed.
@@ -1366,6 +1411,10 @@ void Server::CallData::StartTransportStreamOpBatchImpl(
     batch->payload->recv_initial_metadata.recv_flags =
         &recv_initial_metadata_flags_;
   }
+  if (batch->send_trailing_metadata && method_stats_ != nullptr) {
+    status_time_ = gpr_get_cycle_counter();
+    status_sent_ = true;
+  }
   if (batch->recv_trailing_metadata) {
     original_recv_trailing_metadata_ready_ =
         batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready;
@@ -1454,12 +1503,38 @@ grpc_error_handle Server::CallData::InitCallElement(
 }
 
 void Server::CallData::DestroyCallElement(
-    grpc_call_element* elem, const grpc_call_final_info* /*final_info*/,
+    grpc_call_element* elem, const grpc_call_final_info* final_info,
     grpc_closure* /*ignored*/) {
   auto* calld = static_cast<CallData*>(elem->call_data);
+  if (calld->published_) calld->RecordMethodStats(final_info);
   calld->~CallData();
 }
 
+namespace {
+
+uint64_t NanosBetween(gpr_cycle_counter start, gpr_cycle_counter end) {
+  gpr_timespec elapsed = gpr_cycle_counter_sub(end, start);
+  if (elapsed.tv_sec < 0) return 0;
+  return static_cast<uint64_t>(elapsed.tv_sec) * GPR_NS_PER_SEC +
+         elapsed.tv_nsec;
+}
+
+}  // namespace
+
+void Server::CallData::RecordMethodStats(
+    const grpc_call_final_info* final_info) {
+  // Calls that end without a status, e.g. when cancelled, are charged the
+  // time until they were destroyed.
+  gpr_cycle_counter end_time =
+      status_sent_ ? status_time_ : gpr_get_cycle_counter();
+  const grpc_transport_stream_stats& transport_stats =
+      final_info->stats.transport_stream_stats;
+  method_stats_->RecordCall(NanosBetween(start_time_, publish_time_),
+                            NanosBetween(publish_time_, end_time),
+                            transport_stats.incoming.data_bytes,
+                            transport_stats.outgoing.data_bytes);
+}
+
 void Server::CallData::StartTransportStreamOpBatch(
     grpc_call_element* elem, grpc_transport_stream_op_batch* batch) {
   auto* calld = static_cast<CallData*>(elem->call_data);
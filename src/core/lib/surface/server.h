@@ -31,7 +31,9 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/debug/method_stats.h"
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/surface/completion_queue.h"
 #include "src/core/lib/transport/transport.h"
@@ -115,6 +117,10 @@ class Server : public InternallyRefCounted<Server> {
 
   bool HasOpenConnections() ABSL_LOCKS_EXCLUDED(mu_global_);
 
+  // Returns the stats of the registered methods, if the server was started
+  // with GRPC_ARG_SERVER_METHOD_STATS.
+  std::vector<RefCountedPtr<MethodStats>> GetMethodStats() const;
+
   // Adds a listener to the server.  When the server starts, it will call
   // the listener's Start() method, and when it shuts down, it will orphan
   // the listener.
@@ -266,7 +272,7 @@ class Server : public InternallyRefCounted<Server> {
     static grpc_error_handle InitCallElement(
         grpc_call_element* elem, const grpc_call_element_args* args);
     static void DestroyCallElement(grpc_call_element* elem,
-                                   const grpc_call_final_info* /*final_info*/,
+                                   const grpc_call_final_info* final_info,
                                    grpc_closure* /*ignored*/);
     static void StartTransportStreamOpBatch(
         grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
@@ -284,6 +290,8 @@ class Server : public InternallyRefCounted<Server> {
     static void RecvInitialMetadataReady(void* arg, grpc_error_handle error);
     static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
 
+    void RecordMethodStats(const grpc_call_final_info* final_info);
+
     RefCountedPtr<Server> server_;
 
     grpc_call* call_;
@@ -319,6 +327,14 @@ class Server : public InternallyRefCounted<Server> {
     grpc_closure publish_;
 
     CallCombiner* call_combiner_;
+
+    // Set for calls to registered methods that keep stats.
+    MethodStats* method_stats_ = nullptr;
+    gpr_cycle_counter start_time_ = 0;
+    gpr_cycle_counter publish_time_ = 0;
+    gpr_cycle_counter status_time_ = 0;
+    bool published_ = false;
+    bool status_sent_ = false;
   };
 
   struct Listener {
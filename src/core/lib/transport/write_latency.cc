@@ -0,0 +1,111 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/transport/write_latency.h"
+
+#include <atomic>
+
+#include "absl/strings/str_format.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Writes are sampled, so a single set of counters is contended enough.
+struct StageCounters {
+  std::atomic<uint64_t> sum;
+  std::atomic<uint64_t> buckets[MethodStats::kNumBuckets];
+};
+
+StageCounters g_stages[WriteLatency::kNumStages];
+
+}  // namespace
+
+const char* WriteLatency::StageName(Stage stage) {
+  switch (stage) {
+    case kApp:
+      return "app";
+    case kWriteQueue:
+      return "write_queue";
+    case kKernel:
+      return "kernel";
+    case kQdisc:
+      return "qdisc";
+    case kNetwork:
+      return "network";
+    case kNumStages:
+      break;
+  }
+  GPR_UNREACHABLE_CODE(return "");
+}
+
+void WriteLatencyStats::Record(const WriteLatency& latency) {
+  for (int i = 0; i < WriteLatency::kNumStages; ++i) {
+    if (latency.stage_ns[i] < 0) continue;
+    uint64_t value = static_cast<uint64_t>(latency.stage_ns[i]);
+    g_stages[i].sum.fetch_add(value, std::memory_order_relaxed);
+    g_stages[i]
+        .buckets[MethodStats::BucketFor(value)]
+        .fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+WriteLatencyStats::Snapshot WriteLatencyStats::GetSnapshot() {
+  Snapshot snapshot;
+  for (int i = 0; i < WriteLatency::kNumStages; ++i) {
+    MethodStats::Histogram& histogram = snapshot.stages[i];
+    histogram.sum_ = g_stages[i].sum.load(std::memory_order_relaxed);
+    for (int b = 0; b < MethodStats::kNumBuckets; ++b) {
+      uint64_t count = g_stages[i].buckets[b].load(std::memory_order_relaxed);
+      histogram.buckets_[b] = count;
+      histogram.count_ += count;
+    }
+  }
+  return snapshot;
+}
+
+void WriteLatencyStats::Reset() {
+  for (StageCounters& stage : g_stages) {
+    stage.sum.store(0, std::memory_order_relaxed);
+    for (auto& bucket : stage.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::string WriteLatencyStats::Report() {
+  Snapshot snapshot = GetSnapshot();
+  std::string report = absl::StrFormat(
+      "Write latency breakdown, in microseconds:\n%-12s %10s %10s %10s %10s "
+      "%10s\n",
+      "stage", "writes", "p50", "p90", "p99", "p999");
+  for (int i = 0; i < WriteLatency::kNumStages; ++i) {
+    const MethodStats::Histogram& histogram = snapshot.stages[i];
+    absl::StrAppendFormat(
+        &report, "%-12s %10d %10.1f %10.1f %10.1f %10.1f\n",
+        WriteLatency::StageName(static_cast<WriteLatency::Stage>(i)),
+        histogram.count(), histogram.Percentile(50) / 1e3,
+        histogram.Percentile(90) / 1e3, histogram.Percentile(99) / 1e3,
+        histogram.Percentile(99.9) / 1e3);
+  }
+  return report;
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,97 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_TRANSPORT_WRITE_LATENCY_H
+#define GRPC_CORE_LIB_TRANSPORT_WRITE_LATENCY_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <string>
+
+#include <grpc/support/time.h>
+
+#include "src/core/lib/debug/method_stats.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+
+namespace grpc_core {
+
+// Where the time to put one write of a call on the wire went, from when the
+// previous write of the call was done to when the peer acknowledged the last
+// byte of the write. The kernel stages come from the TX timestamps Linux
+// reports for sockets with SO_TIMESTAMPING, for streams sampled with
+// GRPC_ARG_HTTP2_WRITE_TIMESTAMPS_SAMPLING_PERIOD.
+struct WriteLatency {
+  enum Stage {
+    // From when the transport was done with the previous write of the call
+    // (or the creation of its stream, for the first write) to when it got
+    // this one: time spent above the transport, in the application and the
+    // filters. 0 when the write was queued before the previous one was done.
+    kApp,
+    // From when the transport got the write to its sendmsg(): the
+    // transport's write queue, including flow control stalls.
+    kWriteQueue,
+    // From sendmsg() to the packet scheduler: the TCP stack, including
+    // waiting for the congestion and send windows.
+    kKernel,
+    // Through the packet scheduler (qdisc) to the NIC driver.
+    kQdisc,
+    // From the NIC driver to the ACK of the peer: the NIC, the network and
+    // the peer's TCP stack.
+    kNetwork,
+    kNumStages,
+  };
+
+  static const char* StageName(Stage stage);
+
+  // The time spent in each stage, in nanoseconds; -1 when the timestamps of
+  // the stage were not reported, e.g. if the connection closed first.
+  int64_t stage_ns[kNumStages];
+  // The offset of the last byte of the write in the stream.
+  uint32_t byte_offset = 0;
+  bool is_client = false;
+};
+
+// Receives the write latencies of a call. The transport holds a ref for each
+// write waiting for its timestamps, since the peer may acknowledge a write
+// after the call ended.
+class WriteLatencyObserver : public RefCounted<WriteLatencyObserver> {
+ public:
+  // Called from the endpoint's handling of the timestamps, under its lock:
+  // must not block.
+  virtual void OnWriteLatency(const WriteLatency& latency) = 0;
+};
+
+// Process-wide histograms of the write latencies reported so far, per stage.
+class WriteLatencyStats {
+ public:
+  struct Snapshot {
+    MethodStats::Histogram stages[WriteLatency::kNumStages];
+  };
+
+  static void Record(const WriteLatency& latency);
+  static Snapshot GetSnapshot();
+  static void Reset();
+  // Returns the count and percentiles of each stage, in microseconds.
+  static std::string Report();
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_TRANSPORT_WRITE_LATENCY_H */
@@ -54,6 +54,8 @@ void grpc_client_idle_filter_init(void);
 void grpc_client_idle_filter_shutdown(void);
 void grpc_max_age_filter_init(void);
 void grpc_max_age_filter_shutdown(void);
+void grpc_adaptive_concurrency_filter_init(void);
+void grpc_adaptive_concurrency_filter_shutdown(void);
 void grpc_message_size_filter_init(void);
 void grpc_message_size_filter_shutdown(void);
 void grpc_service_config_channel_arg_filter_init(void);
@@ -67,6 +69,8 @@ void FaultInjectionFilterInit(void);
 void FaultInjectionFilterShutdown(void);
 void GrpcLbPolicyRingHashInit(void);
 void GrpcLbPolicyRingHashShutdown(void);
+void GrpcLbPolicyOutlierDetectionInit(void);
+void GrpcLbPolicyOutlierDetectionShutdown(void);
 }  // namespace grpc_core
 
 #ifndef GRPC_NO_XDS
@@ -121,6 +125,8 @@ void grpc_register_built_in_plugins(void) {
                        grpc_lb_policy_round_robin_shutdown);
   grpc_register_plugin(grpc_core::GrpcLbPolicyRingHashInit,
                        grpc_core::GrpcLbPolicyRingHashShutdown);
+  grpc_register_plugin(grpc_core::GrpcLbPolicyOutlierDetectionInit,
+                       grpc_core::GrpcLbPolicyOutlierDetectionShutdown);
   grpc_register_plugin(grpc_resolver_dns_ares_init,
                        grpc_resolver_dns_ares_shutdown);
   grpc_register_plugin(grpc_resolver_dns_native_init,
@@ -131,6 +137,8 @@ void grpc_register_built_in_plugins(void) {
                        grpc_client_idle_filter_shutdown);
   grpc_register_plugin(grpc_max_age_filter_init,
                        grpc_max_age_filter_shutdown);
+  grpc_register_plugin(grpc_adaptive_concurrency_filter_init,
+                       grpc_adaptive_concurrency_filter_shutdown);
   grpc_register_plugin(grpc_message_size_filter_init,
                        grpc_message_size_filter_shutdown);
   grpc_register_plugin(grpc_core::FaultInjectionFilterInit,
@@ -167,10 +175,12 @@ namespace grpc_core {
 
 extern void BuildClientChannelConfiguration(CoreConfiguration::Builder* builder);
 extern void SecurityRegisterHandshakerFactories(CoreConfiguration::Builder* builder);
+extern void RegisterShmHandshaker(CoreConfiguration::Builder* builder);
 
 void BuildCoreConfiguration(CoreConfiguration::Builder* builder) {
   BuildClientChannelConfiguration(builder);
   SecurityRegisterHandshakerFactories(builder);
+  RegisterShmHandshaker(builder);
 }
 
 }  // namespace grpc_core
@@ -115,10 +115,143 @@ static tsi_result alts_grpc_privacy_integrity_unprotect(
   return TSI_OK;
 }
 
+static tsi_result alts_grpc_privacy_integrity_protect_frames(
+    alts_grpc_record_protocol* rp, grpc_slice_buffer* unprotected_slices,
+    size_t max_unprotected_frame_size, grpc_slice_buffer* protected_slices) {
+  /* Input sanity check.  */
+  if (rp == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    gpr_log(GPR_ERROR,
+            "Invalid nullptr arguments to alts_grpc_record_protocol protect.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (max_unprotected_frame_size == 0) {
+    gpr_log(GPR_ERROR, "Invalid maximum unprotected frame size.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  /* Allocates a single buffer for all output frames.  */
+  size_t data_length = unprotected_slices->length;
+  size_t num_frames =
+      data_length == 0 ? 1
+                       : (data_length + max_unprotected_frame_size - 1) /
+                             max_unprotected_frame_size;
+  grpc_slice protected_slice = GRPC_SLICE_MALLOC(
+      data_length + num_frames * (rp->header_length + rp->tag_length));
+  iovec_t protected_iovec = {GRPC_SLICE_START_PTR(protected_slice),
+                             GRPC_SLICE_LENGTH(protected_slice)};
+  /* Calls alts_iovec_record_protocol multi-frame protect.  */
+  char* error_details = nullptr;
+  alts_grpc_record_protocol_convert_slice_buffer_to_iovec(rp,
+                                                          unprotected_slices);
+  grpc_status_code status =
+      alts_iovec_record_protocol_privacy_integrity_protect_frames(
+          rp->iovec_rp, rp->iovec_buf, unprotected_slices->count,
+          max_unprotected_frame_size, protected_iovec, &error_details);
+  if (status != GRPC_STATUS_OK) {
+    gpr_log(GPR_ERROR, "Failed to protect, %s", error_details);
+    gpr_free(error_details);
+    grpc_slice_unref_internal(protected_slice);
+    return TSI_INTERNAL_ERROR;
+  }
+  grpc_slice_buffer_add(protected_slices, protected_slice);
+  grpc_slice_buffer_reset_and_unref_internal(unprotected_slices);
+  return TSI_OK;
+}
+
+static tsi_result alts_grpc_privacy_integrity_unprotect_frames(
+    alts_grpc_record_protocol* rp, grpc_slice_buffer* protected_slices,
+    size_t num_frames, grpc_slice_buffer* unprotected_slices) {
+  /* Input sanity check.  */
+  if (rp == nullptr || protected_slices == nullptr ||
+      unprotected_slices == nullptr) {
+    gpr_log(
+        GPR_ERROR,
+        "Invalid nullptr arguments to alts_grpc_record_protocol unprotect.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  size_t frame_overhead = rp->header_length + rp->tag_length;
+  if (num_frames == 0 ||
+      protected_slices->length / frame_overhead < num_frames) {
+    gpr_log(GPR_ERROR, "Protected slices do not have sufficient data.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  /* Allocates a single buffer for the unprotected data of all frames.  */
+  grpc_slice unprotected_slice = GRPC_SLICE_MALLOC(
+      protected_slices->length - num_frames * frame_overhead);
+  unsigned char* out = GRPC_SLICE_START_PTR(unprotected_slice);
+  grpc_slice_buffer frame_sb;
+  grpc_slice_buffer_init(&frame_sb);
+  tsi_result result = TSI_OK;
+  for (size_t i = 0; i < num_frames; ++i) {
+    if (protected_slices->length < frame_overhead) {
+      gpr_log(GPR_ERROR, "Protected slices do not have sufficient data.");
+      result = TSI_INVALID_ARGUMENT;
+      break;
+    }
+    /* Strips frame header and reads the frame length from it. The header
+     * itself is validated by alts_iovec_record_protocol unprotect.  */
+    grpc_slice_buffer_reset_and_unref_internal(&rp->header_sb);
+    grpc_slice_buffer_move_first(protected_slices, rp->header_length,
+                                 &rp->header_sb);
+    iovec_t header_iovec = alts_grpc_record_protocol_get_header_iovec(rp);
+    const unsigned char* header =
+        static_cast<const unsigned char*>(header_iovec.iov_base);
+    uint32_t frame_length = (static_cast<uint32_t>(header[3]) << 24) |
+                            (static_cast<uint32_t>(header[2]) << 16) |
+                            (static_cast<uint32_t>(header[1]) << 8) |
+                            static_cast<uint32_t>(header[0]);
+    size_t frame_payload_length =
+        static_cast<size_t>(frame_length) + kZeroCopyFrameLengthFieldSize -
+        rp->header_length;
+    if (frame_length < kZeroCopyFrameMessageTypeFieldSize + rp->tag_length ||
+        frame_payload_length > protected_slices->length ||
+        frame_payload_length - rp->tag_length >
+            static_cast<size_t>(GRPC_SLICE_END_PTR(unprotected_slice) - out)) {
+      gpr_log(GPR_ERROR, "Bad frame length.");
+      result = TSI_DATA_CORRUPTED;
+      break;
+    }
+    /* Calls alts_iovec_record_protocol unprotect into this frame's region of
+     * the output buffer.  */
+    grpc_slice_buffer_move_first(protected_slices, frame_payload_length,
+                                 &frame_sb);
+    alts_grpc_record_protocol_convert_slice_buffer_to_iovec(rp, &frame_sb);
+    iovec_t unprotected_iovec = {out, frame_payload_length - rp->tag_length};
+    char* error_details = nullptr;
+    grpc_status_code status =
+        alts_iovec_record_protocol_privacy_integrity_unprotect(
+            rp->iovec_rp, header_iovec, rp->iovec_buf, frame_sb.count,
+            unprotected_iovec, &error_details);
+    grpc_slice_buffer_reset_and_unref_internal(&frame_sb);
+    if (status != GRPC_STATUS_OK) {
+      gpr_log(GPR_ERROR, "Failed to unprotect, %s", error_details);
+      gpr_free(error_details);
+      result = TSI_INTERNAL_ERROR;
+      break;
+    }
+    out += unprotected_iovec.iov_len;
+  }
+  grpc_slice_buffer_destroy_internal(&frame_sb);
+  grpc_slice_buffer_reset_and_unref_internal(&rp->header_sb);
+  if (result == TSI_OK && (protected_slices->length != 0 ||
+                           out != GRPC_SLICE_END_PTR(unprotected_slice))) {
+    gpr_log(GPR_ERROR, "Protected slices do not match the number of frames.");
+    result = TSI_DATA_CORRUPTED;
+  }
+  if (result != TSI_OK) {
+    grpc_slice_unref_internal(unprotected_slice);
+    return result;
+  }
+  grpc_slice_buffer_add(unprotected_slices, unprotected_slice);
+  return TSI_OK;
+}
+
 static const alts_grpc_record_protocol_vtable
     alts_grpc_privacy_integrity_record_protocol_vtable = {
         alts_grpc_privacy_integrity_protect,
-        alts_grpc_privacy_integrity_unprotect, nullptr};
+        alts_grpc_privacy_integrity_unprotect, nullptr,
+        alts_grpc_privacy_integrity_protect_frames,
+        alts_grpc_privacy_integrity_unprotect_frames};
 
 tsi_result alts_grpc_privacy_integrity_record_protocol_create(
     gsec_aead_crypter* crypter, size_t overflow_size, bool is_client,
@@ -68,6 +68,49 @@ tsi_result alts_grpc_record_protocol_unprotect(
     alts_grpc_record_protocol* self, grpc_slice_buffer* protected_slices,
     grpc_slice_buffer* unprotected_slices);
 
+/**
+ * This methods performs protect operation on unprotected data spanning one or
+ * more frames and appends the protected frames to protected_slices. The
+ * unprotected data are split into chunks of at most max_unprotected_frame_size
+ * bytes, and all frames are sealed as a single batch into one newly allocated
+ * slice. Empty unprotected data yields a single empty frame. The input
+ * unprotected data slice buffer will be cleared, although the actual
+ * unprotected data bytes are not modified.
+ *
+ * - self: an alts_grpc_record_protocol instance.
+ * - unprotected_slices: the unprotected data to be protected.
+ * - max_unprotected_frame_size: maximum unprotected data size of a frame.
+ * - protected_slices: slice buffer where the protected frames are appended.
+ *
+ * This method returns TSI_OK in case of success, TSI_UNIMPLEMENTED if the
+ * instance does not support batch protection, or a specific error code in
+ * case of failure.
+ */
+tsi_result alts_grpc_record_protocol_protect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* unprotected_slices,
+    size_t max_unprotected_frame_size, grpc_slice_buffer* protected_slices);
+
+/**
+ * This methods performs unprotect operation on num_frames full frames of
+ * protected data and appends unprotected data of all frames to
+ * unprotected_slices as a single slice. It is the caller's responsibility to
+ * prepare exactly num_frames full frames of data before calling this method.
+ * The input protected frames slice buffer will be cleared, although the actual
+ * protected data bytes are not modified.
+ *
+ * - self: an alts_grpc_record_protocol instance.
+ * - protected_slices: num_frames full frames of protected data in grpc slices.
+ * - num_frames: the number of frames in protected_slices.
+ * - unprotected_slices: slice buffer where unprotected data is appended.
+ *
+ * This method returns TSI_OK in case of success, TSI_UNIMPLEMENTED if the
+ * instance does not support batch unprotection, or a specific error code in
+ * case of failure.
+ */
+tsi_result alts_grpc_record_protocol_unprotect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* protected_slices,
+    size_t num_frames, grpc_slice_buffer* unprotected_slices);
+
 /**
  * This method returns maximum allowed unprotected data size, given maximum
  * protected frame size.
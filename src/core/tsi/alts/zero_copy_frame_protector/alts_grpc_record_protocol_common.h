@@ -39,6 +39,15 @@ struct alts_grpc_record_protocol_vtable {
                           grpc_slice_buffer* protected_slices,
                           grpc_slice_buffer* unprotected_slices);
   void (*destruct)(alts_grpc_record_protocol* self);
+  /* Optional multi-frame variants of protect and unprotect.  */
+  tsi_result (*protect_frames)(alts_grpc_record_protocol* self,
+                               grpc_slice_buffer* unprotected_slices,
+                               size_t max_unprotected_frame_size,
+                               grpc_slice_buffer* protected_slices);
+  tsi_result (*unprotect_frames)(alts_grpc_record_protocol* self,
+                                 grpc_slice_buffer* protected_slices,
+                                 size_t num_frames,
+                                 grpc_slice_buffer* unprotected_slices);
 };
 /* Main struct for alts_grpc_record_protocol implementation, shared by both
  * integrity-only record protocol and privacy-integrity record protocol.
@@ -26,6 +26,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/tsi/alts/frame_protector/alts_counter.h"
 
 struct alts_iovec_record_protocol {
@@ -354,6 +355,105 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect(
   return increment_counter(rp->ctr, error_details);
 }
 
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_frames(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    size_t unprotected_vec_length, size_t max_frame_data_length,
+    iovec_t protected_frames, char** error_details) {
+  /* Input sanity checks, done once for all frames.  */
+  if (rp == nullptr) {
+    maybe_copy_error_msg("Input iovec_record_protocol is nullptr.",
+                         error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (rp->is_integrity_only) {
+    maybe_copy_error_msg(
+        "Privacy-integrity operations are not allowed for this object.",
+        error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (!rp->is_protect) {
+    maybe_copy_error_msg("Protect operations are not allowed for this object.",
+                         error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (max_frame_data_length == 0) {
+    maybe_copy_error_msg("Maximum frame data length is zero.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  size_t data_length =
+      get_total_length(unprotected_vec, unprotected_vec_length);
+  size_t num_frames =
+      data_length == 0
+          ? 1
+          : (data_length + max_frame_data_length - 1) / max_frame_data_length;
+  size_t frame_overhead =
+      alts_iovec_record_protocol_get_header_length() + rp->tag_length;
+  if (protected_frames.iov_base == nullptr) {
+    maybe_copy_error_msg("Protected frames are nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (protected_frames.iov_len != data_length + num_frames * frame_overhead) {
+    maybe_copy_error_msg("Protected frames size is incorrect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  /* A frame never references more input iovecs than the whole input.  */
+  iovec_t* frame_vec = static_cast<iovec_t*>(
+      gpr_malloc(GPR_MAX(unprotected_vec_length, 1) * sizeof(iovec_t)));
+  unsigned char* out = static_cast<unsigned char*>(protected_frames.iov_base);
+  size_t vec_index = 0;
+  size_t vec_offset = 0;
+  grpc_status_code status = GRPC_STATUS_OK;
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    /* Gathers the unprotected data of this frame.  */
+    size_t frame_data_length =
+        GPR_MIN(max_frame_data_length,
+                data_length - frame * max_frame_data_length);
+    size_t frame_vec_length = 0;
+    size_t remaining = frame_data_length;
+    while (remaining > 0) {
+      const iovec_t& vec = unprotected_vec[vec_index];
+      size_t length = GPR_MIN(remaining, vec.iov_len - vec_offset);
+      if (length > 0) {
+        frame_vec[frame_vec_length].iov_base =
+            static_cast<unsigned char*>(vec.iov_base) + vec_offset;
+        frame_vec[frame_vec_length].iov_len = length;
+        frame_vec_length++;
+      }
+      remaining -= length;
+      vec_offset += length;
+      if (vec_offset == vec.iov_len) {
+        vec_index++;
+        vec_offset = 0;
+      }
+    }
+    /* Writes frame header and seals the data right after it.  */
+    status = write_frame_header(frame_data_length + rp->tag_length, out,
+                                error_details);
+    if (status != GRPC_STATUS_OK) break;
+    out += alts_iovec_record_protocol_get_header_length();
+    iovec_t ciphertext = {out, frame_data_length + rp->tag_length};
+    size_t bytes_written = 0;
+    status = gsec_aead_crypter_encrypt_iovec(
+        rp->crypter, alts_counter_get_counter(rp->ctr),
+        alts_counter_get_size(rp->ctr), /* aad_vec = */ nullptr,
+        /* aad_vec_length = */ 0, frame_vec, frame_vec_length, ciphertext,
+        &bytes_written, error_details);
+    if (status != GRPC_STATUS_OK) break;
+    if (bytes_written != frame_data_length + rp->tag_length) {
+      maybe_copy_error_msg(
+          "Bytes written expects to be data length plus tag length.",
+          error_details);
+      status = GRPC_STATUS_INTERNAL;
+      break;
+    }
+    out += bytes_written;
+    status = increment_counter(rp->ctr, error_details);
+    if (status != GRPC_STATUS_OK) break;
+  }
+  gpr_free(frame_vec);
+  return status;
+}
+
 grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
     alts_iovec_record_protocol* rp, iovec_t header,
     const iovec_t* protected_vec, size_t protected_vec_length,
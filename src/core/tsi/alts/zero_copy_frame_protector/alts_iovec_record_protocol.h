@@ -136,6 +136,33 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect(
     size_t unprotected_vec_length, iovec_t protected_frame,
     char** error_details);
 
+/**
+ * This method performs privacy-integrity protect operation on a
+ * alts_iovec_record_protocol instance for data spanning several frames, i.e.,
+ * splits the unprotected data into chunks of at most max_frame_data_length
+ * bytes and seals each of them into a frame. The frames are written back to
+ * back into protected_frames, whose length must be the sum of the protected
+ * frame sizes. Empty unprotected data yields a single empty frame. The caller
+ * needs to allocate the memory for the protected frames prior to calling this
+ * method.
+ *
+ * - rp: an alts_iovec_record_protocol instance.
+ * - unprotected_vec: an iovec array containing unprotected data.
+ * - unprotected_vec_length: the array length of unprotected_vec.
+ * - max_frame_data_length: the maximum unprotected data size of a frame.
+ * - protected_frames: an iovec containing the output protected frames.
+ * - error_details: a buffer containing an error message if the method does not
+ *   function correctly. It is OK to pass nullptr into error_details.
+ *
+ * On success, the method returns GRPC_STATUS_OK. Otherwise, it returns an
+ * error status code along with its details specified in error_details (if
+ * error_details is not nullptr).
+ */
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_frames(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    size_t unprotected_vec_length, size_t max_frame_data_length,
+    iovec_t protected_frames, char** error_details);
+
 /**
  * This method performs privacy-integrity unprotect operation on a
  * alts_iovec_record_protocol instance given a full protected frame, i.e.,
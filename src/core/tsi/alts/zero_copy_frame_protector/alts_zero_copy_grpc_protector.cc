@@ -56,31 +56,41 @@ typedef struct alts_zero_copy_grpc_protector {
   grpc_slice_buffer protected_sb;
   grpc_slice_buffer protected_staging_sb;
   uint32_t parsed_frame_size;
+  /* Whether unrecord_protocol unprotects several frames as a batch.  */
+  bool unprotect_frames;
 } alts_zero_copy_grpc_protector;
 
 /**
- * Given a slice buffer, parses the first 4 bytes little-endian unsigned frame
- * size and returns the total frame size including the frame field. Caller
- * needs to make sure the input slice buffer has at least 4 bytes. Returns true
- * on success and false on failure.
+ * Given a slice buffer, parses the 4 bytes little-endian unsigned frame size
+ * starting at offset and returns the total frame size including the frame
+ * field. Caller needs to make sure the input slice buffer has at least 4 bytes
+ * after offset. Returns true on success and false on failure.
  */
-static bool read_frame_size(const grpc_slice_buffer* sb,
+static bool read_frame_size(const grpc_slice_buffer* sb, size_t offset,
                             uint32_t* total_frame_size) {
-  if (sb == nullptr || sb->length < kZeroCopyFrameLengthFieldSize) {
+  if (sb == nullptr || sb->length < offset ||
+      sb->length - offset < kZeroCopyFrameLengthFieldSize) {
     return false;
   }
   uint8_t frame_size_buffer[kZeroCopyFrameLengthFieldSize];
   uint8_t* buf = frame_size_buffer;
-  /* Copies the first 4 bytes to a temporary buffer.  */
+  /* Copies the 4 bytes at offset to a temporary buffer.  */
   size_t remaining = kZeroCopyFrameLengthFieldSize;
   for (size_t i = 0; i < sb->count; i++) {
     size_t slice_length = GRPC_SLICE_LENGTH(sb->slices[i]);
+    if (offset >= slice_length) {
+      offset -= slice_length;
+      continue;
+    }
+    const uint8_t* start = GRPC_SLICE_START_PTR(sb->slices[i]) + offset;
+    slice_length -= offset;
+    offset = 0;
     if (remaining <= slice_length) {
-      memcpy(buf, GRPC_SLICE_START_PTR(sb->slices[i]), remaining);
+      memcpy(buf, start, remaining);
       remaining = 0;
       break;
     } else {
-      memcpy(buf, GRPC_SLICE_START_PTR(sb->slices[i]), slice_length);
+      memcpy(buf, start, slice_length);
       buf += slice_length;
       remaining -= slice_length;
     }
@@ -144,6 +154,48 @@ static tsi_result create_alts_grpc_record_protocol(
   return TSI_OK;
 }
 
+/**
+ * Unprotects all complete frames buffered in protected_sb as a single batch,
+ * leaving a trailing partial frame (if any) in protected_sb.
+ */
+static tsi_result unprotect_complete_frames(
+    alts_zero_copy_grpc_protector* protector,
+    grpc_slice_buffer* unprotected_slices) {
+  grpc_slice_buffer* sb = &protector->protected_sb;
+  size_t num_frames = 0;
+  size_t frames_length = 0;
+  while (sb->length - frames_length >= kZeroCopyFrameLengthFieldSize) {
+    uint32_t frame_size;
+    if (!read_frame_size(sb, frames_length, &frame_size)) {
+      grpc_slice_buffer_reset_and_unref_internal(sb);
+      return TSI_DATA_CORRUPTED;
+    }
+    if (sb->length - frames_length < frame_size) break;
+    frames_length += frame_size;
+    num_frames++;
+  }
+  if (num_frames == 0) {
+    return TSI_OK;
+  }
+  tsi_result status;
+  if (sb->length == frames_length) {
+    status = alts_grpc_record_protocol_unprotect_frames(
+        protector->unrecord_protocol, sb, num_frames, unprotected_slices);
+  } else {
+    grpc_slice_buffer_move_first(sb, frames_length,
+                                 &protector->protected_staging_sb);
+    status = alts_grpc_record_protocol_unprotect_frames(
+        protector->unrecord_protocol, &protector->protected_staging_sb,
+        num_frames, unprotected_slices);
+  }
+  if (status != TSI_OK) {
+    grpc_slice_buffer_reset_and_unref_internal(
+        &protector->protected_staging_sb);
+    grpc_slice_buffer_reset_and_unref_internal(sb);
+  }
+  return status;
+}
+
 /* --- tsi_zero_copy_grpc_protector methods implementation. --- */
 
 static tsi_result alts_zero_copy_grpc_protector_protect(
@@ -156,6 +208,13 @@ static tsi_result alts_zero_copy_grpc_protector_protect(
   }
   alts_zero_copy_grpc_protector* protector =
       reinterpret_cast<alts_zero_copy_grpc_protector*>(self);
+  /* Seals all frames of this write as a single batch if supported.  */
+  tsi_result result = alts_grpc_record_protocol_protect_frames(
+      protector->record_protocol, unprotected_slices,
+      protector->max_unprotected_data_size, protected_slices);
+  if (result != TSI_UNIMPLEMENTED) {
+    return result;
+  }
   /* Calls alts_grpc_record_protocol protect repeatly.  */
   while (unprotected_slices->length > protector->max_unprotected_data_size) {
     grpc_slice_buffer_move_first(unprotected_slices,
@@ -184,11 +243,14 @@ static tsi_result alts_zero_copy_grpc_protector_unprotect(
   alts_zero_copy_grpc_protector* protector =
       reinterpret_cast<alts_zero_copy_grpc_protector*>(self);
   grpc_slice_buffer_move_into(protected_slices, &protector->protected_sb);
+  if (protector->unprotect_frames) {
+    return unprotect_complete_frames(protector, unprotected_slices);
+  }
   /* Keep unprotecting each frame if possible.  */
   while (protector->protected_sb.length >= kZeroCopyFrameLengthFieldSize) {
     if (protector->parsed_frame_size == 0) {
       /* We have not parsed frame size yet. Parses frame size.  */
-      if (!read_frame_size(&protector->protected_sb,
+      if (!read_frame_size(&protector->protected_sb, /*offset=*/0,
                            &protector->parsed_frame_size)) {
         grpc_slice_buffer_reset_and_unref_internal(&protector->protected_sb);
         return TSI_DATA_CORRUPTED;
@@ -293,6 +355,7 @@ tsi_result alts_zero_copy_grpc_protector_create(
       grpc_slice_buffer_init(&impl->protected_sb);
       grpc_slice_buffer_init(&impl->protected_staging_sb);
       impl->parsed_frame_size = 0;
+      impl->unprotect_frames = !is_integrity_only;
       impl->base.vtable = &alts_zero_copy_grpc_protector_vtable;
       *protector = &impl->base;
       return TSI_OK;
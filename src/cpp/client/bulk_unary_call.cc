@@ -0,0 +1,214 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpcpp/support/bulk_unary_call.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <grpc/grpc.h>
+#include <grpc/slice.h>
+#include <grpc/support/log.h>
+#include <grpcpp/completion_queue.h>
+#include <grpcpp/impl/codegen/slice.h>
+#include <grpcpp/security/credentials.h>
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc {
+namespace internal {
+
+// The state of a bulk operation, shared by its calls. The last call to
+// complete reports the results and deletes it.
+class BulkUnaryCall::BulkOp {
+ public:
+  BulkOp(ClientContext* context, std::vector<ByteBuffer> requests,
+         std::function<void(std::vector<Status>, std::vector<ByteBuffer>)>
+             on_done);
+  ~BulkOp();
+
+  // Starts the calls, and reports the results if none could be started.
+  void Start(Channel* channel, void* method_tag, ClientContext* context);
+
+ private:
+  struct PendingCall : public grpc_completion_queue_functor {
+    BulkOp* op;
+    grpc_call* call = nullptr;
+    ByteBuffer request;
+    ByteBuffer response;
+    grpc_status_code status_code = GRPC_STATUS_UNKNOWN;
+    grpc_slice status_details = grpc_empty_slice();
+    grpc_metadata_array initial_metadata;
+    grpc_metadata_array trailing_metadata;
+    Status status;
+  };
+
+  static void OnCallDone(grpc_completion_queue_functor* functor, int ok);
+
+  // Called once for each call: the last one reports the results.
+  void CallDone();
+
+  const size_t num_calls_;
+  std::unique_ptr<PendingCall[]> calls_;
+  // The metadata of the context, converted once for all the calls. Core
+  // links the metadata of a call through its grpc_metadata entries, so each
+  // call sends its own copy of them: call_metadata_ holds the copies.
+  std::vector<grpc_metadata> metadata_;
+  std::unique_ptr<grpc_metadata[]> call_metadata_;
+  const uint32_t metadata_flags_;
+  std::atomic<size_t> pending_;
+  std::function<void(std::vector<Status>, std::vector<ByteBuffer>)> on_done_;
+};
+
+BulkUnaryCall::BulkOp::BulkOp(
+    ClientContext* context, std::vector<ByteBuffer> requests,
+    std::function<void(std::vector<Status>, std::vector<ByteBuffer>)> on_done)
+    : num_calls_(requests.size()),
+      calls_(new PendingCall[requests.size()]),
+      metadata_flags_(context->initial_metadata_flags()),
+      // One count for each call, and one for Start() itself.
+      pending_(requests.size() + 1),
+      on_done_(std::move(on_done)) {
+  for (size_t i = 0; i < num_calls_; i++) {
+    calls_[i].functor_run = OnCallDone;
+    calls_[i].inlineable = false;
+    calls_[i].op = this;
+    calls_[i].request.Swap(&requests[i]);
+    grpc_metadata_array_init(&calls_[i].initial_metadata);
+    grpc_metadata_array_init(&calls_[i].trailing_metadata);
+  }
+  metadata_.reserve(context->send_initial_metadata_.size());
+  for (const auto& entry : context->send_initial_metadata_) {
+    grpc_metadata md;
+    md.key = grpc_slice_intern(SliceReferencingString(entry.first));
+    md.value = grpc_slice_intern(SliceReferencingString(entry.second));
+    metadata_.push_back(md);
+  }
+  call_metadata_.reset(new grpc_metadata[num_calls_ * metadata_.size()]);
+  for (size_t i = 0; i < num_calls_; i++) {
+    std::copy(metadata_.begin(), metadata_.end(),
+              &call_metadata_[i * metadata_.size()]);
+  }
+}
+
+BulkUnaryCall::BulkOp::~BulkOp() {
+  for (size_t i = 0; i < num_calls_; i++) {
+    if (calls_[i].call != nullptr) grpc_call_unref(calls_[i].call);
+    grpc_slice_unref(calls_[i].status_details);
+    grpc_metadata_array_destroy(&calls_[i].initial_metadata);
+    grpc_metadata_array_destroy(&calls_[i].trailing_metadata);
+  }
+  for (grpc_metadata& md : metadata_) {
+    grpc_slice_unref(md.key);
+    grpc_slice_unref(md.value);
+  }
+}
+
+void BulkUnaryCall::BulkOp::Start(Channel* channel, void* method_tag,
+                                  ClientContext* context) {
+  const std::shared_ptr<CallCredentials> creds = context->credentials();
+  grpc_completion_queue* cq = channel->CallbackCQ()->cq();
+  for (size_t i = 0; i < num_calls_; i++) {
+    PendingCall* call = &calls_[i];
+    if (!call->request.Valid()) {
+      call->status =
+          Status(StatusCode::INTERNAL, "Failed to serialize request");
+      CallDone();
+      continue;
+    }
+    call->call = grpc_channel_create_registered_call(
+        channel->c_channel_, context->propagate_from_call_,
+        context->propagation_options_.c_bitmask(), cq, method_tag,
+        context->raw_deadline(), nullptr);
+    grpc_census_call_set_context(call->call, context->census_context());
+    if (creds != nullptr && !creds->ApplyToCall(call->call)) {
+      grpc_call_cancel_with_status(call->call, GRPC_STATUS_CANCELLED,
+                                   "Failed to set credentials to rpc.",
+                                   nullptr);
+    }
+    // Core delivers the message of a call after its initial metadata, so the
+    // calls receive it too.
+    grpc_op ops[6] = {};
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[0].flags = metadata_flags_;
+    ops[0].data.send_initial_metadata.count = metadata_.size();
+    ops[0].data.send_initial_metadata.metadata =
+        &call_metadata_[i * metadata_.size()];
+    ops[1].op = GRPC_OP_SEND_MESSAGE;
+    ops[1].data.send_message.send_message = call->request.c_buffer();
+    ops[2].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    ops[3].op = GRPC_OP_RECV_INITIAL_METADATA;
+    ops[3].data.recv_initial_metadata.recv_initial_metadata =
+        &call->initial_metadata;
+    ops[4].op = GRPC_OP_RECV_MESSAGE;
+    ops[4].data.recv_message.recv_message = call->response.c_buffer_ptr();
+    ops[5].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+    ops[5].data.recv_status_on_client.trailing_metadata =
+        &call->trailing_metadata;
+    ops[5].data.recv_status_on_client.status = &call->status_code;
+    ops[5].data.recv_status_on_client.status_details = &call->status_details;
+    GPR_ASSERT(grpc_call_start_batch(call->call, ops, GPR_ARRAY_SIZE(ops),
+                                     call, nullptr) == GRPC_CALL_OK);
+  }
+  CallDone();
+}
+
+void BulkUnaryCall::BulkOp::OnCallDone(grpc_completion_queue_functor* functor,
+                                       int ok) {
+  PendingCall* call = static_cast<PendingCall*>(functor);
+  // A batch receiving the status always succeeds.
+  GPR_ASSERT(ok);
+  if (call->status_code == GRPC_STATUS_OK && !call->response.Valid()) {
+    call->status =
+        Status(StatusCode::INTERNAL, "No message returned for unary request");
+  } else {
+    call->status = Status(static_cast<StatusCode>(call->status_code),
+                          StringFromCopiedSlice(call->status_details));
+  }
+  call->op->CallDone();
+}
+
+void BulkUnaryCall::BulkOp::CallDone() {
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  std::vector<Status> statuses(num_calls_);
+  std::vector<ByteBuffer> responses(num_calls_);
+  for (size_t i = 0; i < num_calls_; i++) {
+    statuses[i] = std::move(calls_[i].status);
+    responses[i].Swap(&calls_[i].response);
+  }
+  auto on_done = std::move(on_done_);
+  delete this;
+  on_done(std::move(statuses), std::move(responses));
+}
+
+void* BulkUnaryCall::RegisterMethod(Channel* channel,
+                                    const std::string& method) {
+  return channel->RegisterMethod(method.c_str());
+}
+
+void BulkUnaryCall::Start(
+    Channel* channel, void* method_tag, ClientContext* context,
+    std::vector<ByteBuffer> requests,
+    std::function<void(std::vector<Status>, std::vector<ByteBuffer>)>
+        on_done) {
+  BulkOp* op = new BulkOp(context, std::move(requests), std::move(on_done));
+  op->Start(channel, method_tag, context);
+}
+
+}  // namespace internal
+}  // namespace grpc
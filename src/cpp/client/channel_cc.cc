@@ -151,7 +151,9 @@ void ChannelResetConnectionBackoff(Channel* channel) {
       interceptor_creators_, interceptor_pos);
   context->set_call(c_call, shared_from_this());
 
-  return ::grpc::internal::Call(c_call, this, cq, info);
+  ::grpc::internal::Call call(c_call, this, cq, info);
+  call.set_pass_message_pointers(pass_message_pointers_);
+  return call;
 }
 
 ::grpc::internal::Call Channel::CreateCall(
@@ -174,6 +174,11 @@ grpc_slice CoreCodegen::grpc_slice_malloc(size_t length) {
   return ::grpc_slice_malloc(length);
 }
 
+grpc_slice CoreCodegen::grpc_slice_malloc_with_headroom(size_t length,
+                                                        size_t headroom) {
+  return ::grpc_slice_malloc_with_headroom(length, headroom);
+}
+
 void CoreCodegen::grpc_slice_unref(grpc_slice slice) {
   ::grpc_slice_unref(slice);
 }
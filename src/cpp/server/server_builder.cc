@@ -160,6 +160,12 @@ ServerBuilder& ServerBuilder::SetSyncServerOption(
     case CQ_TIMEOUT_MSEC:
       sync_server_settings_.cq_timeout_msec = val;
       break;
+    case PINNED_POLLERS:
+      sync_server_settings_.pinned_pollers = val;
+      break;
+    case TARGET_QUEUEING_DELAY_USEC:
+      sync_server_settings_.target_queueing_delay_usec = val;
+      break;
   }
   return *this;
 }
@@ -330,6 +336,13 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
             sync_server_settings_.num_cqs, sync_server_settings_.min_pollers,
             sync_server_settings_.max_pollers,
             sync_server_settings_.cq_timeout_msec);
+    if (sync_server_settings_.pinned_pollers > 0) {
+      gpr_log(GPR_INFO,
+              "Work-stealing sync server. Pinned pollers: %d, Target queueing "
+              "delay (usec): %d",
+              sync_server_settings_.pinned_pollers,
+              sync_server_settings_.target_queueing_delay_usec);
+    }
   }
 
   if (has_callback_methods) {
@@ -377,7 +390,14 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
     return nullptr;
   }
 
+  if (has_sync_methods && sync_server_settings_.pinned_pollers > 0) {
+    server->EnableSyncServerWorkStealing(
+        sync_server_settings_.pinned_pollers,
+        sync_server_settings_.target_queueing_delay_usec);
+  }
+
   server->RegisterContextAllocator(std::move(context_allocator_));
+  server->RegisterMessageArenaPools(std::move(message_arena_pools_));
 
   for (const auto& value : services_) {
     if (!server->RegisterService(value->host.get(), value->service)) {
@@ -44,6 +44,7 @@
 #include <grpcpp/support/time.h>
 
 #include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/iomgr.h"
@@ -387,6 +388,12 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
         call_, server_, &cq_, server_->max_receive_message_size(),
         ctx_->ctx.set_server_rpc_info(method_->name(), method_->method_type(),
                                       server_->interceptor_creators_));
+    // A client that passes its request as an object gets its responses the
+    // same way.
+    wrapped_call_->set_pass_message_pointers(
+        has_request_payload_ &&
+        grpc::internal::InprocMessage::FromByteBuffer(request_payload_) !=
+            nullptr);
     ctx_->ctx.set_call(call_);
     ctx_->ctx.cq_ = &cq_;
     request_metadata_.count = 0;
@@ -633,6 +640,10 @@ class Server::CallbackRequest final
                           ? req_->method_->method_type()
                           : grpc::internal::RpcMethod::BIDI_STREAMING,
                       req_->server_->interceptor_creators_));
+      call_->set_pass_message_pointers(
+          req_->has_request_payload_ &&
+          grpc::internal::InprocMessage::FromByteBuffer(
+              req_->request_payload_) != nullptr);
 
       req_->interceptor_methods_.SetCall(call_);
       req_->interceptor_methods_.SetReverse();
@@ -964,10 +975,13 @@ grpc_server* Server::c_server() { return server_; }
 std::shared_ptr<grpc::Channel> Server::InProcessChannel(
     const grpc::ChannelArguments& args) {
   grpc_channel_args channel_args = args.c_channel_args();
-  return grpc::CreateChannelInternal(
+  std::shared_ptr<grpc::Channel> channel = grpc::CreateChannelInternal(
       "inproc", grpc_inproc_channel_create(server_, &channel_args, nullptr),
       std::vector<std::unique_ptr<
           grpc::experimental::ClientInterceptorFactoryInterface>>());
+  channel->pass_message_pointers_ = grpc_channel_args_find_bool(
+      &channel_args, GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS, false);
+  return channel;
 }
 
 std::shared_ptr<grpc::Channel>
@@ -977,10 +991,50 @@ Server::experimental_type::InProcessChannelWithInterceptors(
         std::unique_ptr<grpc::experimental::ClientInterceptorFactoryInterface>>
         interceptor_creators) {
   grpc_channel_args channel_args = args.c_channel_args();
-  return grpc::CreateChannelInternal(
+  std::shared_ptr<grpc::Channel> channel = grpc::CreateChannelInternal(
       "inproc",
       grpc_inproc_channel_create(server_->server_, &channel_args, nullptr),
       std::move(interceptor_creators));
+  channel->pass_message_pointers_ = grpc_channel_args_find_bool(
+      &channel_args, GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS, false);
+  return channel;
+}
+
+namespace {
+
+grpc::experimental::MethodStats::Distribution ToDistribution(
+    const grpc_core::MethodStats::Histogram& histogram) {
+  grpc::experimental::MethodStats::Distribution distribution;
+  distribution.count = histogram.count();
+  distribution.sum = histogram.sum();
+  distribution.p50 = histogram.Percentile(50);
+  distribution.p90 = histogram.Percentile(90);
+  distribution.p99 = histogram.Percentile(99);
+  distribution.p999 = histogram.Percentile(99.9);
+  return distribution;
+}
+
+}  // namespace
+
+std::vector<grpc::experimental::MethodStats>
+Server::experimental_type::GetMethodStats() {
+  std::vector<grpc::experimental::MethodStats> result;
+  for (const auto& stats : server_->server_->core_server->GetMethodStats()) {
+    grpc_core::MethodStats::Snapshot snapshot = stats->GetSnapshot();
+    grpc::experimental::MethodStats method_stats;
+    method_stats.method = stats->method();
+    method_stats.host = stats->host();
+    method_stats.queue_time_ns =
+        ToDistribution(snapshot.metrics[grpc_core::MethodStats::kQueueTime]);
+    method_stats.handler_time_ns =
+        ToDistribution(snapshot.metrics[grpc_core::MethodStats::kHandlerTime]);
+    method_stats.bytes_in =
+        ToDistribution(snapshot.metrics[grpc_core::MethodStats::kBytesIn]);
+    method_stats.bytes_out =
+        ToDistribution(snapshot.metrics[grpc_core::MethodStats::kBytesOut]);
+    result.push_back(std::move(method_stats));
+  }
+  return result;
 }
 
 static grpc_server_register_method_payload_handling PayloadHandlingForMethod(
@@ -1029,6 +1083,15 @@ bool Server::RegisterService(const std::string* addr, grpc::Service* service) {
       }
     } else {
       has_callback_methods_ = true;
+      if (method->method_type() == grpc::internal::RpcMethod::NORMAL_RPC) {
+        auto pool = message_arena_pools_.find(method->name());
+        if (pool == message_arena_pools_.end()) {
+          pool = message_arena_pools_.find("");
+        }
+        if (pool != message_arena_pools_.end()) {
+          method->handler()->SetMessageArenaPool(pool->second);
+        }
+      }
       grpc::internal::RpcServiceMethod* method_value = method.get();
       grpc::CompletionQueue* cq = CallbackCQ();
       server_->core_server->SetRegisteredMethodAllocator(
@@ -1055,6 +1118,13 @@ bool Server::RegisterService(const std::string* addr, grpc::Service* service) {
   return true;
 }
 
+void Server::EnableSyncServerWorkStealing(int pinned_pollers,
+                                          int target_queueing_delay_usec) {
+  for (const auto& mgr : sync_req_mgrs_) {
+    mgr->EnableWorkStealing(pinned_pollers, target_queueing_delay_usec);
+  }
+}
+
 void Server::RegisterAsyncGenericService(grpc::AsyncGenericService* service) {
   GPR_ASSERT(service->server_ == nullptr &&
              "Can only register an async generic service against one server.");
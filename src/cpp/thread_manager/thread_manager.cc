@@ -18,8 +18,13 @@
 
 #include "src/cpp/thread_manager/thread_manager.h"
 
+#include <algorithm>
 #include <climits>
 
+#ifdef GPR_LINUX
+#include <sched.h>
+#endif
+
 #include <grpc/support/log.h>
 
 #include "src/core/lib/gprpp/thd.h"
@@ -27,8 +32,42 @@
 
 namespace grpc {
 
-ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
-    : thd_mgr_(thd_mgr) {
+namespace {
+
+// How long an executor above the minimum count waits for work before exiting
+constexpr int kExecutorIdleTimeoutMs = 1000;
+
+// Pins the calling thread to one of the CPUs it is allowed to run on. The
+// pinned pollers of all the thread managers of the process are spread over
+// these CPUs in turn.
+void PinToNextCpu() {
+#ifdef GPR_LINUX
+  static std::atomic<unsigned> next_cpu{0};
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+  int num_allowed = CPU_COUNT(&allowed);
+  if (num_allowed <= 1) return;
+  unsigned n = next_cpu.fetch_add(1, std::memory_order_relaxed) % num_allowed;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed)) continue;
+    if (n-- > 0) continue;
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    CPU_SET(cpu, &pinned);
+    if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0) {
+      gpr_log(GPR_DEBUG, "Could not pin grpc_sync_server poller to CPU %d",
+              cpu);
+    }
+    return;
+  }
+#endif
+}
+
+}  // namespace
+
+ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr, Role role,
+                                          size_t index)
+    : thd_mgr_(thd_mgr), role_(role), index_(index) {
   // Make thread creation exclusive with respect to its join happening in
   // ~WorkerThread().
   thd_ = grpc_core::Thread(
@@ -41,7 +80,18 @@ ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
 }
 
 void ThreadManager::WorkerThread::Run() {
-  thd_mgr_->MainWorkLoop();
+  switch (role_) {
+    case POLLER:
+      thd_mgr_->MainWorkLoop();
+      break;
+    case PINNED_POLLER:
+      PinToNextCpu();
+      thd_mgr_->PinnedPollerWorkLoop(index_);
+      break;
+    case EXECUTOR:
+      thd_mgr_->ExecutorWorkLoop(index_);
+      break;
+  }
   thd_mgr_->MarkAsCompleted(this);
 }
 
@@ -84,6 +134,8 @@ void ThreadManager::Wait() {
 void ThreadManager::Shutdown() {
   grpc_core::MutexLock lock(&mu_);
   shutdown_ = true;
+  // Idle executors above the minimum count may exit now
+  work_cv_.SignalAll();
 }
 
 bool ThreadManager::IsShutdown() {
@@ -125,7 +177,72 @@ void ThreadManager::CleanupCompletedThreads() {
   for (auto thd : completed_threads) delete thd;
 }
 
+void ThreadManager::EnableWorkStealing(int num_pollers,
+                                       int target_queueing_delay_usec) {
+  GPR_ASSERT(num_pollers > 0);
+  work_stealing_ = true;
+  for (int i = 0; i < num_pollers; i++) {
+    queues_.emplace_back(new WorkQueue());
+  }
+  target_queueing_delay_ = gpr_time_from_micros(
+      std::max(target_queueing_delay_usec, 0), GPR_TIMESPAN);
+  // Executors poll nothing: the minimum count is all the server needs to
+  // start, whatever min_pollers was set to.
+  if (min_pollers_ < 1) min_pollers_ = 1;
+}
+
+bool ThreadManager::StartThread(WorkerThread::Role role, size_t index) {
+  WorkerThread* worker = new WorkerThread(this, role, index);
+  if (worker->created()) {
+    worker->Start();
+    return true;
+  }
+  delete worker;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    num_threads_--;
+    if (role == WorkerThread::EXECUTOR) {
+      num_executors_--;
+    } else {
+      num_pollers_--;
+      if (num_pollers_ == 0) work_cv_.SignalAll();
+    }
+    if (num_threads_ == 0) shutdown_cv_.Signal();
+  }
+  grpc_resource_user_free_threads(resource_user_, 1);
+  return false;
+}
+
 void ThreadManager::Initialize() {
+  if (work_stealing_) {
+    int num_pollers = static_cast<int>(queues_.size());
+    int num_threads = num_pollers + min_pollers_;
+    if (!grpc_resource_user_allocate_threads(resource_user_, num_threads)) {
+      gpr_log(GPR_ERROR,
+              "No thread quota available to create the pinned pollers and the "
+              "minimum executors (i.e %d). Unable to start the thread manager",
+              num_threads);
+      abort();
+    }
+    {
+      grpc_core::MutexLock lock(&mu_);
+      num_pollers_ = num_pollers;
+      num_executors_ = min_pollers_;
+      next_executor_index_ = min_pollers_;
+      num_threads_ = num_threads;
+      max_active_threads_sofar_ = num_threads;
+      last_executor_added_ = gpr_now(GPR_CLOCK_MONOTONIC);
+    }
+    for (int i = 0; i < min_pollers_; i++) {
+      // Must be able to create the minimum
+      GPR_ASSERT(StartThread(WorkerThread::EXECUTOR, i));
+    }
+    for (int i = 0; i < num_pollers; i++) {
+      GPR_ASSERT(StartThread(WorkerThread::PINNED_POLLER, i));
+    }
+    return;
+  }
+
   if (!grpc_resource_user_allocate_threads(resource_user_, min_pollers_)) {
     gpr_log(GPR_ERROR,
             "No thread quota available to even create the minimum required "
@@ -264,4 +381,123 @@ void ThreadManager::MainWorkLoop() {
   // enough threads.
 }
 
+void ThreadManager::PinnedPollerWorkLoop(size_t index) {
+  while (true) {
+    void* tag;
+    bool ok;
+    WorkStatus work_status = PollForWork(&tag, &ok);
+    if (work_status == SHUTDOWN) break;
+    if (work_status == TIMEOUT) {
+      if (IsShutdown()) break;
+      continue;
+    }
+    QueueWork(index, tag, ok);
+  }
+
+  {
+    grpc_core::MutexLock lock(&mu_);
+    num_pollers_--;
+    // Once no work can be queued anymore, executors may exit as soon as the
+    // queues are drained
+    if (num_pollers_ == 0) work_cv_.SignalAll();
+  }
+  CleanupCompletedThreads();
+}
+
+void ThreadManager::QueueWork(size_t index, void* tag, bool ok) {
+  WorkQueue* queue = queues_[index].get();
+  {
+    grpc_core::MutexLock lock(&queue->mu);
+    queue->work.push_back({tag, ok, gpr_now(GPR_CLOCK_MONOTONIC)});
+  }
+  num_queued_.fetch_add(1);
+  // An executor increments num_idle_executors_ before it checks num_queued_
+  // for the last time and waits: if it is not counted here yet, it will find
+  // this work.
+  if (num_idle_executors_.load() > 0) {
+    grpc_core::MutexLock lock(&mu_);
+    work_cv_.Signal();
+  }
+}
+
+bool ThreadManager::TakeWork(size_t index, QueuedWork* work) {
+  if (num_queued_.load(std::memory_order_relaxed) == 0) return false;
+  for (size_t i = 0; i < queues_.size(); i++) {
+    WorkQueue* queue = queues_[(index + i) % queues_.size()].get();
+    grpc_core::MutexLock lock(&queue->mu);
+    if (queue->work.empty()) continue;
+    if (i == 0) {
+      *work = queue->work.front();
+      queue->work.pop_front();
+    } else {
+      *work = queue->work.back();
+      queue->work.pop_back();
+    }
+    num_queued_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+void ThreadManager::MaybeAddExecutor() {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  size_t index;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    // Adding executors one per target delay at most lets each new one drain
+    // some of the backlog before the next is added, so that a burst does not
+    // start as many threads as it has requests.
+    if (shutdown_ || num_idle_executors_.load() > 0 ||
+        gpr_time_cmp(gpr_time_sub(now, last_executor_added_),
+                     target_queueing_delay_) < 0) {
+      return;
+    }
+    if (!grpc_resource_user_allocate_threads(resource_user_, 1)) return;
+    last_executor_added_ = now;
+    index = next_executor_index_++;
+    num_executors_++;
+    num_threads_++;
+    if (num_threads_ > max_active_threads_sofar_) {
+      max_active_threads_sofar_ = num_threads_;
+    }
+  }
+  StartThread(WorkerThread::EXECUTOR, index);
+}
+
+void ThreadManager::ExecutorWorkLoop(size_t index) {
+  while (true) {
+    QueuedWork work;
+    if (TakeWork(index, &work)) {
+      gpr_timespec queueing_delay =
+          gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), work.queued_at);
+      if (gpr_time_cmp(queueing_delay, target_queueing_delay_) > 0) {
+        MaybeAddExecutor();
+      }
+      DoWork(work.tag, work.ok, true);
+      continue;
+    }
+
+    grpc_core::MutexLock lock(&mu_);
+    if (shutdown_ && num_pollers_ == 0 && num_queued_.load() == 0) {
+      num_executors_--;
+      break;
+    }
+    num_idle_executors_.fetch_add(1);
+    if (num_queued_.load() > 0) {
+      num_idle_executors_.fetch_sub(1);
+      continue;
+    }
+    bool timed_out = work_cv_.WaitWithTimeout(
+        &mu_, absl::Milliseconds(kExecutorIdleTimeoutMs));
+    num_idle_executors_.fetch_sub(1);
+    if ((timed_out || shutdown_) && num_executors_ > min_pollers_ &&
+        num_queued_.load() == 0) {
+      num_executors_--;
+      break;
+    }
+  }
+
+  CleanupCompletedThreads();
+}
+
 }  // namespace grpc
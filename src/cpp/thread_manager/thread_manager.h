@@ -19,9 +19,13 @@
 #ifndef GRPC_INTERNAL_CPP_THREAD_MANAGER_H
 #define GRPC_INTERNAL_CPP_THREAD_MANAGER_H
 
+#include <atomic>
+#include <deque>
 #include <list>
 #include <memory>
+#include <vector>
 
+#include <grpc/support/time.h>
 #include <grpcpp/support/config.h>
 
 #include "src/core/lib/gprpp/sync.h"
@@ -36,6 +40,20 @@ class ThreadManager {
                          int min_pollers, int max_pollers);
   virtual ~ThreadManager();
 
+  // Switches the ThreadManager to work-stealing mode. Must be called before
+  // Initialize().
+  //
+  // In this mode, a fixed set of 'num_pollers' threads, each pinned to a CPU
+  // (on Linux), call PollForWork() and queue the work found. A pool of executor
+  // threads runs DoWork() on the queued work: each executor takes work from
+  // the queue of one poller first, and steals from the queues of the others
+  // when it is empty. The pool starts with min_pollers executors, adds one
+  // when work waited more than 'target_queueing_delay_usec' in the queues (at
+  // most one per such delay), and drops executors that stay idle. max_pollers
+  // is not used. All threads are still allocated from the resource quota: when
+  // it is exhausted, work waits in the queues rather than being failed.
+  void EnableWorkStealing(int num_pollers, int target_queueing_delay_usec);
+
   // Initializes and Starts the Rpc Manager threads
   void Initialize();
 
@@ -119,25 +137,62 @@ class ThreadManager {
   // not be called (and the need for this WorkerThread class is eliminated)
   class WorkerThread {
    public:
-    explicit WorkerThread(ThreadManager* thd_mgr);
+    enum Role { POLLER, PINNED_POLLER, EXECUTOR };
+
+    explicit WorkerThread(ThreadManager* thd_mgr, Role role = POLLER,
+                          size_t index = 0);
     ~WorkerThread();
 
     bool created() const { return created_; }
     void Start() { thd_.Start(); }
 
    private:
-    // Calls thd_mgr_->MainWorkLoop() and once that completes, calls
+    // Calls the work loop of the thread's role and once that completes, calls
     // thd_mgr_>MarkAsCompleted(this) to mark the thread as completed
     void Run();
 
     ThreadManager* const thd_mgr_;
+    const Role role_;
+    // The index of the poller or executor
+    const size_t index_;
     grpc_core::Thread thd_;
     bool created_;
   };
 
+  // Work found by a pinned poller, waiting for an executor
+  struct QueuedWork {
+    void* tag;
+    bool ok;
+    gpr_timespec queued_at;
+  };
+
+  // The queue of the work found by one pinned poller
+  struct WorkQueue {
+    grpc_core::Mutex mu;
+    std::deque<QueuedWork> work;
+  };
+
   // The main function in ThreadManager
   void MainWorkLoop();
 
+  // The work loops of the work-stealing mode
+  void PinnedPollerWorkLoop(size_t index);
+  void ExecutorWorkLoop(size_t index);
+
+  // Queues work found by the pinned poller 'index' and wakes up an idle
+  // executor, if any
+  void QueueWork(size_t index, void* tag, bool ok);
+  // Takes the oldest work of queue 'index', or else steals the newest work of
+  // another queue. Returns false if all the queues are empty.
+  bool TakeWork(size_t index, QueuedWork* work);
+  // Starts a new executor unless one was started less than
+  // target_queueing_delay_ ago, an executor is idle or there is no thread
+  // quota left
+  void MaybeAddExecutor();
+  // Starts a thread for which num_threads_ and the resource quota were already
+  // accounted. Returns false (and undoes the accounting) if it failed.
+  bool StartThread(WorkerThread::Role role, size_t index);
+
   void MarkAsCompleted(WorkerThread* thd);
   void CleanupCompletedThreads();
 
@@ -174,6 +229,21 @@ class ThreadManager {
 
   grpc_core::Mutex list_mu_;
   std::list<WorkerThread*> completed_threads_;
+
+  // Work-stealing mode state. queues_ and target_queueing_delay_ are set before
+  // Initialize() and never change afterwards. num_executors_,
+  // next_executor_index_ and last_executor_added_ are protected by mu_.
+  bool work_stealing_ = false;
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  gpr_timespec target_queueing_delay_;
+  int num_executors_ = 0;
+  size_t next_executor_index_ = 0;
+  gpr_timespec last_executor_added_;
+  // The total number of queued work items, and of executors waiting for work
+  std::atomic<int> num_queued_{0};
+  std::atomic<int> num_idle_executors_{0};
+  // Signaled when work is queued, and when the last pinned poller exits
+  grpc_core::CondVar work_cv_;
 };
 
 }  // namespace grpc
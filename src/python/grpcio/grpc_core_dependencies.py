@@ -15,6 +15,7 @@
 # AUTO-GENERATED FROM `$REPO_ROOT/templates/src/python/grpcio/grpc_core_dependencies.py.template`!!!
 
 CORE_SOURCE_FILES = [
+    'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
     'src/core/ext/filters/census/grpc_context.cc',
     'src/core/ext/filters/client_channel/backend_metric.cc',
     'src/core/ext/filters/client_channel/backup_poller.cc',
@@ -23,6 +24,7 @@ CORE_SOURCE_FILES = [
     'src/core/ext/filters/client_channel/client_channel_channelz.cc',
     'src/core/ext/filters/client_channel/client_channel_factory.cc',
     'src/core/ext/filters/client_channel/client_channel_plugin.cc',
+    'src/core/ext/filters/client_channel/client_concurrency_filter.cc',
     'src/core/ext/filters/client_channel/config_selector.cc',
     'src/core/ext/filters/client_channel/dynamic_filters.cc',
     'src/core/ext/filters/client_channel/global_subchannel_pool.cc',
@@ -38,6 +40,7 @@ CORE_SOURCE_FILES = [
     'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_channel_secure.cc',
     'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
     'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+    'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
     'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
     'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
     'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
@@ -59,6 +62,7 @@ CORE_SOURCE_FILES = [
     'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_event_engine.cc',
     'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_posix.cc',
     'src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper_windows.cc',
+    'src/core/ext/filters/client_channel/resolver/dns/dns_cache.cc',
     'src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.cc',
     'src/core/ext/filters/client_channel/resolver/dns/native/dns_resolver.cc',
     'src/core/ext/filters/client_channel/resolver/fake/fake_resolver.cc',
@@ -346,18 +350,24 @@ CORE_SOURCE_FILES = [
     'src/core/lib/channel/channel_trace.cc',
     'src/core/lib/channel/channelz.cc',
     'src/core/lib/channel/channelz_registry.cc',
+    'src/core/lib/channel/concurrency_limiter.cc',
     'src/core/lib/channel/connected_channel.cc',
     'src/core/lib/channel/handshaker.cc',
     'src/core/lib/channel/handshaker_registry.cc',
+    'src/core/lib/channel/shm_handshaker.cc',
     'src/core/lib/channel/status_util.cc',
     'src/core/lib/compression/compression.cc',
     'src/core/lib/compression/compression_args.cc',
+    'src/core/lib/compression/compression_dictionary.cc',
+    'src/core/lib/compression/adaptive_compression.cc',
+    'src/core/lib/compression/parallel_compress.cc',
     'src/core/lib/compression/compression_internal.cc',
     'src/core/lib/compression/message_compress.cc',
     'src/core/lib/compression/stream_compression.cc',
     'src/core/lib/compression/stream_compression_gzip.cc',
     'src/core/lib/compression/stream_compression_identity.cc',
     'src/core/lib/config/core_configuration.cc',
+    'src/core/lib/debug/method_stats.cc',
     'src/core/lib/debug/stats.cc',
     'src/core/lib/debug/stats_data.cc',
     'src/core/lib/debug/trace.cc',
@@ -396,6 +406,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/gpr/tmpfile_windows.cc',
     'src/core/lib/gpr/wrap_memcpy.cc',
     'src/core/lib/gprpp/arena.cc',
+    'src/core/lib/gprpp/contention_profiler.cc',
     'src/core/lib/gprpp/examine_stack.cc',
     'src/core/lib/gprpp/fork.cc',
     'src/core/lib/gprpp/global_config_env.cc',
@@ -421,6 +432,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/iomgr/endpoint_pair_event_engine.cc',
     'src/core/lib/iomgr/endpoint_pair_posix.cc',
     'src/core/lib/iomgr/endpoint_pair_windows.cc',
+    'src/core/lib/iomgr/endpoint_shm.cc',
     'src/core/lib/iomgr/error.cc',
     'src/core/lib/iomgr/error_cfstream.cc',
     'src/core/lib/iomgr/ev_apple.cc',
@@ -608,6 +620,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/transport/timeout_encoding.cc',
     'src/core/lib/transport/transport.cc',
     'src/core/lib/transport/transport_op_string.cc',
+    'src/core/lib/transport/write_latency.cc',
     'src/core/lib/uri/uri_parser.cc',
     'src/core/plugin_registry/grpc_plugin_registry.cc',
     'src/core/tsi/alts/crypt/aes_gcm.cc',
@@ -661,6 +674,17 @@ CORE_SOURCE_FILES = [
     'third_party/abseil-cpp/absl/hash/internal/hash.cc',
     'third_party/abseil-cpp/absl/hash/internal/wyhash.cc',
     'third_party/abseil-cpp/absl/numeric/int128.cc',
+    'third_party/abseil-cpp/absl/random/discrete_distribution.cc',
+    'third_party/abseil-cpp/absl/random/gaussian_distribution.cc',
+    'third_party/abseil-cpp/absl/random/internal/pool_urbg.cc',
+    'third_party/abseil-cpp/absl/random/internal/randen.cc',
+    'third_party/abseil-cpp/absl/random/internal/randen_detect.cc',
+    'third_party/abseil-cpp/absl/random/internal/randen_hwaes.cc',
+    'third_party/abseil-cpp/absl/random/internal/randen_round_keys.cc',
+    'third_party/abseil-cpp/absl/random/internal/randen_slow.cc',
+    'third_party/abseil-cpp/absl/random/internal/seed_material.cc',
+    'third_party/abseil-cpp/absl/random/seed_gen_exception.cc',
+    'third_party/abseil-cpp/absl/random/seed_sequences.cc',
     'third_party/abseil-cpp/absl/status/status.cc',
     'third_party/abseil-cpp/absl/status/status_payload_printer.cc',
     'third_party/abseil-cpp/absl/status/statusor.cc',
@@ -68,6 +68,9 @@ extern grpc_compression_options_disable_algorithm_type grpc_compression_options_
 typedef int(*grpc_compression_options_is_algorithm_enabled_type)(const grpc_compression_options* opts, grpc_compression_algorithm algorithm);
 extern grpc_compression_options_is_algorithm_enabled_type grpc_compression_options_is_algorithm_enabled_import;
 #define grpc_compression_options_is_algorithm_enabled grpc_compression_options_is_algorithm_enabled_import
+typedef int(*grpc_compression_dictionary_register_type)(const char* path_prefix, const char* dictionary, size_t length);
+extern grpc_compression_dictionary_register_type grpc_compression_dictionary_register_import;
+#define grpc_compression_dictionary_register grpc_compression_dictionary_register_import
 typedef void(*grpc_metadata_array_init_type)(grpc_metadata_array* array);
 extern grpc_metadata_array_init_type grpc_metadata_array_init_import;
 #define grpc_metadata_array_init grpc_metadata_array_init_import
@@ -611,6 +614,9 @@ extern grpc_slice_malloc_type grpc_slice_malloc_import;
 typedef grpc_slice(*grpc_slice_malloc_large_type)(size_t length);
 extern grpc_slice_malloc_large_type grpc_slice_malloc_large_import;
 #define grpc_slice_malloc_large grpc_slice_malloc_large_import
+typedef grpc_slice(*grpc_slice_malloc_with_headroom_type)(size_t length, size_t headroom);
+extern grpc_slice_malloc_with_headroom_type grpc_slice_malloc_with_headroom_import;
+#define grpc_slice_malloc_with_headroom grpc_slice_malloc_with_headroom_import
 typedef grpc_slice(*grpc_slice_intern_type)(grpc_slice slice);
 extern grpc_slice_intern_type grpc_slice_intern_import;
 #define grpc_slice_intern grpc_slice_intern_import
@@ -0,0 +1,159 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/channel/concurrency_limiter.h"
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+ConcurrencyLimiter::Options TestOptions() {
+  ConcurrencyLimiter::Options options;
+  options.initial_limit = 10;
+  options.min_limit = 2;
+  options.max_limit = 100;
+  // Every call ends a window.
+  options.window_ns = 0;
+  options.min_window_samples = 1;
+  return options;
+}
+
+// Admits \a limiter.limit() calls and releases them with \a latency_ns.
+void RunWindow(ConcurrencyLimiter* limiter, int64_t latency_ns) {
+  int admitted = 0;
+  while (limiter->TryAcquire()) admitted++;
+  for (int i = 0; i < admitted; i++) limiter->Release(latency_ns);
+}
+
+TEST(ConcurrencyLimiterTest, RejectsCallsOverLimit) {
+  RefCountedPtr<ConcurrencyLimiter> limiter =
+      MakeRefCounted<ConcurrencyLimiter>(TestOptions());
+  for (int i = 0; i < 10; i++) EXPECT_TRUE(limiter->TryAcquire());
+  EXPECT_EQ(limiter->in_flight(), 10);
+  EXPECT_FALSE(limiter->TryAcquire());
+  EXPECT_EQ(limiter->rejected(), 1);
+  // A release without a latency sample leaves the limit alone.
+  limiter->Release(-1);
+  EXPECT_EQ(limiter->limit(), 10);
+  EXPECT_TRUE(limiter->TryAcquire());
+  EXPECT_FALSE(limiter->TryAcquire());
+  EXPECT_EQ(limiter->rejected(), 2);
+}
+
+TEST(ConcurrencyLimiterTest, GrowsWhileLatencyHolds) {
+  RefCountedPtr<ConcurrencyLimiter> limiter =
+      MakeRefCounted<ConcurrencyLimiter>(TestOptions());
+  for (int i = 0; i < 200; i++) RunWindow(limiter.get(), GPR_NS_PER_MS);
+  EXPECT_EQ(limiter->limit(), 100);
+  EXPECT_EQ(limiter->in_flight(), 0);
+}
+
+TEST(ConcurrencyLimiterTest, ShrinksWhenLatencyRises) {
+  RefCountedPtr<ConcurrencyLimiter> limiter =
+      MakeRefCounted<ConcurrencyLimiter>(TestOptions());
+  for (int i = 0; i < 20; i++) RunWindow(limiter.get(), GPR_NS_PER_MS);
+  int limit = limiter->limit();
+  EXPECT_GT(limit, 10);
+  int admitted = 0;
+  while (limiter->TryAcquire()) admitted++;
+  // The long-term latency soon follows a sustained rise, so only look at the
+  // first few windows after it.
+  for (int i = 0; i < 10; i++) limiter->Release(10 * GPR_NS_PER_MS);
+  EXPECT_LT(limiter->limit(), limit * 3 / 4);
+  EXPECT_GE(limiter->limit(), 2);
+  for (int i = 10; i < admitted; i++) limiter->Release(-1);
+  EXPECT_EQ(limiter->in_flight(), 0);
+}
+
+TEST(ConcurrencyLimiterTest, DoesNotGrowWhenUnderused) {
+  RefCountedPtr<ConcurrencyLimiter> limiter =
+      MakeRefCounted<ConcurrencyLimiter>(TestOptions());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(limiter->TryAcquire());
+    limiter->Release(GPR_NS_PER_MS);
+  }
+  EXPECT_EQ(limiter->limit(), 10);
+}
+
+TEST(ConcurrencyLimiterTest, ServerOptionsFromChannelArgs) {
+  grpc_arg args[] = {
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_SERVER_CONCURRENCY_INITIAL_LIMIT), 500),
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_SERVER_CONCURRENCY_MIN_LIMIT), 5),
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_SERVER_CONCURRENCY_MAX_LIMIT), 200),
+  };
+  grpc_channel_args channel_args = {GPR_ARRAY_SIZE(args), args};
+  ConcurrencyLimiter::Options options =
+      ConcurrencyLimiter::ServerOptionsFromChannelArgs(&channel_args);
+  EXPECT_EQ(options.min_limit, 5);
+  EXPECT_EQ(options.max_limit, 200);
+  // Out of [min_limit, max_limit]: the default is used.
+  EXPECT_EQ(options.initial_limit, 20);
+  // The client args are not the server's.
+  options = ConcurrencyLimiter::ClientOptionsFromChannelArgs(&channel_args);
+  EXPECT_EQ(options.max_limit, 1000);
+}
+
+TEST(ConcurrencyLimiterTest, ClientOptionsFromChannelArgs) {
+  grpc_arg args[] = {
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_CLIENT_CONCURRENCY_INITIAL_LIMIT), 50),
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_CLIENT_CONCURRENCY_MAX_LIMIT), 200),
+  };
+  grpc_channel_args channel_args = {GPR_ARRAY_SIZE(args), args};
+  ConcurrencyLimiter::Options options =
+      ConcurrencyLimiter::ClientOptionsFromChannelArgs(&channel_args);
+  EXPECT_EQ(options.initial_limit, 50);
+  EXPECT_EQ(options.min_limit, 1);
+  EXPECT_EQ(options.max_limit, 200);
+}
+
+TEST(ConcurrencyLimiterTest, ChannelArgHoldsRef) {
+  RefCountedPtr<ConcurrencyLimiter> limiter =
+      MakeRefCounted<ConcurrencyLimiter>(TestOptions());
+  grpc_arg arg = limiter->MakeChannelArg();
+  grpc_channel_args* args = grpc_channel_args_copy_and_add(nullptr, &arg, 1);
+  ConcurrencyLimiter* found = ConcurrencyLimiter::FromChannelArgs(args);
+  limiter.reset();
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->limit(), 10);
+  grpc_channel_args_destroy(args);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
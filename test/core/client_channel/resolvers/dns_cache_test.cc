@@ -0,0 +1,348 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/filters/client_channel/resolver/dns/dns_cache.h"
+
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper.h"
+#include "src/core/ext/filters/client_channel/resolver_registry.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+DnsCache::ResultPtr MakeResult(int num_addresses, grpc_millis ttl) {
+  auto result = std::make_shared<DnsCache::Result>();
+  result->addresses = absl::make_unique<ServerAddressList>();
+  for (int i = 0; i < num_addresses; i++) {
+    grpc_resolved_address address;
+    memset(&address, 0, sizeof(address));
+    address.len = i + 1;
+    result->addresses->emplace_back(address, nullptr);
+  }
+  result->ttl = ttl;
+  return result;
+}
+
+DnsCache::ResultPtr MakeFailure() {
+  auto result = std::make_shared<DnsCache::Result>();
+  result->error = GRPC_ERROR_CREATE_FROM_STATIC_STRING("no such host");
+  return result;
+}
+
+class DnsCacheTest : public ::testing::Test {
+ protected:
+  // Looks \a key up, expecting a miss that must be resolved.
+  void ExpectResolve(DnsCache* cache, const std::string& key) {
+    bool resolve;
+    EXPECT_EQ(cache->Lookup(key, Unexpected(), &resolve), nullptr);
+    EXPECT_TRUE(resolve);
+  }
+
+  // Looks \a key up, expecting a hit.
+  DnsCache::ResultPtr ExpectHit(DnsCache* cache, const std::string& key) {
+    bool resolve;
+    DnsCache::ResultPtr result = cache->Lookup(key, Unexpected(), &resolve);
+    EXPECT_NE(result, nullptr);
+    EXPECT_FALSE(resolve);
+    return result;
+  }
+
+  void AdvanceTime(grpc_millis ms) {
+    ExecCtx::Get()->TestOnlySetNow(ExecCtx::Get()->Now() + ms);
+  }
+
+  static DnsCache::Callback Unexpected() {
+    return [](DnsCache::ResultPtr) { FAIL() << "unexpected callback"; };
+  }
+
+  ExecCtx exec_ctx_;
+};
+
+TEST_F(DnsCacheTest, CachesResultsForTheirTtl) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  DnsCache::ResultPtr result = MakeResult(2, 1000);
+  cache.Complete("a", result);
+  EXPECT_EQ(ExpectHit(&cache, "a"), result);
+  AdvanceTime(999);
+  EXPECT_EQ(ExpectHit(&cache, "a"), result);
+  AdvanceTime(1);
+  ExpectResolve(&cache, "a");
+}
+
+TEST_F(DnsCacheTest, DefaultAndMaxTtl) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "unknown");
+  cache.Complete("unknown", MakeResult(1, -1));
+  ExpectResolve(&cache, "long");
+  cache.Complete("long", MakeResult(1, 24 * 3600 * GPR_MS_PER_SEC));
+  AdvanceTime(DnsCache::kDefaultTtl - 1);
+  ExpectHit(&cache, "unknown");
+  AdvanceTime(1);
+  ExpectResolve(&cache, "unknown");
+  AdvanceTime(DnsCache::kMaxTtl - DnsCache::kDefaultTtl);
+  ExpectResolve(&cache, "long");
+}
+
+TEST_F(DnsCacheTest, ZeroTtlIsNotCached) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  cache.Complete("a", MakeResult(1, 0));
+  ExpectResolve(&cache, "a");
+}
+
+TEST_F(DnsCacheTest, CachesFailuresBriefly) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  cache.Complete("a", MakeFailure());
+  DnsCache::ResultPtr result = ExpectHit(&cache, "a");
+  EXPECT_TRUE(result->failed());
+  AdvanceTime(DnsCache::kNegativeTtl);
+  ExpectResolve(&cache, "a");
+}
+
+TEST_F(DnsCacheTest, CoalescesLookups) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  std::vector<DnsCache::ResultPtr> results;
+  for (int i = 0; i < 3; i++) {
+    bool resolve;
+    EXPECT_EQ(cache.Lookup(
+                  "a",
+                  [&results](DnsCache::ResultPtr result) {
+                    results.push_back(std::move(result));
+                  },
+                  &resolve),
+              nullptr);
+    EXPECT_FALSE(resolve);
+  }
+  // Other names are resolved separately.
+  ExpectResolve(&cache, "b");
+  EXPECT_TRUE(results.empty());
+  DnsCache::ResultPtr result = MakeResult(1, 1000);
+  cache.Complete("a", result);
+  ASSERT_EQ(results.size(), 3);
+  for (const DnsCache::ResultPtr& r : results) EXPECT_EQ(r, result);
+}
+
+TEST_F(DnsCacheTest, RefreshesExpiredResultsOnce) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  cache.Complete("a", MakeResult(1, 1000));
+  AdvanceTime(1000);
+  ExpectResolve(&cache, "a");
+  bool called = false;
+  bool resolve;
+  cache.Lookup(
+      "a", [&called](DnsCache::ResultPtr) { called = true; }, &resolve);
+  EXPECT_FALSE(resolve);
+  cache.Complete("a", MakeResult(2, 1000));
+  EXPECT_TRUE(called);
+  EXPECT_EQ(ExpectHit(&cache, "a")->addresses->size(), 2);
+}
+
+TEST_F(DnsCacheTest, AbandonWakesWaiters) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  bool called = false;
+  bool resolve;
+  cache.Lookup(
+      "a",
+      [&called](DnsCache::ResultPtr result) {
+        EXPECT_EQ(result, nullptr);
+        called = true;
+      },
+      &resolve);
+  cache.Abandon("a");
+  EXPECT_TRUE(called);
+  // The next lookup resolves.
+  ExpectResolve(&cache, "a");
+}
+
+TEST_F(DnsCacheTest, Invalidate) {
+  DnsCache cache(10);
+  ExpectResolve(&cache, "a");
+  cache.Complete("a", MakeResult(1, 1000));
+  cache.Invalidate("a");
+  ExpectResolve(&cache, "a");
+  // A resolution in flight survives, and so do its waiters.
+  bool called = false;
+  bool resolve;
+  cache.Lookup(
+      "a", [&called](DnsCache::ResultPtr) { called = true; }, &resolve);
+  EXPECT_FALSE(resolve);
+  cache.Invalidate("a");
+  cache.Complete("a", MakeResult(1, 1000));
+  EXPECT_TRUE(called);
+  ExpectHit(&cache, "a");
+}
+
+TEST_F(DnsCacheTest, EvictsLeastRecentlyUsed) {
+  DnsCache cache(2);
+  for (const char* key : {"a", "b"}) {
+    ExpectResolve(&cache, key);
+    cache.Complete(key, MakeResult(1, 1000));
+  }
+  ExpectHit(&cache, "a");
+  ExpectResolve(&cache, "c");
+  cache.Complete("c", MakeResult(1, 1000));
+  ExpectHit(&cache, "a");
+  ExpectHit(&cache, "c");
+  ExpectResolve(&cache, "b");
+}
+
+//
+// The c-ares resolver, with fake lookups.
+//
+
+struct FakeLookup {
+  grpc_closure* on_done;
+  std::unique_ptr<ServerAddressList>* addresses;
+  int* min_ttl_seconds;
+};
+
+std::vector<FakeLookup>* g_lookups;
+
+grpc_ares_request* FakeDnsLookupAresLocked(
+    const char* /*dns_server*/, const char* /*name*/,
+    const char* /*default_port*/, grpc_pollset_set* /*interested_parties*/,
+    grpc_closure* on_done, std::unique_ptr<ServerAddressList>* addresses,
+    std::unique_ptr<ServerAddressList>* /*balancer_addresses*/,
+    char** /*service_config_json*/, int* min_ttl_seconds,
+    int /*query_timeout_ms*/,
+    std::shared_ptr<WorkSerializer> /*work_serializer*/) {
+  g_lookups->push_back({on_done, addresses, min_ttl_seconds});
+  return nullptr;
+}
+
+class CountingResultHandler : public Resolver::ResultHandler {
+ public:
+  explicit CountingResultHandler(int* results) : results_(results) {}
+
+  void ReturnResult(Resolver::Result result) override {
+    EXPECT_EQ(result.addresses.size(), 1);
+    ++*results_;
+  }
+
+  void ReturnError(grpc_error_handle error) override {
+    GRPC_ERROR_UNREF(error);
+    FAIL() << "unexpected error";
+  }
+
+ private:
+  int* results_;
+};
+
+TEST(AresDnsResolverCacheTest, ChannelsShareResolutions) {
+  if (ResolverRegistry::LookupResolverFactory("dns") == nullptr) return;
+  std::vector<FakeLookup> lookups;
+  g_lookups = &lookups;
+  grpc_dns_lookup_ares_locked = FakeDnsLookupAresLocked;
+  grpc_arg arg[] = {
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_DNS_ENABLE_CACHE), 1),
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_DNS_MIN_TIME_BETWEEN_RESOLUTIONS_MS), 0)};
+  grpc_channel_args args = {GPR_ARRAY_SIZE(arg), arg};
+  auto work_serializer = std::make_shared<WorkSerializer>();
+  int results = 0;
+  std::vector<OrphanablePtr<Resolver>> resolvers;
+  ExecCtx exec_ctx;
+  auto start_resolver = [&]() {
+    ResolverArgs resolver_args;
+    resolver_args.uri = *URI::Parse("dns:///cached.test:443");
+    resolver_args.args = &args;
+    resolver_args.work_serializer = work_serializer;
+    resolver_args.result_handler =
+        absl::make_unique<CountingResultHandler>(&results);
+    resolvers.push_back(
+        ResolverRegistry::LookupResolverFactory("dns")->CreateResolver(
+            std::move(resolver_args)));
+    Resolver* resolver = resolvers.back().get();
+    work_serializer->Run([resolver]() { resolver->StartLocked(); },
+                         DEBUG_LOCATION);
+    ExecCtx::Get()->Flush();
+  };
+  auto complete_lookup = [&lookups](size_t i) {
+    *lookups[i].addresses = absl::make_unique<ServerAddressList>();
+    grpc_resolved_address address;
+    memset(&address, 0, sizeof(address));
+    address.len = 1;
+    (*lookups[i].addresses)->emplace_back(address, nullptr);
+    *lookups[i].min_ttl_seconds = 60;
+    ExecCtx::Run(DEBUG_LOCATION, lookups[i].on_done, GRPC_ERROR_NONE);
+    ExecCtx::Get()->Flush();
+  };
+  // A burst of channels sends a single query, which reports TTLs.
+  for (int i = 0; i < 5; i++) start_resolver();
+  ASSERT_EQ(lookups.size(), 1);
+  ASSERT_NE(lookups[0].min_ttl_seconds, nullptr);
+  EXPECT_EQ(results, 0);
+  complete_lookup(0);
+  EXPECT_EQ(results, 5);
+  // Later channels get the cached result.
+  start_resolver();
+  EXPECT_EQ(lookups.size(), 1);
+  EXPECT_EQ(results, 6);
+  // A re-resolution bypasses the cache...
+  Resolver* resolver = resolvers[0].get();
+  work_serializer->Run([resolver]() { resolver->RequestReresolutionLocked(); },
+                       DEBUG_LOCATION);
+  ExecCtx::Get()->Flush();
+  ASSERT_EQ(lookups.size(), 2);
+  EXPECT_EQ(results, 6);
+  complete_lookup(1);
+  EXPECT_EQ(results, 7);
+  // ...and refreshes it for the other channels.
+  start_resolver();
+  EXPECT_EQ(lookups.size(), 2);
+  EXPECT_EQ(results, 8);
+  for (OrphanablePtr<Resolver>& resolver : resolvers) {
+    Resolver* r = resolver.release();
+    work_serializer->Run([r]() { r->Orphan(); }, DEBUG_LOCATION);
+  }
+  ExecCtx::Get()->Flush();
+  DnsCache::Get()->Clear();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
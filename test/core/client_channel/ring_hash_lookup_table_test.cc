@@ -0,0 +1,204 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+
+#include <map>
+
+#include <gtest/gtest.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+std::vector<RingHashEndpoint> MakeEndpoints(size_t num_endpoints) {
+  std::vector<RingHashEndpoint> endpoints(num_endpoints);
+  for (size_t i = 0; i < num_endpoints; ++i) {
+    endpoints[i].address = absl::StrCat("10.0.", i / 256, ".", i % 256, ":443");
+  }
+  return endpoints;
+}
+
+// Returns the address of the endpoint of each entry of table.
+std::vector<std::string> EntryAddresses(
+    const RingHashLookupTable& table,
+    const std::vector<RingHashEndpoint>& endpoints) {
+  std::vector<std::string> addresses(table.size());
+  for (size_t i = 0; i < table.size(); ++i) {
+    addresses[i] = endpoints[table.EndpointIndex(i)].address;
+  }
+  return addresses;
+}
+
+TEST(MaglevTableTest, EveryEndpointGetsItsShareOfEntries) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(10);
+  endpoints[0].weight = 3;
+  auto table = MakeMaglevTable(endpoints, 65537);
+  ASSERT_EQ(table->size(), 65537u);
+  std::vector<size_t> counts(endpoints.size());
+  for (size_t i = 0; i < table->size(); ++i) {
+    ASSERT_LT(table->EndpointIndex(i), endpoints.size());
+    ++counts[table->EndpointIndex(i)];
+  }
+  // Total weight is 12.
+  EXPECT_NEAR(counts[0], 65537 * 3 / 12, 65537 / 12 / 10);
+  for (size_t i = 1; i < endpoints.size(); ++i) {
+    EXPECT_NEAR(counts[i], 65537 / 12, 65537 / 12 / 10) << i;
+  }
+}
+
+TEST(MaglevTableTest, FindEntryIsInTable) {
+  auto table = MakeMaglevTable(MakeEndpoints(3), 251);
+  for (uint64_t hash : {uint64_t(0), uint64_t(250), uint64_t(251), UINT64_MAX}) {
+    EXPECT_EQ(table->FindEntry(hash), hash % 251);
+  }
+}
+
+TEST(MaglevTableTest, RemovingAnEndpointMovesFewOtherEntries) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(100);
+  auto table = MakeMaglevTable(endpoints, 65537);
+  std::vector<std::string> before = EntryAddresses(*table, endpoints);
+  const std::string removed = endpoints[42].address;
+  endpoints.erase(endpoints.begin() + 42);
+  table = MakeMaglevTable(endpoints, 65537);
+  std::vector<std::string> after = EntryAddresses(*table, endpoints);
+  size_t moved = 0;
+  for (size_t i = 0; i < before.size(); ++i) {
+    EXPECT_NE(after[i], removed);
+    if (before[i] != removed && before[i] != after[i]) ++moved;
+  }
+  // Only the entries of the removed endpoint have to move; Maglev moves a
+  // few more.
+  EXPECT_LT(moved, before.size() / 50);
+}
+
+TEST(MaglevTableTest, SameEndpointsInAnyOrderGiveSameMapping) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(20);
+  auto table = MakeMaglevTable(endpoints, 1009);
+  std::vector<RingHashEndpoint> reversed(endpoints.rbegin(), endpoints.rend());
+  auto reversed_table = MakeMaglevTable(reversed, 1009);
+  std::vector<std::string> addresses = EntryAddresses(*table, endpoints);
+  std::vector<std::string> reversed_addresses =
+      EntryAddresses(*reversed_table, reversed);
+  size_t differences = 0;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    if (addresses[i] != reversed_addresses[i]) ++differences;
+  }
+  // Ties between endpoints are broken by their order, so a few entries may
+  // differ.
+  EXPECT_LT(differences, addresses.size() / 10);
+}
+
+TEST(RingHashRingTest, EveryEndpointGetsItsShareOfEntries) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(4);
+  endpoints[1].weight = 2;
+  auto ring = MakeRingHashRing(endpoints, 1024, 8388608);
+  // The least-weighted endpoints get 1024 / 5 = 205 entries (rounded up), so
+  // the ring has 5 * 205 entries.
+  ASSERT_EQ(ring->size(), 1025u);
+  std::map<size_t, size_t> counts;
+  for (size_t i = 0; i < ring->size(); ++i) ++counts[ring->EndpointIndex(i)];
+  EXPECT_EQ(counts[0], 205u);
+  EXPECT_EQ(counts[1], 410u);
+  EXPECT_EQ(counts[2], 205u);
+  EXPECT_EQ(counts[3], 205u);
+}
+
+TEST(RingHashRingTest, SizeIsCappedByMaxRingSize) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(3);
+  endpoints[0].weight = 1000;
+  auto ring = MakeRingHashRing(endpoints, 1024, 4096);
+  EXPECT_LE(ring->size(), 4096u);
+}
+
+TEST(RingHashRingTest, FindEntryWrapsAround) {
+  auto ring = MakeRingHashRing(MakeEndpoints(3), 16, 16);
+  ASSERT_GT(ring->size(), 0u);
+  EXPECT_EQ(ring->FindEntry(0), 0u);
+  EXPECT_EQ(ring->FindEntry(UINT64_MAX), 0u);
+  for (uint64_t hash = 1; hash < UINT64_MAX / 2; hash *= 3) {
+    EXPECT_LT(ring->FindEntry(hash), ring->size());
+  }
+}
+
+class ParseRingHashLbConfigTest : public ::testing::Test {
+ protected:
+  // Parses json, and returns the errors.
+  std::vector<grpc_error_handle> Parse(const char* json_string) {
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    Json json = Json::Parse(json_string, &error);
+    GPR_ASSERT(error == GRPC_ERROR_NONE);
+    std::vector<grpc_error_handle> error_list;
+    ParseRingHashLbConfig(json, &min_ring_size_, &max_ring_size_,
+                          &lookup_table_type_, &maglev_table_size_,
+                          &error_list);
+    return error_list;
+  }
+
+  static void Unref(std::vector<grpc_error_handle> error_list) {
+    for (grpc_error_handle error : error_list) GRPC_ERROR_UNREF(error);
+  }
+
+  size_t min_ring_size_;
+  size_t max_ring_size_;
+  RingHashLookupTableType lookup_table_type_;
+  size_t maglev_table_size_;
+};
+
+TEST_F(ParseRingHashLbConfigTest, Defaults) {
+  EXPECT_TRUE(Parse("{}").empty());
+  EXPECT_EQ(lookup_table_type_, RingHashLookupTableType::kRing);
+  EXPECT_EQ(maglev_table_size_, 65537u);
+}
+
+TEST_F(ParseRingHashLbConfigTest, Maglev) {
+  EXPECT_TRUE(
+      Parse("{\"lookup_table\": \"MAGLEV\", \"maglev_table_size\": 251}")
+          .empty());
+  EXPECT_EQ(lookup_table_type_, RingHashLookupTableType::kMaglev);
+  EXPECT_EQ(maglev_table_size_, 251u);
+}
+
+TEST_F(ParseRingHashLbConfigTest, UnknownLookupTable) {
+  std::vector<grpc_error_handle> error_list =
+      Parse("{\"lookup_table\": \"TREE\"}");
+  EXPECT_EQ(error_list.size(), 1u);
+  Unref(std::move(error_list));
+}
+
+TEST_F(ParseRingHashLbConfigTest, MaglevTableSizeMustBePrime) {
+  std::vector<grpc_error_handle> error_list =
+      Parse("{\"maglev_table_size\": 65536}");
+  EXPECT_EQ(error_list.size(), 1u);
+  Unref(std::move(error_list));
+  error_list = Parse("{\"maglev_table_size\": 5000101}");
+  EXPECT_EQ(error_list.size(), 1u);
+  Unref(std::move(error_list));
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
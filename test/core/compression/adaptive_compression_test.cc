@@ -0,0 +1,207 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/compression/adaptive_compression.h"
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class Message {
+ public:
+  explicit Message(const std::string& data) {
+    grpc_slice_buffer_init(&buffer_);
+    // Split in two, to exercise sampling across slices.
+    const size_t half = data.size() / 2;
+    grpc_slice_buffer_add(&buffer_,
+                          grpc_slice_from_copied_buffer(data.data(), half));
+    grpc_slice_buffer_add(&buffer_, grpc_slice_from_copied_buffer(
+                                        data.data() + half, data.size() - half));
+  }
+  ~Message() { grpc_slice_buffer_destroy_internal(&buffer_); }
+
+  const grpc_slice_buffer* get() const { return &buffer_; }
+
+ private:
+  grpc_slice_buffer buffer_;
+};
+
+std::string RandomBytes(size_t length) {
+  std::mt19937 gen(42);
+  std::string data(length, 0);
+  for (char& c : data) c = static_cast<char>(gen());
+  return data;
+}
+
+std::string Text(size_t length) {
+  static const char kText[] =
+      "The quick brown fox jumps over the lazy dog. Pack my box with five "
+      "dozen liquor jugs. ";
+  std::string data;
+  while (data.size() < length) data += kText;
+  data.resize(length);
+  return data;
+}
+
+TEST(AdaptiveCompressionTest, Entropy) {
+  EXPECT_LT(EstimateEntropyBitsPerByte(Message(std::string(4096, 'a')).get(),
+                                       1024),
+            0.1);
+  EXPECT_LT(EstimateEntropyBitsPerByte(Message(Text(4096)).get(), 1024), 5);
+  EXPECT_GT(EstimateEntropyBitsPerByte(Message(RandomBytes(4096)).get(), 1024),
+            7.5);
+  // Samples that end before sample_size.
+  EXPECT_GT(EstimateEntropyBitsPerByte(Message(RandomBytes(512)).get(), 1024),
+            7.5);
+}
+
+TEST(AdaptiveCompressionTest, SkipsIncompressibleMessages) {
+  AdaptiveCompressionStats stats(0);
+  EXPECT_FALSE(stats.Decide(Message(RandomBytes(4096)).get()).compress);
+  EXPECT_TRUE(stats.Decide(Message(Text(4096)).get()).compress);
+  // Too short to sample.
+  EXPECT_TRUE(stats.Decide(Message(RandomBytes(100)).get()).compress);
+}
+
+TEST(AdaptiveCompressionTest, CompressesAtDefaultLevel) {
+  AdaptiveCompressionStats stats(1000);
+  Message message(Text(4096));
+  for (int i = 0; i < 100; i++) {
+    AdaptiveCompressionStats::Decision decision = stats.Decide(message.get());
+    EXPECT_TRUE(decision.compress);
+    EXPECT_EQ(decision.level, Z_DEFAULT_COMPRESSION);
+    // 3000 bytes saved in 100us: 30000 per CPU-ms.
+    stats.Record(decision.level, 4096, 1096, 100000);
+  }
+  EXPECT_NEAR(stats.ratio(), 1096.0 / 4096, 0.01);
+  EXPECT_NEAR(stats.bytes_saved_per_cpu_ms(), 30000, 1);
+}
+
+TEST(AdaptiveCompressionTest, StopsWhenRatioIsPoorAndProbes) {
+  AdaptiveCompressionStats stats(0);
+  Message message(Text(4096));
+  for (int i = 0; i < 8; i++) {
+    AdaptiveCompressionStats::Decision decision = stats.Decide(message.get());
+    ASSERT_TRUE(decision.compress);
+    stats.Record(decision.level, 4096, 4000, 100000);
+  }
+  int compressed = 0;
+  for (int i = 0; i < 64; i++) {
+    AdaptiveCompressionStats::Decision decision = stats.Decide(message.get());
+    if (decision.compress) {
+      compressed++;
+      EXPECT_EQ(decision.level, Z_DEFAULT_COMPRESSION);
+      stats.Record(decision.level, 4096, 4000, 100000);
+    }
+  }
+  // One probe every 32 messages.
+  EXPECT_EQ(compressed, 2);
+  // A probe that compresses well turns compression back on.
+  AdaptiveCompressionStats::Decision decision;
+  do {
+    decision = stats.Decide(message.get());
+  } while (!decision.compress);
+  stats.Record(decision.level, 4096, 1000, 100000);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(stats.Decide(message.get()).compress);
+  }
+}
+
+TEST(AdaptiveCompressionTest, LowersLevelThenStopsOverCpuBudget) {
+  AdaptiveCompressionStats stats(10000);
+  Message message(Text(4096));
+  // 3000 bytes saved per CPU-ms.
+  for (int i = 0; i < 8; i++) {
+    AdaptiveCompressionStats::Decision decision = stats.Decide(message.get());
+    ASSERT_TRUE(decision.compress);
+    ASSERT_EQ(decision.level, Z_DEFAULT_COMPRESSION);
+    stats.Record(decision.level, 4096, 1096, 1000000);
+  }
+  for (int i = 0; i < 8; i++) {
+    AdaptiveCompressionStats::Decision decision = stats.Decide(message.get());
+    ASSERT_TRUE(decision.compress);
+    ASSERT_EQ(decision.level, Z_BEST_SPEED);
+    stats.Record(decision.level, 4096, 1096, 1000000);
+  }
+  EXPECT_FALSE(stats.Decide(message.get()).compress);
+}
+
+TEST(AdaptiveCompressionTest, ConcurrentCallers) {
+  AdaptiveCompressionStats stats(0);
+  Message message(Text(4096));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&stats, &message] {
+      for (int i = 0; i < 1000; i++) {
+        AdaptiveCompressionStats::Decision decision =
+            stats.Decide(message.get());
+        if (decision.compress) {
+          stats.Record(decision.level, 4096, 4000, 100000);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  // Whatever samples the races lost, the poor ratio turned compression off.
+  EXPECT_NEAR(stats.ratio(), 4000.0 / 4096, 0.01);
+  int compressed = 0;
+  for (int i = 0; i < 64; i++) {
+    if (stats.Decide(message.get()).compress) compressed++;
+  }
+  EXPECT_EQ(compressed, 2);
+}
+
+TEST(AdaptiveCompressionTest, StatsPerMethod) {
+  AdaptiveCompressionPolicy policy(0);
+  AdaptiveCompressionStats* foo = policy.StatsForMethod("/pkg.Service/Foo");
+  EXPECT_EQ(policy.StatsForMethod("/pkg.Service/Foo"), foo);
+  EXPECT_NE(policy.StatsForMethod("/pkg.Service/Bar"), foo);
+  // Past the limit, methods share their stats.
+  for (int i = 0; i < 1000; i++) {
+    policy.StatsForMethod("/pkg.Service/" + std::to_string(i));
+  }
+  EXPECT_EQ(policy.StatsForMethod("/pkg.Service/New1"),
+            policy.StatsForMethod("/pkg.Service/New2"));
+  EXPECT_EQ(policy.StatsForMethod("/pkg.Service/Foo"), foo);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
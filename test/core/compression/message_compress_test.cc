@@ -18,12 +18,18 @@
 
 #include "src/core/lib/compression/message_compress.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
+
+#include <grpc/compression.h>
 #include <grpc/grpc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/compression/compression_dictionary.h"
+#include "src/core/lib/compression/parallel_compress.h"
 #include "src/core/lib/gpr/murmur_hash.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
@@ -310,6 +316,200 @@ static void test_bad_decompression_algorithm(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+/* A small message that shares most of its bytes with kDictionary. */
+static const char kDictionary[] =
+    "{\"user_id\": , \"display_name\": \"\", \"email\": \"@example.com\", "
+    "\"locale\": \"en-US\", \"time_zone\": \"America/Los_Angeles\", "
+    "\"subscription\": {\"plan\": \"premium\", \"renews\": true}}";
+
+static std::string small_message(int n) {
+  return "{\"user_id\": " + std::to_string(n) +
+         ", \"display_name\": \"user" + std::to_string(n) +
+         "\", \"email\": \"user" + std::to_string(n) +
+         "@example.com\", \"locale\": \"en-US\", \"time_zone\": "
+         "\"America/Los_Angeles\", \"subscription\": {\"plan\": "
+         "\"premium\", \"renews\": true}}";
+}
+
+static size_t compressed_length(grpc_core::MessageCompressor* compressor,
+                                grpc_message_compression_algorithm algorithm,
+                                const std::string& message) {
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input,
+                        grpc_slice_from_copied_buffer(message.data(),
+                                                      message.size()));
+  GPR_ASSERT(compressor->Compress(algorithm, &input, &compressed));
+  size_t length = compressed.length;
+  GPR_ASSERT(compressor->Decompress(algorithm, &compressed, &output));
+  grpc_slice merged = grpc_slice_merge(output.slices, output.count);
+  GPR_ASSERT(grpc_slice_str_cmp(merged, message.c_str()) == 0);
+  grpc_slice_unref(merged);
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&compressed);
+  grpc_slice_buffer_destroy(&output);
+  return length;
+}
+
+static void test_dictionary_compress(void) {
+  GPR_ASSERT(grpc_compression_dictionary_register(
+      "/test.Service/", kDictionary, sizeof(kDictionary) - 1));
+  const grpc_core::CompressionDictionary* dictionary =
+      grpc_core::CompressionDictionaryForPath("/test.Service/Get");
+  GPR_ASSERT(dictionary != nullptr);
+  GPR_ASSERT(grpc_core::CompressionDictionaryForPath("/other.Service/Get") ==
+             nullptr);
+  GPR_ASSERT(grpc_core::CompressionDictionaryForId(dictionary->id()) ==
+             dictionary);
+  GPR_ASSERT(grpc_core::CompressionDictionariesRegistered());
+
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MessageCompressor plain;
+  grpc_core::MessageCompressor with_dictionary;
+  with_dictionary.set_dictionary(dictionary);
+  /* the pooled streams are reused across messages */
+  for (int i = 0; i < 10; i++) {
+    std::string message = small_message(i);
+    size_t deflate_length =
+        compressed_length(&plain, GRPC_MESSAGE_COMPRESS_DEFLATE, message);
+    size_t dict_length = compressed_length(
+        &with_dictionary, GRPC_MESSAGE_COMPRESS_DEFLATE, message);
+    gpr_log(GPR_INFO,
+            "message_length=%" PRIuPTR " deflate=%" PRIuPTR
+            " deflate-dict=%" PRIuPTR,
+            message.size(), deflate_length, dict_length);
+    GPR_ASSERT(dict_length * 2 < deflate_length);
+  }
+}
+
+static void test_dictionary_encoding(void) {
+  grpc_core::CompressionDictionary dictionary("some dictionary");
+  char expected[32];
+  snprintf(expected, sizeof(expected), "deflate-dict-%08x", dictionary.id());
+  GPR_ASSERT(dictionary.encoding_name() == expected);
+  uint32_t id;
+  GPR_ASSERT(grpc_core::ParseCompressionDictionaryEncoding(expected, &id));
+  GPR_ASSERT(id == dictionary.id());
+  GPR_ASSERT(!grpc_core::ParseCompressionDictionaryEncoding("deflate", &id));
+  GPR_ASSERT(
+      !grpc_core::ParseCompressionDictionaryEncoding("deflate-dict-", &id));
+  GPR_ASSERT(!grpc_core::ParseCompressionDictionaryEncoding(
+      "deflate-dict-0123456", &id));
+  GPR_ASSERT(!grpc_core::ParseCompressionDictionaryEncoding(
+      "deflate-dict-0123456g", &id));
+  GPR_ASSERT(grpc_core::ParseCompressionDictionaryEncoding(
+      "deflate-dict-0123abCD", &id));
+  GPR_ASSERT(id == 0x0123abcd);
+
+  /* a dictionary encoding is deflate to the rest of the stack */
+  grpc_message_compression_algorithm algorithm;
+  GPR_ASSERT(grpc_message_compression_algorithm_parse(
+      grpc_slice_from_static_string(expected), &algorithm));
+  GPR_ASSERT(algorithm == GRPC_MESSAGE_COMPRESS_DEFLATE);
+
+  GPR_ASSERT(grpc_slice_str_cmp(dictionary.encoding_slice(), expected) == 0);
+  std::string accept_encoding = "identity,gzip," + dictionary.encoding_name();
+  GPR_ASSERT(grpc_slice_str_cmp(dictionary.accept_encoding_slice(
+                                    (1u << GRPC_MESSAGE_COMPRESS_NONE) |
+                                    (1u << GRPC_MESSAGE_COMPRESS_GZIP)),
+                                accept_encoding.c_str()) == 0);
+}
+
+static void test_unknown_dictionary_decompress(void) {
+  /* never registered */
+  grpc_core::CompressionDictionary dictionary("unregistered dictionary");
+  grpc_core::CompressionDictionary other_dictionary("other dictionary");
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MessageCompressor compressor;
+  compressor.set_dictionary(&dictionary);
+  GPR_ASSERT(
+      compressor.Compress(GRPC_MESSAGE_COMPRESS_DEFLATE, &input, &compressed));
+  /* without a dictionary */
+  GPR_ASSERT(0 == grpc_msg_decompress(GRPC_MESSAGE_COMPRESS_DEFLATE,
+                                      &compressed, &output));
+  /* with another one */
+  grpc_core::MessageCompressor decompressor;
+  decompressor.set_dictionary(&other_dictionary);
+  GPR_ASSERT(0 == decompressor.Decompress(GRPC_MESSAGE_COMPRESS_DEFLATE,
+                                          &compressed, &output));
+  GPR_ASSERT(output.length == 0);
+
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&compressed);
+  grpc_slice_buffer_destroy(&output);
+}
+
+/* text that compresses, but not to nothing, across chunk boundaries */
+static std::string large_message(size_t length) {
+  std::string message;
+  for (int n = 0; message.size() < length; n++) {
+    message += small_message(n * 7919 % 100003);
+  }
+  message.resize(length);
+  return message;
+}
+
+static void test_parallel_compress(void) {
+  const size_t chunk = grpc_core::ParallelCompressor::kChunkSize;
+  const size_t lengths[] = {1, 1000, chunk - 1, chunk, chunk + 1,
+                            3 * chunk + 12345};
+  const grpc_message_compression_algorithm algorithms[] = {
+      GRPC_MESSAGE_COMPRESS_DEFLATE, GRPC_MESSAGE_COMPRESS_GZIP};
+  const int levels[] = {Z_DEFAULT_COMPRESSION, Z_BEST_SPEED, 9};
+  grpc_core::ExecCtx exec_ctx;
+  for (int threads = 1; threads <= 3; threads += 2) {
+    grpc_core::ParallelCompressor parallel(threads);
+    for (size_t length : lengths) {
+      std::string message = large_message(length);
+      for (grpc_message_compression_algorithm algorithm : algorithms) {
+        for (int level : levels) {
+          grpc_slice_buffer input;
+          grpc_slice_buffer compressed;
+          grpc_slice_buffer output;
+          grpc_slice_buffer_init(&input);
+          grpc_slice_buffer_init(&compressed);
+          grpc_slice_buffer_init(&output);
+          /* slices that straddle the chunks */
+          for (size_t i = 0; i < length; i += 7000) {
+            grpc_slice_buffer_add(
+                &input, grpc_slice_from_copied_buffer(
+                            message.data() + i, GPR_MIN(7000, length - i)));
+          }
+          grpc_core::MessageCompressor compressor;
+          compressor.set_level(level);
+          compressor.set_parallel_compressor(&parallel, 1);
+          int was_compressed = compressor.Compress(algorithm, &input,
+                                                   &compressed);
+          GPR_ASSERT(was_compressed || length < 1000);
+          if (was_compressed) {
+            GPR_ASSERT(grpc_msg_decompress(algorithm, &compressed, &output));
+          } else {
+            grpc_slice_buffer_move_into(&compressed, &output);
+          }
+          grpc_slice merged = grpc_slice_merge(output.slices, output.count);
+          GPR_ASSERT(grpc_slice_str_cmp(merged, message.c_str()) == 0);
+          grpc_slice_unref(merged);
+          grpc_slice_buffer_destroy(&input);
+          grpc_slice_buffer_destroy(&compressed);
+          grpc_slice_buffer_destroy(&output);
+        }
+      }
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   unsigned i, j, k, m;
   grpc_slice_split_mode uncompressed_split_modes[] = {
@@ -346,6 +546,10 @@ int main(int argc, char** argv) {
   test_bad_decompression_data_trailing_garbage();
   test_bad_compression_algorithm();
   test_bad_decompression_algorithm();
+  test_dictionary_compress();
+  test_dictionary_encoding();
+  test_unknown_dictionary_decompress();
+  test_parallel_compress();
   grpc_shutdown();
 
   return 0;
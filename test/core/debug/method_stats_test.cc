@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/debug/method_stats.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+TEST(MethodStatsTest, Buckets) {
+  for (uint64_t value = 0; value < MethodStats::kSubBuckets; ++value) {
+    EXPECT_EQ(MethodStats::BucketFor(value), value);
+  }
+  EXPECT_EQ(MethodStats::BucketFor(4), 4);
+  EXPECT_EQ(MethodStats::BucketFor(7), 7);
+  EXPECT_EQ(MethodStats::BucketFor(8), 8);
+  EXPECT_EQ(MethodStats::BucketFor(9), 8);
+  EXPECT_EQ(MethodStats::BucketFor(10), 9);
+  EXPECT_EQ(MethodStats::BucketFor(UINT64_MAX), MethodStats::kNumBuckets - 1);
+  // Every bucket starts where the previous one ends.
+  for (int bucket = 1; bucket < MethodStats::kNumBuckets; ++bucket) {
+    uint64_t lower = MethodStats::BucketLowerBound(bucket);
+    EXPECT_EQ(MethodStats::BucketFor(lower), bucket);
+    EXPECT_EQ(MethodStats::BucketFor(lower - 1), bucket - 1);
+  }
+}
+
+TEST(MethodStatsTest, RecordsCalls) {
+  ExecCtx exec_ctx;
+  MethodStats stats("/foo.Bar/Baz", "");
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    stats.RecordCall(i * 1000, i * 2000, 10, i);
+  }
+  MethodStats::Snapshot snapshot = stats.GetSnapshot();
+  const MethodStats::Histogram& queue_time =
+      snapshot.metrics[MethodStats::kQueueTime];
+  EXPECT_EQ(queue_time.count(), 1000);
+  EXPECT_EQ(queue_time.sum(), 1000 * 1001 / 2 * 1000);
+  EXPECT_EQ(snapshot.metrics[MethodStats::kBytesIn].sum(), 10000);
+  // Percentiles are within the 25% bucket width of the exact values.
+  EXPECT_NEAR(queue_time.Percentile(50), 500000, 500000 * 0.25);
+  EXPECT_NEAR(queue_time.Percentile(99), 990000, 990000 * 0.25);
+  const MethodStats::Histogram& handler_time =
+      snapshot.metrics[MethodStats::kHandlerTime];
+  EXPECT_NEAR(handler_time.Percentile(90), 1800000, 1800000 * 0.25);
+  EXPECT_EQ(snapshot.metrics[MethodStats::kBytesIn].Percentile(50),
+            MethodStats::BucketLowerBound(MethodStats::BucketFor(10)) + 1);
+}
+
+TEST(MethodStatsTest, EmptyHistogram) {
+  MethodStats stats("/foo.Bar/Baz", "");
+  MethodStats::Snapshot snapshot = stats.GetSnapshot();
+  EXPECT_EQ(snapshot.metrics[MethodStats::kQueueTime].count(), 0);
+  EXPECT_EQ(snapshot.metrics[MethodStats::kQueueTime].Percentile(50), 0);
+}
+
+TEST(MethodStatsTest, RecordsFromManyThreads) {
+  constexpr int kThreads = 8;
+  constexpr int kCallsPerThread = 10000;
+  MethodStats stats("/foo.Bar/Baz", "");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&stats]() {
+      ExecCtx exec_ctx;
+      for (int i = 0; i < kCallsPerThread; ++i) stats.RecordCall(1, 2, 3, 4);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  MethodStats::Snapshot snapshot = stats.GetSnapshot();
+  for (const MethodStats::Histogram& histogram : snapshot.metrics) {
+    EXPECT_EQ(histogram.count(), kThreads * kCallsPerThread);
+  }
+  EXPECT_EQ(snapshot.metrics[MethodStats::kBytesOut].sum(),
+            4 * kThreads * kCallsPerThread);
+}
+
+TEST(MethodStatsTest, RenderedByChannelz) {
+  ExecCtx exec_ctx;
+  auto stats = MakeRefCounted<MethodStats>("/foo.Bar/Baz", "");
+  stats->RecordCall(1000, 2000, 30, 40);
+  auto server_node = MakeRefCounted<channelz::ServerNode>(0);
+  server_node->AddMethodStats(stats);
+  Json json = server_node->RenderJson();
+  const Json::Array& array = json.object_value().at("methodStats").array_value();
+  ASSERT_EQ(array.size(), 1);
+  const Json::Object& method = array[0].object_value();
+  EXPECT_EQ(method.at("method").string_value(), "/foo.Bar/Baz");
+  EXPECT_EQ(method.at("callsRecorded").string_value(), "1");
+  EXPECT_EQ(method.count("host"), 0);
+  const Json::Object& bytes_out = method.at("bytesOut").object_value();
+  EXPECT_EQ(bytes_out.at("sum").string_value(), "40");
+  EXPECT_EQ(bytes_out.count("p99"), 1);
+  EXPECT_EQ(method.count("queueTimeNanos"), 1);
+  EXPECT_EQ(method.count("handlerTimeNanos"), 1);
+  EXPECT_EQ(method.count("bytesIn"), 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
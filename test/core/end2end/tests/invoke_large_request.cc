@@ -90,11 +90,36 @@ static grpc_slice large_slice(void) {
   return slice;
 }
 
+// The same payload as large_slice(), in slices with headroom that the
+// transport can frame in place.
+static grpc_byte_buffer* framed_large_payload(void) {
+  grpc_slice slices[1000000 / GRPC_SLICE_WRITE_CHUNK_SIZE + 2];
+  size_t count = 0;
+  size_t remaining = 1000000;
+  // The first slice leaves room for the message prefix.
+  size_t chunk_size = GRPC_SLICE_WRITE_CHUNK_SIZE - 5;
+  while (remaining > 0) {
+    size_t length = GPR_MIN(chunk_size, remaining);
+    slices[count] =
+        grpc_slice_malloc_with_headroom(length, GRPC_SLICE_WRITE_HEADROOM);
+    memset(GRPC_SLICE_START_PTR(slices[count]), 'x', length);
+    count++;
+    remaining -= length;
+    chunk_size = GRPC_SLICE_WRITE_CHUNK_SIZE;
+  }
+  grpc_byte_buffer* payload = grpc_raw_byte_buffer_create(slices, count);
+  for (size_t i = 0; i < count; i++) {
+    grpc_slice_unref(slices[i]);
+  }
+  return payload;
+}
+
 static void test_invoke_large_request(grpc_end2end_test_config config,
-                                      int max_frame_size, int lookahead_bytes) {
+                                      int max_frame_size, int lookahead_bytes,
+                                      bool framed) {
   std::string name = absl::StrFormat(
-      "test_invoke_large_request:max_frame_size=%d:lookahead_bytes=%d",
-      max_frame_size, lookahead_bytes);
+      "test_invoke_large_request:max_frame_size=%d:lookahead_bytes=%d%s",
+      max_frame_size, lookahead_bytes, framed ? ":framed" : "");
 
   grpc_arg args[2];
   args[0].type = GRPC_ARG_INTEGER;
@@ -113,7 +138,8 @@ static void test_invoke_large_request(grpc_end2end_test_config config,
   grpc_call* c;
   grpc_call* s;
   grpc_byte_buffer* request_payload =
-      grpc_raw_byte_buffer_create(&request_payload_slice, 1);
+      framed ? framed_large_payload()
+             : grpc_raw_byte_buffer_create(&request_payload_slice, 1);
   grpc_byte_buffer* response_payload =
       grpc_raw_byte_buffer_create(&response_payload_slice, 1);
   cq_verifier* cqv = cq_verifier_create(f.cq);
@@ -236,6 +262,7 @@ static void test_invoke_large_request(grpc_end2end_test_config config,
   GPR_ASSERT(0 == grpc_slice_str_cmp(details, "xyz"));
   GPR_ASSERT(0 == grpc_slice_str_cmp(call_details.method, "/foo"));
   GPR_ASSERT(was_cancelled == 0);
+  GPR_ASSERT(byte_buffer_eq_slice(request_payload_recv, request_payload_slice));
 
   grpc_slice_unref(details);
   grpc_metadata_array_destroy(&initial_metadata_recv);
@@ -252,7 +279,6 @@ static void test_invoke_large_request(grpc_end2end_test_config config,
   grpc_byte_buffer_destroy(response_payload);
   grpc_byte_buffer_destroy(request_payload_recv);
   grpc_byte_buffer_destroy(response_payload_recv);
-  grpc_slice_unref(request_payload_slice);
   grpc_slice_unref(response_payload_slice);
 
   end_test(&f);
@@ -260,26 +286,30 @@ static void test_invoke_large_request(grpc_end2end_test_config config,
 }
 
 void invoke_large_request(grpc_end2end_test_config config) {
-  test_invoke_large_request(config, 16384, 65536);
-  test_invoke_large_request(config, 32768, 65536);
-
-  test_invoke_large_request(config, 1000000 - 1, 65536);
-  test_invoke_large_request(config, 1000000, 65536);
-  test_invoke_large_request(config, 1000000 + 1, 65536);
-  test_invoke_large_request(config, 1000000 + 2, 65536);
-  test_invoke_large_request(config, 1000000 + 3, 65536);
-  test_invoke_large_request(config, 1000000 + 4, 65536);
-  test_invoke_large_request(config, 1000000 + 5, 65536);
-  test_invoke_large_request(config, 1000000 + 6, 65536);
-
-  test_invoke_large_request(config, 1000000 - 1, 2000000);
-  test_invoke_large_request(config, 1000000, 2000000);
-  test_invoke_large_request(config, 1000000 + 1, 2000000);
-  test_invoke_large_request(config, 1000000 + 2, 2000000);
-  test_invoke_large_request(config, 1000000 + 3, 2000000);
-  test_invoke_large_request(config, 1000000 + 4, 2000000);
-  test_invoke_large_request(config, 1000000 + 5, 2000000);
-  test_invoke_large_request(config, 1000000 + 6, 2000000);
+  test_invoke_large_request(config, 16384, 65536, false);
+  test_invoke_large_request(config, 32768, 65536, false);
+
+  test_invoke_large_request(config, 1000000 - 1, 65536, false);
+  test_invoke_large_request(config, 1000000, 65536, false);
+  test_invoke_large_request(config, 1000000 + 1, 65536, false);
+  test_invoke_large_request(config, 1000000 + 2, 65536, false);
+  test_invoke_large_request(config, 1000000 + 3, 65536, false);
+  test_invoke_large_request(config, 1000000 + 4, 65536, false);
+  test_invoke_large_request(config, 1000000 + 5, 65536, false);
+  test_invoke_large_request(config, 1000000 + 6, 65536, false);
+
+  test_invoke_large_request(config, 1000000 - 1, 2000000, false);
+  test_invoke_large_request(config, 1000000, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 1, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 2, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 3, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 4, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 5, 2000000, false);
+  test_invoke_large_request(config, 1000000 + 6, 2000000, false);
+
+  test_invoke_large_request(config, 16384, 65536, true);
+  test_invoke_large_request(config, 32768, 65536, true);
+  test_invoke_large_request(config, 1000000 + 6, 2000000, true);
 }
 
 void invoke_large_request_pre_init(void) {}
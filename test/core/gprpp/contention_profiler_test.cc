@@ -0,0 +1,165 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/gprpp/contention_profiler.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class ContentionProfilerTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    ContentionProfiler::Disable();
+    ContentionProfiler::Reset();
+  }
+
+  // Returns the stats of the site at \a line of this file.
+  static ContentionProfiler::SiteStats StatsAt(int line) {
+    std::string site = absl::StrCat(__FILE__, ":", line);
+    for (const auto& stats : ContentionProfiler::GetStats()) {
+      if (stats.site == site) return stats;
+    }
+    return ContentionProfiler::SiteStats();
+  }
+};
+
+TEST_F(ContentionProfilerTest, DisabledRecordsNothing) {
+  Mutex mu;
+  for (int i = 0; i < 100; ++i) {
+    MutexLock lock(&mu);
+  }
+  EXPECT_TRUE(ContentionProfiler::GetStats().empty());
+}
+
+TEST_F(ContentionProfilerTest, RecordsHoldTimePerSite) {
+  ContentionProfiler::Enable(1);
+  Mutex mu;
+  int line;
+  for (int i = 0; i < 3; ++i) {
+    line = __LINE__ + 1;
+    MutexLock lock(&mu);
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  ContentionProfiler::SiteStats stats = StatsAt(line);
+  EXPECT_EQ(stats.acquisitions, 3);
+  EXPECT_EQ(stats.contended, 0);
+  EXPECT_GE(stats.hold_ns, 30 * GPR_NS_PER_MS);
+  EXPECT_GE(stats.max_hold_ns, 10 * GPR_NS_PER_MS);
+  EXPECT_TRUE(absl::StrContains(ContentionProfiler::Report(),
+                                absl::StrCat(__FILE__, ":", line)));
+}
+
+TEST_F(ContentionProfilerTest, RecordsWaitTime) {
+  ContentionProfiler::Enable(1);
+  Mutex mu;
+  absl::Notification locked;
+  std::thread holder([&]() {
+    MutexLock lock(&mu);
+    locked.Notify();
+    absl::SleepFor(absl::Milliseconds(50));
+  });
+  locked.WaitForNotification();
+  int line = __LINE__ + 1;
+  { MutexLock lock(&mu); }
+  holder.join();
+  ContentionProfiler::SiteStats stats = StatsAt(line);
+  EXPECT_EQ(stats.contended, 1);
+  EXPECT_GE(stats.wait_ns, 20 * GPR_NS_PER_MS);
+  // The longest wait comes first.
+  EXPECT_EQ(ContentionProfiler::GetStats()[0].site, stats.site);
+}
+
+TEST_F(ContentionProfilerTest, ReleasableLocks) {
+  ContentionProfiler::Enable(1);
+  Mutex mu;
+  int line = __LINE__ + 1;
+  ReleasableMutexLock lock(&mu);
+  absl::SleepFor(absl::Milliseconds(10));
+  lock.Release();
+  EXPECT_GE(StatsAt(line).hold_ns, 10 * GPR_NS_PER_MS);
+}
+
+TEST_F(ContentionProfilerTest, SamplesGprMu) {
+  ContentionProfiler::Enable(1);
+  gpr_mu mu;
+  gpr_mu_init(&mu);
+  gpr_mu_lock(&mu);
+  gpr_mu_unlock(&mu);
+  gpr_mu_destroy(&mu);
+  bool found = false;
+  for (const auto& stats : ContentionProfiler::GetStats()) {
+    if (absl::StartsWith(stats.site, "gpr_mu_lock() from ")) found = true;
+  }
+#ifdef GPR_ABSEIL_SYNC
+  EXPECT_TRUE(found);
+#else
+  (void)found;
+#endif
+}
+
+#ifdef GPR_POSIX_SYNC
+TEST_F(ContentionProfilerTest, ReusesTheStatesOfExitedThreads) {
+  ContentionProfiler::Enable(1);
+  Mutex mu;
+  const int kThreads = 100;
+  const int line = __LINE__ + 3;
+  for (int i = 0; i < kThreads; ++i) {
+    // Each thread takes the state the previous one left behind.
+    std::thread([&mu]() { MutexLock lock(&mu); }).join();
+  }
+  EXPECT_EQ(StatsAt(line).acquisitions, kThreads);
+}
+#endif
+
+TEST_F(ContentionProfilerTest, ScalesSamplesByThePeriod) {
+  ContentionProfiler::Enable(10);
+  Mutex mu;
+  int line;
+  for (int i = 0; i < 1000; ++i) {
+    line = __LINE__ + 1;
+    MutexLock lock(&mu);
+  }
+  ContentionProfiler::SiteStats stats = StatsAt(line);
+  EXPECT_GE(stats.acquisitions, 990);
+  EXPECT_LE(stats.acquisitions, 1010);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
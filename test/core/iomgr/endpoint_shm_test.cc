@@ -0,0 +1,405 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/port.h"
+
+// This test won't work except with the shared-memory endpoint enabled
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <functional>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/iomgr/endpoint_shm.h"
+#include "test/core/iomgr/endpoint_tests.h"
+#include "test/core/util/test_config.h"
+
+static gpr_mu* g_mu;
+static grpc_pollset* g_pollset;
+
+static void clean_up(void) {}
+
+/* Polls g_pollset until \a done returns true. */
+static void poll_until(const std::function<bool()>& done) {
+  gpr_mu_lock(g_mu);
+  grpc_millis deadline =
+      grpc_timespec_to_millis_round_up(grpc_timeout_seconds_to_deadline(10));
+  while (!done() && grpc_core::ExecCtx::Get()->Now() < deadline) {
+    grpc_pollset_worker* worker = nullptr;
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "pollset_work", grpc_pollset_work(g_pollset, &worker, deadline)));
+    gpr_mu_unlock(g_mu);
+    grpc_core::ExecCtx::Get()->Flush();
+    gpr_mu_lock(g_mu);
+  }
+  gpr_mu_unlock(g_mu);
+}
+
+struct handshake_state {
+  bool done = false;
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  grpc_endpoint* endpoint = nullptr;
+  grpc_closure on_done;
+};
+
+static void on_handshake_done(void* arg, grpc_error_handle error) {
+  handshake_state* state = static_cast<handshake_state*>(arg);
+  gpr_mu_lock(g_mu);
+  state->done = true;
+  state->error = GRPC_ERROR_REF(error);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR("kick", grpc_pollset_kick(g_pollset, nullptr)));
+  gpr_mu_unlock(g_mu);
+}
+
+static grpc_fd* create_polled_fd(int fd, const char* name) {
+  grpc_fd* result = grpc_fd_create(fd, name, false);
+  grpc_pollset_add_fd(g_pollset, result);
+  return result;
+}
+
+/* Accepts the handshake arriving on \a fd. */
+static void accept_handshake(int fd, handshake_state* state) {
+  grpc_fd* server_fd = create_polled_fd(fd, "server");
+  GRPC_CLOSURE_INIT(&state->on_done, on_handshake_done, state,
+                    grpc_schedule_on_exec_ctx);
+  grpc_shm_endpoint_accept(server_fd, "test:client", &state->endpoint,
+                           &state->on_done);
+  poll_until([state]() { return state->done; });
+  GPR_ASSERT(state->done);
+  grpc_fd_orphan(server_fd, nullptr, nullptr, "test");
+}
+
+static grpc_endpoint_test_fixture finish_fixture(grpc_endpoint* client,
+                                                 grpc_endpoint* server) {
+  grpc_endpoint_test_fixture f;
+  f.client_ep = client;
+  f.server_ep = server;
+  grpc_endpoint_add_to_pollset(f.client_ep, g_pollset);
+  grpc_endpoint_add_to_pollset(f.server_ep, g_pollset);
+  return f;
+}
+
+/* A ring much smaller than the test writes, so that writers keep waiting for
+   space and positions wrap around. */
+static grpc_endpoint_test_fixture create_fixture_small_ring(
+    size_t /*slice_size*/) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_endpoint_pair p = grpc_shm_endpoint_pair_create("test", 4096);
+  return finish_fixture(p.client, p.server);
+}
+
+/* Both ends set up through the Unix domain socket handshake. */
+static grpc_endpoint_test_fixture create_fixture_handshake(
+    size_t /*slice_size*/) {
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  grpc_fd* client_fd = create_polled_fd(sv[0], "client");
+  grpc_fd* server_fd = create_polled_fd(sv[1], "server");
+  handshake_state client;
+  handshake_state server;
+  GRPC_CLOSURE_INIT(&client.on_done, on_handshake_done, &client,
+                    grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&server.on_done, on_handshake_done, &server,
+                    grpc_schedule_on_exec_ctx);
+  /* Both ends run on this thread, so neither step may block. */
+  grpc_shm_endpoint_connect(client_fd, GRPC_SHM_ENDPOINT_DEFAULT_RING_SIZE,
+                            "test:server", &client.endpoint, &client.on_done);
+  grpc_shm_endpoint_accept(server_fd, "test:client", &server.endpoint,
+                           &server.on_done);
+  poll_until([&]() { return client.done && server.done; });
+  GPR_ASSERT(client.done && server.done);
+  GPR_ASSERT(client.error == GRPC_ERROR_NONE);
+  GPR_ASSERT(server.error == GRPC_ERROR_NONE);
+  grpc_fd_orphan(client_fd, nullptr, nullptr, "test");
+  grpc_fd_orphan(server_fd, nullptr, nullptr, "test");
+  return finish_fixture(client.endpoint, server.endpoint);
+}
+
+static grpc_endpoint_test_config configs[] = {
+    {"shm/small_ring", create_fixture_small_ring, clean_up},
+    {"shm/handshake", create_fixture_handshake, clean_up},
+};
+
+struct read_state {
+  bool done = false;
+  grpc_error_handle error = GRPC_ERROR_NONE;
+};
+
+static void on_read_done(void* arg, grpc_error_handle error) {
+  read_state* state = static_cast<read_state*>(arg);
+  gpr_mu_lock(g_mu);
+  state->done = true;
+  state->error = GRPC_ERROR_REF(error);
+  GPR_ASSERT(GRPC_LOG_IF_ERROR("kick", grpc_pollset_kick(g_pollset, nullptr)));
+  gpr_mu_unlock(g_mu);
+}
+
+/* Destroying one end makes pending reads on the other end fail. */
+static void test_peer_destroyed(void) {
+  gpr_log(GPR_INFO, "test_peer_destroyed");
+  grpc_core::ExecCtx exec_ctx;
+  grpc_endpoint_test_fixture f = create_fixture_small_ring(0);
+  grpc_slice_buffer incoming;
+  grpc_slice_buffer_init(&incoming);
+  read_state state;
+  grpc_closure read_closure;
+  GRPC_CLOSURE_INIT(&read_closure, on_read_done, &state,
+                    grpc_schedule_on_exec_ctx);
+  grpc_endpoint_read(f.server_ep, &incoming, &read_closure, /*urgent=*/false);
+  grpc_endpoint_destroy(f.client_ep);
+  grpc_core::ExecCtx::Get()->Flush();
+  poll_until([&state]() { return state.done; });
+  GPR_ASSERT(state.done);
+  GPR_ASSERT(state.error != GRPC_ERROR_NONE);
+  GRPC_ERROR_UNREF(state.error);
+  grpc_slice_buffer_destroy(&incoming);
+  grpc_endpoint_destroy(f.server_ep);
+}
+
+/* Plays a hand-rolled client: sends a segment laid out like the endpoint's
+   (a header page, then per ring a control page followed by the data), and
+   returns the mapped segment. Sends \a doorbells if set, which stay open,
+   and new non-blocking eventfds otherwise. */
+static const size_t kTestRingSize = 4096;
+static const size_t kTestSegmentSize = 4096 + 2 * (4096 + kTestRingSize);
+
+static void* send_segment(int sock, bool seal,
+                          const int* doorbells = nullptr) {
+  int fds[5];
+  fds[0] = static_cast<int>(syscall(SYS_memfd_create, "test",
+                                    seal ? 2u /* MFD_ALLOW_SEALING */ : 0u));
+  GPR_ASSERT(fds[0] >= 0);
+  GPR_ASSERT(ftruncate(fds[0], kTestSegmentSize) == 0);
+  if (seal) {
+    GPR_ASSERT(fcntl(fds[0], 1033 /* F_ADD_SEALS */,
+                     0x2 | 0x4 /* F_SEAL_SHRINK | F_SEAL_GROW */) == 0);
+  }
+  void* segment = mmap(nullptr, kTestSegmentSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fds[0], 0);
+  GPR_ASSERT(segment != MAP_FAILED);
+  uint64_t* header = static_cast<uint64_t*>(segment);
+  header[0] = 0x6d68732d63707267; /* magic */
+  header[1] = kTestRingSize;
+  for (int i = 1; i < 5; i++) {
+    fds[i] = doorbells != nullptr ? dup(doorbells[i - 1])
+                                  : eventfd(0, EFD_NONBLOCK);
+    GPR_ASSERT(fds[i] >= 0);
+  }
+  struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t ring_size;
+  } request = {0x6d68732d63707267, 1, 0, kTestRingSize};
+  struct iovec iov = {&request, sizeof(request)};
+  union {
+    char buf[CMSG_SPACE(sizeof(fds))];
+    struct cmsghdr align;
+  } control;
+  memset(&control, 0, sizeof(control));
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+  GPR_ASSERT(sendmsg(sock, &msg, 0) == sizeof(request));
+  for (int fd : fds) close(fd);
+  return segment;
+}
+
+/* A segment the peer could still shrink is refused. */
+static void test_rejects_unsealed_segment(void) {
+  gpr_log(GPR_INFO, "test_rejects_unsealed_segment");
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  void* segment = send_segment(sv[0], /*seal=*/false);
+  handshake_state server;
+  accept_handshake(sv[1], &server);
+  GPR_ASSERT(server.error != GRPC_ERROR_NONE);
+  GPR_ASSERT(server.endpoint == nullptr);
+  GRPC_ERROR_UNREF(server.error);
+  munmap(segment, kTestSegmentSize);
+  close(sv[0]);
+}
+
+/* Doorbells that are not eventfds are refused: ringing a pipe could block. */
+static void test_rejects_non_eventfd_doorbell(void) {
+  gpr_log(GPR_INFO, "test_rejects_non_eventfd_doorbell");
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  int pipe_fds[2];
+  GPR_ASSERT(pipe(pipe_fds) == 0);
+  int doorbells[4];
+  for (int i = 0; i < 4; i++) {
+    doorbells[i] = i == 0 ? pipe_fds[1] : eventfd(0, EFD_NONBLOCK);
+    GPR_ASSERT(doorbells[i] >= 0);
+  }
+  void* segment = send_segment(sv[0], /*seal=*/true, doorbells);
+  handshake_state server;
+  accept_handshake(sv[1], &server);
+  GPR_ASSERT(server.error != GRPC_ERROR_NONE);
+  GPR_ASSERT(server.endpoint == nullptr);
+  GRPC_ERROR_UNREF(server.error);
+  for (int fd : doorbells) close(fd);
+  close(pipe_fds[0]);
+  munmap(segment, kTestSegmentSize);
+  close(sv[0]);
+}
+
+/* Blocking doorbells are made non-blocking, so that a doorbell the peer
+   filled up cannot stall us. */
+static void test_makes_doorbells_nonblocking(void) {
+  gpr_log(GPR_INFO, "test_makes_doorbells_nonblocking");
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  int doorbells[4];
+  for (int i = 0; i < 4; i++) {
+    doorbells[i] = eventfd(0, 0);
+    GPR_ASSERT(doorbells[i] >= 0);
+  }
+  void* segment = send_segment(sv[0], /*seal=*/true, doorbells);
+  handshake_state server;
+  accept_handshake(sv[1], &server);
+  GPR_ASSERT(server.error == GRPC_ERROR_NONE);
+  for (int fd : doorbells) {
+    GPR_ASSERT((fcntl(fd, F_GETFL) & O_NONBLOCK) != 0);
+  }
+  /* Fill up the doorbell the server rings when it frees space in ring 0.
+     Ringing it again must not block. */
+  GPR_ASSERT(eventfd_write(doorbells[1], 0xfffffffffffffffe) == 0);
+  grpc_endpoint_destroy(server.endpoint);
+  for (int fd : doorbells) close(fd);
+  munmap(segment, kTestSegmentSize);
+  close(sv[0]);
+}
+
+/* A peer publishing a write position beyond the ring fails the reads instead
+   of making us copy out of bounds. */
+static void test_rejects_corrupted_ring(void) {
+  gpr_log(GPR_INFO, "test_rejects_corrupted_ring");
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  void* segment = send_segment(sv[0], /*seal=*/true);
+  handshake_state server;
+  accept_handshake(sv[1], &server);
+  GPR_ASSERT(server.error == GRPC_ERROR_NONE);
+  char ack;
+  GPR_ASSERT(read(sv[0], &ack, 1) == 1);
+  grpc_endpoint_add_to_pollset(server.endpoint, g_pollset);
+  /* The head of ring 0, which the client writes and the server reads. */
+  *reinterpret_cast<volatile uint64_t*>(static_cast<char*>(segment) + 4096) =
+      3 * kTestRingSize;
+  grpc_slice_buffer incoming;
+  grpc_slice_buffer_init(&incoming);
+  read_state state;
+  grpc_closure read_closure;
+  GRPC_CLOSURE_INIT(&read_closure, on_read_done, &state,
+                    grpc_schedule_on_exec_ctx);
+  grpc_endpoint_read(server.endpoint, &incoming, &read_closure,
+                     /*urgent=*/false);
+  grpc_core::ExecCtx::Get()->Flush();
+  poll_until([&state]() { return state.done; });
+  GPR_ASSERT(state.done);
+  GPR_ASSERT(state.error != GRPC_ERROR_NONE);
+  GPR_ASSERT(incoming.length == 0);
+  GRPC_ERROR_UNREF(state.error);
+  grpc_slice_buffer_destroy(&incoming);
+  grpc_endpoint_destroy(server.endpoint);
+  munmap(segment, kTestSegmentSize);
+  close(sv[0]);
+}
+
+/* A client that does not offer shared memory, such as a plain HTTP/2
+   client, is let through with its bytes still on the socket. */
+static void test_plain_peer_left_untouched(void) {
+  gpr_log(GPR_INFO, "test_plain_peer_left_untouched");
+  grpc_core::ExecCtx exec_ctx;
+  int sv[2];
+  GPR_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  static const char kPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+  GPR_ASSERT(write(sv[0], kPreface, sizeof(kPreface) - 1) ==
+             static_cast<ssize_t>(sizeof(kPreface) - 1));
+  handshake_state server;
+  accept_handshake(dup(sv[1]), &server);
+  GPR_ASSERT(server.error == GRPC_ERROR_NONE);
+  GPR_ASSERT(server.endpoint == nullptr);
+  char buf[sizeof(kPreface)];
+  GPR_ASSERT(read(sv[1], buf, sizeof(buf)) ==
+             static_cast<ssize_t>(sizeof(kPreface) - 1));
+  GPR_ASSERT(memcmp(buf, kPreface, sizeof(kPreface) - 1) == 0);
+  close(sv[0]);
+  close(sv[1]);
+}
+
+static void destroy_pollset(void* p, grpc_error_handle /*error*/) {
+  grpc_pollset_destroy(static_cast<grpc_pollset*>(p));
+}
+
+int main(int argc, char** argv) {
+  grpc_closure destroyed;
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  {
+    grpc_core::ExecCtx exec_ctx;
+    g_pollset = static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+    grpc_pollset_init(g_pollset, &g_mu);
+    for (const grpc_endpoint_test_config& config : configs) {
+      grpc_endpoint_tests(config, g_pollset, g_mu);
+    }
+    test_peer_destroyed();
+    test_rejects_unsealed_segment();
+    test_rejects_corrupted_ring();
+    test_rejects_non_eventfd_doorbell();
+    test_makes_doorbells_nonblocking();
+    test_plain_peer_left_untouched();
+    GRPC_CLOSURE_INIT(&destroyed, destroy_pollset, g_pollset,
+                      grpc_schedule_on_exec_ctx);
+    grpc_pollset_shutdown(g_pollset, &destroyed);
+  }
+  grpc_shutdown();
+  gpr_free(g_pollset);
+
+  return 0;
+}
+
+#else /* GRPC_LINUX_SHM_ENDPOINT */
+
+int main(int /*argc*/, char** /*argv*/) { return 0; }
+
+#endif /* GRPC_LINUX_SHM_ENDPOINT */
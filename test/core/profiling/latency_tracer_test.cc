@@ -0,0 +1,194 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/profiling/timers.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class LatencyTracerTest : public ::testing::Test {
+ protected:
+  void TearDown() override { LatencyTracer::Disable(); }
+
+  // Returns the events of the dump, checking that it is valid JSON.
+  static Json::Array DumpEvents() {
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    Json json = Json::Parse(LatencyTracer::DumpChromeTrace(), &error);
+    EXPECT_EQ(error, GRPC_ERROR_NONE) << grpc_error_std_string(error);
+    GRPC_ERROR_UNREF(error);
+    if (json.type() != Json::Type::OBJECT) return Json::Array();
+    return json.object_value().at("traceEvents").array_value();
+  }
+
+  // Counts the events named \a name of phase \a phase.
+  static int Count(const Json::Array& events, const std::string& name,
+                   const std::string& phase) {
+    int count = 0;
+    for (const Json& event : events) {
+      const Json::Object& object = event.object_value();
+      if (object.at("name").string_value() == name &&
+          object.at("ph").string_value() == phase) {
+        ++count;
+      }
+    }
+    return count;
+  }
+};
+
+TEST_F(LatencyTracerTest, DisabledRecordsNothing) {
+  LatencyTracer::Reset();
+  {
+    GPR_TIMER_SCOPE("scope", 0);
+    GPR_TIMER_MARK("mark", 0);
+  }
+  Json::Array events = DumpEvents();
+  EXPECT_EQ(Count(events, "scope", "B"), 0);
+  EXPECT_EQ(Count(events, "mark", "i"), 0);
+}
+
+TEST_F(LatencyTracerTest, RecordsScopesAndMarks) {
+  LatencyTracer::Enable(1);
+  {
+    GPR_TIMER_SCOPE("scope", 1);
+    GPR_TIMER_MARK("mark", 0);
+  }
+  LatencyTracer::Disable();
+  Json::Array events = DumpEvents();
+  EXPECT_EQ(Count(events, "scope", "B"), 1);
+  EXPECT_EQ(Count(events, "scope", "E"), 1);
+  EXPECT_EQ(Count(events, "mark", "i"), 1);
+  for (const Json& event : events) {
+    const Json::Object& object = event.object_value();
+    if (object.at("name").string_value() != "scope") continue;
+    if (object.at("ph").string_value() != "B") continue;
+    const Json::Object& args = object.at("args").object_value();
+    EXPECT_EQ(args.at("file").string_value(), __FILE__);
+    EXPECT_EQ(args.at("important").type(), Json::Type::JSON_TRUE);
+  }
+}
+
+TEST_F(LatencyTracerTest, LinksClosuresToWhereTheyWereScheduled) {
+  LatencyTracer::Enable(1);
+  {
+    ExecCtx exec_ctx;
+    ExecCtx::Run(DEBUG_LOCATION,
+                 GRPC_CLOSURE_CREATE([](void*, grpc_error_handle) {}, nullptr,
+                                     nullptr),
+                 GRPC_ERROR_NONE);
+  }
+  LatencyTracer::Disable();
+  Json::Array events = DumpEvents();
+  EXPECT_EQ(Count(events, "closure", "s"), 1);
+  EXPECT_EQ(Count(events, "closure", "f"), 1);
+  EXPECT_EQ(Count(events, "closure", "B"), 1);
+  EXPECT_EQ(Count(events, "closure", "E"), 1);
+}
+
+TEST_F(LatencyTracerTest, KeepsTheMostRecentEvents) {
+  LatencyTracer::Enable(1);
+  // Run on a thread of its own, for a ring of its own.
+  std::thread([]() {
+    GPR_TIMER_SCOPE("outer", 0);
+    for (size_t i = 0; i < LatencyTracer::kEventsPerThread + 100; ++i) {
+      GPR_TIMER_MARK("overflow", 0);
+    }
+  }).join();
+  LatencyTracer::Disable();
+  Json::Array events = DumpEvents();
+  // The ring dropped the begin of the outer scope: its end is dropped too.
+  EXPECT_EQ(Count(events, "outer", "B"), 0);
+  EXPECT_EQ(Count(events, "outer", "E"), 0);
+  EXPECT_EQ(Count(events, "overflow", "i"),
+            static_cast<int>(LatencyTracer::kEventsPerThread) - 1);
+}
+
+TEST_F(LatencyTracerTest, SamplesTopLevelExecCtxs) {
+  LatencyTracer::Enable(4);
+  std::thread([]() {
+    GPR_TIMER_MARK("outside", 0);
+    for (int i = 0; i < 100; ++i) {
+      ExecCtx exec_ctx;
+      GPR_TIMER_MARK("sampled", 0);
+      ExecCtx nested;
+      GPR_TIMER_MARK("nested", 0);
+    }
+  }).join();
+  LatencyTracer::Disable();
+  Json::Array events = DumpEvents();
+  EXPECT_EQ(Count(events, "outside", "i"), 0);
+  EXPECT_EQ(Count(events, "sampled", "i"), 25);
+  EXPECT_EQ(Count(events, "nested", "i"), 25);
+}
+
+#ifdef GPR_POSIX_SYNC
+TEST_F(LatencyTracerTest, ReusesTheRingsOfExitedThreads) {
+  LatencyTracer::Enable(1);
+  const size_t kThreads = LatencyTracer::kMaxThreads + 10;
+  for (size_t i = 0; i < kThreads; ++i) {
+    std::thread([]() { GPR_TIMER_MARK("short_lived", 0); }).join();
+  }
+  LatencyTracer::Disable();
+  EXPECT_EQ(Count(DumpEvents(), "short_lived", "i"),
+            static_cast<int>(kThreads));
+}
+#endif
+
+TEST_F(LatencyTracerTest, DumpsWhileRecording) {
+  LatencyTracer::Enable(1);
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&done]() {
+      while (!done.load(std::memory_order_relaxed)) {
+        GPR_TIMER_SCOPE("busy", 0);
+      }
+    });
+  }
+  for (int i = 0; i < 2; ++i) {
+    Json::Array events = DumpEvents();
+    // Every end is preceded by its begin.
+    EXPECT_LE(Count(events, "busy", "E"), Count(events, "busy", "B"));
+  }
+  done.store(true, std::memory_order_relaxed);
+  for (std::thread& thread : threads) thread.join();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -20,6 +20,8 @@
 
 #include <string.h>
 
+#include <string>
+
 #include <grpc/grpc.h>
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
@@ -619,6 +621,186 @@ static void test_jwt_verifier_bad_format(void) {
   grpc_httpcli_set_override(nullptr, nullptr);
 }
 
+static int g_jwk_set_fetches = 0;
+
+static int httpcli_get_jwk_set_no_store(const grpc_httpcli_request* request,
+                                        grpc_millis deadline,
+                                        grpc_closure* on_done,
+                                        grpc_httpcli_response* response) {
+  g_jwk_set_fetches++;
+  httpcli_get_jwk_set(request, deadline, on_done, response);
+  response->hdr_count = 1;
+  response->hdrs =
+      static_cast<grpc_http_header*>(gpr_malloc(sizeof(grpc_http_header)));
+  response->hdrs[0].key = gpr_strdup("Cache-Control");
+  response->hdrs[0].value = gpr_strdup("private, no-store");
+  return 1;
+}
+
+static void test_jwt_verifier_caches_keys(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_jwt_verifier* verifier = grpc_jwt_verifier_create(nullptr, 0);
+  char* jwt = nullptr;
+  char* key_str = json_key_str(json_key_str_part3_for_url_issuer);
+  grpc_auth_json_key key = grpc_auth_json_key_create_from_string(key_str);
+  gpr_free(key_str);
+  GPR_ASSERT(grpc_auth_json_key_is_valid(&key));
+  jwt = grpc_jwt_encode_and_sign(&key, expected_audience, expected_lifetime,
+                                 nullptr);
+  grpc_auth_json_key_destruct(&key);
+  GPR_ASSERT(jwt != nullptr);
+  grpc_httpcli_set_override(httpcli_get_openid_config,
+                            httpcli_post_should_not_be_called);
+  grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                           on_verification_success,
+                           const_cast<char*>(expected_user_data));
+  grpc_core::ExecCtx::Get()->Flush();
+  /* Both the jwks_uri and the keys are now cached. */
+  grpc_httpcli_set_override(httpcli_get_should_not_be_called,
+                            httpcli_post_should_not_be_called);
+  grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                           on_verification_success,
+                           const_cast<char*>(expected_user_data));
+  grpc_jwt_verifier_destroy(verifier);
+  grpc_core::ExecCtx::Get()->Flush();
+  gpr_free(jwt);
+  grpc_httpcli_set_override(nullptr, nullptr);
+}
+
+static int httpcli_get_openid_config_no_store_keys(
+    const grpc_httpcli_request* request, grpc_millis deadline,
+    grpc_closure* on_done, grpc_httpcli_response* response) {
+  httpcli_get_openid_config(request, deadline, on_done, response);
+  grpc_httpcli_set_override(httpcli_get_jwk_set_no_store,
+                            httpcli_post_should_not_be_called);
+  return 1;
+}
+
+static void test_jwt_verifier_honors_no_store(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_jwt_verifier* verifier = grpc_jwt_verifier_create(nullptr, 0);
+  char* jwt = nullptr;
+  char* key_str = json_key_str(json_key_str_part3_for_url_issuer);
+  grpc_auth_json_key key = grpc_auth_json_key_create_from_string(key_str);
+  gpr_free(key_str);
+  GPR_ASSERT(grpc_auth_json_key_is_valid(&key));
+  jwt = grpc_jwt_encode_and_sign(&key, expected_audience, expected_lifetime,
+                                 nullptr);
+  grpc_auth_json_key_destruct(&key);
+  GPR_ASSERT(jwt != nullptr);
+  g_jwk_set_fetches = 0;
+  grpc_httpcli_set_override(httpcli_get_openid_config_no_store_keys,
+                            httpcli_post_should_not_be_called);
+  /* The jwks_uri gets cached but the keys are fetched every time. */
+  for (int i = 0; i < 2; i++) {
+    grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                             on_verification_success,
+                             const_cast<char*>(expected_user_data));
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+  GPR_ASSERT(g_jwk_set_fetches == 2);
+  grpc_jwt_verifier_destroy(verifier);
+  gpr_free(jwt);
+  grpc_httpcli_set_override(nullptr, nullptr);
+}
+
+/* The good key set, with the key under another kid, as if the issuer had
+   not published the key of the JWT yet. */
+static char* stale_jwk_set() {
+  std::string jwk_set = good_jwk_set;
+  const std::string kid = "e6b5137873db8d2ef81e06a47289e6434ec8a165";
+  jwk_set.replace(jwk_set.find(kid), kid.size(), "some-older-key");
+  return gpr_strdup(jwk_set.c_str());
+}
+
+static int httpcli_get_stale_jwk_set(const grpc_httpcli_request* request,
+                                     grpc_millis deadline,
+                                     grpc_closure* on_done,
+                                     grpc_httpcli_response* response) {
+  g_jwk_set_fetches++;
+  httpcli_get_jwk_set(request, deadline, on_done, response);
+  gpr_free(response->body);
+  response->body = stale_jwk_set();
+  response->body_length = strlen(response->body);
+  return 1;
+}
+
+static int httpcli_get_openid_config_stale_keys(
+    const grpc_httpcli_request* request, grpc_millis deadline,
+    grpc_closure* on_done, grpc_httpcli_response* response) {
+  httpcli_get_openid_config(request, deadline, on_done, response);
+  grpc_httpcli_set_override(httpcli_get_stale_jwk_set,
+                            httpcli_post_should_not_be_called);
+  return 1;
+}
+
+static void test_jwt_verifier_refetches_keys_on_kid_miss(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_jwt_verifier* verifier = grpc_jwt_verifier_create(nullptr, 0);
+  char* jwt = nullptr;
+  char* key_str = json_key_str(json_key_str_part3_for_url_issuer);
+  grpc_auth_json_key key = grpc_auth_json_key_create_from_string(key_str);
+  gpr_free(key_str);
+  GPR_ASSERT(grpc_auth_json_key_is_valid(&key));
+  jwt = grpc_jwt_encode_and_sign(&key, expected_audience, expected_lifetime,
+                                 nullptr);
+  grpc_auth_json_key_destruct(&key);
+  GPR_ASSERT(jwt != nullptr);
+  g_jwk_set_fetches = 0;
+  grpc_httpcli_set_override(httpcli_get_openid_config_stale_keys,
+                            httpcli_post_should_not_be_called);
+  grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                           on_verification_key_retrieval_error,
+                           const_cast<char*>(expected_user_data));
+  grpc_core::ExecCtx::Get()->Flush();
+  GPR_ASSERT(g_jwk_set_fetches == 1);
+  /* The cached keys lack the kid of the JWT: they get refetched once, and
+     then not again within the refetch interval. */
+  for (int i = 0; i < 2; i++) {
+    grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                             on_verification_key_retrieval_error,
+                             const_cast<char*>(expected_user_data));
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+  GPR_ASSERT(g_jwk_set_fetches == 2);
+  /* Once the issuer publishes the key, the next refetch picks it up. */
+  grpc_millis saved_interval = grpc_jwt_verifier_key_miss_refetch_interval;
+  grpc_jwt_verifier_key_miss_refetch_interval = 0;
+  grpc_httpcli_set_override(httpcli_get_jwk_set,
+                            httpcli_post_should_not_be_called);
+  grpc_jwt_verifier_verify(verifier, nullptr, jwt, expected_audience,
+                           on_verification_success,
+                           const_cast<char*>(expected_user_data));
+  grpc_core::ExecCtx::Get()->Flush();
+  grpc_jwt_verifier_key_miss_refetch_interval = saved_interval;
+  grpc_jwt_verifier_destroy(verifier);
+  gpr_free(jwt);
+  grpc_httpcli_set_override(nullptr, nullptr);
+}
+
+static void test_jwt_cache_ttl_from_http_response(void) {
+  grpc_http_header header = {const_cast<char*>("cache-control"), nullptr};
+  grpc_http_response response;
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) ==
+             grpc_jwt_verifier_key_cache_default_ttl);
+  response.hdr_count = 1;
+  response.hdrs = &header;
+  header.value = const_cast<char*>("public, max-age=3600, must-revalidate");
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) ==
+             3600 * GPR_MS_PER_SEC);
+  header.value = const_cast<char*>("max-age=31536000");
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) ==
+             grpc_jwt_verifier_key_cache_max_ttl);
+  header.value = const_cast<char*>("max-age=9223372036854775807");
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) ==
+             grpc_jwt_verifier_key_cache_max_ttl);
+  header.value = const_cast<char*>("max-age=abc");
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) ==
+             grpc_jwt_verifier_key_cache_default_ttl);
+  header.value = const_cast<char*>("No-Cache");
+  GPR_ASSERT(grpc_jwt_cache_ttl_from_http_response(&response) == 0);
+}
+
 /* find verification key: bad jks, cannot find key in jks */
 /* bad signature custom provided email*/
 /* bad key */
@@ -639,6 +821,10 @@ int main(int argc, char** argv) {
   test_jwt_verifier_bad_json_key();
   test_jwt_verifier_bad_signature();
   test_jwt_verifier_bad_format();
+  test_jwt_verifier_caches_keys();
+  test_jwt_verifier_honors_no_store();
+  test_jwt_verifier_refetches_keys_on_kid_miss();
+  test_jwt_cache_ttl_from_http_response();
   grpc_shutdown();
   return 0;
 }
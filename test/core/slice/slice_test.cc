@@ -329,6 +329,46 @@ static void test_moved_string_slice(void) {
   grpc_shutdown();
 }
 
+static void test_slice_headroom(void) {
+  LOG_TEST_NAME("test_slice_headroom");
+
+  grpc_slice slice = grpc_slice_malloc_with_headroom(100, 16);
+  GPR_ASSERT(GRPC_SLICE_LENGTH(slice) == 100);
+  GPR_ASSERT(grpc_core::SliceHeadroom(slice) == 16);
+  memset(GRPC_SLICE_START_PTR(slice), 'x', 100);
+
+  // A slice further into the allocation has no headroom.
+  grpc_slice sub = grpc_slice_sub(slice, 1, 100);
+  grpc_slice grown;
+  GPR_ASSERT(grpc_core::SliceHeadroom(sub) == 0);
+  GPR_ASSERT(!grpc_core::ClaimSliceHeadroom(sub, 1, &grown));
+  grpc_slice_unref(sub);
+
+  GPR_ASSERT(!grpc_core::ClaimSliceHeadroom(slice, 17, &grown));
+  GPR_ASSERT(grpc_core::ClaimSliceHeadroom(slice, 5, &grown));
+  GPR_ASSERT(GRPC_SLICE_LENGTH(grown) == 105);
+  GPR_ASSERT(GRPC_SLICE_START_PTR(grown) + 5 == GRPC_SLICE_START_PTR(slice));
+  // The headroom was claimed once: holders of the original slice lost it.
+  GPR_ASSERT(grpc_core::SliceHeadroom(slice) == 0);
+  GPR_ASSERT(!grpc_core::ClaimSliceHeadroom(slice, 5, &sub));
+  grpc_slice_unref(slice);
+
+  // The rest of the headroom goes to the grown slice.
+  GPR_ASSERT(grpc_core::SliceHeadroom(grown) == 11);
+  grpc_slice twice_grown;
+  GPR_ASSERT(grpc_core::ClaimSliceHeadroom(grown, 11, &twice_grown));
+  GPR_ASSERT(GRPC_SLICE_LENGTH(twice_grown) == 116);
+  GPR_ASSERT(grpc_core::SliceHeadroom(twice_grown) == 0);
+  grpc_slice_unref(grown);
+  grpc_slice_unref(twice_grown);
+
+  // Other slices have no headroom.
+  slice = grpc_slice_malloc(100);
+  GPR_ASSERT(grpc_core::SliceHeadroom(slice) == 0);
+  GPR_ASSERT(!grpc_core::ClaimSliceHeadroom(slice, 1, &grown));
+  grpc_slice_unref(slice);
+}
+
 void test_string_view_from_slice() {
   constexpr char kStr[] = "foo";
   absl::string_view sv(
@@ -354,6 +394,7 @@ int main(int argc, char** argv) {
   test_static_slice_interning();
   test_static_slice_copy_interning();
   test_moved_string_slice();
+  test_slice_headroom();
   test_string_view_from_slice();
   grpc_shutdown();
   return 0;
@@ -28,6 +28,7 @@
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
 #include "src/core/lib/iomgr/port.h"
 #include "src/core/lib/transport/transport.h"
+#include "src/core/lib/transport/write_latency.h"
 #include "test/core/util/mock_endpoint.h"
 #include "test/core/util/test_config.h"
 
@@ -164,6 +165,147 @@ TEST_F(ContextListTest, NonEmptyListEmptyTimestamp) {
   exec_ctx.Flush();
 }
 
+class RecordingObserver : public WriteLatencyObserver {
+ public:
+  void OnWriteLatency(const WriteLatency& latency) override {
+    latencies.push_back(latency);
+  }
+
+  std::vector<WriteLatency> latencies;
+};
+
+gpr_timespec AtMicros(int64_t micros) {
+  return gpr_time_add(gpr_time_0(GPR_CLOCK_REALTIME),
+                      gpr_time_from_micros(micros, GPR_TIMESPAN));
+}
+
+/** Tests that the writes of sampled streams are broken down into stages, and
+ * that the breakdown reaches the stream's observer and the stats.
+ */
+TEST_F(ContextListTest, SampledStreamsReportWriteLatency) {
+  WriteLatencyStats::Reset();
+  grpc_core::ContextList* list = nullptr;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_stream_refcount ref;
+  GRPC_STREAM_REF_INIT(&ref, 1, nullptr, nullptr, "phony ref");
+  grpc_resource_quota* resource_quota =
+      grpc_resource_quota_create("context_list_test");
+  grpc_endpoint* mock_endpoint = grpc_mock_endpoint_create(
+      discard_write,
+      grpc_slice_allocator_create(resource_quota, "mock_endpoint"));
+  grpc_transport* t = grpc_create_chttp2_transport(
+      nullptr, mock_endpoint, true,
+      grpc_resource_user_create(resource_quota, "mock_transport"));
+  grpc_resource_quota_unref(resource_quota);
+  grpc_chttp2_stream* s = static_cast<grpc_chttp2_stream*>(
+      gpr_malloc(grpc_transport_stream_size(t)));
+  grpc_transport_init_stream(reinterpret_cast<grpc_transport*>(t),
+                             reinterpret_cast<grpc_stream*>(s), &ref, nullptr,
+                             nullptr);
+  gpr_atm verifier_called;
+  gpr_atm_rel_store(&verifier_called, static_cast<gpr_atm>(0));
+  auto observer = MakeRefCounted<RecordingObserver>();
+  s->context = &verifier_called;
+  s->byte_counter = kByteOffset;
+  s->write_timestamps_sampled = true;
+  s->last_write_done_time = AtMicros(0);
+  s->write_queued_time = AtMicros(10);
+  s->write_latency_observer = observer;
+  grpc_core::ContextList::Append(&list, s);
+  // The next write of the stream gets its own queueing time.
+  EXPECT_EQ(gpr_time_cmp(s->write_queued_time,
+                         gpr_inf_past(GPR_CLOCK_REALTIME)),
+            0);
+  grpc_core::Timestamps ts;
+  ts.sendmsg_time.time = AtMicros(30);
+  ts.scheduled_time.time = AtMicros(60);
+  ts.sent_time.time = AtMicros(100);
+  ts.acked_time.time = AtMicros(150);
+  grpc_core::ContextList::Execute(list, &ts, GRPC_ERROR_NONE);
+  EXPECT_EQ(gpr_atm_acq_load(&verifier_called), static_cast<gpr_atm>(1));
+  ASSERT_EQ(observer->latencies.size(), 1);
+  const WriteLatency& latency = observer->latencies[0];
+  EXPECT_EQ(latency.stage_ns[WriteLatency::kApp], 10 * GPR_NS_PER_US);
+  EXPECT_EQ(latency.stage_ns[WriteLatency::kWriteQueue], 20 * GPR_NS_PER_US);
+  EXPECT_EQ(latency.stage_ns[WriteLatency::kKernel], 30 * GPR_NS_PER_US);
+  EXPECT_EQ(latency.stage_ns[WriteLatency::kQdisc], 40 * GPR_NS_PER_US);
+  EXPECT_EQ(latency.stage_ns[WriteLatency::kNetwork], 50 * GPR_NS_PER_US);
+  EXPECT_EQ(latency.byte_offset, kByteOffset);
+  WriteLatencyStats::Snapshot snapshot = WriteLatencyStats::GetSnapshot();
+  for (const auto& stage : snapshot.stages) {
+    EXPECT_EQ(stage.count(), 1);
+  }
+  EXPECT_EQ(snapshot.stages[WriteLatency::kNetwork].sum(), 50 * GPR_NS_PER_US);
+  // The next write was queued before the transport was done with this one:
+  // no time was spent above the transport.
+  list = nullptr;
+  s->last_write_done_time = AtMicros(40);
+  s->write_queued_time = AtMicros(35);
+  grpc_core::ContextList::Append(&list, s);
+  ts.sendmsg_time.time = AtMicros(45);
+  grpc_core::ContextList::Execute(list, &ts, GRPC_ERROR_NONE);
+  ASSERT_EQ(observer->latencies.size(), 2);
+  EXPECT_EQ(observer->latencies[1].stage_ns[WriteLatency::kApp], 0);
+  EXPECT_EQ(observer->latencies[1].stage_ns[WriteLatency::kWriteQueue],
+            10 * GPR_NS_PER_US);
+  grpc_transport_destroy_stream(reinterpret_cast<grpc_transport*>(t),
+                                reinterpret_cast<grpc_stream*>(s), nullptr);
+  exec_ctx.Flush();
+  gpr_free(s);
+  grpc_transport_destroy(t);
+  exec_ctx.Flush();
+}
+
+/** Tests that stages whose timestamps were not reported are left out. */
+TEST_F(ContextListTest, UnreportedStagesAreSkipped) {
+  WriteLatencyStats::Reset();
+  grpc_core::ContextList* list = nullptr;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_stream_refcount ref;
+  GRPC_STREAM_REF_INIT(&ref, 1, nullptr, nullptr, "phony ref");
+  grpc_resource_quota* resource_quota =
+      grpc_resource_quota_create("context_list_test");
+  grpc_endpoint* mock_endpoint = grpc_mock_endpoint_create(
+      discard_write,
+      grpc_slice_allocator_create(resource_quota, "mock_endpoint"));
+  grpc_transport* t = grpc_create_chttp2_transport(
+      nullptr, mock_endpoint, true,
+      grpc_resource_user_create(resource_quota, "mock_transport"));
+  grpc_resource_quota_unref(resource_quota);
+  grpc_chttp2_stream* s = static_cast<grpc_chttp2_stream*>(
+      gpr_malloc(grpc_transport_stream_size(t)));
+  grpc_transport_init_stream(reinterpret_cast<grpc_transport*>(t),
+                             reinterpret_cast<grpc_stream*>(s), &ref, nullptr,
+                             nullptr);
+  gpr_atm verifier_called;
+  gpr_atm_rel_store(&verifier_called, static_cast<gpr_atm>(0));
+  s->context = &verifier_called;
+  s->byte_counter = kByteOffset;
+  s->write_timestamps_sampled = true;
+  s->last_write_done_time = AtMicros(0);
+  s->write_queued_time = AtMicros(10);
+  grpc_core::ContextList::Append(&list, s);
+  // The connection closed before the write was sent.
+  grpc_core::Timestamps ts;
+  ts.sendmsg_time.time = AtMicros(30);
+  ts.scheduled_time.time = gpr_inf_past(GPR_CLOCK_REALTIME);
+  ts.sent_time.time = gpr_inf_past(GPR_CLOCK_REALTIME);
+  ts.acked_time.time = gpr_inf_past(GPR_CLOCK_REALTIME);
+  grpc_core::ContextList::Execute(list, &ts, GRPC_ERROR_NONE);
+  WriteLatencyStats::Snapshot snapshot = WriteLatencyStats::GetSnapshot();
+  EXPECT_EQ(snapshot.stages[WriteLatency::kApp].count(), 1);
+  EXPECT_EQ(snapshot.stages[WriteLatency::kWriteQueue].count(), 1);
+  EXPECT_EQ(snapshot.stages[WriteLatency::kKernel].count(), 0);
+  EXPECT_EQ(snapshot.stages[WriteLatency::kQdisc].count(), 0);
+  EXPECT_EQ(snapshot.stages[WriteLatency::kNetwork].count(), 0);
+  grpc_transport_destroy_stream(reinterpret_cast<grpc_transport*>(t),
+                                reinterpret_cast<grpc_stream*>(s), nullptr);
+  exec_ctx.Flush();
+  gpr_free(s);
+  grpc_transport_destroy(t);
+  exec_ctx.Flush();
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace grpc_core
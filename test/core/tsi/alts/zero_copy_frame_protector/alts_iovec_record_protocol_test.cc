@@ -21,6 +21,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/gpr/useful.h"
 #include "test/core/tsi/alts/crypt/gsec_test_util.h"
 
 constexpr size_t kMaxDataSize = 1024;
@@ -448,6 +449,49 @@ static void privacy_integrity_random_seal_unseal(
   }
 }
 
+static void privacy_integrity_multi_frame_seal_unseal(
+    alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
+  for (size_t i = 0; i < kSealRepeatTimes; i++) {
+    alts_iovec_record_protocol_test_var* var =
+        alts_iovec_record_protocol_test_var_create();
+    size_t max_frame_data_length =
+        gsec_test_bias_random_uint32(static_cast<uint32_t>(var->data_length)) +
+        1;
+    size_t num_frames = (var->data_length + max_frame_data_length - 1) /
+                        max_frame_data_length;
+    size_t frame_overhead = var->header_length + var->tag_length;
+    size_t protected_length = var->data_length + num_frames * frame_overhead;
+    auto* protected_buf = static_cast<uint8_t*>(gpr_malloc(protected_length));
+    iovec_t protected_iovec = {protected_buf, protected_length};
+    /* Seals all frames at once and then unseals them one by one.  */
+    grpc_status_code status =
+        alts_iovec_record_protocol_privacy_integrity_protect_frames(
+            sender, var->data_iovec, var->data_iovec_length,
+            max_frame_data_length, protected_iovec, nullptr);
+    GPR_ASSERT(status == GRPC_STATUS_OK);
+    uint8_t* frame = protected_buf;
+    size_t offset = 0;
+    while (offset < var->data_length) {
+      size_t frame_data_length =
+          GPR_MIN(max_frame_data_length, var->data_length - offset);
+      iovec_t header_iovec = {frame, var->header_length};
+      iovec_t frame_iovec = {frame + var->header_length,
+                             frame_data_length + var->tag_length};
+      iovec_t unprotected_iovec = {var->data_buf + offset, frame_data_length};
+      status = alts_iovec_record_protocol_privacy_integrity_unprotect(
+          receiver, header_iovec, &frame_iovec, 1, unprotected_iovec, nullptr);
+      GPR_ASSERT(status == GRPC_STATUS_OK);
+      frame += frame_overhead + frame_data_length;
+      offset += frame_data_length;
+    }
+    GPR_ASSERT(frame == protected_buf + protected_length);
+    /* Makes sure unprotected data are the same as the original.  */
+    GPR_ASSERT(memcmp(var->data_buf, var->dup_buf, var->data_length) == 0);
+    gpr_free(protected_buf);
+    alts_iovec_record_protocol_test_var_destroy(var);
+  }
+}
+
 static void privacy_integrity_empty_seal_unseal(
     alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
   alts_iovec_record_protocol_test_var* var =
@@ -766,6 +810,25 @@ static void alts_iovec_record_protocol_random_seal_unseal_tests() {
   alts_iovec_record_protocol_test_fixture_destroy(fixture);
 }
 
+static void alts_iovec_record_protocol_multi_frame_seal_unseal_tests() {
+  alts_iovec_record_protocol_test_fixture* fixture =
+      alts_iovec_record_protocol_test_fixture_create(
+          /*rekey=*/false, /*integrity_only=*/false);
+  privacy_integrity_multi_frame_seal_unseal(fixture->client_protect,
+                                            fixture->server_unprotect);
+  privacy_integrity_multi_frame_seal_unseal(fixture->server_protect,
+                                            fixture->client_unprotect);
+  alts_iovec_record_protocol_test_fixture_destroy(fixture);
+
+  fixture = alts_iovec_record_protocol_test_fixture_create(
+      /*rekey=*/true, /*integrity_only=*/false);
+  privacy_integrity_multi_frame_seal_unseal(fixture->client_protect,
+                                            fixture->server_unprotect);
+  privacy_integrity_multi_frame_seal_unseal(fixture->server_protect,
+                                            fixture->client_unprotect);
+  alts_iovec_record_protocol_test_fixture_destroy(fixture);
+}
+
 static void alts_iovec_record_protocol_empty_seal_unseal_tests() {
   alts_iovec_record_protocol_test_fixture* fixture =
       alts_iovec_record_protocol_test_fixture_create(
@@ -920,6 +983,7 @@ static void alts_iovec_record_protocol_mix_operations_tests() {
 
 int main(int /*argc*/, char** /*argv*/) {
   alts_iovec_record_protocol_random_seal_unseal_tests();
+  alts_iovec_record_protocol_multi_frame_seal_unseal_tests();
   alts_iovec_record_protocol_empty_seal_unseal_tests();
   alts_iovec_record_protocol_unsync_seal_unseal_tests();
   alts_iovec_record_protocol_corrupted_data_tests();
@@ -92,9 +92,10 @@ TEST_F(ProtoUtilsTest, TinyBackupThenNext) {
 namespace {
 
 // Set backup_size to 0 to indicate no backup is needed.
-void BufferWriterTest(int block_size, int total_size, int backup_size) {
+void BufferWriterTest(int block_size, int total_size, int backup_size,
+                      bool framed = false) {
   ByteBuffer bb;
-  ProtoBufferWriter writer(&bb, block_size, total_size);
+  ProtoBufferWriter writer(&bb, block_size, total_size, framed);
 
   int written_size = 0;
   void* data;
@@ -185,6 +186,28 @@ TEST_F(WriterTest, LargeBlockLargeBackup) {
   BufferWriterTest(4096, 8192, 4095);
 }
 
+TEST_F(WriterTest, FramedBlockNoBackup) {
+  BufferWriterTest(4096, 8192, 0, true);
+}
+
+TEST_F(WriterTest, FramedBlockTinyBackup) {
+  BufferWriterTest(4096, 8192, 1, true);
+}
+
+TEST_F(WriterTest, FramedBlockSizes) {
+  ByteBuffer bb;
+  ProtoBufferWriter writer(&bb, 4096, 10000, /*framed=*/true);
+  void* data;
+  int size;
+  // The first block leaves room for the message prefix.
+  ASSERT_TRUE(writer.Next(&data, &size));
+  EXPECT_EQ(4096 - 5, size);
+  ASSERT_TRUE(writer.Next(&data, &size));
+  EXPECT_EQ(4096, size);
+  ASSERT_TRUE(writer.Next(&data, &size));
+  EXPECT_EQ(10000 - 4096 * 2 + 5, size);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace grpc
@@ -0,0 +1,166 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+// Holds the handlers of Echo until Release().
+class BlockingEchoService : public EchoTestService::Service {
+ public:
+  Status Echo(ServerContext* /*context*/, const EchoRequest* request,
+              EchoResponse* response) override {
+    grpc_core::MutexLock lock(&mu_);
+    ++handlers_;
+    while (!released_) cv_.Wait(&mu_);
+    response->set_message(request->message());
+    return Status::OK;
+  }
+
+  Status BidiStream(
+      ServerContext* /*context*/,
+      ServerReaderWriter<EchoResponse, EchoRequest>* stream) override {
+    EchoRequest request;
+    EchoResponse response;
+    while (stream->Read(&request)) {
+      response.set_message(request.message());
+      stream->Write(response);
+    }
+    return Status::OK;
+  }
+
+  void WaitForHandlers(int count) {
+    grpc_core::MutexLock lock(&mu_);
+    while (handlers_ < count) {
+      cv_.WaitWithTimeout(&mu_, absl::Milliseconds(1));
+    }
+  }
+
+  void Release() {
+    grpc_core::MutexLock lock(&mu_);
+    released_ = true;
+    cv_.SignalAll();
+  }
+
+ private:
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar cv_;
+  int handlers_ ABSL_GUARDED_BY(mu_) = 0;
+  bool released_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+class AdaptiveConcurrencyEnd2endTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int port = 0;
+    ServerBuilder builder;
+    builder.AddListeningPort("localhost:0", InsecureServerCredentials(),
+                             &port);
+    builder.RegisterService(&service_);
+    // A single call at a time.
+    builder.experimental().EnableAdaptiveConcurrency(1, 1, 1);
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    stub_ = EchoTestService::NewStub(
+        CreateChannel("localhost:" + std::to_string(port),
+                      InsecureChannelCredentials()));
+  }
+
+  void TearDown() override {
+    service_.Release();
+    server_->Shutdown();
+  }
+
+  Status Echo(const std::string& message) {
+    ClientContext context;
+    EchoRequest request;
+    EchoResponse response;
+    request.set_message(message);
+    Status status = stub_->Echo(&context, request, &response);
+    if (status.ok()) EXPECT_EQ(response.message(), message);
+    return status;
+  }
+
+  BlockingEchoService service_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+TEST_F(AdaptiveConcurrencyEnd2endTest, RejectedCallsGetResourceExhausted) {
+  Status held_status;
+  std::thread held([&]() { held_status = Echo("held"); });
+  service_.WaitForHandlers(1);
+  for (int i = 0; i < 20; ++i) {
+    Status status = Echo("rejected");
+    EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+    EXPECT_EQ(status.error_message(), "Server concurrency limit reached");
+  }
+  service_.Release();
+  held.join();
+  EXPECT_TRUE(held_status.ok()) << held_status.error_message();
+  // The held call released its slot.
+  Status status = Echo("admitted");
+  EXPECT_TRUE(status.ok()) << status.error_message();
+}
+
+TEST_F(AdaptiveConcurrencyEnd2endTest, RejectedStreamsGetResourceExhausted) {
+  Status held_status;
+  std::thread held([&]() { held_status = Echo("held"); });
+  service_.WaitForHandlers(1);
+  ClientContext context;
+  auto stream = stub_->BidiStream(&context);
+  EchoRequest request;
+  request.set_message("rejected");
+  // The write may or may not make it before the stream fails.
+  stream->Write(request);
+  stream->WritesDone();
+  EchoResponse response;
+  EXPECT_FALSE(stream->Read(&response));
+  Status status = stream->Finish();
+  EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+  service_.Release();
+  held.join();
+  EXPECT_TRUE(held_status.ok()) << held_status.error_message();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
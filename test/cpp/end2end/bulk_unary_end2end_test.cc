@@ -0,0 +1,239 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/support/time.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/bulk_unary_call.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+const char kMetadataKey[] = "bulk-key";
+
+// Echoes the message of its requests, followed by the value of kMetadataKey if
+// sent. Sleeps for server_sleep_us first, and fails with expected_error if
+// set.
+class BulkService : public EchoTestService::Service {
+ public:
+  Status Echo(ServerContext* context, const EchoRequest* request,
+              EchoResponse* response) override {
+    calls_.fetch_add(1);
+    if (request->param().server_sleep_us() > 0) {
+      gpr_sleep_until(gpr_time_add(
+          gpr_now(GPR_CLOCK_MONOTONIC),
+          gpr_time_from_micros(request->param().server_sleep_us(),
+                               GPR_TIMESPAN)));
+    }
+    if (request->param().expected_error().code() != 0) {
+      return Status(
+          static_cast<StatusCode>(request->param().expected_error().code()),
+          request->param().expected_error().error_message());
+    }
+    std::string message = request->message();
+    auto it = context->client_metadata().find(kMetadataKey);
+    if (it != context->client_metadata().end()) {
+      message.append(it->second.data(), it->second.size());
+    }
+    response->set_message(message);
+    return Status::OK;
+  }
+
+  int calls() const { return calls_.load(); }
+
+ private:
+  std::atomic<int> calls_{0};
+};
+
+class BulkUnaryEnd2endTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int port = grpc_pick_unused_port_or_die();
+    server_address_ = "localhost:" + std::to_string(port);
+    ServerBuilder builder;
+    builder.AddListeningPort(server_address_, InsecureServerCredentials());
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    channel_ = CreateChannel(server_address_, InsecureChannelCredentials());
+    stub_.reset(new experimental::BulkUnaryStub<EchoRequest, EchoResponse>(
+        channel_, "/grpc.testing.EchoTestService/Echo"));
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  // Sends \a requests in bulk with \a context, and returns their statuses once
+  // they are done.
+  std::vector<Status> SendBulk(ClientContext* context,
+                               const std::vector<EchoRequest>& requests,
+                               std::vector<EchoResponse>* responses) {
+    grpc_core::Mutex mu;
+    grpc_core::CondVar cv;
+    bool done = false;
+    std::vector<Status> statuses;
+    stub_->Call(context, requests, responses,
+                [&mu, &cv, &done, &statuses](std::vector<Status> s) {
+                  grpc_core::MutexLock lock(&mu);
+                  statuses = std::move(s);
+                  done = true;
+                  cv.Signal();
+                });
+    grpc_core::MutexLock lock(&mu);
+    while (!done) cv.Wait(&mu);
+    return statuses;
+  }
+
+  static EchoRequest MakeRequest(const std::string& message) {
+    EchoRequest request;
+    request.set_message(message);
+    return request;
+  }
+
+  std::string server_address_;
+  BulkService service_;
+  std::unique_ptr<Server> server_;
+  std::shared_ptr<Channel> channel_;
+  std::unique_ptr<experimental::BulkUnaryStub<EchoRequest, EchoResponse>>
+      stub_;
+};
+
+TEST_F(BulkUnaryEnd2endTest, ReturnsResponsesInOrder) {
+  const size_t kNumCalls = 100;
+  std::vector<EchoRequest> requests;
+  for (size_t i = 0; i < kNumCalls; i++) {
+    requests.push_back(MakeRequest("hello " + std::to_string(i)));
+  }
+  ClientContext context;
+  std::vector<EchoResponse> responses;
+  std::vector<Status> statuses = SendBulk(&context, requests, &responses);
+  ASSERT_EQ(statuses.size(), kNumCalls);
+  ASSERT_EQ(responses.size(), kNumCalls);
+  for (size_t i = 0; i < kNumCalls; i++) {
+    EXPECT_TRUE(statuses[i].ok()) << statuses[i].error_message();
+    EXPECT_EQ(responses[i].message(), requests[i].message());
+  }
+  EXPECT_EQ(service_.calls(), static_cast<int>(kNumCalls));
+}
+
+TEST_F(BulkUnaryEnd2endTest, ReportsStatusOfEachCall) {
+  std::vector<EchoRequest> requests = {MakeRequest("a"), MakeRequest("b"),
+                                       MakeRequest("c")};
+  auto* error = requests[1].mutable_param()->mutable_expected_error();
+  error->set_code(StatusCode::ABORTED);
+  error->set_error_message("aborted b");
+  ClientContext context;
+  std::vector<EchoResponse> responses;
+  std::vector<Status> statuses = SendBulk(&context, requests, &responses);
+  ASSERT_EQ(statuses.size(), 3u);
+  EXPECT_TRUE(statuses[0].ok());
+  EXPECT_EQ(responses[0].message(), "a");
+  EXPECT_EQ(statuses[1].error_code(), StatusCode::ABORTED);
+  EXPECT_EQ(statuses[1].error_message(), "aborted b");
+  EXPECT_TRUE(statuses[2].ok());
+  EXPECT_EQ(responses[2].message(), "c");
+}
+
+TEST_F(BulkUnaryEnd2endTest, SendsContextMetadataWithEachCall) {
+  std::vector<EchoRequest> requests = {MakeRequest("a"), MakeRequest("b")};
+  ClientContext context;
+  context.AddMetadata(kMetadataKey, "-value");
+  std::vector<EchoResponse> responses;
+  std::vector<Status> statuses = SendBulk(&context, requests, &responses);
+  ASSERT_EQ(statuses.size(), 2u);
+  EXPECT_TRUE(statuses[0].ok());
+  EXPECT_EQ(responses[0].message(), "a-value");
+  EXPECT_TRUE(statuses[1].ok());
+  EXPECT_EQ(responses[1].message(), "b-value");
+}
+
+TEST_F(BulkUnaryEnd2endTest, AppliesContextDeadlineToEachCall) {
+  std::vector<EchoRequest> requests = {MakeRequest("a"), MakeRequest("b")};
+  for (EchoRequest& request : requests) {
+    request.mutable_param()->set_server_sleep_us(500000 *
+                                                 grpc_test_slowdown_factor());
+  }
+  ClientContext context;
+  context.set_deadline(grpc_timeout_milliseconds_to_deadline(100));
+  std::vector<EchoResponse> responses;
+  std::vector<Status> statuses = SendBulk(&context, requests, &responses);
+  ASSERT_EQ(statuses.size(), 2u);
+  for (const Status& status : statuses) {
+    EXPECT_EQ(status.error_code(), StatusCode::DEADLINE_EXCEEDED);
+  }
+}
+
+TEST_F(BulkUnaryEnd2endTest, ContextCanGoAwayOnceCallReturns) {
+  std::vector<EchoRequest> requests = {MakeRequest("a"), MakeRequest("b")};
+  std::vector<EchoResponse> responses;
+  grpc_core::Mutex mu;
+  grpc_core::CondVar cv;
+  bool done = false;
+  std::vector<Status> statuses;
+  {
+    ClientContext context;
+    context.AddMetadata(kMetadataKey, "-value");
+    stub_->Call(&context, requests, &responses,
+                [&mu, &cv, &done, &statuses](std::vector<Status> s) {
+                  grpc_core::MutexLock lock(&mu);
+                  statuses = std::move(s);
+                  done = true;
+                  cv.Signal();
+                });
+  }
+  grpc_core::MutexLock lock(&mu);
+  while (!done) cv.Wait(&mu);
+  ASSERT_EQ(statuses.size(), 2u);
+  EXPECT_TRUE(statuses[0].ok());
+  EXPECT_EQ(responses[0].message(), "a-value");
+  EXPECT_TRUE(statuses[1].ok());
+  EXPECT_EQ(responses[1].message(), "b-value");
+}
+
+TEST_F(BulkUnaryEnd2endTest, NoRequests) {
+  ClientContext context;
+  std::vector<EchoResponse> responses;
+  std::vector<Status> statuses = SendBulk(&context, {}, &responses);
+  EXPECT_TRUE(statuses.empty());
+  EXPECT_TRUE(responses.empty());
+  EXPECT_EQ(service_.calls(), 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
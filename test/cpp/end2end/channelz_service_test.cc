@@ -209,6 +209,9 @@ class ChannelzServerTest : public ::testing::TestWithParam<CredentialsType> {
     proxy_builder.AddChannelArgument(GRPC_ARG_ENABLE_CHANNELZ, 1);
     proxy_builder.AddChannelArgument(
         GRPC_ARG_MAX_CHANNEL_TRACE_EVENT_MEMORY_PER_NODE, 1024);
+    proxy_builder.AddChannelArgument(GRPC_ARG_SERVER_METHOD_STATS, 1);
+    // A limit no test reaches, for channelz to report a limiter.
+    proxy_builder.experimental().EnableAdaptiveConcurrency(1000, 1000, 1000);
     proxy_builder.RegisterService(&proxy_service_);
     proxy_server_ = proxy_builder.BuildAndStart();
   }
@@ -881,6 +884,76 @@ TEST_P(ChannelzServerTest, GetServerSocketsPaginationTest) {
   }
 }
 
+TEST_P(ChannelzServerTest, MethodStatsTest) {
+  ResetStubs();
+  ConfigureProxy(1);
+  const int kNumCalls = 10;
+  for (int i = 0; i < kNumCalls; ++i) {
+    SendSuccessfulEcho(0);
+  }
+  // Calls are recorded when the server destroys them, which may be after the
+  // client got their status.
+  const char* kEchoMethod = "/grpc.testing.EchoTestService/Echo";
+  experimental::MethodStats echo_stats;
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+  do {
+    for (const experimental::MethodStats& stats :
+         proxy_server_->experimental().GetMethodStats()) {
+      if (stats.method == kEchoMethod) echo_stats = stats;
+    }
+    if (echo_stats.handler_time_ns.count == kNumCalls) break;
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+  } while (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0);
+  EXPECT_EQ(echo_stats.queue_time_ns.count, kNumCalls);
+  EXPECT_EQ(echo_stats.handler_time_ns.count, kNumCalls);
+  EXPECT_GT(echo_stats.handler_time_ns.sum, 0);
+  EXPECT_GT(echo_stats.handler_time_ns.p99, 0);
+  EXPECT_GE(echo_stats.handler_time_ns.p99, echo_stats.handler_time_ns.p50);
+  EXPECT_GT(echo_stats.bytes_in.sum, 0);
+  EXPECT_GT(echo_stats.bytes_out.sum, 0);
+  // Channelz reports the same stats.
+  GetServersRequest request;
+  GetServersResponse response;
+  request.set_start_server_id(0);
+  ClientContext context;
+  Status s = channelz_stub_->GetServers(&context, request, &response);
+  EXPECT_TRUE(s.ok()) << "s.error_message() = " << s.error_message();
+  ASSERT_EQ(response.server_size(), 1);
+  bool found = false;
+  for (const grpc::channelz::v1::MethodStats& stats :
+       response.server(0).method_stats()) {
+    if (stats.method() != kEchoMethod) continue;
+    found = true;
+    EXPECT_EQ(stats.calls_recorded(), kNumCalls);
+    EXPECT_GT(stats.handler_time_nanos().p99(), 0);
+    EXPECT_EQ(stats.bytes_in().sum(), echo_stats.bytes_in.sum);
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST_P(ChannelzServerTest, ConcurrencyLimiterTest) {
+  ResetStubs();
+  ConfigureProxy(1);
+  const int kNumCalls = 10;
+  for (int i = 0; i < kNumCalls; ++i) {
+    SendSuccessfulEcho(0);
+  }
+  GetServersRequest request;
+  GetServersResponse response;
+  request.set_start_server_id(0);
+  ClientContext context;
+  Status s = channelz_stub_->GetServers(&context, request, &response);
+  EXPECT_TRUE(s.ok()) << "s.error_message() = " << s.error_message();
+  ASSERT_EQ(response.server_size(), 1);
+  ASSERT_TRUE(response.server(0).has_concurrency_limiter());
+  const grpc::channelz::v1::ConcurrencyLimiter& limiter =
+      response.server(0).concurrency_limiter();
+  EXPECT_EQ(limiter.limit(), 1000);
+  // The GetServers call itself is admitted too.
+  EXPECT_GE(limiter.admitted(), kNumCalls);
+  EXPECT_EQ(limiter.rejected(), 0);
+}
+
 TEST_P(ChannelzServerTest, GetServerListenSocketsTest) {
   ResetStubs();
   ConfigureProxy(1);
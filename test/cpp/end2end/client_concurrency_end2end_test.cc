@@ -0,0 +1,240 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/support/time.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+// A slow backend: sleeps for server_sleep_us, then fails with expected_error
+// if set.
+class SlowService : public EchoTestService::Service {
+ public:
+  Status Echo(ServerContext* /*context*/, const EchoRequest* request,
+              EchoResponse* response) override {
+    calls_.fetch_add(1);
+    if (request->param().server_sleep_us() > 0) {
+      gpr_sleep_until(gpr_time_add(
+          gpr_now(GPR_CLOCK_MONOTONIC),
+          gpr_time_from_micros(request->param().server_sleep_us(),
+                               GPR_TIMESPAN)));
+    }
+    if (request->param().expected_error().code() != 0) {
+      return Status(
+          static_cast<StatusCode>(request->param().expected_error().code()),
+          "");
+    }
+    response->set_message(request->message());
+    return Status::OK;
+  }
+
+  int calls() const { return calls_.load(); }
+
+ private:
+  std::atomic<int> calls_{0};
+};
+
+class ClientConcurrencyEnd2endTest : public ::testing::Test {
+ protected:
+  // The channel admits kLimit calls at once.
+  static constexpr int kLimit = 2;
+
+  void SetUp() override {
+    int port = grpc_pick_unused_port_or_die();
+    server_address_ = "localhost:" + std::to_string(port);
+    ServerBuilder builder;
+    builder.AddListeningPort(server_address_, InsecureServerCredentials());
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  void ResetStub(const std::string& service_config = "") {
+    ChannelArguments args;
+    args.SetInt(GRPC_ARG_CLIENT_ADAPTIVE_CONCURRENCY, 1);
+    args.SetInt(GRPC_ARG_CLIENT_CONCURRENCY_INITIAL_LIMIT, kLimit);
+    args.SetInt(GRPC_ARG_CLIENT_CONCURRENCY_MIN_LIMIT, kLimit);
+    args.SetInt(GRPC_ARG_CLIENT_CONCURRENCY_MAX_LIMIT, kLimit);
+    if (!service_config.empty()) args.SetServiceConfigJSON(service_config);
+    channel_ = CreateCustomChannel(server_address_,
+                                   InsecureChannelCredentials(), args);
+    stub_ = EchoTestService::NewStub(channel_);
+    // Get the channel ready, so that calls go through the filter in order.
+    EXPECT_TRUE(SendRpc(0, StatusCode::OK).ok());
+  }
+
+  Status SendRpc(int server_sleep_us, StatusCode code) {
+    EchoRequest request;
+    EchoResponse response;
+    ClientContext context;
+    request.set_message("hello");
+    request.mutable_param()->set_server_sleep_us(server_sleep_us);
+    request.mutable_param()->mutable_expected_error()->set_code(code);
+    return stub_->Echo(&context, request, &response);
+  }
+
+  // Starts \a num_calls calls taking \a server_sleep_us on the server, and
+  // returns their statuses once they are all done.
+  std::vector<Status> SendConcurrentRpcs(int num_calls, int server_sleep_us) {
+    struct Call {
+      ClientContext context;
+      EchoRequest request;
+      EchoResponse response;
+      Status status;
+    };
+    std::vector<std::unique_ptr<Call>> calls;
+    grpc_core::Mutex mu;
+    grpc_core::CondVar cv;
+    int pending = num_calls;
+    for (int i = 0; i < num_calls; i++) {
+      calls.emplace_back(new Call);
+      Call* call = calls.back().get();
+      call->request.set_message("hello");
+      call->request.mutable_param()->set_server_sleep_us(server_sleep_us);
+      stub_->async()->Echo(&call->context, &call->request, &call->response,
+                           [call, &mu, &cv, &pending](Status s) {
+                             grpc_core::MutexLock lock(&mu);
+                             call->status = std::move(s);
+                             if (--pending == 0) cv.Signal();
+                           });
+    }
+    grpc_core::MutexLock lock(&mu);
+    while (pending > 0) cv.Wait(&mu);
+    std::vector<Status> statuses;
+    for (const auto& call : calls) statuses.push_back(call->status);
+    return statuses;
+  }
+
+  static int SlowCallUs() { return 500000 * grpc_test_slowdown_factor(); }
+
+  std::string server_address_;
+  SlowService service_;
+  std::unique_ptr<Server> server_;
+  std::shared_ptr<Channel> channel_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+constexpr int ClientConcurrencyEnd2endTest::kLimit;
+
+TEST_F(ClientConcurrencyEnd2endTest, FailsCallsOverLimit) {
+  ResetStub();
+  const int kNumCalls = kLimit + 3;
+  std::vector<Status> statuses = SendConcurrentRpcs(kNumCalls, SlowCallUs());
+  int ok = 0;
+  for (const Status& status : statuses) {
+    if (status.ok()) {
+      ok++;
+    } else {
+      EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+      EXPECT_EQ(status.error_message(), "Client concurrency limit reached");
+    }
+  }
+  EXPECT_EQ(ok, kLimit);
+  // The rejected calls never reached the backend.
+  EXPECT_EQ(service_.calls(), 1 + kLimit);
+  // Once the calls are done, new ones are admitted again.
+  EXPECT_TRUE(SendRpc(0, StatusCode::OK).ok());
+}
+
+TEST_F(ClientConcurrencyEnd2endTest, RejectedCallsCanBeCancelled) {
+  ResetStub();
+  std::vector<Status> statuses;
+  std::thread admitted(
+      [&]() { statuses = SendConcurrentRpcs(kLimit, SlowCallUs()); });
+  while (service_.calls() < 1 + kLimit) {
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+  }
+  // The cancellation goes down the stack after the rejection.
+  ClientContext context;
+  auto stream = stub_->BidiStream(&context);
+  context.TryCancel();
+  EchoResponse response;
+  EXPECT_FALSE(stream->Read(&response));
+  Status status = stream->Finish();
+  EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+  admitted.join();
+  for (const Status& status : statuses) EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(SendRpc(0, StatusCode::OK).ok());
+}
+
+TEST_F(ClientConcurrencyEnd2endTest, RejectedCallsThrottleRetries) {
+  ResetStub(
+      "{\n"
+      "  \"methodConfig\": [ {\n"
+      "    \"name\": [\n"
+      "      { \"service\": \"grpc.testing.EchoTestService\" }\n"
+      "    ],\n"
+      "    \"retryPolicy\": {\n"
+      "      \"maxAttempts\": 3,\n"
+      "      \"initialBackoff\": \"0.01s\",\n"
+      "      \"maxBackoff\": \"0.01s\",\n"
+      "      \"backoffMultiplier\": 1.0,\n"
+      "      \"retryableStatusCodes\": [ \"ABORTED\" ]\n"
+      "    }\n"
+      "  } ],\n"
+      "  \"retryThrottling\": {\n"
+      "    \"maxTokens\": 10,\n"
+      "    \"tokenRatio\": 0.1\n"
+      "  }\n"
+      "}");
+  // Retried while the throttle has tokens: 3 attempts.
+  EXPECT_EQ(SendRpc(0, StatusCode::ABORTED).error_code(), StatusCode::ABORTED);
+  EXPECT_EQ(service_.calls(), 1 + 3);
+  // Shed enough calls to use up the tokens left.
+  const int kNumCalls = kLimit + 10;
+  std::vector<Status> statuses = SendConcurrentRpcs(kNumCalls, SlowCallUs());
+  int rejected = 0;
+  for (const Status& status : statuses) {
+    if (status.error_code() == StatusCode::RESOURCE_EXHAUSTED) rejected++;
+  }
+  EXPECT_EQ(rejected, kNumCalls - kLimit);
+  EXPECT_EQ(service_.calls(), 1 + 3 + kLimit);
+  // Not retried anymore.
+  EXPECT_EQ(SendRpc(0, StatusCode::ABORTED).error_code(), StatusCode::ABORTED);
+  EXPECT_EQ(service_.calls(), 1 + 3 + kLimit + 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -105,12 +106,22 @@ class MyTestServiceImpl : public TestServiceImpl {
   Status Echo(ServerContext* context, const EchoRequest* request,
               EchoResponse* response) override {
     const udpa::data::orca::v1::OrcaLoadReport* load_report = nullptr;
+    StatusCode fault_code;
+    int fault_delay_ms;
     {
       grpc::internal::MutexLock lock(&mu_);
       ++request_count_;
       load_report = load_report_;
+      fault_code = fault_code_;
+      fault_delay_ms = fault_delay_ms_;
     }
     AddClient(context->peer());
+    if (fault_delay_ms > 0) {
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(fault_delay_ms));
+    }
+    if (fault_code != StatusCode::OK) {
+      return Status(fault_code, "injected fault");
+    }
     if (load_report != nullptr) {
       // TODO(roth): Once we provide a more standard server-side API for
       // populating this data, use that API here.
@@ -140,6 +151,14 @@ class MyTestServiceImpl : public TestServiceImpl {
     load_report_ = load_report;
   }
 
+  // Makes the following calls fail with code (unless it is OK), after
+  // delay_ms.
+  void set_fault(StatusCode code, int delay_ms) {
+    grpc::internal::MutexLock lock(&mu_);
+    fault_code_ = code;
+    fault_delay_ms_ = delay_ms;
+  }
+
  private:
   void AddClient(const std::string& client) {
     grpc::internal::MutexLock lock(&clients_mu_);
@@ -149,6 +168,8 @@ class MyTestServiceImpl : public TestServiceImpl {
   grpc::internal::Mutex mu_;
   int request_count_ = 0;
   const udpa::data::orca::v1::OrcaLoadReport* load_report_ = nullptr;
+  StatusCode fault_code_ = StatusCode::OK;
+  int fault_delay_ms_ = 0;
   grpc::internal::Mutex clients_mu_;
   std::set<std::string> clients_;
 };
@@ -1256,8 +1277,60 @@ TEST_F(ClientLbEnd2endTest, RoundRobinManyUpdates) {
 }
 
 TEST_F(ClientLbEnd2endTest, RoundRobinConcurrentUpdates) {
-  // TODO(dgq): replicate the way internal testing exercises the concurrent
-  // update provisions of RR.
+  // Picks run without the channel's lock: race them against picker updates
+  // and subchannel disconnects. Server 0 stays up and in every update, so
+  // that there is always a subchannel to pick.
+  const int kNumServers = 4;
+  const int kNumPickingThreads = 4;
+  const int kNumUpdates = 1000;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("round_robin", response_generator);
+  auto stub = BuildStub(channel);
+  std::vector<int> ports = GetServersPorts();
+  response_generator.SetNextResolution(ports);
+  WaitForServer(stub, 0, DEBUG_LOCATION);
+  std::atomic<bool> done{false};
+  std::atomic<int> num_ok{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumPickingThreads; ++i) {
+    threads.emplace_back([&]() {
+      while (!done.load()) {
+        Status status;
+        if (SendRpc(stub, nullptr, 1000, &status)) {
+          num_ok.fetch_add(1);
+        } else {
+          // The RPCs in flight on a server being shut down fail.
+          EXPECT_THAT(status.error_code(),
+                      ::testing::AnyOf(StatusCode::UNAVAILABLE,
+                                       StatusCode::CANCELLED))
+              << status.error_message();
+        }
+      }
+    });
+  }
+  std::mt19937 rng(std::random_device{}());
+  for (int i = 0; i < kNumUpdates; ++i) {
+    std::vector<int> update = {ports[0]};
+    for (size_t j = 1; j < ports.size(); ++j) {
+      if (rng() % 2 == 0) update.push_back(ports[j]);
+    }
+    std::shuffle(update.begin(), update.end(), rng);
+    response_generator.SetNextResolution(update);
+    if (i % 50 == 0) {
+      const size_t index = 1 + rng() % (kNumServers - 1);
+      servers_[index]->Shutdown();
+      StartServer(index);
+    }
+  }
+  done.store(true);
+  for (auto& thread : threads) thread.join();
+  EXPECT_GT(num_ok.load(), 0);
+  // The channel still reaches every server.
+  response_generator.SetNextResolution(ports);
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    WaitForServer(stub, i, DEBUG_LOCATION);
+  }
 }
 
 TEST_F(ClientLbEnd2endTest, RoundRobinReresolve) {
@@ -1669,6 +1742,170 @@ TEST_F(ClientLbEnd2endTest, ChannelIdleness) {
   EXPECT_EQ(channel->GetState(false), GRPC_CHANNEL_READY);
 }
 
+class ClientLbOutlierDetectionTest : public ClientLbEnd2endTest {
+ protected:
+  // Returns a service config for outlier detection over round_robin, with
+  // a short interval.  ejection_config holds the ejection fields.
+  static std::string ServiceConfig(const std::string& ejection_config,
+                                   const char* interval = "0.2s") {
+    return absl::StrCat(
+        "{\"loadBalancingConfig\": [{\"outlier_detection_experimental\": {"
+        "  \"interval\": \"",
+        interval,
+        "\","
+        "  \"maxEjectionPercent\": 50,",
+        ejection_config,
+        "  \"childPolicy\": [{\"round_robin\": {}}]"
+        "}}]}");
+  }
+
+  // Sends RPCs until server_idx receives none of kNumRpcs RPCs, and returns
+  // whether it did before the deadline.
+  bool WaitForEjection(
+      const std::unique_ptr<grpc::testing::EchoTestService::Stub>& stub,
+      size_t server_idx, int timeout_seconds = 10) {
+    constexpr int kNumRpcs = 50;
+    const gpr_timespec deadline =
+        grpc_timeout_seconds_to_deadline(timeout_seconds);
+    while (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0) {
+      ResetCounters();
+      for (int i = 0; i < kNumRpcs; ++i) SendRpc(stub);
+      if (servers_[server_idx]->service_.request_count() == 0) return true;
+    }
+    return false;
+  }
+};
+
+TEST_F(ClientLbOutlierDetectionTest, EjectsFailingBackend) {
+  const int kNumServers = 5;
+  StartServers(kNumServers);
+  servers_[0]->service_.set_fault(StatusCode::UNAVAILABLE, 0);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  const std::string service_config = ServiceConfig(
+      "\"failurePercentageEjection\": {"
+      "  \"threshold\": 50,"
+      "  \"enforcementPercentage\": 100,"
+      "  \"minimumHosts\": 3,"
+      "  \"requestVolume\": 5"
+      "},");
+  response_generator.SetNextResolution(GetServersPorts(),
+                                       service_config.c_str());
+  ASSERT_TRUE(WaitForEjection(stub, 0));
+  // The other backends keep receiving RPCs, which all succeed.
+  for (int i = 0; i < 20; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+  EXPECT_EQ(0, servers_[0]->service_.request_count());
+  for (size_t i = 1; i < servers_.size(); ++i) {
+    EXPECT_GT(servers_[i]->service_.request_count(), 0) << i;
+  }
+  EXPECT_EQ("outlier_detection_experimental",
+            channel->GetLoadBalancingPolicyName());
+}
+
+TEST_F(ClientLbOutlierDetectionTest, EjectsBackendWithLowSuccessRate) {
+  const int kNumServers = 5;
+  StartServers(kNumServers);
+  servers_[2]->service_.set_fault(StatusCode::INTERNAL, 0);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  const std::string service_config = ServiceConfig(
+      "\"successRateEjection\": {"
+      "  \"stdevFactor\": 1000,"
+      "  \"minimumHosts\": 3,"
+      "  \"requestVolume\": 5"
+      "},");
+  response_generator.SetNextResolution(GetServersPorts(),
+                                       service_config.c_str());
+  ASSERT_TRUE(WaitForEjection(stub, 2));
+  for (int i = 0; i < 20; ++i) CheckRpcSendOk(stub, DEBUG_LOCATION);
+}
+
+TEST_F(ClientLbOutlierDetectionTest, EjectsSlowBackend) {
+  const int kNumServers = 5;
+  StartServers(kNumServers);
+  servers_[1]->service_.set_fault(StatusCode::OK, 50);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  const std::string service_config = ServiceConfig(
+      "\"latencyEjection\": {"
+      "  \"percentile\": 90,"
+      "  \"threshold\": 300,"
+      "  \"minimumHosts\": 3,"
+      "  \"requestVolume\": 2"
+      "},");
+  response_generator.SetNextResolution(GetServersPorts(),
+                                       service_config.c_str());
+  ASSERT_TRUE(WaitForEjection(stub, 1));
+}
+
+TEST_F(ClientLbOutlierDetectionTest, UnejectsAfterBaseEjectionTime) {
+  const int kNumServers = 5;
+  StartServers(kNumServers);
+  servers_[0]->service_.set_fault(StatusCode::UNAVAILABLE, 0);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  const std::string service_config = ServiceConfig(
+      "\"baseEjectionTime\": \"1s\","
+      "\"failurePercentageEjection\": {"
+      "  \"enforcementPercentage\": 100,"
+      "  \"minimumHosts\": 3,"
+      "  \"requestVolume\": 5"
+      "},");
+  response_generator.SetNextResolution(GetServersPorts(),
+                                       service_config.c_str());
+  ASSERT_TRUE(WaitForEjection(stub, 0));
+  // Once the backend recovers, it gets RPCs again after its ejection time.
+  servers_[0]->service_.set_fault(StatusCode::OK, 0);
+  WaitForServer(stub, 0, DEBUG_LOCATION);
+}
+
+TEST_F(ClientLbOutlierDetectionTest, DoesNotEjectWithoutEjectionConfig) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  servers_[0]->service_.set_fault(StatusCode::UNAVAILABLE, 0);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(),
+                                       ServiceConfig("").c_str());
+  do {
+    SendRpc(stub);
+  } while (!SeenAllServers());
+  // The failing backend keeps getting its share of the RPCs.
+  for (int i = 0; i < 10; ++i) {
+    ResetCounters();
+    for (int j = 0; j < 30; ++j) SendRpc(stub);
+    EXPECT_EQ(10, servers_[0]->service_.request_count());
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(100));
+  }
+}
+
+TEST_F(ClientLbOutlierDetectionTest, TogglesEjectionWhileTimerFires) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  const std::string enabled = ServiceConfig(
+      "\"failurePercentageEjection\": {},", /*interval=*/"0.001s");
+  const std::string disabled = ServiceConfig("", /*interval=*/"0.001s");
+  response_generator.SetNextResolution(GetServersPorts(), enabled.c_str());
+  CheckRpcSendOk(stub, DEBUG_LOCATION);
+  // Turning ejection off and back on while an expired timer's callback is
+  // queued must not leave two timers running the ejection algorithms.
+  const gpr_timespec deadline = grpc_timeout_seconds_to_deadline(3);
+  while (gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0) {
+    response_generator.SetNextResolution(GetServersPorts(), disabled.c_str());
+    response_generator.SetNextResolution(GetServersPorts(), enabled.c_str());
+    SendRpc(stub);
+  }
+  CheckRpcSendOk(stub, DEBUG_LOCATION);
+}
+
 class ClientLbPickArgsTest : public ClientLbEnd2endTest {
  protected:
   void SetUp() override {
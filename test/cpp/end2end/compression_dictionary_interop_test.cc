@@ -0,0 +1,126 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/compression.h>
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/util/subprocess.h"
+
+static std::string g_root;
+
+namespace grpc {
+namespace testing {
+
+namespace {
+
+// Dictionaries are registered for the whole process, so the server runs in
+// another one, which may or may not register the dictionary of the client.
+const char kPathPrefix[] = "/grpc.testing.EchoTestService/";
+const char kDictionary[] =
+    "{\"user\": \"alice\", \"status\": \"active\", \"roles\": [\"admin\"]}";
+
+class CompressionDictionaryInteropTest : public ::testing::Test {
+ protected:
+  void StartServer(bool with_dictionary) {
+    std::string addr =
+        "localhost:" + std::to_string(grpc_pick_unused_port_or_die());
+    std::vector<std::string> args = {
+        g_root + "/compression_dictionary_interop_test_server",
+        "--address=" + addr,
+    };
+    if (with_dictionary) {
+      args.push_back(std::string("--dictionary_path_prefix=") + kPathPrefix);
+      args.push_back(std::string("--dictionary=") + kDictionary);
+    }
+    server_ = absl::make_unique<SubProcess>(args);
+    ChannelArguments channel_args;
+    channel_args.SetCompressionAlgorithm(GRPC_COMPRESS_DEFLATE);
+    stub_ = EchoTestService::NewStub(CreateCustomChannel(
+        addr, InsecureChannelCredentials(), channel_args));
+  }
+
+  // Sends RPCs that deflate well with the dictionary, one after the other on
+  // the same connection.
+  void SendRpcs() {
+    for (int i = 0; i < 5; i++) {
+      EchoRequest request;
+      EchoResponse response;
+      ClientContext context;
+      context.set_wait_for_ready(true);
+      context.set_deadline(grpc_timeout_seconds_to_deadline(30));
+      request.set_message(
+          "{\"user\": \"bob\", \"status\": \"active\", \"roles\": []}");
+      Status status = stub_->Echo(&context, request, &response);
+      ASSERT_TRUE(status.ok())
+          << "RPC " << i << ": " << status.error_message();
+      EXPECT_EQ(response.message(), request.message());
+    }
+  }
+
+  std::unique_ptr<SubProcess> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+// The client has to wait for the server to list the dictionary: a server
+// without it cannot inflate the messages deflated with it.
+TEST_F(CompressionDictionaryInteropTest, ServerWithoutDictionary) {
+  StartServer(/*with_dictionary=*/false);
+  SendRpcs();
+}
+
+TEST_F(CompressionDictionaryInteropTest, ServerWithDictionary) {
+  StartServer(/*with_dictionary=*/true);
+  SendRpcs();
+}
+
+}  // namespace
+
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  std::string me = argv[0];
+  auto lslash = me.rfind('/');
+  if (lslash != std::string::npos) {
+    g_root = me.substr(0, lslash);
+  } else {
+    g_root = ".";
+  }
+
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  GPR_ASSERT(grpc_compression_dictionary_register(
+      grpc::testing::kPathPrefix, grpc::testing::kDictionary,
+      sizeof(grpc::testing::kDictionary) - 1));
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "absl/flags/flag.h"
+
+#include <grpc/compression.h>
+#include <grpc/support/log.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/cpp/util/test_config.h"
+
+ABSL_FLAG(std::string, address, "", "Address to bind to");
+ABSL_FLAG(std::string, dictionary_path_prefix, "",
+          "Path prefix to register --dictionary for");
+ABSL_FLAG(std::string, dictionary, "",
+          "Compression dictionary to register, if any");
+
+using grpc::testing::EchoRequest;
+using grpc::testing::EchoResponse;
+
+namespace grpc {
+namespace testing {
+
+class ServiceImpl final : public ::grpc::testing::EchoTestService::Service {
+  Status Echo(ServerContext* /*context*/, const EchoRequest* request,
+              EchoResponse* response) override {
+    response->set_message(request->message());
+    return Status::OK;
+  }
+};
+
+void RunServer() {
+  const std::string dictionary = absl::GetFlag(FLAGS_dictionary);
+  if (!dictionary.empty()) {
+    GPR_ASSERT(grpc_compression_dictionary_register(
+        absl::GetFlag(FLAGS_dictionary_path_prefix).c_str(),
+        dictionary.data(), dictionary.size()));
+  }
+  ServiceImpl service;
+
+  ServerBuilder builder;
+  builder.AddListeningPort(absl::GetFlag(FLAGS_address),
+                           grpc::InsecureServerCredentials());
+  builder.SetDefaultCompressionAlgorithm(GRPC_COMPRESS_DEFLATE);
+  builder.RegisterService(&service);
+  std::unique_ptr<Server> server(builder.BuildAndStart());
+  std::cout << "Server listening on " << absl::GetFlag(FLAGS_address)
+            << std::endl;
+  server->Wait();
+}
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::InitTest(&argc, &argv, true);
+  grpc::testing::RunServer();
+
+  return 0;
+}
@@ -0,0 +1,304 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Needs C++20: the tests are compiled out otherwise.
+#include <grpcpp/support/coroutine.h>
+
+#ifdef GRPCPP_HAS_COROUTINES
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+const int kNumMessages = 5;
+
+class CoroutineEchoService : public EchoTestService::CallbackService {
+ public:
+  ServerUnaryReactor* Echo(CallbackServerContext* context,
+                           const EchoRequest* request,
+                           EchoResponse* response) override {
+    return HandleEcho(context, request, response);
+  }
+
+  ServerReadReactor<EchoRequest>* RequestStream(
+      CallbackServerContext* context, EchoResponse* response) override {
+    return HandleRequestStream(context, response);
+  }
+
+  ServerWriteReactor<EchoResponse>* ResponseStream(
+      CallbackServerContext* context, const EchoRequest* request) override {
+    return HandleResponseStream(context, request);
+  }
+
+  ServerBidiReactor<EchoRequest, EchoResponse>* BidiStream(
+      CallbackServerContext* context) override {
+    return HandleBidiStream(context);
+  }
+
+  // The number of streaming handlers that returned.
+  int handlers_done() const { return handlers_done_.load(); }
+
+ private:
+  experimental::ServerUnaryHandler HandleEcho(CallbackServerContext* context,
+                                              const EchoRequest* request,
+                                              EchoResponse* response) {
+    if (request->message().empty()) {
+      co_return Status(StatusCode::INVALID_ARGUMENT, "empty message");
+    }
+    response->set_message(request->message());
+    co_return Status::OK;
+  }
+
+  experimental::ServerReadHandler<EchoRequest> HandleRequestStream(
+      CallbackServerContext* context, EchoResponse* response) {
+    auto& stream = co_await experimental::this_stream;
+    EchoRequest request;
+    while (co_await stream.Read(&request)) {
+      response->mutable_message()->append(request.message());
+    }
+    ++handlers_done_;
+    co_return Status::OK;
+  }
+
+  experimental::ServerWriteHandler<EchoResponse> HandleResponseStream(
+      CallbackServerContext* context, const EchoRequest* request) {
+    auto& stream = co_await experimental::this_stream;
+    EchoResponse response;
+    for (int i = 0; i < kNumMessages; ++i) {
+      response.set_message(request->message() + std::to_string(i));
+      if (!co_await stream.Write(response)) break;
+    }
+    ++handlers_done_;
+    co_return Status::OK;
+  }
+
+  experimental::ServerBidiHandler<EchoRequest, EchoResponse> HandleBidiStream(
+      CallbackServerContext* context) {
+    auto& stream = co_await experimental::this_stream;
+    EchoRequest request;
+    EchoResponse response;
+    while (co_await stream.Read(&request)) {
+      response.set_message(request.message());
+      if (!co_await stream.Write(response)) break;
+    }
+    ++handlers_done_;
+    co_return context->IsCancelled() ? Status::CANCELLED : Status::OK;
+  }
+
+  std::atomic<int> handlers_done_{0};
+};
+
+class CoroutineEnd2endTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int port = 0;
+    ServerBuilder builder;
+    builder.AddListeningPort("localhost:0", InsecureServerCredentials(),
+                             &port);
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    stub_ = EchoTestService::NewStub(
+        CreateChannel("localhost:" + std::to_string(port),
+                      InsecureChannelCredentials()));
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  // Waits for the streaming handlers on the server to return.
+  void WaitForHandlers(int count) {
+    gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+    while (service_.handlers_done() < count) {
+      ASSERT_LT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline), 0);
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+    }
+  }
+
+  CoroutineEchoService service_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+using UnaryResult = std::pair<Status, std::string>;
+
+experimental::Detached Unary(EchoTestService::Stub* stub,
+                             const std::string& message,
+                             std::promise<UnaryResult>* done) {
+  ClientContext context;
+  EchoRequest request;
+  EchoResponse response;
+  request.set_message(message);
+  Status status = co_await experimental::CallUnary(
+      [&](ClientUnaryReactor* reactor) {
+        stub->async()->Echo(&context, &request, &response, reactor);
+      });
+  done->set_value({status, response.message()});
+}
+
+TEST_F(CoroutineEnd2endTest, Unary) {
+  std::promise<UnaryResult> done;
+  Unary(stub_.get(), "hello", &done);
+  auto result = done.get_future().get();
+  EXPECT_TRUE(result.first.ok()) << result.first.error_message();
+  EXPECT_EQ(result.second, "hello");
+}
+
+TEST_F(CoroutineEnd2endTest, UnaryError) {
+  std::promise<UnaryResult> done;
+  Unary(stub_.get(), "", &done);
+  auto result = done.get_future().get();
+  EXPECT_EQ(result.first.error_code(), StatusCode::INVALID_ARGUMENT);
+  EXPECT_EQ(result.first.error_message(), "empty message");
+}
+
+experimental::Detached ClientStreaming(EchoTestService::Stub* stub,
+                                       std::promise<std::string>* done) {
+  ClientContext context;
+  EchoResponse response;
+  experimental::ClientWriteStream<EchoRequest> stream;
+  stub->async()->RequestStream(&context, &response, &stream);
+  stream.Start();
+  EchoRequest request;
+  for (int i = 0; i < kNumMessages; ++i) {
+    request.set_message(std::to_string(i));
+    EXPECT_TRUE(co_await stream.Write(request));
+  }
+  EXPECT_TRUE(co_await stream.WritesDone());
+  Status status = co_await stream.Finish();
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  done->set_value(response.message());
+}
+
+TEST_F(CoroutineEnd2endTest, ClientStreaming) {
+  std::promise<std::string> done;
+  ClientStreaming(stub_.get(), &done);
+  EXPECT_EQ(done.get_future().get(), "01234");
+  WaitForHandlers(1);
+}
+
+experimental::Detached ServerStreaming(EchoTestService::Stub* stub,
+                                       std::promise<int>* done) {
+  ClientContext context;
+  EchoRequest request;
+  request.set_message("hello");
+  experimental::ClientReadStream<EchoResponse> stream;
+  stub->async()->ResponseStream(&context, &request, &stream);
+  stream.Start();
+  EchoResponse response;
+  int reads = 0;
+  while (co_await stream.Read(&response)) {
+    EXPECT_EQ(response.message(), "hello" + std::to_string(reads));
+    ++reads;
+  }
+  Status status = co_await stream.Finish();
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  done->set_value(reads);
+}
+
+TEST_F(CoroutineEnd2endTest, ServerStreaming) {
+  std::promise<int> done;
+  ServerStreaming(stub_.get(), &done);
+  EXPECT_EQ(done.get_future().get(), kNumMessages);
+  WaitForHandlers(1);
+}
+
+experimental::Detached Bidi(EchoTestService::Stub* stub,
+                            std::promise<Status>* done) {
+  ClientContext context;
+  experimental::ClientBidiStream<EchoRequest, EchoResponse> stream;
+  stub->async()->BidiStream(&context, &stream);
+  stream.Start();
+  EchoRequest request;
+  EchoResponse response;
+  for (int i = 0; i < kNumMessages; ++i) {
+    request.set_message(std::to_string(i));
+    EXPECT_TRUE(co_await stream.Write(request));
+    EXPECT_TRUE(co_await stream.Read(&response));
+    EXPECT_EQ(response.message(), request.message());
+  }
+  EXPECT_TRUE(co_await stream.WritesDone());
+  EXPECT_FALSE(co_await stream.Read(&response));
+  done->set_value(co_await stream.Finish());
+}
+
+TEST_F(CoroutineEnd2endTest, Bidi) {
+  std::promise<Status> done;
+  Bidi(stub_.get(), &done);
+  Status status = done.get_future().get();
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  WaitForHandlers(1);
+}
+
+experimental::Detached CancelledBidi(EchoTestService::Stub* stub,
+                                     std::promise<Status>* done) {
+  ClientContext context;
+  experimental::ClientBidiStream<EchoRequest, EchoResponse> stream;
+  stub->async()->BidiStream(&context, &stream);
+  stream.Start();
+  EchoRequest request;
+  EchoResponse response;
+  request.set_message("hello");
+  EXPECT_TRUE(co_await stream.Write(request));
+  EXPECT_TRUE(co_await stream.Read(&response));
+  // Cancels the read awaited below, and the read the server awaits.
+  context.TryCancel();
+  EXPECT_FALSE(co_await stream.Read(&response));
+  done->set_value(co_await stream.Finish());
+}
+
+TEST_F(CoroutineEnd2endTest, CancelledBidi) {
+  std::promise<Status> done;
+  CancelledBidi(stub_.get(), &done);
+  EXPECT_EQ(done.get_future().get().error_code(), StatusCode::CANCELLED);
+  // The server handler resumed and returned, freeing its frame.
+  WaitForHandlers(1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else  // GRPCPP_HAS_COROUTINES
+
+int main(int /*argc*/, char** /*argv*/) { return 0; }
+
+#endif  // GRPCPP_HAS_COROUTINES
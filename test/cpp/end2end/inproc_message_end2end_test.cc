@@ -0,0 +1,222 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/grpc.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/client_interceptor.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/end2end/test_service_impl.h"
+
+namespace grpc {
+namespace testing {
+namespace {
+
+// Messages passed as objects never go through the byte size checks, so a
+// small receive limit on the server tells the two paths apart.
+constexpr int kMaxReceiveMessageSize = 64;
+const std::string& LargeMessage() {
+  static const std::string* message = new std::string(1024, 'x');
+  return *message;
+}
+
+// Asks for the serialized form of every message the client sends.
+class SerializingInterceptor : public experimental::Interceptor {
+ public:
+  void Intercept(experimental::InterceptorBatchMethods* methods) override {
+    if (methods->QueryInterceptionHookPoint(
+            experimental::InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+      EXPECT_NE(methods->GetSerializedSendMessage(), nullptr);
+    }
+    methods->Proceed();
+  }
+};
+
+class SerializingInterceptorFactory
+    : public experimental::ClientInterceptorFactoryInterface {
+ public:
+  experimental::Interceptor* CreateClientInterceptor(
+      experimental::ClientRpcInfo* /*info*/) override {
+    return new SerializingInterceptor();
+  }
+};
+
+class InprocMessageEnd2endTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    if (server_ != nullptr) server_->Shutdown();
+  }
+
+  void StartServer(bool callback_server) {
+    ServerBuilder builder;
+    if (callback_server) {
+      builder.RegisterService(&callback_service_);
+    } else {
+      builder.RegisterService(&service_);
+    }
+    builder.SetMaxReceiveMessageSize(kMaxReceiveMessageSize);
+    server_ = builder.BuildAndStart();
+  }
+
+  void ResetStub(bool pass_message_pointers, bool serializing_interceptor) {
+    ChannelArguments args;
+    if (pass_message_pointers) {
+      args.SetInt(GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS, 1);
+    }
+    std::shared_ptr<Channel> channel;
+    if (serializing_interceptor) {
+      std::vector<
+          std::unique_ptr<experimental::ClientInterceptorFactoryInterface>>
+          creators;
+      creators.push_back(absl::make_unique<SerializingInterceptorFactory>());
+      channel = server_->experimental().InProcessChannelWithInterceptors(
+          args, std::move(creators));
+    } else {
+      channel = server_->InProcessChannel(args);
+    }
+    stub_ = grpc::testing::EchoTestService::NewStub(channel);
+  }
+
+  Status SyncEcho(const std::string& message, EchoResponse* response) {
+    EchoRequest request;
+    request.set_message(message);
+    ClientContext context;
+    return stub_->Echo(&context, request, response);
+  }
+
+  TestServiceImpl service_;
+  CallbackTestServiceImpl callback_service_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<grpc::testing::EchoTestService::Stub> stub_;
+};
+
+TEST_F(InprocMessageEnd2endTest, SerializesByDefault) {
+  StartServer(/*callback_server=*/false);
+  ResetStub(/*pass_message_pointers=*/false, /*serializing_interceptor=*/false);
+  EchoResponse response;
+  Status status = SyncEcho(LargeMessage(), &response);
+  EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+}
+
+TEST_F(InprocMessageEnd2endTest, SyncUnaryPassesMessages) {
+  StartServer(/*callback_server=*/false);
+  ResetStub(/*pass_message_pointers=*/true, /*serializing_interceptor=*/false);
+  for (int i = 0; i < 10; i++) {
+    EchoResponse response;
+    Status status = SyncEcho(LargeMessage(), &response);
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(response.message(), LargeMessage());
+  }
+}
+
+TEST_F(InprocMessageEnd2endTest, CallbackUnaryPassesMessages) {
+  StartServer(/*callback_server=*/true);
+  ResetStub(/*pass_message_pointers=*/true, /*serializing_interceptor=*/false);
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext context;
+  request.set_message(LargeMessage());
+  std::mutex mu;
+  std::condition_variable cv;
+  bool done = false;
+  Status status;
+  stub_->async()->Echo(&context, &request, &response, [&](Status s) {
+    std::lock_guard<std::mutex> l(mu);
+    status = std::move(s);
+    done = true;
+    cv.notify_one();
+  });
+  std::unique_lock<std::mutex> l(mu);
+  while (!done) {
+    cv.wait(l);
+  }
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  EXPECT_EQ(response.message(), LargeMessage());
+}
+
+TEST_F(InprocMessageEnd2endTest, ClientStreamPassesMessages) {
+  StartServer(/*callback_server=*/false);
+  ResetStub(/*pass_message_pointers=*/true, /*serializing_interceptor=*/false);
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext context;
+  auto stream = stub_->RequestStream(&context, &response);
+  request.set_message(LargeMessage());
+  EXPECT_TRUE(stream->Write(request));
+  EXPECT_TRUE(stream->Write(request));
+  stream->WritesDone();
+  Status status = stream->Finish();
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  EXPECT_EQ(response.message(), LargeMessage() + LargeMessage());
+}
+
+TEST_F(InprocMessageEnd2endTest, InterceptorGetsSerializedMessages) {
+  StartServer(/*callback_server=*/false);
+  ResetStub(/*pass_message_pointers=*/true, /*serializing_interceptor=*/true);
+  EchoResponse response;
+  Status status = SyncEcho(LargeMessage(), &response);
+  EXPECT_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+  status = SyncEcho("small", &response);
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  EXPECT_EQ(response.message(), "small");
+}
+
+TEST(InprocMessageTest, OnlyRecognizesTheSliceItMade) {
+  EchoRequest request;
+  request.set_message(LargeMessage());
+  ByteBuffer buffer;
+  ASSERT_TRUE(
+      GenericSerializeInproc(request, /*may_move=*/false, &buffer).ok());
+  EXPECT_NE(grpc::internal::InprocMessageFromByteBuffer(buffer), nullptr);
+  // The same bytes anywhere else are just bytes.
+  std::vector<Slice> slices;
+  ASSERT_TRUE(buffer.Dump(&slices).ok());
+  ASSERT_EQ(slices.size(), 1u);
+  Slice copy(slices[0].begin(), slices[0].size());
+  ByteBuffer copied(&copy, 1);
+  EXPECT_EQ(grpc::internal::InprocMessageFromByteBuffer(copied), nullptr);
+  EchoRequest received;
+  EXPECT_TRUE(SerializationTraits<EchoRequest>::Deserialize(&buffer, &received)
+                  .ok());
+  EXPECT_EQ(received.message(), LargeMessage());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
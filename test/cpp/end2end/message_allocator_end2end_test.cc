@@ -37,6 +37,7 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/client_callback.h>
 #include <grpcpp/support/message_allocator.h>
+#include <grpcpp/support/message_arena_pool.h>
 
 #include "src/core/lib/iomgr/iomgr.h"
 #include "src/proto/grpc/testing/echo.grpc.pb.h"
@@ -108,8 +109,14 @@ class MessageAllocatorEnd2endTestBase
 
   ~MessageAllocatorEnd2endTestBase() override = default;
 
-  void CreateServer(MessageAllocator<EchoRequest, EchoResponse>* allocator) {
+  // Allocates the messages of \a arena_pool_method from an arena pool, unless
+  // it is null.
+  void CreateServer(MessageAllocator<EchoRequest, EchoResponse>* allocator,
+                    const char* arena_pool_method = nullptr) {
     ServerBuilder builder;
+    if (arena_pool_method != nullptr) {
+      builder.experimental().SetMessageArenaPool(arena_pool_method);
+    }
 
     auto server_creds = GetCredentialsProvider()->GetServerCredentials(
         GetParam().credentials_type);
@@ -353,6 +360,77 @@ TEST_P(ArenaAllocatorTest, SimpleRpc) {
   EXPECT_EQ(kRpcCount, allocator->allocation_count);
 }
 
+TEST_P(ArenaAllocatorTest, BuiltInAllocator) {
+  const int kRpcCount = 10;
+  experimental::ArenaMessageAllocator<EchoRequest, EchoResponse> allocator;
+  std::atomic<int> arena_allocated{0};
+  callback_service_.SetAllocatorMutator(
+      [&arena_allocated](RpcAllocatorState* /*allocator_state*/,
+                         const EchoRequest* req, EchoResponse* resp) {
+        if (req->GetArena() != nullptr && req->GetArena() == resp->GetArena()) {
+          arena_allocated++;
+        }
+      });
+  CreateServer(&allocator);
+  ResetStub();
+  SendRpcs(kRpcCount);
+  EXPECT_EQ(kRpcCount, arena_allocated.load());
+}
+
+class ArenaPoolTest : public MessageAllocatorEnd2endTestBase {
+ protected:
+  // Counts the RPCs whose messages are on an arena.
+  void CountArenaAllocatedRpcs() {
+    callback_service_.SetAllocatorMutator(
+        [this](RpcAllocatorState* /*allocator_state*/, const EchoRequest* req,
+               EchoResponse* resp) {
+          if (req->GetArena() != nullptr &&
+              req->GetArena() == resp->GetArena()) {
+            arena_allocated_++;
+          }
+        });
+  }
+
+  std::atomic<int> arena_allocated_{0};
+};
+
+TEST_P(ArenaPoolTest, AllMethods) {
+  const int kRpcCount = 10;
+  CountArenaAllocatedRpcs();
+  CreateServer(nullptr, "");
+  ResetStub();
+  SendRpcs(kRpcCount);
+  EXPECT_EQ(kRpcCount, arena_allocated_.load());
+}
+
+TEST_P(ArenaPoolTest, OneMethod) {
+  const int kRpcCount = 10;
+  CountArenaAllocatedRpcs();
+  CreateServer(nullptr, "/grpc.testing.EchoTestService/Echo");
+  ResetStub();
+  SendRpcs(kRpcCount);
+  EXPECT_EQ(kRpcCount, arena_allocated_.load());
+}
+
+TEST_P(ArenaPoolTest, OtherMethod) {
+  const int kRpcCount = 10;
+  CountArenaAllocatedRpcs();
+  CreateServer(nullptr, "/grpc.testing.EchoTestService/BidiStream");
+  ResetStub();
+  SendRpcs(kRpcCount);
+  EXPECT_EQ(0, arena_allocated_.load());
+}
+
+TEST_P(ArenaPoolTest, AllocatorTakesPrecedence) {
+  const int kRpcCount = 10;
+  std::unique_ptr<ArenaAllocatorTest::ArenaAllocator> allocator(
+      new ArenaAllocatorTest::ArenaAllocator);
+  CreateServer(allocator.get(), "");
+  ResetStub();
+  SendRpcs(kRpcCount);
+  EXPECT_EQ(kRpcCount, allocator->allocation_count);
+}
+
 std::vector<TestScenario> CreateTestScenarios(bool test_insecure) {
   std::vector<TestScenario> scenarios;
   std::vector<std::string> credentials_types{
@@ -388,6 +466,8 @@ INSTANTIATE_TEST_SUITE_P(SimpleAllocatorTest, SimpleAllocatorTest,
                          ::testing::ValuesIn(CreateTestScenarios(true)));
 INSTANTIATE_TEST_SUITE_P(ArenaAllocatorTest, ArenaAllocatorTest,
                          ::testing::ValuesIn(CreateTestScenarios(true)));
+INSTANTIATE_TEST_SUITE_P(ArenaPoolTest, ArenaPoolTest,
+                         ::testing::ValuesIn(CreateTestScenarios(true)));
 
 }  // namespace
 }  // namespace testing
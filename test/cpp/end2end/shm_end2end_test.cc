@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include "src/core/lib/channel/shm_handshaker.h"
+#include "src/core/lib/iomgr/port.h"
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/end2end/test_service_impl.h"
+
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+
+namespace grpc {
+namespace testing {
+namespace {
+
+// A server listening on a Unix domain socket with the shared-memory endpoint
+// enabled.
+class ShmEnd2endTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    server_address_ =
+        absl::StrCat("unix:/tmp/grpc_shm_end2end_test.", getpid(), ".",
+                     grpc_pick_unused_port_or_die());
+    ServerBuilder builder;
+    builder.AddListeningPort(server_address_, InsecureServerCredentials());
+    builder.AddChannelArgument(GRPC_ARG_SHM_ENDPOINT, 1);
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  void SendRpcs(bool shm_client) {
+    ChannelArguments args;
+    if (shm_client) args.SetInt(GRPC_ARG_SHM_ENDPOINT, 1);
+    auto stub = EchoTestService::NewStub(CreateCustomChannel(
+        server_address_, InsecureChannelCredentials(), args));
+    for (int i = 0; i < 10; i++) {
+      EchoRequest request;
+      EchoResponse response;
+      ClientContext context;
+      context.set_deadline(grpc_timeout_seconds_to_deadline(10));
+      request.set_message(std::string(i * 1000, 'a'));
+      Status status = stub->Echo(&context, request, &response);
+      ASSERT_TRUE(status.ok()) << status.error_message();
+      EXPECT_EQ(response.message(), request.message());
+    }
+  }
+
+  std::string server_address_;
+  TestServiceImpl service_;
+  std::unique_ptr<Server> server_;
+};
+
+TEST_F(ShmEnd2endTest, ShmClient) { SendRpcs(/*shm_client=*/true); }
+
+// A client without the channel arg keeps talking HTTP/2 over the socket.
+TEST_F(ShmEnd2endTest, PlainClient) { SendRpcs(/*shm_client=*/false); }
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+#endif  // GRPC_LINUX_SHM_ENDPOINT
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -277,6 +277,22 @@ void WriteBootstrapFiles() {
   g_bootstrap_file_v2 = bootstrap_file;
 }
 
+// Sets an environment variable until it goes out of scope, so that a test
+// failing an assertion does not leave it set for the tests that follow.
+class ScopedEnvVar {
+ public:
+  ScopedEnvVar(const char* name, const char* value) : name_(name) {
+    gpr_setenv(name_, value);
+  }
+  ~ScopedEnvVar() { gpr_unsetenv(name_); }
+
+  ScopedEnvVar(const ScopedEnvVar&) = delete;
+  ScopedEnvVar& operator=(const ScopedEnvVar&) = delete;
+
+ private:
+  const char* name_;
+};
+
 template <typename ServiceType>
 class CountedService : public ServiceType {
  public:
@@ -8219,6 +8235,49 @@ TEST_P(CdsTest, RingHashPolicyHasInvalidRingSizeMinGreaterThanMax) {
                   "min_ring_size cannot be greater than max_ring_size."));
 }
 
+// Test that the outlier detection config of the cluster is accepted and
+// passed to the LB policy.
+TEST_P(CdsTest, OutlierDetectionEnabled) {
+  ScopedEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_OUTLIER_DETECTION", "true");
+  auto cluster = default_cluster_;
+  auto* outlier_detection = cluster.mutable_outlier_detection();
+  outlier_detection->mutable_interval()->set_nanos(100000000);
+  outlier_detection->mutable_base_ejection_time()->set_seconds(1);
+  outlier_detection->mutable_max_ejection_percent()->set_value(50);
+  outlier_detection->mutable_enforcing_failure_percentage()->set_value(100);
+  outlier_detection->mutable_failure_percentage_request_volume()->set_value(
+      5);
+  balancers_[0]->ads_service()->SetCdsResource(cluster);
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  AdsServiceImpl::EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends()},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(
+      BuildEdsResource(args, DefaultEdsServiceName()));
+  WaitForAllBackends();
+  EXPECT_EQ(balancers_[0]->ads_service()->cds_response_state().state,
+            AdsServiceImpl::ResponseState::ACKED);
+}
+
+// Test we nack when the outlier detection config has an invalid percentage.
+TEST_P(CdsTest, OutlierDetectionHasInvalidMaxEjectionPercent) {
+  ScopedEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_OUTLIER_DETECTION", "true");
+  auto cluster = default_cluster_;
+  cluster.mutable_outlier_detection()
+      ->mutable_max_ejection_percent()
+      ->set_value(101);
+  balancers_[0]->ads_service()->SetCdsResource(cluster);
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  ASSERT_TRUE(WaitForCdsNack()) << "timed out waiting for NACK";
+  const auto response_state =
+      balancers_[0]->ads_service()->cds_response_state();
+  EXPECT_EQ(response_state.state, AdsServiceImpl::ResponseState::NACKED);
+  EXPECT_THAT(response_state.error_message,
+              ::testing::HasSubstr("max_ejection_percent must be <= 100"));
+}
+
 class XdsSecurityTest : public BasicTest {
  protected:
   void SetUp() override {
@@ -0,0 +1,148 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Microbenchmarks around ALTS zero-copy frame protection throughput */
+
+#include <string.h>
+
+#include <benchmark/benchmark.h>
+
+#include <grpc/grpc.h>
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/tsi/alts/crypt/gsec.h"
+#include "src/core/tsi/alts/zero_copy_frame_protector/alts_zero_copy_grpc_protector.h"
+#include "src/core/tsi/transport_security_grpc.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+// Writes are split into this many slices, as they would be coming out of the
+// chttp2 transport.
+constexpr size_t kSlicesPerWrite = 8;
+
+struct ProtectorPair {
+  ProtectorPair(bool integrity_only) {
+    uint8_t key[kAes128GcmRekeyKeyLength];
+    memset(key, 0x5a, sizeof(key));
+    GPR_ASSERT(alts_zero_copy_grpc_protector_create(
+                   key, sizeof(key), /*is_rekey=*/true, /*is_client=*/true,
+                   integrity_only, /*enable_extra_copy=*/false, nullptr,
+                   &sender) == TSI_OK);
+    GPR_ASSERT(alts_zero_copy_grpc_protector_create(
+                   key, sizeof(key), /*is_rekey=*/true, /*is_client=*/false,
+                   integrity_only, /*enable_extra_copy=*/false, nullptr,
+                   &receiver) == TSI_OK);
+  }
+  ~ProtectorPair() {
+    tsi_zero_copy_grpc_protector_destroy(sender);
+    tsi_zero_copy_grpc_protector_destroy(receiver);
+  }
+  tsi_zero_copy_grpc_protector* sender = nullptr;
+  tsi_zero_copy_grpc_protector* receiver = nullptr;
+};
+
+static void FillWrite(size_t write_size, grpc_slice_buffer* sb) {
+  size_t slice_size = write_size / kSlicesPerWrite;
+  for (size_t i = 0; i < kSlicesPerWrite; ++i) {
+    size_t length =
+        i + 1 == kSlicesPerWrite ? write_size - i * slice_size : slice_size;
+    grpc_slice slice = GRPC_SLICE_MALLOC(length);
+    memset(GRPC_SLICE_START_PTR(slice), static_cast<int>(i), length);
+    grpc_slice_buffer_add(sb, slice);
+  }
+}
+
+static void BM_AltsZeroCopySeal(benchmark::State& state) {
+  const size_t write_size = static_cast<size_t>(state.range(0));
+  grpc_core::ExecCtx exec_ctx;
+  ProtectorPair protectors(/*integrity_only=*/state.range(1) != 0);
+  grpc_slice_buffer unprotected;
+  grpc_slice_buffer protected_sb;
+  grpc_slice_buffer_init(&unprotected);
+  grpc_slice_buffer_init(&protected_sb);
+  for (auto _ : state) {
+    state.PauseTiming();
+    FillWrite(write_size, &unprotected);
+    state.ResumeTiming();
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(
+                   protectors.sender, &unprotected, &protected_sb) == TSI_OK);
+    grpc_slice_buffer_reset_and_unref_internal(&protected_sb);
+  }
+  grpc_slice_buffer_destroy_internal(&unprotected);
+  grpc_slice_buffer_destroy_internal(&protected_sb);
+  state.SetBytesProcessed(state.iterations() * write_size);
+}
+
+static void BM_AltsZeroCopySealUnseal(benchmark::State& state) {
+  const size_t write_size = static_cast<size_t>(state.range(0));
+  grpc_core::ExecCtx exec_ctx;
+  ProtectorPair protectors(/*integrity_only=*/state.range(1) != 0);
+  grpc_slice_buffer unprotected;
+  grpc_slice_buffer protected_sb;
+  grpc_slice_buffer_init(&unprotected);
+  grpc_slice_buffer_init(&protected_sb);
+  for (auto _ : state) {
+    state.PauseTiming();
+    FillWrite(write_size, &unprotected);
+    state.ResumeTiming();
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_protect(
+                   protectors.sender, &unprotected, &protected_sb) == TSI_OK);
+    GPR_ASSERT(tsi_zero_copy_grpc_protector_unprotect(
+                   protectors.receiver, &protected_sb, &unprotected) ==
+               TSI_OK);
+    GPR_ASSERT(unprotected.length == write_size);
+    grpc_slice_buffer_reset_and_unref_internal(&unprotected);
+  }
+  grpc_slice_buffer_destroy_internal(&unprotected);
+  grpc_slice_buffer_destroy_internal(&protected_sb);
+  state.SetBytesProcessed(state.iterations() * write_size * 2);
+}
+
+static void WriteSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"write_size", "integrity_only"});
+  for (int integrity_only = 0; integrity_only <= 1; ++integrity_only) {
+    for (int64_t write_size = 16 * 1024; write_size <= 1024 * 1024;
+         write_size *= 4) {
+      b->Args({write_size, integrity_only});
+    }
+  }
+}
+BENCHMARK(BM_AltsZeroCopySeal)->Apply(WriteSizes);
+BENCHMARK(BM_AltsZeroCopySealUnseal)->Apply(WriteSizes);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  grpc_init();
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
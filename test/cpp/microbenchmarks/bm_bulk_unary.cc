@@ -0,0 +1,140 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark bursts of small unary calls, started one by one or in bulk */
+
+#include <condition_variable>
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+#include <grpcpp/support/bulk_unary_call.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/callback_test_service.h"
+#include "test/cpp/microbenchmarks/fullstack_fixtures.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+/*******************************************************************************
+ * BENCHMARKING KERNELS
+ */
+
+// Each iteration starts state.range(0) callback unary calls, and waits for them
+// all to complete.
+template <class Fixture>
+static void BM_IndividualUnaryCalls(benchmark::State& state) {
+  const int num_calls = state.range(0);
+  CallbackStreamingTestService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(&service));
+  std::unique_ptr<EchoTestService::Stub> stub(
+      EchoTestService::NewStub(fixture->channel()));
+  EchoRequest request;
+  request.set_message("hello");
+  std::vector<EchoResponse> responses(num_calls);
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<ClientContext>> contexts;
+    std::mutex mu;
+    std::condition_variable cv;
+    int pending = num_calls;
+    for (int i = 0; i < num_calls; i++) {
+      contexts.emplace_back(new ClientContext);
+      stub->async()->Echo(contexts.back().get(), &request, &responses[i],
+                          [&mu, &cv, &pending](Status s) {
+                            GPR_ASSERT(s.ok());
+                            std::lock_guard<std::mutex> l(mu);
+                            if (--pending == 0) cv.notify_one();
+                          });
+    }
+    std::unique_lock<std::mutex> l(mu);
+    while (pending > 0) cv.wait(l);
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetItemsProcessed(num_calls * state.iterations());
+}
+
+// Each iteration starts state.range(0) unary calls with a single bulk call,
+// and waits for its callback.
+template <class Fixture>
+static void BM_BulkUnaryCalls(benchmark::State& state) {
+  const int num_calls = state.range(0);
+  CallbackStreamingTestService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(&service));
+  experimental::BulkUnaryStub<EchoRequest, EchoResponse> stub(
+      fixture->channel(), "/grpc.testing.EchoTestService/Echo");
+  EchoRequest request;
+  request.set_message("hello");
+  std::vector<EchoRequest> requests(num_calls, request);
+  std::vector<EchoResponse> responses;
+  for (auto _ : state) {
+    ClientContext context;
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+    stub.Call(&context, requests, &responses,
+              [&mu, &cv, &done](std::vector<Status> statuses) {
+                for (const Status& s : statuses) GPR_ASSERT(s.ok());
+                std::lock_guard<std::mutex> l(mu);
+                done = true;
+                cv.notify_one();
+              });
+    std::unique_lock<std::mutex> l(mu);
+    while (!done) cv.wait(l);
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetItemsProcessed(num_calls * state.iterations());
+}
+
+/*******************************************************************************
+ * CONFIGURATIONS
+ */
+
+// Replace "benchmark::internal::Benchmark" with "::testing::Benchmark" to use
+// internal microbenchmarking tooling
+static void BurstSizes(benchmark::internal::Benchmark* b) {
+  // The argument is the number of calls of a burst
+  for (int i = 10; i <= 1000; i *= 10) b->Arg(i);
+}
+
+BENCHMARK_TEMPLATE(BM_IndividualUnaryCalls, InProcess)->Apply(BurstSizes);
+BENCHMARK_TEMPLATE(BM_BulkUnaryCalls, InProcess)->Apply(BurstSizes);
+BENCHMARK_TEMPLATE(BM_IndividualUnaryCalls, TCP)->Apply(BurstSizes);
+BENCHMARK_TEMPLATE(BM_BulkUnaryCalls, TCP)->Apply(BurstSizes);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -47,6 +47,26 @@ BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcess, NoOpMutator,
 BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, MinInProcess, NoOpMutator,
                    NoOpMutator)
     ->Apply(SweepSizesArgs);
+BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcessPassMessagePointers,
+                   NoOpMutator, NoOpMutator)
+    ->Apply(SweepSizesArgs);
+
+// Replace "benchmark::internal::Benchmark" with "::testing::Benchmark" to use
+// internal microbenchmarking tooling
+static void NestedArgs(benchmark::internal::Benchmark* b) {
+  for (int leaves = 1; leaves <= 4096; leaves *= 8) {
+    // First argument is the number of leaves of the request
+    // Second argument is the message size of response
+    b->Args({leaves, 0});
+  }
+}
+
+// Unary ping pong with nested requests, with the default message allocation
+// and with arena pools
+BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPongNested, InProcess)
+    ->Apply(NestedArgs);
+BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPongNested, InProcessMessageArenaPool)
+    ->Apply(NestedArgs);
 
 // Client context with different metadata
 BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcess,
@@ -25,9 +25,12 @@
 #include <grpc/grpc.h>
 
 #include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/gprpp/contention_profiler.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/combiner.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/profiling/timers.h"
 #include "test/core/util/test_config.h"
 #include "test/cpp/microbenchmarks/helpers.h"
 #include "test/cpp/util/test_config.h"
@@ -136,6 +139,24 @@ static void BM_ClosureSchedOnExecCtx(benchmark::State& state) {
 }
 BENCHMARK(BM_ClosureSchedOnExecCtx);
 
+// Arg is the latency tracer's sampling period, 0 to disable it.
+static void BM_ClosureSchedOnTracedExecCtx(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_closure c;
+  GRPC_CLOSURE_INIT(&c, DoNothing, nullptr, grpc_schedule_on_exec_ctx);
+  if (state.range(0) > 0) {
+    grpc_core::LatencyTracer::Enable(state.range(0));
+  }
+  for (auto _ : state) {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, &c, GRPC_ERROR_NONE);
+  }
+  grpc_core::LatencyTracer::Disable();
+
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_ClosureSchedOnTracedExecCtx)->Arg(0)->Arg(1)->Arg(100);
+
 static void BM_ClosureSched2OnExecCtx(benchmark::State& state) {
   TrackCounters track_counters;
   grpc_closure c1;
@@ -210,6 +231,51 @@ static void BM_TryAcquireMutex(benchmark::State& state) {
 }
 BENCHMARK(BM_TryAcquireMutex);
 
+// Arg is the contention profiler's sampling period, 0 to disable it.
+static void MaybeEnableContentionProfiler(benchmark::State& state) {
+  if (state.range(0) > 0) {
+    grpc_core::ContentionProfiler::Enable(state.range(0));
+  }
+}
+
+static void DisableContentionProfiler() {
+  grpc_core::ContentionProfiler::Disable();
+  grpc_core::ContentionProfiler::Reset();
+}
+
+static void BM_AcquireMutexProfiled(benchmark::State& state) {
+  TrackCounters track_counters;
+  gpr_mu mu;
+  gpr_mu_init(&mu);
+  grpc_core::ExecCtx exec_ctx;
+  MaybeEnableContentionProfiler(state);
+  for (auto _ : state) {
+    gpr_mu_lock(&mu);
+    DoNothing(nullptr, GRPC_ERROR_NONE);
+    gpr_mu_unlock(&mu);
+  }
+  DisableContentionProfiler();
+  gpr_mu_destroy(&mu);
+
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_AcquireMutexProfiled)->Arg(0)->Arg(1)->Arg(100);
+
+static void BM_AcquireCoreMutex(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::Mutex mu;
+  grpc_core::ExecCtx exec_ctx;
+  MaybeEnableContentionProfiler(state);
+  for (auto _ : state) {
+    grpc_core::MutexLock lock(&mu);
+    DoNothing(nullptr, GRPC_ERROR_NONE);
+  }
+  DisableContentionProfiler();
+
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_AcquireCoreMutex)->Arg(0)->Arg(1)->Arg(100);
+
 static void BM_AcquireSpinlock(benchmark::State& state) {
   TrackCounters track_counters;
   // for comparison with the combiner stuff below
@@ -0,0 +1,269 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark the coroutine layer of the callback API against reactors */
+
+#include <grpcpp/support/coroutine.h>
+
+#include "test/core/util/test_config.h"
+#include "test/cpp/util/test_config.h"
+
+#ifdef GRPCPP_HAS_COROUTINES
+
+#include "test/cpp/microbenchmarks/callback_streaming_ping_pong.h"
+#include "test/cpp/microbenchmarks/callback_unary_ping_pong.h"
+
+namespace grpc {
+namespace testing {
+
+/*******************************************************************************
+ * BENCHMARKING KERNELS
+ */
+
+namespace {
+
+int MessageSizeFromMetadata(CallbackServerContext* context) {
+  auto it = context->client_metadata().find(kServerMessageSize);
+  if (it == context->client_metadata().end()) return 0;
+  return std::stoi(std::string(it->second.data(), it->second.size()));
+}
+
+// The same service as CallbackStreamingTestService, with coroutine handlers.
+class CoroutineTestService : public EchoTestService::CallbackService {
+ public:
+  ServerUnaryReactor* Echo(CallbackServerContext* context,
+                           const EchoRequest* request,
+                           EchoResponse* response) override {
+    return HandleEcho(context, request, response);
+  }
+
+  ServerBidiReactor<EchoRequest, EchoResponse>* BidiStream(
+      CallbackServerContext* context) override {
+    return HandleBidiStream(context);
+  }
+
+ private:
+  experimental::ServerUnaryHandler HandleEcho(
+      CallbackServerContext* context, const EchoRequest* /*request*/,
+      EchoResponse* response) {
+    response->set_message(std::string(MessageSizeFromMetadata(context), 'a'));
+    co_return Status::OK;
+  }
+
+  experimental::ServerBidiHandler<EchoRequest, EchoResponse> HandleBidiStream(
+      CallbackServerContext* context) {
+    auto& stream = co_await experimental::this_stream;
+    int message_size = MessageSizeFromMetadata(context);
+    EchoRequest request;
+    EchoResponse response;
+    while (co_await stream.Read(&request)) {
+      response.set_message(std::string(message_size, 'a'));
+      if (!co_await stream.Write(response)) {
+        gpr_log(GPR_ERROR, "Server write failed");
+        break;
+      }
+    }
+    co_return Status::OK;
+  }
+};
+
+class Done {
+ public:
+  void Notify() {
+    std::lock_guard<std::mutex> l(mu_);
+    done_ = true;
+    cv_.notify_one();
+  }
+  void Await() {
+    std::unique_lock<std::mutex> l(mu_);
+    while (!done_) {
+      cv_.wait(l);
+    }
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool done_ = false;
+};
+
+experimental::Detached CoroutineUnaryPingPongs(benchmark::State* state,
+                                               EchoTestService::Stub* stub,
+                                               const EchoRequest* request,
+                                               EchoResponse* response,
+                                               Done* done) {
+  do {
+    ClientContext cli_ctx;
+    cli_ctx.AddMetadata(kServerMessageSize, std::to_string(state->range(1)));
+    Status s = co_await experimental::CallUnary(
+        [&](ClientUnaryReactor* reactor) {
+          stub->async()->Echo(&cli_ctx, request, response, reactor);
+        });
+    GPR_ASSERT(s.ok());
+  } while (state->KeepRunning());
+  done->Notify();
+}
+
+experimental::Detached CoroutineBidiStreams(benchmark::State* state,
+                                            EchoTestService::Stub* stub,
+                                            const EchoRequest* request,
+                                            EchoResponse* response,
+                                            Done* done) {
+  do {
+    ClientContext cli_ctx;
+    cli_ctx.AddMetadata(kServerMessageSize, std::to_string(state->range(0)));
+    experimental::ClientBidiStream<EchoRequest, EchoResponse> stream;
+    stub->async()->BidiStream(&cli_ctx, &stream);
+    stream.Start();
+    for (int i = 0; i < state->range(1); i++) {
+      bool ok = co_await stream.Write(*request);
+      ok = ok && co_await stream.Read(response);
+      GPR_ASSERT(ok);
+    }
+    co_await stream.WritesDone();
+    Status s = co_await stream.Finish();
+    GPR_ASSERT(s.ok());
+  } while (state->KeepRunning());
+  done->Notify();
+}
+
+}  // namespace
+
+template <class Fixture>
+static void BM_CoroutineUnaryPingPong(benchmark::State& state) {
+  int request_msgs_size = state.range(0);
+  int response_msgs_size = state.range(1);
+  CoroutineTestService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(&service));
+  std::unique_ptr<EchoTestService::Stub> stub_(
+      EchoTestService::NewStub(fixture->channel()));
+  EchoRequest request;
+  EchoResponse response;
+  request.set_message(std::string(request_msgs_size, 'a'));
+  if (state.KeepRunning()) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    Done done;
+    CoroutineUnaryPingPongs(&state, stub_.get(), &request, &response, &done);
+    done.Await();
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(request_msgs_size * state.iterations() +
+                          response_msgs_size * state.iterations());
+}
+
+template <class Fixture>
+static void BM_CoroutineBidiStreaming(benchmark::State& state) {
+  int message_size = state.range(0);
+  int max_ping_pongs = state.range(1);
+  CoroutineTestService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(&service));
+  std::unique_ptr<EchoTestService::Stub> stub_(
+      EchoTestService::NewStub(fixture->channel()));
+  EchoRequest request;
+  EchoResponse response;
+  request.set_message(std::string(message_size, 'a'));
+  if (state.KeepRunning()) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    Done done;
+    CoroutineBidiStreams(&state, stub_.get(), &request, &response, &done);
+    done.Await();
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(2 * message_size * max_ping_pongs *
+                          state.iterations());
+}
+
+/*******************************************************************************
+ * CONFIGURATIONS
+ */
+
+// The reactor benchmarks run with the same arguments, for comparison.
+
+// Replace "benchmark::internal::Benchmark" with "::testing::Benchmark" to use
+// internal microbenchmarking tooling
+static void UnarySizesArgs(benchmark::internal::Benchmark* b) {
+  b->Args({0, 0});
+  for (int i = 1; i <= 1024 * 1024; i *= 32) {
+    // First argument is the message size of request
+    // Second argument is the message size of response
+    b->Args({i, i});
+  }
+}
+
+// Replace "benchmark::internal::Benchmark" with "::testing::Benchmark" to use
+// internal microbenchmarking tooling
+static void StreamingArgs(benchmark::internal::Benchmark* b) {
+  // First argument is the message size
+  // Second argument is the number of ping-pongs per stream
+  for (int msg_number = 1; msg_number <= 4096; msg_number *= 64) {
+    b->Args({0, msg_number});
+    b->Args({1024, msg_number});
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_CoroutineUnaryPingPong, InProcess)
+    ->Apply(UnarySizesArgs);
+BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcess, NoOpMutator,
+                   NoOpMutator)
+    ->Apply(UnarySizesArgs);
+BENCHMARK_TEMPLATE(BM_CoroutineUnaryPingPong, MinInProcess)
+    ->Apply(UnarySizesArgs);
+BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, MinInProcess, NoOpMutator,
+                   NoOpMutator)
+    ->Apply(UnarySizesArgs);
+
+BENCHMARK_TEMPLATE(BM_CoroutineBidiStreaming, InProcess)
+    ->Apply(StreamingArgs);
+BENCHMARK_TEMPLATE(BM_CallbackBidiStreaming, InProcess, NoOpMutator,
+                   NoOpMutator)
+    ->Apply(StreamingArgs);
+BENCHMARK_TEMPLATE(BM_CoroutineBidiStreaming, MinInProcess)
+    ->Apply(StreamingArgs);
+BENCHMARK_TEMPLATE(BM_CallbackBidiStreaming, MinInProcess, NoOpMutator,
+                   NoOpMutator)
+    ->Apply(StreamingArgs);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
+
+#else  // GRPCPP_HAS_COROUTINES
+
+// The coroutine layer needs C++20.
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  return 0;
+}
+
+#endif  // GRPCPP_HAS_COROUTINES
@@ -50,6 +50,12 @@ BENCHMARK_TEMPLATE(BM_StreamingPingPong, TCP, NoOpMutator, NoOpMutator)
     ->Apply(StreamingPingPongArgs);
 BENCHMARK_TEMPLATE(BM_StreamingPingPong, InProcess, NoOpMutator, NoOpMutator)
     ->Apply(StreamingPingPongArgs);
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+BENCHMARK_TEMPLATE(BM_StreamingPingPong, ShmPair, NoOpMutator, NoOpMutator)
+    ->Apply(StreamingPingPongArgs);
+BENCHMARK_TEMPLATE(BM_StreamingPingPong, ShmUDS, NoOpMutator, NoOpMutator)
+    ->Apply(StreamingPingPongArgs);
+#endif  // GRPC_LINUX_SHM_ENDPOINT
 
 BENCHMARK_TEMPLATE(BM_StreamingPingPongMsgs, InProcessCHTTP2, NoOpMutator,
                    NoOpMutator)
@@ -59,6 +65,10 @@ BENCHMARK_TEMPLATE(BM_StreamingPingPongMsgs, TCP, NoOpMutator, NoOpMutator)
 BENCHMARK_TEMPLATE(BM_StreamingPingPongMsgs, InProcess, NoOpMutator,
                    NoOpMutator)
     ->Range(0, 128 * 1024 * 1024);
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+BENCHMARK_TEMPLATE(BM_StreamingPingPongMsgs, ShmPair, NoOpMutator, NoOpMutator)
+    ->Range(0, 128 * 1024 * 1024);
+#endif  // GRPC_LINUX_SHM_ENDPOINT
 
 BENCHMARK_TEMPLATE(BM_StreamingPingPong, MinInProcessCHTTP2, NoOpMutator,
                    NoOpMutator)
@@ -45,6 +45,18 @@ BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, InProcess)
     ->Range(0, 128 * 1024 * 1024);
 BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, InProcessCHTTP2)
     ->Range(0, 128 * 1024 * 1024);
+// Messages of many frames, to compare framing in place with reslicing (in
+// addition to the sizes above).
+static void FramingArgs(benchmark::internal::Benchmark* b) {
+  b->Arg(64 * 1024)->Arg(1024 * 1024)->Arg(4 * 1024 * 1024);
+}
+BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, TCP)->Apply(FramingArgs);
+BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, InProcessCHTTP2)
+    ->Apply(FramingArgs);
+BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, TCP)->Apply(FramingArgs);
+BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, InProcessCHTTP2)
+    ->Apply(FramingArgs);
+
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinTCP)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinUDS)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinInProcess)->Arg(0);
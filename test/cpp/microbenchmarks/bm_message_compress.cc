@@ -0,0 +1,289 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Microbenchmarks for message compression: compression ratio and CPU of
+   per-message deflate, reused zlib streams, preset dictionaries, adaptive
+   compression and parallel compression of large messages */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <zlib.h>
+
+#include "absl/memory/memory.h"
+
+#include <grpc/compression.h>
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/compression/adaptive_compression.h"
+#include "src/core/lib/compression/compression_dictionary.h"
+#include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/compression/parallel_compress.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+static const char kPath[] = "/grpc.testing.UserService/GetUser";
+
+/* The strings the messages of the corpus have in common, most frequent
+   last: zlib favors the end of the dictionary. */
+static const char kDictionary[] =
+    "\"preferences\": {\"newsletter\": false, \"theme\": \"dark\"}, "
+    "\"subscription\": {\"plan\": \"premium\", \"renews\": true}, "
+    "\"locale\": \"en-US\", \"time_zone\": \"America/Los_Angeles\", "
+    "{\"user_id\": , \"display_name\": \"\", \"email\": \"@example.com\", ";
+
+/* JSON-ish user records of a couple hundred bytes, which deflate alone
+   barely shrinks. */
+static std::vector<std::string> Corpus() {
+  static const char* kNames[] = {"alice", "bob", "carol", "dave", "erin",
+                                 "frank", "grace", "heidi"};
+  static const char* kPlans[] = {"free", "basic", "premium"};
+  std::vector<std::string> corpus;
+  for (int i = 0; i < 64; i++) {
+    std::string name = kNames[i % 8];
+    corpus.push_back(
+        "{\"user_id\": " + std::to_string(100000 + i * 7919) +
+        ", \"display_name\": \"" + name + std::to_string(i) +
+        "\", \"email\": \"" + name + "." + std::to_string(i) +
+        "@example.com\", \"locale\": \"en-US\", \"time_zone\": "
+        "\"America/Los_Angeles\", \"subscription\": {\"plan\": \"" +
+        kPlans[i % 3] + "\", \"renews\": " + (i % 2 ? "true" : "false") +
+        "}, \"preferences\": {\"newsletter\": " + (i % 5 ? "false" : "true") +
+        ", \"theme\": \"dark\"}}");
+  }
+  return corpus;
+}
+
+static void RegisterDictionary() {
+  static bool registered = grpc_compression_dictionary_register(
+      "/grpc.testing.UserService/", kDictionary, sizeof(kDictionary) - 1);
+  GPR_ASSERT(registered);
+}
+
+enum class Mode {
+  // plain deflate
+  kPlain,
+  // deflate with the dictionary for kPath
+  kDictionary,
+};
+
+/* Compresses and decompresses each message of the corpus in turn, and reports
+   the ratio of compressed to uncompressed bytes. */
+static void BM_CompressSmallMessages(benchmark::State& state, Mode mode) {
+  RegisterDictionary();
+  grpc_core::ExecCtx exec_ctx;
+  const grpc_message_compression_algorithm algorithm =
+      GRPC_MESSAGE_COMPRESS_DEFLATE;
+  grpc_core::MessageCompressor compressor;
+  if (mode == Mode::kDictionary) {
+    compressor.set_dictionary(grpc_core::CompressionDictionaryForPath(kPath));
+  }
+  std::vector<grpc_slice> corpus;
+  for (const std::string& message : Corpus()) {
+    corpus.push_back(
+        grpc_slice_from_copied_buffer(message.data(), message.size()));
+  }
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  grpc_slice_buffer_init(&output);
+  size_t uncompressed_bytes = 0;
+  size_t compressed_bytes = 0;
+  size_t next = 0;
+  for (auto _ : state) {
+    grpc_slice_buffer_add(&input, grpc_slice_ref(corpus[next]));
+    next = (next + 1) % corpus.size();
+    // Messages that do not shrink are sent uncompressed.
+    int was_compressed = compressor.Compress(algorithm, &input, &compressed);
+    GPR_ASSERT(compressor.Decompress(
+        was_compressed ? algorithm : GRPC_MESSAGE_COMPRESS_NONE, &compressed,
+        &output));
+    uncompressed_bytes += input.length;
+    compressed_bytes += compressed.length;
+    grpc_slice_buffer_reset_and_unref_internal(&input);
+    grpc_slice_buffer_reset_and_unref_internal(&compressed);
+    grpc_slice_buffer_reset_and_unref_internal(&output);
+  }
+  state.counters["ratio"] =
+      uncompressed_bytes == 0
+          ? 0
+          : static_cast<double>(compressed_bytes) / uncompressed_bytes;
+  state.SetBytesProcessed(uncompressed_bytes);
+  grpc_slice_buffer_destroy_internal(&input);
+  grpc_slice_buffer_destroy_internal(&compressed);
+  grpc_slice_buffer_destroy_internal(&output);
+  for (grpc_slice& slice : corpus) grpc_slice_unref(slice);
+}
+BENCHMARK_CAPTURE(BM_CompressSmallMessages, Plain, Mode::kPlain);
+BENCHMARK_CAPTURE(BM_CompressSmallMessages, Dictionary, Mode::kDictionary);
+
+/* 4KB messages of one method: half text, half random bytes standing for
+   images or encrypted blobs. */
+static std::vector<std::string> MixedCorpus() {
+  std::vector<std::string> small = Corpus();
+  std::mt19937 gen(42);
+  std::vector<std::string> corpus;
+  for (int i = 0; i < 16; i++) {
+    std::string message;
+    if (i % 2 == 0) {
+      while (message.size() < 4096) message += small[gen() % small.size()];
+    } else {
+      while (message.size() < 4096) message += static_cast<char>(gen());
+    }
+    message.resize(4096);
+    corpus.push_back(std::move(message));
+  }
+  return corpus;
+}
+
+/* Compresses the messages of MixedCorpus() in turn, as the message_compress
+   filter would with and without GRPC_ARG_ADAPTIVE_MESSAGE_COMPRESSION, and
+   reports the compression ratio and the bytes saved per CPU-ms. */
+static void BM_CompressMixedMessages(benchmark::State& state, bool adaptive) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MessageCompressor compressor;
+  grpc_core::AdaptiveCompressionStats stats(4096);
+  std::vector<grpc_slice> corpus;
+  for (const std::string& message : MixedCorpus()) {
+    corpus.push_back(
+        grpc_slice_from_copied_buffer(message.data(), message.size()));
+  }
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  size_t uncompressed_bytes = 0;
+  size_t compressed_bytes = 0;
+  int64_t cpu_ns = 0;
+  size_t next = 0;
+  for (auto _ : state) {
+    grpc_slice_buffer_add(&input, grpc_slice_ref(corpus[next]));
+    next = (next + 1) % corpus.size();
+    grpc_core::AdaptiveCompressionStats::Decision decision = {
+        true, Z_DEFAULT_COMPRESSION};
+    const int64_t start = gpr_thread_cpu_time_ns();
+    if (adaptive) {
+      decision = stats.Decide(&input);
+      compressor.set_level(decision.level);
+    }
+    if (decision.compress) {
+      compressor.Compress(GRPC_MESSAGE_COMPRESS_GZIP, &input, &compressed);
+    } else {
+      grpc_slice_buffer_add(&compressed, grpc_slice_ref(input.slices[0]));
+    }
+    const int64_t message_cpu_ns = gpr_thread_cpu_time_ns() - start;
+    if (adaptive && decision.compress) {
+      stats.Record(decision.level, input.length, compressed.length,
+                   message_cpu_ns);
+    }
+    uncompressed_bytes += input.length;
+    compressed_bytes += compressed.length;
+    cpu_ns += message_cpu_ns;
+    grpc_slice_buffer_reset_and_unref_internal(&input);
+    grpc_slice_buffer_reset_and_unref_internal(&compressed);
+  }
+  if (uncompressed_bytes > 0) {
+    state.counters["ratio"] =
+        static_cast<double>(compressed_bytes) / uncompressed_bytes;
+    state.counters["saved_per_cpu_ms"] =
+        (uncompressed_bytes - compressed_bytes) * 1e6 /
+        std::max<int64_t>(cpu_ns, 1);
+  }
+  state.SetBytesProcessed(uncompressed_bytes);
+  grpc_slice_buffer_destroy_internal(&input);
+  grpc_slice_buffer_destroy_internal(&compressed);
+  for (grpc_slice& slice : corpus) grpc_slice_unref(slice);
+}
+BENCHMARK_CAPTURE(BM_CompressMixedMessages, Always, false);
+BENCHMARK_CAPTURE(BM_CompressMixedMessages, Adaptive, true);
+
+/* Compresses a single message of state.range(0) bytes of Corpus() records,
+   serially when state.range(1) is 0 and otherwise on a ParallelCompressor
+   with that many helper threads. Timed in wall time: the latency the sender
+   sees. */
+static void BM_CompressLargeMessage(benchmark::State& state) {
+  const size_t length = state.range(0);
+  const int helpers = state.range(1);
+  std::vector<std::string> small = Corpus();
+  std::mt19937 gen(42);
+  std::string message;
+  while (message.size() < length) message += small[gen() % small.size()];
+  message.resize(length);
+  grpc_slice slice =
+      grpc_slice_from_copied_buffer(message.data(), message.size());
+  grpc_core::ExecCtx exec_ctx;
+  std::unique_ptr<grpc_core::ParallelCompressor> parallel;
+  grpc_core::MessageCompressor compressor;
+  if (helpers > 0) {
+    parallel = absl::make_unique<grpc_core::ParallelCompressor>(helpers);
+    compressor.set_parallel_compressor(parallel.get(), 1);
+  }
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&compressed);
+  size_t compressed_bytes = 0;
+  for (auto _ : state) {
+    grpc_slice_buffer_add(&input, grpc_slice_ref(slice));
+    GPR_ASSERT(
+        compressor.Compress(GRPC_MESSAGE_COMPRESS_GZIP, &input, &compressed));
+    compressed_bytes = compressed.length;
+    grpc_slice_buffer_reset_and_unref_internal(&input);
+    grpc_slice_buffer_reset_and_unref_internal(&compressed);
+  }
+  state.counters["ratio"] = static_cast<double>(compressed_bytes) / length;
+  state.SetBytesProcessed(state.iterations() * length);
+  grpc_slice_buffer_destroy_internal(&input);
+  grpc_slice_buffer_destroy_internal(&compressed);
+  grpc_slice_unref(slice);
+}
+BENCHMARK(BM_CompressLargeMessage)
+    ->ArgNames({"bytes", "helpers"})
+    ->ArgsProduct({{1 << 20, 8 << 20, 50 << 20}, {0, 1, 3, 7}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  grpc_init();
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark the cost of per-method server stats */
+
+#include <string>
+#include <thread>  // NOLINT
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/grpc.h>
+#include <grpcpp/grpcpp.h>
+
+#include "src/core/lib/debug/method_stats.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+
+class EchoServer final : public grpc::testing::EchoTestService::Service {
+  grpc::Status Echo(grpc::ServerContext* /*context*/,
+                    const grpc::testing::EchoRequest* request,
+                    grpc::testing::EchoResponse* response) override {
+    response->set_message(request->message());
+    return grpc::Status::OK;
+  }
+};
+
+// An EchoServerThread object creates an EchoServer on a separate thread and
+// shuts down the server and thread when it goes out of scope.
+class EchoServerThread final {
+ public:
+  explicit EchoServerThread(bool method_stats) {
+    grpc::ServerBuilder builder;
+    int port;
+    builder.AddListeningPort("[::]:0", grpc::InsecureServerCredentials(),
+                             &port);
+    builder.AddChannelArgument(GRPC_ARG_SERVER_METHOD_STATS, method_stats);
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    if (server_ == nullptr || port == 0) {
+      std::abort();
+    }
+    server_address_ = absl::StrCat("[::]:", port);
+    server_thread_ = std::thread(&EchoServerThread::RunServerLoop, this);
+  }
+
+  ~EchoServerThread() {
+    server_->Shutdown();
+    server_thread_.join();
+  }
+
+  const std::string& address() { return server_address_; }
+
+ private:
+  void RunServerLoop() { server_->Wait(); }
+
+  std::string server_address_;
+  EchoServer service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::thread server_thread_;
+};
+
+static void BM_E2eLatencyMethodStats(benchmark::State& state) {
+  grpc::testing::TestGrpcScope grpc_scope;
+  EchoServerThread server(state.range(0) != 0);
+  std::unique_ptr<grpc::testing::EchoTestService::Stub> stub =
+      grpc::testing::EchoTestService::NewStub(grpc::CreateChannel(
+          server.address(), grpc::InsecureChannelCredentials()));
+
+  grpc::testing::EchoResponse response;
+  for (auto _ : state) {
+    grpc::testing::EchoRequest request;
+    grpc::ClientContext context;
+    grpc::Status status = stub->Echo(&context, request, &response);
+  }
+}
+BENCHMARK(BM_E2eLatencyMethodStats)->Arg(0)->Arg(1);
+
+// The cost added to each call: recording it.
+static void BM_MethodStatsRecordCall(benchmark::State& state) {
+  grpc::testing::TestGrpcScope grpc_scope;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MethodStats stats("/grpc.testing.EchoTestService/Echo", "");
+  uint64_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    stats.RecordCall(i * 1000, i * 3000, i & 1023, i & 4095);
+  }
+}
+BENCHMARK(BM_MethodStatsRecordCall)->ThreadRange(1, 8);
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark building and searching the lookup tables of ring_hash */
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+// The defaults of the ring_hash config.
+constexpr size_t kMinRingSize = 1024;
+constexpr size_t kMaxRingSize = 8388608;
+constexpr size_t kMaglevTableSize = 65537;
+
+std::vector<RingHashEndpoint> MakeEndpoints(size_t num_endpoints) {
+  std::vector<RingHashEndpoint> endpoints(num_endpoints);
+  for (size_t i = 0; i < num_endpoints; ++i) {
+    endpoints[i].address = absl::StrCat("10.", i / 65536, ".", i / 256 % 256,
+                                        ".", i % 256, ":443");
+  }
+  return endpoints;
+}
+
+RefCountedPtr<RingHashLookupTable> MakeRing(
+    const std::vector<RingHashEndpoint>& endpoints) {
+  return MakeRingHashRing(endpoints, kMinRingSize, kMaxRingSize);
+}
+
+RefCountedPtr<RingHashLookupTable> MakeMaglev(
+    const std::vector<RingHashEndpoint>& endpoints) {
+  return MakeMaglevTable(endpoints, kMaglevTableSize);
+}
+
+// Each iteration builds a lookup table for state.range(0) endpoints.
+template <RefCountedPtr<RingHashLookupTable> (*kMakeTable)(
+    const std::vector<RingHashEndpoint>&)>
+void BM_BuildLookupTable(benchmark::State& state) {
+  std::vector<RingHashEndpoint> endpoints = MakeEndpoints(state.range(0));
+  size_t entries = 0;
+  for (auto _ : state) {
+    entries = kMakeTable(endpoints)->size();
+  }
+  state.counters["entries"] = entries;
+}
+
+// Each iteration maps a request hash to an endpoint, in a lookup table for
+// state.range(0) endpoints.
+template <RefCountedPtr<RingHashLookupTable> (*kMakeTable)(
+    const std::vector<RingHashEndpoint>&)>
+void BM_PickFromLookupTable(benchmark::State& state) {
+  RefCountedPtr<RingHashLookupTable> table =
+      kMakeTable(MakeEndpoints(state.range(0)));
+  uint64_t hash = 0;
+  for (auto _ : state) {
+    // A cheap stand-in for the hash of the request.
+    hash = hash * 6364136223846793005u + 1442695040888963407u;
+    benchmark::DoNotOptimize(table->EndpointIndex(table->FindEntry(hash)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Replace "benchmark::internal::Benchmark" with "::testing::Benchmark" to use
+// internal microbenchmarking tooling
+void NumEndpoints(benchmark::internal::Benchmark* b) {
+  for (int i = 10; i <= 10000; i *= 10) b->Arg(i);
+}
+
+BENCHMARK_TEMPLATE(BM_BuildLookupTable, MakeRing)->Apply(NumEndpoints);
+BENCHMARK_TEMPLATE(BM_BuildLookupTable, MakeMaglev)->Apply(NumEndpoints);
+BENCHMARK_TEMPLATE(BM_PickFromLookupTable, MakeRing)->Apply(NumEndpoints);
+BENCHMARK_TEMPLATE(BM_PickFromLookupTable, MakeMaglev)->Apply(NumEndpoints);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
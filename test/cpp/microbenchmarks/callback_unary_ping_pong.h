@@ -98,6 +98,44 @@ static void BM_CallbackUnaryPingPong(benchmark::State& state) {
                           response_msgs_size * state.iterations());
 }
 
+// Unary ping pong whose requests are trees of many small messages, which is
+// what message allocation costs the most for. The first argument is the number
+// of leaves, the second is the message size of response.
+template <class Fixture>
+static void BM_CallbackUnaryPingPongNested(benchmark::State& state) {
+  int num_leaves = state.range(0);
+  CallbackStreamingTestService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(&service));
+  std::unique_ptr<EchoTestService::Stub> stub_(
+      EchoTestService::NewStub(fixture->channel()));
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext cli_ctx;
+
+  RequestParams* params = request.mutable_param();
+  for (int i = 0; i < num_leaves; i++) {
+    params->mutable_debug_info()->add_stack_entries(std::string(32, 'a'));
+  }
+  params->mutable_expected_error()->set_error_message(std::string(32, 'a'));
+  params->set_expected_client_identity(std::string(32, 'a'));
+
+  std::mutex mu;
+  std::condition_variable cv;
+  bool done = false;
+  if (state.KeepRunning()) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    SendCallbackUnaryPingPong(&state, &cli_ctx, &request, &response,
+                              stub_.get(), &done, &mu, &cv);
+  }
+  std::unique_lock<std::mutex> l(mu);
+  while (!done) {
+    cv.wait(l);
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(request.ByteSizeLong() * state.iterations());
+}
+
 }  // namespace testing
 }  // namespace grpc
 
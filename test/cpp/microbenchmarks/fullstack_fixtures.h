@@ -30,8 +30,10 @@
 
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/channel/shm_handshaker.h"
 #include "src/core/lib/iomgr/endpoint.h"
 #include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/endpoint_shm.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/tcp_posix.h"
 #include "src/core/lib/surface/channel.h"
@@ -149,6 +151,28 @@ class UDS : public FullstackFixture {
   }
 };
 
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+class ShmFixtureConfiguration : public FixtureConfiguration {
+ public:
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+    c->SetInt(GRPC_ARG_SHM_ENDPOINT, 1);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+    b->AddChannelArgument(GRPC_ARG_SHM_ENDPOINT, 1);
+  }
+};
+
+// A real client and server over a Unix domain socket, which the shm
+// handshaker switches to the shared-memory endpoint.
+class ShmUDS : public UDS {
+ public:
+  explicit ShmUDS(Service* service) : UDS(service, ShmFixtureConfiguration()) {}
+};
+#endif  // GRPC_LINUX_SHM_ENDPOINT
+
 class InProcess : public FullstackFixture {
  public:
   explicit InProcess(Service* service,
@@ -158,6 +182,40 @@ class InProcess : public FullstackFixture {
   ~InProcess() override {}
 };
 
+// In-process channel that passes messages as objects instead of bytes.
+class InProcessPassMessagePointers : public FullstackFixture {
+ public:
+  explicit InProcessPassMessagePointers(Service* service)
+      : FullstackFixture(service, Configuration(), "") {}
+  ~InProcessPassMessagePointers() override {}
+
+ private:
+  class Configuration : public FixtureConfiguration {
+   public:
+    void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+      FixtureConfiguration::ApplyCommonChannelArguments(c);
+      c->SetInt(GRPC_ARG_INPROC_PASS_MESSAGE_POINTERS, 1);
+    }
+  };
+};
+
+// In-process channel to a server that allocates messages from arena pools.
+class InProcessMessageArenaPool : public FullstackFixture {
+ public:
+  explicit InProcessMessageArenaPool(Service* service)
+      : FullstackFixture(service, Configuration(), "") {}
+  ~InProcessMessageArenaPool() override {}
+
+ private:
+  class Configuration : public FixtureConfiguration {
+   public:
+    void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+      FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+      b->experimental().SetMessageArenaPool("");
+    }
+  };
+};
+
 class EndpointPairFixture : public BaseFixture {
  public:
   EndpointPairFixture(Service* service, grpc_endpoint_pair endpoints,
@@ -258,6 +316,20 @@ class SockPair : public EndpointPairFixture {
                             fixture_configuration) {}
 };
 
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+class ShmPair : public EndpointPairFixture {
+ public:
+  explicit ShmPair(Service* service,
+                   const FixtureConfiguration& fixture_configuration =
+                       FixtureConfiguration())
+      : EndpointPairFixture(
+            service,
+            grpc_shm_endpoint_pair_create("test",
+                                          GRPC_SHM_ENDPOINT_DEFAULT_RING_SIZE),
+            fixture_configuration) {}
+};
+#endif  // GRPC_LINUX_SHM_ENDPOINT
+
 /* Use InProcessCHTTP2 instead. This class (with stats as an explicit parameter)
    is here only to be able to initialize both the base class and stats_ with the
    same stats instance without accessing the stats_ fields before the object is
@@ -330,6 +402,9 @@ typedef MinStackize<TCP> MinTCP;
 typedef MinStackize<UDS> MinUDS;
 typedef MinStackize<InProcess> MinInProcess;
 typedef MinStackize<SockPair> MinSockPair;
+#ifdef GRPC_LINUX_SHM_ENDPOINT
+typedef MinStackize<ShmPair> MinShmPair;
+#endif  // GRPC_LINUX_SHM_ENDPOINT
 typedef MinStackize<InProcessCHTTP2> MinInProcessCHTTP2;
 
 }  // namespace testing
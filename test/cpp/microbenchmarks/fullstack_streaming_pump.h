@@ -25,6 +25,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/proto/grpc/testing/echo.grpc.pb.h"
 #include "test/cpp/microbenchmarks/fullstack_context_mutators.h"
@@ -39,6 +40,34 @@ namespace testing {
 
 static void* tag(intptr_t x) { return reinterpret_cast<void*>(x); }
 
+// Counts how the data frames of the messages were put together: in place,
+// with the frame header in the headroom of the serialized payload, or
+// resliced, with a header slice of its own and the payload split to fit.
+class FramingCounters {
+ public:
+  FramingCounters() { grpc_stats_collect(&begin_); }
+
+  void Report(benchmark::State& state) {
+    grpc_stats_data end;
+    grpc_stats_collect(&end);
+    grpc_stats_data diff;
+    grpc_stats_diff(&end, &begin_, &diff);
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["frames_in_place"] =
+        diff.counters[GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_IN_PLACE] /
+        iterations;
+    state.counters["frames_resliced"] =
+        diff.counters[GRPC_STATS_COUNTER_HTTP2_DATA_FRAMES_RESLICED] /
+        iterations;
+    state.counters["prefixes_in_place"] =
+        diff.counters[GRPC_STATS_COUNTER_HTTP2_MESSAGE_PREFIXES_IN_PLACE] /
+        iterations;
+  }
+
+ private:
+  grpc_stats_data begin_;
+};
+
 template <class Fixture>
 static void BM_PumpStreamClientToServer(benchmark::State& state) {
   EchoTestService::AsyncService service;
@@ -69,6 +98,7 @@ static void BM_PumpStreamClientToServer(benchmark::State& state) {
       need_tags &= ~(1 << i);
     }
     response_rw.Read(&recv_request, tag(0));
+    FramingCounters framing;
     for (auto _ : state) {
       GPR_TIMER_SCOPE("BenchmarkCycle", 0);
       request_rw->Write(send_request, tag(1));
@@ -83,6 +113,7 @@ static void BM_PumpStreamClientToServer(benchmark::State& state) {
         }
       }
     }
+    framing.Report(state);
     request_rw->WritesDone(tag(1));
     need_tags = (1 << 0) | (1 << 1);
     while (need_tags) {
@@ -138,6 +169,7 @@ static void BM_PumpStreamServerToClient(benchmark::State& state) {
       need_tags &= ~(1 << i);
     }
     request_rw->Read(&recv_response, tag(0));
+    FramingCounters framing;
     for (auto _ : state) {
       GPR_TIMER_SCOPE("BenchmarkCycle", 0);
       response_rw.Write(send_response, tag(1));
@@ -152,6 +184,7 @@ static void BM_PumpStreamServerToClient(benchmark::State& state) {
         }
       }
     }
+    framing.Report(state);
     response_rw.Finish(Status::OK, tag(1));
     need_tags = (1 << 0) | (1 << 1);
     while (need_tags) {
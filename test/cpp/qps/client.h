@@ -132,6 +132,19 @@ class HistogramEntry final {
   int status_;
 };
 
+// Returns the time, in UsageTimer::Now() terms, to measure the latency of a
+// request scheduled for \a issue_time from. With coordinated omission
+// correction, this is the scheduled time, so that the time the request waited
+// for a saturated client to issue it counts; otherwise it is now.
+inline double RequestStartTime(bool correct_coordinated_omission,
+                               gpr_timespec issue_time) {
+  if (!correct_coordinated_omission) {
+    return UsageTimer::Now();
+  }
+  gpr_timespec start = gpr_convert_clock_type(issue_time, GPR_CLOCK_REALTIME);
+  return start.tv_sec + 1e-9 * start.tv_nsec;
+}
+
 typedef std::unordered_map<int, int64_t> StatusHistogram;
 
 inline void MergeStatusHistogram(const StatusHistogram& from,
@@ -146,6 +159,7 @@ class Client {
  public:
   Client()
       : timer_(new UsageTimer),
+        correct_coordinated_omission_(false),
         interarrival_timer_(),
         started_requests_(false),
         last_reset_poll_count_(0) {
@@ -241,6 +255,8 @@ class Client {
 
   bool IsClosedLoop() { return closed_loop_; }
 
+  bool CorrectsCoordinatedOmission() { return correct_coordinated_omission_; }
+
   gpr_timespec NextIssueTime(int thread_idx) {
     const gpr_timespec result = next_time_[thread_idx];
     next_time_[thread_idx] =
@@ -364,6 +380,8 @@ class Client {
       case LoadParams::kPoisson:
         random_dist = absl::make_unique<ExpDist>(load.poisson().offered_load() /
                                                  num_threads);
+        correct_coordinated_omission_ =
+            load.poisson().correct_coordinated_omission();
         break;
       default:
         GPR_ASSERT(false);
@@ -394,6 +412,7 @@ class Client {
 
   std::vector<std::unique_ptr<Thread>> threads_;
   std::unique_ptr<UsageTimer> timer_;
+  bool correct_coordinated_omission_;
 
   InterarrivalTimer interarrival_timer_;
   std::vector<gpr_timespec> next_time_;
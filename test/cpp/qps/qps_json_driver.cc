@@ -29,6 +29,7 @@
 #include "test/core/util/test_config.h"
 #include "test/cpp/qps/benchmark_config.h"
 #include "test/cpp/qps/driver.h"
+#include "test/cpp/qps/histogram.h"
 #include "test/cpp/qps/parse_json.h"
 #include "test/cpp/qps/report.h"
 #include "test/cpp/qps/server.h"
@@ -143,6 +144,7 @@ static std::unique_ptr<ScenarioResult> RunAndReport(
   GetReporter()->ReportQPS(*result);
   GetReporter()->ReportQPSPerCore(*result);
   GetReporter()->ReportLatency(*result);
+  GetReporter()->ReportLatencyDistribution(*result);
   GetReporter()->ReportTimes(*result);
   GetReporter()->ReportCpuUsage(*result);
   GetReporter()->ReportPollCount(*result);
@@ -228,6 +230,66 @@ static double SearchOfferedLoad(
   return targeted_offered_load;
 }
 
+static double RampOfferedLoad(
+    Scenario* scenario,
+    const std::map<std::string, std::string>& per_worker_credential_types,
+    bool* success) {
+  const LoadRampParams& ramp = scenario->load_ramp();
+  const double percentile =
+      ramp.latency_percentile() > 0 ? ramp.latency_percentile() : 99;
+  const double qps_tolerance =
+      ramp.qps_tolerance() > 0 ? ramp.qps_tolerance() : 0.05;
+  // The ramp steps the offered load of open-loop (Poisson) clients; there is
+  // nothing to step for closed-loop clients or a zero rate.
+  if (!scenario->client_config().load_params().has_poisson()) {
+    gpr_log(GPR_ERROR, "Load ramp of scenario %s needs Poisson load params",
+            scenario->name().c_str());
+    *success = false;
+    return 0;
+  }
+  if (ramp.start_qps() <= 0 || ramp.step_qps() <= 0 ||
+      ramp.max_qps() < ramp.start_qps()) {
+    gpr_log(GPR_ERROR,
+            "Invalid load ramp of scenario %s: start_qps %f, step_qps %f, "
+            "max_qps %f",
+            scenario->name().c_str(), ramp.start_qps(), ramp.step_qps(),
+            ramp.max_qps());
+    *success = false;
+    return 0;
+  }
+  PoissonParams* poisson = scenario->mutable_client_config()
+                               ->mutable_load_params()
+                               ->mutable_poisson();
+  // Latencies that leave out the queueing of an overloaded client would let
+  // the ramp go past the load the system actually sustains.
+  poisson->set_correct_coordinated_omission(true);
+  double sustained_offered_load = 0;
+  for (double offered_load = ramp.start_qps(); offered_load <= ramp.max_qps();
+       offered_load += ramp.step_qps()) {
+    poisson->set_offered_load(offered_load);
+    auto result = RunAndReport(*scenario, per_worker_credential_types, success);
+    if (!*success) {
+      gpr_log(GPR_ERROR, "Client/Server Failure");
+      break;
+    }
+    Histogram histogram;
+    histogram.MergeProto(result->latencies());
+    const double latency_us = histogram.Percentile(percentile) / 1000;
+    const double target_qps = offered_load * result->client_stats_size();
+    gpr_log(GPR_INFO,
+            "Load ramp: offered %.0f QPS, achieved %.0f QPS, %g%%-ile "
+            "latency %.1f us (SLO %.1f us)",
+            target_qps, result->summary().qps(), percentile, latency_us,
+            ramp.latency_slo_us());
+    if (latency_us > ramp.latency_slo_us() ||
+        result->summary().qps() < target_qps * (1 - qps_tolerance)) {
+      break;
+    }
+    sustained_offered_load = offered_load;
+  }
+  return sustained_offered_load;
+}
+
 static bool QpsDriver() {
   std::string json;
 
@@ -271,7 +333,12 @@ static bool QpsDriver() {
   GPR_ASSERT(scenarios.scenarios_size() > 0);
 
   for (int i = 0; i < scenarios.scenarios_size(); i++) {
-    if (absl::GetFlag(FLAGS_search_param).empty()) {
+    if (scenarios.scenarios(i).has_load_ramp()) {
+      double sustained_offered_load = RampOfferedLoad(
+          scenarios.mutable_scenarios(i), per_worker_credential_types,
+          &success);
+      gpr_log(GPR_INFO, "sustained_offered_load %f", sustained_offered_load);
+    } else if (absl::GetFlag(FLAGS_search_param).empty()) {
       const Scenario& scenario = scenarios.scenarios(i);
       RunAndReport(scenario, per_worker_credential_types, &success);
     } else {
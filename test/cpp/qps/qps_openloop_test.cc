@@ -45,6 +45,9 @@ static void RunQPS() {
   client_config.set_rpc_type(STREAMING);
   client_config.mutable_load_params()->mutable_poisson()->set_offered_load(
       1000.0 / grpc_test_slowdown_factor());
+  client_config.mutable_load_params()
+      ->mutable_poisson()
+      ->set_correct_coordinated_omission(true);
 
   ServerConfig server_config;
   server_config.set_server_type(ASYNC_SERVER);
@@ -56,6 +59,7 @@ static void RunQPS() {
 
   GetReporter()->ReportQPSPerCore(*result);
   GetReporter()->ReportLatency(*result);
+  GetReporter()->ReportLatencyDistribution(*result);
 }
 
 }  // namespace testing
@@ -0,0 +1,122 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "test/core/util/test_config.h"
+#include "test/cpp/qps/benchmark_config.h"
+#include "test/cpp/qps/driver.h"
+#include "test/cpp/qps/report.h"
+#include "test/cpp/qps/server.h"
+#include "test/cpp/util/test_config.h"
+#include "test/cpp/util/test_credentials_provider.h"
+
+namespace grpc {
+namespace testing {
+
+static const int WARMUP = 5;
+static const int BENCHMARK = 5;
+// Bound on the p99 latency of the calls the limiter admits, in nanoseconds.
+static const double kMaxLimitedP99Ns = 1e9;
+
+// Offers the server more unary calls than it can handle. Without adaptive
+// concurrency, calls queue up on the server behind all the calls in flight;
+// with it, the excess calls fail fast with RESOURCE_EXHAUSTED and the latency
+// of the admitted calls (the only ones in the histogram) stays bounded.
+// Latencies are measured from the start of each call rather than from its
+// scheduled time: the offered load is more than the client can send too, and
+// the time calls wait for one of its outstanding slots would hide the
+// server's queueing.
+static std::unique_ptr<ScenarioResult> RunQPS(bool adaptive_concurrency) {
+  gpr_log(GPR_INFO, "Running QPS test, overloaded, adaptive concurrency %s",
+          adaptive_concurrency ? "on" : "off");
+
+  ClientConfig client_config;
+  client_config.set_client_type(ASYNC_CLIENT);
+  client_config.set_outstanding_rpcs_per_channel(100);
+  client_config.set_client_channels(8);
+  client_config.set_async_client_threads(8);
+  client_config.set_rpc_type(UNARY);
+  client_config.mutable_payload_config()->mutable_simple_params()->set_req_size(
+      1024);
+  client_config.mutable_payload_config()
+      ->mutable_simple_params()
+      ->set_resp_size(1024);
+  client_config.mutable_load_params()->mutable_poisson()->set_offered_load(
+      200000.0 / grpc_test_slowdown_factor());
+  client_config.mutable_load_params()
+      ->mutable_poisson()
+      ->set_correct_coordinated_omission(false);
+
+  ServerConfig server_config;
+  server_config.set_server_type(SYNC_SERVER);
+  if (adaptive_concurrency) {
+    ChannelArg* arg = server_config.add_channel_args();
+    arg->set_name(GRPC_ARG_SERVER_ADAPTIVE_CONCURRENCY);
+    arg->set_int_value(1);
+  }
+
+  auto result =
+      RunScenario(client_config, 1, server_config, 1, WARMUP, BENCHMARK, -2, "",
+                  kInsecureCredentialsType, {}, false, 0);
+
+  GetReporter()->ReportQPS(*result);
+  GetReporter()->ReportLatency(*result);
+  GetReporter()->ReportLatencyDistribution(*result);
+  return result;
+}
+
+static int64_t CountStatus(const ScenarioResult& result, StatusCode code) {
+  int64_t count = 0;
+  for (const RequestResultCount& rrc : result.request_results()) {
+    if (rrc.status_code() == code) count += rrc.count();
+  }
+  return count;
+}
+
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc::testing::InitTest(&argc, &argv, true);
+
+  const auto unlimited = grpc::testing::RunQPS(false);
+  const auto limited = grpc::testing::RunQPS(true);
+
+  // The limiter shed the excess load...
+  GPR_ASSERT(grpc::testing::CountStatus(*unlimited,
+                                        grpc::StatusCode::RESOURCE_EXHAUSTED) ==
+             0);
+  GPR_ASSERT(grpc::testing::CountStatus(
+                 *limited, grpc::StatusCode::RESOURCE_EXHAUSTED) > 0);
+  // ...which kept the tail latency of the calls it admitted bounded, and
+  // below the latency of the calls queueing without it.
+  const double limited_p99 = limited->summary().latency_99();
+  const double unlimited_p99 = unlimited->summary().latency_99();
+  gpr_log(GPR_INFO, "p99 latency: %.1f us limited, %.1f us unlimited",
+          limited_p99 / 1000, unlimited_p99 / 1000);
+  GPR_ASSERT(limited_p99 <
+             grpc::testing::kMaxLimitedP99Ns * grpc_test_slowdown_factor());
+  GPR_ASSERT(limited_p99 < unlimited_p99);
+
+  return 0;
+}
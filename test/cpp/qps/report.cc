@@ -18,6 +18,8 @@
 
 #include "test/cpp/qps/report.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include <grpc/support/log.h>
@@ -26,6 +28,7 @@
 #include "src/cpp/util/core_stats.h"
 #include "src/proto/grpc/testing/report_qps_scenario_service.grpc.pb.h"
 #include "test/cpp/qps/driver.h"
+#include "test/cpp/qps/histogram.h"
 #include "test/cpp/qps/parse_json.h"
 #include "test/cpp/qps/stats.h"
 
@@ -54,6 +57,13 @@ void CompositeReporter::ReportLatency(const ScenarioResult& result) {
   }
 }
 
+void CompositeReporter::ReportLatencyDistribution(
+    const ScenarioResult& result) {
+  for (size_t i = 0; i < reporters_.size(); ++i) {
+    reporters_[i]->ReportLatencyDistribution(result);
+  }
+}
+
 void CompositeReporter::ReportTimes(const ScenarioResult& result) {
   for (size_t i = 0; i < reporters_.size(); ++i) {
     reporters_[i]->ReportTimes(result);
@@ -133,6 +143,41 @@ void GprLogReporter::ReportLatency(const ScenarioResult& result) {
           result.summary().latency_999() / 1000);
 }
 
+void GprLogReporter::ReportLatencyDistribution(const ScenarioResult& result) {
+  const HistogramData& data = result.latencies();
+  if (data.count() == 0) {
+    return;
+  }
+  Histogram histogram;
+  histogram.MergeProto(data);
+  // Like HdrHistogram, report kTicksPerHalfDistance percentiles for every
+  // halving of the distance to 100%, until less than one request remains
+  // above the percentile.
+  const int kTicksPerHalfDistance = 5;
+  gpr_log(GPR_INFO, "Latency distribution (us):");
+  gpr_log(GPR_INFO, "%12s %14s %10s %14s", "Value", "Percentile",
+          "TotalCount", "1/(1-Percentile)");
+  double percentile = 0;
+  while ((100 - percentile) / 100 * data.count() >= 1) {
+    gpr_log(GPR_INFO, "%12.3f %14.12f %10.0f %14.2f",
+            histogram.Percentile(percentile) / 1000, percentile / 100,
+            std::ceil(percentile / 100 * data.count()),
+            100 / (100 - percentile));
+    double half_distance =
+        std::pow(2, std::floor(std::log2(100 / (100 - percentile))) + 1);
+    percentile += 100 / (half_distance * kTicksPerHalfDistance);
+  }
+  gpr_log(GPR_INFO, "%12.3f %14.12f %10.0f", data.max_seen() / 1000, 1.0,
+          data.count());
+  double mean = data.sum() / data.count();
+  double stddev = std::sqrt(
+      std::max(0.0, data.sum_of_squares() / data.count() - mean * mean));
+  gpr_log(GPR_INFO, "#[Mean    = %12.3f, StdDeviation   = %12.3f]",
+          mean / 1000, stddev / 1000);
+  gpr_log(GPR_INFO, "#[Max     = %12.3f, Total count    = %12.0f]",
+          data.max_seen() / 1000, data.count());
+}
+
 void GprLogReporter::ReportTimes(const ScenarioResult& result) {
   gpr_log(GPR_INFO, "Server system time: %.2f%%",
           result.summary().server_system_time());
@@ -179,6 +224,11 @@ void JsonReporter::ReportLatency(const ScenarioResult& /*result*/) {
   // NOP - all reporting is handled by ReportQPS.
 }
 
+void JsonReporter::ReportLatencyDistribution(
+    const ScenarioResult& /*result*/) {
+  // NOP - all reporting is handled by ReportQPS.
+}
+
 void JsonReporter::ReportTimes(const ScenarioResult& /*result*/) {
   // NOP - all reporting is handled by ReportQPS.
 }
@@ -219,6 +269,11 @@ void RpcReporter::ReportLatency(const ScenarioResult& /*result*/) {
   // NOP - all reporting is handled by ReportQPS.
 }
 
+void RpcReporter::ReportLatencyDistribution(
+    const ScenarioResult& /*result*/) {
+  // NOP - all reporting is handled by ReportQPS.
+}
+
 void RpcReporter::ReportTimes(const ScenarioResult& /*result*/) {
   // NOP - all reporting is handled by ReportQPS.
 }
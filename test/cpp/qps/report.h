@@ -54,6 +54,10 @@ class Reporter {
   /** Reports latencies for the 50, 90, 95, 99 and 99.9 percentiles, in ms. */
   virtual void ReportLatency(const ScenarioResult& result) = 0;
 
+  /** Reports the latency at every percentile, in the style of the percentile
+   * distribution of HdrHistogram. */
+  virtual void ReportLatencyDistribution(const ScenarioResult& result) = 0;
+
   /** Reports system and user time for client and server systems. */
   virtual void ReportTimes(const ScenarioResult& result) = 0;
 
@@ -81,6 +85,7 @@ class CompositeReporter : public Reporter {
   void ReportQPS(const ScenarioResult& result) override;
   void ReportQPSPerCore(const ScenarioResult& result) override;
   void ReportLatency(const ScenarioResult& result) override;
+  void ReportLatencyDistribution(const ScenarioResult& result) override;
   void ReportTimes(const ScenarioResult& result) override;
   void ReportCpuUsage(const ScenarioResult& result) override;
   void ReportPollCount(const ScenarioResult& result) override;
@@ -99,6 +104,7 @@ class GprLogReporter : public Reporter {
   void ReportQPS(const ScenarioResult& result) override;
   void ReportQPSPerCore(const ScenarioResult& result) override;
   void ReportLatency(const ScenarioResult& result) override;
+  void ReportLatencyDistribution(const ScenarioResult& result) override;
   void ReportTimes(const ScenarioResult& result) override;
   void ReportCpuUsage(const ScenarioResult& result) override;
   void ReportPollCount(const ScenarioResult& result) override;
@@ -118,6 +124,7 @@ class JsonReporter : public Reporter {
   void ReportQPS(const ScenarioResult& result) override;
   void ReportQPSPerCore(const ScenarioResult& result) override;
   void ReportLatency(const ScenarioResult& result) override;
+  void ReportLatencyDistribution(const ScenarioResult& result) override;
   void ReportTimes(const ScenarioResult& result) override;
   void ReportCpuUsage(const ScenarioResult& result) override;
   void ReportPollCount(const ScenarioResult& result) override;
@@ -135,6 +142,7 @@ class RpcReporter : public Reporter {
   void ReportQPS(const ScenarioResult& result) override;
   void ReportQPSPerCore(const ScenarioResult& result) override;
   void ReportLatency(const ScenarioResult& result) override;
+  void ReportLatencyDistribution(const ScenarioResult& result) override;
   void ReportTimes(const ScenarioResult& result) override;
   void ReportCpuUsage(const ScenarioResult& result) override;
   void ReportPollCount(const ScenarioResult& result) override;
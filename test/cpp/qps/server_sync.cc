@@ -168,6 +168,16 @@ class SynchronousServer final : public grpc::testing::Server {
 
     ApplyConfigToBuilder(config, builder.get());
 
+    if (config.sync_server_pinned_pollers() > 0) {
+      builder->SetSyncServerOption(ServerBuilder::PINNED_POLLERS,
+                                   config.sync_server_pinned_pollers());
+      if (config.sync_server_target_queueing_delay_us() > 0) {
+        builder->SetSyncServerOption(
+            ServerBuilder::TARGET_QUEUEING_DELAY_USEC,
+            config.sync_server_target_queueing_delay_us());
+      }
+    }
+
     builder->RegisterService(&service_);
 
     impl_ = builder->BuildAndStart();
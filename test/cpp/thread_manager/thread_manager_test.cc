@@ -57,6 +57,12 @@ struct TestThreadManagerSettings {
 
   // How many should be instantiated
   int thread_manager_count;
+
+  // The number of pinned pollers in work-stealing mode (0 to not use it)
+  int pinned_pollers;
+
+  // The queueing delay above which executors are added in work-stealing mode
+  int target_queueing_delay_usec;
 };
 
 class TestThreadManager final : public grpc::ThreadManager {
@@ -67,7 +73,12 @@ class TestThreadManager final : public grpc::ThreadManager {
         settings_(settings),
         num_do_work_(0),
         num_poll_for_work_(0),
-        num_work_found_(0) {}
+        num_work_found_(0) {
+    if (settings.pinned_pollers > 0) {
+      EnableWorkStealing(settings.pinned_pollers,
+                         settings.target_queueing_delay_usec);
+    }
+  }
 
   grpc::ThreadManager::WorkStatus PollForWork(void** tag, bool* ok) override;
   void DoWork(void* /* tag */, bool /*ok*/, bool /*resources*/) override {
@@ -151,10 +162,20 @@ class ThreadManagerTest
 TestThreadManagerSettings scenarios[] = {
     {2 /* min_pollers */, 10 /* max_pollers */, 10 /* poll_duration_ms */,
      1 /* work_duration_ms */, 50 /* max_poll_calls */,
-     INT_MAX /* thread_limit */, 1 /* thread_manager_count */},
+     INT_MAX /* thread_limit */, 1 /* thread_manager_count */,
+     0 /* pinned_pollers */, 0 /* target_queueing_delay_usec */},
     {1 /* min_pollers */, 1 /* max_pollers */, 1 /* poll_duration_ms */,
      10 /* work_duration_ms */, 50 /* max_poll_calls */, 3 /* thread_limit */,
-     2 /* thread_manager_count */}};
+     2 /* thread_manager_count */, 0 /* pinned_pollers */,
+     0 /* target_queueing_delay_usec */},
+    {1 /* min_pollers */, 1 /* max_pollers */, 1 /* poll_duration_ms */,
+     10 /* work_duration_ms */, 100 /* max_poll_calls */,
+     INT_MAX /* thread_limit */, 1 /* thread_manager_count */,
+     2 /* pinned_pollers */, 1000 /* target_queueing_delay_usec */},
+    {1 /* min_pollers */, 1 /* max_pollers */, 1 /* poll_duration_ms */,
+     10 /* work_duration_ms */, 50 /* max_poll_calls */, 5 /* thread_limit */,
+     2 /* thread_manager_count */, 1 /* pinned_pollers */,
+     1000 /* target_queueing_delay_usec */}};
 
 INSTANTIATE_TEST_SUITE_P(ThreadManagerTest, ThreadManagerTest,
                          ::testing::ValuesIn(scenarios));
@@ -169,6 +190,18 @@ TEST_P(ThreadManagerTest, TestPollAndWork) {
   }
 }
 
+TEST_P(ThreadManagerTest, TestExecutorsFollowQueueingDelay) {
+  // Work takes longer than the pollers take to find it, so that it queues up
+  // and executors get added while there is thread quota left.
+  if (GetParam().pinned_pollers > 0 &&
+      GetParam().thread_limit == INT_MAX) {
+    for (auto& tm : thread_manager_) {
+      EXPECT_GT(tm->GetMaxActiveThreadsSoFar(),
+                GetParam().pinned_pollers + GetParam().min_pollers);
+    }
+  }
+}
+
 TEST_P(ThreadManagerTest, TestThreadQuota) {
   if (GetParam().thread_limit > 0) {
     for (auto& tm : thread_manager_) {
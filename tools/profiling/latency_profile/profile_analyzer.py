@@ -159,20 +159,43 @@ class CallStack(object):
 builder = collections.defaultdict(CallStackBuilder)
 call_stacks = collections.defaultdict(CallStack)
 
+# The scopes and marks of the Chrome trace written by the latency tracer, as
+# the line types of the old basic_prof format.
+_LINE_TYPES = {'B': '{', 'E': '}', 'i': '.'}
+
+
+def trace_lines(trace):
+    """Converts the scope and mark events of a Chrome trace to lines."""
+    for event in trace['traceEvents']:
+        line_type = _LINE_TYPES.get(event['ph'])
+        if line_type is None:
+            continue
+        event_args = event.get('args', {})
+        yield {
+            't': event['ts'] / 1e6,
+            'thd': event['tid'],
+            'type': line_type,
+            'tag': event['name'],
+            'file': event_args.get('file', ''),
+            'line': event_args.get('line', 0),
+            'imp': event_args.get('important', False),
+        }
+
+
 lines = 0
 start = time.time()
 with open(args.source) as f:
-    for line in f:
-        lines += 1
-        inf = json.loads(line)
-        thd = inf['thd']
-        cs = builder[thd]
-        if cs.add(inf):
-            if cs.signature in call_stacks:
-                call_stacks[cs.signature].add(cs)
-            else:
-                call_stacks[cs.signature] = CallStack(cs)
-            del builder[thd]
+    trace = json.load(f)
+for inf in trace_lines(trace):
+    lines += 1
+    thd = inf['thd']
+    cs = builder[thd]
+    if cs.add(inf):
+        if cs.signature in call_stacks:
+            call_stacks[cs.signature].add(cs)
+        else:
+            call_stacks[cs.signature] = CallStack(cs)
+        del builder[thd]
 time_taken = time.time() - start
 
 call_stacks = sorted(call_stacks.values(),
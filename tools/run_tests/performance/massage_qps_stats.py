@@ -317,6 +317,27 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_cq_ev_queue_transient_pop_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_transient_pop_failures")
+            stats[
+                "core_message_compression_compressed"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compression_compressed")
+            stats[
+                "core_message_compression_skipped"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compression_skipped")
+            stats[
+                "core_message_compression_bytes_saved"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compression_bytes_saved")
+            stats[
+                "core_message_compression_cpu_us"] = massage_qps_stats_helpers.counter(
+                    core_stats, "message_compression_cpu_us")
+            stats[
+                "core_http2_data_frames_in_place"] = massage_qps_stats_helpers.counter(
+                    core_stats, "http2_data_frames_in_place")
+            stats[
+                "core_http2_data_frames_resliced"] = massage_qps_stats_helpers.counter(
+                    core_stats, "http2_data_frames_resliced")
+            stats[
+                "core_http2_message_prefixes_in_place"] = massage_qps_stats_helpers.counter(
+                    core_stats, "http2_message_prefixes_in_place")
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "call_initial_size")
             stats["core_call_initial_size"] = ",".join(
@@ -135,7 +135,8 @@ def _ping_pong_scenario(name,
                         messages_per_stream=None,
                         excluded_poll_engines=None,
                         minimal_stack=False,
-                        offered_load=None):
+                        offered_load=None,
+                        sync_server_pinned_pollers=None):
     """Creates a basic ping pong scenario."""
     scenario = {
         'name': name,
@@ -168,6 +169,9 @@ def _ping_pong_scenario(name,
     }
     if resource_quota_size:
         scenario['server_config']['resource_quota_size'] = resource_quota_size
+    if sync_server_pinned_pollers:
+        scenario['server_config'][
+            'sync_server_pinned_pollers'] = sync_server_pinned_pollers
     if use_generic_payload:
         if server_type != 'ASYNC_GENERIC_SERVER':
             raise Exception('Use ASYNC_GENERIC_SERVER for generic payload.')
@@ -482,6 +486,24 @@ class CXXLanguage(Language):
                 categories=smoketest_categories + inproc_categories +
                 [SCALABLE])
 
+            # Poisson arrivals from many channels come in bursts: compare how
+            # the sync server's default and work-stealing thread managers
+            # absorb them.
+            for pinned_pollers in [None, 2]:
+                mode = 'work_stealing' if pinned_pollers else 'default'
+                yield _ping_pong_scenario(
+                    'cpp_protobuf_async_client_sync_server_unary_poisson_%s_%s'
+                    % (mode, secstr),
+                    rpc_type='UNARY',
+                    client_type='ASYNC_CLIENT',
+                    server_type='SYNC_SERVER',
+                    unconstrained_client='async',
+                    offered_load=20000,
+                    sync_server_pinned_pollers=pinned_pollers,
+                    secure=secure,
+                    minimal_stack=not secure,
+                    categories=[SCALABLE])
+
             yield _ping_pong_scenario(
                 'cpp_protobuf_async_client_unary_1channel_64wide_128Breq_8MBresp_%s'
                 % (secstr),